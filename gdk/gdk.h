@@ -74,6 +74,7 @@
 #include <gdk/gdksurface.h>
 #include <gdk/gdktexture.h>
 #include <gdk/gdktexturedownloader.h>
+#include <gdk/gdktextureloader.h>
 #include <gdk/gdktoplevel.h>
 #include <gdk/gdktoplevellayout.h>
 #include <gdk/gdktoplevelsize.h>
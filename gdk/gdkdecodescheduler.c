@@ -0,0 +1,478 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkdecodeschedulerprivate.h"
+
+#include "gdkprivate.h"
+#include "gdkprofilerprivate.h"
+#include "gdktextureprivate.h"
+
+#include <gio/gio.h>
+
+/* Decodes image files in a small pool of threads.
+ *
+ * Widgets that show images from files, like pictures in a grid view of
+ * thousands of photos, can request a lot of them at once. Running each
+ * load in a thread of its own floods the GTask pool, and images that
+ * have been scrolled away are still loaded before the ones on screen.
+ *
+ * So loads are queued here instead. At most MAX_THREADS of them run at
+ * the same time, loads of visible images go first, followed by the ones
+ * that are close to being scrolled into view, loads that nobody
+ * waits for anymore are dropped from the queue (or cancelled, if they
+ * are already running), and requests for a file that is already being
+ * loaded at the same size share that load.
+ *
+ * Requests are made and completed in the main thread. Only the queues
+ * of pending jobs are shared with the threads, and protected by a lock.
+ */
+
+#define MAX_THREADS 4
+
+typedef struct _DecodeJob DecodeJob;
+
+typedef enum {
+  JOB_PENDING,
+  JOB_RUNNING,
+  JOB_DONE,
+} JobState;
+
+struct _DecodeJob
+{
+  GFile *file;
+  int width;
+  int height;
+  double scale;
+  GdkDecodeFunc func;
+
+  /* main thread only */
+  GQueue requests;
+  gboolean in_table;
+
+  /* protected by the lock */
+  GdkDecodePriority priority;
+  JobState state;
+  GList link;
+
+  /* set by the thread that runs the job */
+  GCancellable *cancellable;
+  GdkPaintable *paintable;
+  GError *error;
+};
+
+struct _GdkDecodeRequest
+{
+  DecodeJob *job;
+  GdkDecodePriority priority;
+  GdkDecodeCallback callback;
+  gpointer user_data;
+  GList link;
+};
+
+static GMutex lock;
+static GQueue pending[GDK_DECODE_N_PRIORITIES];
+static GThreadPool *pool;
+static GHashTable *jobs;
+
+static guint pending_counter;
+static guint running_counter;
+static guint n_running;
+
+static guint
+decode_job_hash (gconstpointer data)
+{
+  const DecodeJob *job = data;
+
+  return g_file_hash (job->file) ^ ((guint) job->width << 16) ^ (guint) job->height ^
+         g_double_hash (&job->scale) ^ GPOINTER_TO_UINT (job->func);
+}
+
+static gboolean
+decode_job_equal (gconstpointer data1,
+                  gconstpointer data2)
+{
+  const DecodeJob *a = data1;
+  const DecodeJob *b = data2;
+
+  return a->width == b->width &&
+         a->height == b->height &&
+         a->scale == b->scale &&
+         a->func == b->func &&
+         g_file_equal (a->file, b->file);
+}
+
+static void
+decode_job_free (DecodeJob *job)
+{
+  g_assert (job->requests.length == 0);
+
+  g_object_unref (job->file);
+  g_object_unref (job->cancellable);
+  g_clear_object (&job->paintable);
+  g_clear_error (&job->error);
+  g_free (job);
+}
+
+static void
+update_counters (void)
+{
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      guint n_pending = 0;
+      int i;
+
+      for (i = 0; i < GDK_DECODE_N_PRIORITIES; i++)
+        n_pending += pending[i].length;
+
+      gdk_profiler_set_int_counter (pending_counter, n_pending);
+      gdk_profiler_set_int_counter (running_counter, n_running);
+    }
+}
+
+static gboolean
+decode_job_done (gpointer data)
+{
+  DecodeJob *job = data;
+  GList *link;
+
+  g_mutex_lock (&lock);
+  job->state = JOB_DONE;
+  n_running--;
+  update_counters ();
+  g_mutex_unlock (&lock);
+
+  /* New requests must not join this job anymore */
+  if (job->in_table)
+    {
+      g_hash_table_remove (jobs, job);
+      job->in_table = FALSE;
+    }
+
+  while ((link = g_queue_pop_head_link (&job->requests)))
+    {
+      GdkDecodeRequest *request = link->data;
+
+      request->callback (job->paintable, job->error, request->user_data);
+      g_free (request);
+    }
+
+  decode_job_free (job);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+decode_thread (gpointer data,
+               gpointer unused)
+{
+  DecodeJob *job;
+  GList *link = NULL;
+  guint id;
+  int i;
+  G_GNUC_UNUSED gint64 before = GDK_PROFILER_CURRENT_TIME;
+
+  /* Every queued job pushes one item into the pool, but it
+   * is the most important job that gets run, not that one.
+   */
+  g_mutex_lock (&lock);
+  for (i = 0; i < GDK_DECODE_N_PRIORITIES && link == NULL; i++)
+    link = g_queue_pop_head_link (&pending[i]);
+  if (link)
+    {
+      job = link->data;
+      job->state = JOB_RUNNING;
+      n_running++;
+      update_counters ();
+    }
+  else
+    job = NULL;
+  g_mutex_unlock (&lock);
+
+  /* The job was cancelled while it was waiting */
+  if (job == NULL)
+    return;
+
+  job->paintable = job->func (job->file, job->width, job->height, job->scale, job->cancellable, &job->error);
+  g_assert ((job->paintable == NULL) != (job->error == NULL));
+
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      char *name = g_file_get_basename (job->file);
+      gdk_profiler_end_markf (before, "Decode", "%s%s", name, job->error ? " (failed)" : "");
+      g_free (name);
+    }
+
+  id = g_idle_add_full (G_PRIORITY_DEFAULT, decode_job_done, job, NULL);
+  gdk_source_set_static_name_by_id (id, "[gdk] decode_job_done");
+}
+
+static GdkDecodePriority
+decode_job_get_best_priority (DecodeJob *job)
+{
+  GdkDecodePriority priority = GDK_DECODE_PRIORITY_BACKGROUND;
+  GList *l;
+
+  for (l = job->requests.head; l; l = l->next)
+    {
+      GdkDecodeRequest *request = l->data;
+
+      priority = MIN (priority, request->priority);
+    }
+
+  return priority;
+}
+
+static void
+decode_job_update_priority (DecodeJob *job)
+{
+  GdkDecodePriority priority;
+
+  priority = decode_job_get_best_priority (job);
+
+  g_mutex_lock (&lock);
+
+  if (job->priority != priority)
+    {
+      if (job->state == JOB_PENDING)
+        {
+          g_queue_unlink (&pending[job->priority], &job->link);
+          g_queue_push_tail_link (&pending[priority], &job->link);
+        }
+
+      job->priority = priority;
+    }
+
+  g_mutex_unlock (&lock);
+}
+
+static GdkPaintable *
+decode_texture (GFile         *file,
+                int            width,
+                int            height,
+                double         scale,
+                GCancellable  *cancellable,
+                GError       **error)
+{
+  return GDK_PAINTABLE (gdk_texture_load_file (file, width, height, cancellable, error));
+}
+
+/*
+ * gdk_decode_scheduler_load_file:
+ * @file: the file to load
+ * @width: the width the image will be displayed at, or -1
+ * @height: the height the image will be displayed at, or -1
+ * @priority: the priority of the request
+ * @callback: function to call when the texture has been loaded
+ * @user_data: data to pass to @callback
+ *
+ * Queues loading a texture from @file, like
+ * gdk_texture_new_from_file_at_size() would.
+ *
+ * See gdk_decode_scheduler_load_file_full() for details.
+ *
+ * Returns: (transfer none): the request
+ */
+GdkDecodeRequest *
+gdk_decode_scheduler_load_file (GFile             *file,
+                                int                width,
+                                int                height,
+                                GdkDecodePriority  priority,
+                                GdkDecodeCallback  callback,
+                                gpointer           user_data)
+{
+  return gdk_decode_scheduler_load_file_full (file, width, height, 1.0, NULL,
+                                              priority, callback, user_data);
+}
+
+/*
+ * gdk_decode_scheduler_load_file_full:
+ * @file: the file to load
+ * @width: the width the image will be displayed at, or -1
+ * @height: the height the image will be displayed at, or -1
+ * @scale: the scale the image will be displayed at
+ * @func: (nullable): function that loads the file in a thread
+ * @priority: the priority of the request
+ * @callback: function to call when the file has been loaded
+ * @user_data: data to pass to @callback
+ *
+ * Queues loading a paintable from @file with @func, or a texture
+ * like gdk_texture_new_from_file_at_size() does if @func is %NULL.
+ *
+ * @callback is called in the main thread once the file is loaded,
+ * after which the returned request is freed. Until then, it can be used
+ * to change the priority of the load, or to cancel it.
+ *
+ * Requests with the same arguments share one load.
+ *
+ * Returns: (transfer none): the request
+ */
+GdkDecodeRequest *
+gdk_decode_scheduler_load_file_full (GFile             *file,
+                                     int                width,
+                                     int                height,
+                                     double             scale,
+                                     GdkDecodeFunc      func,
+                                     GdkDecodePriority  priority,
+                                     GdkDecodeCallback  callback,
+                                     gpointer           user_data)
+{
+  GdkDecodeRequest *request;
+  DecodeJob key, *job;
+
+  g_return_val_if_fail (G_IS_FILE (file), NULL);
+  g_return_val_if_fail (callback != NULL, NULL);
+
+  if (func == NULL)
+    func = decode_texture;
+
+  if (G_UNLIKELY (jobs == NULL))
+    {
+      jobs = g_hash_table_new (decode_job_hash, decode_job_equal);
+      pool = g_thread_pool_new (decode_thread, NULL, MAX_THREADS, FALSE, NULL);
+      pending_counter = gdk_profiler_define_int_counter ("decode-pending", "Number of queued image loads");
+      running_counter = gdk_profiler_define_int_counter ("decode-running", "Number of running image loads");
+    }
+
+  request = g_new0 (GdkDecodeRequest, 1);
+  request->priority = priority;
+  request->callback = callback;
+  request->user_data = user_data;
+  request->link.data = request;
+
+  key.file = file;
+  key.width = width;
+  key.height = height;
+  key.scale = scale;
+  key.func = func;
+
+  job = g_hash_table_lookup (jobs, &key);
+  if (job)
+    {
+      request->job = job;
+      g_queue_push_tail_link (&job->requests, &request->link);
+      decode_job_update_priority (job);
+
+      return request;
+    }
+
+  job = g_new0 (DecodeJob, 1);
+  job->file = g_object_ref (file);
+  job->width = key.width;
+  job->height = key.height;
+  job->scale = scale;
+  job->func = func;
+  job->cancellable = g_cancellable_new ();
+  job->priority = priority;
+  job->state = JOB_PENDING;
+  job->link.data = job;
+
+  request->job = job;
+  g_queue_push_tail_link (&job->requests, &request->link);
+
+  g_hash_table_add (jobs, job);
+  job->in_table = TRUE;
+
+  g_mutex_lock (&lock);
+  g_queue_push_tail_link (&pending[priority], &job->link);
+  update_counters ();
+  g_mutex_unlock (&lock);
+
+  g_thread_pool_push (pool, job, NULL);
+
+  return request;
+}
+
+/*
+ * gdk_decode_request_set_priority:
+ * @request: a request
+ * @priority: the new priority
+ *
+ * Changes the priority of the request, for example
+ * when the image scrolls into view.
+ */
+void
+gdk_decode_request_set_priority (GdkDecodeRequest  *request,
+                                 GdkDecodePriority  priority)
+{
+  if (request->priority == priority)
+    return;
+
+  request->priority = priority;
+  decode_job_update_priority (request->job);
+}
+
+/*
+ * gdk_decode_request_cancel:
+ * @request: (transfer full): a request
+ *
+ * Cancels the request and frees it. Its callback will not be called.
+ *
+ * If there are no other requests for the same load, the load is
+ * dropped from the queue, or cancelled if it is already running.
+ */
+void
+gdk_decode_request_cancel (GdkDecodeRequest *request)
+{
+  DecodeJob *job = request->job;
+  JobState state;
+
+  g_queue_unlink (&job->requests, &request->link);
+  g_free (request);
+
+  if (job->requests.length > 0)
+    {
+      decode_job_update_priority (job);
+      return;
+    }
+
+  g_mutex_lock (&lock);
+  state = job->state;
+  if (state == JOB_PENDING)
+    {
+      g_queue_unlink (&pending[job->priority], &job->link);
+      update_counters ();
+    }
+  g_mutex_unlock (&lock);
+
+  switch (state)
+    {
+    case JOB_PENDING:
+      /* The thread will find nothing to do */
+      g_hash_table_remove (jobs, job);
+      decode_job_free (job);
+      break;
+
+    case JOB_RUNNING:
+      /* Let the job finish with nobody waiting for it */
+      g_cancellable_cancel (job->cancellable);
+      if (job->in_table)
+        {
+          g_hash_table_remove (jobs, job);
+          job->in_table = FALSE;
+        }
+      break;
+
+    case JOB_DONE:
+      /* Called from another request's callback */
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gdkpaintable.h"
+#include "gdktexture.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GdkDecodeRequest GdkDecodeRequest;
+
+typedef enum {
+  GDK_DECODE_PRIORITY_VISIBLE,
+  GDK_DECODE_PRIORITY_NEARBY,
+  GDK_DECODE_PRIORITY_BACKGROUND,
+} GdkDecodePriority;
+
+#define GDK_DECODE_N_PRIORITIES (GDK_DECODE_PRIORITY_BACKGROUND + 1)
+
+/* Called in a thread */
+typedef GdkPaintable * (* GdkDecodeFunc) (GFile         *file,
+                                          int            width,
+                                          int            height,
+                                          double         scale,
+                                          GCancellable  *cancellable,
+                                          GError       **error);
+
+/* Called in the main thread. Exactly one of @paintable and @error is set */
+typedef void (* GdkDecodeCallback) (GdkPaintable *paintable,
+                                    const GError *error,
+                                    gpointer      user_data);
+
+GdkDecodeRequest *      gdk_decode_scheduler_load_file          (GFile                  *file,
+                                                                 int                     width,
+                                                                 int                     height,
+                                                                 GdkDecodePriority       priority,
+                                                                 GdkDecodeCallback       callback,
+                                                                 gpointer                user_data);
+GdkDecodeRequest *      gdk_decode_scheduler_load_file_full     (GFile                  *file,
+                                                                 int                     width,
+                                                                 int                     height,
+                                                                 double                  scale,
+                                                                 GdkDecodeFunc           func,
+                                                                 GdkDecodePriority       priority,
+                                                                 GdkDecodeCallback       callback,
+                                                                 gpointer                user_data);
+
+void                    gdk_decode_request_set_priority         (GdkDecodeRequest       *request,
+                                                                 GdkDecodePriority       priority);
+void                    gdk_decode_request_cancel               (GdkDecodeRequest       *request);
+
+G_END_DECLS
@@ -71,7 +71,7 @@ download_memcpy (guchar          *dst_data,
   bpp = gdk_memory_format_bytes_per_pixel (dst_format);
   src_stride = dmabuf->planes[0].stride;
   src_data = src_datas[0] + dmabuf->planes[0].offset;
-  g_return_if_fail (sizes[0] >= dmabuf->planes[0].offset + (height - 1) * dst_stride + width * bpp);
+  g_return_if_fail (sizes[0] >= dmabuf->planes[0].offset + (height - 1) * src_stride + width * bpp);
 
   if (dst_stride == src_stride)
     memcpy (dst_data, src_data, (height - 1) * dst_stride + width * bpp);
@@ -1980,30 +1980,60 @@ gdk_dmabuf_get_mmap_formats (void)
   return formats;
 }
 
-static void
-gdk_dmabuf_do_download_mmap (GdkTexture *texture,
-                             guchar     *data,
-                             gsize       stride)
+typedef struct _GdkDmabufMapping GdkDmabufMapping;
+
+struct _GdkDmabufMapping
 {
-  const GdkDrmFormatInfo *info;
-  const GdkDmabuf *dmabuf;
-  const guchar *src_data[GDK_DMABUF_MAX_PLANES];
+  const guchar *data[GDK_DMABUF_MAX_PLANES];
   gsize sizes[GDK_DMABUF_MAX_PLANES];
-  gsize needs_unmap[GDK_DMABUF_MAX_PLANES] = { FALSE, };
-  gsize i, j;
+  gboolean needs_unmap[GDK_DMABUF_MAX_PLANES];
+};
 
-  dmabuf = gdk_dmabuf_texture_get_dmabuf (GDK_DMABUF_TEXTURE (texture));
-  info = get_drm_format_info (dmabuf->fourcc);
+static void
+gdk_dmabuf_sync (int     fd,
+                 guint64 flags)
+{
+  if (gdk_dmabuf_ioctl (fd, DMA_BUF_IOCTL_SYNC, &(struct dma_buf_sync) { flags }) < 0 &&
+      errno != ENOTTY)
+    g_warning ("Failed to sync dmabuf: %s", g_strerror (errno));
+}
 
-  g_return_if_fail (info && info->download);
+static void
+gdk_dmabuf_unmap (const GdkDmabuf  *dmabuf,
+                  GdkDmabufMapping *mapping)
+{
+  gsize i;
 
-  GDK_DISPLAY_DEBUG (gdk_dmabuf_texture_get_display (GDK_DMABUF_TEXTURE (texture)), DMABUF,
-                     "Using mmap for downloading %dx%d dmabuf (format %.4s:%#" G_GINT64_MODIFIER "x)",
-                     gdk_texture_get_width (texture), gdk_texture_get_height (texture),
-                     (char *)&dmabuf->fourcc, dmabuf->modifier);
+  for (i = 0; i < dmabuf->n_planes; i++)
+    {
+      if (!mapping->needs_unmap[i])
+        continue;
+
+      munmap ((void *) mapping->data[i], mapping->sizes[i]);
+
+      gdk_dmabuf_sync (dmabuf->planes[i].fd, DMA_BUF_SYNC_END|DMA_BUF_SYNC_READ);
+    }
+}
+
+/* Maps all the fds of @dmabuf for reading, starting at the beginning
+ * of the fd, so the plane offsets need to be added by the caller.
+ *
+ * Buffers that don't support DMA_BUF_IOCTL_SYNC, like memfds,
+ * are mapped without syncing.
+ */
+static gboolean
+gdk_dmabuf_map (const GdkDmabuf  *dmabuf,
+                GdkDmabufMapping *mapping)
+{
+  gsize i, j;
+
+  memset (mapping, 0, sizeof (GdkDmabufMapping));
 
   for (i = 0; i < dmabuf->n_planes; i++)
     {
+      off_t size;
+      void *data;
+
       for (j = 0; j < i; j++)
         {
           if (dmabuf->planes[i].fd == dmabuf->planes[j].fd)
@@ -2011,52 +2041,40 @@ gdk_dmabuf_do_download_mmap (GdkTexture *texture,
         }
       if (j < i)
         {
-          src_data[i] = src_data[j];
-          sizes[i] = sizes[j];
+          mapping->data[i] = mapping->data[j];
+          mapping->sizes[i] = mapping->sizes[j];
           continue;
         }
 
-      sizes[i] = lseek (dmabuf->planes[i].fd, 0, SEEK_END);
-      if (sizes[i] == (off_t) -1)
+      size = lseek (dmabuf->planes[i].fd, 0, SEEK_END);
+      if (size == (off_t) -1)
         {
           g_warning ("Failed to seek dmabuf: %s", g_strerror (errno));
-          goto out;
+          goto fail;
         }
       /* be a good citizen and seek back to the start, as the docs recommend */
       lseek (dmabuf->planes[i].fd, 0, SEEK_SET);
 
-      if (gdk_dmabuf_ioctl (dmabuf->planes[i].fd, DMA_BUF_IOCTL_SYNC, &(struct dma_buf_sync) { DMA_BUF_SYNC_START|DMA_BUF_SYNC_READ }) < 0)
-        g_warning ("Failed to sync dmabuf: %s", g_strerror (errno));
+      gdk_dmabuf_sync (dmabuf->planes[i].fd, DMA_BUF_SYNC_START|DMA_BUF_SYNC_READ);
 
-      src_data[i] = mmap (NULL, sizes[i], PROT_READ, MAP_SHARED, dmabuf->planes[i].fd, dmabuf->planes[i].offset);
-      if (src_data[i] == NULL)
+      data = mmap (NULL, size, PROT_READ, MAP_SHARED, dmabuf->planes[i].fd, 0);
+      if (data == MAP_FAILED)
         {
           g_warning ("Failed to mmap dmabuf: %s", g_strerror (errno));
-          goto out;
+          gdk_dmabuf_sync (dmabuf->planes[i].fd, DMA_BUF_SYNC_END|DMA_BUF_SYNC_READ);
+          goto fail;
         }
-      needs_unmap[i] = TRUE;
-    }
-
-    info->download (data,
-                    stride,
-                    gdk_texture_get_format (texture),
-                    gdk_texture_get_width (texture),
-                    gdk_texture_get_height (texture),
-                    dmabuf,
-                    src_data,
-                    sizes);
 
-out:
-  for (i = 0; i < dmabuf->n_planes; i++)
-    {
-      if (!needs_unmap[i])
-        continue;
+      mapping->data[i] = data;
+      mapping->sizes[i] = size;
+      mapping->needs_unmap[i] = TRUE;
+    }
 
-      munmap ((void *)src_data[i], sizes[i]);
+  return TRUE;
 
-      if (gdk_dmabuf_ioctl (dmabuf->planes[i].fd, DMA_BUF_IOCTL_SYNC, &(struct dma_buf_sync) { DMA_BUF_SYNC_END|DMA_BUF_SYNC_READ }) < 0)
-        g_warning ("Failed to sync dmabuf: %s", g_strerror (errno));
-    }
+fail:
+  gdk_dmabuf_unmap (dmabuf, mapping);
+  return FALSE;
 }
 
 void
@@ -2066,22 +2084,54 @@ gdk_dmabuf_download_mmap (GdkTexture      *texture,
                           gsize            stride)
 {
   GdkMemoryFormat src_format = gdk_texture_get_format (texture);
+  const GdkDrmFormatInfo *info;
+  const GdkDmabuf *dmabuf;
+  GdkDmabufMapping mapping;
+  unsigned int width, height;
+
+  dmabuf = gdk_dmabuf_texture_get_dmabuf (GDK_DMABUF_TEXTURE (texture));
+  info = get_drm_format_info (dmabuf->fourcc);
+  width = gdk_texture_get_width (texture);
+  height = gdk_texture_get_height (texture);
+
+  g_return_if_fail (info && info->download);
+
+  GDK_DISPLAY_DEBUG (gdk_dmabuf_texture_get_display (GDK_DMABUF_TEXTURE (texture)), DMABUF,
+                     "Using mmap for downloading %dx%d dmabuf (format %.4s:%#" G_GINT64_MODIFIER "x)",
+                     width, height,
+                     (char *)&dmabuf->fourcc, dmabuf->modifier);
+
+  if (!gdk_dmabuf_map (dmabuf, &mapping))
+    return;
 
   if (format == src_format)
-    gdk_dmabuf_do_download_mmap (texture, data, stride);
+    {
+      info->download (data, stride, format, width, height, dmabuf, mapping.data, mapping.sizes);
+    }
+  else if (info->download == download_memcpy)
+    {
+      gsize src_stride = dmabuf->planes[0].stride;
+      gsize bpp = gdk_memory_format_bytes_per_pixel (src_format);
+
+      /* The pixels are usable as they are, so convert straight
+       * from the mapping, without copying them first
+       */
+      if (mapping.sizes[0] >= dmabuf->planes[0].offset + (height - 1) * src_stride + width * bpp)
+        gdk_memory_convert (data, stride, format,
+                            mapping.data[0] + dmabuf->planes[0].offset, src_stride, src_format,
+                            width, height);
+      else
+        g_warning ("Dmabuf is too small for a %ux%u image", width, height);
+    }
   else
     {
-      unsigned int width, height;
       guchar *src_data;
       gsize src_stride;
 
-      width = gdk_texture_get_width (texture);
-      height = gdk_texture_get_height (texture);
-
       src_stride = width * gdk_memory_format_bytes_per_pixel (src_format);
       src_data = g_new (guchar, src_stride * height);
 
-      gdk_dmabuf_do_download_mmap (texture, src_data, src_stride);
+      info->download (src_data, src_stride, src_format, width, height, dmabuf, mapping.data, mapping.sizes);
 
       gdk_memory_convert (data, stride, format,
                           src_data, src_stride, src_format,
@@ -2089,6 +2139,8 @@ gdk_dmabuf_download_mmap (GdkTexture      *texture,
 
       g_free (src_data);
     }
+
+  gdk_dmabuf_unmap (dmabuf, &mapping);
 }
 
 int
@@ -36,6 +36,9 @@ struct _GdkMemoryTexture
 
   GBytes *bytes;
   gsize stride;
+
+  /* atomic */ GdkMemoryTexture *next_lod;
+  /* atomic */ GdkMemoryTexture *thumbnail;
 };
 
 struct _GdkMemoryTextureClass
@@ -51,6 +54,8 @@ gdk_memory_texture_dispose (GObject *object)
   GdkMemoryTexture *self = GDK_MEMORY_TEXTURE (object);
 
   g_clear_pointer (&self->bytes, g_bytes_unref);
+  g_clear_object (&self->next_lod);
+  g_clear_object (&self->thumbnail);
 
   G_OBJECT_CLASS (gdk_memory_texture_parent_class)->dispose (object);
 }
@@ -235,6 +240,341 @@ gdk_memory_texture_from_texture (GdkTexture      *texture,
   return GDK_MEMORY_TEXTURE (result);
 }
 
+/* Averages 2x2 pixels. For odd sizes, the last row and column
+ * are averaged with themselves.
+ */
+static void
+downscale_u8 (guchar       *dest,
+              gsize         dest_stride,
+              const guchar *src,
+              gsize         src_stride,
+              gsize         bpp,
+              gsize         width,
+              gsize         height)
+{
+  gsize dest_width, dest_height;
+  gsize x, y, c;
+
+  dest_width = (width + 1) / 2;
+  dest_height = (height + 1) / 2;
+
+  for (y = 0; y < dest_height; y++)
+    {
+      const guchar *row0 = src + 2 * y * src_stride;
+      const guchar *row1 = src + MIN (2 * y + 1, height - 1) * src_stride;
+      guchar *dest_row = dest + y * dest_stride;
+
+      for (x = 0; x < dest_width; x++)
+        {
+          gsize x0 = 2 * x * bpp;
+          gsize x1 = MIN (2 * x + 1, width - 1) * bpp;
+
+          for (c = 0; c < bpp; c++)
+            dest_row[x * bpp + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4;
+        }
+    }
+}
+
+static void
+downscale_float (guchar          *dest,
+                 gsize            dest_stride,
+                 const guchar    *src,
+                 gsize            src_stride,
+                 GdkMemoryFormat  format,
+                 gsize            width,
+                 gsize            height)
+{
+  gsize dest_width, dest_height;
+  float *rows, *row0, *row1, *dest_row;
+  gsize x, y, c;
+
+  dest_width = (width + 1) / 2;
+  dest_height = (height + 1) / 2;
+
+  rows = g_new (float, 4 * (2 * width + dest_width));
+  row0 = rows;
+  row1 = row0 + 4 * width;
+  dest_row = row1 + 4 * width;
+
+  for (y = 0; y < dest_height; y++)
+    {
+      gdk_memory_convert ((guchar *) row0, 4 * width * sizeof (float),
+                          GDK_MEMORY_R32G32B32A32_FLOAT_PREMULTIPLIED,
+                          src + 2 * y * src_stride, src_stride, format,
+                          width, 1);
+      gdk_memory_convert ((guchar *) row1, 4 * width * sizeof (float),
+                          GDK_MEMORY_R32G32B32A32_FLOAT_PREMULTIPLIED,
+                          src + MIN (2 * y + 1, height - 1) * src_stride, src_stride, format,
+                          width, 1);
+
+      for (x = 0; x < dest_width; x++)
+        {
+          gsize x0 = 2 * x * 4;
+          gsize x1 = MIN (2 * x + 1, width - 1) * 4;
+
+          for (c = 0; c < 4; c++)
+            dest_row[4 * x + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) / 4;
+        }
+
+      gdk_memory_convert (dest + y * dest_stride, dest_stride, format,
+                          (guchar *) dest_row, 4 * dest_width * sizeof (float),
+                          GDK_MEMORY_R32G32B32A32_FLOAT_PREMULTIPLIED,
+                          dest_width, 1);
+    }
+
+  g_free (rows);
+}
+
+static GdkMemoryTexture *
+gdk_memory_texture_downscale (GdkMemoryTexture *self)
+{
+  GdkTexture *texture = GDK_TEXTURE (self);
+  GdkTexture *result;
+  gsize width, height, bpp, stride;
+  const guchar *src;
+  guchar *data;
+  GBytes *bytes;
+
+  width = (texture->width + 1) / 2;
+  height = (texture->height + 1) / 2;
+  bpp = gdk_memory_format_bytes_per_pixel (texture->format);
+  stride = width * bpp;
+  data = g_malloc_n (stride, height);
+  src = g_bytes_get_data (self->bytes, NULL);
+
+  /* Averaging the bytes is good enough unless the colors
+   * would need to be weighted by a separate alpha channel
+   */
+  if (gdk_memory_format_get_depth (texture->format) == GDK_MEMORY_U8 &&
+      gdk_memory_format_alpha (texture->format) != GDK_MEMORY_ALPHA_STRAIGHT)
+    downscale_u8 (data, stride, src, self->stride, bpp, texture->width, texture->height);
+  else
+    downscale_float (data, stride, src, self->stride, texture->format, texture->width, texture->height);
+
+  bytes = g_bytes_new_take (data, stride * height);
+  result = gdk_memory_texture_new (width, height, texture->format, bytes, stride);
+  g_bytes_unref (bytes);
+
+  return GDK_MEMORY_TEXTURE (result);
+}
+
+/*
+ * gdk_memory_texture_get_lod:
+ * @self: a `GdkMemoryTexture`
+ * @lod: the level of detail
+ *
+ * Gets a version of @self that is scaled down by 2 in each
+ * dimension @lod times, so that renderers can sample very
+ * large images without having to look at all of the pixels.
+ *
+ * The levels are computed on demand and kept around for as
+ * long as @self exists. When @self gets down to a single pixel,
+ * smaller levels are the same as the last one.
+ *
+ * This function is threadsafe.
+ *
+ * Returns: (transfer none): the texture for @lod
+ */
+GdkTexture *
+gdk_memory_texture_get_lod (GdkMemoryTexture *self,
+                            guint             lod)
+{
+  GdkMemoryTexture *level = self;
+
+  g_return_val_if_fail (GDK_IS_MEMORY_TEXTURE (self), NULL);
+
+  for (; lod > 0; lod--)
+    {
+      GdkMemoryTexture *next;
+
+      if (GDK_TEXTURE (level)->width == 1 && GDK_TEXTURE (level)->height == 1)
+        break;
+
+      next = g_atomic_pointer_get (&level->next_lod);
+      if (next == NULL)
+        {
+          next = gdk_memory_texture_downscale (level);
+          if (!g_atomic_pointer_compare_and_exchange (&level->next_lod, NULL, next))
+            {
+              /* Another thread was faster */
+              g_object_unref (next);
+              next = g_atomic_pointer_get (&level->next_lod);
+            }
+        }
+
+      level = next;
+    }
+
+  return GDK_TEXTURE (level);
+}
+
+/*
+ * gdk_memory_texture_peek_lod:
+ * @self: a `GdkMemoryTexture`
+ * @lod: the level of detail
+ *
+ * Gets @lod of @self if it has been computed already, see
+ * gdk_memory_texture_get_lod().
+ *
+ * This function is threadsafe.
+ *
+ * Returns: (nullable) (transfer none): the texture for @lod
+ */
+GdkTexture *
+gdk_memory_texture_peek_lod (GdkMemoryTexture *self,
+                             guint             lod)
+{
+  GdkMemoryTexture *level = self;
+
+  g_return_val_if_fail (GDK_IS_MEMORY_TEXTURE (self), NULL);
+
+  for (; lod > 0; lod--)
+    {
+      if (GDK_TEXTURE (level)->width == 1 && GDK_TEXTURE (level)->height == 1)
+        break;
+
+      level = g_atomic_pointer_get (&level->next_lod);
+      if (level == NULL)
+        return NULL;
+    }
+
+  return GDK_TEXTURE (level);
+}
+
+static void
+prepare_lod_in_thread (GTask        *task,
+                       gpointer      source_object,
+                       gpointer      task_data,
+                       GCancellable *cancellable)
+{
+  gdk_memory_texture_get_lod (source_object, GPOINTER_TO_UINT (task_data));
+
+  g_task_return_boolean (task, TRUE);
+}
+
+/*
+ * gdk_memory_texture_prepare_lod_async:
+ * @self: a `GdkMemoryTexture`
+ * @lod: the level of detail
+ * @cancellable: (nullable): a `GCancellable`
+ * @callback: called when @lod is available
+ * @user_data: data for @callback
+ *
+ * Computes @lod of @self in a thread, so that renderers don't
+ * need to block on the levels of very large images.
+ *
+ * Use gdk_memory_texture_peek_lod() to get the level once
+ * @callback has been called.
+ */
+void
+gdk_memory_texture_prepare_lod_async (GdkMemoryTexture    *self,
+                                      guint                lod,
+                                      GCancellable        *cancellable,
+                                      GAsyncReadyCallback  callback,
+                                      gpointer             user_data)
+{
+  GTask *task;
+
+  g_return_if_fail (GDK_IS_MEMORY_TEXTURE (self));
+
+  task = g_task_new (self, cancellable, callback, user_data);
+  g_task_set_source_tag (task, gdk_memory_texture_prepare_lod_async);
+  g_task_set_task_data (task, GUINT_TO_POINTER (lod), NULL);
+  g_task_run_in_thread (task, prepare_lod_in_thread);
+  g_object_unref (task);
+}
+
+gboolean
+gdk_memory_texture_prepare_lod_finish (GdkMemoryTexture  *self,
+                                       GAsyncResult      *result,
+                                       GError           **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == gdk_memory_texture_prepare_lod_async, FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+#define THUMBNAIL_SIZE 256
+
+/*
+ * gdk_memory_texture_get_thumbnail:
+ * @self: a `GdkMemoryTexture`
+ *
+ * Gets a small version of @self to draw while its levels of
+ * detail are computed.
+ *
+ * The thumbnail has the size of the first level that fits into
+ * 256x256 pixels, but its pixels are sampled from @self instead
+ * of averaged, so it is quick to make even for huge images.
+ * It is kept around for as long as @self exists.
+ *
+ * This function is threadsafe.
+ *
+ * Returns: (transfer none): the thumbnail
+ */
+GdkTexture *
+gdk_memory_texture_get_thumbnail (GdkMemoryTexture *self)
+{
+  GdkTexture *texture = GDK_TEXTURE (self);
+  GdkMemoryTexture *thumbnail;
+  gsize width, height, bpp, stride, x, y;
+  const guchar *src;
+  guchar *data;
+  GBytes *bytes;
+  guint lod;
+
+  g_return_val_if_fail (GDK_IS_MEMORY_TEXTURE (self), NULL);
+
+  if (texture->width <= THUMBNAIL_SIZE && texture->height <= THUMBNAIL_SIZE)
+    return texture;
+
+  thumbnail = g_atomic_pointer_get (&self->thumbnail);
+  if (thumbnail)
+    return GDK_TEXTURE (thumbnail);
+
+  width = texture->width;
+  height = texture->height;
+  for (lod = 0; width > THUMBNAIL_SIZE || height > THUMBNAIL_SIZE; lod++)
+    {
+      width = (width + 1) / 2;
+      height = (height + 1) / 2;
+    }
+
+  bpp = gdk_memory_format_bytes_per_pixel (texture->format);
+  stride = width * bpp;
+  data = g_malloc_n (stride, height);
+  src = g_bytes_get_data (self->bytes, NULL);
+
+  /* Take the pixel in the middle of each block of the level */
+  for (y = 0; y < height; y++)
+    {
+      gsize src_y = MIN ((y << lod) + (((gsize) 1 << lod) >> 1), texture->height - 1);
+
+      for (x = 0; x < width; x++)
+        {
+          gsize src_x = MIN ((x << lod) + (((gsize) 1 << lod) >> 1), texture->width - 1);
+
+          memcpy (data + y * stride + x * bpp,
+                  src + src_y * self->stride + src_x * bpp,
+                  bpp);
+        }
+    }
+
+  bytes = g_bytes_new_take (data, stride * height);
+  thumbnail = GDK_MEMORY_TEXTURE (gdk_memory_texture_new (width, height, texture->format, bytes, stride));
+  g_bytes_unref (bytes);
+
+  if (!g_atomic_pointer_compare_and_exchange (&self->thumbnail, NULL, thumbnail))
+    {
+      /* Another thread was faster */
+      g_object_unref (thumbnail);
+      thumbnail = g_atomic_pointer_get (&self->thumbnail);
+    }
+
+  return GDK_TEXTURE (thumbnail);
+}
+
 GBytes *
 gdk_memory_texture_get_bytes (GdkMemoryTexture *self,
                               gsize            *out_stride)
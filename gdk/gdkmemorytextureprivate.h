@@ -35,6 +35,21 @@ GdkTexture *            gdk_memory_texture_new_subtexture   (GdkMemoryTexture  *
                                                              int                y,
                                                              int                width,
                                                              int                height);
+GdkTexture *            gdk_memory_texture_get_lod          (GdkMemoryTexture  *self,
+                                                             guint              lod);
+GdkTexture *            gdk_memory_texture_peek_lod         (GdkMemoryTexture  *self,
+                                                             guint              lod);
+void                    gdk_memory_texture_prepare_lod_async
+                                                            (GdkMemoryTexture  *self,
+                                                             guint              lod,
+                                                             GCancellable      *cancellable,
+                                                             GAsyncReadyCallback callback,
+                                                             gpointer           user_data);
+gboolean                gdk_memory_texture_prepare_lod_finish
+                                                            (GdkMemoryTexture  *self,
+                                                             GAsyncResult      *result,
+                                                             GError           **error);
+GdkTexture *            gdk_memory_texture_get_thumbnail    (GdkMemoryTexture  *self);
 
 GBytes *                gdk_memory_texture_get_bytes        (GdkMemoryTexture  *self,
                                                              gsize             *out_stride);
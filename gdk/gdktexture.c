@@ -44,6 +44,7 @@
 #include "gdkmemorytextureprivate.h"
 #include "gdkpaintable.h"
 #include "gdksnapshot.h"
+#include "gdktexturecacheprivate.h"
 
 #include <graphene.h>
 #include "loaders/gdkpngprivate.h"
@@ -556,6 +557,110 @@ gdk_texture_new_from_file (GFile   *file,
   return texture;
 }
 
+/**
+ * gdk_texture_new_from_file_at_size:
+ * @file: `GFile` to load
+ * @width: the width the image will be displayed at, or -1
+ * @height: the height the image will be displayed at, or -1
+ * @error: Return location for an error
+ *
+ * Creates a new texture by loading an image from a file,
+ * at a reduced size.
+ *
+ * See [ctor@Gdk.Texture.new_from_bytes_at_size] for details
+ * about the size of the resulting texture.
+ *
+ * This function is threadsafe, so that you can e.g. use GTask
+ * and [method@Gio.Task.run_in_thread] to avoid blocking the main thread
+ * while loading a big image.
+ *
+ * Return value: A newly-created `GdkTexture`
+ *
+ * Since: 4.16
+ */
+GdkTexture *
+gdk_texture_new_from_file_at_size (GFile   *file,
+                                   int      width,
+                                   int      height,
+                                   GError **error)
+{
+  GBytes *bytes;
+  GdkTexture *texture;
+
+  g_return_val_if_fail (G_IS_FILE (file), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  bytes = g_file_load_bytes (file, NULL, NULL, error);
+  if (bytes == NULL)
+    return NULL;
+
+  texture = gdk_texture_new_from_bytes_at_size (bytes, width, height, error);
+
+  g_bytes_unref (bytes);
+
+  return texture;
+}
+
+/*
+ * gdk_texture_load_file:
+ * @file: `GFile` to load
+ * @width: the width the image will be displayed at, or -1
+ * @height: the height the image will be displayed at, or -1
+ * @cancellable: (nullable): a `GCancellable`
+ * @error: Return location for an error
+ *
+ * Loads a texture like gdk_texture_new_from_file_at_size(),
+ * sharing it with earlier loads of the same file.
+ *
+ * This is for GTK's own loaders. The public constructors return
+ * new textures every time, since applications may rely on that,
+ * for example when they set diffs between textures.
+ *
+ * Returns: (transfer full) (nullable): the texture
+ */
+GdkTexture *
+gdk_texture_load_file (GFile         *file,
+                       int            width,
+                       int            height,
+                       GCancellable  *cancellable,
+                       GError       **error)
+{
+  GBytes *bytes;
+  GdkTexture *texture;
+  char *key;
+
+  key = gdk_texture_cache_get_file_key (file);
+  if (key)
+    {
+      texture = gdk_texture_cache_lookup (key, width, height);
+      if (texture)
+        {
+          g_free (key);
+          return texture;
+        }
+    }
+
+  bytes = g_file_load_bytes (file, cancellable, NULL, error);
+  if (bytes)
+    {
+      texture = gdk_texture_new_from_bytes_at_size (bytes, width, height, error);
+
+      /* GTK loads other formats differently depending on the scale,
+       * so don't let it find these
+       */
+      if (key && texture && gdk_texture_can_load (bytes))
+        gdk_texture_cache_insert (key, width, height, texture);
+
+      g_bytes_unref (bytes);
+    }
+  else
+    texture = NULL;
+
+  g_free (key);
+
+  return texture;
+}
+
 gboolean
 gdk_texture_can_load (GBytes *bytes)
 {
@@ -566,19 +671,21 @@ gdk_texture_can_load (GBytes *bytes)
 
 static GdkTexture *
 gdk_texture_new_from_bytes_internal (GBytes  *bytes,
+                                     int      width,
+                                     int      height,
                                      GError **error)
 {
   if (gdk_is_png (bytes))
     {
-      return gdk_load_png (bytes, NULL, error);
+      return gdk_load_png_at_size (bytes, width, height, NULL, error);
     }
   else if (gdk_is_jpeg (bytes))
     {
-      return gdk_load_jpeg (bytes, error);
+      return gdk_load_jpeg_at_size (bytes, width, height, error);
     }
   else if (gdk_is_tiff (bytes))
     {
-      return gdk_load_tiff (bytes, error);
+      return gdk_load_tiff_at_size (bytes, width, height, error);
     }
   else
     {
@@ -591,6 +698,8 @@ gdk_texture_new_from_bytes_internal (GBytes  *bytes,
 
 static GdkTexture *
 gdk_texture_new_from_bytes_pixbuf (GBytes  *bytes,
+                                   int      width,
+                                   int      height,
                                    GError **error)
 {
   GInputStream *stream;
@@ -598,7 +707,14 @@ gdk_texture_new_from_bytes_pixbuf (GBytes  *bytes,
   GdkTexture *texture;
 
   stream = g_memory_input_stream_new_from_bytes (bytes);
-  pixbuf = gdk_pixbuf_new_from_stream (stream, NULL, error);
+  if (width > 0 || height > 0)
+    pixbuf = gdk_pixbuf_new_from_stream_at_scale (stream,
+                                                  width > 0 ? width : -1,
+                                                  height > 0 ? height : -1,
+                                                  TRUE,
+                                                  NULL, error);
+  else
+    pixbuf = gdk_pixbuf_new_from_stream (stream, NULL, error);
   g_object_unref (stream);
   if (pixbuf == NULL)
     return NULL;
@@ -633,6 +749,46 @@ gdk_texture_new_from_bytes_pixbuf (GBytes  *bytes,
 GdkTexture *
 gdk_texture_new_from_bytes (GBytes  *bytes,
                             GError **error)
+{
+  g_return_val_if_fail (bytes != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  return gdk_texture_new_from_bytes_at_size (bytes, -1, -1, error);
+}
+
+/**
+ * gdk_texture_new_from_bytes_at_size:
+ * @bytes: a `GBytes` containing the data to load
+ * @width: the width the image will be displayed at, or -1
+ * @height: the height the image will be displayed at, or -1
+ * @error: Return location for an error
+ *
+ * Creates a new texture by loading an image from memory,
+ * at a reduced size.
+ *
+ * This works like [ctor@Gdk.Texture.new_from_bytes], but the image
+ * is scaled down while it is decoded, so that it is only as large
+ * as needed to be scaled to fit into @width x @height while keeping
+ * its aspect ratio. That way, the memory needed to load a big image
+ * is proportional to the size it is displayed at.
+ *
+ * The resulting texture may be larger than the requested size, but
+ * it is never scaled up. Pass -1 for @width or @height to not
+ * constrain that dimension.
+ *
+ * This function is threadsafe, so that you can e.g. use GTask
+ * and [method@Gio.Task.run_in_thread] to avoid blocking the main thread
+ * while loading a big image.
+ *
+ * Return value: A newly-created `GdkTexture`
+ *
+ * Since: 4.16
+ */
+GdkTexture *
+gdk_texture_new_from_bytes_at_size (GBytes  *bytes,
+                                    int      width,
+                                    int      height,
+                                    GError **error)
 {
   GdkTexture *texture;
   GError *internal_error = NULL;
@@ -640,7 +796,7 @@ gdk_texture_new_from_bytes (GBytes  *bytes,
   g_return_val_if_fail (bytes != NULL, NULL);
   g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-  texture = gdk_texture_new_from_bytes_internal (bytes, &internal_error);
+  texture = gdk_texture_new_from_bytes_internal (bytes, width, height, &internal_error);
   if (texture)
     return texture;
 
@@ -653,7 +809,7 @@ gdk_texture_new_from_bytes (GBytes  *bytes,
 
   g_clear_error (&internal_error);
 
-  return gdk_texture_new_from_bytes_pixbuf (bytes, error);
+  return gdk_texture_new_from_bytes_pixbuf (bytes, width, height, error);
 }
 
 /**
@@ -1026,6 +1182,38 @@ gdk_texture_save_to_png_bytes (GdkTexture *texture)
   return gdk_save_png (texture);
 }
 
+/**
+ * gdk_texture_save_to_png_bytes_with_compression:
+ * @texture: a `GdkTexture`
+ * @compression_level: the compression level from 0 to 9,
+ *   or -1 for the default
+ *
+ * Store the given @texture in memory as a PNG file,
+ * trading size for speed.
+ *
+ * This works like [method@Gdk.Texture.save_to_png_bytes], but lets
+ * you choose how hard to compress the image. 0 does not compress the
+ * image at all, 1 is fastest and 9 produces the smallest files. Low
+ * levels also try fewer PNG filters, which makes them a good choice
+ * for things like screenshots of big windows, when saving needs to
+ * be fast.
+ *
+ * Big images are encoded using multiple threads.
+ *
+ * Returns: a newly allocated `GBytes` containing PNG data
+ *
+ * Since: 4.16
+ */
+GBytes *
+gdk_texture_save_to_png_bytes_with_compression (GdkTexture *texture,
+                                                int         compression_level)
+{
+  g_return_val_if_fail (GDK_IS_TEXTURE (texture), NULL);
+  g_return_val_if_fail (compression_level >= -1 && compression_level <= 9, NULL);
+
+  return gdk_save_png_with_compression (texture, compression_level);
+}
+
 /**
  * gdk_texture_save_to_tiff:
  * @texture: a `GdkTexture`
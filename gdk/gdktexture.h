@@ -75,6 +75,16 @@ GdkTexture *            gdk_texture_new_from_filename          (const char
 GDK_AVAILABLE_IN_4_6
 GdkTexture *            gdk_texture_new_from_bytes             (GBytes          *bytes,
                                                                 GError         **error);
+GDK_AVAILABLE_IN_4_16
+GdkTexture *            gdk_texture_new_from_file_at_size      (GFile           *file,
+                                                                int              width,
+                                                                int              height,
+                                                                GError         **error);
+GDK_AVAILABLE_IN_4_16
+GdkTexture *            gdk_texture_new_from_bytes_at_size     (GBytes          *bytes,
+                                                                int              width,
+                                                                int              height,
+                                                                GError         **error);
 
 GDK_AVAILABLE_IN_ALL
 int                     gdk_texture_get_width                  (GdkTexture      *texture) G_GNUC_PURE;
@@ -92,6 +102,10 @@ gboolean                gdk_texture_save_to_png                (GdkTexture
                                                                 const char      *filename);
 GDK_AVAILABLE_IN_4_6
 GBytes *                gdk_texture_save_to_png_bytes          (GdkTexture      *texture);
+GDK_AVAILABLE_IN_4_16
+GBytes *                gdk_texture_save_to_png_bytes_with_compression
+                                                               (GdkTexture      *texture,
+                                                                int              compression_level);
 GDK_AVAILABLE_IN_4_6
 gboolean                gdk_texture_save_to_tiff               (GdkTexture      *texture,
                                                                 const char      *filename);
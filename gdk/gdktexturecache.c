@@ -0,0 +1,439 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdktexturecacheprivate.h"
+
+#include "gdkmemoryformatprivate.h"
+
+#include <gio/gio.h>
+#include <string.h>
+
+/* A process-wide cache of textures loaded from files and resources.
+ *
+ * Applications tend to load the same images over and over, for example
+ * the same icon in every row of a list, or the same picture in every
+ * window. Each of those loads decodes the image again, and the new
+ * texture gets uploaded to the GPU again.
+ *
+ * So loaded textures are kept here, keyed on where they came from and
+ * the size they were loaded at. For files, the key includes the
+ * modification time, the file size and the file ID (the device and
+ * inode on Unix), so a changed or replaced file is loaded again even
+ * when the change does not show up in the modification time.
+ *
+ * Only GTK's own loaders go through the cache. The public texture
+ * constructors always return new textures.
+ *
+ * Textures are kept alive until they exceed a memory budget, after
+ * which the least recently used ones are dropped. The cache keeps weak
+ * references to all the textures it has seen, so a texture that is
+ * still in use somewhere is shared even when it does not fit into the
+ * budget anymore.
+ *
+ * Textures are loaded in threads, so all of this is protected by a lock.
+ */
+
+/* Default budget for the textures that are kept alive, in MiB */
+#define DEFAULT_MAX_SIZE 64
+
+typedef struct _CacheKey CacheKey;
+typedef struct _CacheEntry CacheEntry;
+
+struct _CacheKey
+{
+  char *key;
+  int width;
+  int height;
+};
+
+struct _CacheEntry
+{
+  CacheKey key;
+  GWeakRef texture;
+  /* set while the entry is in the lru */
+  GdkTexture *kept;
+  gsize size;
+  GList lru_link;
+};
+
+static GMutex lock;
+static GHashTable *cache;
+static GQueue lru;
+static gsize size;
+static gsize max_size;
+static guint64 n_hits;
+static guint64 n_misses;
+static guint64 n_evictions;
+
+static guint
+cache_key_hash (gconstpointer data)
+{
+  const CacheKey *key = data;
+  guint hash;
+
+  hash = g_str_hash (key->key);
+  hash = (hash << 5) - hash + (guint) key->width;
+  hash = (hash << 5) - hash + (guint) key->height;
+
+  return hash;
+}
+
+static gboolean
+cache_key_equal (gconstpointer data1,
+                 gconstpointer data2)
+{
+  const CacheKey *a = data1;
+  const CacheKey *b = data2;
+
+  return a->width == b->width &&
+         a->height == b->height &&
+         strcmp (a->key, b->key) == 0;
+}
+
+static void
+cache_entry_free (gpointer data)
+{
+  CacheEntry *entry = data;
+
+  g_assert (entry->kept == NULL);
+
+  g_weak_ref_clear (&entry->texture);
+  g_free (entry->key.key);
+  g_free (entry);
+}
+
+/* Call with the lock held. Returns the texture to unref,
+ * which should be done after dropping the lock.
+ */
+static GdkTexture *
+cache_entry_release (CacheEntry *entry)
+{
+  g_queue_unlink (&lru, &entry->lru_link);
+  size -= entry->size;
+
+  return g_steal_pointer (&entry->kept);
+}
+
+static gboolean
+cache_ensure (void)
+{
+  static gsize initialized = 0;
+
+  if (g_once_init_enter (&initialized))
+    {
+      const char *str;
+
+      max_size = DEFAULT_MAX_SIZE;
+
+      str = g_getenv ("GDK_TEXTURE_CACHE_SIZE");
+      if (str != NULL)
+        {
+          guint64 value;
+          GError *error = NULL;
+
+          if (!g_ascii_string_to_unsigned (str, 10, 0, G_MAXSIZE >> 20, &value, &error))
+            {
+              g_warning ("Failed to parse GDK_TEXTURE_CACHE_SIZE: %s", error->message);
+              g_error_free (error);
+            }
+          else
+            {
+              max_size = value;
+            }
+        }
+
+      max_size <<= 20;
+      cache = g_hash_table_new_full (cache_key_hash, cache_key_equal, NULL, cache_entry_free);
+
+      g_once_init_leave (&initialized, 1);
+    }
+
+  return max_size > 0;
+}
+
+static gboolean
+cache_entry_is_dead (gpointer key,
+                     gpointer value,
+                     gpointer data)
+{
+  CacheEntry *entry = value;
+  GdkTexture *texture;
+
+  if (entry->kept)
+    return FALSE;
+
+  texture = g_weak_ref_get (&entry->texture);
+  if (texture == NULL)
+    return TRUE;
+
+  g_object_unref (texture);
+  return FALSE;
+}
+
+/*
+ * gdk_texture_cache_get_file_key:
+ * @file: a `GFile`
+ *
+ * Creates the key for textures loaded from @file, which
+ * includes its modification time, size and ID.
+ *
+ * Returns: (nullable): the key, or %NULL if the
+ *   textures from @file cannot be cached
+ */
+char *
+gdk_texture_cache_get_file_key (GFile *file)
+{
+  GFileInfo *info;
+  GDateTime *mtime;
+  const char *id;
+  goffset file_size;
+  char *uri, *key;
+
+  if (!cache_ensure ())
+    return NULL;
+
+  /* Resources don't change */
+  if (g_file_has_uri_scheme (file, "resource"))
+    return g_file_get_uri (file);
+
+  info = g_file_query_info (file,
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC ","
+                            G_FILE_ATTRIBUTE_STANDARD_SIZE ","
+                            G_FILE_ATTRIBUTE_ID_FILE,
+                            G_FILE_QUERY_INFO_NONE,
+                            NULL, NULL);
+  if (info == NULL)
+    return NULL;
+
+  mtime = g_file_info_get_modification_date_time (info);
+  if (mtime == NULL ||
+      !g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_SIZE))
+    {
+      g_clear_pointer (&mtime, g_date_time_unref);
+      g_object_unref (info);
+      return NULL;
+    }
+
+  file_size = g_file_info_get_size (info);
+  id = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_ID_FILE);
+
+  uri = g_file_get_uri (file);
+  key = g_strdup_printf ("%s@%" G_GINT64_FORMAT ":%" G_GOFFSET_FORMAT ":%s",
+                         uri, g_date_time_to_unix_usec (mtime), file_size,
+                         id ? id : "");
+
+  g_object_unref (info);
+
+  g_free (uri);
+  g_date_time_unref (mtime);
+
+  return key;
+}
+
+/*
+ * gdk_texture_cache_get_resource_key:
+ * @resource_path: a resource path
+ *
+ * Creates the key for textures loaded from the resource
+ * at @resource_path.
+ *
+ * Returns: (nullable): the key, or %NULL if the cache is disabled
+ */
+char *
+gdk_texture_cache_get_resource_key (const char *resource_path)
+{
+  if (!cache_ensure ())
+    return NULL;
+
+  /* The same as the URI of the GFile for the resource */
+  return g_strconcat ("resource://", resource_path, NULL);
+}
+
+/*
+ * gdk_texture_cache_lookup:
+ * @key: a key from gdk_texture_cache_get_file_key() or
+ *   gdk_texture_cache_get_resource_key()
+ * @width: the width the texture was loaded at, or -1
+ * @height: the height the texture was loaded at, or -1
+ *
+ * Looks up a texture that was loaded before.
+ *
+ * Returns: (transfer full) (nullable): the texture
+ */
+GdkTexture *
+gdk_texture_cache_lookup (const char *key,
+                          int         width,
+                          int         height)
+{
+  CacheKey lookup = { (char *) key, width, height };
+  CacheEntry *entry;
+  GdkTexture *texture;
+
+  if (!cache_ensure ())
+    return NULL;
+
+  g_mutex_lock (&lock);
+
+  entry = g_hash_table_lookup (cache, &lookup);
+  if (entry == NULL)
+    {
+      n_misses++;
+      g_mutex_unlock (&lock);
+      return NULL;
+    }
+
+  texture = g_weak_ref_get (&entry->texture);
+  if (texture == NULL)
+    {
+      /* It's gone, and so it can't be kept */
+      g_assert (entry->kept == NULL);
+      g_hash_table_remove (cache, &lookup);
+      n_misses++;
+      g_mutex_unlock (&lock);
+      return NULL;
+    }
+
+  n_hits++;
+
+  if (entry->kept)
+    {
+      g_queue_unlink (&lru, &entry->lru_link);
+      g_queue_push_head_link (&lru, &entry->lru_link);
+    }
+
+  g_mutex_unlock (&lock);
+
+  return texture;
+}
+
+/*
+ * gdk_texture_cache_insert:
+ * @key: the key that gdk_texture_cache_lookup() did not find
+ * @width: the width the texture was loaded at, or -1
+ * @height: the height the texture was loaded at, or -1
+ * @texture: the loaded texture
+ *
+ * Adds a texture, so the next load from the same place
+ * at the same size finds it.
+ */
+void
+gdk_texture_cache_insert (const char *key,
+                          int         width,
+                          int         height,
+                          GdkTexture *texture)
+{
+  CacheKey lookup = { (char *) key, width, height };
+  CacheEntry *entry;
+  GSList *unref = NULL;
+
+  if (!cache_ensure ())
+    return;
+
+  g_mutex_lock (&lock);
+
+  /* Someone else loaded the same texture at the same time */
+  entry = g_hash_table_lookup (cache, &lookup);
+  if (entry)
+    {
+      if (entry->kept)
+        unref = g_slist_prepend (unref, cache_entry_release (entry));
+      g_hash_table_remove (cache, &lookup);
+    }
+
+  entry = g_new0 (CacheEntry, 1);
+  entry->key.key = g_strdup (key);
+  entry->key.width = width;
+  entry->key.height = height;
+  g_weak_ref_init (&entry->texture, texture);
+  entry->size = (gsize) gdk_texture_get_width (texture) *
+                gdk_texture_get_height (texture) *
+                gdk_memory_format_bytes_per_pixel (gdk_texture_get_format (texture));
+  entry->lru_link.data = entry;
+
+  g_hash_table_add (cache, entry);
+
+  /* Textures that would evict everything else are only shared
+   * for as long as they are alive
+   */
+  if (entry->size <= max_size)
+    {
+      entry->kept = g_object_ref (texture);
+      g_queue_push_head_link (&lru, &entry->lru_link);
+      size += entry->size;
+    }
+
+  while (size > max_size)
+    {
+      CacheEntry *last = g_queue_peek_tail (&lru);
+
+      unref = g_slist_prepend (unref, cache_entry_release (last));
+      n_evictions++;
+    }
+
+  /* Don't let entries of textures that are gone pile up */
+  if (g_hash_table_size (cache) > 2 * lru.length + 256)
+    g_hash_table_foreach_remove (cache, cache_entry_is_dead, NULL);
+
+  g_mutex_unlock (&lock);
+
+  g_slist_free_full (unref, g_object_unref);
+}
+
+/*
+ * gdk_texture_cache_clear:
+ *
+ * Drops all textures from the cache.
+ */
+void
+gdk_texture_cache_clear (void)
+{
+  GSList *unref = NULL;
+
+  cache_ensure ();
+
+  g_mutex_lock (&lock);
+
+  while (lru.length > 0)
+    unref = g_slist_prepend (unref, cache_entry_release (g_queue_peek_tail (&lru)));
+
+  g_hash_table_remove_all (cache);
+
+  g_mutex_unlock (&lock);
+
+  g_slist_free_full (unref, g_object_unref);
+}
+
+void
+gdk_texture_cache_get_stats (GdkTextureCacheStats *stats)
+{
+  cache_ensure ();
+
+  g_mutex_lock (&lock);
+
+  stats->n_entries = g_hash_table_size (cache);
+  stats->n_kept = lru.length;
+  stats->size = size;
+  stats->max_size = max_size;
+  stats->n_hits = n_hits;
+  stats->n_misses = n_misses;
+  stats->n_evictions = n_evictions;
+
+  g_mutex_unlock (&lock);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gdktexture.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GdkTextureCacheStats GdkTextureCacheStats;
+
+struct _GdkTextureCacheStats
+{
+  guint   n_entries;
+  guint   n_kept;
+  gsize   size;
+  gsize   max_size;
+  guint64 n_hits;
+  guint64 n_misses;
+  guint64 n_evictions;
+};
+
+char *          gdk_texture_cache_get_file_key          (GFile                  *file);
+char *          gdk_texture_cache_get_resource_key      (const char             *resource_path);
+
+GdkTexture *    gdk_texture_cache_lookup                (const char             *key,
+                                                         int                     width,
+                                                         int                     height);
+void            gdk_texture_cache_insert                (const char             *key,
+                                                         int                     width,
+                                                         int                     height,
+                                                         GdkTexture             *texture);
+void            gdk_texture_cache_clear                 (void);
+void            gdk_texture_cache_get_stats             (GdkTextureCacheStats   *stats);
+
+G_END_DECLS
@@ -0,0 +1,629 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdktextureloaderprivate.h"
+
+#include "gdkpaintable.h"
+#include "gdkprofilerprivate.h"
+#include "gdksnapshot.h"
+#include "gdktexture.h"
+#include "loaders/gdkjpegprivate.h"
+#include "loaders/gdkpngprivate.h"
+
+/**
+ * GdkTextureLoader:
+ *
+ * `GdkTextureLoader` is a [iface@Gdk.Paintable] that loads an image
+ * in a thread and shows it as soon as something is available.
+ *
+ * The image is read from a [class@Gio.InputStream] while it is being
+ * decoded, so that slow sources like network file systems do not need
+ * to deliver the whole file before decoding can start.
+ *
+ * For formats that support it, like progressive JPEG and interlaced
+ * PNG, coarse previews of the image are shown while the rest of the
+ * data arrives. Every time a better version is available, the contents
+ * of the paintable are invalidated. Other formats are shown once they
+ * are loaded completely.
+ *
+ * Loading starts as soon as the loader is created. It is cancelled
+ * when the loader is disposed.
+ *
+ * Since: 4.16
+ */
+
+struct _GdkTextureLoader
+{
+  GObject parent_instance;
+
+  GCancellable *cancellable;
+
+  GdkTexture *texture;
+  GError *error;
+  guint loading : 1;
+};
+
+struct _GdkTextureLoaderClass
+{
+  GObjectClass parent_class;
+};
+
+enum
+{
+  PROP_0,
+  PROP_LOADING,
+  PROP_TEXTURE,
+
+  N_PROPS
+};
+
+static GParamSpec *properties[N_PROPS] = { NULL, };
+
+/* The state of the loading thread. It must not touch the loader
+ * itself, which may go away while it runs. Previews keep a reference
+ * of their own, since they may outlive the thread.
+ */
+typedef struct _LoadData LoadData;
+
+struct _LoadData
+{
+  GWeakRef loader;
+  GMainContext *context;
+  GFile *file;
+  GInputStream *stream;
+};
+
+typedef struct _Preview Preview;
+
+struct _Preview
+{
+  LoadData *load;
+  GdkTexture *texture;
+};
+
+static void
+load_data_clear (gpointer data)
+{
+  LoadData *load = data;
+
+  g_weak_ref_clear (&load->loader);
+  g_main_context_unref (load->context);
+  g_clear_object (&load->file);
+  g_clear_object (&load->stream);
+}
+
+static void
+load_data_unref (gpointer data)
+{
+  g_atomic_rc_box_release_full (data, load_data_clear);
+}
+
+static void
+preview_free (gpointer data)
+{
+  Preview *preview = data;
+
+  load_data_unref (preview->load);
+  g_object_unref (preview->texture);
+  g_free (preview);
+}
+
+static void
+gdk_texture_loader_set_texture (GdkTextureLoader *self,
+                                GdkTexture       *texture)
+{
+  gboolean size_changed;
+
+  if (self->texture == texture)
+    return;
+
+  size_changed = self->texture == NULL ||
+                 gdk_texture_get_width (self->texture) != gdk_texture_get_width (texture) ||
+                 gdk_texture_get_height (self->texture) != gdk_texture_get_height (texture);
+
+  g_set_object (&self->texture, texture);
+
+  if (size_changed)
+    gdk_paintable_invalidate_size (GDK_PAINTABLE (self));
+  gdk_paintable_invalidate_contents (GDK_PAINTABLE (self));
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_TEXTURE]);
+}
+
+static gboolean
+gdk_texture_loader_apply_preview (gpointer data)
+{
+  Preview *preview = data;
+  GdkTextureLoader *self;
+
+  self = g_weak_ref_get (&preview->load->loader);
+  if (self == NULL)
+    return G_SOURCE_REMOVE;
+
+  /* Don't let a late preview replace the final image */
+  if (self->loading)
+    gdk_texture_loader_set_texture (self, preview->texture);
+
+  g_object_unref (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Called in the loading thread */
+static void
+gdk_texture_loader_preview (GdkTexture *texture,
+                            gpointer    data)
+{
+  LoadData *load = data;
+  Preview *preview;
+
+  preview = g_new0 (Preview, 1);
+  preview->load = g_atomic_rc_box_acquire (load);
+  preview->texture = g_object_ref (texture);
+
+  g_main_context_invoke_full (load->context,
+                              G_PRIORITY_DEFAULT,
+                              gdk_texture_loader_apply_preview,
+                              preview,
+                              preview_free);
+}
+
+static GBytes *
+read_all (GInputStream  *stream,
+          GCancellable  *cancellable,
+          GError       **error)
+{
+  GOutputStream *output;
+  GBytes *bytes;
+
+  output = g_memory_output_stream_new_resizable ();
+
+  if (g_output_stream_splice (output,
+                              stream,
+                              G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET,
+                              cancellable,
+                              error) < 0)
+    {
+      g_object_unref (output);
+      return NULL;
+    }
+
+  bytes = g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (output));
+  g_object_unref (output);
+
+  return bytes;
+}
+
+static GdkTexture *
+load_from_stream (LoadData      *load,
+                  GInputStream  *stream,
+                  GCancellable  *cancellable,
+                  GError       **error)
+{
+  GBufferedInputStream *buffered;
+  GdkTexture *texture;
+  GBytes *bytes;
+  const void *data;
+  gsize size;
+
+  buffered = G_BUFFERED_INPUT_STREAM (g_buffered_input_stream_new (stream));
+
+  /* Read enough to know the format */
+  while (g_buffered_input_stream_get_available (buffered) < 16)
+    {
+      gssize n_read;
+
+      n_read = g_buffered_input_stream_fill (buffered,
+                                             16 - g_buffered_input_stream_get_available (buffered),
+                                             cancellable,
+                                             error);
+      if (n_read < 0)
+        {
+          g_object_unref (buffered);
+          return NULL;
+        }
+      else if (n_read == 0)
+        break;
+    }
+
+  data = g_buffered_input_stream_peek_buffer (buffered, &size);
+  bytes = g_bytes_new_static (data, size);
+
+  if (gdk_is_png (bytes))
+    {
+      texture = gdk_load_png_from_stream (G_INPUT_STREAM (buffered),
+                                          gdk_texture_loader_preview, load,
+                                          cancellable,
+                                          error);
+    }
+  else if (gdk_is_jpeg (bytes))
+    {
+      texture = gdk_load_jpeg_from_stream (G_INPUT_STREAM (buffered),
+                                           gdk_texture_loader_preview, load,
+                                           cancellable,
+                                           error);
+    }
+  else
+    {
+      GBytes *all;
+
+      all = read_all (G_INPUT_STREAM (buffered), cancellable, error);
+      if (all)
+        {
+          texture = gdk_texture_new_from_bytes (all, error);
+          g_bytes_unref (all);
+        }
+      else
+        texture = NULL;
+    }
+
+  g_bytes_unref (bytes);
+  g_object_unref (buffered);
+
+  return texture;
+}
+
+static void
+gdk_texture_loader_load_thread (GTask        *task,
+                                gpointer      source_object,
+                                gpointer      task_data,
+                                GCancellable *cancellable)
+{
+  LoadData *load = task_data;
+  GInputStream *stream;
+  GdkTexture *texture;
+  GError *error = NULL;
+  G_GNUC_UNUSED gint64 before = GDK_PROFILER_CURRENT_TIME;
+
+  if (load->stream)
+    stream = g_object_ref (load->stream);
+  else
+    stream = G_INPUT_STREAM (g_file_read (load->file, cancellable, &error));
+
+  if (stream == NULL)
+    {
+      g_task_return_error (task, error);
+      return;
+    }
+
+  texture = load_from_stream (load, stream, cancellable, &error);
+  g_object_unref (stream);
+
+  gdk_profiler_end_mark (before, "Texture loader", NULL);
+
+  if (texture)
+    g_task_return_pointer (task, texture, g_object_unref);
+  else
+    g_task_return_error (task, error);
+}
+
+static void
+gdk_texture_loader_load_done (GObject      *source,
+                              GAsyncResult *result,
+                              gpointer      data)
+{
+  LoadData *load = g_task_get_task_data (G_TASK (result));
+  GdkTextureLoader *self;
+  GdkTexture *texture;
+  GError *error = NULL;
+
+  texture = g_task_propagate_pointer (G_TASK (result), &error);
+
+  self = g_weak_ref_get (&load->loader);
+  if (self == NULL)
+    {
+      g_clear_object (&texture);
+      g_clear_error (&error);
+      return;
+    }
+
+  self->loading = FALSE;
+
+  if (texture)
+    {
+      gdk_texture_loader_set_texture (self, texture);
+      g_object_unref (texture);
+    }
+  else
+    {
+      /* Keep the last preview, if there was one */
+      self->error = error;
+    }
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOADING]);
+
+  g_object_unref (self);
+}
+
+static void
+gdk_texture_loader_start (GdkTextureLoader *self,
+                          GFile            *file,
+                          GInputStream     *stream)
+{
+  LoadData *load;
+  GTask *task;
+
+  load = g_atomic_rc_box_new0 (LoadData);
+  g_weak_ref_init (&load->loader, self);
+  load->context = g_main_context_ref_thread_default ();
+  load->file = file ? g_object_ref (file) : NULL;
+  load->stream = stream ? g_object_ref (stream) : NULL;
+
+  self->loading = TRUE;
+
+  task = g_task_new (NULL, self->cancellable, gdk_texture_loader_load_done, NULL);
+  g_task_set_source_tag (task, gdk_texture_loader_start);
+  g_task_set_static_name (task, "[gdk] texture loader");
+  g_task_set_task_data (task, load, load_data_unref);
+  g_task_run_in_thread (task, gdk_texture_loader_load_thread);
+  g_object_unref (task);
+}
+
+static void
+gdk_texture_loader_paintable_snapshot (GdkPaintable *paintable,
+                                       GdkSnapshot  *snapshot,
+                                       double        width,
+                                       double        height)
+{
+  GdkTextureLoader *self = GDK_TEXTURE_LOADER (paintable);
+
+  if (self->texture)
+    gdk_paintable_snapshot (GDK_PAINTABLE (self->texture), snapshot, width, height);
+}
+
+static GdkPaintable *
+gdk_texture_loader_paintable_get_current_image (GdkPaintable *paintable)
+{
+  GdkTextureLoader *self = GDK_TEXTURE_LOADER (paintable);
+
+  if (self->texture)
+    return GDK_PAINTABLE (g_object_ref (self->texture));
+
+  return gdk_paintable_new_empty (0, 0);
+}
+
+static int
+gdk_texture_loader_paintable_get_intrinsic_width (GdkPaintable *paintable)
+{
+  GdkTextureLoader *self = GDK_TEXTURE_LOADER (paintable);
+
+  return self->texture ? gdk_texture_get_width (self->texture) : 0;
+}
+
+static int
+gdk_texture_loader_paintable_get_intrinsic_height (GdkPaintable *paintable)
+{
+  GdkTextureLoader *self = GDK_TEXTURE_LOADER (paintable);
+
+  return self->texture ? gdk_texture_get_height (self->texture) : 0;
+}
+
+static void
+gdk_texture_loader_paintable_init (GdkPaintableInterface *iface)
+{
+  iface->snapshot = gdk_texture_loader_paintable_snapshot;
+  iface->get_current_image = gdk_texture_loader_paintable_get_current_image;
+  iface->get_intrinsic_width = gdk_texture_loader_paintable_get_intrinsic_width;
+  iface->get_intrinsic_height = gdk_texture_loader_paintable_get_intrinsic_height;
+}
+
+G_DEFINE_TYPE_WITH_CODE (GdkTextureLoader, gdk_texture_loader, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GDK_TYPE_PAINTABLE,
+                                                gdk_texture_loader_paintable_init))
+
+static void
+gdk_texture_loader_get_property (GObject    *object,
+                                 guint       property_id,
+                                 GValue     *value,
+                                 GParamSpec *pspec)
+{
+  GdkTextureLoader *self = GDK_TEXTURE_LOADER (object);
+
+  switch (property_id)
+    {
+    case PROP_LOADING:
+      g_value_set_boolean (value, self->loading);
+      break;
+
+    case PROP_TEXTURE:
+      g_value_set_object (value, self->texture);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+    }
+}
+
+static void
+gdk_texture_loader_dispose (GObject *object)
+{
+  GdkTextureLoader *self = GDK_TEXTURE_LOADER (object);
+
+  g_cancellable_cancel (self->cancellable);
+
+  g_clear_object (&self->texture);
+
+  G_OBJECT_CLASS (gdk_texture_loader_parent_class)->dispose (object);
+}
+
+static void
+gdk_texture_loader_finalize (GObject *object)
+{
+  GdkTextureLoader *self = GDK_TEXTURE_LOADER (object);
+
+  g_clear_object (&self->cancellable);
+  g_clear_error (&self->error);
+
+  G_OBJECT_CLASS (gdk_texture_loader_parent_class)->finalize (object);
+}
+
+static void
+gdk_texture_loader_class_init (GdkTextureLoaderClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->get_property = gdk_texture_loader_get_property;
+  gobject_class->dispose = gdk_texture_loader_dispose;
+  gobject_class->finalize = gdk_texture_loader_finalize;
+
+  /**
+   * GdkTextureLoader:loading: (attributes org.gtk.Property.get=gdk_texture_loader_is_loading)
+   *
+   * Whether the image is still being loaded.
+   *
+   * Since: 4.16
+   */
+  properties[PROP_LOADING] =
+    g_param_spec_boolean ("loading", NULL, NULL,
+                          TRUE,
+                          G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GdkTextureLoader:texture: (attributes org.gtk.Property.get=gdk_texture_loader_get_texture)
+   *
+   * The best version of the image that is available so far.
+   *
+   * Since: 4.16
+   */
+  properties[PROP_TEXTURE] =
+    g_param_spec_object ("texture", NULL, NULL,
+                         GDK_TYPE_TEXTURE,
+                         G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (gobject_class, N_PROPS, properties);
+}
+
+static void
+gdk_texture_loader_init (GdkTextureLoader *self)
+{
+  self->cancellable = g_cancellable_new ();
+}
+
+/**
+ * gdk_texture_loader_new_for_file:
+ * @file: the file to load
+ *
+ * Creates a new `GdkTextureLoader` and starts loading @file.
+ *
+ * Returns: a new `GdkTextureLoader`
+ *
+ * Since: 4.16
+ */
+GdkTextureLoader *
+gdk_texture_loader_new_for_file (GFile *file)
+{
+  GdkTextureLoader *self;
+
+  g_return_val_if_fail (G_IS_FILE (file), NULL);
+
+  self = g_object_new (GDK_TYPE_TEXTURE_LOADER, NULL);
+
+  gdk_texture_loader_start (self, file, NULL);
+
+  return self;
+}
+
+/**
+ * gdk_texture_loader_new_for_stream:
+ * @stream: the stream to load the image from
+ *
+ * Creates a new `GdkTextureLoader` and starts loading
+ * an image from @stream.
+ *
+ * The stream is read from a thread, so it must not be
+ * used by anything else until loading is done.
+ *
+ * Returns: a new `GdkTextureLoader`
+ *
+ * Since: 4.16
+ */
+GdkTextureLoader *
+gdk_texture_loader_new_for_stream (GInputStream *stream)
+{
+  GdkTextureLoader *self;
+
+  g_return_val_if_fail (G_IS_INPUT_STREAM (stream), NULL);
+
+  self = g_object_new (GDK_TYPE_TEXTURE_LOADER, NULL);
+
+  gdk_texture_loader_start (self, NULL, stream);
+
+  return self;
+}
+
+/**
+ * gdk_texture_loader_get_texture: (attributes org.gtk.Method.get_property=texture)
+ * @self: a `GdkTextureLoader`
+ *
+ * Gets the best version of the image that has been loaded so far.
+ *
+ * While [property@Gdk.TextureLoader:loading] is %TRUE, this is
+ * a preview of the image, if one is available. Once loading is
+ * done, it is the final image.
+ *
+ * If loading failed, this may still return the last preview.
+ *
+ * Returns: (nullable) (transfer none): the texture
+ *
+ * Since: 4.16
+ */
+GdkTexture *
+gdk_texture_loader_get_texture (GdkTextureLoader *self)
+{
+  g_return_val_if_fail (GDK_IS_TEXTURE_LOADER (self), NULL);
+
+  return self->texture;
+}
+
+/**
+ * gdk_texture_loader_is_loading: (attributes org.gtk.Method.get_property=loading)
+ * @self: a `GdkTextureLoader`
+ *
+ * Returns whether the image is still being loaded.
+ *
+ * Returns: %TRUE while loading
+ *
+ * Since: 4.16
+ */
+gboolean
+gdk_texture_loader_is_loading (GdkTextureLoader *self)
+{
+  g_return_val_if_fail (GDK_IS_TEXTURE_LOADER (self), FALSE);
+
+  return self->loading;
+}
+
+/**
+ * gdk_texture_loader_get_error:
+ * @self: a `GdkTextureLoader`
+ *
+ * Gets the error that happened while loading, if any.
+ *
+ * Returns: (nullable): the error
+ *
+ * Since: 4.16
+ */
+const GError *
+gdk_texture_loader_get_error (GdkTextureLoader *self)
+{
+  g_return_val_if_fail (GDK_IS_TEXTURE_LOADER (self), NULL);
+
+  return self->error;
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#if !defined (__GDK_H_INSIDE__) && !defined (GTK_COMPILATION)
+#error "Only <gdk/gdk.h> can be included directly."
+#endif
+
+#include <gdk/gdktypes.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_TEXTURE_LOADER (gdk_texture_loader_get_type ())
+GDK_AVAILABLE_IN_4_16
+GDK_DECLARE_INTERNAL_TYPE (GdkTextureLoader, gdk_texture_loader, GDK, TEXTURE_LOADER, GObject)
+
+GDK_AVAILABLE_IN_4_16
+GdkTextureLoader *      gdk_texture_loader_new_for_file         (GFile                  *file);
+GDK_AVAILABLE_IN_4_16
+GdkTextureLoader *      gdk_texture_loader_new_for_stream       (GInputStream           *stream);
+
+GDK_AVAILABLE_IN_4_16
+GdkTexture *            gdk_texture_loader_get_texture          (GdkTextureLoader       *self);
+GDK_AVAILABLE_IN_4_16
+gboolean                gdk_texture_loader_is_loading           (GdkTextureLoader       *self);
+GDK_AVAILABLE_IN_4_16
+const GError *          gdk_texture_loader_get_error            (GdkTextureLoader       *self);
+
+G_END_DECLS
@@ -0,0 +1,30 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gdktextureloader.h"
+
+G_BEGIN_DECLS
+
+/* Called by the loaders from the loading thread, whenever
+ * a better preview of the image than the last one is available.
+ */
+typedef void (* GdkTextureLoaderPreviewFunc) (GdkTexture *preview,
+                                              gpointer    user_data);
+
+G_END_DECLS
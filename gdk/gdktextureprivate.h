@@ -51,6 +51,11 @@ struct _GdkTextureClass {
 };
 
 gboolean                gdk_texture_can_load            (GBytes                 *bytes);
+GdkTexture *            gdk_texture_load_file           (GFile                  *file,
+                                                         int                     width,
+                                                         int                     height,
+                                                         GCancellable           *cancellable,
+                                                         GError                **error);
 
 GdkTexture *            gdk_texture_new_for_surface     (cairo_surface_t        *surface);
 cairo_surface_t *       gdk_texture_download_surface    (GdkTexture             *texture);
@@ -0,0 +1,175 @@
+/* GDK - The GIMP Drawing Kit
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkdownscalerprivate.h"
+
+#include <string.h>
+
+/*
+ * gdk_downscaler_init:
+ * @self: the downscaler to initialize
+ * @src_width: the width of the rows that are added
+ * @factor: the factor to scale down by
+ * @n_channels: the number of channels per pixel
+ * @bytes_per_channel: 1 or 2, for 8bit and native endian 16bit channels
+ * @straight_alpha: %TRUE if the last channel is alpha, and the
+ *   other channels are not premultiplied with it
+ *
+ * Sets up a downscaler that box filters blocks of @factor x @factor
+ * pixels. Blocks at the right and bottom edges may be smaller.
+ *
+ * Straight alpha is taken into account by weighting colors with
+ * their alpha, so that fully transparent pixels do not bleed their
+ * color into their neighbours.
+ */
+void
+gdk_downscaler_init (GdkDownscaler *self,
+                     gsize          src_width,
+                     guint          factor,
+                     guint          n_channels,
+                     guint          bytes_per_channel,
+                     gboolean       straight_alpha)
+{
+  g_assert (factor > 0);
+  g_assert (bytes_per_channel == 1 || bytes_per_channel == 2);
+  g_assert (!straight_alpha || n_channels > 1);
+
+  self->src_width = src_width;
+  self->width = gdk_downscaler_get_size (src_width, factor);
+  self->factor = factor;
+  self->n_channels = n_channels;
+  self->bytes_per_channel = bytes_per_channel;
+  self->straight_alpha = straight_alpha;
+  self->sums = g_new0 (guint64, self->width * n_channels);
+  self->n_rows = 0;
+}
+
+void
+gdk_downscaler_finish (GdkDownscaler *self)
+{
+  g_clear_pointer (&self->sums, g_free);
+}
+
+#define ACCUMULATE(type) G_STMT_START { \
+  const type *src = (const type *) row; \
+  for (x = 0; x < self->src_width; x++) \
+    { \
+      guint64 *sum = &self->sums[(x / self->factor) * n_channels]; \
+      if (self->straight_alpha) \
+        { \
+          guint64 alpha = src[n_channels - 1]; \
+          for (c = 0; c < n_channels - 1; c++) \
+            sum[c] += src[c] * alpha; \
+          sum[n_channels - 1] += alpha; \
+        } \
+      else \
+        { \
+          for (c = 0; c < n_channels; c++) \
+            sum[c] += src[c]; \
+        } \
+      src += n_channels; \
+    } \
+} G_STMT_END
+
+#define EMIT(type) G_STMT_START { \
+  type *out = (type *) dest; \
+  for (x = 0; x < self->width; x++) \
+    { \
+      guint64 *sum = &self->sums[x * n_channels]; \
+      guint64 count = (guint64) MIN (self->factor, self->src_width - x * self->factor) * self->n_rows; \
+      if (self->straight_alpha) \
+        { \
+          guint64 alpha = sum[n_channels - 1]; \
+          for (c = 0; c < n_channels - 1; c++) \
+            out[c] = alpha ? (sum[c] + alpha / 2) / alpha : 0; \
+          out[n_channels - 1] = (alpha + count / 2) / count; \
+        } \
+      else \
+        { \
+          for (c = 0; c < n_channels; c++) \
+            out[c] = (sum[c] + count / 2) / count; \
+        } \
+      out += n_channels; \
+    } \
+} G_STMT_END
+
+/*
+ * gdk_downscaler_add_row:
+ * @self: a `GdkDownscaler`
+ * @row: the next row of the source image
+ * @dest: where to put the next row of the scaled image
+ *
+ * Adds a row to the downscaler. Once @factor rows have been added,
+ * the resulting row is written to @dest.
+ *
+ * Returns: %TRUE if a row was written to @dest
+ */
+gboolean
+gdk_downscaler_add_row (GdkDownscaler *self,
+                        const guchar  *row,
+                        guchar        *dest)
+{
+  guint n_channels = self->n_channels;
+  gsize x;
+  guint c;
+
+  if (self->bytes_per_channel == 1)
+    ACCUMULATE (guint8);
+  else
+    ACCUMULATE (guint16);
+
+  self->n_rows++;
+
+  if (self->n_rows < self->factor)
+    return FALSE;
+
+  return gdk_downscaler_flush (self, dest);
+}
+
+/*
+ * gdk_downscaler_flush:
+ * @self: a `GdkDownscaler`
+ * @dest: where to put the row of the scaled image
+ *
+ * Writes out the rows that have been added so far, which
+ * may be less than @factor at the bottom of the image.
+ *
+ * Returns: %TRUE if a row was written to @dest
+ */
+gboolean
+gdk_downscaler_flush (GdkDownscaler *self,
+                      guchar        *dest)
+{
+  guint n_channels = self->n_channels;
+  gsize x;
+  guint c;
+
+  if (self->n_rows == 0)
+    return FALSE;
+
+  if (self->bytes_per_channel == 1)
+    EMIT (guint8);
+  else
+    EMIT (guint16);
+
+  memset (self->sums, 0, sizeof (guint64) * self->width * n_channels);
+  self->n_rows = 0;
+
+  return TRUE;
+}
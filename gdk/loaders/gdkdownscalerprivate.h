@@ -0,0 +1,94 @@
+/* GDK - The GIMP Drawing Kit
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GdkDownscaler GdkDownscaler;
+
+/* Averages blocks of factor x factor pixels while the rows of
+ * an image are being decoded, so that loaders never need to hold
+ * the image at full size.
+ */
+struct _GdkDownscaler
+{
+  /*< private >*/
+  gsize src_width;
+  gsize width;
+  guint factor;
+  guint n_channels;
+  guint bytes_per_channel;
+  gboolean straight_alpha;
+  guint64 *sums;
+  guint n_rows;
+};
+
+/*
+ * gdk_downscaler_get_factor:
+ * @width: the width of the image
+ * @height: the height of the image
+ * @target_width: the width the image is needed at, or -1
+ * @target_height: the height the image is needed at, or -1
+ *
+ * Computes the largest integer factor that an image can be
+ * scaled down by, so that scaling the result to fit into the
+ * target size while keeping its aspect ratio never needs to
+ * scale it up.
+ *
+ * Returns: the factor, at least 1
+ */
+static inline guint
+gdk_downscaler_get_factor (gsize width,
+                           gsize height,
+                           int   target_width,
+                           int   target_height)
+{
+  gsize factor = 1;
+
+  if (target_width > 0)
+    factor = MAX (factor, width / target_width);
+  if (target_height > 0)
+    factor = MAX (factor, height / target_height);
+
+  return MIN (factor, G_MAXUINT);
+}
+
+static inline gsize
+gdk_downscaler_get_size (gsize size,
+                         guint factor)
+{
+  return (size + factor - 1) / factor;
+}
+
+void            gdk_downscaler_init             (GdkDownscaler          *self,
+                                                 gsize                   src_width,
+                                                 guint                   factor,
+                                                 guint                   n_channels,
+                                                 guint                   bytes_per_channel,
+                                                 gboolean                straight_alpha);
+void            gdk_downscaler_finish           (GdkDownscaler          *self);
+
+gboolean        gdk_downscaler_add_row          (GdkDownscaler          *self,
+                                                 const guchar           *row,
+                                                 guchar                 *dest);
+gboolean        gdk_downscaler_flush            (GdkDownscaler          *self,
+                                                 guchar                 *dest);
+
+G_END_DECLS
@@ -21,6 +21,8 @@
 
 #include "gdkjpegprivate.h"
 
+#include "gdkdownscalerprivate.h"
+
 #include <glib/gi18n-lib.h>
 #include "gdktexture.h"
 #include "gdktexturedownloaderprivate.h"
@@ -131,21 +133,205 @@ convert_cmyk_to_rgba (guchar *data,
     }
 }
 
- /* }}} */
-/* {{{ Public API */
+/* }}} */
+/* {{{ Stream source */
 
-GdkTexture *
-gdk_load_jpeg (GBytes  *input_bytes,
-               GError **error)
+typedef struct
+{
+  struct jpeg_source_mgr pub;
+  GInputStream *stream;
+  GCancellable *cancellable;
+  GError **error;
+  JOCTET buffer[4096];
+} StreamSource;
+
+static void
+stream_source_init (j_decompress_ptr info)
+{
+}
+
+static boolean
+stream_source_fill_input_buffer (j_decompress_ptr info)
+{
+  StreamSource *src = (StreamSource *) info->src;
+  GError *local_error = NULL;
+  gssize n_read;
+
+  /* We are in a thread, so we can just block */
+  n_read = g_input_stream_read (src->stream,
+                                src->buffer, sizeof (src->buffer),
+                                src->cancellable,
+                                &local_error);
+  if (n_read < 0)
+    {
+      /* Keep the IO error, instead of turning it into a corrupt image */
+      if (src->error && !*src->error)
+        g_propagate_error (src->error, local_error);
+      else
+        g_error_free (local_error);
+
+      ERREXIT (info, JERR_FILE_READ);
+    }
+
+  if (n_read == 0)
+    {
+      /* Insert a fake EOI marker, like the stdio source does */
+      WARNMS (info, JWRN_JPEG_EOF);
+      src->buffer[0] = (JOCTET) 0xFF;
+      src->buffer[1] = (JOCTET) JPEG_EOI;
+      n_read = 2;
+    }
+
+  src->pub.next_input_byte = src->buffer;
+  src->pub.bytes_in_buffer = n_read;
+
+  return TRUE;
+}
+
+static void
+stream_source_skip_input_data (j_decompress_ptr info,
+                               long             num_bytes)
+{
+  struct jpeg_source_mgr *src = info->src;
+
+  if (num_bytes <= 0)
+    return;
+
+  while (num_bytes > (long) src->bytes_in_buffer)
+    {
+      num_bytes -= src->bytes_in_buffer;
+      src->fill_input_buffer (info);
+    }
+
+  src->next_input_byte += num_bytes;
+  src->bytes_in_buffer -= num_bytes;
+}
+
+static void
+stream_source_term (j_decompress_ptr info)
+{
+}
+
+static void
+jpeg_stream_src (j_decompress_ptr  info,
+                 GInputStream     *stream,
+                 GCancellable     *cancellable,
+                 GError          **error)
+{
+  StreamSource *src;
+
+  src = (StreamSource *) info->mem->alloc_small ((j_common_ptr) info,
+                                                 JPOOL_PERMANENT,
+                                                 sizeof (StreamSource));
+  src->pub.init_source = stream_source_init;
+  src->pub.fill_input_buffer = stream_source_fill_input_buffer;
+  src->pub.skip_input_data = stream_source_skip_input_data;
+  src->pub.resync_to_restart = jpeg_resync_to_restart;
+  src->pub.term_source = stream_source_term;
+  src->pub.bytes_in_buffer = 0;
+  src->pub.next_input_byte = NULL;
+  src->stream = stream;
+  src->cancellable = cancellable;
+  src->error = error;
+
+  info->src = &src->pub;
+}
+
+/* }}} */
+/* {{{ Loading */
+
+static void
+read_scanlines (struct jpeg_decompress_struct *info,
+                guchar                        *data,
+                gsize                          stride,
+                guint                          factor,
+                guchar                        *scanline,
+                GdkDownscaler                 *downscaler)
+{
+  unsigned char *row[1];
+
+  if (factor > 1)
+    {
+      gsize y = 0;
+
+      row[0] = scanline;
+      while (info->output_scanline < info->output_height)
+        {
+          jpeg_read_scanlines (info, row, 1);
+          if (gdk_downscaler_add_row (downscaler, scanline, &data[stride * y]))
+            y++;
+        }
+      gdk_downscaler_flush (downscaler, &data[stride * y]);
+    }
+  else
+    {
+      while (info->output_scanline < info->output_height)
+        {
+           row[0] = (unsigned char *)(&data[stride * info->output_scanline]);
+           jpeg_read_scanlines (info, row, 1);
+        }
+    }
+}
+
+/* Takes ownership of @data */
+static GdkTexture *
+create_texture (struct jpeg_decompress_struct *info,
+                guchar                        *data,
+                guint                          width,
+                guint                          height,
+                gsize                          stride)
+{
+  GdkMemoryFormat format;
+  GBytes *bytes;
+  GdkTexture *texture;
+
+  switch ((int)info->out_color_space)
+    {
+    case JCS_GRAYSCALE:
+      convert_grayscale_to_rgb (data, width, height, stride);
+      format = GDK_MEMORY_R8G8B8;
+      break;
+    case JCS_RGB:
+      format = GDK_MEMORY_R8G8B8;
+      break;
+    case JCS_CMYK:
+      convert_cmyk_to_rgba (data, width, height, stride);
+      format = GDK_MEMORY_R8G8B8A8_PREMULTIPLIED;
+      break;
+    default:
+      g_assert_not_reached ();
+    }
+
+  bytes = g_bytes_new_take (data, stride * height);
+
+  texture = gdk_memory_texture_new (width, height,
+                                    format,
+                                    bytes, stride);
+
+  g_bytes_unref (bytes);
+
+  return texture;
+}
+
+static GdkTexture *
+load_jpeg (GBytes                       *input_bytes,
+           GInputStream                 *stream,
+           GCancellable                 *cancellable,
+           int                           target_width,
+           int                           target_height,
+           GdkTextureLoaderPreviewFunc   preview_func,
+           gpointer                      preview_data,
+           GError                      **error)
 {
   struct jpeg_decompress_struct info;
   struct error_handler_data jerr;
+  GdkDownscaler downscaler = { 0, };
   guint width, height, stride;
+  guint factor, scale_denom;
+  gboolean progressive;
   unsigned char *data = NULL;
-  unsigned char *row[1];
-  GBytes *bytes;
+  unsigned char *scanline = NULL;
   GdkTexture *texture;
-  GdkMemoryFormat format;
   G_GNUC_UNUSED guint64 before = GDK_PROFILER_CURRENT_TIME;
 
   info.err = jpeg_std_error (&jerr.pub);
@@ -156,6 +342,8 @@ gdk_load_jpeg (GBytes  *input_bytes,
   if (sigsetjmp (jerr.setjmp_buffer, 1))
     {
       g_free (data);
+      g_free (scanline);
+      gdk_downscaler_finish (&downscaler);
       jpeg_destroy_decompress (&info);
       return NULL;
     }
@@ -165,15 +353,31 @@ gdk_load_jpeg (GBytes  *input_bytes,
   /* Limit to 1GB to avoid OOM with large images */
   info.mem->max_memory_to_use = 1024 * 1024 * 1024;
 
-  jpeg_mem_src (&info,
-                g_bytes_get_data (input_bytes, NULL),
-                g_bytes_get_size (input_bytes));
+  if (input_bytes)
+    jpeg_mem_src (&info,
+                  g_bytes_get_data (input_bytes, NULL),
+                  g_bytes_get_size (input_bytes));
+  else
+    jpeg_stream_src (&info, stream, cancellable, error);
 
   jpeg_read_header (&info, TRUE);
+
+  factor = gdk_downscaler_get_factor (info.image_width, info.image_height,
+                                      target_width, target_height);
+  for (scale_denom = 1; scale_denom < 8 && scale_denom * 2 <= factor; scale_denom *= 2)
+    ;
+  info.scale_num = 1;
+  info.scale_denom = scale_denom;
+  factor /= scale_denom;
+
+  /* Decode the scans one by one, so we can show each of them */
+  progressive = preview_func != NULL && jpeg_has_multiple_scans (&info);
+  info.buffered_image = progressive;
+
   jpeg_start_decompress (&info);
 
-  width = info.output_width;
-  height = info.output_height;
+  width = gdk_downscaler_get_size (info.output_width, factor);
+  height = gdk_downscaler_get_size (info.output_height, factor);
 
   switch ((int)info.out_color_space)
     {
@@ -181,12 +385,10 @@ gdk_load_jpeg (GBytes  *input_bytes,
     case JCS_RGB:
       stride = 3 * width;
       data = g_try_malloc_n (stride, height);
-      format = GDK_MEMORY_R8G8B8;
       break;
     case JCS_CMYK:
       stride = 4 * width;
       data = g_try_malloc_n (stride, height);
-      format = GDK_MEMORY_R8G8B8A8_PREMULTIPLIED;
       break;
     default:
       g_set_error (error,
@@ -196,6 +398,13 @@ gdk_load_jpeg (GBytes  *input_bytes,
       return NULL;
     }
 
+  if (factor > 1 && data)
+    {
+      scanline = g_try_malloc_n (info.output_width, info.output_components);
+      if (!scanline)
+        g_clear_pointer (&data, g_free);
+    }
+
   if (!data)
     {
       g_set_error (error,
@@ -205,43 +414,127 @@ gdk_load_jpeg (GBytes  *input_bytes,
       return NULL;
     }
 
-  while (info.output_scanline < info.output_height)
+  if (factor > 1)
+    gdk_downscaler_init (&downscaler, info.output_width, factor,
+                         info.output_components, 1, FALSE);
+
+  if (progressive)
     {
-       row[0] = (unsigned char *)(&data[stride * info.output_scanline]);
-       jpeg_read_scanlines (&info, row, 1);
-    }
+      while (TRUE)
+        {
+          GdkTexture *preview;
+          guchar *preview_data_copy;
 
-  switch ((int)info.out_color_space)
+          jpeg_start_output (&info, info.input_scan_number);
+          read_scanlines (&info, data, stride, factor, scanline, &downscaler);
+          /* This reads ahead to the next scan */
+          jpeg_finish_output (&info);
+
+          if (jpeg_input_complete (&info))
+            break;
+
+          preview_data_copy = g_try_malloc_n (stride, height);
+          if (preview_data_copy == NULL)
+            continue;
+
+          memcpy (preview_data_copy, data, (gsize) stride * height);
+          preview = create_texture (&info, preview_data_copy, width, height, stride);
+          preview_func (preview, preview_data);
+          g_object_unref (preview);
+        }
+    }
+  else
     {
-    case JCS_GRAYSCALE:
-      convert_grayscale_to_rgb (data, width, height, stride);
-      format = GDK_MEMORY_R8G8B8;
-      break;
-    case JCS_RGB:
-      break;
-    case JCS_CMYK:
-      convert_cmyk_to_rgba (data, width, height, stride);
-      break;
-    default:
-      g_assert_not_reached ();
+      read_scanlines (&info, data, stride, factor, scanline, &downscaler);
     }
 
+  gdk_downscaler_finish (&downscaler);
+  g_clear_pointer (&scanline, g_free);
+
   jpeg_finish_decompress (&info);
-  jpeg_destroy_decompress (&info);
 
-  bytes = g_bytes_new_take (data, stride * height);
+  texture = create_texture (&info, data, width, height, stride);
 
-  texture = gdk_memory_texture_new (width, height,
-                                    format,
-                                    bytes, stride);
+  jpeg_destroy_decompress (&info);
 
-  g_bytes_unref (bytes);
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      if (scale_denom * factor > 1)
+        gdk_profiler_end_markf (before, "Load jpeg", "scaled down by %u", scale_denom * factor);
+      else
+        gdk_profiler_end_mark (before, "Load jpeg", NULL);
+    }
 
-  gdk_profiler_end_mark (before, "Load jpeg", NULL);
- 
   return texture;
 }
 
+/* }}} */
+/* {{{ Public API */
+
+GdkTexture *
+gdk_load_jpeg (GBytes  *input_bytes,
+               GError **error)
+{
+  return gdk_load_jpeg_at_size (input_bytes, -1, -1, error);
+}
+
+/*
+ * gdk_load_jpeg_at_size:
+ * @input_bytes: the jpeg data
+ * @target_width: the width the image will be displayed at, or -1
+ * @target_height: the height the image will be displayed at, or -1
+ * @error: return location for an error
+ *
+ * Loads a jpeg, scaled down as far as possible while still being
+ * large enough to fit the target size. See gdk_downscaler_get_factor().
+ *
+ * Scaling by powers of 2 up to 8 is left to libjpeg, which can skip
+ * most of the work of decoding the parts that are thrown away. Any
+ * remaining factor is box filtered while reading the scanlines.
+ *
+ * Returns: the loaded texture
+ */
+GdkTexture *
+gdk_load_jpeg_at_size (GBytes  *input_bytes,
+                       int      target_width,
+                       int      target_height,
+                       GError **error)
+{
+  return load_jpeg (input_bytes, NULL, NULL,
+                    target_width, target_height,
+                    NULL, NULL,
+                    error);
+}
+
+/*
+ * gdk_load_jpeg_from_stream:
+ * @stream: the stream to read the jpeg from
+ * @preview_func: (nullable): function to call with previews
+ * @preview_data: data to pass to @preview_func
+ * @cancellable: (nullable): a `GCancellable`
+ * @error: return location for an error
+ *
+ * Loads a jpeg while reading it from @stream. This blocks, so
+ * it is meant to be called from a thread.
+ *
+ * For progressive jpegs, @preview_func is called with the image
+ * as it looks after every scan but the last one.
+ *
+ * Returns: the loaded texture
+ */
+GdkTexture *
+gdk_load_jpeg_from_stream (GInputStream                 *stream,
+                           GdkTextureLoaderPreviewFunc   preview_func,
+                           gpointer                      preview_data,
+                           GCancellable                 *cancellable,
+                           GError                      **error)
+{
+  return load_jpeg (NULL, stream, cancellable,
+                    -1, -1,
+                    preview_func, preview_data,
+                    error);
+}
+
 GBytes *
 gdk_save_jpeg (GdkTexture *texture)
 {
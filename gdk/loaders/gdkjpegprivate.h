@@ -18,12 +18,23 @@
 #pragma once
 
 #include "gdkmemorytexture.h"
+#include "gdktextureloaderprivate.h"
 #include <gio/gio.h>
 
 #define JPEG_SIGNATURE "\xff\xd8"
 
 GdkTexture *gdk_load_jpeg         (GBytes           *bytes,
                                    GError          **error);
+GdkTexture *gdk_load_jpeg_at_size (GBytes           *bytes,
+                                   int               target_width,
+                                   int               target_height,
+                                   GError          **error);
+GdkTexture *gdk_load_jpeg_from_stream
+                                  (GInputStream                *stream,
+                                   GdkTextureLoaderPreviewFunc  preview_func,
+                                   gpointer                     preview_data,
+                                   GCancellable                *cancellable,
+                                   GError                     **error);
 
 GBytes     *gdk_save_jpeg         (GdkTexture     *texture);
 
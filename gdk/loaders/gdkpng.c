@@ -19,6 +19,8 @@
 
 #include "gdkpngprivate.h"
 
+#include "gdkdownscalerprivate.h"
+
 #include <glib/gi18n-lib.h>
 #include "gdkmemoryformatprivate.h"
 #include "gdkmemorytexture.h"
@@ -27,6 +29,7 @@
 #include "gsk/gl/fp16private.h"
 #include <png.h>
 #include <stdio.h>
+#include <zlib.h>
 
 /* The main difference between the png load/save code here and
  * gdk-pixbuf is that we can support loading 16-bit data in the
@@ -67,6 +70,40 @@ png_read_func (png_structp png,
   io->position += size;
 }
 
+typedef struct
+{
+  GInputStream *stream;
+  GCancellable *cancellable;
+} png_stream_io;
+
+static void
+png_stream_read_func (png_structp png,
+                      png_bytep   data,
+                      png_size_t  size)
+{
+  png_stream_io *io;
+  GError **error;
+  GError *local_error = NULL;
+  gsize bytes_read;
+
+  io = png_get_io_ptr (png);
+  error = png_get_error_ptr (png);
+
+  if (!g_input_stream_read_all (io->stream, data, size, &bytes_read, io->cancellable, &local_error))
+    {
+      /* Keep the IO error, instead of turning it into a corrupt image */
+      if (error && !*error)
+        g_propagate_error (error, local_error);
+      else
+        g_error_free (local_error);
+
+      png_error (png, "Read error");
+    }
+
+  if (bytes_read < size)
+    png_error (png, "Read past EOF");
+}
+
 static void
 png_write_func (png_structp png,
                 png_bytep   data,
@@ -127,14 +164,72 @@ png_simple_warning_callback (png_structp     png,
 }
 
 /* }}} */
-/* {{{ Public API */
+/* {{{ Loading */
+
+/* The grid of pixels that is known after each Adam7 pass */
+static const struct {
+  guint x_step;
+  guint y_step;
+} adam7_grid[7] = {
+  { 8, 8 },
+  { 4, 8 },
+  { 4, 4 },
+  { 2, 4 },
+  { 2, 2 },
+  { 1, 2 },
+  { 1, 1 },
+};
+
+/* Creates a preview of an interlaced image after @pass has been
+ * read into @buffer, by filling the pixels that are still missing
+ * with their nearest decoded neighbour to the top left.
+ */
+static GdkTexture *
+create_interlace_preview (const guchar    *buffer,
+                          gsize            stride,
+                          guint            width,
+                          guint            height,
+                          GdkMemoryFormat  format,
+                          int              pass)
+{
+  gsize bpp = gdk_memory_format_bytes_per_pixel (format);
+  guint x_step = adam7_grid[pass].x_step;
+  guint y_step = adam7_grid[pass].y_step;
+  guchar *data;
+  GBytes *bytes;
+  GdkTexture *texture;
+  guint x, y;
 
-GdkTexture *
-gdk_load_png (GBytes      *bytes,
-              GHashTable  *options,
-              GError     **error)
+  data = g_try_malloc_n (height, stride);
+  if (data == NULL)
+    return NULL;
+
+  for (y = 0; y < height; y++)
+    {
+      const guchar *src = buffer + (y - y % y_step) * stride;
+      guchar *dest = data + y * stride;
+
+      for (x = 0; x < width; x++)
+        memcpy (dest + x * bpp, src + (x - x % x_step) * bpp, bpp);
+    }
+
+  bytes = g_bytes_new_take (data, height * stride);
+  texture = gdk_memory_texture_new (width, height, format, bytes, stride);
+  g_bytes_unref (bytes);
+
+  return texture;
+}
+
+static GdkTexture *
+load_png (png_rw_ptr                    read_func,
+          gpointer                      read_data,
+          int                           target_width,
+          int                           target_height,
+          GHashTable                   *options,
+          GdkTextureLoaderPreviewFunc   preview_func,
+          gpointer                      preview_data,
+          GError                      **error)
 {
-  png_io io;
   png_struct *png = NULL;
   png_info *info;
   png_textp text;
@@ -143,17 +238,19 @@ gdk_load_png (GBytes      *bytes,
   gsize i, stride;
   int depth, color_type;
   int interlace;
+  int n_passes;
   GdkMemoryFormat format;
   guchar *buffer = NULL;
   guchar **row_pointers = NULL;
+  guchar *src_buffer = NULL;
+  GdkDownscaler downscaler = { 0, };
+  guint factor, out_width, out_height;
+  gsize src_stride;
   GBytes *out_bytes;
   GdkTexture *texture;
   int bpp;
   G_GNUC_UNUSED gint64 before = GDK_PROFILER_CURRENT_TIME;
 
-  io.data = (guchar *)g_bytes_get_data (bytes, &io.size);
-  io.position = 0;
-
   png = png_create_read_struct_2 (PNG_LIBPNG_VER_STRING,
                                   error,
                                   png_simple_error_callback,
@@ -168,12 +265,14 @@ gdk_load_png (GBytes      *bytes,
   if (info == NULL)
     g_error ("Out of memory");
 
-  png_set_read_fn (png, &io, png_read_func);
+  png_set_read_fn (png, read_data, read_func);
 
   if (sigsetjmp (png_jmpbuf (png), 1))
     {
       g_free (buffer);
       g_free (row_pointers);
+      g_free (src_buffer);
+      gdk_downscaler_finish (&downscaler);
       png_destroy_read_struct (&png, &info, NULL);
       return NULL;
     }
@@ -197,7 +296,9 @@ gdk_load_png (GBytes      *bytes,
     png_set_packing (png);
 
   if (interlace != PNG_INTERLACE_NONE)
-    png_set_interlace_handling (png);
+    n_passes = png_set_interlace_handling (png);
+  else
+    n_passes = 1;
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
   png_set_swap (png);
@@ -266,23 +367,49 @@ gdk_load_png (GBytes      *bytes,
       return NULL;
     }
 
+  factor = gdk_downscaler_get_factor (width, height, target_width, target_height);
+  out_width = gdk_downscaler_get_size (width, factor);
+  out_height = gdk_downscaler_get_size (height, factor);
+
   bpp = gdk_memory_format_bytes_per_pixel (format);
-  if (!g_size_checked_mul (&stride, width, bpp) ||
+  if (!g_size_checked_mul (&stride, out_width, bpp) ||
       !g_size_checked_add (&stride, stride, (8 - stride % 8) % 8))
     {
+      png_destroy_read_struct (&png, &info, NULL);
       g_set_error (error,
                    GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_TOO_LARGE,
                    _("Image stride too large for image size %ux%u"), width, height);
       return NULL;
     }
 
-  buffer = g_try_malloc_n (height, stride);
-  row_pointers = g_try_malloc_n (height, sizeof (char *));
+  buffer = g_try_malloc_n (out_height, stride);
 
-  if (!buffer || !row_pointers)
+  if (factor == 1)
+    {
+      /* Read straight into the texture data */
+      src_stride = stride;
+      row_pointers = g_try_malloc_n (height, sizeof (char *));
+    }
+  else
+    {
+      src_stride = png_get_rowbytes (png, info);
+      if (interlace == PNG_INTERLACE_NONE)
+        src_buffer = g_try_malloc (src_stride);
+      else
+        {
+          src_buffer = g_try_malloc_n (height, src_stride);
+          row_pointers = g_try_malloc_n (height, sizeof (char *));
+        }
+    }
+
+  if (!buffer ||
+      (factor == 1 && !row_pointers) ||
+      (factor > 1 && !src_buffer) ||
+      (factor > 1 && interlace != PNG_INTERLACE_NONE && !row_pointers))
     {
       g_free (buffer);
       g_free (row_pointers);
+      g_free (src_buffer);
       png_destroy_read_struct (&png, &info, NULL);
       g_set_error (error,
                    GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_TOO_LARGE,
@@ -290,14 +417,80 @@ gdk_load_png (GBytes      *bytes,
       return NULL;
     }
 
-  for (i = 0; i < height; i++)
-    row_pointers[i] = &buffer[i * stride];
+  if (factor == 1)
+    {
+      for (i = 0; i < height; i++)
+        row_pointers[i] = &buffer[i * stride];
+
+      if (preview_func && n_passes == 7)
+        {
+          int pass;
+
+          for (pass = 0; pass < n_passes; pass++)
+            {
+              /* Only writes the pixels of this pass */
+              for (i = 0; i < height; i++)
+                png_read_row (png, row_pointers[i], NULL);
+
+              if (pass + 1 < n_passes)
+                {
+                  GdkTexture *preview;
+
+                  preview = create_interlace_preview (buffer, stride, width, height, format, pass);
+                  if (preview)
+                    {
+                      preview_func (preview, preview_data);
+                      g_object_unref (preview);
+                    }
+                }
+            }
+        }
+      else
+        png_read_image (png, row_pointers);
+    }
+  else
+    {
+      gsize y = 0;
+
+      gdk_downscaler_init (&downscaler,
+                           width,
+                           factor,
+                           png_get_channels (png, info),
+                           depth / 8,
+                           (color_type & PNG_COLOR_MASK_ALPHA) != 0);
+
+      if (interlace == PNG_INTERLACE_NONE)
+        {
+          for (i = 0; i < height; i++)
+            {
+              png_read_row (png, src_buffer, NULL);
+              if (gdk_downscaler_add_row (&downscaler, src_buffer, &buffer[y * stride]))
+                y++;
+            }
+        }
+      else
+        {
+          for (i = 0; i < height; i++)
+            row_pointers[i] = &src_buffer[i * src_stride];
+
+          png_read_image (png, row_pointers);
+
+          for (i = 0; i < height; i++)
+            {
+              if (gdk_downscaler_add_row (&downscaler, row_pointers[i], &buffer[y * stride]))
+                y++;
+            }
+        }
+
+      gdk_downscaler_flush (&downscaler, &buffer[y * stride]);
+      gdk_downscaler_finish (&downscaler);
+      g_clear_pointer (&src_buffer, g_free);
+    }
 
-  png_read_image (png, row_pointers);
   png_read_end (png, info);
 
-  out_bytes = g_bytes_new_take (buffer, height * stride);
-  texture = gdk_memory_texture_new (width, height, format, out_bytes, stride);
+  out_bytes = g_bytes_new_take (buffer, out_height * stride);
+  texture = gdk_memory_texture_new (out_width, out_height, format, out_bytes, stride);
   g_bytes_unref (out_bytes);
 
   if (options && png_get_text (png, info, &text, &num_texts))
@@ -324,8 +517,478 @@ gdk_load_png (GBytes      *bytes,
   return texture;
 }
 
+/* {{{ Parallel saving */
+
+/* Deflating the image data is what makes saving big images slow, and
+ * zlib does it on a single thread. So for big images, we filter and
+ * deflate bands of rows in parallel, each into its own raw deflate
+ * stream that ends on a byte boundary with a sync flush. Concatenated,
+ * and wrapped into a zlib header and the combined adler32 checksum,
+ * they form a single valid zlib stream, which libpng then writes as
+ * IDAT chunks, one per band.
+ *
+ * The bands don't share their history, so the result is very slightly
+ * larger than what zlib would produce on its own.
+ */
+
+/* Bands of less than this are not worth a thread */
+#define MIN_BAND_SIZE (1024 * 1024)
+#define MAX_SAVE_THREADS 8
+
+/* Set by tests, to run the parallel writer on any machine */
+static guint forced_save_threads;
+
+typedef struct
+{
+  GByteArray *out;
+  gsize in_size;
+  guint32 adler;
+} PngBand;
+
+typedef struct
+{
+  const guchar *data;
+  gsize stride;
+  gsize rowbytes;
+  gsize bpp;
+  gboolean swap;
+  int height;
+  int level;
+  int filters;
+
+  int rows_per_band;
+  int n_bands;
+  int next_band;
+  PngBand *bands;
+} PngEncoder;
+
+/* The filters that are tried for each row, like png_set_filter() */
+static int
+get_png_filters (int level)
+{
+  if (level == 0)
+    return PNG_FILTER_NONE;
+  else if (level > 0 && level <= 3)
+    return PNG_FILTER_UP;
+  else
+    return PNG_ALL_FILTERS;
+}
+
+static inline guchar
+paeth_predictor (guchar a,
+                 guchar b,
+                 guchar c)
+{
+  int p = a + b - c;
+  int pa = ABS (p - a);
+  int pb = ABS (p - b);
+  int pc = ABS (p - c);
+
+  if (pa <= pb && pa <= pc)
+    return a;
+  else if (pb <= pc)
+    return b;
+  else
+    return c;
+}
+
+/* Writes the filter type byte followed by the filtered row,
+ * and returns the sum of the absolute values of the result,
+ * which is the heuristic libpng uses to pick filters.
+ */
+static gsize
+filter_row (int           type,
+            gsize         bpp,
+            const guchar *row,
+            const guchar *prev,
+            gsize         rowbytes,
+            guchar       *out)
+{
+  gsize i, sum;
+
+  out[0] = type;
+  out++;
+
+  for (i = 0, sum = 0; i < rowbytes; i++)
+    {
+      guchar a = i >= bpp ? row[i - bpp] : 0;
+      guchar b = prev ? prev[i] : 0;
+      guchar c = prev && i >= bpp ? prev[i - bpp] : 0;
+      guchar x;
+
+      switch (type)
+        {
+        case PNG_FILTER_VALUE_NONE:
+          x = row[i];
+          break;
+        case PNG_FILTER_VALUE_SUB:
+          x = row[i] - a;
+          break;
+        case PNG_FILTER_VALUE_UP:
+          x = row[i] - b;
+          break;
+        case PNG_FILTER_VALUE_AVG:
+          x = row[i] - ((a + b) >> 1);
+          break;
+        case PNG_FILTER_VALUE_PAETH:
+          x = row[i] - paeth_predictor (a, b, c);
+          break;
+        default:
+          g_assert_not_reached ();
+        }
+
+      out[i] = x;
+      sum += ABS ((signed char) x);
+    }
+
+  return sum;
+}
+
+/* PNG stores 16-bit values big endian */
+static const guchar *
+get_row (PngEncoder *self,
+         int         y,
+         guchar     *buffer)
+{
+  const guchar *row = self->data + y * self->stride;
+  gsize i;
+
+  if (!self->swap)
+    return row;
+
+  for (i = 0; i < self->rowbytes; i += 2)
+    {
+      buffer[i] = row[i + 1];
+      buffer[i + 1] = row[i];
+    }
+
+  return buffer;
+}
+
+static void
+band_deflate (z_stream     *strm,
+              GByteArray   *out,
+              const guchar *data,
+              gsize         size,
+              int           flush)
+{
+  strm->next_in = (Bytef *) data;
+  strm->avail_in = size;
+
+  do
+    {
+      guint len = out->len;
+
+      g_byte_array_set_size (out, len + 64 * 1024);
+      strm->next_out = out->data + len;
+      strm->avail_out = 64 * 1024;
+
+      deflate (strm, flush);
+
+      g_byte_array_set_size (out, out->len - strm->avail_out);
+    }
+  while (strm->avail_out == 0);
+}
+
+static void
+encode_band (PngEncoder *self,
+             int         n)
+{
+  PngBand *band = &self->bands[n];
+  int y, y0, y1;
+  guchar *buffers[2];
+  guchar *filtered[5];
+  const guchar *row, *prev;
+  z_stream strm = { 0, };
+  guint i;
+
+  y0 = n * self->rows_per_band;
+  y1 = MIN (y0 + self->rows_per_band, self->height);
+
+  buffers[0] = g_malloc (self->rowbytes);
+  buffers[1] = g_malloc (self->rowbytes);
+  for (i = 0; i < G_N_ELEMENTS (filtered); i++)
+    filtered[i] = g_malloc (self->rowbytes + 1);
+
+  band->out = g_byte_array_new ();
+  band->adler = adler32 (0, NULL, 0);
+  band->in_size = 0;
+
+  /* Leave room for the zlib header */
+  if (n == 0)
+    g_byte_array_set_size (band->out, 2);
+
+  deflateInit2 (&strm, self->level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+
+  prev = y0 > 0 ? get_row (self, y0 - 1, buffers[(y0 - 1) & 1]) : NULL;
+
+  for (y = y0; y < y1; y++)
+    {
+      static const int filter_types[] = {
+        PNG_FILTER_NONE,
+        PNG_FILTER_SUB,
+        PNG_FILTER_UP,
+        PNG_FILTER_AVG,
+        PNG_FILTER_PAETH
+      };
+      gsize best_sum = G_MAXSIZE;
+      int best = 0;
+
+      row = get_row (self, y, buffers[y & 1]);
+
+      for (i = 0; i < G_N_ELEMENTS (filter_types); i++)
+        {
+          gsize sum;
+
+          if ((self->filters & filter_types[i]) == 0)
+            continue;
+
+          sum = filter_row (i, self->bpp, row, prev, self->rowbytes, filtered[i]);
+          if (sum < best_sum)
+            {
+              best_sum = sum;
+              best = i;
+            }
+        }
+
+      band->adler = adler32 (band->adler, filtered[best], self->rowbytes + 1);
+      band->in_size += self->rowbytes + 1;
+
+      band_deflate (&strm, band->out, filtered[best], self->rowbytes + 1,
+                    y + 1 < y1 ? Z_NO_FLUSH : (n + 1 < self->n_bands ? Z_SYNC_FLUSH : Z_FINISH));
+
+      prev = row;
+    }
+
+  deflateEnd (&strm);
+
+  g_free (buffers[0]);
+  g_free (buffers[1]);
+  for (i = 0; i < G_N_ELEMENTS (filtered); i++)
+    g_free (filtered[i]);
+}
+
+static gpointer
+encode_bands (gpointer data)
+{
+  PngEncoder *self = data;
+  int n;
+
+  while ((n = g_atomic_int_add (&self->next_band, 1)) < self->n_bands)
+    encode_band (self, n);
+
+  return NULL;
+}
+
+/*
+ * gdk_png_set_save_threads:
+ * @n_threads: the number of threads to save with, or 0
+ *
+ * Makes saving use @n_threads threads, regardless of the size
+ * of the image and the number of processors. 0 restores the
+ * default. This is meant for tests.
+ */
+void
+gdk_png_set_save_threads (guint n_threads)
+{
+  forced_save_threads = n_threads;
+}
+
+static guint
+get_n_save_threads (gsize size)
+{
+  if (forced_save_threads > 0)
+    return forced_save_threads;
+
+  return CLAMP (size / MIN_BAND_SIZE, 1, MIN (g_get_num_processors (), MAX_SAVE_THREADS));
+}
+
+static void
+write_png_parallel (png_struct   *png,
+                    const guchar *data,
+                    gsize         stride,
+                    int           width,
+                    int           height,
+                    gsize         bpp,
+                    gboolean      swap,
+                    int           level,
+                    guint         n_threads)
+{
+  PngEncoder self;
+  GThread **threads;
+  guint32 adler;
+  guchar trailer[4];
+  guchar *header;
+  int flevel;
+  guint i;
+
+  self.data = data;
+  self.stride = stride;
+  self.rowbytes = width * bpp;
+  self.bpp = bpp;
+  self.swap = swap;
+  self.height = height;
+  self.level = level < 0 ? Z_DEFAULT_COMPRESSION : level;
+  self.filters = get_png_filters (level);
+
+  /* A few bands per thread, to even out differences in how well they compress */
+  self.n_bands = MIN (height, n_threads * 4);
+  self.rows_per_band = (height + self.n_bands - 1) / self.n_bands;
+  self.n_bands = (height + self.rows_per_band - 1) / self.rows_per_band;
+  self.next_band = 0;
+  self.bands = g_new0 (PngBand, self.n_bands);
+
+  threads = g_new (GThread *, n_threads - 1);
+  for (i = 0; i < n_threads - 1; i++)
+    threads[i] = g_thread_new ("gdk-png-save", encode_bands, &self);
+
+  encode_bands (&self);
+
+  for (i = 0; i < n_threads - 1; i++)
+    g_thread_join (threads[i]);
+  g_free (threads);
+
+  /* The zlib header, with the compression level as zlib would set it */
+  if (self.level == Z_DEFAULT_COMPRESSION || self.level == 6)
+    flevel = 2;
+  else if (self.level < 2)
+    flevel = 0;
+  else if (self.level < 6)
+    flevel = 1;
+  else
+    flevel = 3;
+
+  header = self.bands[0].out->data;
+  header[0] = 0x78;
+  header[1] = flevel << 6;
+  header[1] |= (31 - ((header[0] << 8) | header[1]) % 31) % 31;
+
+  adler = self.bands[0].adler;
+  for (i = 1; i < self.n_bands; i++)
+    adler = adler32_combine (adler, self.bands[i].adler, self.bands[i].in_size);
+
+  trailer[0] = adler >> 24;
+  trailer[1] = adler >> 16;
+  trailer[2] = adler >> 8;
+  trailer[3] = adler;
+  g_byte_array_append (self.bands[self.n_bands - 1].out, trailer, 4);
+
+  for (i = 0; i < self.n_bands; i++)
+    {
+      png_write_chunk (png, (png_const_bytep) "IDAT",
+                       self.bands[i].out->data,
+                       self.bands[i].out->len);
+      g_byte_array_unref (self.bands[i].out);
+    }
+
+  g_free (self.bands);
+
+  png_write_chunk (png, (png_const_bytep) "IEND", NULL, 0);
+}
+
+/* }}} */
+/* {{{ Public API */
+
+GdkTexture *
+gdk_load_png (GBytes      *bytes,
+              GHashTable  *options,
+              GError     **error)
+{
+  return gdk_load_png_at_size (bytes, -1, -1, options, error);
+}
+
+/*
+ * gdk_load_png_at_size:
+ * @bytes: the png data
+ * @target_width: the width the image will be displayed at, or -1
+ * @target_height: the height the image will be displayed at, or -1
+ * @options: (nullable): hash table to store text chunks in
+ * @error: return location for an error
+ *
+ * Loads a png, scaled down as far as possible while still being
+ * large enough to fit the target size. See gdk_downscaler_get_factor().
+ *
+ * The rows are box filtered as they are read, so only the scaled
+ * down image is ever kept in memory. Interlaced images need to be
+ * read in full before they can be scaled.
+ *
+ * Returns: the loaded texture
+ */
+GdkTexture *
+gdk_load_png_at_size (GBytes      *bytes,
+                      int          target_width,
+                      int          target_height,
+                      GHashTable  *options,
+                      GError     **error)
+{
+  png_io io;
+
+  io.data = (guchar *)g_bytes_get_data (bytes, &io.size);
+  io.position = 0;
+
+  return load_png (png_read_func, &io,
+                   target_width, target_height,
+                   options,
+                   NULL, NULL,
+                   error);
+}
+
+/*
+ * gdk_load_png_from_stream:
+ * @stream: the stream to read the png from
+ * @preview_func: (nullable): function to call with previews
+ * @preview_data: data to pass to @preview_func
+ * @cancellable: (nullable): a `GCancellable`
+ * @error: return location for an error
+ *
+ * Loads a png while reading it from @stream. This blocks, so
+ * it is meant to be called from a thread.
+ *
+ * For interlaced images, @preview_func is called with a coarse
+ * version of the image after every pass but the last one.
+ *
+ * Returns: the loaded texture
+ */
+GdkTexture *
+gdk_load_png_from_stream (GInputStream                 *stream,
+                          GdkTextureLoaderPreviewFunc   preview_func,
+                          gpointer                      preview_data,
+                          GCancellable                 *cancellable,
+                          GError                      **error)
+{
+  png_stream_io io;
+
+  io.stream = stream;
+  io.cancellable = cancellable;
+
+  return load_png (png_stream_read_func, &io,
+                   -1, -1,
+                   NULL,
+                   preview_func, preview_data,
+                   error);
+}
+
 GBytes *
 gdk_save_png (GdkTexture *texture)
+{
+  return gdk_save_png_with_compression (texture, -1);
+}
+
+/*
+ * gdk_save_png_with_compression:
+ * @texture: the texture to save
+ * @compression_level: the zlib compression level from 0 to 9,
+ *   or -1 for the default
+ *
+ * Encodes @texture as png.
+ *
+ * Big images are encoded with multiple threads.
+ *
+ * Returns: the png data
+ */
+GBytes *
+gdk_save_png_with_compression (GdkTexture *texture,
+                               int         compression_level)
 {
   png_struct *png = NULL;
   png_info *info;
@@ -339,6 +1002,9 @@ gdk_save_png (GdkTexture *texture)
   const guchar *data;
   int png_format;
   int depth;
+  gsize bpp;
+  guint n_threads;
+  G_GNUC_UNUSED gint64 before = GDK_PROFILER_CURRENT_TIME;
 
   width = gdk_texture_get_width (texture);
   height = gdk_texture_get_height (texture);
@@ -467,19 +1133,39 @@ gdk_save_png (GdkTexture *texture)
 
   png_write_info (png, info);
 
+  bpp = gdk_memory_format_bytes_per_pixel (format);
+  n_threads = get_n_save_threads ((gsize) height * width * bpp);
+
+  if (n_threads > 1)
+    {
+      write_png_parallel (png, data, stride, width, height, bpp,
+                          depth == 16 && G_BYTE_ORDER == G_LITTLE_ENDIAN,
+                          compression_level,
+                          n_threads);
+    }
+  else
+    {
+      if (compression_level >= 0)
+        png_set_compression_level (png, compression_level);
+      png_set_filter (png, PNG_FILTER_TYPE_BASE, get_png_filters (compression_level));
+
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
-  png_set_swap (png);
+      png_set_swap (png);
 #endif
 
-  for (y = 0; y < height; y++)
-    png_write_row (png, data + y * stride);
+      for (y = 0; y < height; y++)
+        png_write_row (png, data + y * stride);
 
-  png_write_end (png, info);
+      png_write_end (png, info);
+    }
 
   png_destroy_write_struct (&png, &info);
 
   g_bytes_unref (bytes);
 
+  if (GDK_PROFILER_IS_RUNNING)
+    gdk_profiler_end_markf (before, "Save png", "%dx%d, %u threads", width, height, n_threads);
+
   return g_bytes_new_take (io.data, io.size);
 }
 
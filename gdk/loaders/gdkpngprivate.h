@@ -18,6 +18,7 @@
 #pragma once
 
 #include "gdktexture.h"
+#include "gdktextureloaderprivate.h"
 #include <gio/gio.h>
 
 #define PNG_SIGNATURE "\x89PNG"
@@ -25,8 +26,25 @@
 GdkTexture *gdk_load_png        (GBytes         *bytes,
                                  GHashTable     *options,
                                  GError        **error);
+GdkTexture *gdk_load_png_at_size
+                                (GBytes         *bytes,
+                                 int             target_width,
+                                 int             target_height,
+                                 GHashTable     *options,
+                                 GError        **error);
+GdkTexture *gdk_load_png_from_stream
+                                (GInputStream                *stream,
+                                 GdkTextureLoaderPreviewFunc  preview_func,
+                                 gpointer                     preview_data,
+                                 GCancellable                *cancellable,
+                                 GError                     **error);
 
 GBytes     *gdk_save_png        (GdkTexture     *texture);
+GBytes     *gdk_save_png_with_compression
+                                (GdkTexture     *texture,
+                                 int             compression_level);
+void        gdk_png_set_save_threads
+                                (guint           n_threads);
 
 static inline gboolean
 gdk_is_png (GBytes *bytes)
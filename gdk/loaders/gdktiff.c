@@ -19,6 +19,8 @@
 
 #include "gdktiffprivate.h"
 
+#include "gdkdownscalerprivate.h"
+
 #include <glib/gi18n-lib.h>
 #include "gdkmemoryformatprivate.h"
 #include "gdkmemorytexture.h"
@@ -339,6 +341,7 @@ gdk_save_tiff (GdkTexture *texture)
 
 static GdkTexture *
 load_fallback (TIFF    *tif,
+               guint    factor,
                GError **error)
 {
   int width, height;
@@ -360,6 +363,32 @@ load_fallback (TIFF    *tif,
       return NULL;
     }
 
+  if (factor > 1)
+    {
+      GdkDownscaler downscaler;
+      int y, dest_y;
+
+      /* The data is premultiplied, and rows are only ever
+       * written after all the rows they cover have been read,
+       * so we can scale down in place.
+       */
+      gdk_downscaler_init (&downscaler, width, factor, 4, 1, FALSE);
+      dest_y = 0;
+      for (y = 0; y < height; y++)
+        {
+          if (gdk_downscaler_add_row (&downscaler,
+                                      data + (gsize) y * width * 4,
+                                      data + (gsize) dest_y * downscaler.width * 4))
+            dest_y++;
+        }
+      gdk_downscaler_flush (&downscaler, data + (gsize) dest_y * downscaler.width * 4);
+      gdk_downscaler_finish (&downscaler);
+
+      width = gdk_downscaler_get_size (width, factor);
+      height = gdk_downscaler_get_size (height, factor);
+      data = g_realloc (data, width * height * 4);
+    }
+
   bytes = g_bytes_new_take (data, width * height * 4);
 
   texture = gdk_memory_texture_new (width, height,
@@ -372,9 +401,116 @@ load_fallback (TIFF    *tif,
   return texture;
 }
 
+/*
+ * tiff_select_reduced_image:
+ * @tif: a TIFF, with the first directory selected
+ * @factor: the factor the image can be scaled down by
+ *
+ * Looks for the smallest reduced resolution version of the
+ * image that is still large enough, and selects it. Those can
+ * be found in SubIFDs of the first image, or in later IFDs
+ * marked as FILETYPE_REDUCEDIMAGE.
+ *
+ * If there is none, the first directory is kept.
+ */
+static void
+tiff_select_reduced_image (TIFF  *tif,
+                           guint  factor)
+{
+  guint32 width, height, min_width, min_height, best_width;
+  guint16 n_subifds;
+  toff_t *subifds;
+  toff_t *offsets = NULL;
+  toff_t best_offset = 0;
+  tdir_t best_dir = 0;
+  tdir_t dir;
+  guint i;
+
+  TIFFGetFieldDefaulted (tif, TIFFTAG_IMAGEWIDTH, &width);
+  TIFFGetFieldDefaulted (tif, TIFFTAG_IMAGELENGTH, &height);
+
+  min_width = gdk_downscaler_get_size (width, factor);
+  min_height = gdk_downscaler_get_size (height, factor);
+  best_width = width;
+
+#define IS_BETTER(w, h) ((w) >= min_width && (h) >= min_height && (w) < best_width)
+
+  /* The offsets are owned by the directory, and we are about to change it */
+  if (TIFFGetField (tif, TIFFTAG_SUBIFD, &n_subifds, &subifds) && n_subifds > 0)
+    offsets = g_memdup2 (subifds, n_subifds * sizeof (toff_t));
+  else
+    n_subifds = 0;
+
+  for (i = 0; i < n_subifds; i++)
+    {
+      guint32 w, h;
+
+      if (!TIFFSetSubDirectory (tif, offsets[i]))
+        continue;
+
+      TIFFGetFieldDefaulted (tif, TIFFTAG_IMAGEWIDTH, &w);
+      TIFFGetFieldDefaulted (tif, TIFFTAG_IMAGELENGTH, &h);
+      if (IS_BETTER (w, h))
+        {
+          best_offset = offsets[i];
+          best_width = w;
+        }
+    }
+
+  g_free (offsets);
+
+  for (dir = 1; TIFFSetDirectory (tif, dir); dir++)
+    {
+      guint32 subfile_type, w, h;
+
+      if (!TIFFGetField (tif, TIFFTAG_SUBFILETYPE, &subfile_type) ||
+          (subfile_type & FILETYPE_REDUCEDIMAGE) == 0)
+        continue;
+
+      TIFFGetFieldDefaulted (tif, TIFFTAG_IMAGEWIDTH, &w);
+      TIFFGetFieldDefaulted (tif, TIFFTAG_IMAGELENGTH, &h);
+      if (IS_BETTER (w, h))
+        {
+          best_offset = 0;
+          best_dir = dir;
+          best_width = w;
+        }
+    }
+
+#undef IS_BETTER
+
+  if (best_offset == 0 || !TIFFSetSubDirectory (tif, best_offset))
+    TIFFSetDirectory (tif, best_dir);
+}
+
 GdkTexture *
 gdk_load_tiff (GBytes  *input_bytes,
                GError **error)
+{
+  return gdk_load_tiff_at_size (input_bytes, -1, -1, error);
+}
+
+/*
+ * gdk_load_tiff_at_size:
+ * @input_bytes: the tiff data
+ * @target_width: the width the image will be displayed at, or -1
+ * @target_height: the height the image will be displayed at, or -1
+ * @error: return location for an error
+ *
+ * Loads a tiff, scaled down as far as possible while still being
+ * large enough to fit the target size. See gdk_downscaler_get_factor().
+ *
+ * If the file contains reduced resolution versions of the image,
+ * the best one of those is loaded. Any remaining factor is box
+ * filtered while reading the scanlines.
+ *
+ * Returns: the loaded texture
+ */
+GdkTexture *
+gdk_load_tiff_at_size (GBytes  *input_bytes,
+                       int      target_width,
+                       int      target_height,
+                       GError **error)
 {
   TIFF *tif;
   guint16 samples_per_pixel;
@@ -383,10 +519,12 @@ gdk_load_tiff (GBytes  *input_bytes,
   guint16 planarconfig;
   guint16 sample_format;
   guint16 orientation;
-  guint32 width, height;
+  guint32 width, height, src_width, src_height;
   guint16 alpha_samples;
   GdkMemoryFormat format;
-  guchar *data, *line;
+  GdkDownscaler downscaler;
+  guint factor;
+  guchar *data, *line, *src_line;
   gsize stride;
   int bpp;
   GBytes *bytes;
@@ -404,6 +542,12 @@ gdk_load_tiff (GBytes  *input_bytes,
 
   TIFFSetDirectory (tif, 0);
 
+  TIFFGetFieldDefaulted (tif, TIFFTAG_IMAGEWIDTH, &width);
+  TIFFGetFieldDefaulted (tif, TIFFTAG_IMAGELENGTH, &height);
+  factor = gdk_downscaler_get_factor (width, height, target_width, target_height);
+  if (factor > 1)
+    tiff_select_reduced_image (tif, factor);
+
   TIFFGetFieldDefaulted (tif, TIFFTAG_SAMPLESPERPIXEL, &samples_per_pixel);
   TIFFGetFieldDefaulted (tif, TIFFTAG_BITSPERSAMPLE, &bits_per_sample);
   TIFFGetFieldDefaulted (tif, TIFFTAG_SAMPLEFORMAT, &sample_format);
@@ -413,6 +557,8 @@ gdk_load_tiff (GBytes  *input_bytes,
   TIFFGetFieldDefaulted (tif, TIFFTAG_IMAGEWIDTH, &width);
   TIFFGetFieldDefaulted (tif, TIFFTAG_IMAGELENGTH, &height);
 
+  factor = gdk_downscaler_get_factor (width, height, target_width, target_height);
+
   if (samples_per_pixel == 2 || samples_per_pixel == 4)
     {
       guint16 extra;
@@ -425,7 +571,7 @@ gdk_load_tiff (GBytes  *input_bytes,
 
       if (alpha_samples != 0 && alpha_samples != EXTRASAMPLE_ASSOCALPHA && alpha_samples != EXTRASAMPLE_UNASSALPHA)
         {
-          texture = load_fallback (tif, error);
+          texture = load_fallback (tif, factor, error);
           TIFFClose (tif);
           return texture;
         }
@@ -455,42 +601,95 @@ gdk_load_tiff (GBytes  *input_bytes,
       TIFFIsTiled (tif) ||
       orientation != ORIENTATION_TOPLEFT)
     {
-      texture = load_fallback (tif, error);
+      texture = load_fallback (tif, factor, error);
       TIFFClose (tif);
       return texture;
     }
 
-  stride = width * gdk_memory_format_bytes_per_pixel (format);
+  /* We can only average integer samples */
+  if (sample_format != SAMPLEFORMAT_UINT)
+    factor = 1;
+
+  bpp = gdk_memory_format_bytes_per_pixel (format);
+  stride = width * bpp;
 
   g_assert (TIFFScanlineSize (tif) == stride);
 
+  src_width = width;
+  src_height = height;
+  if (factor > 1)
+    {
+      src_line = g_try_malloc (stride);
+      width = gdk_downscaler_get_size (width, factor);
+      height = gdk_downscaler_get_size (height, factor);
+      stride = width * bpp;
+    }
+  else
+    src_line = NULL;
+
   data = g_try_malloc_n (height, stride);
-  if (!data)
+  if (!data || (factor > 1 && !src_line))
     {
       g_set_error (error,
                    GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_TOO_LARGE,
                    _("Not enough memory for image size %ux%u"), width, height);
       TIFFClose (tif);
+      g_free (data);
+      g_free (src_line);
       return NULL;
     }
 
-  line = data;
-  for (int y = 0; y < height; y++)
+  if (factor > 1)
     {
-      if (TIFFReadScanline (tif, line, y, 0) == -1)
+      gdk_downscaler_init (&downscaler,
+                           src_width,
+                           factor,
+                           samples_per_pixel,
+                           bits_per_sample / 8,
+                           alpha_samples == EXTRASAMPLE_UNASSALPHA);
+
+      line = data;
+      for (int y = 0; y < src_height; y++)
         {
-          g_set_error (error,
-                       GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_CORRUPT_IMAGE,
-                       _("Reading data failed at row %d"), y);
-          TIFFClose (tif);
-          g_free (data);
-          return NULL;
+          if (TIFFReadScanline (tif, src_line, y, 0) == -1)
+            {
+              g_set_error (error,
+                           GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_CORRUPT_IMAGE,
+                           _("Reading data failed at row %d"), y);
+              TIFFClose (tif);
+              gdk_downscaler_finish (&downscaler);
+              g_free (src_line);
+              g_free (data);
+              return NULL;
+            }
+
+          if (gdk_downscaler_add_row (&downscaler, src_line, line))
+            line += stride;
         }
+      gdk_downscaler_flush (&downscaler, line);
 
-      line += stride;
+      gdk_downscaler_finish (&downscaler);
+      g_free (src_line);
+    }
+  else
+    {
+      line = data;
+      for (int y = 0; y < height; y++)
+        {
+          if (TIFFReadScanline (tif, line, y, 0) == -1)
+            {
+              g_set_error (error,
+                           GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_CORRUPT_IMAGE,
+                           _("Reading data failed at row %d"), y);
+              TIFFClose (tif);
+              g_free (data);
+              return NULL;
+            }
+
+          line += stride;
+        }
     }
 
-  bpp = gdk_memory_format_bytes_per_pixel (format);
   bytes = g_bytes_new_take (data, width * height * bpp);
 
   texture = gdk_memory_texture_new (width, height,
@@ -7,6 +7,8 @@
 #include "gskgpuuploadopprivate.h"
 
 #include "gdk/gdkdisplayprivate.h"
+#include "gdk/gdkmemorytextureprivate.h"
+#include "gdk/gdksurfaceprivate.h"
 #include "gdk/gdktextureprivate.h"
 #include "gdk/gdkprofilerprivate.h"
 
@@ -23,6 +25,12 @@
 
 #define CACHE_TIMEOUT 15  /* seconds */
 
+/* Tiles of large textures are evicted, least recently used first, once
+ * they take up more than twice the pixels of the tiles that the current
+ * frame draws, but never below this
+ */
+#define MIN_TILE_PIXELS (32 * 1024 * 1024)
+
 G_STATIC_ASSERT (MAX_ATLAS_ITEM_SIZE < ATLAS_SIZE);
 G_STATIC_ASSERT (MAX_DEAD_PIXELS < ATLAS_SIZE * ATLAS_SIZE);
 
@@ -31,6 +39,8 @@ typedef struct _GskGpuCachedClass GskGpuCachedClass;
 typedef struct _GskGpuCachedAtlas GskGpuCachedAtlas;
 typedef struct _GskGpuCachedGlyph GskGpuCachedGlyph;
 typedef struct _GskGpuCachedTexture GskGpuCachedTexture;
+typedef struct _GskGpuCachedTiledTexture GskGpuCachedTiledTexture;
+typedef struct _GskGpuCachedTile GskGpuCachedTile;
 typedef struct _GskGpuDevicePrivate GskGpuDevicePrivate;
 
 struct _GskGpuDevicePrivate
@@ -44,8 +54,17 @@ struct _GskGpuDevicePrivate
   int cache_timeout;  /* in seconds, or -1 to disable gc */
 
   GHashTable *texture_cache;
+  GHashTable *tiled_texture_cache;
+  GHashTable *tile_cache;
   GHashTable *glyph_cache;
 
+  GQueue tile_lru;
+  gsize tile_pixels;
+  gint64 tile_timestamp;
+  gsize tile_frame_pixels;
+
+  GHashTable *pending_lods;
+
   GskGpuCachedAtlas *current_atlas;
 
   /* atomic */ gsize dead_texture_pixels;
@@ -354,6 +373,234 @@ gsk_gpu_cached_texture_new (GskGpuDevice *device,
   return self;
 }
 
+/* }}} */
+/* {{{ CachedTiledTexture */
+
+/* There is one of these for every texture that has tiles in the
+ * cache. It holds the only weak ref on the texture and owns the
+ * tiles, so tiles can be evicted without touching the texture.
+ */
+struct _GskGpuCachedTiledTexture
+{
+  GskGpuCached parent;
+
+  /* atomic */ int use_count; /* We count the use by the device (via the linked
+                               * list) and by the texture (via weak ref).
+                               */
+
+  gsize *dead_pixels_counter;
+
+  GdkTexture *texture;
+  guint n_tiles;
+};
+
+struct _GskGpuCachedTile
+{
+  GskGpuCached parent;
+
+  GskGpuCachedTiledTexture *owner;
+  guint lod;
+  gsize tile_id;
+
+  GskGpuImage *image;
+  GList lru_link;
+};
+
+static const GskGpuCachedClass GSK_GPU_CACHED_TILE_CLASS;
+
+static void
+gsk_gpu_cached_tiled_texture_free (GskGpuDevice *device,
+                                   GskGpuCached *cached)
+{
+  GskGpuDevicePrivate *priv = gsk_gpu_device_get_instance_private (device);
+  GskGpuCachedTiledTexture *self = (GskGpuCachedTiledTexture *) cached;
+  GskGpuCached *c, *next;
+  gpointer key, value;
+
+  /* Free all remaining tiles of this texture. They were added
+   * after us, so this does not free anything before us.
+   */
+  for (c = cached->next; c != NULL && self->n_tiles > 0; c = next)
+    {
+      next = c->next;
+      if (c->class == &GSK_GPU_CACHED_TILE_CLASS &&
+          ((GskGpuCachedTile *) c)->owner == self)
+        gsk_gpu_cached_free (device, c);
+    }
+
+  if (g_hash_table_steal_extended (priv->tiled_texture_cache, self->texture, &key, &value))
+    {
+      /* If the texture has been reused already, we put the entry back */
+      if ((GskGpuCached *) value != cached)
+        g_hash_table_insert (priv->tiled_texture_cache, key, value);
+    }
+
+  /* If the cached item itself is still in use by the texture, we leave
+   * it to the weak ref to free it.
+   */
+  if (g_atomic_int_dec_and_test (&self->use_count))
+    g_free (self);
+}
+
+static inline gboolean
+gsk_gpu_cached_tiled_texture_is_invalid (GskGpuCachedTiledTexture *self)
+{
+  /* Same as for textures: if the texture is gone, the memory
+   * may have been reused for a new texture.
+   */
+  return g_atomic_int_get (&self->use_count) < 2;
+}
+
+static gboolean
+gsk_gpu_cached_tiled_texture_should_collect (GskGpuDevice *device,
+                                             GskGpuCached *cached,
+                                             gint64        timestamp)
+{
+  GskGpuCachedTiledTexture *self = (GskGpuCachedTiledTexture *) cached;
+
+  return gsk_gpu_cached_is_old (device, cached, timestamp) ||
+         gsk_gpu_cached_tiled_texture_is_invalid (self);
+}
+
+static const GskGpuCachedClass GSK_GPU_CACHED_TILED_TEXTURE_CLASS =
+{
+  sizeof (GskGpuCachedTiledTexture),
+  gsk_gpu_cached_tiled_texture_free,
+  gsk_gpu_cached_tiled_texture_should_collect
+};
+
+/* Note: this function can run in an arbitrary thread, so it can
+ * only access things atomically
+ */
+static void
+gsk_gpu_cached_tiled_texture_destroy_cb (gpointer data)
+{
+  GskGpuCachedTiledTexture *self = data;
+
+  if (!gsk_gpu_cached_tiled_texture_is_invalid (self))
+    g_atomic_pointer_add (self->dead_pixels_counter, ((GskGpuCached *) self)->pixels);
+
+  if (g_atomic_int_dec_and_test (&self->use_count))
+    g_free (self);
+}
+
+static GskGpuCachedTiledTexture *
+gsk_gpu_cached_tiled_texture_new (GskGpuDevice *device,
+                                  GdkTexture   *texture)
+{
+  GskGpuDevicePrivate *priv = gsk_gpu_device_get_instance_private (device);
+  GskGpuCachedTiledTexture *self;
+
+  self = gsk_gpu_cached_new (device, &GSK_GPU_CACHED_TILED_TEXTURE_CLASS, NULL);
+  self->texture = texture;
+  self->dead_pixels_counter = &priv->dead_texture_pixels;
+  self->use_count = 2;
+
+  g_object_weak_ref (G_OBJECT (texture), (GWeakNotify) gsk_gpu_cached_tiled_texture_destroy_cb, self);
+  g_hash_table_insert (priv->tiled_texture_cache, texture, self);
+
+  return self;
+}
+
+/* }}} */
+/* {{{ CachedTile */
+
+static void
+gsk_gpu_cached_tile_free (GskGpuDevice *device,
+                          GskGpuCached *cached)
+{
+  GskGpuDevicePrivate *priv = gsk_gpu_device_get_instance_private (device);
+  GskGpuCachedTile *self = (GskGpuCachedTile *) cached;
+
+  g_hash_table_remove (priv->tile_cache, self);
+  g_queue_unlink (&priv->tile_lru, &self->lru_link);
+  priv->tile_pixels -= cached->pixels;
+
+  self->owner->n_tiles--;
+  ((GskGpuCached *) self->owner)->pixels -= cached->pixels;
+
+  g_object_unref (self->image);
+
+  g_free (self);
+}
+
+static gboolean
+gsk_gpu_cached_tile_should_collect (GskGpuDevice *device,
+                                    GskGpuCached *cached,
+                                    gint64        timestamp)
+{
+  GskGpuCachedTile *self = (GskGpuCachedTile *) cached;
+
+  return gsk_gpu_cached_is_old (device, cached, timestamp) ||
+         gsk_gpu_cached_tiled_texture_is_invalid (self->owner);
+}
+
+static guint
+gsk_gpu_cached_tile_hash (gconstpointer data)
+{
+  const GskGpuCachedTile *tile = data;
+
+  return g_direct_hash (tile->owner) ^
+         tile->tile_id ^
+         (tile->lod << 24);
+}
+
+static gboolean
+gsk_gpu_cached_tile_equal (gconstpointer v1,
+                           gconstpointer v2)
+{
+  const GskGpuCachedTile *tile1 = v1;
+  const GskGpuCachedTile *tile2 = v2;
+
+  return tile1->owner == tile2->owner
+      && tile1->lod == tile2->lod
+      && tile1->tile_id == tile2->tile_id;
+}
+
+static const GskGpuCachedClass GSK_GPU_CACHED_TILE_CLASS =
+{
+  sizeof (GskGpuCachedTile),
+  gsk_gpu_cached_tile_free,
+  gsk_gpu_cached_tile_should_collect
+};
+
+static GskGpuCachedTile *
+gsk_gpu_cached_tile_new (GskGpuDevice             *device,
+                         GskGpuCachedTiledTexture *owner,
+                         guint                     lod,
+                         gsize                     tile_id,
+                         GskGpuImage              *image)
+{
+  GskGpuDevicePrivate *priv = gsk_gpu_device_get_instance_private (device);
+  GskGpuCachedTile lookup = {
+    .owner = owner,
+    .lod = lod,
+    .tile_id = tile_id
+  };
+  GskGpuCachedTile *self;
+
+  self = g_hash_table_lookup (priv->tile_cache, &lookup);
+  if (self)
+    gsk_gpu_cached_free (device, (GskGpuCached *) self);
+
+  self = gsk_gpu_cached_new (device, &GSK_GPU_CACHED_TILE_CLASS, NULL);
+  self->owner = owner;
+  self->lod = lod;
+  self->tile_id = tile_id;
+  self->image = g_object_ref (image);
+  self->lru_link.data = self;
+  ((GskGpuCached *)self)->pixels = gsk_gpu_image_get_width (image) * gsk_gpu_image_get_height (image);
+
+  owner->n_tiles++;
+  ((GskGpuCached *) owner)->pixels += ((GskGpuCached *) self)->pixels;
+
+  g_hash_table_add (priv->tile_cache, self);
+  g_queue_push_head_link (&priv->tile_lru, &self->lru_link);
+  priv->tile_pixels += ((GskGpuCached *) self)->pixels;
+
+  return self;
+}
+
 /* }}} */
 /* {{{ CachedGlyph */
 
@@ -445,6 +692,8 @@ print_cache_stats (GskGpuDevice *self)
   guint glyphs = 0;
   guint stale_glyphs = 0;
   guint textures = 0;
+  guint tiled_textures = 0;
+  guint tiles = 0;
   guint atlases = 0;
   GString *ratios = g_string_new ("");
 
@@ -460,6 +709,14 @@ print_cache_stats (GskGpuDevice *self)
         {
           textures++;
         }
+      else if (cached->class == &GSK_GPU_CACHED_TILED_TEXTURE_CLASS)
+        {
+          tiled_textures++;
+        }
+      else if (cached->class == &GSK_GPU_CACHED_TILE_CLASS)
+        {
+          tiles++;
+        }
       else if (cached->class == &GSK_GPU_CACHED_ATLAS_CLASS)
         {
           double ratio;
@@ -482,9 +739,11 @@ print_cache_stats (GskGpuDevice *self)
   gdk_debug_message ("Cached items\n"
                      "  glyphs:   %5u (%u stale)\n"
                      "  textures: %5u (%u in hash)\n"
+                     "  tiles:    %5u (%" G_GSIZE_FORMAT " pixels, %u textures)\n"
                      "  atlases:  %5u%s",
                      glyphs, stale_glyphs,
                      textures, g_hash_table_size (priv->texture_cache),
+                     tiles, priv->tile_pixels, tiled_textures,
                      atlases, ratios->str);
 
   g_string_free (ratios, TRUE);
@@ -593,6 +852,9 @@ gsk_gpu_device_dispose (GObject *object)
   gsk_gpu_device_clear_cache (self);
   g_hash_table_unref (priv->glyph_cache);
   g_hash_table_unref (priv->texture_cache);
+  g_hash_table_unref (priv->tile_cache);
+  g_hash_table_unref (priv->tiled_texture_cache);
+  g_hash_table_unref (priv->pending_lods);
   g_clear_handle_id (&priv->cache_gc_source, g_source_remove);
 
   G_OBJECT_CLASS (gsk_gpu_device_parent_class)->dispose (object);
@@ -627,6 +889,12 @@ gsk_gpu_device_init (GskGpuDevice *self)
                                         gsk_gpu_cached_glyph_equal);
   priv->texture_cache = g_hash_table_new (g_direct_hash,
                                           g_direct_equal);
+  priv->tiled_texture_cache = g_hash_table_new (g_direct_hash,
+                                                g_direct_equal);
+  priv->tile_cache = g_hash_table_new (gsk_gpu_cached_tile_hash,
+                                       gsk_gpu_cached_tile_equal);
+  priv->pending_lods = g_hash_table_new (g_direct_hash,
+                                         g_direct_equal);
 }
 
 void
@@ -882,6 +1150,197 @@ gsk_gpu_device_cache_texture_image (GskGpuDevice *self,
   gsk_gpu_cached_use (self, (GskGpuCached *) cache, timestamp);
 }
 
+static void
+gsk_gpu_device_use_tile (GskGpuDevice     *self,
+                         GskGpuCachedTile *tile,
+                         gint64            timestamp)
+{
+  GskGpuDevicePrivate *priv = gsk_gpu_device_get_instance_private (self);
+
+  if (priv->tile_timestamp != timestamp)
+    {
+      priv->tile_timestamp = timestamp;
+      priv->tile_frame_pixels = 0;
+    }
+  if (((GskGpuCached *) tile)->timestamp != timestamp)
+    priv->tile_frame_pixels += ((GskGpuCached *) tile)->pixels;
+
+  gsk_gpu_cached_use (self, (GskGpuCached *) tile, timestamp);
+  gsk_gpu_cached_use (self, (GskGpuCached *) tile->owner, timestamp);
+
+  g_queue_unlink (&priv->tile_lru, &tile->lru_link);
+  g_queue_push_head_link (&priv->tile_lru, &tile->lru_link);
+}
+
+/*
+ * gsk_gpu_device_lookup_tile_image:
+ * @self: a `GskGpuDevice`
+ * @texture: the texture the tile is part of
+ * @lod: the level of detail of the tile
+ * @tile_id: the index of the tile
+ * @timestamp: the timestamp of the current frame
+ *
+ * Looks up a tile of a texture that is too large to upload
+ * as a whole, see gsk_gpu_device_cache_tile_image().
+ *
+ * Returns: (nullable) (transfer full): the image for the tile
+ */
+GskGpuImage *
+gsk_gpu_device_lookup_tile_image (GskGpuDevice *self,
+                                  GdkTexture   *texture,
+                                  guint         lod,
+                                  gsize         tile_id,
+                                  gint64        timestamp)
+{
+  GskGpuDevicePrivate *priv = gsk_gpu_device_get_instance_private (self);
+  GskGpuCachedTile lookup = {
+    .lod = lod,
+    .tile_id = tile_id
+  };
+  GskGpuCachedTile *cache;
+
+  lookup.owner = g_hash_table_lookup (priv->tiled_texture_cache, texture);
+  if (!lookup.owner || gsk_gpu_cached_tiled_texture_is_invalid (lookup.owner))
+    return NULL;
+
+  cache = g_hash_table_lookup (priv->tile_cache, &lookup);
+  if (!cache)
+    return NULL;
+
+  gsk_gpu_device_use_tile (self, cache, timestamp);
+
+  return g_object_ref (cache->image);
+}
+
+/*
+ * gsk_gpu_device_cache_tile_image:
+ * @self: a `GskGpuDevice`
+ * @texture: the texture the tile is part of
+ * @lod: the level of detail of the tile
+ * @tile_id: the index of the tile
+ * @timestamp: the timestamp of the current frame
+ * @image: the uploaded tile
+ *
+ * Caches the upload of a tile.
+ *
+ * Unlike whole textures, tiles count against a budget, and the
+ * least recently used tiles are dropped when it is exceeded, so
+ * that panning around a huge image does not keep all of it in
+ * GPU memory. The budget grows with the tiles that the current
+ * frame draws, so tiles needed by a large viewport are never
+ * evicted while drawing it.
+ */
+void
+gsk_gpu_device_cache_tile_image (GskGpuDevice *self,
+                                 GdkTexture   *texture,
+                                 guint         lod,
+                                 gsize         tile_id,
+                                 gint64        timestamp,
+                                 GskGpuImage  *image)
+{
+  GskGpuDevicePrivate *priv = gsk_gpu_device_get_instance_private (self);
+  GskGpuCachedTiledTexture *owner;
+  GskGpuCachedTile *cache;
+  gsize budget;
+
+  owner = g_hash_table_lookup (priv->tiled_texture_cache, texture);
+  if (owner && gsk_gpu_cached_tiled_texture_is_invalid (owner))
+    {
+      gsk_gpu_cached_free (self, (GskGpuCached *) owner);
+      owner = NULL;
+    }
+  if (owner == NULL)
+    owner = gsk_gpu_cached_tiled_texture_new (self, texture);
+
+  cache = gsk_gpu_cached_tile_new (self, owner, lod, tile_id, image);
+
+  gsk_gpu_device_use_tile (self, cache, timestamp);
+
+  budget = MAX (MIN_TILE_PIXELS, 2 * priv->tile_frame_pixels);
+  while (priv->tile_pixels > budget)
+    {
+      GskGpuCached *last = g_queue_peek_tail (&priv->tile_lru);
+
+      /* Everything that is left is needed for this frame */
+      if (last->timestamp == timestamp)
+        break;
+
+      gsk_gpu_cached_free (self, last);
+    }
+}
+
+typedef struct _PendingLod PendingLod;
+
+struct _PendingLod
+{
+  GskGpuDevice *device;
+  GdkTexture *texture;
+  GSList *surfaces;
+};
+
+static void
+pending_lod_done (GObject      *source,
+                  GAsyncResult *result,
+                  gpointer      data)
+{
+  PendingLod *pending = data;
+  GskGpuDevicePrivate *priv = gsk_gpu_device_get_instance_private (pending->device);
+  GSList *l;
+
+  gdk_memory_texture_prepare_lod_finish (GDK_MEMORY_TEXTURE (source), result, NULL);
+
+  g_hash_table_remove (priv->pending_lods, pending->texture);
+
+  for (l = pending->surfaces; l; l = l->next)
+    gdk_surface_invalidate_rect (l->data, NULL);
+
+  g_slist_free_full (pending->surfaces, g_object_unref);
+  g_object_unref (pending->device);
+  g_free (pending);
+}
+
+/*
+ * gsk_gpu_device_prepare_texture_lod:
+ * @self: a `GskGpuDevice`
+ * @texture: a `GdkMemoryTexture`
+ * @lod: the level of detail that is needed
+ * @surface: the surface that draws @texture
+ *
+ * Computes @lod of @texture in a thread, unless that is
+ * happening already, and redraws @surface once it is done.
+ *
+ * Levels that are requested while another one is computed
+ * for the same texture are picked up by that redraw.
+ */
+void
+gsk_gpu_device_prepare_texture_lod (GskGpuDevice *self,
+                                    GdkTexture   *texture,
+                                    guint         lod,
+                                    GdkSurface   *surface)
+{
+  GskGpuDevicePrivate *priv = gsk_gpu_device_get_instance_private (self);
+  PendingLod *pending;
+
+  pending = g_hash_table_lookup (priv->pending_lods, texture);
+  if (pending == NULL)
+    {
+      pending = g_new0 (PendingLod, 1);
+      pending->device = g_object_ref (self);
+      pending->texture = texture;
+      g_hash_table_insert (priv->pending_lods, texture, pending);
+
+      /* The task keeps the texture alive */
+      gdk_memory_texture_prepare_lod_async (GDK_MEMORY_TEXTURE (texture),
+                                            lod,
+                                            NULL,
+                                            pending_lod_done,
+                                            pending);
+    }
+
+  if (!g_slist_find (pending->surfaces, surface))
+    pending->surfaces = g_slist_prepend (pending->surfaces, g_object_ref (surface));
+}
+
 GskGpuImage *
 gsk_gpu_device_lookup_glyph_image (GskGpuDevice           *self,
                                    GskGpuFrame            *frame,
@@ -78,6 +78,21 @@ void                    gsk_gpu_device_cache_texture_image              (GskGpuD
                                                                          GdkTexture             *texture,
                                                                          gint64                  timestamp,
                                                                          GskGpuImage            *image);
+GskGpuImage *           gsk_gpu_device_lookup_tile_image                (GskGpuDevice           *self,
+                                                                         GdkTexture             *texture,
+                                                                         guint                   lod,
+                                                                         gsize                   tile_id,
+                                                                         gint64                  timestamp);
+void                    gsk_gpu_device_cache_tile_image                 (GskGpuDevice           *self,
+                                                                         GdkTexture             *texture,
+                                                                         guint                   lod,
+                                                                         gsize                   tile_id,
+                                                                         gint64                  timestamp,
+                                                                         GskGpuImage            *image);
+void                    gsk_gpu_device_prepare_texture_lod              (GskGpuDevice           *self,
+                                                                         GdkTexture             *texture,
+                                                                         guint                   lod,
+                                                                         GdkSurface             *surface);
 
 typedef enum
 {
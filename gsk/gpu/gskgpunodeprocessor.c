@@ -29,6 +29,7 @@
 #include "gskgpuscissoropprivate.h"
 #include "gskgpustraightalphaopprivate.h"
 #include "gskgputextureopprivate.h"
+#include "gskgputilesprivate.h"
 #include "gskgpuuberopprivate.h"
 #include "gskgpuuploadopprivate.h"
 
@@ -42,6 +43,7 @@
 #include "gsktransformprivate.h"
 #include "gskprivate.h"
 
+#include "gdk/gdkmemorytextureprivate.h"
 #include "gdk/gdkrgbaprivate.h"
 #include "gdk/gdksubsurfaceprivate.h"
 
@@ -50,6 +52,9 @@
  */
 #define EPSILON 0.001
 
+/* Size of the tiles that textures too large for the GPU are split into */
+#define TILE_SIZE 1024
+
 /* A note about coordinate systems
  *
  * The rendering code keeps track of multiple coordinate systems to optimize rendering as
@@ -1919,6 +1924,197 @@ gsk_gpu_node_processor_add_border_node (GskGpuNodeProcessor *self,
                      colors);
 }
 
+static gboolean
+gsk_gpu_node_processor_texture_needs_tiles (GskGpuNodeProcessor *self,
+                                            GdkTexture          *texture)
+{
+  gsize max_size;
+
+  if (!GDK_IS_MEMORY_TEXTURE (texture))
+    return FALSE;
+
+  max_size = gsk_gpu_device_get_max_image_size (gsk_gpu_frame_get_device (self->frame));
+
+  return gdk_texture_get_width (texture) > max_size ||
+         gdk_texture_get_height (texture) > max_size;
+}
+
+static void
+gsk_gpu_node_processor_draw_texture_thumbnail (GskGpuNodeProcessor   *self,
+                                               const graphene_rect_t *texture_bounds,
+                                               GdkTexture            *texture)
+{
+  GskGpuDevice *device;
+  GskGpuImage *image;
+  GdkTexture *thumbnail;
+
+  device = gsk_gpu_frame_get_device (self->frame);
+  thumbnail = gdk_memory_texture_get_thumbnail (GDK_MEMORY_TEXTURE (texture));
+
+  image = gsk_gpu_device_lookup_texture_image (device, thumbnail, gsk_gpu_frame_get_timestamp (self->frame));
+  if (image == NULL)
+    {
+      image = gsk_gpu_frame_upload_texture (self->frame, FALSE, thumbnail);
+      if (image == NULL)
+        return;
+    }
+
+  gsk_gpu_node_processor_image_op (self,
+                                   image,
+                                   texture_bounds,
+                                   texture_bounds);
+
+  g_object_unref (image);
+}
+
+/*
+ * gsk_gpu_node_processor_draw_texture_tiles:
+ * @self: a node processor
+ * @texture_bounds: the bounds to draw the texture into
+ * @texture: a memory texture that is too large to upload
+ * @sampler: the sampler to use
+ *
+ * Draws a texture in tiles. Only the tiles that intersect the
+ * clip are uploaded, and they are taken from the level of detail
+ * that matches the scale the texture is drawn at, so zooming out
+ * of a huge image doesn't need all its pixels.
+ *
+ * Levels that are not available yet are computed in a thread,
+ * and a thumbnail of the texture is drawn until they are ready.
+ *
+ * The uploaded tiles are cached by the device.
+ */
+static void
+gsk_gpu_node_processor_draw_texture_tiles (GskGpuNodeProcessor   *self,
+                                           const graphene_rect_t *texture_bounds,
+                                           GdkTexture            *texture,
+                                           GskGpuSampler          sampler)
+{
+  GskGpuDevice *device;
+  GdkTexture *lod_texture;
+  graphene_rect_t clip_bounds, area;
+  cairo_rectangle_int_t range;
+  gsize tile_size, width, height, n_width, x, y;
+  float scale_x, scale_y;
+  gint64 timestamp;
+  guint lod;
+
+  device = gsk_gpu_frame_get_device (self->frame);
+  timestamp = gsk_gpu_frame_get_timestamp (self->frame);
+  tile_size = MIN (TILE_SIZE, gsk_gpu_device_get_max_image_size (device) - 2 * GSK_GPU_TILE_GUTTER);
+
+  gsk_gpu_node_processor_get_clip_bounds (self, &clip_bounds);
+  if (!gsk_rect_intersection (&clip_bounds, texture_bounds, &clip_bounds))
+    return;
+
+  lod = gsk_gpu_tiles_get_lod (gdk_texture_get_width (texture),
+                               gdk_texture_get_height (texture),
+                               texture_bounds->size.width * graphene_vec2_get_x (&self->scale),
+                               texture_bounds->size.height * graphene_vec2_get_y (&self->scale));
+
+  lod_texture = gdk_memory_texture_peek_lod (GDK_MEMORY_TEXTURE (texture), lod);
+  if (lod_texture == NULL)
+    {
+      GdkSurface *surface;
+
+      surface = gdk_draw_context_get_surface (gsk_gpu_frame_get_context (self->frame));
+      if (surface == NULL)
+        {
+          /* Nothing would draw the result, so we have to wait for it */
+          lod_texture = gdk_memory_texture_get_lod (GDK_MEMORY_TEXTURE (texture), lod);
+        }
+      else
+        {
+          gsk_gpu_device_prepare_texture_lod (device, texture, lod, surface);
+          gsk_gpu_node_processor_draw_texture_thumbnail (self, texture_bounds, texture);
+          return;
+        }
+    }
+
+  width = gdk_texture_get_width (lod_texture);
+  height = gdk_texture_get_height (lod_texture);
+  n_width = (width + tile_size - 1) / tile_size;
+  scale_x = texture_bounds->size.width / width;
+  scale_y = texture_bounds->size.height / height;
+
+  area = GRAPHENE_RECT_INIT ((clip_bounds.origin.x - texture_bounds->origin.x) / scale_x,
+                             (clip_bounds.origin.y - texture_bounds->origin.y) / scale_y,
+                             clip_bounds.size.width / scale_x,
+                             clip_bounds.size.height / scale_y);
+  if (!gsk_gpu_tiles_get_range (width, height, tile_size, &area, &range))
+    return;
+
+  for (y = range.y; y < range.y + range.height; y++)
+    {
+      for (x = range.x; x < range.x + range.width; x++)
+        {
+          cairo_rectangle_int_t tile, upload;
+          graphene_rect_t tile_rect, upload_rect;
+          GskGpuImage *image;
+          guint32 descriptor;
+
+          gsk_gpu_tiles_get_tile (width, height, tile_size, x, y, &tile, &upload);
+          tile_rect = GRAPHENE_RECT_INIT (texture_bounds->origin.x + scale_x * tile.x,
+                                          texture_bounds->origin.y + scale_y * tile.y,
+                                          scale_x * tile.width,
+                                          scale_y * tile.height);
+          /* The gutter is uploaded, but only the tile is drawn */
+          upload_rect = GRAPHENE_RECT_INIT (texture_bounds->origin.x + scale_x * upload.x,
+                                            texture_bounds->origin.y + scale_y * upload.y,
+                                            scale_x * upload.width,
+                                            scale_y * upload.height);
+
+          image = gsk_gpu_device_lookup_tile_image (device, texture, lod, y * n_width + x, timestamp);
+          if (image == NULL)
+            {
+              GdkTexture *subtexture;
+
+              subtexture = gdk_memory_texture_new_subtexture (GDK_MEMORY_TEXTURE (lod_texture),
+                                                              upload.x, upload.y,
+                                                              upload.width, upload.height);
+              image = gsk_gpu_upload_texture_op_try (self->frame, FALSE, subtexture);
+              g_object_unref (subtexture);
+              if (image == NULL)
+                {
+                  GSK_DEBUG (FALLBACK, "Failed to upload %dx%d tile of texture", upload.width, upload.height);
+                  continue;
+                }
+
+              image = gsk_gpu_node_processor_ensure_image (self->frame,
+                                                           image,
+                                                           0,
+                                                           GSK_GPU_IMAGE_STRAIGHT_ALPHA);
+              gsk_gpu_device_cache_tile_image (device, texture, lod, y * n_width + x, timestamp, image);
+            }
+
+          descriptor = gsk_gpu_node_processor_add_image (self, image, sampler);
+          if (self->opacity < 1.0)
+            {
+              gsk_gpu_color_matrix_op_opacity (self->frame,
+                                               gsk_gpu_clip_get_shader_clip (&self->clip, &self->offset, &tile_rect),
+                                               self->desc,
+                                               descriptor,
+                                               &tile_rect,
+                                               &self->offset,
+                                               &upload_rect,
+                                               self->opacity);
+            }
+          else
+            {
+              gsk_gpu_texture_op (self->frame,
+                                  gsk_gpu_clip_get_shader_clip (&self->clip, &self->offset, &tile_rect),
+                                  self->desc,
+                                  descriptor,
+                                  &tile_rect,
+                                  &self->offset,
+                                  &upload_rect);
+            }
+
+          g_object_unref (image);
+        }
+    }
+}
+
 static void
 gsk_gpu_node_processor_add_texture_node (GskGpuNodeProcessor *self,
                                          GskRenderNode       *node)
@@ -1932,6 +2128,12 @@ gsk_gpu_node_processor_add_texture_node (GskGpuNodeProcessor *self,
   texture = gsk_texture_node_get_texture (node);
   timestamp = gsk_gpu_frame_get_timestamp (self->frame);
 
+  if (gsk_gpu_node_processor_texture_needs_tiles (self, texture))
+    {
+      gsk_gpu_node_processor_draw_texture_tiles (self, &node->bounds, texture, GSK_GPU_SAMPLER_DEFAULT);
+      return;
+    }
+
   image = gsk_gpu_device_lookup_texture_image (device, texture, timestamp);
   if (image == NULL)
     {
@@ -2101,6 +2303,17 @@ gsk_gpu_node_processor_add_texture_scale_node (GskGpuNodeProcessor *self,
   timestamp = gsk_gpu_frame_get_timestamp (self->frame);
   need_mipmap = scaling_filter == GSK_SCALING_FILTER_TRILINEAR;
 
+  if (gsk_gpu_node_processor_texture_needs_tiles (self, texture))
+    {
+      /* The levels of detail take the place of mipmaps */
+      gsk_gpu_node_processor_draw_texture_tiles (self,
+                                                 &node->bounds,
+                                                 texture,
+                                                 scaling_filter == GSK_SCALING_FILTER_NEAREST ? GSK_GPU_SAMPLER_NEAREST
+                                                                                              : GSK_GPU_SAMPLER_DEFAULT);
+      return;
+    }
+
   image = gsk_gpu_device_lookup_texture_image (device, texture, timestamp);
   if (image == NULL)
     {
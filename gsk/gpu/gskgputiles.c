@@ -0,0 +1,111 @@
+#include "config.h"
+
+#include "gskgputilesprivate.h"
+
+#include <math.h>
+
+/*
+ * gsk_gpu_tiles_get_lod:
+ * @width: the width of the texture
+ * @height: the height of the texture
+ * @scaled_width: the width the texture is drawn at, in device pixels
+ * @scaled_height: the height the texture is drawn at, in device pixels
+ *
+ * Picks the smallest level of detail that still has at least as
+ * many pixels as end up on screen.
+ *
+ * Returns: the level of detail
+ */
+guint
+gsk_gpu_tiles_get_lod (gsize width,
+                       gsize height,
+                       float scaled_width,
+                       float scaled_height)
+{
+  float lod_scale;
+
+  lod_scale = MIN (width / scaled_width, height / scaled_height);
+  if (lod_scale < 2)
+    return 0;
+
+  return MIN (floorf (log2f (lod_scale)), 31);
+}
+
+/*
+ * gsk_gpu_tiles_get_range:
+ * @width: the width of the level
+ * @height: the height of the level
+ * @tile_size: the size of the tiles
+ * @area: the area to draw, in pixels of the level
+ * @out_range: (out): the tiles that intersect @area, in tiles
+ *
+ * Computes the tiles that need to be drawn to cover @area.
+ *
+ * Returns: %FALSE if no tile intersects @area
+ */
+gboolean
+gsk_gpu_tiles_get_range (gsize                  width,
+                         gsize                  height,
+                         gsize                  tile_size,
+                         const graphene_rect_t *area,
+                         cairo_rectangle_int_t *out_range)
+{
+  float x0, y0, x1, y1;
+
+  x0 = MAX (area->origin.x, 0);
+  y0 = MAX (area->origin.y, 0);
+  x1 = MIN (area->origin.x + area->size.width, width);
+  y1 = MIN (area->origin.y + area->size.height, height);
+
+  if (x1 <= x0 || y1 <= y0)
+    return FALSE;
+
+  out_range->x = floorf (x0 / tile_size);
+  out_range->y = floorf (y0 / tile_size);
+  out_range->width = ceilf (x1 / tile_size) - out_range->x;
+  out_range->height = ceilf (y1 / tile_size) - out_range->y;
+
+  return TRUE;
+}
+
+/*
+ * gsk_gpu_tiles_get_tile:
+ * @width: the width of the level
+ * @height: the height of the level
+ * @tile_size: the size of the tiles
+ * @x: the column of the tile
+ * @y: the row of the tile
+ * @out_tile: (out): the pixels the tile covers
+ * @out_upload: (out): the pixels to upload for the tile
+ *
+ * Computes the area of a tile. The area to upload includes a
+ * gutter of %GSK_GPU_TILE_GUTTER pixels on the sides where the
+ * tile has neighbours, so that sampling near the edge of the
+ * tile does not show seams.
+ */
+void
+gsk_gpu_tiles_get_tile (gsize                  width,
+                        gsize                  height,
+                        gsize                  tile_size,
+                        gsize                  x,
+                        gsize                  y,
+                        cairo_rectangle_int_t *out_tile,
+                        cairo_rectangle_int_t *out_upload)
+{
+  gsize x0, y0, x1, y1;
+
+  out_tile->x = x * tile_size;
+  out_tile->y = y * tile_size;
+  out_tile->width = MIN (tile_size, width - out_tile->x);
+  out_tile->height = MIN (tile_size, height - out_tile->y);
+
+  x0 = out_tile->x > GSK_GPU_TILE_GUTTER ? out_tile->x - GSK_GPU_TILE_GUTTER : 0;
+  y0 = out_tile->y > GSK_GPU_TILE_GUTTER ? out_tile->y - GSK_GPU_TILE_GUTTER : 0;
+  x1 = MIN (out_tile->x + out_tile->width + GSK_GPU_TILE_GUTTER, width);
+  y1 = MIN (out_tile->y + out_tile->height + GSK_GPU_TILE_GUTTER, height);
+
+  out_upload->x = x0;
+  out_upload->y = y0;
+  out_upload->width = x1 - x0;
+  out_upload->height = y1 - y0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <gdk/gdk.h>
+#include <graphene.h>
+
+G_BEGIN_DECLS
+
+/* Pixels around each tile that are uploaded along with it, so that
+ * linear filtering at the tile's edges samples its neighbours
+ */
+#define GSK_GPU_TILE_GUTTER 1
+
+guint                   gsk_gpu_tiles_get_lod                           (gsize                   width,
+                                                                         gsize                   height,
+                                                                         float                   scaled_width,
+                                                                         float                   scaled_height);
+gboolean                gsk_gpu_tiles_get_range                         (gsize                   width,
+                                                                         gsize                   height,
+                                                                         gsize                   tile_size,
+                                                                         const graphene_rect_t  *area,
+                                                                         cairo_rectangle_int_t  *out_range);
+void                    gsk_gpu_tiles_get_tile                          (gsize                   width,
+                                                                         gsize                   height,
+                                                                         gsize                   tile_size,
+                                                                         gsize                   x,
+                                                                         gsize                   y,
+                                                                         cairo_rectangle_int_t  *out_tile,
+                                                                         cairo_rectangle_int_t  *out_upload);
+
+G_END_DECLS
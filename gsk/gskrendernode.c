@@ -467,6 +467,107 @@ gsk_render_node_draw_fallback (GskRenderNode *node,
     }
 }
 
+/*
+ * gsk_render_node_get_hash:
+ * @node: a `GskRenderNode`
+ *
+ * Gets a hash of everything that affects the rendering of @node,
+ * including its children.
+ *
+ * Nodes are immutable, so the hash is computed on first use and
+ * then kept. Node types that don't implement hashing, and nodes
+ * with such children, return 0.
+ *
+ * Returns: the hash of @node, or 0
+ */
+guint64
+gsk_render_node_get_hash (GskRenderNode *node)
+{
+  GskRenderNodeClass *node_class;
+
+  if (node->hash_computed)
+    return node->hash;
+
+  node_class = GSK_RENDER_NODE_GET_CLASS (node);
+  if (node_class->hash)
+    {
+      guint64 hash;
+
+      hash = gsk_hash_value (GSK_HASH_INIT, node_class->node_type);
+      hash = gsk_hash_float_value (hash, node->bounds);
+      node->hash = node_class->hash (node, hash);
+    }
+  else
+    node->hash = 0;
+
+  node->hash_computed = TRUE;
+
+  return node->hash;
+}
+
+static gboolean
+gsk_render_node_hash_matches (GskRenderNode *node1,
+                              GskRenderNode *node2)
+{
+  guint64 hash;
+
+  hash = gsk_render_node_get_hash (node1);
+  if (hash == 0 || hash != gsk_render_node_get_hash (node2))
+    return FALSE;
+
+  return _gsk_render_node_get_node_type (node1) == _gsk_render_node_get_node_type (node2) &&
+         gsk_equal_float_value (node1->bounds, node2->bounds);
+}
+
+/*
+ * gsk_render_node_is_identical:
+ * @node1: a `GskRenderNode`
+ * @node2: the `GskRenderNode` to compare with
+ *
+ * Checks if two nodes are known to render the same.
+ *
+ * Different hashes reject most nodes cheaply. Equal hashes
+ * are confirmed by comparing the contents of the two nodes,
+ * but not of their children: those are compared with
+ * gsk_render_node_child_is_identical(), so checking a tree
+ * costs the same no matter how deep it is.
+ *
+ * Returns: %TRUE if @node1 and @node2 render the same
+ */
+gboolean
+gsk_render_node_is_identical (GskRenderNode *node1,
+                              GskRenderNode *node2)
+{
+  if (node1 == node2)
+    return TRUE;
+
+  if (!gsk_render_node_hash_matches (node1, node2))
+    return FALSE;
+
+  return GSK_RENDER_NODE_GET_CLASS (node1)->equal (node1, node2);
+}
+
+/*
+ * gsk_render_node_child_is_identical:
+ * @child1: a `GskRenderNode`
+ * @child2: the `GskRenderNode` to compare with
+ *
+ * Checks if two children of nodes that are being compared by
+ * their equal() vfunc render the same.
+ *
+ * This only looks at the stored hashes, types and bounds of
+ * the children, and trusts the hashes for the subtrees below.
+ *
+ * Returns: %TRUE if @child1 and @child2 render the same
+ */
+gboolean
+gsk_render_node_child_is_identical (GskRenderNode *child1,
+                                    GskRenderNode *child2)
+{
+  return child1 == child2 ||
+         gsk_render_node_hash_matches (child1, child2);
+}
+
 /*
  * gsk_render_node_can_diff:
  * @node1: a `GskRenderNode`
@@ -486,6 +587,8 @@ gboolean
 gsk_render_node_can_diff (const GskRenderNode *node1,
                           const GskRenderNode *node2)
 {
+  /* Identical nodes are left to gsk_render_node_diff(), which
+   * checks for them anyway. All can_diff() vfuncs accept them */
   if (node1 == node2)
     return TRUE;
 
@@ -548,6 +651,11 @@ gsk_render_node_diff (GskRenderNode  *node1,
   if (node1 == node2)
     return;
 
+  /* Widgets that snapshot again without changes create new,
+   * but identical subtrees. Skip them without looking inside */
+  if (gsk_render_node_is_identical (node1, node2))
+    return;
+
   if (_gsk_render_node_get_node_type (node1) == _gsk_render_node_get_node_type (node2))
     {
       GSK_RENDER_NODE_GET_CLASS (node1)->diff (node1, node2, data);
@@ -180,6 +180,25 @@ gsk_color_node_diff (GskRenderNode *node1,
   gsk_render_node_diff_impossible (node1, node2, data);
 }
 
+static guint64
+gsk_color_node_hash (GskRenderNode *node,
+                     guint64        hash)
+{
+  GskColorNode *self = (GskColorNode *) node;
+
+  return gsk_hash_float_value (hash, self->color);
+}
+
+static gboolean
+gsk_color_node_equal (GskRenderNode *node1,
+                      GskRenderNode *node2)
+{
+  GskColorNode *self1 = (GskColorNode *) node1;
+  GskColorNode *self2 = (GskColorNode *) node2;
+
+  return gsk_equal_float_value (self1->color, self2->color);
+}
+
 static void
 gsk_color_node_class_init (gpointer g_class,
                            gpointer class_data)
@@ -190,6 +209,8 @@ gsk_color_node_class_init (gpointer g_class,
 
   node_class->draw = gsk_color_node_draw;
   node_class->diff = gsk_color_node_diff;
+  node_class->hash = gsk_color_node_hash;
+  node_class->equal = gsk_color_node_equal;
 }
 
 /**
@@ -355,6 +376,42 @@ gsk_linear_gradient_node_diff (GskRenderNode *node1,
   gsk_render_node_diff_impossible (node1, node2, data);
 }
 
+static gboolean
+gsk_color_stops_equal (const GskColorStop *stops1,
+                       gsize               n_stops1,
+                       const GskColorStop *stops2,
+                       gsize               n_stops2)
+{
+  return n_stops1 == n_stops2 &&
+         gsk_equal_floats ((const float *) stops1, (const float *) stops2,
+                           n_stops1 * sizeof (GskColorStop) / sizeof (float));
+}
+
+static guint64
+gsk_linear_gradient_node_hash (GskRenderNode *node,
+                               guint64        hash)
+{
+  GskLinearGradientNode *self = (GskLinearGradientNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->start);
+  hash = gsk_hash_float_value (hash, self->end);
+
+  return gsk_hash_floats (hash, (const float *) self->stops,
+                          self->n_stops * sizeof (GskColorStop) / sizeof (float));
+}
+
+static gboolean
+gsk_linear_gradient_node_equal (GskRenderNode *node1,
+                                GskRenderNode *node2)
+{
+  GskLinearGradientNode *self1 = (GskLinearGradientNode *) node1;
+  GskLinearGradientNode *self2 = (GskLinearGradientNode *) node2;
+
+  return gsk_equal_float_value (self1->start, self2->start) &&
+         gsk_equal_float_value (self1->end, self2->end) &&
+         gsk_color_stops_equal (self1->stops, self1->n_stops, self2->stops, self2->n_stops);
+}
+
 static void
 gsk_linear_gradient_node_class_init (gpointer g_class,
                                      gpointer class_data)
@@ -366,6 +423,8 @@ gsk_linear_gradient_node_class_init (gpointer g_class,
   node_class->finalize = gsk_linear_gradient_node_finalize;
   node_class->draw = gsk_linear_gradient_node_draw;
   node_class->diff = gsk_linear_gradient_node_diff;
+  node_class->hash = gsk_linear_gradient_node_hash;
+  node_class->equal = gsk_linear_gradient_node_equal;
 }
 
 static void
@@ -379,6 +438,8 @@ gsk_repeating_linear_gradient_node_class_init (gpointer g_class,
   node_class->finalize = gsk_linear_gradient_node_finalize;
   node_class->draw = gsk_linear_gradient_node_draw;
   node_class->diff = gsk_linear_gradient_node_diff;
+  node_class->hash = gsk_linear_gradient_node_hash;
+  node_class->equal = gsk_linear_gradient_node_equal;
 }
 
 /**
@@ -689,6 +750,37 @@ gsk_radial_gradient_node_diff (GskRenderNode *node1,
   gsk_render_node_diff_impossible (node1, node2, data);
 }
 
+static guint64
+gsk_radial_gradient_node_hash (GskRenderNode *node,
+                               guint64        hash)
+{
+  GskRadialGradientNode *self = (GskRadialGradientNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->center);
+  hash = gsk_hash_float_value (hash, self->hradius);
+  hash = gsk_hash_float_value (hash, self->vradius);
+  hash = gsk_hash_float_value (hash, self->start);
+  hash = gsk_hash_float_value (hash, self->end);
+
+  return gsk_hash_floats (hash, (const float *) self->stops,
+                          self->n_stops * sizeof (GskColorStop) / sizeof (float));
+}
+
+static gboolean
+gsk_radial_gradient_node_equal (GskRenderNode *node1,
+                                GskRenderNode *node2)
+{
+  GskRadialGradientNode *self1 = (GskRadialGradientNode *) node1;
+  GskRadialGradientNode *self2 = (GskRadialGradientNode *) node2;
+
+  return gsk_equal_float_value (self1->center, self2->center) &&
+         gsk_equal_float_value (self1->hradius, self2->hradius) &&
+         gsk_equal_float_value (self1->vradius, self2->vradius) &&
+         gsk_equal_float_value (self1->start, self2->start) &&
+         gsk_equal_float_value (self1->end, self2->end) &&
+         gsk_color_stops_equal (self1->stops, self1->n_stops, self2->stops, self2->n_stops);
+}
+
 static void
 gsk_radial_gradient_node_class_init (gpointer g_class,
                                      gpointer class_data)
@@ -700,6 +792,8 @@ gsk_radial_gradient_node_class_init (gpointer g_class,
   node_class->finalize = gsk_radial_gradient_node_finalize;
   node_class->draw = gsk_radial_gradient_node_draw;
   node_class->diff = gsk_radial_gradient_node_diff;
+  node_class->hash = gsk_radial_gradient_node_hash;
+  node_class->equal = gsk_radial_gradient_node_equal;
 }
 
 static void
@@ -713,6 +807,8 @@ gsk_repeating_radial_gradient_node_class_init (gpointer g_class,
   node_class->finalize = gsk_radial_gradient_node_finalize;
   node_class->draw = gsk_radial_gradient_node_draw;
   node_class->diff = gsk_radial_gradient_node_diff;
+  node_class->hash = gsk_radial_gradient_node_hash;
+  node_class->equal = gsk_radial_gradient_node_equal;
 }
 
 /**
@@ -1177,6 +1273,33 @@ gsk_conic_gradient_node_diff (GskRenderNode *node1,
     }
 }
 
+static guint64
+gsk_conic_gradient_node_hash (GskRenderNode *node,
+                              guint64        hash)
+{
+  GskConicGradientNode *self = (GskConicGradientNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->center);
+  hash = gsk_hash_float_value (hash, self->rotation);
+  hash = gsk_hash_float_value (hash, self->angle);
+
+  return gsk_hash_floats (hash, (const float *) self->stops,
+                          self->n_stops * sizeof (GskColorStop) / sizeof (float));
+}
+
+static gboolean
+gsk_conic_gradient_node_equal (GskRenderNode *node1,
+                               GskRenderNode *node2)
+{
+  GskConicGradientNode *self1 = (GskConicGradientNode *) node1;
+  GskConicGradientNode *self2 = (GskConicGradientNode *) node2;
+
+  return gsk_equal_float_value (self1->center, self2->center) &&
+         gsk_equal_float_value (self1->rotation, self2->rotation) &&
+         gsk_equal_float_value (self1->angle, self2->angle) &&
+         gsk_color_stops_equal (self1->stops, self1->n_stops, self2->stops, self2->n_stops);
+}
+
 static void
 gsk_conic_gradient_node_class_init (gpointer g_class,
                                     gpointer class_data)
@@ -1188,6 +1311,8 @@ gsk_conic_gradient_node_class_init (gpointer g_class,
   node_class->finalize = gsk_conic_gradient_node_finalize;
   node_class->draw = gsk_conic_gradient_node_draw;
   node_class->diff = gsk_conic_gradient_node_diff;
+  node_class->hash = gsk_conic_gradient_node_hash;
+  node_class->equal = gsk_conic_gradient_node_equal;
 }
 
 /**
@@ -1537,6 +1662,30 @@ gsk_border_node_diff (GskRenderNode *node1,
   gsk_render_node_diff_impossible (node1, node2, data);
 }
 
+static guint64
+gsk_border_node_hash (GskRenderNode *node,
+                      guint64        hash)
+{
+  GskBorderNode *self = (GskBorderNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->outline);
+  hash = gsk_hash_float_value (hash, self->border_width);
+
+  return gsk_hash_float_value (hash, self->border_color);
+}
+
+static gboolean
+gsk_border_node_equal (GskRenderNode *node1,
+                       GskRenderNode *node2)
+{
+  GskBorderNode *self1 = (GskBorderNode *) node1;
+  GskBorderNode *self2 = (GskBorderNode *) node2;
+
+  return gsk_equal_float_value (self1->outline, self2->outline) &&
+         gsk_equal_float_value (self1->border_width, self2->border_width) &&
+         gsk_equal_float_value (self1->border_color, self2->border_color);
+}
+
 static void
 gsk_border_node_class_init (gpointer g_class,
                             gpointer class_data)
@@ -1547,6 +1696,8 @@ gsk_border_node_class_init (gpointer g_class,
 
   node_class->draw = gsk_border_node_draw;
   node_class->diff = gsk_border_node_diff;
+  node_class->hash = gsk_border_node_hash;
+  node_class->equal = gsk_border_node_equal;
 }
 
 /**
@@ -1821,6 +1972,27 @@ gsk_texture_node_diff (GskRenderNode *node1,
   cairo_region_destroy (sub);
 }
 
+/* Textures are immutable, and the old node keeps its texture
+ * alive, so the pointer is as good as the contents */
+static guint64
+gsk_texture_node_hash (GskRenderNode *node,
+                       guint64        hash)
+{
+  GskTextureNode *self = (GskTextureNode *) node;
+
+  return gsk_hash_value (hash, self->texture);
+}
+
+static gboolean
+gsk_texture_node_equal (GskRenderNode *node1,
+                        GskRenderNode *node2)
+{
+  GskTextureNode *self1 = (GskTextureNode *) node1;
+  GskTextureNode *self2 = (GskTextureNode *) node2;
+
+  return self1->texture == self2->texture;
+}
+
 static void
 gsk_texture_node_class_init (gpointer g_class,
                              gpointer class_data)
@@ -1832,6 +2004,8 @@ gsk_texture_node_class_init (gpointer g_class,
   node_class->finalize = gsk_texture_node_finalize;
   node_class->draw = gsk_texture_node_draw;
   node_class->diff = gsk_texture_node_diff;
+  node_class->hash = gsk_texture_node_hash;
+  node_class->equal = gsk_texture_node_equal;
 }
 
 /**
@@ -2009,6 +2183,28 @@ gsk_texture_scale_node_diff (GskRenderNode *node1,
   cairo_region_destroy (sub);
 }
 
+static guint64
+gsk_texture_scale_node_hash (GskRenderNode *node,
+                             guint64        hash)
+{
+  GskTextureScaleNode *self = (GskTextureScaleNode *) node;
+
+  hash = gsk_hash_value (hash, self->texture);
+
+  return gsk_hash_value (hash, self->filter);
+}
+
+static gboolean
+gsk_texture_scale_node_equal (GskRenderNode *node1,
+                              GskRenderNode *node2)
+{
+  GskTextureScaleNode *self1 = (GskTextureScaleNode *) node1;
+  GskTextureScaleNode *self2 = (GskTextureScaleNode *) node2;
+
+  return self1->texture == self2->texture &&
+         self1->filter == self2->filter;
+}
+
 static void
 gsk_texture_scale_node_class_init (gpointer g_class,
                                    gpointer class_data)
@@ -2020,6 +2216,8 @@ gsk_texture_scale_node_class_init (gpointer g_class,
   node_class->finalize = gsk_texture_scale_node_finalize;
   node_class->draw = gsk_texture_scale_node_draw;
   node_class->diff = gsk_texture_scale_node_diff;
+  node_class->hash = gsk_texture_scale_node_hash;
+  node_class->equal = gsk_texture_scale_node_equal;
 }
 
 /**
@@ -2520,6 +2718,36 @@ gsk_inset_shadow_node_diff (GskRenderNode *node1,
   gsk_render_node_diff_impossible (node1, node2, data);
 }
 
+static guint64
+gsk_inset_shadow_node_hash (GskRenderNode *node,
+                            guint64        hash)
+{
+  GskInsetShadowNode *self = (GskInsetShadowNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->outline);
+  hash = gsk_hash_float_value (hash, self->color);
+  hash = gsk_hash_float_value (hash, self->dx);
+  hash = gsk_hash_float_value (hash, self->dy);
+  hash = gsk_hash_float_value (hash, self->spread);
+
+  return gsk_hash_float_value (hash, self->blur_radius);
+}
+
+static gboolean
+gsk_inset_shadow_node_equal (GskRenderNode *node1,
+                             GskRenderNode *node2)
+{
+  GskInsetShadowNode *self1 = (GskInsetShadowNode *) node1;
+  GskInsetShadowNode *self2 = (GskInsetShadowNode *) node2;
+
+  return gsk_equal_float_value (self1->outline, self2->outline) &&
+         gsk_equal_float_value (self1->color, self2->color) &&
+         gsk_equal_float_value (self1->dx, self2->dx) &&
+         gsk_equal_float_value (self1->dy, self2->dy) &&
+         gsk_equal_float_value (self1->spread, self2->spread) &&
+         gsk_equal_float_value (self1->blur_radius, self2->blur_radius);
+}
+
 static void
 gsk_inset_shadow_node_class_init (gpointer g_class,
                                   gpointer class_data)
@@ -2530,6 +2758,8 @@ gsk_inset_shadow_node_class_init (gpointer g_class,
 
   node_class->draw = gsk_inset_shadow_node_draw;
   node_class->diff = gsk_inset_shadow_node_diff;
+  node_class->hash = gsk_inset_shadow_node_hash;
+  node_class->equal = gsk_inset_shadow_node_equal;
 }
 
 /**
@@ -2833,6 +3063,36 @@ gsk_outset_shadow_node_diff (GskRenderNode *node1,
   gsk_render_node_diff_impossible (node1, node2, data);
 }
 
+static guint64
+gsk_outset_shadow_node_hash (GskRenderNode *node,
+                             guint64        hash)
+{
+  GskOutsetShadowNode *self = (GskOutsetShadowNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->outline);
+  hash = gsk_hash_float_value (hash, self->color);
+  hash = gsk_hash_float_value (hash, self->dx);
+  hash = gsk_hash_float_value (hash, self->dy);
+  hash = gsk_hash_float_value (hash, self->spread);
+
+  return gsk_hash_float_value (hash, self->blur_radius);
+}
+
+static gboolean
+gsk_outset_shadow_node_equal (GskRenderNode *node1,
+                              GskRenderNode *node2)
+{
+  GskOutsetShadowNode *self1 = (GskOutsetShadowNode *) node1;
+  GskOutsetShadowNode *self2 = (GskOutsetShadowNode *) node2;
+
+  return gsk_equal_float_value (self1->outline, self2->outline) &&
+         gsk_equal_float_value (self1->color, self2->color) &&
+         gsk_equal_float_value (self1->dx, self2->dx) &&
+         gsk_equal_float_value (self1->dy, self2->dy) &&
+         gsk_equal_float_value (self1->spread, self2->spread) &&
+         gsk_equal_float_value (self1->blur_radius, self2->blur_radius);
+}
+
 static void
 gsk_outset_shadow_node_class_init (gpointer g_class,
                                    gpointer class_data)
@@ -2843,6 +3103,8 @@ gsk_outset_shadow_node_class_init (gpointer g_class,
 
   node_class->draw = gsk_outset_shadow_node_draw;
   node_class->diff = gsk_outset_shadow_node_diff;
+  node_class->hash = gsk_outset_shadow_node_hash;
+  node_class->equal = gsk_outset_shadow_node_equal;
 }
 
 /**
@@ -3286,6 +3548,41 @@ gsk_container_node_diff (GskRenderNode *node1,
   gsk_render_node_diff_impossible (node1, node2, data);
 }
 
+static guint64
+gsk_container_node_hash (GskRenderNode *node,
+                         guint64        hash)
+{
+  GskContainerNode *self = (GskContainerNode *) node;
+  guint i;
+
+  hash = gsk_hash_value (hash, self->n_children);
+
+  for (i = 0; i < self->n_children && hash != 0; i++)
+    hash = gsk_render_node_hash_child (hash, self->children[i]);
+
+  return hash;
+}
+
+static gboolean
+gsk_container_node_equal (GskRenderNode *node1,
+                          GskRenderNode *node2)
+{
+  GskContainerNode *self1 = (GskContainerNode *) node1;
+  GskContainerNode *self2 = (GskContainerNode *) node2;
+  guint i;
+
+  if (self1->n_children != self2->n_children)
+    return FALSE;
+
+  for (i = 0; i < self1->n_children; i++)
+    {
+      if (!gsk_render_node_child_is_identical (self1->children[i], self2->children[i]))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
 static void
 gsk_container_node_class_init (gpointer g_class,
                                gpointer class_data)
@@ -3297,6 +3594,8 @@ gsk_container_node_class_init (gpointer g_class,
   node_class->finalize = gsk_container_node_finalize;
   node_class->draw = gsk_container_node_draw;
   node_class->diff = gsk_container_node_diff;
+  node_class->hash = gsk_container_node_hash;
+  node_class->equal = gsk_container_node_equal;
 }
 
 /**
@@ -3569,6 +3868,39 @@ gsk_transform_node_diff (GskRenderNode *node1,
     }
 }
 
+static guint64
+gsk_transform_node_hash (GskRenderNode *node,
+                         guint64        hash)
+{
+  GskTransformNode *self = (GskTransformNode *) node;
+  graphene_matrix_t matrix;
+  float values[16];
+
+  gsk_transform_to_matrix (self->transform, &matrix);
+  graphene_matrix_to_float (&matrix, values);
+  hash = gsk_hash_float_value (hash, values);
+
+  return gsk_render_node_hash_child (hash, self->child);
+}
+
+static gboolean
+gsk_transform_node_equal (GskRenderNode *node1,
+                          GskRenderNode *node2)
+{
+  GskTransformNode *self1 = (GskTransformNode *) node1;
+  GskTransformNode *self2 = (GskTransformNode *) node2;
+  graphene_matrix_t matrix;
+  float values1[16], values2[16];
+
+  gsk_transform_to_matrix (self1->transform, &matrix);
+  graphene_matrix_to_float (&matrix, values1);
+  gsk_transform_to_matrix (self2->transform, &matrix);
+  graphene_matrix_to_float (&matrix, values2);
+
+  return gsk_equal_float_value (values1, values2) &&
+         gsk_render_node_child_is_identical (self1->child, self2->child);
+}
+
 static void
 gsk_transform_node_class_init (gpointer g_class,
                                gpointer class_data)
@@ -3581,6 +3913,8 @@ gsk_transform_node_class_init (gpointer g_class,
   node_class->draw = gsk_transform_node_draw;
   node_class->can_diff = gsk_transform_node_can_diff;
   node_class->diff = gsk_transform_node_diff;
+  node_class->hash = gsk_transform_node_hash;
+  node_class->equal = gsk_transform_node_equal;
 }
 
 /**
@@ -3729,6 +4063,28 @@ gsk_opacity_node_diff (GskRenderNode *node1,
     gsk_render_node_diff_impossible (node1, node2, data);
 }
 
+static guint64
+gsk_opacity_node_hash (GskRenderNode *node,
+                       guint64        hash)
+{
+  GskOpacityNode *self = (GskOpacityNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->opacity);
+
+  return gsk_render_node_hash_child (hash, self->child);
+}
+
+static gboolean
+gsk_opacity_node_equal (GskRenderNode *node1,
+                        GskRenderNode *node2)
+{
+  GskOpacityNode *self1 = (GskOpacityNode *) node1;
+  GskOpacityNode *self2 = (GskOpacityNode *) node2;
+
+  return gsk_equal_float_value (self1->opacity, self2->opacity) &&
+         gsk_render_node_child_is_identical (self1->child, self2->child);
+}
+
 static void
 gsk_opacity_node_class_init (gpointer g_class,
                              gpointer class_data)
@@ -3740,6 +4096,8 @@ gsk_opacity_node_class_init (gpointer g_class,
   node_class->finalize = gsk_opacity_node_finalize;
   node_class->draw = gsk_opacity_node_draw;
   node_class->diff = gsk_opacity_node_diff;
+  node_class->hash = gsk_opacity_node_hash;
+  node_class->equal = gsk_opacity_node_equal;
 }
 
 /**
@@ -3951,6 +4309,42 @@ nope:
   return;
 }
 
+static guint64
+gsk_color_matrix_node_hash (GskRenderNode *node,
+                            guint64        hash)
+{
+  GskColorMatrixNode *self = (GskColorMatrixNode *) node;
+  float values[16];
+
+  graphene_matrix_to_float (&self->color_matrix, values);
+  hash = gsk_hash_float_value (hash, values);
+  graphene_vec4_to_float (&self->color_offset, values);
+  hash = gsk_hash_floats (hash, values, 4);
+
+  return gsk_render_node_hash_child (hash, self->child);
+}
+
+static gboolean
+gsk_color_matrix_node_equal (GskRenderNode *node1,
+                             GskRenderNode *node2)
+{
+  GskColorMatrixNode *self1 = (GskColorMatrixNode *) node1;
+  GskColorMatrixNode *self2 = (GskColorMatrixNode *) node2;
+  float values1[16], values2[16];
+
+  graphene_matrix_to_float (&self1->color_matrix, values1);
+  graphene_matrix_to_float (&self2->color_matrix, values2);
+  if (!gsk_equal_float_value (values1, values2))
+    return FALSE;
+
+  graphene_vec4_to_float (&self1->color_offset, values1);
+  graphene_vec4_to_float (&self2->color_offset, values2);
+  if (!gsk_equal_floats (values1, values2, 4))
+    return FALSE;
+
+  return gsk_render_node_child_is_identical (self1->child, self2->child);
+}
+
 static void
 gsk_color_matrix_node_class_init (gpointer g_class,
                                   gpointer class_data)
@@ -3962,6 +4356,8 @@ gsk_color_matrix_node_class_init (gpointer g_class,
   node_class->finalize = gsk_color_matrix_node_finalize;
   node_class->draw = gsk_color_matrix_node_draw;
   node_class->diff = gsk_color_matrix_node_diff;
+  node_class->hash = gsk_color_matrix_node_hash;
+  node_class->equal = gsk_color_matrix_node_equal;
 }
 
 /**
@@ -4249,6 +4645,28 @@ gsk_repeat_node_diff (GskRenderNode *node1,
   gsk_render_node_diff_impossible (node1, node2, data);
 }
 
+static guint64
+gsk_repeat_node_hash (GskRenderNode *node,
+                      guint64        hash)
+{
+  GskRepeatNode *self = (GskRepeatNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->child_bounds);
+
+  return gsk_render_node_hash_child (hash, self->child);
+}
+
+static gboolean
+gsk_repeat_node_equal (GskRenderNode *node1,
+                       GskRenderNode *node2)
+{
+  GskRepeatNode *self1 = (GskRepeatNode *) node1;
+  GskRepeatNode *self2 = (GskRepeatNode *) node2;
+
+  return gsk_equal_float_value (self1->child_bounds, self2->child_bounds) &&
+         gsk_render_node_child_is_identical (self1->child, self2->child);
+}
+
 static void
 gsk_repeat_node_class_init (gpointer g_class,
                             gpointer class_data)
@@ -4260,6 +4678,8 @@ gsk_repeat_node_class_init (gpointer g_class,
   node_class->finalize = gsk_repeat_node_finalize;
   node_class->draw = gsk_repeat_node_draw;
   node_class->diff = gsk_repeat_node_diff;
+  node_class->hash = gsk_repeat_node_hash;
+  node_class->equal = gsk_repeat_node_equal;
 }
 
 /**
@@ -4410,6 +4830,28 @@ gsk_clip_node_diff (GskRenderNode *node1,
     }
 }
 
+static guint64
+gsk_clip_node_hash (GskRenderNode *node,
+                    guint64        hash)
+{
+  GskClipNode *self = (GskClipNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->clip);
+
+  return gsk_render_node_hash_child (hash, self->child);
+}
+
+static gboolean
+gsk_clip_node_equal (GskRenderNode *node1,
+                     GskRenderNode *node2)
+{
+  GskClipNode *self1 = (GskClipNode *) node1;
+  GskClipNode *self2 = (GskClipNode *) node2;
+
+  return gsk_equal_float_value (self1->clip, self2->clip) &&
+         gsk_render_node_child_is_identical (self1->child, self2->child);
+}
+
 static void
 gsk_clip_node_class_init (gpointer g_class,
                                gpointer class_data)
@@ -4421,6 +4863,8 @@ gsk_clip_node_class_init (gpointer g_class,
   node_class->finalize = gsk_clip_node_finalize;
   node_class->draw = gsk_clip_node_draw;
   node_class->diff = gsk_clip_node_diff;
+  node_class->hash = gsk_clip_node_hash;
+  node_class->equal = gsk_clip_node_equal;
 }
 
 /**
@@ -4559,6 +5003,28 @@ gsk_rounded_clip_node_diff (GskRenderNode *node1,
     }
 }
 
+static guint64
+gsk_rounded_clip_node_hash (GskRenderNode *node,
+                            guint64        hash)
+{
+  GskRoundedClipNode *self = (GskRoundedClipNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->clip);
+
+  return gsk_render_node_hash_child (hash, self->child);
+}
+
+static gboolean
+gsk_rounded_clip_node_equal (GskRenderNode *node1,
+                             GskRenderNode *node2)
+{
+  GskRoundedClipNode *self1 = (GskRoundedClipNode *) node1;
+  GskRoundedClipNode *self2 = (GskRoundedClipNode *) node2;
+
+  return gsk_equal_float_value (self1->clip, self2->clip) &&
+         gsk_render_node_child_is_identical (self1->child, self2->child);
+}
+
 static void
 gsk_rounded_clip_node_class_init (gpointer g_class,
                                   gpointer class_data)
@@ -4570,6 +5036,8 @@ gsk_rounded_clip_node_class_init (gpointer g_class,
   node_class->finalize = gsk_rounded_clip_node_finalize;
   node_class->draw = gsk_rounded_clip_node_draw;
   node_class->diff = gsk_rounded_clip_node_diff;
+  node_class->hash = gsk_rounded_clip_node_hash;
+  node_class->equal = gsk_rounded_clip_node_equal;
 }
 
 /**
@@ -5203,6 +5671,31 @@ gsk_shadow_node_get_bounds (GskShadowNode *self,
   bounds->size.height += top + bottom;
 }
 
+static guint64
+gsk_shadow_node_hash (GskRenderNode *node,
+                      guint64        hash)
+{
+  GskShadowNode *self = (GskShadowNode *) node;
+
+  hash = gsk_hash_floats (hash, (const float *) self->shadows,
+                          self->n_shadows * sizeof (GskShadow) / sizeof (float));
+
+  return gsk_render_node_hash_child (hash, self->child);
+}
+
+static gboolean
+gsk_shadow_node_equal (GskRenderNode *node1,
+                       GskRenderNode *node2)
+{
+  GskShadowNode *self1 = (GskShadowNode *) node1;
+  GskShadowNode *self2 = (GskShadowNode *) node2;
+
+  return self1->n_shadows == self2->n_shadows &&
+         gsk_equal_floats ((const float *) self1->shadows, (const float *) self2->shadows,
+                           self1->n_shadows * sizeof (GskShadow) / sizeof (float)) &&
+         gsk_render_node_child_is_identical (self1->child, self2->child);
+}
+
 static void
 gsk_shadow_node_class_init (gpointer g_class,
                             gpointer class_data)
@@ -5214,6 +5707,8 @@ gsk_shadow_node_class_init (gpointer g_class,
   node_class->finalize = gsk_shadow_node_finalize;
   node_class->draw = gsk_shadow_node_draw;
   node_class->diff = gsk_shadow_node_diff;
+  node_class->hash = gsk_shadow_node_hash;
+  node_class->equal = gsk_shadow_node_equal;
 }
 
 /**
@@ -5418,6 +5913,32 @@ gsk_blend_node_diff (GskRenderNode *node1,
     }
 }
 
+static guint64
+gsk_blend_node_hash (GskRenderNode *node,
+                     guint64        hash)
+{
+  GskBlendNode *self = (GskBlendNode *) node;
+
+  hash = gsk_hash_value (hash, self->blend_mode);
+  hash = gsk_render_node_hash_child (hash, self->bottom);
+  if (hash == 0)
+    return 0;
+
+  return gsk_render_node_hash_child (hash, self->top);
+}
+
+static gboolean
+gsk_blend_node_equal (GskRenderNode *node1,
+                      GskRenderNode *node2)
+{
+  GskBlendNode *self1 = (GskBlendNode *) node1;
+  GskBlendNode *self2 = (GskBlendNode *) node2;
+
+  return gsk_equal_value (self1->blend_mode, self2->blend_mode) &&
+         gsk_render_node_child_is_identical (self1->bottom, self2->bottom) &&
+         gsk_render_node_child_is_identical (self1->top, self2->top);
+}
+
 static void
 gsk_blend_node_class_init (gpointer g_class,
                            gpointer class_data)
@@ -5429,6 +5950,8 @@ gsk_blend_node_class_init (gpointer g_class,
   node_class->finalize = gsk_blend_node_finalize;
   node_class->draw = gsk_blend_node_draw;
   node_class->diff = gsk_blend_node_diff;
+  node_class->hash = gsk_blend_node_hash;
+  node_class->equal = gsk_blend_node_equal;
 }
 
 /**
@@ -5587,6 +6110,32 @@ gsk_cross_fade_node_diff (GskRenderNode *node1,
   gsk_render_node_diff_impossible (node1, node2, data);
 }
 
+static guint64
+gsk_cross_fade_node_hash (GskRenderNode *node,
+                          guint64        hash)
+{
+  GskCrossFadeNode *self = (GskCrossFadeNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->progress);
+  hash = gsk_render_node_hash_child (hash, self->start);
+  if (hash == 0)
+    return 0;
+
+  return gsk_render_node_hash_child (hash, self->end);
+}
+
+static gboolean
+gsk_cross_fade_node_equal (GskRenderNode *node1,
+                           GskRenderNode *node2)
+{
+  GskCrossFadeNode *self1 = (GskCrossFadeNode *) node1;
+  GskCrossFadeNode *self2 = (GskCrossFadeNode *) node2;
+
+  return gsk_equal_float_value (self1->progress, self2->progress) &&
+         gsk_render_node_child_is_identical (self1->start, self2->start) &&
+         gsk_render_node_child_is_identical (self1->end, self2->end);
+}
+
 static void
 gsk_cross_fade_node_class_init (gpointer g_class,
                                 gpointer class_data)
@@ -5598,6 +6147,8 @@ gsk_cross_fade_node_class_init (gpointer g_class,
   node_class->finalize = gsk_cross_fade_node_finalize;
   node_class->draw = gsk_cross_fade_node_draw;
   node_class->diff = gsk_cross_fade_node_diff;
+  node_class->hash = gsk_cross_fade_node_hash;
+  node_class->equal = gsk_cross_fade_node_equal;
 }
 
 /**
@@ -5780,6 +6331,59 @@ gsk_text_node_diff (GskRenderNode *node1,
   gsk_render_node_diff_impossible (node1, node2, data);
 }
 
+static guint64
+gsk_text_node_hash (GskRenderNode *node,
+                    guint64        hash)
+{
+  GskTextNode *self = (GskTextNode *) node;
+  guint i;
+
+  hash = gsk_hash_value (hash, self->font);
+  hash = gsk_hash_float_value (hash, self->color);
+  hash = gsk_hash_float_value (hash, self->offset);
+
+  /* Not the whole PangoGlyphInfo, its attributes are bitfields */
+  for (i = 0; i < self->num_glyphs; i++)
+    {
+      const PangoGlyphInfo *info = &self->glyphs[i];
+      guint color = info->attr.is_color;
+
+      hash = gsk_hash_value (hash, info->glyph);
+      hash = gsk_hash_value (hash, info->geometry);
+      hash = gsk_hash_value (hash, color);
+    }
+
+  return hash;
+}
+
+static gboolean
+gsk_text_node_equal (GskRenderNode *node1,
+                     GskRenderNode *node2)
+{
+  GskTextNode *self1 = (GskTextNode *) node1;
+  GskTextNode *self2 = (GskTextNode *) node2;
+  guint i;
+
+  if (self1->font != self2->font ||
+      !gsk_equal_float_value (self1->color, self2->color) ||
+      !gsk_equal_float_value (self1->offset, self2->offset) ||
+      self1->num_glyphs != self2->num_glyphs)
+    return FALSE;
+
+  for (i = 0; i < self1->num_glyphs; i++)
+    {
+      const PangoGlyphInfo *info1 = &self1->glyphs[i];
+      const PangoGlyphInfo *info2 = &self2->glyphs[i];
+
+      if (info1->glyph != info2->glyph ||
+          !gsk_equal_value (info1->geometry, info2->geometry) ||
+          info1->attr.is_color != info2->attr.is_color)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
 static void
 gsk_text_node_class_init (gpointer g_class,
                           gpointer class_data)
@@ -5791,6 +6395,8 @@ gsk_text_node_class_init (gpointer g_class,
   node_class->finalize = gsk_text_node_finalize;
   node_class->draw = gsk_text_node_draw;
   node_class->diff = gsk_text_node_diff;
+  node_class->hash = gsk_text_node_hash;
+  node_class->equal = gsk_text_node_equal;
 }
 
 static inline float
@@ -6229,6 +6835,28 @@ gsk_blur_node_diff (GskRenderNode *node1,
     }
 }
 
+static guint64
+gsk_blur_node_hash (GskRenderNode *node,
+                    guint64        hash)
+{
+  GskBlurNode *self = (GskBlurNode *) node;
+
+  hash = gsk_hash_float_value (hash, self->radius);
+
+  return gsk_render_node_hash_child (hash, self->child);
+}
+
+static gboolean
+gsk_blur_node_equal (GskRenderNode *node1,
+                     GskRenderNode *node2)
+{
+  GskBlurNode *self1 = (GskBlurNode *) node1;
+  GskBlurNode *self2 = (GskBlurNode *) node2;
+
+  return gsk_equal_float_value (self1->radius, self2->radius) &&
+         gsk_render_node_child_is_identical (self1->child, self2->child);
+}
+
 static void
 gsk_blur_node_class_init (gpointer g_class,
                           gpointer class_data)
@@ -6240,6 +6868,8 @@ gsk_blur_node_class_init (gpointer g_class,
   node_class->finalize = gsk_blur_node_finalize;
   node_class->draw = gsk_blur_node_draw;
   node_class->diff = gsk_blur_node_diff;
+  node_class->hash = gsk_blur_node_hash;
+  node_class->equal = gsk_blur_node_equal;
 }
 
 /**
@@ -6460,6 +7090,32 @@ gsk_mask_node_diff (GskRenderNode *node1,
   gsk_render_node_diff (self1->mask, self2->mask, data);
 }
 
+static guint64
+gsk_mask_node_hash (GskRenderNode *node,
+                    guint64        hash)
+{
+  GskMaskNode *self = (GskMaskNode *) node;
+
+  hash = gsk_hash_value (hash, self->mask_mode);
+  hash = gsk_render_node_hash_child (hash, self->source);
+  if (hash == 0)
+    return 0;
+
+  return gsk_render_node_hash_child (hash, self->mask);
+}
+
+static gboolean
+gsk_mask_node_equal (GskRenderNode *node1,
+                     GskRenderNode *node2)
+{
+  GskMaskNode *self1 = (GskMaskNode *) node1;
+  GskMaskNode *self2 = (GskMaskNode *) node2;
+
+  return gsk_equal_value (self1->mask_mode, self2->mask_mode) &&
+         gsk_render_node_child_is_identical (self1->source, self2->source) &&
+         gsk_render_node_child_is_identical (self1->mask, self2->mask);
+}
+
 static void
 gsk_mask_node_class_init (gpointer g_class,
                           gpointer class_data)
@@ -6471,6 +7127,8 @@ gsk_mask_node_class_init (gpointer g_class,
   node_class->finalize = gsk_mask_node_finalize;
   node_class->draw = gsk_mask_node_draw;
   node_class->diff = gsk_mask_node_diff;
+  node_class->hash = gsk_mask_node_hash;
+  node_class->equal = gsk_mask_node_equal;
 }
 
 /**
@@ -6631,6 +7289,26 @@ gsk_debug_node_diff (GskRenderNode *node1,
   gsk_render_node_diff (self1->child, self2->child, data);
 }
 
+/* Like diffing, this ignores the message */
+static guint64
+gsk_debug_node_hash (GskRenderNode *node,
+                     guint64        hash)
+{
+  GskDebugNode *self = (GskDebugNode *) node;
+
+  return gsk_render_node_hash_child (hash, self->child);
+}
+
+static gboolean
+gsk_debug_node_equal (GskRenderNode *node1,
+                      GskRenderNode *node2)
+{
+  GskDebugNode *self1 = (GskDebugNode *) node1;
+  GskDebugNode *self2 = (GskDebugNode *) node2;
+
+  return gsk_render_node_child_is_identical (self1->child, self2->child);
+}
+
 static void
 gsk_debug_node_class_init (gpointer g_class,
                            gpointer class_data)
@@ -6643,6 +7321,8 @@ gsk_debug_node_class_init (gpointer g_class,
   node_class->draw = gsk_debug_node_draw;
   node_class->can_diff = gsk_debug_node_can_diff;
   node_class->diff = gsk_debug_node_diff;
+  node_class->hash = gsk_debug_node_hash;
+  node_class->equal = gsk_debug_node_equal;
 }
 
 /**
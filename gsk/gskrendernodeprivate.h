@@ -34,6 +34,9 @@ struct _GskRenderNode
 
   guint preferred_depth : 2;
   guint offscreen_for_opacity : 1;
+  guint hash_computed : 1;
+
+  guint64 hash;
 };
 
 typedef struct
@@ -56,6 +59,10 @@ struct _GskRenderNodeClass
   void            (* diff)        (GskRenderNode  *node1,
                                    GskRenderNode  *node2,
                                    GskDiffData    *data);
+  guint64         (* hash)        (GskRenderNode  *node,
+                                   guint64         hash);
+  gboolean        (* equal)       (GskRenderNode  *node1,
+                                   GskRenderNode  *node2);
 };
 
 void            gsk_render_node_init_types              (void);
@@ -79,6 +86,11 @@ void            gsk_render_node_diff_impossible         (GskRenderNode
 void            gsk_container_node_diff_with            (GskRenderNode               *container,
                                                          GskRenderNode               *other,
                                                          GskDiffData                 *data);
+guint64         gsk_render_node_get_hash                (GskRenderNode               *node);
+gboolean        gsk_render_node_is_identical            (GskRenderNode               *node1,
+                                                         GskRenderNode               *node2);
+gboolean        gsk_render_node_child_is_identical      (GskRenderNode               *child1,
+                                                         GskRenderNode               *child2);
 void            gsk_render_node_draw_fallback           (GskRenderNode               *node,
                                                          cairo_t                     *cr);
 
@@ -100,6 +112,83 @@ gboolean        gsk_container_node_is_disjoint          (const GskRenderNode
 
 gboolean        gsk_render_node_use_offscreen_for_opacity (const GskRenderNode       *node) G_GNUC_PURE;
 
+#define GSK_HASH_INIT 0xcbf29ce484222325ull
+
+/* FNV-1a, for hashing the contents of nodes */
+static inline guint64
+gsk_hash_bytes (guint64       hash,
+                gconstpointer data,
+                gsize         size)
+{
+  const guchar *bytes = data;
+  gsize i;
+
+  for (i = 0; i < size; i++)
+    {
+      hash ^= bytes[i];
+      hash *= 0x100000001b3ull;
+    }
+
+  return hash;
+}
+
+#define gsk_hash_value(hash, value) gsk_hash_bytes ((hash), &(value), sizeof (value))
+
+/* Compares what gsk_hash_value() hashed */
+#define gsk_equal_value(value1, value2) (memcmp (&(value1), &(value2), sizeof (value1)) == 0)
+
+/* Floats are compared with ==, so -0.0 must hash like 0.0 */
+static inline guint64
+gsk_hash_floats (guint64      hash,
+                 const float *values,
+                 gsize        n_values)
+{
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    {
+      float value = values[i] == 0.f ? 0.f : values[i];
+
+      hash = gsk_hash_value (hash, value);
+    }
+
+  return hash;
+}
+
+static inline gboolean
+gsk_equal_floats (const float *values1,
+                  const float *values2,
+                  gsize        n_values)
+{
+  gsize i;
+
+  for (i = 0; i < n_values; i++)
+    {
+      if (values1[i] != values2[i])
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* For values made of floats only, like GdkRGBA or graphene_rect_t */
+#define gsk_hash_float_value(hash, value) \
+  gsk_hash_floats ((hash), (const float *) &(value), sizeof (value) / sizeof (float))
+#define gsk_equal_float_value(value1, value2) \
+  gsk_equal_floats ((const float *) &(value1), (const float *) &(value2), sizeof (value1) / sizeof (float))
+
+static inline guint64
+gsk_render_node_hash_child (guint64        hash,
+                            GskRenderNode *child)
+{
+  guint64 child_hash = gsk_render_node_get_hash (child);
+
+  if (child_hash == 0)
+    return 0;
+
+  return gsk_hash_value (hash, child_hash);
+}
+
 #define gsk_render_node_ref(node)   _gsk_render_node_ref(node)
 #define gsk_render_node_unref(node) _gsk_render_node_unref(node)
 
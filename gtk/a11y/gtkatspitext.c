@@ -67,6 +67,11 @@ atspi_granularity_to_gtk (AtspiTextGranularity granularity)
 
 /* {{{ GtkAccessibleText */
 
+/* The largest message that the D-Bus protocol allows is 128 MiB,
+ * leave some room for the header
+ */
+#define MAX_TEXT_SIZE ((1 << 27) - 4096)
+
 static void
 accessible_text_handle_method (GDBusConnection       *connection,
                                const gchar           *sender,
@@ -102,7 +107,16 @@ accessible_text_handle_method (GDBusConnection       *connection,
 
       contents = gtk_accessible_text_get_contents (accessible_text, start, end < 0 ? G_MAXUINT : end);
 
-      g_dbus_method_invocation_return_value (invocation, g_variant_new ("(s)", g_bytes_get_data (contents, NULL)));
+      /* A reply that does not fit in a D-Bus message would only be
+       * dropped by the connection, so tell the client to ask for less
+       */
+      if (g_bytes_get_size (contents) > MAX_TEXT_SIZE)
+        g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR, G_DBUS_ERROR_LIMITS_EXCEEDED,
+                                               "The text from %d to %d does not fit in a message, "
+                                               "request a smaller range",
+                                               start, end);
+      else
+        g_dbus_method_invocation_return_value (invocation, g_variant_new ("(s)", g_bytes_get_data (contents, NULL)));
 
       g_bytes_unref (contents);
     }
@@ -456,16 +470,11 @@ accessible_text_get_property (GDBusConnection  *connection,
 
   if (g_strcmp0 (property_name, "CharacterCount") == 0)
     {
-      GBytes *contents;
-      const char *str;
-      gsize len;
+      guint n_chars;
 
-      contents = gtk_accessible_text_get_contents (accessible_text, 0, G_MAXUINT);
-      str = g_bytes_get_data (contents, NULL);
-      len = g_utf8_strlen (str, -1);
-      g_bytes_unref (contents);
+      n_chars = gtk_accessible_text_get_character_count (accessible_text);
 
-      return g_variant_new_int32 ((int) len);
+      return g_variant_new_int32 ((int) n_chars);
     }
   else if (g_strcmp0 (property_name, "CaretOffset") == 0)
     {
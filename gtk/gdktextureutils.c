@@ -19,7 +19,9 @@
 #include <gdk/gdk.h>
 #include "gdktextureutilsprivate.h"
 #include "gtkscalerprivate.h"
+#include "gtksymbolicpathsprivate.h"
 
+#include "gdk/gdktexturecacheprivate.h"
 #include "gdk/gdktextureprivate.h"
 #include "gdk/loaders/gdkpngprivate.h"
 
@@ -330,11 +332,11 @@ svg_find_size_strings (const char  *data,
   *width = NULL;
   *height = NULL;
 
-  for (i = 0; i < len - 4; i++)
+  for (i = 0; i + 4 < len; i++)
     {
       if (strncmp (data + i, "<svg", 4) == 0)
         {
-          for (j = i + strlen ("<svg"); j < len - 9; j++)
+          for (j = i + strlen ("<svg"); j + 9 < len; j++)
             {
               if (strncmp (data + j, "height=\"", strlen ("height=\"")) == 0)
                 {
@@ -389,42 +391,108 @@ svg_has_symbolic_classes (const char *data,
 #endif
 }
 
-GdkPixbuf *
-gtk_make_symbolic_pixbuf_from_data (const char  *file_data,
-                                    gsize        file_len,
-                                    int          width,
-                                    int          height,
-                                    double       scale,
-                                    const char  *debug_output_basename,
-                                    GError     **error)
+/* The parts of a symbolic icon that don't depend on the size
+ * it is rendered at. Symbolic icons with colored parts are
+ * rendered once per color plane, from a wrapper svg that
+ * includes the icon as base64 data.
+ */
+typedef struct
+{
+  char *key;
+  GBytes *bytes;
+  gboolean has_symbolic_classes;
+  char *width_str;
+  char *height_str;
+  char *escaped_data;
+  gsize escaped_len;
+  /* parsed on first use */
+  gsize paths_initialized;
+  GtkSymbolicPaths *paths;
+  GList lru_link;
+} SymbolicSource;
+
+static void
+symbolic_source_clear (gpointer data)
+{
+  SymbolicSource *source = data;
+
+  g_free (source->key);
+  g_bytes_unref (source->bytes);
+  g_free (source->width_str);
+  g_free (source->height_str);
+  g_free (source->escaped_data);
+  g_clear_pointer (&source->paths, gtk_symbolic_paths_unref);
+}
+
+static void
+symbolic_source_unref (SymbolicSource *source)
+{
+  g_atomic_rc_box_release_full (source, symbolic_source_clear);
+}
+
+static SymbolicSource *
+symbolic_source_new (const char *key,
+                     GBytes     *bytes)
+{
+  SymbolicSource *source;
+  const char *data;
+  gsize len;
+
+  data = g_bytes_get_data (bytes, &len);
+
+  source = g_atomic_rc_box_new0 (SymbolicSource);
+  source->key = g_strdup (key);
+  source->bytes = g_bytes_ref (bytes);
+  source->has_symbolic_classes = svg_has_symbolic_classes (data, len);
+  source->lru_link.data = source;
+
+  svg_find_size_strings (data, len, &source->width_str, &source->height_str);
 
+  if (source->has_symbolic_classes)
+    {
+      source->escaped_data = g_base64_encode ((const guchar *) data, len);
+      source->escaped_len = strlen (source->escaped_data);
+    }
+
+  return source;
+}
+
+static GtkSymbolicPaths *
+symbolic_source_get_paths (SymbolicSource *source)
+{
+  if (g_once_init_enter (&source->paths_initialized))
+    {
+      source->paths = gtk_symbolic_paths_new (source->bytes, source->has_symbolic_classes);
+      g_once_init_leave (&source->paths_initialized, 1);
+    }
+
+  return source->paths;
+}
+
+static GdkPixbuf *
+symbolic_source_render (SymbolicSource  *source,
+                        int              width,
+                        int              height,
+                        double           scale,
+                        const char      *debug_output_basename,
+                        GError         **error)
 {
   const char *r_string = "rgb(255,0,0)";
   const char *g_string = "rgb(0,255,0)";
-  char *icon_width_str = NULL;
-  char *icon_height_str = NULL;
-  char *escaped_file_data = NULL;
-  gsize len;
   GdkPixbuf *pixbuf = NULL;
-  gboolean has_symbolic_classes;
   gboolean only_fg = TRUE;
 
-  has_symbolic_classes = svg_has_symbolic_classes (file_data, file_len);
-
   /* Fetch size from the original icon */
-  if (has_symbolic_classes || width == 0 || height == 0)
-    svg_find_size_strings (file_data, file_len, &icon_width_str, &icon_height_str);
-
   if (width == 0)
-    width = (int) (g_ascii_strtoull (icon_width_str, NULL, 0) * scale);
+    width = (int) (g_ascii_strtoull (source->width_str, NULL, 0) * scale);
   if (height == 0)
-    height = (int) (g_ascii_strtoull (icon_height_str, NULL, 0) * scale);
+    height = (int) (g_ascii_strtoull (source->height_str, NULL, 0) * scale);
 
-  if (!has_symbolic_classes)
+  if (!source->has_symbolic_classes)
     {
       GInputStream *stream;
 
-      stream = g_memory_input_stream_new_from_data (file_data, file_len, NULL);
+      stream = g_memory_input_stream_new_from_bytes (source->bytes);
       pixbuf = gdk_pixbuf_new_from_stream_at_scale (stream, width, height, TRUE, NULL, error);
       g_object_unref (stream);
 
@@ -434,9 +502,6 @@ gtk_make_symbolic_pixbuf_from_data (const char  *file_data,
       goto out;
     }
 
-  escaped_file_data = g_base64_encode ((guchar *) file_data, file_len);
-  len = strlen (escaped_file_data);
-
   for (int plane = 0; plane < 3; plane++)
     {
       GdkPixbuf *loaded;
@@ -453,16 +518,19 @@ gtk_make_symbolic_pixbuf_from_data (const char  *file_data,
        * channels, with the color of the fg being implicitly
        * the "rest", as all color fractions should add up to 1.
        */
-      loaded = load_symbolic_svg (escaped_file_data, len, width, height,
-                                  icon_width_str,
-                                  icon_height_str,
+      loaded = load_symbolic_svg (source->escaped_data, source->escaped_len, width, height,
+                                  source->width_str,
+                                  source->height_str,
                                   g_string,
                                   plane == 0 ? r_string : g_string,
                                   plane == 1 ? r_string : g_string,
                                   plane == 2 ? r_string : g_string,
                                   error);
       if (loaded == NULL)
-        goto out;
+        {
+          g_clear_object (&pixbuf);
+          goto out;
+        }
 
       if (debug_output_basename)
         {
@@ -493,78 +561,298 @@ out:
   if (only_fg && pixbuf)
     gdk_pixbuf_set_option (pixbuf, "tEXt::only-foreground", "true");
 
-  g_free (escaped_file_data);
-  g_free (icon_width_str);
-  g_free (icon_height_str);
-
   return pixbuf;
 }
 
-static GdkPixbuf *
-make_symbolic_pixbuf_from_resource (const char  *path,
+GdkPixbuf *
+gtk_make_symbolic_pixbuf_from_data (const char  *file_data,
+                                    gsize        file_len,
                                     int          width,
                                     int          height,
                                     double       scale,
+                                    const char  *debug_output_basename,
                                     GError     **error)
+
 {
+  SymbolicSource *source;
   GBytes *bytes;
-  const char *data;
-  gsize size;
   GdkPixbuf *pixbuf;
 
-  bytes = g_resources_lookup_data (path, G_RESOURCE_LOOKUP_FLAGS_NONE, error);
-  if (bytes == NULL)
-    return NULL;
+  bytes = g_bytes_new_static (file_data, file_len);
+  source = symbolic_source_new (NULL, bytes);
+  g_bytes_unref (bytes);
 
-  data = g_bytes_get_data (bytes, &size);
+  pixbuf = symbolic_source_render (source, width, height, scale, debug_output_basename, error);
 
-  pixbuf = gtk_make_symbolic_pixbuf_from_data (data, size, width, height, scale, NULL, error);
-
-  g_bytes_unref (bytes);
+  symbolic_source_unref (source);
 
   return pixbuf;
 }
 
-static GdkPixbuf *
-make_symbolic_pixbuf_from_filename (const char  *filename,
-                                    int          width,
-                                    int          height,
-                                    double       scale,
-                                    GError     **error)
+/* }}} */
+/* {{{ Symbolic icon cache */
+
+/* The sources of recently loaded symbolic icons, so that loading
+ * them at another size does not read and encode the file again.
+ * The rendered textures themselves are shared via the texture
+ * cache, and recoloring them is done when drawing.
+ */
+
+/* Maximum number of sources kept around */
+#define MAX_SYMBOLIC_SOURCES 256
+
+G_LOCK_DEFINE_STATIC (symbolic_cache);
+static GHashTable *symbolic_sources;
+static GQueue symbolic_lru;
+static guint64 symbolic_n_hits;
+static guint64 symbolic_n_misses;
+
+static GQuark
+only_fg_quark (void)
 {
-  char *data;
+  static GQuark quark = 0;
+
+  if (G_UNLIKELY (quark == 0))
+    quark = g_quark_from_static_string ("gtk-symbolic-only-fg");
+
+  return quark;
+}
+
+/* Call with the lock held */
+static void
+symbolic_cache_evict_last (void)
+{
+  SymbolicSource *source = g_queue_peek_tail (&symbolic_lru);
+
+  g_queue_unlink (&symbolic_lru, &source->lru_link);
+  g_hash_table_remove (symbolic_sources, source->key);
+}
+
+static SymbolicSource *
+symbolic_cache_lookup (const char *key)
+{
+  SymbolicSource *source;
+
+  G_LOCK (symbolic_cache);
+
+  if (G_UNLIKELY (symbolic_sources == NULL))
+    symbolic_sources = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                              NULL, (GDestroyNotify) symbolic_source_unref);
+
+  source = g_hash_table_lookup (symbolic_sources, key);
+  if (source)
+    {
+      symbolic_n_hits++;
+      g_queue_unlink (&symbolic_lru, &source->lru_link);
+      g_queue_push_head_link (&symbolic_lru, &source->lru_link);
+      g_atomic_rc_box_acquire (source);
+    }
+  else
+    {
+      symbolic_n_misses++;
+    }
+
+  G_UNLOCK (symbolic_cache);
+
+  return source;
+}
+
+static void
+symbolic_cache_insert (SymbolicSource *source)
+{
+  G_LOCK (symbolic_cache);
+
+  /* Someone else loaded the same icon at the same time */
+  if (g_hash_table_contains (symbolic_sources, source->key))
+    {
+      G_UNLOCK (symbolic_cache);
+      return;
+    }
+
+  g_hash_table_insert (symbolic_sources, source->key, g_atomic_rc_box_acquire (source));
+  g_queue_push_head_link (&symbolic_lru, &source->lru_link);
+
+  while (symbolic_lru.length > MAX_SYMBOLIC_SOURCES)
+    symbolic_cache_evict_last ();
+
+  G_UNLOCK (symbolic_cache);
+}
+
+/*
+ * gtk_symbolic_cache_clear:
+ *
+ * Drops all sources of symbolic icons from the cache.
+ */
+void
+gtk_symbolic_cache_clear (void)
+{
+  G_LOCK (symbolic_cache);
+
+  while (symbolic_lru.length > 0)
+    symbolic_cache_evict_last ();
+
+  G_UNLOCK (symbolic_cache);
+}
+
+void
+gtk_symbolic_cache_get_stats (GtkSymbolicCacheStats *stats)
+{
+  G_LOCK (symbolic_cache);
+
+  stats->n_entries = symbolic_lru.length;
+  stats->max_entries = MAX_SYMBOLIC_SOURCES;
+  stats->n_hits = symbolic_n_hits;
+  stats->n_misses = symbolic_n_misses;
+
+  G_UNLOCK (symbolic_cache);
+}
+
+typedef GBytes * (* SymbolicLoadFunc) (gconstpointer   data,
+                                       GError        **error);
+
+static GBytes *
+load_symbolic_filename (gconstpointer   data,
+                        GError        **error)
+{
+  char *contents;
   gsize size;
-  GdkPixbuf *pixbuf;
 
-  if (!g_file_get_contents (filename, &data, &size, error))
+  if (!g_file_get_contents (data, &contents, &size, error))
     return NULL;
 
-  pixbuf = gtk_make_symbolic_pixbuf_from_data (data, size, width, height, scale, NULL, error);
+  return g_bytes_new_take (contents, size);
+}
 
-  g_free (data);
+static GBytes *
+load_symbolic_resource (gconstpointer   data,
+                        GError        **error)
+{
+  return g_resources_lookup_data (data, G_RESOURCE_LOOKUP_FLAGS_NONE, error);
+}
 
-  return pixbuf;
+static GBytes *
+load_symbolic_file (gconstpointer   data,
+                    GError        **error)
+{
+  return g_file_load_bytes ((GFile *) data, NULL, NULL, error);
 }
 
-static GdkPixbuf *
-make_symbolic_pixbuf_from_file (GFile       *file,
-                                int          width,
-                                int          height,
-                                double       scale,
-                                GError     **error)
+/* Returns the source for a symbolic icon, from the cache if
+ * it was loaded before. A %NULL @key means the file can't be
+ * cached.
+ */
+static SymbolicSource *
+symbolic_source_get (const char        *key,
+                     SymbolicLoadFunc   load_func,
+                     gconstpointer      data,
+                     GError           **error)
 {
-  char *data;
-  gsize size;
+  SymbolicSource *source = NULL;
+  GBytes *bytes;
+
+  if (key)
+    {
+      source = symbolic_cache_lookup (key);
+      if (source)
+        return source;
+    }
+
+  bytes = load_func (data, error);
+  if (bytes == NULL)
+    return NULL;
+
+  source = symbolic_source_new (key, bytes);
+  g_bytes_unref (bytes);
+
+  if (key)
+    symbolic_cache_insert (source);
+
+  return source;
+}
+
+/* Loads a symbolic icon, sharing the source and the rendered
+ * textures with earlier loads of the same file.
+ */
+static GdkTexture *
+symbolic_texture_new (const char        *key,
+                      SymbolicLoadFunc   load_func,
+                      gconstpointer      data,
+                      int                width,
+                      int                height,
+                      double             scale,
+                      gboolean          *only_fg,
+                      GError           **error)
+{
+  SymbolicSource *source;
   GdkPixbuf *pixbuf;
+  GdkTexture *texture;
+  char *texture_key = NULL;
+
+  if (key)
+    {
+      /* The size is 0 when the icon is loaded at its own size */
+      texture_key = g_strdup_printf ("symbolic:%s@%g", key, width == 0 || height == 0 ? scale : 1.0);
+      texture = gdk_texture_cache_lookup (texture_key, width, height);
+      if (texture)
+        {
+          *only_fg = GPOINTER_TO_INT (g_object_get_qdata (G_OBJECT (texture), only_fg_quark ()));
+          g_free (texture_key);
+          return texture;
+        }
+    }
+
+  source = symbolic_source_get (key, load_func, data, error);
+  if (source == NULL)
+    {
+      g_free (texture_key);
+      return NULL;
+    }
+
+  pixbuf = symbolic_source_render (source, width, height, scale, NULL, error);
+  symbolic_source_unref (source);
+
+  if (pixbuf == NULL)
+    {
+      g_free (texture_key);
+      return NULL;
+    }
 
-  if (!g_file_load_contents (file, NULL, &data, &size, NULL, error))
+  *only_fg = pixbuf_is_only_fg (pixbuf);
+  texture = gdk_texture_new_for_pixbuf (pixbuf);
+  g_object_unref (pixbuf);
+
+  if (texture_key)
+    {
+      g_object_set_qdata (G_OBJECT (texture), only_fg_quark (), GINT_TO_POINTER (*only_fg));
+      gdk_texture_cache_insert (texture_key, width, height, texture);
+      g_free (texture_key);
+    }
+
+  return texture;
+}
+
+static GtkSymbolicPaths *
+symbolic_paths_new (const char       *key,
+                    SymbolicLoadFunc  load_func,
+                    gconstpointer     data)
+{
+  SymbolicSource *source;
+  GtkSymbolicPaths *paths;
+
+  if (!gtk_symbolic_paths_enabled ())
     return NULL;
 
-  pixbuf = gtk_make_symbolic_pixbuf_from_data (data, size, width, height, scale, NULL, error);
+  source = symbolic_source_get (key, load_func, data, NULL);
+  if (source == NULL)
+    return NULL;
 
-  g_free (data);
+  paths = symbolic_source_get_paths (source);
+  if (paths)
+    gtk_symbolic_paths_ref (paths);
 
-  return pixbuf;
+  symbolic_source_unref (source);
+
+  return paths;
 }
 
 /* }}} */
@@ -699,16 +987,18 @@ gdk_texture_new_from_filename_symbolic (const char    *filename,
                                         gboolean      *only_fg,
                                         GError       **error)
 {
-  GdkPixbuf *pixbuf;
-  GdkTexture *texture = NULL;
+  GdkTexture *texture;
+  GFile *file;
+  char *key;
 
-  pixbuf = make_symbolic_pixbuf_from_filename (filename, width, height, scale, error);
-  if (pixbuf)
-    {
-      *only_fg = pixbuf_is_only_fg (pixbuf);
-      texture = gdk_texture_new_for_pixbuf (pixbuf);
-      g_object_unref (pixbuf);
-    }
+  file = g_file_new_for_path (filename);
+  key = gdk_texture_cache_get_file_key (file);
+  g_object_unref (file);
+
+  texture = symbolic_texture_new (key, load_symbolic_filename, filename,
+                                  width, height, scale, only_fg, error);
+
+  g_free (key);
 
   return texture;
 }
@@ -727,16 +1017,15 @@ gdk_texture_new_from_resource_symbolic (const char  *path,
                                         gboolean    *only_fg,
                                         GError     **error)
 {
-  GdkPixbuf *pixbuf;
-  GdkTexture *texture = NULL;
+  GdkTexture *texture;
+  char *key;
 
-  pixbuf = make_symbolic_pixbuf_from_resource (path, width, height, scale, error);
-  if (pixbuf)
-    {
-      *only_fg = pixbuf_is_only_fg (pixbuf);
-      texture = gdk_texture_new_for_pixbuf (pixbuf);
-      g_object_unref (pixbuf);
-    }
+  key = gdk_texture_cache_get_resource_key (path);
+
+  texture = symbolic_texture_new (key, load_symbolic_resource, path,
+                                  width, height, scale, only_fg, error);
+
+  g_free (key);
 
   return texture;
 }
@@ -771,20 +1060,62 @@ gdk_texture_new_from_file_symbolic (GFile       *file,
                                     gboolean    *only_fg,
                                     GError     **error)
 {
-  GdkPixbuf *pixbuf;
-  GdkTexture *texture = NULL;
+  GdkTexture *texture;
+  char *key;
 
-  pixbuf = make_symbolic_pixbuf_from_file (file, width, height, scale, error);
-  if (pixbuf)
-    {
-      *only_fg = pixbuf_is_only_fg (pixbuf);
-      texture = gdk_texture_new_for_pixbuf (pixbuf);
-      g_object_unref (pixbuf);
-    }
+  key = gdk_texture_cache_get_file_key (file);
+
+  texture = symbolic_texture_new (key, load_symbolic_file, file,
+                                  width, height, scale, only_fg, error);
+
+  g_free (key);
 
   return texture;
 }
 
+/*
+ * gtk_load_symbolic_paths_from_filename:
+ * @filename: the file of a symbolic icon
+ *
+ * Loads a symbolic icon as paths, parsing the file only
+ * once for all sizes it is used at.
+ *
+ * Returns: (nullable): the paths, or %NULL if the icon
+ *   can't be loaded or drawn as paths
+ */
+GtkSymbolicPaths *
+gtk_load_symbolic_paths_from_filename (const char *filename)
+{
+  GtkSymbolicPaths *paths;
+  GFile *file;
+  char *key;
+
+  file = g_file_new_for_path (filename);
+  key = gdk_texture_cache_get_file_key (file);
+  g_object_unref (file);
+
+  paths = symbolic_paths_new (key, load_symbolic_filename, filename);
+
+  g_free (key);
+
+  return paths;
+}
+
+GtkSymbolicPaths *
+gtk_load_symbolic_paths_from_resource (const char *path)
+{
+  GtkSymbolicPaths *paths;
+  char *key;
+
+  key = gdk_texture_cache_get_resource_key (path);
+
+  paths = symbolic_paths_new (key, load_symbolic_resource, path);
+
+  g_free (key);
+
+  return paths;
+}
+
 /* }}} */
 /* {{{ Scaled paintable API */
 
@@ -814,9 +1145,24 @@ on_loader_size_prepared (GdkPixbufLoader *loader,
                               height * loader_data->scale);
 }
 
+/* Only the formats that GDK loads itself are shared via the texture
+ * cache, since they don't depend on the scale. Scalable formats don't
+ * produce textures at scales other than 1.
+ */
+static GdkPaintable *
+gdk_paintable_lookup_cached (const char *cache_key)
+{
+  if (cache_key == NULL)
+    return NULL;
+
+  return GDK_PAINTABLE (gdk_texture_cache_lookup (cache_key, -1, -1));
+}
+
 static GdkPaintable *
-gdk_paintable_new_from_bytes_scaled (GBytes *bytes,
-                                     double  scale)
+gdk_paintable_new_from_bytes_scaled (GBytes      *bytes,
+                                     double       scale,
+                                     const char  *cache_key,
+                                     GError     **error)
 {
   LoaderData loader_data;
   GdkTexture *texture;
@@ -826,10 +1172,13 @@ gdk_paintable_new_from_bytes_scaled (GBytes *bytes,
 
   if (gdk_texture_can_load (bytes))
     {
-      texture = gdk_texture_new_from_bytes (bytes, NULL);
+      texture = gdk_texture_new_from_bytes (bytes, error);
       if (texture == NULL)
         return NULL;
 
+      if (cache_key)
+        gdk_texture_cache_insert (cache_key, -1, -1, texture);
+
       /* We know these formats can't be scaled */
       paintable = GDK_PAINTABLE (texture);
     }
@@ -842,12 +1191,15 @@ gdk_paintable_new_from_bytes_scaled (GBytes *bytes,
       g_signal_connect (loader, "size-prepared",
                         G_CALLBACK (on_loader_size_prepared), &loader_data);
 
-      success = gdk_pixbuf_loader_write_bytes (loader, bytes, NULL);
+      success = gdk_pixbuf_loader_write_bytes (loader, bytes, error);
       /* close even when writing failed */
-      success &= gdk_pixbuf_loader_close (loader, NULL);
+      success &= gdk_pixbuf_loader_close (loader, success ? error : NULL);
 
       if (!success)
-        return NULL;
+        {
+          g_object_unref (loader);
+          return NULL;
+        }
 
       texture = gdk_texture_new_for_pixbuf (gdk_pixbuf_loader_get_pixbuf (loader));
       g_object_unref (loader);
@@ -867,19 +1219,14 @@ GdkPaintable *
 gdk_paintable_new_from_filename_scaled (const char *filename,
                                         double      scale)
 {
-  char *contents;
-  gsize length;
-  GBytes *bytes;
+  GFile *file;
   GdkPaintable *paintable;
 
-  if (!g_file_get_contents (filename, &contents, &length, NULL))
-    return NULL;
-
-  bytes = g_bytes_new_take (contents, length);
+  file = g_file_new_for_path (filename);
 
-  paintable = gdk_paintable_new_from_bytes_scaled (bytes, scale);
+  paintable = gdk_paintable_new_from_file_scaled (file, scale);
 
-  g_bytes_unref (bytes);
+  g_object_unref (file);
 
   return paintable;
 }
@@ -890,14 +1237,24 @@ gdk_paintable_new_from_resource_scaled (const char *path,
 {
   GBytes *bytes;
   GdkPaintable *paintable;
+  char *key;
 
-  bytes = g_resources_lookup_data (path, G_RESOURCE_LOOKUP_FLAGS_NONE, NULL);
-  if (!bytes)
-    return NULL;
+  key = gdk_texture_cache_get_resource_key (path);
+  paintable = gdk_paintable_lookup_cached (key);
+  if (paintable)
+    {
+      g_free (key);
+      return paintable;
+    }
 
-  paintable = gdk_paintable_new_from_bytes_scaled (bytes, scale);
+  bytes = g_resources_lookup_data (path, G_RESOURCE_LOOKUP_FLAGS_NONE, NULL);
+  if (bytes)
+    {
+      paintable = gdk_paintable_new_from_bytes_scaled (bytes, scale, key, NULL);
+      g_bytes_unref (bytes);
+    }
 
-  g_bytes_unref (bytes);
+  g_free (key);
 
   return paintable;
 }
@@ -908,14 +1265,71 @@ gdk_paintable_new_from_file_scaled (GFile  *file,
 {
   GBytes *bytes;
   GdkPaintable *paintable;
+  char *key;
+
+  key = gdk_texture_cache_get_file_key (file);
+  paintable = gdk_paintable_lookup_cached (key);
+  if (paintable)
+    {
+      g_free (key);
+      return paintable;
+    }
 
   bytes = g_file_load_bytes (file, NULL, NULL, NULL);
-  if (!bytes)
-    return NULL;
+  if (bytes)
+    {
+      paintable = gdk_paintable_new_from_bytes_scaled (bytes, scale, key, NULL);
+      g_bytes_unref (bytes);
+    }
 
-  paintable = gdk_paintable_new_from_bytes_scaled (bytes, scale);
+  g_free (key);
 
-  g_bytes_unref (bytes);
+  return paintable;
+}
+
+/*
+ * gdk_paintable_load_file_scaled:
+ * @file: the file to load
+ * @width: ignored
+ * @height: ignored
+ * @scale: the scale to load scalable images at
+ * @cancellable: (nullable): a `GCancellable`
+ * @error: return location for an error
+ *
+ * Loads @file like gdk_paintable_new_from_file_scaled() does,
+ * with a `GdkDecodeFunc` signature, so that widgets can use it
+ * with the decode scheduler.
+ *
+ * Returns: (transfer full) (nullable): the paintable
+ */
+GdkPaintable *
+gdk_paintable_load_file_scaled (GFile         *file,
+                                int            width,
+                                int            height,
+                                double         scale,
+                                GCancellable  *cancellable,
+                                GError       **error)
+{
+  GBytes *bytes;
+  GdkPaintable *paintable;
+  char *key;
+
+  key = gdk_texture_cache_get_file_key (file);
+  paintable = gdk_paintable_lookup_cached (key);
+  if (paintable)
+    {
+      g_free (key);
+      return paintable;
+    }
+
+  bytes = g_file_load_bytes (file, cancellable, NULL, error);
+  if (bytes)
+    {
+      paintable = gdk_paintable_new_from_bytes_scaled (bytes, scale, key, error);
+      g_bytes_unref (bytes);
+    }
+
+  g_free (key);
 
   return paintable;
 }
@@ -18,9 +18,20 @@
 #pragma once
 
 #include <gdk/gdk.h>
+#include "gtksymbolicpathsprivate.h"
 
 G_BEGIN_DECLS
 
+typedef struct _GtkSymbolicCacheStats GtkSymbolicCacheStats;
+
+struct _GtkSymbolicCacheStats
+{
+  guint   n_entries;
+  guint   max_entries;
+  guint64 n_hits;
+  guint64 n_misses;
+};
+
 GdkPixbuf *gtk_make_symbolic_pixbuf_from_data       (const char    *data,
                                                      gsize          len,
                                                      int            width,
@@ -71,14 +82,26 @@ GdkTexture *gdk_texture_new_from_resource_symbolic  (const char    *path,
                                                      gboolean      *only_fg,
                                                      GError       **error);
 
+void        gtk_symbolic_cache_clear                (void);
+void        gtk_symbolic_cache_get_stats            (GtkSymbolicCacheStats *stats);
+
 GdkTexture *gtk_load_symbolic_texture_from_file     (GFile         *file);
 GdkTexture *gtk_load_symbolic_texture_from_resource (const char    *path);
 
+GtkSymbolicPaths *gtk_load_symbolic_paths_from_filename (const char *filename);
+GtkSymbolicPaths *gtk_load_symbolic_paths_from_resource (const char *path);
+
 GdkPaintable *gdk_paintable_new_from_filename_scaled (const char    *filename,
                                                       double         scale);
 GdkPaintable *gdk_paintable_new_from_resource_scaled (const char    *path,
                                                       double         scale);
 GdkPaintable *gdk_paintable_new_from_file_scaled     (GFile         *file,
                                                       double         scale);
+GdkPaintable *gdk_paintable_load_file_scaled         (GFile         *file,
+                                                      int            width,
+                                                      int            height,
+                                                      double         scale,
+                                                      GCancellable  *cancellable,
+                                                      GError       **error);
 
 G_END_DECLS
@@ -479,6 +479,33 @@ gtk_accessible_text_get_offset (GtkAccessibleText      *self,
   return FALSE;
 }
 
+/*< private >
+ * gtk_accessible_text_get_character_count:
+ * @self: a `GtkAccessibleText`
+ *
+ * Gets the number of characters in the contents of the
+ * accessible object.
+ *
+ * Returns: the number of characters
+ */
+unsigned int
+gtk_accessible_text_get_character_count (GtkAccessibleText *self)
+{
+  GBytes *contents;
+  unsigned int n_chars;
+
+  g_return_val_if_fail (GTK_IS_ACCESSIBLE_TEXT (self), 0);
+
+  if (GTK_ACCESSIBLE_TEXT_GET_IFACE (self)->get_character_count != NULL)
+    return GTK_ACCESSIBLE_TEXT_GET_IFACE (self)->get_character_count (self);
+
+  contents = gtk_accessible_text_get_contents (self, 0, G_MAXUINT);
+  n_chars = g_utf8_strlen (g_bytes_get_data (contents, NULL), -1);
+  g_bytes_unref (contents);
+
+  return n_chars;
+}
+
 /**
  * gtk_accessible_text_update_caret_position:
  * @self: the accessible object
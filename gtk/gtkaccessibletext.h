@@ -290,6 +290,22 @@ struct _GtkAccessibleTextInterface
   gboolean (* get_offset) (GtkAccessibleText      *self,
                            const graphene_point_t *point,
                            unsigned int           *offset);
+
+  /**
+   * GtkAccessibleTextInterface::get_character_count:
+   * @self: the accessible object
+   *
+   * Gets the number of characters in the text of the accessible
+   * object.
+   *
+   * Implementations only need to provide this if they can count
+   * the characters without retrieving the whole contents.
+   *
+   * Returns: the number of characters
+   *
+   * Since: 4.16
+   */
+  unsigned int (* get_character_count) (GtkAccessibleText *self);
 };
 
 GDK_AVAILABLE_IN_4_14
@@ -63,4 +63,7 @@ gtk_accessible_text_get_offset (GtkAccessibleText      *self,
                                 const graphene_point_t *point,
                                 unsigned int           *offset);
 
+unsigned int
+gtk_accessible_text_get_character_count (GtkAccessibleText *self);
+
 G_END_DECLS
@@ -243,6 +243,45 @@ _gtk_allocated_bitmask_subtract (GtkBitmask       *mask,
   return gtk_allocated_bitmask_shrink (mask);
 }
 
+GtkBitmask *
+_gtk_allocated_bitmask_xor (GtkBitmask       *mask,
+                            const GtkBitmask *other)
+{
+  GtkBitmask other_allocated;
+  guint i;
+
+  gtk_internal_return_val_if_fail (mask != NULL, NULL);
+  gtk_internal_return_val_if_fail (other != NULL, NULL);
+
+  mask = gtk_bitmask_ensure_allocated (mask);
+  ENSURE_ALLOCATED (other, other_allocated);
+
+  if (other->len > mask->len)
+    mask = gtk_allocated_bitmask_resize (mask, other->len);
+  for (i = 0; i < other->len; i++)
+    {
+      mask->data[i] ^= other->data[i];
+    }
+
+  return gtk_allocated_bitmask_shrink (mask);
+}
+
+void
+_gtk_allocated_bitmask_xor_into (const GtkBitmask *mask,
+                                 gsize            *bits,
+                                 gsize             n_words)
+{
+  gsize i;
+
+  gtk_internal_return_if_fail (mask != NULL);
+  gtk_internal_return_if_fail (_gtk_bitmask_is_allocated (mask));
+
+  for (i = 0; i < MIN (mask->len, n_words); i++)
+    {
+      bits[i] ^= mask->data[i];
+    }
+}
+
 static inline void
 gtk_allocated_bitmask_indexes (guint index_,
                                guint *array_index,
@@ -51,6 +51,11 @@ GtkBitmask *   _gtk_allocated_bitmask_union             (GtkBitmask        *mask
                                                          const GtkBitmask  *other) G_GNUC_WARN_UNUSED_RESULT;
 GtkBitmask *   _gtk_allocated_bitmask_subtract          (GtkBitmask        *mask,
                                                          const GtkBitmask  *other) G_GNUC_WARN_UNUSED_RESULT;
+GtkBitmask *   _gtk_allocated_bitmask_xor               (GtkBitmask        *mask,
+                                                         const GtkBitmask  *other) G_GNUC_WARN_UNUSED_RESULT;
+void           _gtk_allocated_bitmask_xor_into          (const GtkBitmask  *mask,
+                                                         gsize             *bits,
+                                                         gsize              n_words);
 
 gboolean       _gtk_allocated_bitmask_get               (const GtkBitmask  *mask,
                                                          guint              index_);
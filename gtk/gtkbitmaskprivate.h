@@ -38,6 +38,11 @@ static inline GtkBitmask *      _gtk_bitmask_union                (GtkBitmask
                                                                    const GtkBitmask  *other) G_GNUC_WARN_UNUSED_RESULT;
 static inline GtkBitmask *      _gtk_bitmask_subtract             (GtkBitmask        *mask,
                                                                    const GtkBitmask  *other) G_GNUC_WARN_UNUSED_RESULT;
+static inline GtkBitmask *      _gtk_bitmask_xor                  (GtkBitmask        *mask,
+                                                                   const GtkBitmask  *other) G_GNUC_WARN_UNUSED_RESULT;
+static inline void              _gtk_bitmask_xor_into             (const GtkBitmask  *mask,
+                                                                   gsize             *bits,
+                                                                   gsize              n_words);
 
 static inline gboolean          _gtk_bitmask_get                  (const GtkBitmask  *mask,
                                                                    guint              index_);
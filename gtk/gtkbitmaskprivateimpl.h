@@ -84,6 +84,34 @@ _gtk_bitmask_subtract (GtkBitmask       *mask,
   return _gtk_allocated_bitmask_subtract (mask, other);
 }
 
+static inline GtkBitmask *
+_gtk_bitmask_xor (GtkBitmask       *mask,
+                  const GtkBitmask *other)
+{
+  if (_gtk_bitmask_is_allocated (mask) ||
+      _gtk_bitmask_is_allocated (other))
+    return _gtk_allocated_bitmask_xor (mask, other);
+  else
+    return _gtk_bitmask_from_bits (_gtk_bitmask_to_bits (mask)
+                                   ^ _gtk_bitmask_to_bits (other));
+}
+
+/* Flips the bits that are set in @mask in the @n_words long array
+ * @bits, with bit n in bits[n / (8 * sizeof (gsize))]. Bits past the
+ * end of the array are ignored. This never allocates, so it can be
+ * used to combine many masks into a preallocated one.
+ */
+static inline void
+_gtk_bitmask_xor_into (const GtkBitmask *mask,
+                       gsize            *bits,
+                       gsize             n_words)
+{
+  if (_gtk_bitmask_is_allocated (mask))
+    _gtk_allocated_bitmask_xor_into (mask, bits, n_words);
+  else if (n_words > 0)
+    bits[0] ^= _gtk_bitmask_to_bits (mask);
+}
+
 static inline gboolean
 _gtk_bitmask_get (const GtkBitmask *mask,
                   guint             index_)
@@ -219,7 +219,9 @@ enum
 {
   PROP_0,
   PROP_COLUMNS,
+  PROP_DEFERRED_BINDING,
   PROP_ENABLE_RUBBERBAND,
+  PROP_FIXED_HEIGHT_MODE,
   PROP_HADJUSTMENT,
   PROP_HEADER_FACTORY,
   PROP_HSCROLL_POLICY,
@@ -623,10 +625,18 @@ gtk_column_view_get_property (GObject    *object,
       g_value_set_object (value, self->columns);
       break;
 
+    case PROP_DEFERRED_BINDING:
+      g_value_set_boolean (value, gtk_list_view_get_deferred_binding (self->listview));
+      break;
+
     case PROP_ENABLE_RUBBERBAND:
       g_value_set_boolean (value, gtk_column_view_get_enable_rubberband (self));
       break;
 
+    case PROP_FIXED_HEIGHT_MODE:
+      g_value_set_boolean (value, gtk_list_view_get_fixed_height_mode (self->listview));
+      break;
+
     case PROP_HADJUSTMENT:
       g_value_set_object (value, self->hadjustment);
       break;
@@ -696,10 +706,18 @@ gtk_column_view_set_property (GObject      *object,
 
   switch (property_id)
     {
+    case PROP_DEFERRED_BINDING:
+      gtk_column_view_set_deferred_binding (self, g_value_get_boolean (value));
+      break;
+
     case PROP_ENABLE_RUBBERBAND:
       gtk_column_view_set_enable_rubberband (self, g_value_get_boolean (value));
       break;
 
+    case PROP_FIXED_HEIGHT_MODE:
+      gtk_column_view_set_fixed_height_mode (self, g_value_get_boolean (value));
+      break;
+
     case PROP_HADJUSTMENT:
       adjustment = g_value_get_object (value);
       if (adjustment == NULL)
@@ -836,6 +854,30 @@ gtk_column_view_class_init (GtkColumnViewClass *klass)
                           FALSE,
                           G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkColumnView:deferred-binding: (attributes org.gtk.Property.get=gtk_column_view_get_deferred_binding org.gtk.Property.set=gtk_column_view_set_deferred_binding)
+   *
+   * Bind items to newly visible rows in the background.
+   *
+   * Since: 4.16
+   */
+  properties[PROP_DEFERRED_BINDING] =
+    g_param_spec_boolean ("deferred-binding", NULL, NULL,
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GtkColumnView:fixed-height-mode: (attributes org.gtk.Property.get=gtk_column_view_get_fixed_height_mode org.gtk.Property.set=gtk_column_view_set_fixed_height_mode)
+   *
+   * Assume that all rows have the same height.
+   *
+   * Since: 4.16
+   */
+  properties[PROP_FIXED_HEIGHT_MODE] =
+    g_param_spec_boolean ("fixed-height-mode", NULL, NULL,
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
   /**
    * GtkColumnView:model: (attributes org.gtk.Property.get=gtk_column_view_get_model org.gtk.Property.set=gtk_column_view_set_model)
    *
@@ -2139,6 +2181,92 @@ gtk_column_view_get_tab_behavior (GtkColumnView *self)
   return gtk_list_view_get_tab_behavior (self->listview);
 }
 
+/**
+ * gtk_column_view_set_fixed_height_mode: (attributes org.gtk.Method.set_property=fixed-height-mode)
+ * @self: a `GtkColumnView`
+ * @fixed_height_mode: %TRUE to enable fixed height mode
+ *
+ * Sets whether all rows of @self are assumed to have the same height.
+ *
+ * See [method@Gtk.ListView.set_fixed_height_mode] for details.
+ *
+ * Since: 4.16
+ */
+void
+gtk_column_view_set_fixed_height_mode (GtkColumnView *self,
+                                       gboolean       fixed_height_mode)
+{
+  g_return_if_fail (GTK_IS_COLUMN_VIEW (self));
+
+  if (fixed_height_mode == gtk_list_view_get_fixed_height_mode (self->listview))
+    return;
+
+  gtk_list_view_set_fixed_height_mode (self->listview, fixed_height_mode);
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_FIXED_HEIGHT_MODE]);
+}
+
+/**
+ * gtk_column_view_get_fixed_height_mode: (attributes org.gtk.Method.get_property=fixed-height-mode)
+ * @self: a `GtkColumnView`
+ *
+ * Returns whether all rows are assumed to have the same height.
+ *
+ * Returns: %TRUE if fixed height mode is enabled
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_column_view_get_fixed_height_mode (GtkColumnView *self)
+{
+  g_return_val_if_fail (GTK_IS_COLUMN_VIEW (self), FALSE);
+
+  return gtk_list_view_get_fixed_height_mode (self->listview);
+}
+
+/**
+ * gtk_column_view_set_deferred_binding: (attributes org.gtk.Method.set_property=deferred-binding)
+ * @self: a `GtkColumnView`
+ * @deferred_binding: %TRUE to bind items in the background
+ *
+ * Sets whether items are bound to newly visible rows in the background.
+ *
+ * See [method@Gtk.ListView.set_deferred_binding] for details.
+ *
+ * Since: 4.16
+ */
+void
+gtk_column_view_set_deferred_binding (GtkColumnView *self,
+                                      gboolean       deferred_binding)
+{
+  g_return_if_fail (GTK_IS_COLUMN_VIEW (self));
+
+  if (deferred_binding == gtk_list_view_get_deferred_binding (self->listview))
+    return;
+
+  gtk_list_view_set_deferred_binding (self->listview, deferred_binding);
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_DEFERRED_BINDING]);
+}
+
+/**
+ * gtk_column_view_get_deferred_binding: (attributes org.gtk.Method.get_property=deferred-binding)
+ * @self: a `GtkColumnView`
+ *
+ * Returns whether items are bound to newly visible rows in the background.
+ *
+ * Returns: %TRUE if binding is deferred
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_column_view_get_deferred_binding (GtkColumnView *self)
+{
+  g_return_val_if_fail (GTK_IS_COLUMN_VIEW (self), FALSE);
+
+  return gtk_list_view_get_deferred_binding (self->listview);
+}
+
 /**
  * gtk_column_view_get_header_factory: (attributes org.gtk.Method.get_property=header-factory)
  * @self: a `GtkColumnView`
@@ -129,6 +129,18 @@ GDK_AVAILABLE_IN_4_12
 GtkListItemFactory *
                 gtk_column_view_get_header_factory              (GtkColumnView          *self);
 
+GDK_AVAILABLE_IN_4_16
+void            gtk_column_view_set_fixed_height_mode           (GtkColumnView          *self,
+                                                                 gboolean                fixed_height_mode);
+GDK_AVAILABLE_IN_4_16
+gboolean        gtk_column_view_get_fixed_height_mode           (GtkColumnView          *self);
+
+GDK_AVAILABLE_IN_4_16
+void            gtk_column_view_set_deferred_binding            (GtkColumnView          *self,
+                                                                 gboolean                deferred_binding);
+GDK_AVAILABLE_IN_4_16
+gboolean        gtk_column_view_get_deferred_binding            (GtkColumnView          *self);
+
 GDK_AVAILABLE_IN_4_12
 void            gtk_column_view_scroll_to                       (GtkColumnView          *self,
                                                                  guint                   pos,
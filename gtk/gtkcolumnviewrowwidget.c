@@ -104,6 +104,26 @@ gtk_column_view_row_widget_update (GtkListItemBase *base,
     }
 }
 
+static void
+gtk_column_view_row_widget_placeholder (GtkListItemBase *base)
+{
+  GtkColumnViewRowWidget *self = GTK_COLUMN_VIEW_ROW_WIDGET (base);
+  GtkWidget *child;
+
+  if (gtk_column_view_row_widget_is_header (self))
+    return;
+
+  GTK_LIST_ITEM_BASE_CLASS (gtk_column_view_row_widget_parent_class)->placeholder (base);
+
+  /* The cells were updated along with the row */
+  for (child = gtk_widget_get_first_child (GTK_WIDGET (self));
+       child;
+       child = gtk_widget_get_next_sibling (child))
+    {
+      GTK_LIST_ITEM_BASE_GET_CLASS (child)->placeholder (GTK_LIST_ITEM_BASE (child));
+    }
+}
+
 static gpointer
 gtk_column_view_row_widget_create_object (GtkListFactoryWidget *fw)
 {
@@ -517,6 +537,7 @@ gtk_column_view_row_widget_class_init (GtkColumnViewRowWidgetClass *klass)
   factory_class->teardown_object = gtk_column_view_row_widget_teardown_object;
 
   base_class->update = gtk_column_view_row_widget_update;
+  base_class->placeholder = gtk_column_view_row_widget_placeholder;
 
   widget_class->focus = gtk_column_view_row_widget_focus;
   widget_class->grab_focus = gtk_column_view_row_widget_grab_focus;
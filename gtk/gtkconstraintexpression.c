@@ -626,10 +626,8 @@ gtk_constraint_variable_pair_free (GtkConstraintVariablePair *pair)
 
 /*< private >
  * Term:
- * @variable: a `GtkConstraintVariable`
+ * @variable: a `GtkConstraintVariable`, or %NULL for a removed term
  * @coefficient: the coefficient applied to the @variable
- * @next: the next term in the expression
- * @prev: the previous term in the expression;
  *
  * A tuple of (@variable, @coefficient) in an equation.
  *
@@ -640,55 +638,107 @@ typedef struct _Term Term;
 struct _Term {
   GtkConstraintVariable *variable;
   double coefficient;
+};
+
+/* Rows with more terms than this get an index from variables
+ * to terms; below it, a linear scan of the array is faster
+ */
+#define TERMS_INDEX_THRESHOLD 16
+
+struct _GtkConstraintExpression
+{
+  double constant;
+
+  /* Array of terms, in insertion order; NULL for a constant
+   * expression. Removing a term leaves a hole, with a NULL
+   * variable, that gets compacted away once holes make up
+   * half of the array
+   */
+  Term *terms;
+  guint n_slots;
+  guint n_terms;
+  guint size;
+
+  /* HashTable<Variable, position + 1>; only used for long rows */
+  GHashTable *index;
 
-  Term *next;
-  Term *prev;
+  /* Used by GtkConstraintExpressionIter to guard against changes
+   * in the expression while iterating
+   */
+  gint64 age;
 };
 
-static Term *
-term_new (GtkConstraintVariable *variable,
-          double coefficient)
+static gssize
+gtk_constraint_expression_find_term (const GtkConstraintExpression *self,
+                                     GtkConstraintVariable         *variable)
 {
-  Term *res = g_new (Term, 1);
+  guint i;
 
-  res->variable = gtk_constraint_variable_ref (variable);
-  res->coefficient = coefficient;
-  res->next = res->prev = NULL;
+  if (self->index != NULL)
+    return (gssize) GPOINTER_TO_UINT (g_hash_table_lookup (self->index, variable)) - 1;
 
-  return res;
+  for (i = 0; i < self->n_slots; i++)
+    {
+      if (self->terms[i].variable == variable)
+        return i;
+    }
+
+  return -1;
 }
 
-static void
-term_free (gpointer data)
+static inline Term *
+gtk_constraint_expression_lookup_term (const GtkConstraintExpression *self,
+                                       GtkConstraintVariable         *variable)
 {
-  Term *term = data;
+  gssize pos;
 
-  if (term == NULL)
-    return;
+  if (self->terms == NULL)
+    return NULL;
 
-  gtk_constraint_variable_unref (term->variable);
+  pos = gtk_constraint_expression_find_term (self, variable);
+  if (pos < 0)
+    return NULL;
 
-  g_free (term);
+  return &self->terms[pos];
 }
 
-struct _GtkConstraintExpression
+static void
+gtk_constraint_expression_compact_terms (GtkConstraintExpression *self)
 {
-  double constant;
+  guint i, j;
 
-  /* HashTable<Variable, Term>; the key is the term's variable,
-   * and the value is owned by the hash table
-   */
-  GHashTable *terms;
+  for (i = 0, j = 0; i < self->n_slots; i++)
+    {
+      if (self->terms[i].variable == NULL)
+        continue;
 
-  /* List of terms, in insertion order */
-  Term *first_term;
-  Term *last_term;
+      if (i != j)
+        {
+          self->terms[j] = self->terms[i];
 
-  /* Used by GtkConstraintExpressionIter to guard against changes
-   * in the expression while iterating
-   */
-  gint64 age;
-};
+          if (self->index != NULL)
+            g_hash_table_insert (self->index, self->terms[j].variable, GUINT_TO_POINTER (j + 1));
+        }
+
+      j += 1;
+    }
+
+  self->n_slots = j;
+}
+
+static void
+gtk_constraint_expression_build_index (GtkConstraintExpression *self)
+{
+  guint i;
+
+  self->index = g_hash_table_new (NULL, NULL);
+
+  for (i = 0; i < self->n_slots; i++)
+    {
+      if (self->terms[i].variable != NULL)
+        g_hash_table_insert (self->index, self->terms[i].variable, GUINT_TO_POINTER (i + 1));
+    }
+}
 
 /*< private >
  * gtk_constraint_expression_add_term:
@@ -708,27 +758,31 @@ gtk_constraint_expression_add_term (GtkConstraintExpression *self,
 {
   Term *term;
 
-  if (self->terms == NULL)
+  if (self->n_slots == self->size)
     {
-      g_assert (self->first_term == NULL && self->last_term == NULL);
-      self->terms = g_hash_table_new_full (NULL, NULL,
-                                           NULL,
-                                           term_free);
+      if (self->n_terms < self->n_slots)
+        {
+          gtk_constraint_expression_compact_terms (self);
+        }
+      else
+        {
+          self->size = MAX (4, self->size * 2);
+          self->terms = g_renew (Term, self->terms, self->size);
+        }
     }
 
-  term = term_new (variable, coefficient);
+  term = &self->terms[self->n_slots];
+  term->variable = gtk_constraint_variable_ref (variable);
+  term->coefficient = coefficient;
 
-  g_hash_table_insert (self->terms, term->variable, term);
+  if (self->index != NULL)
+    g_hash_table_insert (self->index, variable, GUINT_TO_POINTER (self->n_slots + 1));
 
-  if (self->first_term == NULL)
-    self->first_term = term;
+  self->n_slots += 1;
+  self->n_terms += 1;
 
-  term->prev = self->last_term;
-
-  if (self->last_term != NULL)
-    self->last_term->next = term;
-
-  self->last_term = term;
+  if (self->index == NULL && self->n_terms > TERMS_INDEX_THRESHOLD)
+    gtk_constraint_expression_build_index (self);
 
   /* Increase the age of the expression, so that we can catch
    * mutations from within an iteration over the terms
@@ -740,46 +794,34 @@ static void
 gtk_constraint_expression_remove_term (GtkConstraintExpression *self,
                                        GtkConstraintVariable *variable)
 {
-  Term *term, *iter;
+  gssize pos;
 
   if (self->terms == NULL)
     return;
 
-  term = g_hash_table_lookup (self->terms, variable);
-  if (term == NULL)
+  pos = gtk_constraint_expression_find_term (self, variable);
+  if (pos < 0)
     return;
 
   /* Keep the variable alive for the duration of the function */
   gtk_constraint_variable_ref (variable);
 
-  iter = self->first_term;
-  while (iter != NULL)
-    {
-      Term *next = iter->next;
-      Term *prev = iter->prev;
-
-      if (iter == term)
-        {
-          if (prev != NULL)
-            prev->next = next;
-          if (next != NULL)
-            next->prev = prev;
-
-          if (iter == self->first_term)
-            self->first_term = next;
-          if (iter == self->last_term)
-            self->last_term = prev;
+  self->terms[pos].variable = NULL;
+  gtk_constraint_variable_unref (variable);
 
-          iter->next = NULL;
-          iter->prev = NULL;
+  if (self->index != NULL)
+    g_hash_table_remove (self->index, variable);
 
-          break;
-        }
+  self->n_terms -= 1;
 
-      iter = next;
-    }
+  /* Trailing holes can go right away; the others once they
+   * take up half of the array
+   */
+  while (self->n_slots > 0 && self->terms[self->n_slots - 1].variable == NULL)
+    self->n_slots -= 1;
 
-  g_hash_table_remove (self->terms, variable);
+  if (self->n_slots > 8 && self->n_terms < self->n_slots / 2)
+    gtk_constraint_expression_compact_terms (self);
 
   gtk_constraint_variable_unref (variable);
 
@@ -801,8 +843,10 @@ gtk_constraint_expression_new (double constant)
 
   res->age = 0;
   res->terms = NULL;
-  res->first_term = NULL;
-  res->last_term = NULL;
+  res->n_slots = 0;
+  res->n_terms = 0;
+  res->size = 0;
+  res->index = NULL;
   res->constant = constant;
 
   return res;
@@ -847,13 +891,22 @@ static void
 gtk_constraint_expression_clear (gpointer data)
 {
   GtkConstraintExpression *self = data;
+  guint i;
+
+  for (i = 0; i < self->n_slots; i++)
+    {
+      if (self->terms[i].variable != NULL)
+        gtk_constraint_variable_unref (self->terms[i].variable);
+    }
 
-  g_clear_pointer (&self->terms, g_hash_table_unref);
+  g_clear_pointer (&self->terms, g_free);
+  g_clear_pointer (&self->index, g_hash_table_unref);
 
   self->age = 0;
   self->constant = 0.0;
-  self->first_term = NULL;
-  self->last_term = NULL;
+  self->n_slots = 0;
+  self->n_terms = 0;
+  self->size = 0;
 }
 
 /*< private >
@@ -918,16 +971,16 @@ GtkConstraintExpression *
 gtk_constraint_expression_clone (GtkConstraintExpression *expression)
 {
   GtkConstraintExpression *res;
-  Term *iter;
+  guint i;
 
   res = gtk_constraint_expression_new (expression->constant);
 
-  iter = expression->first_term;
-  while (iter != NULL)
+  for (i = 0; i < expression->n_slots; i++)
     {
-      gtk_constraint_expression_add_term (res, iter->variable, iter->coefficient);
+      const Term *t = &expression->terms[i];
 
-      iter = iter->next;
+      if (t->variable != NULL)
+        gtk_constraint_expression_add_term (res, t->variable, t->coefficient);
     }
 
   return res;
@@ -962,7 +1015,7 @@ gtk_constraint_expression_add_variable (GtkConstraintExpression *expression,
   /* If the expression already contains the variable, update the coefficient */
   if (expression->terms != NULL)
     {
-      Term *t = g_hash_table_lookup (expression->terms, variable);
+      Term *t = gtk_constraint_expression_lookup_term (expression, variable);
 
       if (t != NULL)
         {
@@ -1029,15 +1082,12 @@ gtk_constraint_expression_set_variable (GtkConstraintExpression *expression,
                                         GtkConstraintVariable *variable,
                                         double coefficient)
 {
-  if (expression->terms != NULL)
-    {
-      Term *t = g_hash_table_lookup (expression->terms, variable);
+  Term *t = gtk_constraint_expression_lookup_term (expression, variable);
 
-      if (t != NULL)
-        {
-          t->coefficient = coefficient;
-          return;
-        }
+  if (t != NULL)
+    {
+      t->coefficient = coefficient;
+      return;
     }
 
   gtk_constraint_expression_add_term (expression, variable, coefficient);
@@ -1076,21 +1126,21 @@ gtk_constraint_expression_add_expression (GtkConstraintExpression *a_expr,
                                           GtkConstraintVariable *subject,
                                           GtkConstraintSolver *solver)
 {
-  Term *iter;
+  guint i;
 
   a_expr->constant += (n * b_expr->constant);
 
-  iter = b_expr->last_term;
-  while (iter != NULL)
+  for (i = b_expr->n_slots; i > 0; i--)
     {
-      Term *next = iter->prev;
+      const Term *t = &b_expr->terms[i - 1];
+
+      if (t->variable == NULL)
+        continue;
 
       gtk_constraint_expression_add_variable (a_expr,
-                                              iter->variable, n * iter->coefficient,
+                                              t->variable, n * t->coefficient,
                                               subject,
                                               solver);
-
-      iter = next;
     }
 }
 
@@ -1196,21 +1246,13 @@ GtkConstraintExpression *
 gtk_constraint_expression_multiply_by (GtkConstraintExpression *expression,
                                        double factor)
 {
-  GHashTableIter iter;
-  gpointer value_p;
+  guint i;
 
   expression->constant *= factor;
 
-  if (expression->terms == NULL)
-    return expression;
-
-  g_hash_table_iter_init (&iter, expression->terms);
-  while (g_hash_table_iter_next (&iter, NULL, &value_p))
-    {
-      Term *t = value_p;
-
-      t->coefficient *= factor;
-    }
+  /* Holes get multiplied as well, which is harmless */
+  for (i = 0; i < expression->n_slots; i++)
+    expression->terms[i].coefficient *= factor;
 
   return expression;
 }
@@ -1269,7 +1311,7 @@ gtk_constraint_expression_new_subject (GtkConstraintExpression *expression,
 
   g_assert (!gtk_constraint_expression_is_constant (expression));
 
-  term = g_hash_table_lookup (expression->terms, subject);
+  term = gtk_constraint_expression_lookup_term (expression, subject);
   g_assert (term != NULL);
   g_assert (!G_APPROX_VALUE (term->coefficient, 0.0, 0.001));
 
@@ -1334,10 +1376,7 @@ gtk_constraint_expression_get_coefficient (GtkConstraintExpression *expression,
   g_return_val_if_fail (expression != NULL, 0.0);
   g_return_val_if_fail (variable != NULL, 0.0);
 
-  if (expression->terms == NULL)
-    return 0.0;
-
-  term = g_hash_table_lookup (expression->terms, variable);
+  term = gtk_constraint_expression_lookup_term (expression, variable);
   if (term == NULL)
     return 0.0;
 
@@ -1365,7 +1404,7 @@ gtk_constraint_expression_substitute_out (GtkConstraintExpression *expression,
                                           GtkConstraintSolver *solver)
 {
   double multiplier;
-  Term *iter;
+  guint i;
 
   if (expression->terms == NULL)
     return;
@@ -1375,18 +1414,19 @@ gtk_constraint_expression_substitute_out (GtkConstraintExpression *expression,
 
   expression->constant = expression->constant + multiplier * expr->constant;
 
-  iter = expr->first_term;
-  while (iter != NULL)
+  for (i = 0; i < expr->n_slots; i++)
     {
-      GtkConstraintVariable *clv = iter->variable;
-      double coeff = iter->coefficient;
-      Term *next = iter->next;
+      GtkConstraintVariable *clv = expr->terms[i].variable;
+      double coeff = expr->terms[i].coefficient;
+      Term *t;
 
-      if (expression->terms != NULL &&
-          g_hash_table_contains (expression->terms, clv))
+      if (clv == NULL)
+        continue;
+
+      t = gtk_constraint_expression_lookup_term (expression, clv);
+      if (t != NULL)
         {
-          double old_coefficient = gtk_constraint_expression_get_coefficient (expression, clv);
-          double new_coefficient = old_coefficient + multiplier * coeff;
+          double new_coefficient = t->coefficient + multiplier * coeff;
 
           if (G_APPROX_VALUE (new_coefficient, 0.0, 0.001))
             {
@@ -1396,17 +1436,15 @@ gtk_constraint_expression_substitute_out (GtkConstraintExpression *expression,
               gtk_constraint_expression_remove_term (expression, clv);
             }
           else
-            gtk_constraint_expression_set_variable (expression, clv, new_coefficient);
+            t->coefficient = new_coefficient;
         }
       else
         {
-          gtk_constraint_expression_set_variable (expression, clv, multiplier * coeff);
+          gtk_constraint_expression_add_term (expression, clv, multiplier * coeff);
 
           if (solver != NULL)
             gtk_constraint_solver_note_added_variable (solver, clv, subject);
         }
-
-      iter = next;
     }
 }
 
@@ -1422,7 +1460,7 @@ gtk_constraint_expression_substitute_out (GtkConstraintExpression *expression,
 GtkConstraintVariable *
 gtk_constraint_expression_get_pivotable_variable (GtkConstraintExpression *expression)
 {
-  Term *iter;
+  guint i;
 
   if (expression->terms == NULL)
     {
@@ -1430,15 +1468,12 @@ gtk_constraint_expression_get_pivotable_variable (GtkConstraintExpression *expre
       return NULL;
     }
 
-  iter = expression->first_term;
-  while (iter != NULL)
+  for (i = 0; i < expression->n_slots; i++)
     {
-      Term *next = iter->next;
+      GtkConstraintVariable *variable = expression->terms[i].variable;
 
-      if (gtk_constraint_variable_is_pivotable (iter->variable))
-        return iter->variable;
-
-      iter = next;
+      if (variable != NULL && gtk_constraint_variable_is_pivotable (variable))
+        return variable;
     }
 
   return NULL;
@@ -1459,7 +1494,7 @@ gtk_constraint_expression_to_string (const GtkConstraintExpression *expression)
 {
   gboolean needs_plus = FALSE;
   GString *buf;
-  Term *iter;
+  guint i;
 
   if (expression == NULL)
     return g_strdup ("<null>");
@@ -1477,26 +1512,28 @@ gtk_constraint_expression_to_string (const GtkConstraintExpression *expression)
   if (expression->terms == NULL)
     return g_string_free (buf, FALSE);
 
-  iter = expression->first_term;
-  while (iter != NULL)
+  for (i = 0; i < expression->n_slots; i++)
     {
-      char *str = gtk_constraint_variable_to_string (iter->variable);
-      Term *next = iter->next;
+      const Term *t = &expression->terms[i];
+      char *str;
+
+      if (t->variable == NULL)
+        continue;
+
+      str = gtk_constraint_variable_to_string (t->variable);
 
       if (needs_plus)
         g_string_append (buf, " + ");
 
-      if (G_APPROX_VALUE (iter->coefficient, 1.0, 0.001))
+      if (G_APPROX_VALUE (t->coefficient, 1.0, 0.001))
         g_string_append_printf (buf, "%s", str);
       else
-        g_string_append_printf (buf, "(%g * %s)", iter->coefficient, str);
+        g_string_append_printf (buf, "(%g * %s)", t->coefficient, str);
 
       g_free (str);
 
       if (!needs_plus)
         needs_plus = TRUE;
-
-      iter = next;
     }
 
   return g_string_free (buf, FALSE);
@@ -1505,7 +1542,7 @@ gtk_constraint_expression_to_string (const GtkConstraintExpression *expression)
 /* Keep in sync with GtkConstraintExpressionIter */
 typedef struct {
   GtkConstraintExpression *expression;
-  Term *current;
+  gssize current;
   gint64 age;
 } RealExpressionIter;
 
@@ -1525,7 +1562,7 @@ gtk_constraint_expression_iter_init (GtkConstraintExpressionIter *iter,
   RealExpressionIter *riter = REAL_EXPRESSION_ITER (iter);
 
   riter->expression = expression;
-  riter->current = NULL;
+  riter->current = -1;
   riter->age = expression->age;
 }
 
@@ -1548,20 +1585,25 @@ gtk_constraint_expression_iter_next (GtkConstraintExpressionIter *iter,
 {
   RealExpressionIter *riter = REAL_EXPRESSION_ITER (iter);
 
-  g_assert (riter->age == riter->expression->age);
+  const GtkConstraintExpression *expression = riter->expression;
 
-  if (riter->current == NULL)
-    riter->current = riter->expression->first_term;
-  else
-    riter->current = riter->current->next;
+  g_assert (riter->age == expression->age);
 
-  if (riter->current != NULL)
+  for (riter->current += 1; riter->current < (gssize) expression->n_slots; riter->current += 1)
     {
-      *coefficient = riter->current->coefficient;
-      *variable = riter->current->variable;
+      const Term *t = &expression->terms[riter->current];
+
+      if (t->variable != NULL)
+        {
+          *coefficient = t->coefficient;
+          *variable = t->variable;
+          return TRUE;
+        }
     }
 
-  return riter->current != NULL;
+  riter->current = -1;
+
+  return FALSE;
 }
 
 /*< private >
@@ -1583,20 +1625,26 @@ gtk_constraint_expression_iter_prev (GtkConstraintExpressionIter *iter,
 {
   RealExpressionIter *riter = REAL_EXPRESSION_ITER (iter);
 
-  g_assert (riter->age == riter->expression->age);
+  const GtkConstraintExpression *expression = riter->expression;
 
-  if (riter->current == NULL)
-    riter->current = riter->expression->last_term;
-  else
-    riter->current = riter->current->prev;
+  g_assert (riter->age == expression->age);
+
+  if (riter->current < 0)
+    riter->current = expression->n_slots;
 
-  if (riter->current != NULL)
+  for (riter->current -= 1; riter->current >= 0; riter->current -= 1)
     {
-      *coefficient = riter->current->coefficient;
-      *variable = riter->current->variable;
+      const Term *t = &expression->terms[riter->current];
+
+      if (t->variable != NULL)
+        {
+          *coefficient = t->coefficient;
+          *variable = t->variable;
+          return TRUE;
+        }
     }
 
-  return riter->current != NULL;
+  return FALSE;
 }
 
 typedef enum {
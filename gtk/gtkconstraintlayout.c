@@ -263,6 +263,18 @@ struct _GtkConstraintLayout
 
   GListStore *constraints_observer;
   GListStore *guides_observer;
+
+  /* The edit variables holding the layout at its allocation: top,
+   * left, width and height. They are kept in the solver between
+   * allocations, so that resizing the layout only needs to suggest
+   * new values and re-solve from the previous solution, instead of
+   * adding and removing constraints every time. Measuring relaxes
+   * them to a strength of 0 instead of removing them
+   */
+  GtkConstraintVariable *allocation_vars[4];
+  gboolean allocation_relaxed;
+  int allocated_width;
+  int allocated_height;
 };
 
 G_DEFINE_TYPE (GtkConstraintLayoutChild, gtk_constraint_layout_child, GTK_TYPE_LAYOUT_CHILD)
@@ -543,6 +555,10 @@ static void
 gtk_constraint_layout_finalize (GObject *gobject)
 {
   GtkConstraintLayout *self = GTK_CONSTRAINT_LAYOUT (gobject);
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (self->allocation_vars); i++)
+    g_clear_pointer (&self->allocation_vars[i], gtk_constraint_variable_unref);
 
   if (self->constraints_observer)
     {
@@ -907,6 +923,35 @@ update_child_constraint (GtkConstraintLayout       *self,
     }
 }
 
+static void
+gtk_constraint_layout_release_allocation (GtkConstraintLayout *self)
+{
+  guint i;
+
+  if (self->allocation_vars[0] == NULL)
+    return;
+
+  for (i = 0; i < G_N_ELEMENTS (self->allocation_vars); i++)
+    {
+      gtk_constraint_solver_remove_edit_variable (self->solver, self->allocation_vars[i]);
+      g_clear_pointer (&self->allocation_vars[i], gtk_constraint_variable_unref);
+    }
+
+  self->allocation_relaxed = FALSE;
+}
+
+static void
+gtk_constraint_layout_set_allocation_strength (GtkConstraintLayout *self,
+                                               int                  strength)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (self->allocation_vars); i++)
+    gtk_constraint_solver_set_edit_strength (self->solver, self->allocation_vars[i], strength);
+
+  self->allocation_relaxed = strength == 0;
+}
+
 static void
 gtk_constraint_layout_measure (GtkLayoutManager *manager,
                                GtkWidget        *widget,
@@ -928,6 +973,13 @@ gtk_constraint_layout_measure (GtkLayoutManager *manager,
   if (solver == NULL)
     return;
 
+  /* Measuring needs the layout to be free to change size. The
+   * allocation edits are only relaxed, so that the next allocation
+   * does not need to add them again
+   */
+  if (self->allocation_vars[0] != NULL && !self->allocation_relaxed)
+    gtk_constraint_layout_set_allocation_strength (self, 0);
+
   gtk_constraint_solver_freeze (solver);
 
   /* We measure each child in the layout and impose restrictions on the
@@ -979,11 +1031,22 @@ gtk_constraint_layout_measure (GtkLayoutManager *manager,
   /* We impose a temporary value on the size and opposite size of the
    * layout, with a low weight to let the solver settle towards the
    * natural state of the system. Once we get the value out, we can
-   * remove these constraints
+   * remove these constraints. If the layout was allocated, its
+   * relaxed allocation edits are used for this instead
    */
-  gtk_constraint_solver_add_edit_variable (solver, size, GTK_CONSTRAINT_STRENGTH_STRONG * 2);
-  if (for_size > 0)
-    gtk_constraint_solver_add_edit_variable (solver, opposite_size, GTK_CONSTRAINT_STRENGTH_STRONG * 2);
+  if (self->allocation_vars[0] != NULL)
+    {
+      gtk_constraint_solver_set_edit_strength (solver, size, GTK_CONSTRAINT_STRENGTH_STRONG * 2);
+      if (for_size > 0)
+        gtk_constraint_solver_set_edit_strength (solver, opposite_size, GTK_CONSTRAINT_STRENGTH_STRONG * 2);
+    }
+  else
+    {
+      gtk_constraint_solver_add_edit_variable (solver, size, GTK_CONSTRAINT_STRENGTH_STRONG * 2);
+      if (for_size > 0)
+        gtk_constraint_solver_add_edit_variable (solver, opposite_size, GTK_CONSTRAINT_STRENGTH_STRONG * 2);
+    }
+
   gtk_constraint_solver_begin_edit (solver);
   gtk_constraint_solver_suggest_value (solver, size, 0.0);
   if (for_size > 0)
@@ -992,9 +1055,18 @@ gtk_constraint_layout_measure (GtkLayoutManager *manager,
 
   min_value = gtk_constraint_variable_get_value (size);
 
-  gtk_constraint_solver_remove_edit_variable (solver, size);
-  if (for_size > 0)
-    gtk_constraint_solver_remove_edit_variable (solver, opposite_size);
+  if (self->allocation_vars[0] != NULL)
+    {
+      gtk_constraint_solver_set_edit_strength (solver, size, 0);
+      if (for_size > 0)
+        gtk_constraint_solver_set_edit_strength (solver, opposite_size, 0);
+    }
+  else
+    {
+      gtk_constraint_solver_remove_edit_variable (solver, size);
+      if (for_size > 0)
+        gtk_constraint_solver_remove_edit_variable (solver, opposite_size);
+    }
   gtk_constraint_solver_end_edit (solver);
 
   GTK_DEBUG (LAYOUT, "layout %p %s size: min %d nat %d (for opposite size: %d)",
@@ -1018,7 +1090,6 @@ gtk_constraint_layout_allocate (GtkLayoutManager *manager,
                                 int               baseline)
 {
   GtkConstraintLayout *self = GTK_CONSTRAINT_LAYOUT (manager);
-  GtkConstraintRef *stay_w, *stay_h, *stay_t, *stay_l;
   GtkConstraintSolver *solver;
   GtkConstraintVariable *layout_top, *layout_height;
   GtkConstraintVariable *layout_left, *layout_width;
@@ -1028,30 +1099,49 @@ gtk_constraint_layout_allocate (GtkLayoutManager *manager,
   if (solver == NULL)
     return;
 
-  /* We add required stay constraints to ensure that the layout remains
-   * within the bounds of the allocation
-   */
   layout_top = get_layout_attribute (self, widget, GTK_CONSTRAINT_ATTRIBUTE_TOP);
   layout_left = get_layout_attribute (self, widget, GTK_CONSTRAINT_ATTRIBUTE_LEFT);
   layout_width = get_layout_attribute (self, widget, GTK_CONSTRAINT_ATTRIBUTE_WIDTH);
   layout_height = get_layout_attribute (self, widget, GTK_CONSTRAINT_ATTRIBUTE_HEIGHT);
 
-  gtk_constraint_variable_set_value (layout_top, 0.0);
-  stay_t = gtk_constraint_solver_add_stay_variable (solver,
-                                                    layout_top,
-                                                    GTK_CONSTRAINT_STRENGTH_REQUIRED);
-  gtk_constraint_variable_set_value (layout_left, 0.0);
-  stay_l = gtk_constraint_solver_add_stay_variable (solver,
-                                                    layout_left,
-                                                    GTK_CONSTRAINT_STRENGTH_REQUIRED);
-  gtk_constraint_variable_set_value (layout_width, width);
-  stay_w = gtk_constraint_solver_add_stay_variable (solver,
-                                                    layout_width,
-                                                    GTK_CONSTRAINT_STRENGTH_REQUIRED);
-  gtk_constraint_variable_set_value (layout_height, height);
-  stay_h = gtk_constraint_solver_add_stay_variable (solver,
-                                                    layout_height,
-                                                    GTK_CONSTRAINT_STRENGTH_REQUIRED);
+  if (self->allocation_vars[0] == NULL)
+    {
+      GtkConstraintVariable *vars[4] = { layout_top, layout_left, layout_width, layout_height };
+      double values[4] = { 0.0, 0.0, width, height };
+      guint i;
+
+      /* We add edit constraints to ensure that the layout remains
+       * within the bounds of the allocation; they are strong, rather
+       * than required, so that an allocation that does not satisfy
+       * the constraints of the layout does not break the solver
+       */
+      for (i = 0; i < G_N_ELEMENTS (vars); i++)
+        {
+          gtk_constraint_variable_set_value (vars[i], values[i]);
+          gtk_constraint_solver_add_edit_variable (solver, vars[i], GTK_CONSTRAINT_STRENGTH_STRONG * 2);
+          self->allocation_vars[i] = gtk_constraint_variable_ref (vars[i]);
+        }
+    }
+  else if (self->allocation_relaxed ||
+           width != self->allocated_width || height != self->allocated_height)
+    {
+      /* Only the size changed, or the layout was measured; the solver
+       * can start from the previous solution, instead of rebuilding
+       * the tableau. Measuring may have suggested other sizes, so they
+       * are suggested again before the edits get their strength back
+       */
+      gtk_constraint_solver_begin_edit (solver);
+      gtk_constraint_solver_suggest_value (solver, layout_width, width);
+      gtk_constraint_solver_suggest_value (solver, layout_height, height);
+      gtk_constraint_solver_end_edit (solver);
+
+      if (self->allocation_relaxed)
+        gtk_constraint_layout_set_allocation_strength (self, GTK_CONSTRAINT_STRENGTH_STRONG * 2);
+    }
+
+  self->allocated_width = width;
+  self->allocated_height = height;
+
   GTK_DEBUG (LAYOUT, "Layout [%p]: { .x: %g, .y: %g, .w: %g, .h: %g }",
                      self,
                      gtk_constraint_variable_get_value (layout_left),
@@ -1120,12 +1210,6 @@ gtk_constraint_layout_allocate (GtkLayoutManager *manager,
                    gtk_constraint_variable_get_value (var_height));
         }
     }
-
-  /* The allocation stay constraints are not needed any more */
-  gtk_constraint_solver_remove_constraint (solver, stay_w);
-  gtk_constraint_solver_remove_constraint (solver, stay_h);
-  gtk_constraint_solver_remove_constraint (solver, stay_t);
-  gtk_constraint_solver_remove_constraint (solver, stay_l);
 }
 
 static void
@@ -1165,6 +1249,8 @@ gtk_constraint_layout_unroot (GtkLayoutManager *manager)
   GHashTableIter iter;
   gpointer key;
 
+  gtk_constraint_layout_release_allocation (self);
+
   /* Detach all constraints we're holding, as we're removing the layout
    * from the global solver, and they should not contribute to the other
    * layouts
@@ -1723,6 +1723,77 @@ gtk_constraint_solver_remove_edit_variable (GtkConstraintSolver *self,
   gtk_constraint_solver_remove_constraint (self, ei->constraint);
 }
 
+/*< private >
+ * gtk_constraint_solver_set_edit_strength:
+ * @self: a `GtkConstraintSolver`
+ * @variable: an edit variable
+ * @strength: the new strength of the edit constraint, or 0
+ *
+ * Changes the strength of the edit constraint associated to @variable.
+ *
+ * With a strength of 0, the solver ignores the edit constraint, like
+ * it would after removing it, but its rows stay in the tableau. Giving
+ * it a strength again then only re-optimizes from the current solution,
+ * instead of adding the constraint again.
+ *
+ * The edit constraint must not be required.
+ */
+void
+gtk_constraint_solver_set_edit_strength (GtkConstraintSolver   *self,
+                                         GtkConstraintVariable *variable,
+                                         int                    strength)
+{
+  EditInfo *ei = g_hash_table_lookup (self->edit_var_map, variable);
+  GtkConstraintVariable *error_vars[2];
+  GtkConstraintExpression *z_row;
+  double delta;
+  guint i;
+
+  if (ei == NULL)
+    {
+      char *str = gtk_constraint_variable_to_string (variable);
+
+      g_critical ("Unknown edit variable '%s'", str);
+
+      g_free (str);
+
+      return;
+    }
+
+  g_return_if_fail (!gtk_constraint_ref_is_required (ei->constraint));
+  g_return_if_fail (strength >= 0 && strength != GTK_CONSTRAINT_STRENGTH_REQUIRED);
+
+  delta = strength - ei->constraint->strength;
+  if (delta == 0.0)
+    return;
+
+  /* The error variables of the edit constraint are weighted by its
+   * strength in the objective; change their weight by the difference,
+   * using their rows if they are basic
+   */
+  z_row = g_hash_table_lookup (self->rows, self->objective);
+  error_vars[0] = ei->eplus;
+  error_vars[1] = ei->eminus;
+
+  for (i = 0; i < G_N_ELEMENTS (error_vars); i++)
+    {
+      GtkConstraintExpression *e = g_hash_table_lookup (self->rows, error_vars[i]);
+
+      if (e == NULL)
+        gtk_constraint_expression_add_variable (z_row, error_vars[i], delta, self->objective, self);
+      else
+        gtk_constraint_expression_add_expression (z_row, e, delta, self->objective, self);
+    }
+
+  ei->constraint->strength = strength;
+
+  /* The current solution is still feasible, it only needs to be
+   * optimized for the new objective
+   */
+  gtk_constraint_solver_optimize (self, self->objective);
+  gtk_constraint_solver_set_external_variables (self);
+}
+
 /*< private >
  * gtk_constraint_solver_remove_constraint:
  * @self: a `GtkConstraintSolver`
@@ -1969,6 +2040,10 @@ gtk_constraint_solver_suggest_value (GtkConstraintSolver *self,
   delta = value - ei->prev_constant;
   ei->prev_constant = value;
 
+  /* Nothing to update in the tableau */
+  if (delta == 0.0)
+    return;
+
   gtk_constraint_solver_delta_edit_constant (self, delta, ei->eplus, ei->eminus);
 }
 
@@ -2024,8 +2099,11 @@ gtk_constraint_solver_has_edit_variable (GtkConstraintSolver   *solver,
  * gtk_constraint_solver_resolve() to solve the system, and get the value
  * of the various variables that you're interested in.
  *
- * Once you completed the edit phase, call gtk_constraint_solver_end_edit()
- * to remove all the edit variables.
+ * Once you completed the edit phase, call gtk_constraint_solver_end_edit().
+ *
+ * Edit variables can be kept across edit phases; in that case, the next
+ * edit phase only needs to suggest new values, and resolving the system
+ * starts from the current solution instead of rebuilding the tableau.
  */
 void
 gtk_constraint_solver_begin_edit (GtkConstraintSolver *solver)
@@ -2054,8 +2132,12 @@ edit_info_free (gpointer data)
  * gtk_constraint_solver_end_edit:
  * @solver: a `GtkConstraintSolver`
  *
- * Ends the edit phase for a constraint system, and clears
- * all the edit variables introduced.
+ * Ends the edit phase for a constraint system.
+ *
+ * The edit variables remain in the solver until they are removed
+ * with gtk_constraint_solver_remove_edit_variable(); the solver is
+ * shared between layouts, and other layouts may keep their edit
+ * variables around between edit phases.
  */
 void
 gtk_constraint_solver_end_edit (GtkConstraintSolver *solver)
@@ -2063,8 +2145,6 @@ gtk_constraint_solver_end_edit (GtkConstraintSolver *solver)
   solver->in_edit_phase = FALSE;
 
   gtk_constraint_solver_resolve (solver);
-
-  g_hash_table_remove_all (solver->edit_var_map);
 }
 
 void
@@ -2197,6 +2277,7 @@ gtk_constraint_solver_statistics (GtkConstraintSolver *solver)
   g_string_append_printf (buf, "Artificial vars: %d\n", solver->artificial_counter);
   g_string_append_printf (buf, "Dummy vars: %d\n", solver->dummy_counter);
   g_string_append_printf (buf, "Stay vars: %d\n", g_hash_table_size (solver->stay_var_map));
+  g_string_append_printf (buf, "Edit vars: %d\n", g_hash_table_size (solver->edit_var_map));
   g_string_append_printf (buf, "Optimize count: %d\n", solver->optimize_count);
   g_string_append_printf (buf, "Rows: %d\n", g_hash_table_size (solver->rows));
   g_string_append_printf (buf, "Columns: %d\n", g_hash_table_size (solver->columns));
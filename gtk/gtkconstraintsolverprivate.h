@@ -84,6 +84,11 @@ gboolean
 gtk_constraint_solver_has_edit_variable (GtkConstraintSolver   *solver,
                                          GtkConstraintVariable *variable);
 
+void
+gtk_constraint_solver_set_edit_strength (GtkConstraintSolver   *solver,
+                                         GtkConstraintVariable *variable,
+                                         int                    strength);
+
 void
 gtk_constraint_solver_suggest_value (GtkConstraintSolver   *solver,
                                      GtkConstraintVariable *variable,
@@ -22,6 +22,8 @@
 #include "gtkcssstaticstyleprivate.h"
 #include "gtkcssanimatedstyleprivate.h"
 #include "gtkcssstylepropertyprivate.h"
+#include "gtkcsswidgetnodeprivate.h"
+#include "gtklayoutstatsprivate.h"
 #include "gtkmarshalers.h"
 #include "gtksettingsprivate.h"
 #include "gtktypebuiltins.h"
@@ -881,7 +883,17 @@ gtk_css_node_set_style (GtkCssNode  *cssnode,
   if (cssnode->style == style)
     return FALSE;
 
-  gtk_css_style_change_init (&change, cssnode->style, style);
+  /* The widgets still have state derived from the style they had
+   * before the node went dormant, and the default style that replaced
+   * it is no baseline for comparing, so report everything as changed
+   */
+  if (cssnode->styles_dropped)
+    {
+      gtk_css_style_change_init_all (&change, cssnode->style, style);
+      cssnode->styles_dropped = FALSE;
+    }
+  else
+    gtk_css_style_change_init (&change, cssnode->style, style);
 
   style_changed = gtk_css_style_change_has_change (&change);
   if (style_changed)
@@ -1316,10 +1328,13 @@ gtk_css_node_validate_internal (GtkCssNode             *cssnode,
 {
   GtkCssNode *child;
   gboolean bloomed = FALSE;
+  gint64 stats_start;
 
   if (!cssnode->invalid)
     return;
 
+  stats_start = gtk_layout_stats_begin ();
+
   gtk_css_node_ensure_style (cssnode, filter, timestamp);
 
   /* need to set to FALSE then to TRUE here to make it chain up */
@@ -1329,6 +1344,18 @@ gtk_css_node_validate_internal (GtkCssNode             *cssnode,
 
   GTK_CSS_NODE_GET_CLASS (cssnode)->validate (cssnode);
 
+  if (stats_start != 0)
+    {
+      GtkWidget *widget = NULL;
+
+      if (GTK_IS_CSS_WIDGET_NODE (cssnode))
+        widget = gtk_css_widget_node_get_widget (GTK_CSS_WIDGET_NODE (cssnode));
+
+      gtk_layout_stats_end (stats_start,
+                            GTK_LAYOUT_STATS_CSS,
+                            widget ? G_OBJECT_TYPE (widget) : G_OBJECT_TYPE (cssnode));
+    }
+
   for (child = gtk_css_node_get_first_child (cssnode);
        child;
        child = gtk_css_node_get_next_sibling (child))
@@ -1349,6 +1376,54 @@ gtk_css_node_validate_internal (GtkCssNode             *cssnode,
     gtk_css_node_declaration_remove_bloom_hashes (cssnode->decl, filter);
 }
 
+/*
+ * gtk_css_node_drop_styles:
+ * @cssnode: a `GtkCssNode`
+ *
+ * Replaces the styles of @cssnode and all its descendants with the
+ * default style and marks them for recomputation, without emitting
+ * change notifications.
+ *
+ * This is used for subtrees that are not going to be shown for a
+ * while. The node is expected to be invisible, so that it does not
+ * take part in validation until it is shown again.
+ *
+ * The next style computed for each node is reported as changing
+ * every property, since the widgets may still hold state derived
+ * from the dropped style.
+ *
+ * Returns: the number of styles that were dropped
+ */
+guint
+gtk_css_node_drop_styles (GtkCssNode *cssnode)
+{
+  GtkCssStyle *default_style;
+  GtkCssNode *child;
+  guint n_dropped = 0;
+
+  default_style = gtk_css_static_style_get_default ();
+
+  if (cssnode->style != default_style)
+    {
+      g_set_object (&cssnode->style, default_style);
+      cssnode->styles_dropped = TRUE;
+      n_dropped++;
+    }
+
+  g_clear_pointer (&cssnode->cache, gtk_css_node_style_cache_unref);
+
+  cssnode->pending_changes |= GTK_CSS_CHANGE_ANY;
+  cssnode->style_is_invalid = TRUE;
+  gtk_css_node_set_invalid (cssnode, TRUE);
+
+  for (child = gtk_css_node_get_first_child (cssnode);
+       child;
+       child = gtk_css_node_get_next_sibling (child))
+    n_dropped += gtk_css_node_drop_styles (child);
+
+  return n_dropped;
+}
+
 void
 gtk_css_node_validate (GtkCssNode *cssnode)
 {
@@ -63,6 +63,7 @@ struct _GtkCssNode
    * So if a valid style is computed, one has to previously ensure that the parent's and the previous sibling's style
    * are valid. This allows both validation and invalidation to run in O(nodes-in-tree) */
   guint                  style_is_invalid :1;   /* the style needs to be recomputed */
+  guint                  styles_dropped :1;     /* the style was replaced by the default style while dormant */
 };
 
 struct _GtkCssNodeClass
@@ -150,6 +151,7 @@ void                    gtk_css_node_invalidate_frame_clock
 void                    gtk_css_node_invalidate         (GtkCssNode            *cssnode,
                                                          GtkCssChange           change);
 void                    gtk_css_node_validate           (GtkCssNode            *cssnode);
+guint                   gtk_css_node_drop_styles        (GtkCssNode            *cssnode);
 
 GtkStyleProvider *      gtk_css_node_get_style_provider (GtkCssNode            *cssnode) G_GNUC_PURE;
 
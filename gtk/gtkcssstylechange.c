@@ -125,6 +125,21 @@ gtk_css_style_change_init (GtkCssStyleChange *change,
     compute_change (change);
 }
 
+/* Used when @old_style is not the style that the users of the
+ * change last saw, so every property has to be treated as changed
+ */
+void
+gtk_css_style_change_init_all (GtkCssStyleChange *change,
+                               GtkCssStyle       *old_style,
+                               GtkCssStyle       *new_style)
+{
+  change->old_style = g_object_ref (old_style);
+  change->new_style = g_object_ref (new_style);
+
+  change->affects = GTK_CSS_AFFECTS_ANY;
+  change->changes = _gtk_bitmask_invert_range (_gtk_bitmask_new (), 0, GTK_CSS_PROPERTY_N_PROPERTIES);
+}
+
 void
 gtk_css_style_change_finish (GtkCssStyleChange *change)
 {
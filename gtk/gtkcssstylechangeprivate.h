@@ -32,6 +32,9 @@ struct _GtkCssStyleChange {
 void            gtk_css_style_change_init               (GtkCssStyleChange      *change,
                                                          GtkCssStyle            *old_style,
                                                          GtkCssStyle            *new_style);
+void            gtk_css_style_change_init_all           (GtkCssStyleChange      *change,
+                                                         GtkCssStyle            *old_style,
+                                                         GtkCssStyle            *new_style);
 void            gtk_css_style_change_finish             (GtkCssStyleChange      *change);
 
 GtkCssStyle *   gtk_css_style_change_get_old_style      (GtkCssStyleChange      *change);
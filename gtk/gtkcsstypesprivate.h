@@ -182,6 +182,8 @@ typedef enum {
 #define GTK_CSS_AFFECTS_TEXT (GTK_CSS_AFFECTS_TEXT_SIZE | \
                               GTK_CSS_AFFECTS_TEXT_CONTENT)
 
+#define GTK_CSS_AFFECTS_ANY ((GTK_CSS_AFFECTS_TRANSFORM << 1) - 1)
+
 
 enum { /*< skip >*/
   GTK_CSS_PROPERTY_COLOR,
@@ -0,0 +1,227 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkdecodeloadprivate.h"
+
+#include "gtkadjustment.h"
+#include "gtkscrollable.h"
+
+/* Loads a file through the decode scheduler for a widget, and keeps
+ * the priority of the load in line with where the widget is.
+ *
+ * Widgets in a list or grid view stay mapped long after they have
+ * been scrolled out of view, so being mapped says little about
+ * whether they are visible. Instead, the bounds of the widget are
+ * compared to the nearest scrollable ancestor, and the priority is
+ * updated whenever that scrolls.
+ */
+
+struct _GtkDecodeLoad
+{
+  GtkWidget *widget;
+  GdkDecodeRequest *request;
+  GdkDecodeCallback callback;
+  gpointer user_data;
+
+  GtkAdjustment *adjustments[2];
+};
+
+/*
+ * gtk_widget_get_decode_priority:
+ * @widget: a `GtkWidget`
+ *
+ * Ranks @widget by how soon it is going to be seen.
+ *
+ * Widgets inside the viewport of their nearest scrollable ancestor
+ * are visible, widgets that are less than a page away from it are
+ * nearby, and everything else, including widgets that are not
+ * mapped, is in the background. Widgets without a scrollable
+ * ancestor are visible as long as they are mapped.
+ *
+ * Returns: the priority for loading content for @widget
+ */
+GdkDecodePriority
+gtk_widget_get_decode_priority (GtkWidget *widget)
+{
+  GtkWidget *scrollable;
+  graphene_rect_t bounds, viewport, nearby;
+  int width, height;
+
+  if (!gtk_widget_get_mapped (widget))
+    return GDK_DECODE_PRIORITY_BACKGROUND;
+
+  scrollable = gtk_widget_get_ancestor (widget, GTK_TYPE_SCROLLABLE);
+  if (scrollable == NULL)
+    return GDK_DECODE_PRIORITY_VISIBLE;
+
+  if (!gtk_widget_compute_bounds (widget, scrollable, &bounds))
+    return GDK_DECODE_PRIORITY_BACKGROUND;
+
+  width = gtk_widget_get_width (scrollable);
+  height = gtk_widget_get_height (scrollable);
+
+  graphene_rect_init (&viewport, 0, 0, width, height);
+  if (graphene_rect_intersection (&bounds, &viewport, NULL))
+    return GDK_DECODE_PRIORITY_VISIBLE;
+
+  graphene_rect_init (&nearby, - width, - height, 3 * width, 3 * height);
+  if (graphene_rect_intersection (&bounds, &nearby, NULL))
+    return GDK_DECODE_PRIORITY_NEARBY;
+
+  return GDK_DECODE_PRIORITY_BACKGROUND;
+}
+
+static void
+gtk_decode_load_disconnect (GtkDecodeLoad *load)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (load->adjustments); i++)
+    {
+      if (load->adjustments[i] == NULL)
+        continue;
+
+      g_signal_handlers_disconnect_by_func (load->adjustments[i], gtk_decode_load_update_priority, load);
+      g_clear_object (&load->adjustments[i]);
+    }
+}
+
+static void
+gtk_decode_load_done (GdkPaintable *paintable,
+                      const GError *error,
+                      gpointer      data)
+{
+  GtkDecodeLoad *load = data;
+  GdkDecodeCallback callback = load->callback;
+  gpointer user_data = load->user_data;
+
+  gtk_decode_load_disconnect (load);
+  g_free (load);
+
+  callback (paintable, error, user_data);
+}
+
+/*
+ * gtk_decode_load_update_priority:
+ * @load: a load
+ *
+ * Updates the priority of @load after @widget has moved, for
+ * example because it has been mapped or unmapped.
+ *
+ * Scrolling of the nearest scrollable ancestor at the time of the
+ * update is tracked automatically.
+ */
+void
+gtk_decode_load_update_priority (GtkDecodeLoad *load)
+{
+  GtkWidget *scrollable;
+  GtkAdjustment *adjustments[2] = { NULL, NULL };
+  guint i;
+
+  gdk_decode_request_set_priority (load->request, gtk_widget_get_decode_priority (load->widget));
+
+  scrollable = gtk_widget_get_ancestor (load->widget, GTK_TYPE_SCROLLABLE);
+  if (scrollable)
+    {
+      adjustments[0] = gtk_scrollable_get_hadjustment (GTK_SCROLLABLE (scrollable));
+      adjustments[1] = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (scrollable));
+    }
+
+  if (adjustments[0] == load->adjustments[0] &&
+      adjustments[1] == load->adjustments[1])
+    return;
+
+  gtk_decode_load_disconnect (load);
+
+  for (i = 0; i < G_N_ELEMENTS (adjustments); i++)
+    {
+      if (adjustments[i] == NULL)
+        continue;
+
+      load->adjustments[i] = g_object_ref (adjustments[i]);
+      g_signal_connect_swapped (adjustments[i], "value-changed",
+                                G_CALLBACK (gtk_decode_load_update_priority), load);
+      g_signal_connect_swapped (adjustments[i], "changed",
+                                G_CALLBACK (gtk_decode_load_update_priority), load);
+    }
+}
+
+/*
+ * gtk_decode_load_start:
+ * @widget: the widget that shows the file
+ * @file: the file to load
+ * @width: the width the image will be displayed at, or -1
+ * @height: the height the image will be displayed at, or -1
+ * @scale: the scale the image will be displayed at
+ * @func: function that loads the file in a thread
+ * @callback: function to call when the file has been loaded
+ * @user_data: data to pass to @callback
+ *
+ * Queues loading @file with gdk_decode_scheduler_load_file_full(),
+ * at a priority that follows the position of @widget.
+ *
+ * @callback is called once the file has been loaded, after which
+ * the returned load is freed. Until then, the load must be
+ * cancelled with gtk_decode_load_cancel() before @widget goes away.
+ *
+ * Returns: (transfer none): the load
+ */
+GtkDecodeLoad *
+gtk_decode_load_start (GtkWidget         *widget,
+                       GFile             *file,
+                       int                width,
+                       int                height,
+                       double             scale,
+                       GdkDecodeFunc      func,
+                       GdkDecodeCallback  callback,
+                       gpointer           user_data)
+{
+  GtkDecodeLoad *load;
+
+  load = g_new0 (GtkDecodeLoad, 1);
+  load->widget = widget;
+  load->callback = callback;
+  load->user_data = user_data;
+
+  load->request = gdk_decode_scheduler_load_file_full (file,
+                                                       width, height,
+                                                       scale,
+                                                       func,
+                                                       gtk_widget_get_decode_priority (widget),
+                                                       gtk_decode_load_done,
+                                                       load);
+
+  gtk_decode_load_update_priority (load);
+
+  return load;
+}
+
+/*
+ * gtk_decode_load_cancel:
+ * @load: (transfer full): a load
+ *
+ * Cancels @load and frees it. Its callback will not be called.
+ */
+void
+gtk_decode_load_cancel (GtkDecodeLoad *load)
+{
+  gtk_decode_load_disconnect (load);
+  gdk_decode_request_cancel (load->request);
+  g_free (load);
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gtkwidget.h"
+
+#include "gdk/gdkdecodeschedulerprivate.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GtkDecodeLoad GtkDecodeLoad;
+
+GtkDecodeLoad *         gtk_decode_load_start                   (GtkWidget              *widget,
+                                                                 GFile                  *file,
+                                                                 int                     width,
+                                                                 int                     height,
+                                                                 double                  scale,
+                                                                 GdkDecodeFunc           func,
+                                                                 GdkDecodeCallback       callback,
+                                                                 gpointer                user_data);
+void                    gtk_decode_load_update_priority         (GtkDecodeLoad          *load);
+void                    gtk_decode_load_cancel                  (GtkDecodeLoad          *load);
+
+GdkDecodePriority       gtk_widget_get_decode_priority          (GtkWidget              *widget);
+
+G_END_DECLS
@@ -21,6 +21,7 @@
 
 #include "gtkdirectorylist.h"
 
+#include "gtkmain.h"
 #include "gtkprivate.h"
 
 /**
@@ -74,6 +75,7 @@ struct _QueuedEvent
   GFile *file;
   GFileInfo *info;
   GFileMonitorEvent event;
+  gboolean queried;
 };
 
 static void
@@ -99,7 +101,14 @@ struct _GtkDirectoryList
   GCancellable *cancellable;
   GError *error; /* Error while loading */
   GSequence *items; /* Use GPtrArray or GListStore here? */
+  GHashTable *index; /* GFile => GSequenceIter in items */
   GQueue events;
+  guint events_idle;
+
+  /* The not yet emitted change, see gtk_directory_list_queue_change() */
+  guint change_position;
+  guint change_removed;
+  guint change_added;
 };
 
 struct _GtkDirectoryListClass
@@ -260,12 +269,14 @@ gtk_directory_list_dispose (GObject *object)
 
   gtk_directory_list_stop_loading (self);
   gtk_directory_list_stop_monitoring (self);
+  g_clear_handle_id (&self->events_idle, g_source_remove);
 
   g_clear_object (&self->file);
   g_clear_pointer (&self->attributes, g_free);
 
   g_clear_error (&self->error);
   g_clear_pointer (&self->items, g_sequence_free);
+  g_clear_pointer (&self->index, g_hash_table_unref);
 
   g_queue_foreach (&self->events, (GFunc) free_queued_event, NULL);
   g_queue_clear (&self->events);
@@ -373,6 +384,7 @@ static void
 gtk_directory_list_init (GtkDirectoryList *self)
 {
   self->items = g_sequence_new (g_object_unref);
+  self->index = g_hash_table_new_full (g_file_hash, (GEqualFunc) g_file_equal, g_object_unref, NULL);
   self->io_priority = G_PRIORITY_DEFAULT;
   self->monitored = TRUE;
   g_queue_init (&self->events);
@@ -402,6 +414,119 @@ gtk_directory_list_new (const char *attributes,
                        NULL);
 }
 
+static GFile *
+get_file (GFileInfo *info)
+{
+  return G_FILE (g_file_info_get_attribute_object (info, "standard::file"));
+}
+
+static GSequenceIter *
+find_file (GtkDirectoryList *self,
+           GFile            *file)
+{
+  return g_hash_table_lookup (self->index, file);
+}
+
+static void
+append_item (GtkDirectoryList *self,
+             GFileInfo        *info)
+{
+  GSequenceIter *iter;
+
+  iter = g_sequence_append (self->items, info);
+  g_hash_table_insert (self->index, g_object_ref (get_file (info)), iter);
+}
+
+static void
+remove_item (GtkDirectoryList *self,
+             GSequenceIter    *iter)
+{
+  g_hash_table_remove (self->index, get_file (g_sequence_get (iter)));
+  g_sequence_remove (iter);
+}
+
+static void
+gtk_directory_list_flush_changes (GtkDirectoryList *self)
+{
+  guint position, removed, added;
+
+  position = self->change_position;
+  removed = self->change_removed;
+  added = self->change_added;
+
+  self->change_position = 0;
+  self->change_removed = 0;
+  self->change_added = 0;
+
+  if (removed == 0 && added == 0)
+    return;
+
+  g_list_model_items_changed (G_LIST_MODEL (self), position, removed, added);
+  if (removed != added)
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
+}
+
+/*
+ * gtk_directory_list_queue_change:
+ * @self: a `GtkDirectoryList`
+ * @position: the position of the change
+ * @removed: the number of items that are going to be removed
+ * @added: the number of items that are going to be added
+ *
+ * Records a change that is about to be made to the items, so that
+ * changes made in one go are emitted together.
+ *
+ * Changes that touch or overlap the pending one are merged into it.
+ * Other changes cause the pending change to be emitted, so we never
+ * claim that items changed which didn't.
+ *
+ * Call gtk_directory_list_flush_changes() when done.
+ */
+static void
+gtk_directory_list_queue_change (GtkDirectoryList *self,
+                                 guint             position,
+                                 guint             removed,
+                                 guint             added)
+{
+  guint end;
+
+  if (self->change_removed == 0 && self->change_added == 0)
+    {
+      self->change_position = position;
+      self->change_removed = removed;
+      self->change_added = added;
+      return;
+    }
+
+  if (position > self->change_position + self->change_added ||
+      position + removed < self->change_position)
+    {
+      gtk_directory_list_flush_changes (self);
+      gtk_directory_list_queue_change (self, position, removed, added);
+      return;
+    }
+
+  if (position < self->change_position)
+    {
+      guint n = self->change_position - position;
+
+      self->change_position = position;
+      self->change_removed += n;
+      self->change_added += n;
+    }
+
+  end = self->change_position + self->change_added;
+  if (position + removed > end)
+    {
+      guint n = position + removed - end;
+
+      self->change_removed += n;
+      self->change_added += n;
+    }
+
+  self->change_added = self->change_added - removed + added;
+}
+
 static void
 gtk_directory_list_clear_items (GtkDirectoryList *self)
 {
@@ -410,6 +535,7 @@ gtk_directory_list_clear_items (GtkDirectoryList *self)
   n_items = g_sequence_get_length (self->items);
   if (n_items > 0)
     {
+      g_hash_table_remove_all (self->index);
       g_sequence_remove_range (g_sequence_get_begin_iter (self->items),
                                g_sequence_get_end_iter (self->items));
 
@@ -441,7 +567,6 @@ gtk_directory_list_got_files_cb (GObject      *source,
   GFileEnumerator *enumerator = G_FILE_ENUMERATOR (source);
   GError *error = NULL;
   GList *l, *files;
-  guint n;
 
   files = g_file_enumerator_next_files_finish (enumerator, res, &error);
 
@@ -474,18 +599,30 @@ gtk_directory_list_got_files_cb (GObject      *source,
       return;
     }
 
-  n = 0;
   for (l = files; l; l = l->next)
     {
+      GSequenceIter *iter;
       GFileInfo *info;
       GFile *file;
 
       info = l->data;
       file = g_file_enumerator_get_child (enumerator, info);
       g_file_info_set_attribute_object (info, "standard::file", G_OBJECT (file));
+
+      /* The monitor may have told us about the file already */
+      iter = find_file (self, file);
+      if (iter)
+        {
+          gtk_directory_list_queue_change (self, g_sequence_iter_get_position (iter), 1, 1);
+          g_sequence_set (iter, info);
+        }
+      else
+        {
+          gtk_directory_list_queue_change (self, g_sequence_get_length (self->items), 0, 1);
+          append_item (self, info);
+        }
+
       g_object_unref (file);
-      g_sequence_append (self->items, info);
-      n++;
     }
   g_list_free (files);
 
@@ -496,11 +633,7 @@ gtk_directory_list_got_files_cb (GObject      *source,
                                       gtk_directory_list_got_files_cb,
                                       self);
 
-  if (n > 0)
-    {
-      g_list_model_items_changed (G_LIST_MODEL (self), g_sequence_get_length (self->items) - n, 0, n);
-      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
-    }
+  gtk_directory_list_flush_changes (self);
 }
 
 static void
@@ -571,26 +704,6 @@ gtk_directory_list_start_loading (GtkDirectoryList *self)
     g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOADING]);
 }
 
-static GSequenceIter *
-find_file (GSequence *sequence,
-           GFile     *file)
-{
-  GSequenceIter *iter;
-
-  for (iter = g_sequence_get_begin_iter (sequence);
-       !g_sequence_iter_is_end (iter);
-       iter = g_sequence_iter_next (iter))
-    {
-      GFileInfo *item = G_FILE_INFO (g_sequence_get (iter));
-      GFile *f = G_FILE (g_file_info_get_attribute_object (item, "standard::file"));
-
-      if (g_file_equal (f, file))
-        return iter;
-    }
-
-  return NULL;
-}
-
 static gboolean
 handle_event (QueuedEvent *event)
 {
@@ -604,51 +717,56 @@ handle_event (QueuedEvent *event)
     {
     case G_FILE_MONITOR_EVENT_MOVED_IN:
     case G_FILE_MONITOR_EVENT_CREATED:
-      if (!info)
+      if (!event->queried)
         return FALSE;
 
+      /* The file is gone again */
+      if (!info)
+        break;
+
       g_file_info_set_attribute_object (info, "standard::file", G_OBJECT (file));
 
-      iter = find_file (self->items, file);
+      iter = find_file (self, file);
       if (iter)
         {
           position = g_sequence_iter_get_position (iter);
+          gtk_directory_list_queue_change (self, position, 1, 1);
           g_sequence_set (iter, g_object_ref (info));
-          g_list_model_items_changed (G_LIST_MODEL (self), position, 1, 1);
         }
       else
         {
           position = g_sequence_get_length (self->items);
-          g_sequence_append (self->items, g_object_ref (info));
-          g_list_model_items_changed (G_LIST_MODEL (self), position, 0, 1);
-          g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
+          gtk_directory_list_queue_change (self, position, 0, 1);
+          append_item (self, g_object_ref (info));
         }
       break;
 
     case G_FILE_MONITOR_EVENT_MOVED_OUT:
     case G_FILE_MONITOR_EVENT_DELETED:
-      iter = find_file (self->items, file);
+      iter = find_file (self, file);
       if (iter)
         {
           position = g_sequence_iter_get_position (iter);
-          g_sequence_remove (iter);
-          g_list_model_items_changed (G_LIST_MODEL (self), position, 1, 0);
-          g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
+          gtk_directory_list_queue_change (self, position, 1, 0);
+          remove_item (self, iter);
         }
       break;
 
     case G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED:
-      if (!info)
+      if (!event->queried)
         return FALSE;
 
+      if (!info)
+        break;
+
       g_file_info_set_attribute_object (info, "standard::file", G_OBJECT (file));
 
-      iter = find_file (self->items, file);
+      iter = find_file (self, file);
       if (iter)
         {
           position = g_sequence_iter_get_position (iter);
+          gtk_directory_list_queue_change (self, position, 1, 1);
           g_sequence_set (iter, g_object_ref (info));
-          g_list_model_items_changed (G_LIST_MODEL (self), position, 1, 1);
         }
       break;
 
@@ -664,19 +782,40 @@ handle_events (GtkDirectoryList *self)
 {
   QueuedEvent *event;
 
-  do
+  while ((event = g_queue_peek_tail (&self->events)))
     {
-      event = g_queue_peek_tail (&self->events);
-      if (!event)
-        return;
-
       if (!handle_event (event))
-        return;
+        break;
 
       event = g_queue_pop_tail (&self->events);
       free_queued_event (event);
     }
-  while (TRUE);
+
+  gtk_directory_list_flush_changes (self);
+}
+
+static gboolean
+handle_events_idle (gpointer data)
+{
+  GtkDirectoryList *self = data;
+
+  self->events_idle = 0;
+  handle_events (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Handle events in batches, after all the queries that finished
+ * in this main loop iteration, but before the next frame
+ */
+static void
+queue_handle_events (GtkDirectoryList *self)
+{
+  if (self->events_idle != 0)
+    return;
+
+  self->events_idle = g_idle_add_full (GTK_PRIORITY_RESIZE - 1, handle_events_idle, self, NULL);
+  gdk_source_set_static_name_by_id (self->events_idle, "[gtk] handle_events_idle");
 }
 
 static void
@@ -689,7 +828,8 @@ got_new_file_info_cb (GObject      *source,
   GFile *file = event->file;
 
   event->info = g_file_query_info_finish (file, res, NULL);
-  handle_events (self);
+  event->queried = TRUE;
+  queue_handle_events (self);
 }
 
 static void
@@ -702,7 +842,8 @@ got_existing_file_info_cb (GObject      *source,
   GFile *file = event->file;
 
   event->info = g_file_query_info_finish (file, res, NULL);
-  handle_events (self);
+  event->queried = TRUE;
+  queue_handle_events (self);
 }
 
 static void
@@ -742,7 +883,7 @@ directory_changed (GFileMonitor       *monitor,
       ev->file = g_object_ref (file);
       g_queue_push_head (&self->events, ev);
 
-      handle_events (self);
+      queue_handle_events (self);
       break;
 
     case G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED:
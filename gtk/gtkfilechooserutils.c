@@ -457,7 +457,6 @@ _gtk_file_info_get_icon (GFileInfo    *info,
                          int           scale,
                          GtkIconTheme *icon_theme)
 {
-  GIcon *icon;
   GdkPixbuf *pixbuf;
   const char *thumbnail_path;
 
@@ -473,6 +472,16 @@ _gtk_file_info_get_icon (GFileInfo    *info,
         return G_ICON (pixbuf);
     }
 
+  return _gtk_file_info_get_content_type_icon (info, icon_theme);
+}
+
+/* The icon to show for @info when there is no thumbnail */
+GIcon *
+_gtk_file_info_get_content_type_icon (GFileInfo    *info,
+                                      GtkIconTheme *icon_theme)
+{
+  GIcon *icon;
+
   icon = g_file_info_get_icon (info);
   if (icon && gtk_icon_theme_has_gicon (icon_theme, icon))
     return g_object_ref (icon);
@@ -56,6 +56,8 @@ GIcon *         _gtk_file_info_get_icon    (GFileInfo    *info,
                                             int           icon_size,
                                             int           scale,
                                             GtkIconTheme *icon_theme);
+GIcon *         _gtk_file_info_get_content_type_icon (GFileInfo    *info,
+                                                      GtkIconTheme *icon_theme);
 
 GFile *         _gtk_file_info_get_file (GFileInfo *info);
 
@@ -23,6 +23,7 @@
 #include "gtkfilethumbnail.h"
 
 #include "gtkbinlayout.h"
+#include "gtkdecodeloadprivate.h"
 #include "gtkfilechooserutils.h"
 #include "gtkimage.h"
 #include "gtkprivate.h"
@@ -38,6 +39,7 @@ struct _GtkFileThumbnail
   int icon_size;
 
   GCancellable *cancellable;
+  GtkDecodeLoad *decode_load;
   GFileInfo *info;
 };
 
@@ -69,10 +71,26 @@ copy_attribute (GFileInfo  *to,
     g_file_info_set_attribute (to, attribute, type, value);
 }
 
+static void
+thumbnail_loaded_cb (GdkPaintable *paintable,
+                     const GError *error,
+                     gpointer      user_data)
+{
+  GtkFileThumbnail *self = user_data;
+
+  /* The load is gone after this callback */
+  self->decode_load = NULL;
+
+  /* Keep the icon if the thumbnail is broken */
+  if (paintable)
+    gtk_image_set_from_paintable (GTK_IMAGE (self->image), paintable);
+}
+
 static gboolean
 update_image (GtkFileThumbnail *self)
 {
   GtkIconTheme *icon_theme;
+  const char *thumbnail_path;
   GIcon *icon;
   int icon_size;
   int scale;
@@ -87,7 +105,29 @@ update_image (GtkFileThumbnail *self)
   icon_theme = gtk_icon_theme_get_for_display (gtk_widget_get_display (GTK_WIDGET (self)));
 
   icon_size = self->icon_size != -1 ? self->icon_size : ICON_SIZE;
-  icon = _gtk_file_info_get_icon (self->info, icon_size, scale, icon_theme);
+
+  /* Thumbnails are decoded in a thread, so scrolling through a folder
+   * full of images does not block. Show the icon until they are ready.
+   */
+  g_clear_pointer (&self->decode_load, gtk_decode_load_cancel);
+
+  thumbnail_path = g_file_info_get_attribute_byte_string (self->info, G_FILE_ATTRIBUTE_THUMBNAIL_PATH);
+  if (thumbnail_path)
+    {
+      GFile *file = g_file_new_for_path (thumbnail_path);
+
+      self->decode_load = gtk_decode_load_start (GTK_WIDGET (self),
+                                                 file,
+                                                 icon_size * scale,
+                                                 icon_size * scale,
+                                                 1.0,
+                                                 NULL,
+                                                 thumbnail_loaded_cb,
+                                                 self);
+      g_object_unref (file);
+    }
+
+  icon = _gtk_file_info_get_content_type_icon (self->info, icon_theme);
 
   gtk_image_set_from_gicon (GTK_IMAGE (self->image), icon);
 
@@ -134,6 +174,7 @@ cancel_thumbnail (GtkFileThumbnail *self)
 {
   g_cancellable_cancel (self->cancellable);
   g_clear_object (&self->cancellable);
+  g_clear_pointer (&self->decode_load, gtk_decode_load_cancel);
 }
 
 static void
@@ -168,6 +209,28 @@ get_thumbnail (GtkFileThumbnail *self)
     }
 }
 
+static void
+_gtk_file_thumbnail_map (GtkWidget *widget)
+{
+  GtkFileThumbnail *self = GTK_FILE_THUMBNAIL (widget);
+
+  GTK_WIDGET_CLASS (_gtk_file_thumbnail_parent_class)->map (widget);
+
+  if (self->decode_load)
+    gtk_decode_load_update_priority (self->decode_load);
+}
+
+static void
+_gtk_file_thumbnail_unmap (GtkWidget *widget)
+{
+  GtkFileThumbnail *self = GTK_FILE_THUMBNAIL (widget);
+
+  GTK_WIDGET_CLASS (_gtk_file_thumbnail_parent_class)->unmap (widget);
+
+  if (self->decode_load)
+    gtk_decode_load_update_priority (self->decode_load);
+}
+
 static void
 _gtk_file_thumbnail_dispose (GObject *object)
 {
@@ -236,6 +299,9 @@ _gtk_file_thumbnail_class_init (GtkFileThumbnailClass *klass)
   object_class->get_property = _gtk_file_thumbnail_get_property;
   object_class->set_property = _gtk_file_thumbnail_set_property;
 
+  widget_class->map = _gtk_file_thumbnail_map;
+  widget_class->unmap = _gtk_file_thumbnail_unmap;
+
   properties[PROP_ICON_SIZE] =
     g_param_spec_int ("icon-size", NULL, NULL,
                       -1, G_MAXINT, -1,
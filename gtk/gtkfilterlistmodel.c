@@ -22,6 +22,7 @@
 #include "gtkfilterlistmodel.h"
 
 #include "gtkbitset.h"
+#include "gtkidleschedulerprivate.h"
 #include "gtkprivate.h"
 #include "gtksectionmodelprivate.h"
 
@@ -250,9 +251,12 @@ gtk_filter_list_model_run_filter_on_item (GtkFilterListModel *self,
   return visible;
 }
 
+/* Number of items filtered between checks of the clock */
+#define GTK_FILTER_CHECK_TIME_ITEMS 32
+
 static void
 gtk_filter_list_model_run_filter (GtkFilterListModel *self,
-                                  guint               n_steps)
+                                  gint64              end_time)
 {
   GtkBitsetIter iter;
   guint i, pos;
@@ -264,9 +268,13 @@ gtk_filter_list_model_run_filter (GtkFilterListModel *self,
     return;
 
   for (i = 0, more = gtk_bitset_iter_init_first (&iter, self->pending, &pos);
-       i < n_steps && more;
+       more;
        i++, more = gtk_bitset_iter_next (&iter, &pos))
     {
+      if (i % GTK_FILTER_CHECK_TIME_ITEMS == GTK_FILTER_CHECK_TIME_ITEMS - 1 &&
+          g_get_monotonic_time () >= end_time)
+        break;
+
       if (gtk_filter_list_model_run_filter_on_item (self, pos))
         gtk_bitset_add (self->matches, pos);
     }
@@ -283,7 +291,7 @@ gtk_filter_list_model_stop_filtering (GtkFilterListModel *self)
   gboolean notify_pending = self->pending != NULL;
 
   g_clear_pointer (&self->pending, gtk_bitset_unref);
-  g_clear_handle_id (&self->pending_cb, g_source_remove);
+  g_clear_handle_id (&self->pending_cb, gtk_idle_scheduler_remove);
 
   if (notify_pending)
     g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PENDING]);
@@ -317,13 +325,14 @@ gtk_filter_list_model_emit_items_changed_for_changes (GtkFilterListModel *self,
 }
 
 static gboolean
-gtk_filter_list_model_run_filter_cb (gpointer data)
+gtk_filter_list_model_run_filter_cb (gpointer data,
+                                     gint64   deadline)
 {
   GtkFilterListModel *self = data;
   GtkBitset *old;
 
   old = gtk_bitset_copy (self->matches);
-  gtk_filter_list_model_run_filter (self, 512);
+  gtk_filter_list_model_run_filter (self, deadline);
 
   if (self->pending == NULL)
     gtk_filter_list_model_stop_filtering (self);
@@ -357,15 +366,17 @@ gtk_filter_list_model_start_filtering (GtkFilterListModel *self,
 
   if (!self->incremental)
     {
-      gtk_filter_list_model_run_filter (self, G_MAXUINT);
+      gtk_filter_list_model_run_filter (self, G_MAXINT64);
       g_assert (self->pending == NULL);
       return;
     }
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PENDING]);
   g_assert (self->pending_cb == 0);
-  self->pending_cb = g_idle_add (gtk_filter_list_model_run_filter_cb, self);
-  gdk_source_set_static_name_by_id (self->pending_cb, "[gtk] gtk_filter_list_model_run_filter_cb");
+  self->pending_cb = gtk_idle_scheduler_add (GTK_IDLE_TASK_VISIBLE,
+                                             gtk_filter_list_model_run_filter_cb,
+                                             self, NULL,
+                                             "[gtk] gtk_filter_list_model_run_filter_cb");
 }
 
 static void
@@ -945,10 +956,10 @@ gtk_filter_list_model_set_incremental (GtkFilterListModel *self,
   if (!incremental)
     {
       GtkBitset *old;
-      gtk_filter_list_model_run_filter (self, G_MAXUINT);
+      gtk_filter_list_model_run_filter (self, G_MAXINT64);
 
       old = gtk_bitset_copy (self->matches);
-      gtk_filter_list_model_run_filter (self, 512);
+      gtk_filter_list_model_run_filter (self, 0);
 
       gtk_filter_list_model_stop_filtering (self);
 
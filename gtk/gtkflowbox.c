@@ -87,6 +87,7 @@
 #include "gtkaccessible.h"
 #include "gtkadjustment.h"
 #include "gtkbinlayout.h"
+#include "gtkbitset.h"
 #include "gtkbuildable.h"
 #include "gtkcsscolorvalueprivate.h"
 #include "gtkeventcontrollerkey.h"
@@ -121,6 +122,11 @@ static int gtk_flow_box_sort                 (GtkFlowBoxChild *a,
                                               GtkFlowBoxChild *b,
                                               GtkFlowBox      *box);
 
+static gboolean gtk_flow_box_is_virtual      (GtkFlowBox *box);
+static GtkFlowBoxChild *gtk_flow_box_insert_bound_child (GtkFlowBox *box,
+                                                         guint       position,
+                                                         int         index);
+static void gtk_flow_box_queue_update_window (GtkFlowBox *box);
 static void gtk_flow_box_bound_model_changed (GListModel *list,
                                               guint       position,
                                               guint       removed,
@@ -269,6 +275,9 @@ struct _GtkFlowBoxChildPrivate
   GtkWidget     *child;
   GSequenceIter *iter;
   gboolean       selected;
+  guint          position;   /* in the bound model, for virtualized boxes */
+  gboolean       measured;
+  gboolean       detached;
 };
 
 #define CHILD_PRIV(child) ((GtkFlowBoxChildPrivate*)gtk_flow_box_child_get_instance_private ((GtkFlowBoxChild*)(child)))
@@ -646,7 +655,14 @@ gtk_flow_box_child_get_index (GtkFlowBoxChild *child)
   priv = CHILD_PRIV (child);
 
   if (priv->iter != NULL)
-    return g_sequence_iter_get_position (priv->iter);
+    {
+      GtkFlowBox *box = gtk_flow_box_child_get_box (child);
+
+      if (box && gtk_flow_box_is_virtual (box))
+        return priv->position;
+
+      return g_sequence_iter_get_position (priv->iter);
+    }
 
   return -1;
 }
@@ -743,6 +759,7 @@ enum {
   PROP_SELECTION_MODE,
   PROP_ACTIVATE_ON_SINGLE_CLICK,
   PROP_ACCEPT_UNPAIRED_RELEASE,
+  PROP_VIRTUALIZED,
 
   /* orientable */
   PROP_ORIENTATION,
@@ -827,11 +844,37 @@ struct _GtkFlowBoxPrivate {
   gpointer                    create_widget_func_data;
   GDestroyNotify              create_widget_func_data_destroy;
 
+  /* With a virtualized model, children only exist for the items
+   * from window_start to window_end, and for the selected and cursor
+   * children. window_start is always at the start of a line. The
+   * size of the other lines is estimated */
+  gboolean           virtualized;
+  guint              window_start;
+  guint              window_end;
+  int                estimated_line_size;
+  gint64             measured_lines_size;
+  guint              n_measured_children;
+  GtkBitset         *virtual_selection;
+  guint              window_tick_id;
+
+  /* The child the cursor moves to once it is allocated */
+  guint              pending_cursor;
+  gboolean           pending_cursor_extend;
+  gboolean           pending_cursor_modify;
+  gboolean           pending_cursor_allocated;
+
   gboolean           disable_move_cursor;
 };
 
 #define BOX_PRIV(box) ((GtkFlowBoxPrivate*)gtk_flow_box_get_instance_private ((GtkFlowBox*)(box)))
 
+/* Line size to assume for virtualized models before any line was allocated */
+#define VIRTUAL_DEFAULT_LINE_SIZE 64
+/* Lines to create when the visible area is not known */
+#define VIRTUAL_DEFAULT_LINES 20
+/* Lines to keep before and after the visible area */
+#define VIRTUAL_MARGIN_LINES 4
+
 static void gtk_flow_box_buildable_iface_init (GtkBuildableIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (GtkFlowBox, gtk_flow_box, GTK_TYPE_WIDGET,
@@ -862,6 +905,62 @@ child_is_visible (GtkWidget *child)
          gtk_widget_get_child_visible (child);
 }
 
+/* Children of a virtualized box that are kept outside of the
+ * window, like the cursor child, are not part of the lines
+ */
+static inline gboolean
+child_is_in_flow (GtkWidget *child)
+{
+  return child_is_visible (child) &&
+         !CHILD_PRIV (child)->detached;
+}
+
+static gboolean
+gtk_flow_box_is_virtual (GtkFlowBox *box)
+{
+  return BOX_PRIV (box)->virtualized && BOX_PRIV (box)->bound_model != NULL;
+}
+
+/* Returns the first child of a virtualized box at or after @position */
+static GSequenceIter *
+gtk_flow_box_find_position (GtkFlowBox *box,
+                            guint       position)
+{
+  GSequenceIter *begin, *end, *mid;
+
+  begin = g_sequence_get_begin_iter (BOX_PRIV (box)->children);
+  end = g_sequence_get_end_iter (BOX_PRIV (box)->children);
+
+  while (begin != end)
+    {
+      mid = g_sequence_range_get_midpoint (begin, end);
+      if (CHILD_PRIV (g_sequence_get (mid))->position < position)
+        begin = g_sequence_iter_next (mid);
+      else
+        end = mid;
+    }
+
+  return begin;
+}
+
+static GtkFlowBoxChild *
+gtk_flow_box_get_child_at_position (GtkFlowBox *box,
+                                    guint       position)
+{
+  GSequenceIter *iter;
+  GtkFlowBoxChild *child;
+
+  iter = gtk_flow_box_find_position (box, position);
+  if (g_sequence_iter_is_end (iter))
+    return NULL;
+
+  child = g_sequence_get (iter);
+  if (CHILD_PRIV (child)->position != position)
+    return NULL;
+
+  return child;
+}
+
 static int
 get_visible_children (GtkFlowBox *box)
 {
@@ -875,7 +974,7 @@ get_visible_children (GtkFlowBox *box)
       GtkWidget *child;
 
       child = g_sequence_get (iter);
-      if (child_is_visible (child))
+      if (child_is_in_flow (child))
         i++;
     }
 
@@ -960,6 +1059,13 @@ gtk_flow_box_unselect_all_internal (GtkFlowBox *box)
   if (BOX_PRIV (box)->selection_mode == GTK_SELECTION_NONE)
     return FALSE;
 
+  if (BOX_PRIV (box)->virtual_selection &&
+      !gtk_bitset_is_empty (BOX_PRIV (box)->virtual_selection))
+    {
+      gtk_bitset_remove_all (BOX_PRIV (box)->virtual_selection);
+      dirty = TRUE;
+    }
+
   for (iter = g_sequence_get_begin_iter (BOX_PRIV (box)->children);
        !g_sequence_iter_is_end (iter);
        iter = g_sequence_iter_next (iter))
@@ -994,6 +1100,9 @@ gtk_flow_box_update_cursor (GtkFlowBox      *box,
 {
   BOX_PRIV (box)->cursor_child = child;
   gtk_widget_grab_focus (GTK_WIDGET (child));
+
+  /* The previous cursor child may be out of view */
+  gtk_flow_box_queue_update_window (box);
 }
 
 static void
@@ -1039,6 +1148,12 @@ gtk_flow_box_select_all_between (GtkFlowBox      *box,
       iter2 = iter;
     }
 
+  /* Select the items in between that have no child, too */
+  if (gtk_flow_box_is_virtual (box) && child1 && child2 && !modify)
+    gtk_bitset_add_range_closed (BOX_PRIV (box)->virtual_selection,
+                                 MIN (CHILD_PRIV (child1)->position, CHILD_PRIV (child2)->position),
+                                 MAX (CHILD_PRIV (child1)->position, CHILD_PRIV (child2)->position));
+
   for (iter = iter1;
        !g_sequence_iter_is_end (iter);
        iter = g_sequence_iter_next (iter))
@@ -1046,6 +1161,9 @@ gtk_flow_box_select_all_between (GtkFlowBox      *box,
       GtkWidget *child;
 
       child = g_sequence_get (iter);
+      if (gtk_flow_box_is_virtual (box))
+        gtk_bitset_remove (BOX_PRIV (box)->virtual_selection, CHILD_PRIV (child)->position);
+
       if (child_is_visible (child))
         {
           if (modify)
@@ -1142,7 +1260,7 @@ gtk_flow_box_get_previous_focusable (GtkFlowBox    *box,
     {
       iter = g_sequence_iter_prev (iter);
       child = g_sequence_get (iter);
-      if (child_is_visible (GTK_WIDGET (child)) &&
+      if (child_is_in_flow (GTK_WIDGET (child)) &&
           gtk_widget_is_sensitive (GTK_WIDGET (child)))
         return iter;
     }
@@ -1162,7 +1280,7 @@ gtk_flow_box_get_next_focusable (GtkFlowBox    *box,
       if (g_sequence_iter_is_end (iter))
         return NULL;
       child = g_sequence_get (iter);
-      if (child_is_visible (GTK_WIDGET (child)) &&
+      if (child_is_in_flow (GTK_WIDGET (child)) &&
           gtk_widget_is_sensitive (GTK_WIDGET (child)))
         return iter;
     }
@@ -1181,7 +1299,7 @@ gtk_flow_box_get_first_focusable (GtkFlowBox *box)
     return NULL;
 
   child = g_sequence_get (iter);
-  if (child_is_visible (GTK_WIDGET (child)) &&
+  if (child_is_in_flow (GTK_WIDGET (child)) &&
       gtk_widget_is_sensitive (GTK_WIDGET (child)))
     return iter;
 
@@ -1214,7 +1332,7 @@ gtk_flow_box_get_above_focusable (GtkFlowBox    *box,
             return NULL;
           iter = g_sequence_iter_prev (iter);
           child = g_sequence_get (iter);
-          if (child_is_visible (GTK_WIDGET (child)))
+          if (child_is_in_flow (GTK_WIDGET (child)))
             i++;
         }
       if (child && gtk_widget_get_sensitive (GTK_WIDGET (child)))
@@ -1240,7 +1358,7 @@ gtk_flow_box_get_below_focusable (GtkFlowBox    *box,
           if (g_sequence_iter_is_end (iter))
             return NULL;
           child = g_sequence_get (iter);
-          if (child_is_visible (GTK_WIDGET (child)))
+          if (child_is_in_flow (GTK_WIDGET (child)))
             i++;
         }
       if (child && gtk_widget_get_sensitive (GTK_WIDGET (child)))
@@ -1276,7 +1394,7 @@ get_max_item_size (GtkFlowBox     *box,
 
       child = g_sequence_get (iter);
 
-      if (!child_is_visible (child))
+      if (!child_is_in_flow (child))
         continue;
 
       gtk_widget_measure (child, orientation, -1,
@@ -1318,7 +1436,7 @@ get_largest_size_for_opposing_orientation (GtkFlowBox     *box,
 
       child = g_sequence_get (iter);
 
-      if (!child_is_visible (child))
+      if (!child_is_in_flow (child))
         continue;
 
       gtk_widget_measure (child, 1 - orientation, item_size,
@@ -1365,7 +1483,7 @@ get_largest_size_for_line_in_opposing_orientation (GtkFlowBox       *box,
 
       child = g_sequence_get (iter);
 
-      if (!child_is_visible (child))
+      if (!child_is_in_flow (child))
         continue;
 
       /* Distribute the extra pixels to the first children in the line
@@ -1424,7 +1542,7 @@ gather_aligned_item_requests (GtkFlowBox       *box,
 
       child = g_sequence_get (iter);
 
-      if (!child_is_visible (child))
+      if (!child_is_in_flow (child))
         continue;
 
       gtk_widget_measure (child, orientation, -1,
@@ -1540,6 +1658,110 @@ get_offset_pixels (GtkAlign align,
   return offset;
 }
 
+static int
+gtk_flow_box_get_estimated_line_size (GtkFlowBox *box)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+
+  if (priv->estimated_line_size > 0)
+    return priv->estimated_line_size;
+
+  return VIRTUAL_DEFAULT_LINE_SIZE;
+}
+
+/* Gets the number of estimated lines before and after the window
+ * when only a part of a bound model has children */
+static void
+gtk_flow_box_get_virtual_lines (GtkFlowBox *box,
+                                guint      *before,
+                                guint      *after)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  guint n_items, n_after, per_line;
+
+  *before = *after = 0;
+
+  if (!gtk_flow_box_is_virtual (box))
+    return;
+
+  n_items = g_list_model_get_n_items (priv->bound_model);
+  n_after = n_items - MIN (priv->window_end, n_items);
+  per_line = MAX (1, priv->cur_children_per_line);
+
+  *before = (priv->window_start + per_line - 1) / per_line;
+  *after = (n_after + per_line - 1) / per_line;
+}
+
+/* Gets the size of the lines before and after the window */
+static void
+gtk_flow_box_get_virtual_size (GtkFlowBox *box,
+                               int        *before,
+                               int        *after)
+{
+  guint lines_before, lines_after;
+  int line_size;
+
+  gtk_flow_box_get_virtual_lines (box, &lines_before, &lines_after);
+  line_size = gtk_flow_box_get_estimated_line_size (box);
+
+  *before = lines_before * line_size;
+  *after = lines_after * line_size;
+}
+
+/* Allocates a child that is kept outside of the window at the place
+ * its item is estimated to be, so that it can be focused */
+static void
+gtk_flow_box_allocate_detached (GtkFlowBox *box,
+                                GtkWidget  *child,
+                                int         width,
+                                int         line_offset_before,
+                                int         line_offset_after,
+                                int         item_size,
+                                int         item_spacing,
+                                int         line_spacing)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GtkAllocation child_allocation;
+  guint per_line, position, line;
+  int line_size, this_line_size, line_offset, item_offset;
+
+  per_line = MAX (1, priv->cur_children_per_line);
+  line_size = gtk_flow_box_get_estimated_line_size (box);
+  position = CHILD_PRIV (child)->position;
+  line = position / per_line;
+
+  if (position < priv->window_start)
+    line_offset = line_offset_before + (int) line * line_size;
+  else
+    line_offset = line_offset_after + ((int) line - (int) ((priv->window_end + per_line - 1) / per_line)) * line_size;
+
+  item_offset = (int) (position % per_line) * (item_size + item_spacing);
+
+  gtk_widget_measure (child, 1 - priv->orientation, item_size,
+                      &this_line_size, NULL, NULL, NULL);
+  this_line_size = MAX (this_line_size, line_size - line_spacing);
+
+  if (priv->orientation == GTK_ORIENTATION_HORIZONTAL)
+    {
+      child_allocation.x = item_offset;
+      child_allocation.y = line_offset;
+      child_allocation.width = item_size;
+      child_allocation.height = this_line_size;
+    }
+  else /* GTK_ORIENTATION_VERTICAL */
+    {
+      child_allocation.x = line_offset;
+      child_allocation.y = item_offset;
+      child_allocation.width = this_line_size;
+      child_allocation.height = item_size;
+    }
+
+  if (gtk_widget_get_direction (GTK_WIDGET (box)) == GTK_TEXT_DIR_RTL)
+    child_allocation.x = width - child_allocation.x - child_allocation.width;
+
+  gtk_widget_size_allocate (child, &child_allocation, -1);
+}
+
 static void
 gtk_flow_box_size_allocate (GtkWidget *widget,
                             int        width,
@@ -1562,9 +1784,12 @@ gtk_flow_box_size_allocate (GtkWidget *widget,
   int extra_pixels = 0, extra_per_item = 0, extra_extra = 0;
   int extra_line_pixels = 0, extra_per_line = 0, extra_line_extra = 0;
   int i, this_line_size;
+  int virtual_before, virtual_after, first_line_offset;
+  gboolean virtual;
   GSequenceIter *iter;
 
   min_items = MAX (1, priv->min_children_per_line);
+  virtual = gtk_flow_box_is_virtual (box);
 
   if (priv->orientation == GTK_ORIENTATION_HORIZONTAL)
     {
@@ -1583,6 +1808,10 @@ gtk_flow_box_size_allocate (GtkWidget *widget,
   item_align = ORIENTATION_ALIGN (box);
   line_align = OPPOSING_ORIENTATION_ALIGN (box);
 
+  /* The lines of items without children are not ours to distribute */
+  gtk_flow_box_get_virtual_size (box, &virtual_before, &virtual_after);
+  avail_other_size = MAX (0, avail_other_size - virtual_before - virtual_after);
+
   /* Get how many lines we'll be needing to flow */
   n_children = get_visible_children (box);
   if (n_children <= 0)
@@ -1737,6 +1966,9 @@ gtk_flow_box_size_allocate (GtkWidget *widget,
    * go on to distribute expand space if needed.
    */
 
+  if (priv->virtualized && priv->cur_children_per_line != line_length)
+    gtk_flow_box_queue_update_window (box);
+
   priv->cur_children_per_line = line_length;
 
   /* FIXME: This portion needs to consider which columns
@@ -1763,7 +1995,8 @@ gtk_flow_box_size_allocate (GtkWidget *widget,
 
   /* prepend extra space to item_offset/line_offset for SPREAD_END */
   item_offset = get_offset_pixels (item_align, extra_pixels);
-  line_offset = get_offset_pixels (line_align, extra_line_pixels);
+  line_offset = get_offset_pixels (line_align, extra_line_pixels) + virtual_before;
+  first_line_offset = line_offset;
 
   /* Get the allocation size for the first line */
   if (priv->homogeneous)
@@ -1793,7 +2026,7 @@ gtk_flow_box_size_allocate (GtkWidget *widget,
 
       child = g_sequence_get (iter);
 
-      if (!child_is_visible (child))
+      if (!child_is_in_flow (child))
         continue;
 
       /* Get item position */
@@ -1904,6 +2137,57 @@ gtk_flow_box_size_allocate (GtkWidget *widget,
       item_offset += item_spacing;
 
       i++;
+
+      if (!virtual)
+        continue;
+
+      /* Every child counts once towards the estimate, so it settles
+       * instead of changing whenever different lines are in view */
+      if (!CHILD_PRIV (child)->measured)
+        {
+          CHILD_PRIV (child)->measured = TRUE;
+          priv->measured_lines_size += this_line_size + line_spacing;
+          priv->n_measured_children++;
+        }
+
+      if (CHILD_PRIV (child)->position == priv->pending_cursor)
+        priv->pending_cursor_allocated = TRUE;
+    }
+
+  if (virtual)
+    {
+      int detached_item_size;
+
+      if (priv->homogeneous)
+        detached_item_size = item_size;
+      else
+        detached_item_size = item_sizes[0].minimum_size;
+      if (item_align == GTK_ALIGN_FILL)
+        detached_item_size += extra_per_item;
+
+      for (iter = g_sequence_get_begin_iter (priv->children);
+           !g_sequence_iter_is_end (iter);
+           iter = g_sequence_iter_next (iter))
+        {
+          GtkWidget *child = g_sequence_get (iter);
+
+          if (!CHILD_PRIV (child)->detached || !child_is_visible (child))
+            continue;
+
+          gtk_flow_box_allocate_detached (box, child, width,
+                                          first_line_offset - virtual_before,
+                                          line_offset + this_line_size + line_spacing,
+                                          detached_item_size,
+                                          item_spacing,
+                                          line_spacing);
+        }
+
+      /* Changing the estimate or the cursor needs to happen outside
+       * of layout */
+      if (priv->pending_cursor_allocated ||
+          (priv->n_measured_children > 0 &&
+           MAX (1, priv->measured_lines_size / priv->n_measured_children) != gtk_flow_box_get_estimated_line_size (box)))
+        gtk_flow_box_queue_update_window (box);
     }
 
   g_free (item_sizes);
@@ -1952,7 +2236,7 @@ get_largest_aligned_line_length (GtkFlowBox     *box,
       int child_min, child_nat;
 
       child = g_sequence_get (iter);
-      if (!child_is_visible (child))
+      if (!child_is_in_flow (child))
         continue;
 
       gtk_widget_measure (child, orientation, -1,
@@ -1988,13 +2272,13 @@ get_largest_aligned_line_length (GtkFlowBox     *box,
 }
 
 static void
-gtk_flow_box_measure (GtkWidget      *widget,
-                      GtkOrientation  orientation,
-                      int             for_size,
-                      int            *minimum,
-                      int            *natural,
-                      int            *minimum_baseline,
-                      int            *natural_baseline)
+gtk_flow_box_measure_children (GtkWidget      *widget,
+                               GtkOrientation  orientation,
+                               int             for_size,
+                               int            *minimum,
+                               int            *natural,
+                               int            *minimum_baseline,
+                               int            *natural_baseline)
 {
   GtkFlowBox *box = GTK_FLOW_BOX (widget);
   GtkFlowBoxPrivate *priv = BOX_PRIV (box);
@@ -2069,16 +2353,16 @@ gtk_flow_box_measure (GtkWidget      *widget,
               int min_height;
               int dummy;
 
-              gtk_flow_box_measure (widget,
-                                    GTK_ORIENTATION_VERTICAL,
-                                    -1,
-                                    &min_height, &dummy,
-                                    NULL, NULL);
-              gtk_flow_box_measure (widget,
-                                    GTK_ORIENTATION_HORIZONTAL,
-                                    min_height,
-                                    &min_width, &nat_width,
-                                    NULL, NULL);
+              gtk_flow_box_measure_children (widget,
+                                             GTK_ORIENTATION_VERTICAL,
+                                             -1,
+                                             &min_height, &dummy,
+                                             NULL, NULL);
+              gtk_flow_box_measure_children (widget,
+                                             GTK_ORIENTATION_HORIZONTAL,
+                                             min_height,
+                                             &min_width, &nat_width,
+                                             NULL, NULL);
             }
 
           *minimum = min_width;
@@ -2099,11 +2383,11 @@ gtk_flow_box_measure (GtkWidget      *widget,
           if (priv->orientation == GTK_ORIENTATION_HORIZONTAL)
             {
               /* Return the minimum width */
-              gtk_flow_box_measure (widget,
-                                    GTK_ORIENTATION_HORIZONTAL,
-                                    -1,
-                                    &min_width, &nat_width,
-                                    NULL, NULL);
+              gtk_flow_box_measure_children (widget,
+                                             GTK_ORIENTATION_HORIZONTAL,
+                                             -1,
+                                             &min_width, &nat_width,
+                                             NULL, NULL);
             }
           else /* GTK_ORIENTATION_VERTICAL */
             {
@@ -2117,11 +2401,11 @@ gtk_flow_box_measure (GtkWidget      *widget,
                 goto out_width;
 
               /* Make sure its no smaller than the minimum */
-              gtk_flow_box_measure (widget,
-                                    GTK_ORIENTATION_VERTICAL,
-                                    -1,
-                                    &min_height, &dummy,
-                                    NULL, NULL);
+              gtk_flow_box_measure_children (widget,
+                                             GTK_ORIENTATION_VERTICAL,
+                                             -1,
+                                             &min_height, &dummy,
+                                             NULL, NULL);
 
               avail_size = MAX (for_size, min_height);
               if (avail_size <= 0)
@@ -2262,16 +2546,16 @@ gtk_flow_box_measure (GtkWidget      *widget,
               int min_width;
               int dummy;
 
-              gtk_flow_box_measure (widget,
-                                    GTK_ORIENTATION_HORIZONTAL,
-                                    -1,
-                                    &min_width, &dummy,
-                                   NULL, NULL);
-              gtk_flow_box_measure (widget,
-                                    GTK_ORIENTATION_VERTICAL,
-                                    min_width,
-                                    &min_height, &nat_height,
-                                    NULL, NULL);
+              gtk_flow_box_measure_children (widget,
+                                             GTK_ORIENTATION_HORIZONTAL,
+                                             -1,
+                                             &min_width, &dummy,
+                                             NULL, NULL);
+              gtk_flow_box_measure_children (widget,
+                                             GTK_ORIENTATION_VERTICAL,
+                                             min_width,
+                                             &min_height, &nat_height,
+                                             NULL, NULL);
             }
           else /* GTK_ORIENTATION_VERTICAL */
             {
@@ -2357,11 +2641,11 @@ gtk_flow_box_measure (GtkWidget      *widget,
                 goto out_height;
 
               /* Make sure its no smaller than the minimum */
-              gtk_flow_box_measure (widget,
-                                    GTK_ORIENTATION_HORIZONTAL,
-                                    -1,
-                                    &min_width, &dummy,
-                                    NULL, NULL);
+              gtk_flow_box_measure_children (widget,
+                                             GTK_ORIENTATION_HORIZONTAL,
+                                             -1,
+                                             &min_width, &dummy,
+                                             NULL, NULL);
 
               avail_size = MAX (for_size, min_width);
               if (avail_size <= 0)
@@ -2481,11 +2765,11 @@ gtk_flow_box_measure (GtkWidget      *widget,
           else /* GTK_ORIENTATION_VERTICAL */
             {
               /* Return the minimum height */
-              gtk_flow_box_measure (widget,
-                                    GTK_ORIENTATION_VERTICAL,
-                                    -1,
-                                    &min_height, &nat_height,
-                                    NULL, NULL);
+              gtk_flow_box_measure_children (widget,
+                                             GTK_ORIENTATION_VERTICAL,
+                                             -1,
+                                             &min_height, &nat_height,
+                                             NULL, NULL);
             }
 
          out_height:
@@ -2495,6 +2779,31 @@ gtk_flow_box_measure (GtkWidget      *widget,
     }
 }
 
+static void
+gtk_flow_box_measure (GtkWidget      *widget,
+                      GtkOrientation  orientation,
+                      int             for_size,
+                      int            *minimum,
+                      int            *natural,
+                      int            *minimum_baseline,
+                      int            *natural_baseline)
+{
+  GtkFlowBox *box = GTK_FLOW_BOX (widget);
+  int before, after;
+
+  gtk_flow_box_measure_children (widget, orientation, for_size,
+                                 minimum, natural,
+                                 minimum_baseline, natural_baseline);
+
+  /* Items without children get estimated lines */
+  if (orientation != BOX_PRIV (box)->orientation)
+    {
+      gtk_flow_box_get_virtual_size (box, &before, &after);
+      *minimum += before + after;
+      *natural += before + after;
+    }
+}
+
 /* Drawing {{{3 */
 
 static void
@@ -3090,6 +3399,8 @@ gtk_flow_box_remove (GtkFlowBox *box,
     priv->active_child = NULL;
   if (child == priv->selected_child)
     priv->selected_child = NULL;
+  if (child == priv->cursor_child)
+    priv->cursor_child = NULL;
 
   g_sequence_remove (CHILD_PRIV (child)->iter);
   gtk_widget_unparent (GTK_WIDGET (child));
@@ -3249,6 +3560,130 @@ gtk_flow_box_disable_move_cursor (GtkFlowBox *box)
   priv->disable_move_cursor = TRUE;
 }
 
+static gboolean
+gtk_flow_box_keynav_failed (GtkFlowBox *box,
+                            int         count)
+{
+  GtkDirectionType direction = count < 0 ? GTK_DIR_UP : GTK_DIR_DOWN;
+
+  return gtk_widget_keynav_failed (GTK_WIDGET (box), direction);
+}
+
+/* Lines are stacked in the other orientation */
+static GtkAdjustment *
+gtk_flow_box_get_lines_adjustment (GtkFlowBox *box)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+
+  if (priv->orientation == GTK_ORIENTATION_HORIZONTAL)
+    return priv->vadjustment;
+  else
+    return priv->hadjustment;
+}
+
+/* Children of a virtualized box past the ones in view may not exist,
+ * so the cursor moves by model position, creating the child if needed.
+ * A new child only gets the cursor once it is allocated in its line,
+ * or focusing it could not scroll it into view.
+ */
+static gboolean
+gtk_flow_box_move_cursor_virtual (GtkFlowBox      *box,
+                                  GtkMovementStep  step,
+                                  int              count,
+                                  gboolean         extend,
+                                  gboolean         modify)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GtkFlowBoxChild *child;
+  GtkAdjustment *adjustment;
+  guint n_items, current, per_line, line;
+  gint64 target;
+  int line_size;
+  int page_size;
+
+  n_items = g_list_model_get_n_items (priv->bound_model);
+  per_line = MAX (1, priv->cur_children_per_line);
+  line_size = gtk_flow_box_get_estimated_line_size (box);
+  adjustment = gtk_flow_box_get_lines_adjustment (box);
+
+  if (priv->pending_cursor != GTK_INVALID_LIST_POSITION)
+    current = priv->pending_cursor;
+  else if (priv->cursor_child != NULL)
+    current = CHILD_PRIV (priv->cursor_child)->position;
+  else
+    current = GTK_INVALID_LIST_POSITION;
+
+  switch ((guint) step)
+    {
+    case GTK_MOVEMENT_BUFFER_ENDS:
+      target = count < 0 ? 0 : (gint64) n_items - 1;
+      break;
+    case GTK_MOVEMENT_VISUAL_POSITIONS:
+      if (gtk_widget_get_direction (GTK_WIDGET (box)) == GTK_TEXT_DIR_RTL)
+        count = - count;
+      G_GNUC_FALLTHROUGH;
+    case GTK_MOVEMENT_DISPLAY_LINES:
+    case GTK_MOVEMENT_PAGES:
+      if (current == GTK_INVALID_LIST_POSITION)
+        {
+          target = -1;
+          break;
+        }
+
+      if (step == GTK_MOVEMENT_DISPLAY_LINES)
+        count *= (int) per_line;
+      else if (step == GTK_MOVEMENT_PAGES)
+        {
+          page_size = 100;
+          if (adjustment)
+            page_size = gtk_adjustment_get_page_increment (adjustment);
+          count *= MAX (1, page_size / line_size) * (int) per_line;
+        }
+
+      target = CLAMP ((gint64) current + count, 0, (gint64) n_items - 1);
+      break;
+    default:
+      g_assert_not_reached ();
+    }
+
+  if (target < 0 || target == current)
+    return gtk_flow_box_keynav_failed (box, count);
+
+  child = gtk_flow_box_get_child_at_position (box, target);
+  if (child != NULL && !CHILD_PRIV (child)->detached && CHILD_PRIV (child)->measured)
+    {
+      priv->pending_cursor = GTK_INVALID_LIST_POSITION;
+      gtk_flow_box_update_cursor (box, child);
+      if (!modify)
+        gtk_flow_box_update_selection (box, child, FALSE, extend);
+      return TRUE;
+    }
+
+  priv->pending_cursor = target;
+  priv->pending_cursor_extend = extend;
+  priv->pending_cursor_modify = modify;
+  priv->pending_cursor_allocated = FALSE;
+
+  if (child == NULL)
+    {
+      GSequenceIter *iter = gtk_flow_box_find_position (box, target);
+
+      child = gtk_flow_box_insert_bound_child (box, target, g_sequence_iter_get_position (iter));
+      CHILD_PRIV (child)->detached = target < priv->window_start || target >= priv->window_end;
+      gtk_widget_queue_resize (GTK_WIDGET (box));
+    }
+
+  /* Scroll to where the child is expected, so the lines around it
+   * get created as well */
+  line = target / per_line;
+  if (adjustment)
+    gtk_adjustment_clamp_page (adjustment,
+                               (double) line * line_size,
+                               (double) (line + 1) * line_size);
+
+  return TRUE;
+}
+
 static gboolean
 gtk_flow_box_move_cursor (GtkFlowBox      *box,
                           GtkMovementStep  step,
@@ -3287,6 +3722,9 @@ gtk_flow_box_move_cursor (GtkFlowBox      *box,
          }
     }
 
+  if (gtk_flow_box_is_virtual (box))
+    return gtk_flow_box_move_cursor_virtual (box, step, count, extend, modify);
+
   child = NULL;
   switch ((guint) step)
     {
@@ -3422,16 +3860,7 @@ G_GNUC_END_IGNORE_DEPRECATIONS
     }
 
   if (child == NULL || child == priv->cursor_child)
-    {
-      GtkDirectionType direction = count < 0 ? GTK_DIR_UP : GTK_DIR_DOWN;
-
-      if (!gtk_widget_keynav_failed (GTK_WIDGET (box), direction))
-        {
-          return FALSE;
-        }
-
-      return TRUE;
-    }
+    return gtk_flow_box_keynav_failed (box, count);
 
   /* If the child has its "focusable" property set to FALSE then it will
    * not grab the focus. We must pass the focus to its child directly.
@@ -3501,6 +3930,9 @@ gtk_flow_box_get_property (GObject    *object,
     case PROP_ACCEPT_UNPAIRED_RELEASE:
       g_value_set_boolean (value, priv->accept_unpaired_release);
       break;
+    case PROP_VIRTUALIZED:
+      g_value_set_boolean (value, priv->virtualized);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3558,6 +3990,9 @@ gtk_flow_box_set_property (GObject      *object,
     case PROP_ACCEPT_UNPAIRED_RELEASE:
       gtk_flow_box_set_accept_unpaired_release (box, g_value_get_boolean (value));
       break;
+    case PROP_VIRTUALIZED:
+      gtk_flow_box_set_virtualized (box, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3589,9 +4024,20 @@ gtk_flow_box_dispose (GObject *obj)
       g_clear_pointer (&priv->children, g_sequence_free);
     }
 
+  if (priv->hadjustment)
+    g_signal_handlers_disconnect_by_func (priv->hadjustment, gtk_flow_box_queue_update_window, obj);
+  if (priv->vadjustment)
+    g_signal_handlers_disconnect_by_func (priv->vadjustment, gtk_flow_box_queue_update_window, obj);
   g_clear_object (&priv->hadjustment);
   g_clear_object (&priv->vadjustment);
 
+  if (priv->window_tick_id)
+    {
+      gtk_widget_remove_tick_callback (GTK_WIDGET (obj), priv->window_tick_id);
+      priv->window_tick_id = 0;
+    }
+  g_clear_pointer (&priv->virtual_selection, gtk_bitset_unref);
+
   if (priv->bound_model)
     {
       if (priv->create_widget_func_data_destroy)
@@ -3684,6 +4130,18 @@ gtk_flow_box_class_init (GtkFlowBoxClass *class)
                           FALSE,
                           GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkFlowBox:virtualized: (attributes org.gtk.Property.get=gtk_flow_box_get_virtualized org.gtk.Property.set=gtk_flow_box_set_virtualized)
+   *
+   * Whether to only create children for the visible part of a bound model.
+   *
+   * Since: 4.16
+   */
+  props[PROP_VIRTUALIZED] =
+    g_param_spec_boolean ("virtualized", NULL, NULL,
+                          FALSE,
+                          GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   /**
    * GtkFlowBox:homogeneous: (attributes org.gtk.Property.get=gtk_flow_box_get_homogeneous org.gtk.Property.set=gtk_flow_box_set_homogeneous)
    *
@@ -3959,6 +4417,7 @@ gtk_flow_box_init (GtkFlowBox *box)
   priv->column_spacing = 0;
   priv->row_spacing = 0;
   priv->activate_on_single_click = TRUE;
+  priv->pending_cursor = GTK_INVALID_LIST_POSITION;
 
   gtk_widget_update_orientation (GTK_WIDGET (box), priv->orientation);
 
@@ -4002,6 +4461,303 @@ gtk_flow_box_init (GtkFlowBox *box)
   gtk_widget_add_controller (GTK_WIDGET (box), controller);
 }
 
+static GtkFlowBoxChild *
+gtk_flow_box_insert_bound_child (GtkFlowBox *box,
+                                 guint       position,
+                                 int         index)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GObject *item;
+  GtkWidget *widget;
+  GtkFlowBoxChild *child;
+
+  item = g_list_model_get_item (priv->bound_model, position);
+  widget = priv->create_widget_func (item, priv->create_widget_func_data);
+
+  /* We need to sink the floating reference here, so that we can accept
+   * both instances created with a floating reference (e.g. C functions
+   * that just return the result of g_object_new()) and without (e.g.
+   * from language bindings which will automatically sink the floating
+   * reference).
+   *
+   * See the similar code in gtklistbox.c:gtk_list_box_insert_bound_row.
+   */
+  if (g_object_is_floating (widget))
+    g_object_ref_sink (widget);
+
+  gtk_widget_set_visible (widget, TRUE);
+
+  if (GTK_IS_FLOW_BOX_CHILD (widget))
+    child = g_object_ref (GTK_FLOW_BOX_CHILD (widget));
+  else
+    {
+      child = GTK_FLOW_BOX_CHILD (g_object_ref_sink (gtk_flow_box_child_new ()));
+      gtk_flow_box_child_set_child (child, widget);
+    }
+
+  CHILD_PRIV (child)->position = position;
+  gtk_flow_box_insert (box, GTK_WIDGET (child), index);
+
+  /* Restore the selection of children that were dropped while scrolling */
+  if (priv->virtual_selection && gtk_bitset_contains (priv->virtual_selection, position))
+    {
+      gtk_bitset_remove (priv->virtual_selection, position);
+      if (gtk_flow_box_child_set_selected (child, TRUE))
+        priv->selected_child = child;
+    }
+
+  g_object_unref (child);
+  g_object_unref (widget);
+  g_object_unref (item);
+
+  return child;
+}
+
+/* Removes a child whose item is still in the model, but is no longer
+ * needed. Its selection is remembered for when it is needed again */
+static void
+gtk_flow_box_release_bound_child (GtkFlowBox      *box,
+                                  GtkFlowBoxChild *child)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+
+  if (CHILD_PRIV (child)->selected)
+    {
+      gtk_bitset_add (priv->virtual_selection, CHILD_PRIV (child)->position);
+      gtk_flow_box_child_set_selected (child, FALSE);
+    }
+
+  gtk_flow_box_remove (box, GTK_WIDGET (child));
+}
+
+/* The selected and cursor children are kept when they scroll out of
+ * view, so they can still be queried and navigated from */
+static gboolean
+gtk_flow_box_child_is_pinned (GtkFlowBox      *box,
+                              GtkFlowBoxChild *child)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+
+  return child == priv->selected_child ||
+         child == priv->cursor_child ||
+         CHILD_PRIV (child)->position == priv->pending_cursor;
+}
+
+static void
+gtk_flow_box_update_window (GtkFlowBox *box)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GtkAdjustment *adjustment;
+  GSequenceIter *iter;
+  guint n_items, per_line, start, end, position;
+  int line_size, first_line, last_line;
+  gboolean changed;
+
+  if (!gtk_flow_box_is_virtual (box))
+    return;
+
+  n_items = g_list_model_get_n_items (priv->bound_model);
+  per_line = MAX (1, priv->cur_children_per_line);
+  line_size = gtk_flow_box_get_estimated_line_size (box);
+  adjustment = gtk_flow_box_get_lines_adjustment (box);
+
+  if (adjustment && gtk_adjustment_get_page_size (adjustment) > 0)
+    {
+      double value = gtk_adjustment_get_value (adjustment);
+
+      first_line = value / line_size;
+      last_line = (value + gtk_adjustment_get_page_size (adjustment)) / line_size + 1;
+    }
+  else
+    {
+      first_line = 0;
+      last_line = VIRTUAL_DEFAULT_LINES;
+    }
+
+  first_line = MAX (0, first_line - VIRTUAL_MARGIN_LINES);
+  last_line += VIRTUAL_MARGIN_LINES;
+
+  start = MIN ((guint) first_line * per_line, n_items);
+  end = CLAMP ((guint) last_line * per_line, start, n_items);
+
+  changed = FALSE;
+
+  iter = g_sequence_get_begin_iter (priv->children);
+  while (!g_sequence_iter_is_end (iter))
+    {
+      GtkFlowBoxChild *child = g_sequence_get (iter);
+      gboolean detached;
+
+      iter = g_sequence_iter_next (iter);
+
+      detached = CHILD_PRIV (child)->position < start || CHILD_PRIV (child)->position >= end;
+      if (detached && !gtk_flow_box_child_is_pinned (box, child))
+        {
+          gtk_flow_box_release_bound_child (box, child);
+          changed = TRUE;
+        }
+      else if (CHILD_PRIV (child)->detached != detached)
+        {
+          CHILD_PRIV (child)->detached = detached;
+          changed = TRUE;
+        }
+    }
+
+  iter = gtk_flow_box_find_position (box, start);
+  for (position = start; position < end; position++)
+    {
+      if (!g_sequence_iter_is_end (iter) &&
+          CHILD_PRIV (g_sequence_get (iter))->position == position)
+        {
+          iter = g_sequence_iter_next (iter);
+          continue;
+        }
+
+      gtk_flow_box_insert_bound_child (box, position, g_sequence_iter_get_position (iter));
+      changed = TRUE;
+    }
+
+  priv->window_start = start;
+  priv->window_end = end;
+
+  if (changed)
+    gtk_widget_queue_resize (GTK_WIDGET (box));
+}
+
+/* Moves the view along with the estimated lines before the window
+ * when their size changes, so the lines in view stay in place */
+static void
+gtk_flow_box_update_estimated_line_size (GtkFlowBox *box)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GtkAdjustment *adjustment;
+  int old_size, new_size;
+  guint lines_before, lines_after;
+
+  if (priv->n_measured_children == 0)
+    return;
+
+  old_size = gtk_flow_box_get_estimated_line_size (box);
+  new_size = MAX (1, priv->measured_lines_size / priv->n_measured_children);
+  if (old_size == new_size)
+    return;
+
+  gtk_flow_box_get_virtual_lines (box, &lines_before, &lines_after);
+  priv->estimated_line_size = new_size;
+
+  adjustment = gtk_flow_box_get_lines_adjustment (box);
+  if (adjustment)
+    {
+      double delta, total;
+
+      delta = (double) lines_before * (new_size - old_size);
+      total = (double) (lines_before + lines_after) * (new_size - old_size);
+
+      /* The viewport updates the upper bound with the next
+       * allocation, until then it must not clamp the value */
+      gtk_adjustment_configure (adjustment,
+                                gtk_adjustment_get_value (adjustment) + delta,
+                                gtk_adjustment_get_lower (adjustment),
+                                gtk_adjustment_get_upper (adjustment) + MAX (total, 0),
+                                gtk_adjustment_get_step_increment (adjustment),
+                                gtk_adjustment_get_page_increment (adjustment),
+                                gtk_adjustment_get_page_size (adjustment));
+    }
+
+  gtk_widget_queue_resize (GTK_WIDGET (box));
+}
+
+static void
+gtk_flow_box_apply_pending_cursor (GtkFlowBox *box)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GtkFlowBoxChild *child;
+
+  if (!priv->pending_cursor_allocated)
+    return;
+
+  child = gtk_flow_box_get_child_at_position (box, priv->pending_cursor);
+  priv->pending_cursor = GTK_INVALID_LIST_POSITION;
+  priv->pending_cursor_allocated = FALSE;
+
+  if (child == NULL)
+    return;
+
+  gtk_flow_box_update_cursor (box, child);
+  if (!priv->pending_cursor_modify)
+    gtk_flow_box_update_selection (box, child, FALSE, priv->pending_cursor_extend);
+}
+
+static gboolean
+gtk_flow_box_update_window_tick (GtkWidget     *widget,
+                                 GdkFrameClock *frame_clock,
+                                 gpointer       user_data)
+{
+  GtkFlowBox *box = GTK_FLOW_BOX (widget);
+
+  BOX_PRIV (box)->window_tick_id = 0;
+
+  /* The cursor child is focused while its allocation is current */
+  gtk_flow_box_apply_pending_cursor (box);
+  gtk_flow_box_update_estimated_line_size (box);
+  gtk_flow_box_update_window (box);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Scrolling happens during layout, when we can't add or remove
+ * children, so update them before the next one */
+static void
+gtk_flow_box_queue_update_window (GtkFlowBox *box)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+
+  if (!gtk_flow_box_is_virtual (box) || priv->window_tick_id != 0)
+    return;
+
+  priv->window_tick_id = gtk_widget_add_tick_callback (GTK_WIDGET (box),
+                                                       gtk_flow_box_update_window_tick,
+                                                       NULL, NULL);
+}
+
+static void
+gtk_flow_box_bound_model_changed_virtual (GtkFlowBox *box,
+                                          guint       position,
+                                          guint       removed,
+                                          guint       added)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GSequenceIter *iter;
+
+  gtk_bitset_splice (priv->virtual_selection, position, removed, added);
+
+  if (priv->pending_cursor != GTK_INVALID_LIST_POSITION && priv->pending_cursor >= position)
+    {
+      if (priv->pending_cursor >= position + removed)
+        priv->pending_cursor = priv->pending_cursor - removed + added;
+      else
+        priv->pending_cursor = GTK_INVALID_LIST_POSITION;
+    }
+
+  /* Children of removed items go away, the ones after them move.
+   * Updating the window puts them into their new lines */
+  iter = gtk_flow_box_find_position (box, position);
+  while (!g_sequence_iter_is_end (iter))
+    {
+      GtkFlowBoxChild *child = g_sequence_get (iter);
+
+      iter = g_sequence_iter_next (iter);
+
+      if (CHILD_PRIV (child)->position < position + removed)
+        gtk_flow_box_remove (box, GTK_WIDGET (child));
+      else
+        CHILD_PRIV (child)->position = CHILD_PRIV (child)->position - removed + added;
+    }
+
+  gtk_widget_queue_resize (GTK_WIDGET (box));
+  gtk_flow_box_update_window (box);
+}
+
 static void
 gtk_flow_box_bound_model_changed (GListModel *list,
                                   guint       position,
@@ -4010,9 +4766,14 @@ gtk_flow_box_bound_model_changed (GListModel *list,
                                   gpointer    user_data)
 {
   GtkFlowBox *box = user_data;
-  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
   int i;
 
+  if (BOX_PRIV (box)->virtualized)
+    {
+      gtk_flow_box_bound_model_changed_virtual (box, position, removed, added);
+      return;
+    }
+
   while (removed--)
     {
       GtkFlowBoxChild *child;
@@ -4022,30 +4783,27 @@ gtk_flow_box_bound_model_changed (GListModel *list,
     }
 
   for (i = 0; i < added; i++)
-    {
-      GObject *item;
-      GtkWidget *widget;
-
-      item = g_list_model_get_item (list, position + i);
-      widget = priv->create_widget_func (item, priv->create_widget_func_data);
-
-      /* We need to sink the floating reference here, so that we can accept
-       * both instances created with a floating reference (e.g. C functions
-       * that just return the result of g_object_new()) and without (e.g.
-       * from language bindings which will automatically sink the floating
-       * reference).
-       *
-       * See the similar code in gtklistbox.c:gtk_list_box_bound_model_changed.
-       */
-      if (g_object_is_floating (widget))
-        g_object_ref_sink (widget);
+    gtk_flow_box_insert_bound_child (box, position + i, position + i);
+}
 
-      gtk_widget_set_visible (widget, TRUE);
-      gtk_flow_box_insert (box, widget, position + i);
+static void
+gtk_flow_box_remove_bound_children (GtkFlowBox *box)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GtkWidget *child;
 
-      g_object_unref (widget);
-      g_object_unref (item);
-    }
+  while ((child = gtk_widget_get_first_child (GTK_WIDGET (box))))
+    gtk_flow_box_remove (box, child);
+
+  priv->window_start = 0;
+  priv->window_end = 0;
+  priv->estimated_line_size = 0;
+  priv->measured_lines_size = 0;
+  priv->n_measured_children = 0;
+  priv->pending_cursor = GTK_INVALID_LIST_POSITION;
+  priv->pending_cursor_allocated = FALSE;
+  if (priv->virtual_selection)
+    gtk_bitset_remove_all (priv->virtual_selection);
 }
 
 /* Buildable implementation {{{3 */
@@ -4214,6 +4972,9 @@ gtk_flow_box_insert (GtkFlowBox *box,
  *
  * Gets the nth child in the @box.
  *
+ * If @box is [property@Gtk.FlowBox:virtualized], %NULL is returned
+ * for items that currently have no child.
+ *
  * Returns: (transfer none) (nullable): the child widget, which will
  *   always be a `GtkFlowBoxChild` or %NULL in case no child widget
  *   with the given index exists.
@@ -4226,6 +4987,12 @@ gtk_flow_box_get_child_at_index (GtkFlowBox *box,
 
   g_return_val_if_fail (GTK_IS_FLOW_BOX (box), NULL);
 
+  if (idx < 0)
+    return NULL;
+
+  if (gtk_flow_box_is_virtual (box))
+    return gtk_flow_box_get_child_at_position (box, idx);
+
   iter = g_sequence_get_iter_at_pos (BOX_PRIV (box)->children, idx);
   if (!g_sequence_iter_is_end (iter))
     return g_sequence_get (iter);
@@ -4291,8 +5058,15 @@ gtk_flow_box_set_hadjustment (GtkFlowBox    *box,
 
   g_object_ref (adjustment);
   if (priv->hadjustment)
-    g_object_unref (priv->hadjustment);
+    {
+      g_signal_handlers_disconnect_by_func (priv->hadjustment, gtk_flow_box_queue_update_window, box);
+      g_object_unref (priv->hadjustment);
+    }
   priv->hadjustment = adjustment;
+  g_signal_connect_swapped (adjustment, "value-changed", G_CALLBACK (gtk_flow_box_queue_update_window), box);
+  g_signal_connect_swapped (adjustment, "changed", G_CALLBACK (gtk_flow_box_queue_update_window), box);
+
+  gtk_flow_box_queue_update_window (box);
 }
 
 /**
@@ -4326,8 +5100,15 @@ gtk_flow_box_set_vadjustment (GtkFlowBox    *box,
 
   g_object_ref (adjustment);
   if (priv->vadjustment)
-    g_object_unref (priv->vadjustment);
+    {
+      g_signal_handlers_disconnect_by_func (priv->vadjustment, gtk_flow_box_queue_update_window, box);
+      g_object_unref (priv->vadjustment);
+    }
   priv->vadjustment = adjustment;
+  g_signal_connect_swapped (adjustment, "value-changed", G_CALLBACK (gtk_flow_box_queue_update_window), box);
+  g_signal_connect_swapped (adjustment, "changed", G_CALLBACK (gtk_flow_box_queue_update_window), box);
+
+  gtk_flow_box_queue_update_window (box);
 }
 
 static void
@@ -4363,6 +5144,9 @@ gtk_flow_box_check_model_compat (GtkFlowBox *box)
  * Note that using a model is incompatible with the filtering and sorting
  * functionality in `GtkFlowBox`. When using a model, filtering and sorting
  * should be implemented by the model.
+ *
+ * For large models, consider making @box
+ * [property@Gtk.FlowBox:virtualized].
  */
 void
 gtk_flow_box_bind_model (GtkFlowBox                 *box,
@@ -4372,7 +5156,6 @@ gtk_flow_box_bind_model (GtkFlowBox                 *box,
                          GDestroyNotify              user_data_free_func)
 {
   GtkFlowBoxPrivate *priv = BOX_PRIV (box);
-  GtkWidget *child;
 
   g_return_if_fail (GTK_IS_FLOW_BOX (box));
   g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
@@ -4387,8 +5170,7 @@ gtk_flow_box_bind_model (GtkFlowBox                 *box,
       g_clear_object (&priv->bound_model);
     }
 
-  while ((child = gtk_widget_get_first_child (GTK_WIDGET (box))))
-    gtk_flow_box_remove (box, child);
+  gtk_flow_box_remove_bound_children (box);
 
   if (model == NULL)
     return;
@@ -4658,6 +5440,91 @@ gtk_flow_box_set_accept_unpaired_release (GtkFlowBox *box,
   g_object_notify_by_pspec (G_OBJECT (box), props[PROP_ACCEPT_UNPAIRED_RELEASE]);
 }
 
+/**
+ * gtk_flow_box_set_virtualized: (attributes org.gtk.Method.set_property=virtualized)
+ * @box: a `GtkFlowBox`
+ * @virtualized: %TRUE to only create children for visible items
+ *
+ * Sets whether children are only created for the visible part of
+ * a model bound with [method@Gtk.FlowBox.bind_model].
+ *
+ * When enabled, @box only creates children for the lines in view
+ * plus a few around them, and estimates the size of the other lines.
+ * Children are created and destroyed as @box is scrolled, so binding
+ * a model with many thousand items stays cheap.
+ *
+ * For this to work, the adjustment in the direction the lines are
+ * stacked has to be set with [method@Gtk.FlowBox.set_vadjustment]
+ * or [method@Gtk.FlowBox.set_hadjustment].
+ *
+ * Items that currently don't have a child can not be accessed
+ * with [method@Gtk.FlowBox.get_child_at_index], and are not reported
+ * by [method@Gtk.FlowBox.selected_foreach] and
+ * [method@Gtk.FlowBox.get_selected_children], though their selection
+ * is kept. The child that was selected last and the child with the
+ * keyboard cursor are kept when they are scrolled out of view.
+ *
+ * This setting has no effect when no model is bound.
+ *
+ * Since: 4.16
+ */
+void
+gtk_flow_box_set_virtualized (GtkFlowBox *box,
+                              gboolean    virtualized)
+{
+  GtkFlowBoxPrivate *priv;
+
+  g_return_if_fail (GTK_IS_FLOW_BOX (box));
+
+  priv = BOX_PRIV (box);
+
+  if (priv->virtualized == virtualized)
+    return;
+
+  if (priv->bound_model)
+    gtk_flow_box_remove_bound_children (box);
+
+  priv->virtualized = virtualized;
+
+  if (virtualized)
+    {
+      priv->virtual_selection = gtk_bitset_new_empty ();
+    }
+  else
+    {
+      g_clear_pointer (&priv->virtual_selection, gtk_bitset_unref);
+      if (priv->window_tick_id)
+        {
+          gtk_widget_remove_tick_callback (GTK_WIDGET (box), priv->window_tick_id);
+          priv->window_tick_id = 0;
+        }
+    }
+
+  if (priv->bound_model)
+    gtk_flow_box_bound_model_changed (priv->bound_model, 0, 0, g_list_model_get_n_items (priv->bound_model), box);
+
+  g_object_notify_by_pspec (G_OBJECT (box), props[PROP_VIRTUALIZED]);
+}
+
+/**
+ * gtk_flow_box_get_virtualized: (attributes org.gtk.Method.get_property=virtualized)
+ * @box: a `GtkFlowBox`
+ *
+ * Returns whether children are only created for the visible
+ * part of a bound model.
+ *
+ * Returns: %TRUE if @box is virtualized
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_flow_box_get_virtualized (GtkFlowBox *box)
+{
+  g_return_val_if_fail (GTK_IS_FLOW_BOX (box), FALSE);
+
+  return BOX_PRIV (box)->virtualized;
+}
+
  /* Selection handling {{{2 */
 
 /**
@@ -4742,6 +5609,19 @@ gtk_flow_box_select_all (GtkFlowBox *box)
   if (BOX_PRIV (box)->selection_mode != GTK_SELECTION_MULTIPLE)
     return;
 
+  if (gtk_flow_box_is_virtual (box))
+    {
+      GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+      GSequenceIter *iter;
+
+      /* Existing children are selected below */
+      gtk_bitset_add_range (priv->virtual_selection, 0, g_list_model_get_n_items (priv->bound_model));
+      for (iter = g_sequence_get_begin_iter (priv->children);
+           !g_sequence_iter_is_end (iter);
+           iter = g_sequence_iter_next (iter))
+        gtk_bitset_remove (priv->virtual_selection, CHILD_PRIV (g_sequence_get (iter))->position);
+    }
+
   if (g_sequence_get_length (BOX_PRIV (box)->children) > 0)
     {
       gtk_flow_box_select_all_between (box, NULL, NULL, FALSE);
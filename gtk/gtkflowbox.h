@@ -145,6 +145,11 @@ void                  gtk_flow_box_set_activate_on_single_click (GtkFlowBox
                                                                  gboolean           single);
 GDK_AVAILABLE_IN_ALL
 gboolean              gtk_flow_box_get_activate_on_single_click (GtkFlowBox        *box);
+GDK_AVAILABLE_IN_4_16
+void                  gtk_flow_box_set_virtualized              (GtkFlowBox        *box,
+                                                                 gboolean           virtualized);
+GDK_AVAILABLE_IN_4_16
+gboolean              gtk_flow_box_get_virtualized              (GtkFlowBox        *box);
 
 GDK_AVAILABLE_IN_4_6
 void                  gtk_flow_box_prepend                      (GtkFlowBox        *self,
@@ -103,6 +103,7 @@ struct _GtkGridViewClass
 enum
 {
   PROP_0,
+  PROP_DEFERRED_BINDING,
   PROP_ENABLE_RUBBERBAND,
   PROP_FACTORY,
   PROP_MAX_COLUMNS,
@@ -973,6 +974,10 @@ gtk_grid_view_get_property (GObject    *object,
 
   switch (property_id)
     {
+    case PROP_DEFERRED_BINDING:
+      g_value_set_boolean (value, gtk_grid_view_get_deferred_binding (self));
+      break;
+
     case PROP_ENABLE_RUBBERBAND:
       g_value_set_boolean (value, gtk_list_base_get_enable_rubberband (GTK_LIST_BASE (self)));
       break;
@@ -1017,6 +1022,10 @@ gtk_grid_view_set_property (GObject      *object,
 
   switch (property_id)
     {
+    case PROP_DEFERRED_BINDING:
+      gtk_grid_view_set_deferred_binding (self, g_value_get_boolean (value));
+      break;
+
     case PROP_ENABLE_RUBBERBAND:
       gtk_grid_view_set_enable_rubberband (self, g_value_get_boolean (value));
       break;
@@ -1095,6 +1104,18 @@ gtk_grid_view_class_init (GtkGridViewClass *klass)
   gobject_class->get_property = gtk_grid_view_get_property;
   gobject_class->set_property = gtk_grid_view_set_property;
 
+  /**
+   * GtkGridView:deferred-binding: (attributes org.gtk.Property.get=gtk_grid_view_get_deferred_binding org.gtk.Property.set=gtk_grid_view_set_deferred_binding)
+   *
+   * Bind items to newly visible rows in the background.
+   *
+   * Since: 4.16
+   */
+  properties[PROP_DEFERRED_BINDING] =
+    g_param_spec_boolean ("deferred-binding", NULL, NULL,
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
   /**
    * GtkGridView:enable-rubberband: (attributes org.gtk.Property.get=gtk_grid_view_get_enable_rubberband org.gtk.Property.set=gtk_grid_view_set_enable_rubberband)
    *
@@ -1532,6 +1553,64 @@ gtk_grid_view_get_enable_rubberband (GtkGridView *self)
   return gtk_list_base_get_enable_rubberband (GTK_LIST_BASE (self));
 }
 
+/**
+ * gtk_grid_view_set_deferred_binding: (attributes org.gtk.Method.set_property=deferred-binding)
+ * @self: a `GtkGridView`
+ * @deferred_binding: %TRUE to bind items in the background
+ *
+ * Sets whether items are bound to newly visible rows in the background.
+ *
+ * When enabled, rows that scroll into view or are prepared ahead of
+ * scrolling are first shown as placeholders, see
+ * [signal@Gtk.SignalListItemFactory::placeholder]. The items are then
+ * bound in the time left between frames, starting with the rows
+ * closest to the center of the view. This keeps scrolling smooth when
+ * binding is expensive, like when it involves loading images.
+ *
+ * The focused item and items that are scrolled to explicitly are
+ * always bound right away.
+ *
+ * For this to look good, the rows should have the same size before
+ * and after binding.
+ *
+ * Since: 4.16
+ */
+void
+gtk_grid_view_set_deferred_binding (GtkGridView *self,
+                                    gboolean     deferred_binding)
+{
+  GtkListItemManager *manager;
+
+  g_return_if_fail (GTK_IS_GRID_VIEW (self));
+
+  manager = gtk_list_base_get_manager (GTK_LIST_BASE (self));
+  if (gtk_list_item_manager_get_deferred_binding (manager) == deferred_binding)
+    return;
+
+  gtk_list_item_manager_set_deferred_binding (manager, deferred_binding);
+  gtk_widget_queue_allocate (GTK_WIDGET (self));
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_DEFERRED_BINDING]);
+}
+
+/**
+ * gtk_grid_view_get_deferred_binding: (attributes org.gtk.Method.get_property=deferred-binding)
+ * @self: a `GtkGridView`
+ *
+ * Returns whether items are bound to newly visible rows in the background.
+ *
+ * Returns: %TRUE if binding is deferred
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_grid_view_get_deferred_binding (GtkGridView *self)
+{
+  g_return_val_if_fail (GTK_IS_GRID_VIEW (self), FALSE);
+
+  return gtk_list_item_manager_get_deferred_binding (gtk_list_base_get_manager (GTK_LIST_BASE (self)));
+}
+
 /**
  * gtk_grid_view_set_tab_behavior: (attributes org.gtk.Method.set_property=tab-behavior)
  * @self: a `GtkGridView`
@@ -85,6 +85,12 @@ void            gtk_grid_view_set_single_click_activate         (GtkGridView
 GDK_AVAILABLE_IN_ALL
 gboolean        gtk_grid_view_get_single_click_activate         (GtkGridView            *self);
 
+GDK_AVAILABLE_IN_4_16
+void            gtk_grid_view_set_deferred_binding              (GtkGridView            *self,
+                                                                 gboolean                deferred_binding);
+GDK_AVAILABLE_IN_4_16
+gboolean        gtk_grid_view_get_deferred_binding              (GtkGridView            *self);
+
 GDK_AVAILABLE_IN_4_12
 void            gtk_grid_view_scroll_to                         (GtkGridView            *self,
                                                                  guint                   pos,
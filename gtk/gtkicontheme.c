@@ -50,6 +50,7 @@
 #include "gtksnapshot.h"
 #include "gtkstyleproviderprivate.h"
 #include "gtksymbolicpaintable.h"
+#include "gtksymbolicpathsprivate.h"
 #include "gtkwidgetprivate.h"
 #include "gdktextureutilsprivate.h"
 #include "gdk/gdktextureprivate.h"
@@ -346,6 +347,10 @@ struct _GtkIconTheme
   GList *themes;
   GHashTable *unthemed_icons;
 
+  /* The index of where icons are in the themes, see build_icon_index() */
+  GHashTable *icon_index;
+  GArray *icon_index_entries;
+
   /* GdkDisplay for the icon theme (may be NULL) */
   GdkDisplay *display;
   GtkSettings *display_settings;
@@ -425,6 +430,8 @@ struct _GtkIconPaintable
   GMutex texture_lock;
 
   GdkTexture *texture;
+  /* Symbolic icons that are drawn as paths have no texture */
+  GtkSymbolicPaths *paths;
 };
 
 typedef struct
@@ -454,9 +461,22 @@ typedef struct
   int scale;
 
   GArray *icon_files;
-  GHashTable *icon_hash; /* name (interned) -> file index */
+  GHashTable *icon_hash; /* name (interned) -> file index, only while loading */
 } IconThemeDirSize;
 
+/* One dir size of a theme that has a file for an icon name.
+ * Entries for the same name are consecutive, in the search order
+ * of the themes, and end with an entry with an invalid theme index.
+ */
+typedef struct
+{
+  guint16 theme_index;
+  guint16 dir_size_index;
+  guint32 file_index;
+} IconIndexEntry;
+
+#define ICON_INDEX_END G_MAXUINT16
+
 typedef struct
 {
   gboolean is_resource;
@@ -485,7 +505,9 @@ static IconTheme *       theme_new                        (const char       *the
 static void              theme_dir_size_destroy           (IconThemeDirSize *dir_size);
 static void              theme_dir_destroy                (IconThemeDir     *dir);
 static void              theme_destroy                    (IconTheme        *theme);
-static GtkIconPaintable *theme_lookup_icon                (IconTheme        *theme,
+static GtkIconPaintable *theme_lookup_icon                (GtkIconTheme     *self,
+                                                           guint             theme_index,
+                                                           IconTheme        *theme,
                                                            const char       *icon_name,
                                                            int               size,
                                                            int               scale,
@@ -1382,10 +1404,14 @@ blow_themes (GtkIconTheme *self)
       g_list_free_full (self->themes, (GDestroyNotify) theme_destroy);
       g_array_set_size (self->dir_mtimes, 0);
       g_hash_table_destroy (self->unthemed_icons);
+      g_hash_table_destroy (self->icon_index);
+      g_array_free (self->icon_index_entries, TRUE);
       gtk_string_set_destroy (&self->icons);
     }
   self->themes = NULL;
   self->unthemed_icons = NULL;
+  self->icon_index = NULL;
+  self->icon_index_entries = NULL;
   self->themes_valid = FALSE;
   self->serial++;
 }
@@ -1945,6 +1971,88 @@ add_unthemed_icon (GtkIconTheme *self,
     }
 }
 
+/* Collects the files of all icons in all themes into one index,
+ * so lookups only need to look at the dir sizes that actually
+ * have an icon, instead of at every dir size of every theme.
+ *
+ * The hash tables of the dir sizes are only needed while loading,
+ * and are freed here.
+ */
+static void
+build_icon_index (GtkIconTheme *self)
+{
+  GHashTable *entries;
+  GHashTableIter iter;
+  gpointer key, value;
+  GList *l;
+  guint theme_index;
+  gsize n_entries = 0;
+
+  entries = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_array_unref);
+
+  for (l = self->themes, theme_index = 0; l; l = l->next, theme_index++)
+    {
+      IconTheme *theme = l->data;
+      guint i;
+
+      g_assert (theme_index < ICON_INDEX_END);
+
+      for (i = 0; i < theme->dir_sizes->len; i++)
+        {
+          IconThemeDirSize *dir_size = &g_array_index (theme->dir_sizes, IconThemeDirSize, i);
+
+          g_hash_table_iter_init (&iter, dir_size->icon_hash);
+          while (g_hash_table_iter_next (&iter, &key, &value))
+            {
+              IconIndexEntry entry = { theme_index, i, GPOINTER_TO_UINT (value) };
+              GArray *array;
+
+              array = g_hash_table_lookup (entries, key);
+              if (array == NULL)
+                {
+                  array = g_array_new (FALSE, FALSE, sizeof (IconIndexEntry));
+                  g_hash_table_insert (entries, key, array);
+                  n_entries++;
+                }
+
+              g_array_append_val (array, entry);
+              n_entries++;
+            }
+
+          g_clear_pointer (&dir_size->icon_hash, g_hash_table_destroy);
+        }
+    }
+
+  self->icon_index = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->icon_index_entries = g_array_sized_new (FALSE, FALSE, sizeof (IconIndexEntry), n_entries);
+
+  g_hash_table_iter_init (&iter, entries);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      GArray *array = value;
+      IconIndexEntry end = { ICON_INDEX_END, 0, 0 };
+
+      g_hash_table_insert (self->icon_index, key, GUINT_TO_POINTER (self->icon_index_entries->len));
+      g_array_append_vals (self->icon_index_entries, array->data, array->len);
+      g_array_append_val (self->icon_index_entries, end);
+    }
+
+  g_hash_table_destroy (entries);
+}
+
+/* Returns the entries for @icon_name, or %NULL */
+static const IconIndexEntry *
+lookup_icon_index (GtkIconTheme *self,
+                   const char   *icon_name) /* interned */
+{
+  gpointer position;
+
+  if (!g_hash_table_lookup_extended (self->icon_index, icon_name, NULL, &position))
+    return NULL;
+
+  return &g_array_index (self->icon_index_entries, IconIndexEntry, GPOINTER_TO_UINT (position));
+}
+
 static void
 load_themes (GtkIconTheme *self)
 {
@@ -2014,6 +2122,8 @@ load_themes (GtkIconTheme *self)
       g_strfreev (children);
     }
 
+  build_icon_index (self);
+
   self->themes_valid = TRUE;
 
   self->last_stat_time = g_get_monotonic_time ();
@@ -2140,6 +2250,7 @@ real_choose_icon (GtkIconTheme      *self,
   UnthemedIcon *unthemed_icon = NULL;
   const char *icon_name = NULL;
   IconTheme *theme = NULL;
+  guint theme_index;
   int i;
   IconKey key;
 
@@ -2170,7 +2281,7 @@ real_choose_icon (GtkIconTheme      *self,
    * In other words: We prefer symbolic icons in inherited themes over
    * generic icons in the theme.
    */
-  for (l = self->themes; l; l = l->next)
+  for (l = self->themes, theme_index = 0; l; l = l->next, theme_index++)
     {
       theme = l->data;
       for (i = 0; icon_names[i] && icon_name_is_symbolic (icon_names[i], -1); i++)
@@ -2178,14 +2289,14 @@ real_choose_icon (GtkIconTheme      *self,
           icon_name = gtk_string_set_lookup (&self->icons, icon_names[i]);
           if (icon_name)
             {
-              icon = theme_lookup_icon (theme, icon_name, size, scale, self->pixbuf_supports_svg);
+              icon = theme_lookup_icon (self, theme_index, theme, icon_name, size, scale, self->pixbuf_supports_svg);
               if (icon)
                 goto out;
             }
         }
     }
 
-  for (l = self->themes; l; l = l->next)
+  for (l = self->themes, theme_index = 0; l; l = l->next, theme_index++)
     {
       theme = l->data;
 
@@ -2194,7 +2305,7 @@ real_choose_icon (GtkIconTheme      *self,
           icon_name = gtk_string_set_lookup (&self->icons, icon_names[i]);
           if (icon_name)
             {
-              icon = theme_lookup_icon (theme, icon_name, size, scale, self->pixbuf_supports_svg);
+              icon = theme_lookup_icon (self, theme_index, theme, icon_name, size, scale, self->pixbuf_supports_svg);
               if (icon)
                 goto out;
             }
@@ -2511,7 +2622,7 @@ gtk_icon_theme_lookup_icon (GtkIconTheme       *self,
          currently loading the icon, so we need to do nothing */
       if (g_mutex_trylock (&icon->texture_lock))
         {
-          has_texture = icon->texture != NULL;
+          has_texture = icon->texture != NULL || icon->paths != NULL;
           g_mutex_unlock (&icon->texture_lock);
 
           if (!has_texture)
@@ -2653,10 +2764,11 @@ gtk_icon_theme_get_icon_sizes (GtkIconTheme *self,
                                const char   *icon_name)
 {
   GList *l;
-  int i;
   GHashTable *sizes;
   int *result, *r;
   const char *interned_icon_name;
+  const IconIndexEntry *entry;
+  guint theme_index;
 
   g_return_val_if_fail (GTK_IS_ICON_THEME (self), NULL);
 
@@ -2667,20 +2779,15 @@ gtk_icon_theme_get_icon_sizes (GtkIconTheme *self,
   sizes = g_hash_table_new (g_direct_hash, g_direct_equal);
 
   interned_icon_name = gtk_string_set_lookup (&self->icons, icon_name);
+  entry = interned_icon_name ? lookup_icon_index (self, interned_icon_name) : NULL;
 
-  for (l = self->themes; l; l = l->next)
+  for (l = self->themes, theme_index = 0; entry && l; l = l->next, theme_index++)
     {
       IconTheme *theme = l->data;
 
-      for (i = 0; i < theme->dir_sizes->len; i++)
+      for (; entry->theme_index == theme_index; entry++)
         {
-          IconThemeDirSize *dir_size = &g_array_index (theme->dir_sizes, IconThemeDirSize, i);
-
-          if (dir_size->type != ICON_THEME_DIR_SCALABLE && g_hash_table_lookup_extended (sizes, GINT_TO_POINTER (dir_size->size), NULL, NULL))
-            continue;
-
-          if (!g_hash_table_contains (dir_size->icon_hash, interned_icon_name))
-            continue;
+          IconThemeDirSize *dir_size = &g_array_index (theme->dir_sizes, IconThemeDirSize, entry->dir_size_index);
 
           if (dir_size->type == ICON_THEME_DIR_SCALABLE)
             g_hash_table_insert (sizes, GINT_TO_POINTER (-1), NULL);
@@ -3010,35 +3117,40 @@ compare_dir_size_matches (IconThemeDirSize *dir_a, int difference_a,
 }
 
 static GtkIconPaintable *
-theme_lookup_icon (IconTheme   *theme,
-                   const char *icon_name, /* interned */
-                   int          size,
-                   int          scale,
-                   gboolean     allow_svg)
+theme_lookup_icon (GtkIconTheme *self,
+                   guint         theme_index,
+                   IconTheme    *theme,
+                   const char   *icon_name, /* interned */
+                   int           size,
+                   int           scale,
+                   gboolean      allow_svg)
 {
+  const IconIndexEntry *entry;
   IconThemeDirSize *min_dir_size;
   IconThemeFile *min_file;
   int min_difference;
   IconCacheFlag min_suffix = ICON_CACHE_FLAG_PNG_SUFFIX;
-  int i;
 
   min_difference = G_MAXINT;
   min_dir_size = NULL;
   min_file = NULL;
 
-  for (i = 0; i < theme->dir_sizes->len; i++)
+  entry = lookup_icon_index (self, icon_name);
+  if (entry == NULL)
+    return NULL;
+
+  /* Skip the themes before this one */
+  while (entry->theme_index < theme_index)
+    entry++;
+
+  for (; entry->theme_index == theme_index; entry++)
     {
-      IconThemeDirSize *dir_size = &g_array_index (theme->dir_sizes, IconThemeDirSize, i);
+      IconThemeDirSize *dir_size = &g_array_index (theme->dir_sizes, IconThemeDirSize, entry->dir_size_index);
       IconThemeFile *file;
       guint best_suffix;
       int difference;
-      gpointer file_index;
-
-      if (!g_hash_table_lookup_extended (dir_size->icon_hash, icon_name, NULL, &file_index))
-        continue;
-
-      file = &g_array_index (dir_size->icon_files, IconThemeFile, GPOINTER_TO_INT(file_index));
 
+      file = &g_array_index (dir_size->icon_files, IconThemeFile, entry->file_index);
 
       if (allow_svg)
         best_suffix = file->best_suffix;
@@ -3473,6 +3585,7 @@ gtk_icon_paintable_finalize (GObject *object)
 
   g_clear_object (&icon->loadable);
   g_clear_object (&icon->texture);
+  g_clear_pointer (&icon->paths, gtk_symbolic_paths_unref);
 #ifdef G_OS_WIN32
   g_clear_object (&icon->win32_icon);
 #endif
@@ -3695,7 +3808,7 @@ icon_ensure_texture__locked (GtkIconPaintable *icon,
 
   icon_cache_mark_used_if_cached (icon);
 
-  if (icon->texture)
+  if (icon->texture || icon->paths)
     return;
 
   before = GDK_PROFILER_CURRENT_TIME;
@@ -3705,9 +3818,25 @@ icon_ensure_texture__locked (GtkIconPaintable *icon,
    */
   pixel_size = icon->desired_size * icon->desired_scale;
 
+  /* Symbolic svgs are drawn from paths when they can be,
+   * so they don't need a texture for every size
+   */
+  if (icon->is_symbolic && icon->is_svg && icon->filename)
+    {
+      if (icon->is_resource)
+        icon->paths = gtk_load_symbolic_paths_from_resource (icon->filename);
+      else
+        icon->paths = gtk_load_symbolic_paths_from_filename (icon->filename);
+    }
+
   /* At this point, we need to actually get the icon; either from the
    * builtin image or by loading the file
    */
+  if (icon->paths)
+    {
+      /* Nothing else to load */
+    }
+  else
 #ifdef G_OS_WIN32
   if (icon->win32_icon)
     {
@@ -3797,7 +3926,7 @@ icon_ensure_texture__locked (GtkIconPaintable *icon,
 
   icon->only_fg = only_fg;
 
-  if (!icon->texture)
+  if (!icon->texture && !icon->paths)
     {
       g_warning ("Failed to load icon %s: %s", icon->filename, load_error ? load_error->message : "");
       g_clear_error (&load_error);
@@ -3819,8 +3948,10 @@ icon_ensure_texture__locked (GtkIconPaintable *icon,
     }
 }
 
+/* Returns the texture, or %NULL if the icon is drawn from @paths */
 static GdkTexture *
-gtk_icon_paintable_ensure_texture (GtkIconPaintable *self)
+gtk_icon_paintable_ensure_texture (GtkIconPaintable  *self,
+                                   GtkSymbolicPaths **paths)
 {
   GdkTexture *texture = NULL;
 
@@ -3829,10 +3960,11 @@ gtk_icon_paintable_ensure_texture (GtkIconPaintable *self)
   icon_ensure_texture__locked (self, FALSE);
 
   texture = self->texture;
+  *paths = self->paths;
 
   g_mutex_unlock (&self->texture_lock);
 
-  g_assert (texture != NULL);
+  g_assert (texture != NULL || *paths != NULL);
 
   return texture;
 }
@@ -3884,12 +4016,20 @@ gtk_icon_paintable_snapshot_symbolic (GtkSymbolicPaintable *paintable,
 {
   GtkIconPaintable *icon = GTK_ICON_PAINTABLE (paintable);
   GdkTexture *texture;
+  GtkSymbolicPaths *paths;
   int texture_width, texture_height;
   double render_width;
   double render_height;
   graphene_rect_t render_rect;
 
-  texture = gtk_icon_paintable_ensure_texture (icon);
+  texture = gtk_icon_paintable_ensure_texture (icon, &paths);
+
+  if (paths)
+    {
+      g_debug ("snapshot symbolic icon using paths");
+      gtk_symbolic_paths_snapshot (paths, snapshot, width, height, colors, n_colors);
+      return;
+    }
 
   texture_width = gdk_texture_get_width (texture);
   texture_height = gdk_texture_get_height (texture);
@@ -0,0 +1,414 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkidleschedulerprivate.h"
+
+#include "gdk/gdkprofilerprivate.h"
+
+/* A scheduler for incremental work.
+ *
+ * Models that sort or filter in the background, text views that
+ * validate offscreen lines and similar jobs used to each install
+ * their own idle with a fixed amount of work per run. When several
+ * of them were busy at the same time, they easily added up to more
+ * than a frame.
+ *
+ * Instead, they register a task here. All tasks are run from a
+ * single idle, and they share a time budget that ends a bit before
+ * the next frame is due. When frames are being drawn, that is
+ * determined from the frame clock of the window that painted last;
+ * otherwise a fixed budget is used, to keep input latency low.
+ *
+ * Tasks for visible content are run before background tasks.
+ * Tasks that the next frame depends on are run from an idle with
+ * redraw priority instead, and they are never held back to wait
+ * for a frame.
+ */
+
+/* Budget when no frames are being drawn */
+#define IDLE_BUDGET_US 5000
+
+/* Don't start any work with less time than this left */
+#define MIN_BUDGET_US 1000
+
+/* Time to keep free before the next frame starts */
+#define FRAME_MARGIN_US 1000
+
+#define N_PRIORITIES (GTK_IDLE_TASK_BACKGROUND + 1)
+
+/* The priority of the idle while there are redraw tasks. This is
+ * GTK_TEXT_VIEW_PRIORITY_VALIDATE, between GDK_PRIORITY_REDRAW and
+ * G_PRIORITY_DEFAULT_IDLE
+ */
+#define REDRAW_IDLE_PRIORITY (GDK_PRIORITY_REDRAW + 5)
+
+typedef struct _Task Task;
+
+struct _Task
+{
+  guint id;
+  GtkIdleTaskPriority priority;
+  GtkIdleTaskFunc func;
+  gpointer user_data;
+  GDestroyNotify notify;
+  const char *name;
+  GList link;
+  guint running : 1;
+  guint removed : 1;
+};
+
+static GHashTable *tasks;
+static GQueue queues[N_PRIORITIES];
+static guint next_id = 1;
+static guint source_id;
+static int source_priority;
+static gboolean waiting_for_frame;
+
+static GdkFrameClock *last_frame_clock;
+static gint64 last_paint_time;
+
+static gboolean scheduler_dispatch (gpointer data);
+
+static void
+task_free (Task *task)
+{
+  if (task->notify)
+    task->notify (task->user_data);
+
+  g_free (task);
+}
+
+static void
+scheduler_stop (void)
+{
+  g_clear_handle_id (&source_id, g_source_remove);
+  waiting_for_frame = FALSE;
+}
+
+static int
+scheduler_get_priority (void)
+{
+  if (queues[GTK_IDLE_TASK_REDRAW].length > 0)
+    return REDRAW_IDLE_PRIORITY;
+  else
+    return G_PRIORITY_DEFAULT_IDLE;
+}
+
+static void
+scheduler_start (void)
+{
+  int priority = scheduler_get_priority ();
+
+  if (source_id != 0 && !waiting_for_frame && source_priority == priority)
+    return;
+
+  scheduler_stop ();
+
+  source_id = g_idle_add_full (priority, scheduler_dispatch, NULL, NULL);
+  gdk_source_set_static_name_by_id (source_id, "[gtk] idle scheduler");
+  source_priority = priority;
+}
+
+static void
+scheduler_wait_for_frame (gint64 refresh_interval)
+{
+  scheduler_stop ();
+
+  /* The after-paint handler will pick things up again, but in case
+   * the frame never comes, don't wait forever
+   */
+  source_id = g_timeout_add (MAX (1, refresh_interval / 1000), scheduler_dispatch, NULL);
+  gdk_source_set_static_name_by_id (source_id, "[gtk] idle scheduler");
+  waiting_for_frame = TRUE;
+}
+
+/* Returns the time by which the tasks should be done,
+ * and the refresh interval if frames are being drawn
+ */
+static gint64
+scheduler_get_deadline (gint64  now,
+                        gint64 *refresh_interval)
+{
+  *refresh_interval = 0;
+
+  if (last_frame_clock)
+    {
+      gint64 frame_time, interval, presentation_time;
+
+      frame_time = gdk_frame_clock_get_frame_time (last_frame_clock);
+      gdk_frame_clock_get_refresh_info (last_frame_clock, frame_time,
+                                        &interval, &presentation_time);
+
+      /* Only if the clock is still ticking */
+      if (now < last_paint_time + 2 * interval)
+        {
+          *refresh_interval = interval;
+          return frame_time + interval - FRAME_MARGIN_US;
+        }
+    }
+
+  return now + IDLE_BUDGET_US;
+}
+
+static gboolean
+scheduler_dispatch (gpointer data)
+{
+  gint64 now, deadline, refresh_interval;
+  gint64 before G_GNUC_UNUSED;
+  guint self_id, i, n_run;
+  gboolean was_waiting;
+
+  now = g_get_monotonic_time ();
+  deadline = scheduler_get_deadline (now, &refresh_interval);
+
+  if (deadline - now < MIN_BUDGET_US)
+    {
+      if (queues[GTK_IDLE_TASK_REDRAW].length == 0)
+        {
+          /* The tasks would only push the next frame back */
+          source_id = 0;
+          scheduler_wait_for_frame (refresh_interval);
+          return G_SOURCE_REMOVE;
+        }
+
+      /* The next frame can't be drawn without the redraw tasks */
+      deadline = now + MIN_BUDGET_US;
+    }
+
+  self_id = source_id;
+  was_waiting = waiting_for_frame;
+  waiting_for_frame = FALSE;
+
+  before = GDK_PROFILER_CURRENT_TIME;
+  n_run = 0;
+
+  for (i = 0; i < N_PRIORITIES; i++)
+    {
+      guint n = queues[i].length;
+
+      /* Run every task at most once, so that one that always
+       * finishes early can't keep the others from their turn
+       */
+      while (n-- > 0 && g_get_monotonic_time () < deadline)
+        {
+          GList *link = g_queue_pop_head_link (&queues[i]);
+          Task *task = link->data;
+          gint64 task_before G_GNUC_UNUSED;
+          gboolean result;
+
+          task_before = GDK_PROFILER_CURRENT_TIME;
+
+          task->running = TRUE;
+          result = task->func (task->user_data, deadline);
+          task->running = FALSE;
+          n_run++;
+
+          gdk_profiler_end_mark (task_before, "Idle task", task->name);
+
+          if (task->removed)
+            {
+              task_free (task);
+            }
+          else if (result == G_SOURCE_REMOVE)
+            {
+              g_hash_table_remove (tasks, GUINT_TO_POINTER (task->id));
+              task_free (task);
+            }
+          else
+            {
+              g_queue_push_tail_link (&queues[task->priority], link);
+            }
+        }
+    }
+
+  gdk_profiler_end_markf (before, "Idle tasks", "%u tasks, %.1f ms budget",
+                          n_run, (deadline - now) / 1000.);
+
+  /* The tasks may have stopped or restarted the scheduler */
+  if (source_id != self_id)
+    return G_SOURCE_REMOVE;
+
+  if (g_hash_table_size (tasks) == 0)
+    {
+      source_id = 0;
+      return G_SOURCE_REMOVE;
+    }
+
+  if (was_waiting || source_priority != scheduler_get_priority ())
+    {
+      /* We were the timeout, or the redraw tasks changed,
+       * continue as an idle of the right priority
+       */
+      source_id = 0;
+      scheduler_start ();
+      return G_SOURCE_REMOVE;
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+/*
+ * gtk_idle_scheduler_add:
+ * @priority: the priority of the task
+ * @func: function to call
+ * @user_data: data to pass to @func
+ * @notify: (nullable): function to call when the task is removed
+ * @name: (nullable): a static name for the task, for debugging
+ *
+ * Adds a task for incremental work.
+ *
+ * @func will be called repeatedly from the main loop with a deadline
+ * by which it should return, until it returns %G_SOURCE_REMOVE or the
+ * task is removed with gtk_idle_scheduler_remove().
+ *
+ * Returns: the ID of the task
+ */
+guint
+gtk_idle_scheduler_add (GtkIdleTaskPriority  priority,
+                        GtkIdleTaskFunc      func,
+                        gpointer             user_data,
+                        GDestroyNotify       notify,
+                        const char          *name)
+{
+  Task *task;
+
+  g_return_val_if_fail (func != NULL, 0);
+
+  if (G_UNLIKELY (tasks == NULL))
+    tasks = g_hash_table_new (NULL, NULL);
+
+  task = g_new0 (Task, 1);
+  task->id = next_id++;
+  task->priority = priority;
+  task->func = func;
+  task->user_data = user_data;
+  task->notify = notify;
+  task->name = name;
+  task->link.data = task;
+
+  g_hash_table_insert (tasks, GUINT_TO_POINTER (task->id), task);
+  g_queue_push_tail_link (&queues[priority], &task->link);
+
+  scheduler_start ();
+
+  return task->id;
+}
+
+/*
+ * gtk_idle_scheduler_remove:
+ * @id: the ID of a task
+ *
+ * Removes a task that was added with gtk_idle_scheduler_add().
+ *
+ * This may be called from the task function itself.
+ */
+void
+gtk_idle_scheduler_remove (guint id)
+{
+  Task *task;
+
+  g_return_if_fail (tasks != NULL);
+
+  task = g_hash_table_lookup (tasks, GUINT_TO_POINTER (id));
+  g_return_if_fail (task != NULL);
+
+  g_hash_table_remove (tasks, GUINT_TO_POINTER (id));
+
+  if (task->running)
+    {
+      task->removed = TRUE;
+      return;
+    }
+
+  g_queue_unlink (&queues[task->priority], &task->link);
+  task_free (task);
+
+  if (g_hash_table_size (tasks) == 0)
+    scheduler_stop ();
+}
+
+/*
+ * gtk_idle_scheduler_set_priority:
+ * @id: the ID of a task
+ * @priority: the new priority
+ *
+ * Changes the priority of a task, for example when the
+ * content it affects becomes visible.
+ */
+void
+gtk_idle_scheduler_set_priority (guint               id,
+                                 GtkIdleTaskPriority priority)
+{
+  GtkIdleTaskPriority old_priority;
+  Task *task;
+
+  g_return_if_fail (tasks != NULL);
+
+  task = g_hash_table_lookup (tasks, GUINT_TO_POINTER (id));
+  g_return_if_fail (task != NULL);
+
+  if (task->priority == priority)
+    return;
+
+  old_priority = task->priority;
+
+  task->priority = priority;
+
+  /* A running task is requeued when it returns */
+  if (!task->running)
+    {
+      g_queue_unlink (&queues[old_priority], &task->link);
+      g_queue_push_tail_link (&queues[priority], &task->link);
+      scheduler_start ();
+    }
+}
+
+static void
+frame_clock_after_paint (GdkFrameClock *frame_clock,
+                         gpointer       data)
+{
+  last_frame_clock = frame_clock;
+  last_paint_time = g_get_monotonic_time ();
+
+  /* This is the best time to continue */
+  if (waiting_for_frame)
+    scheduler_start ();
+}
+
+/*
+ * gtk_idle_scheduler_add_frame_clock:
+ * @frame_clock: a frame clock
+ *
+ * Makes the scheduler take the frames of @frame_clock
+ * into account when handing out time to tasks.
+ */
+void
+gtk_idle_scheduler_add_frame_clock (GdkFrameClock *frame_clock)
+{
+  g_signal_connect (frame_clock, "after-paint", G_CALLBACK (frame_clock_after_paint), NULL);
+}
+
+void
+gtk_idle_scheduler_remove_frame_clock (GdkFrameClock *frame_clock)
+{
+  g_signal_handlers_disconnect_by_func (frame_clock, frame_clock_after_paint, NULL);
+
+  if (last_frame_clock == frame_clock)
+    last_frame_clock = NULL;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gdk/gdk.h>
+
+G_BEGIN_DECLS
+
+/*
+ * GtkIdleTaskPriority:
+ * @GTK_IDLE_TASK_REDRAW: work that the next frame needs, such as
+ *   validating the visible lines of a text view. These tasks run
+ *   ahead of the frame, like %GTK_TEXT_VIEW_PRIORITY_VALIDATE did
+ * @GTK_IDLE_TASK_VISIBLE: work that affects visible content
+ * @GTK_IDLE_TASK_BACKGROUND: everything else
+ *
+ * The priority of a task.
+ */
+typedef enum
+{
+  GTK_IDLE_TASK_REDRAW,
+  GTK_IDLE_TASK_VISIBLE,
+  GTK_IDLE_TASK_BACKGROUND,
+} GtkIdleTaskPriority;
+
+/*
+ * GtkIdleTaskFunc:
+ * @user_data: the data passed to gtk_idle_scheduler_add()
+ * @deadline: monotonic time in microseconds by which the task
+ *   should return
+ *
+ * Performs a slice of incremental work.
+ *
+ * Returns: %G_SOURCE_CONTINUE if more work is left, %G_SOURCE_REMOVE
+ *   to remove the task
+ */
+typedef gboolean (* GtkIdleTaskFunc) (gpointer user_data,
+                                      gint64   deadline);
+
+guint   gtk_idle_scheduler_add                  (GtkIdleTaskPriority  priority,
+                                                 GtkIdleTaskFunc      func,
+                                                 gpointer             user_data,
+                                                 GDestroyNotify       notify,
+                                                 const char          *name);
+void    gtk_idle_scheduler_remove               (guint                id);
+void    gtk_idle_scheduler_set_priority         (guint                id,
+                                                 GtkIdleTaskPriority  priority);
+
+void    gtk_idle_scheduler_add_frame_clock      (GdkFrameClock       *frame_clock);
+void    gtk_idle_scheduler_remove_frame_clock   (GdkFrameClock       *frame_clock);
+
+G_END_DECLS
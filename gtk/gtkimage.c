@@ -26,7 +26,9 @@
 
 #include "gtkimageprivate.h"
 
+#include "gtkdecodeloadprivate.h"
 #include "gtkiconhelperprivate.h"
+#include "gtkmeasurecacheprivate.h"
 #include "gtkprivate.h"
 #include "gtksnapshot.h"
 #include "gtktypebuiltins.h"
@@ -94,6 +96,10 @@ struct _GtkImage
 
   char *filename;
   char *resource_path;
+
+  GtkDecodeLoad *decode_load;
+  guint load_async : 1;
+  guint load_pending : 1;
 };
 
 struct _GtkImageClass
@@ -105,6 +111,10 @@ struct _GtkImageClass
 static void gtk_image_snapshot             (GtkWidget    *widget,
                                             GtkSnapshot  *snapshot);
 static void gtk_image_unrealize            (GtkWidget    *widget);
+static void gtk_image_root                 (GtkWidget    *widget);
+static void gtk_image_unroot               (GtkWidget    *widget);
+static void gtk_image_map                  (GtkWidget    *widget);
+static void gtk_image_unmap                (GtkWidget    *widget);
 static void gtk_image_measure (GtkWidget      *widget,
                                GtkOrientation  orientation,
                                int            for_size,
@@ -112,6 +122,8 @@ static void gtk_image_measure (GtkWidget      *widget,
                                int           *natural,
                                int           *minimum_baseline,
                                int           *natural_baseline);
+static gboolean gtk_image_measure_key      (GtkWidget    *widget,
+                                            GtkMeasureKey *key);
 
 static void gtk_image_css_changed          (GtkWidget    *widget,
                                             GtkCssStyleChange *change);
@@ -142,6 +154,7 @@ enum
   PROP_GICON,
   PROP_RESOURCE,
   PROP_USE_FALLBACK,
+  PROP_LOAD_ASYNC,
   NUM_PROPERTIES
 };
 
@@ -165,9 +178,15 @@ gtk_image_class_init (GtkImageClass *class)
   widget_class->snapshot = gtk_image_snapshot;
   widget_class->measure = gtk_image_measure;
   widget_class->unrealize = gtk_image_unrealize;
+  widget_class->root = gtk_image_root;
+  widget_class->unroot = gtk_image_unroot;
+  widget_class->map = gtk_image_map;
+  widget_class->unmap = gtk_image_unmap;
   widget_class->css_changed = gtk_image_css_changed;
   widget_class->system_setting_changed = gtk_image_system_setting_changed;
 
+  gtk_widget_class_set_measure_key_func (widget_class, gtk_image_measure_key);
+
   /**
    * GtkImage:paintable: (attributes org.gtk.Property.get=gtk_image_get_paintable org.gtk.Property.set=gtk_image_set_from_paintable)
    *
@@ -274,6 +293,20 @@ gtk_image_class_init (GtkImageClass *class)
                             FALSE,
                             GTK_PARAM_READWRITE|G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkImage:load-async: (attributes org.gtk.Property.get=gtk_image_get_load_async org.gtk.Property.set=gtk_image_set_load_async)
+   *
+   * Whether files are loaded in a thread.
+   *
+   * See [method@Gtk.Image.set_load_async].
+   *
+   * Since: 4.16
+   */
+  image_props[PROP_LOAD_ASYNC] =
+      g_param_spec_boolean ("load-async", NULL, NULL,
+                            FALSE,
+                            GTK_PARAM_READWRITE|G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (gobject_class, NUM_PROPERTIES, image_props);
 
   gtk_widget_class_set_css_name (widget_class, I_("image"));
@@ -343,6 +376,10 @@ gtk_image_set_property (GObject      *object,
         g_object_notify_by_pspec (object, pspec);
       break;
 
+    case PROP_LOAD_ASYNC:
+      gtk_image_set_load_async (image, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -386,6 +423,9 @@ gtk_image_get_property (GObject     *object,
     case PROP_STORAGE_TYPE:
       g_value_set_enum (value, _gtk_icon_helper_get_storage_type (image->icon_helper));
       break;
+    case PROP_LOAD_ASYNC:
+      g_value_set_boolean (value, image->load_async);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -568,6 +608,59 @@ gtk_image_new_from_gicon (GIcon *icon)
   return GTK_WIDGET (image);
 }
 
+static void
+gtk_image_file_loaded (GdkPaintable *paintable,
+                       const GError *error,
+                       gpointer      data)
+{
+  GtkImage *image = data;
+  char *filename;
+
+  /* The load is gone after this callback */
+  image->decode_load = NULL;
+  image->load_pending = FALSE;
+
+  g_object_freeze_notify (G_OBJECT (image));
+
+  /* Keep the filename around, like gtk_image_set_from_file() does */
+  filename = g_steal_pointer (&image->filename);
+
+  if (paintable)
+    {
+      gtk_image_set_from_paintable (image, paintable);
+      image->filename = filename;
+    }
+  else
+    {
+      gtk_image_set_from_icon_name (image, "image-missing");
+      g_free (filename);
+      g_object_notify_by_pspec (G_OBJECT (image), image_props[PROP_FILE]);
+    }
+
+  g_object_thaw_notify (G_OBJECT (image));
+}
+
+static void
+gtk_image_start_load (GtkImage *image)
+{
+  GFile *file;
+
+  g_assert (image->decode_load == NULL);
+
+  /* Load the file the same way gtk_image_set_from_file() does, so
+   * that scalable images are rendered at the scale of the image
+   */
+  file = g_file_new_for_path (image->filename);
+  image->decode_load = gtk_decode_load_start (GTK_WIDGET (image),
+                                              file,
+                                              -1, -1,
+                                              gtk_widget_get_scale_factor (GTK_WIDGET (image)),
+                                              gdk_paintable_load_file_scaled,
+                                              gtk_image_file_loaded,
+                                              image);
+  g_object_unref (file);
+}
+
 /**
  * gtk_image_set_from_file: (attributes org.gtk.Method.set_property=file)
  * @image: a `GtkImage`
@@ -597,6 +690,18 @@ gtk_image_set_from_file (GtkImage    *image,
       return;
     }
 
+  if (image->load_async)
+    {
+      image->filename = g_strdup (filename);
+      image->load_pending = TRUE;
+      if (gtk_widget_get_root (GTK_WIDGET (image)))
+        gtk_image_start_load (image);
+
+      g_object_notify_by_pspec (G_OBJECT (image), image_props[PROP_FILE]);
+      g_object_thaw_notify (G_OBJECT (image));
+      return;
+    }
+
   scale_factor = gtk_widget_get_scale_factor (GTK_WIDGET (image));
   paintable = gdk_paintable_new_from_filename_scaled (filename, scale_factor);
 
@@ -960,6 +1065,52 @@ gtk_image_new (void)
   return g_object_new (GTK_TYPE_IMAGE, NULL);
 }
 
+static void
+gtk_image_root (GtkWidget *widget)
+{
+  GtkImage *image = GTK_IMAGE (widget);
+
+  GTK_WIDGET_CLASS (gtk_image_parent_class)->root (widget);
+
+  if (image->load_pending && image->decode_load == NULL)
+    gtk_image_start_load (image);
+}
+
+static void
+gtk_image_unroot (GtkWidget *widget)
+{
+  GtkImage *image = GTK_IMAGE (widget);
+
+  /* Don't keep loading for an image that nobody sees,
+   * it is started again if the image gets rooted again
+   */
+  g_clear_pointer (&image->decode_load, gtk_decode_load_cancel);
+
+  GTK_WIDGET_CLASS (gtk_image_parent_class)->unroot (widget);
+}
+
+static void
+gtk_image_map (GtkWidget *widget)
+{
+  GtkImage *image = GTK_IMAGE (widget);
+
+  GTK_WIDGET_CLASS (gtk_image_parent_class)->map (widget);
+
+  if (image->decode_load)
+    gtk_decode_load_update_priority (image->decode_load);
+}
+
+static void
+gtk_image_unmap (GtkWidget *widget)
+{
+  GtkImage *image = GTK_IMAGE (widget);
+
+  GTK_WIDGET_CLASS (gtk_image_parent_class)->unmap (widget);
+
+  if (image->decode_load)
+    gtk_decode_load_update_priority (image->decode_load);
+}
+
 static void
 gtk_image_unrealize (GtkWidget *widget)
 {
@@ -1100,6 +1251,9 @@ gtk_image_clear_internal (GtkImage *self,
   GtkImageType storage_type = gtk_image_get_storage_type (self);
   GObject *gobject = G_OBJECT (self);
 
+  g_clear_pointer (&self->decode_load, gtk_decode_load_cancel);
+  self->load_pending = FALSE;
+
   if (notify)
     {
       if (storage_type != GTK_IMAGE_EMPTY)
@@ -1185,6 +1339,21 @@ gtk_image_measure (GtkWidget      *widget,
     }
 }
 
+/* The size only depends on the icon size, not on the icon */
+static gboolean
+gtk_image_measure_key (GtkWidget     *widget,
+                       GtkMeasureKey *key)
+{
+  GtkImage *image = GTK_IMAGE (widget);
+  int pixel_size;
+
+  pixel_size = _gtk_icon_helper_get_pixel_size (image->icon_helper);
+  gtk_measure_key_add_value (key, pixel_size);
+  gtk_measure_key_add_pango_context (key, gtk_widget_get_pango_context (widget));
+
+  return TRUE;
+}
+
 static void
 gtk_image_css_changed (GtkWidget         *widget,
                        GtkCssStyleChange *change)
@@ -1294,3 +1463,52 @@ gtk_image_get_image_size (GtkImage *image,
 {
   *width = *height = gtk_icon_helper_get_size (image->icon_helper);
 }
+
+/**
+ * gtk_image_set_load_async: (attributes org.gtk.Method.set_property=load-async)
+ * @image: a `GtkImage`
+ * @load_async: whether to load files in a thread
+ *
+ * Sets whether files set with [method@Gtk.Image.set_from_file] are
+ * loaded in a thread.
+ *
+ * With this property set, the image stays empty until the file has
+ * been loaded. Images that are in view of their scrolled window are
+ * loaded first, followed by the ones that are about to be scrolled
+ * into view. Loading stops when another file or paintable is set,
+ * like when list items are bound to a different item, and when the
+ * image is removed from its window.
+ *
+ * Since: 4.16
+ */
+void
+gtk_image_set_load_async (GtkImage *image,
+                          gboolean  load_async)
+{
+  g_return_if_fail (GTK_IS_IMAGE (image));
+
+  if (image->load_async == !!load_async)
+    return;
+
+  image->load_async = !!load_async;
+
+  g_object_notify_by_pspec (G_OBJECT (image), image_props[PROP_LOAD_ASYNC]);
+}
+
+/**
+ * gtk_image_get_load_async: (attributes org.gtk.Method.get_property=load-async)
+ * @image: a `GtkImage`
+ *
+ * Returns whether files are loaded in a thread.
+ *
+ * Returns: %TRUE if files are loaded in a thread
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_image_get_load_async (GtkImage *image)
+{
+  g_return_val_if_fail (GTK_IS_IMAGE (image), FALSE);
+
+  return image->load_async;
+}
@@ -125,6 +125,12 @@ int        gtk_image_get_pixel_size (GtkImage             *image);
 GDK_AVAILABLE_IN_ALL
 GtkIconSize gtk_image_get_icon_size (GtkImage             *image);
 
+GDK_AVAILABLE_IN_4_16
+void       gtk_image_set_load_async (GtkImage             *image,
+                                     gboolean              load_async);
+GDK_AVAILABLE_IN_4_16
+gboolean   gtk_image_get_load_async (GtkImage             *image);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GtkImage, g_object_unref)
 
 G_END_DECLS
@@ -24,7 +24,9 @@
 #include "gtkaccessibletextprivate.h"
 #include "gtkcssnodeprivate.h"
 #include "gtkcssstylechangeprivate.h"
+#include "gtkmeasurecacheprivate.h"
 #include "gtkpangoprivate.h"
+#include "gtkpangolayoutcacheprivate.h"
 #include "gtksnapshot.h"
 #include "gtkrenderlayoutprivate.h"
 #include "gtktypebuiltins.h"
@@ -79,6 +81,10 @@ struct _GtkInscription
   GtkInscriptionOverflow overflow;
 
   PangoLayout *layout;
+
+  /* Shaped copy of layout, shared with other widgets via the layout cache */
+  PangoLayout *shaped_layout;
+  guint shaped_layout_serial;
 };
 
 enum
@@ -123,6 +129,7 @@ gtk_inscription_finalize (GObject *object)
   GtkInscription *self = GTK_INSCRIPTION (object);
 
   g_clear_object (&self->layout);
+  g_clear_object (&self->shaped_layout);
 
   G_OBJECT_CLASS (gtk_inscription_parent_class)->finalize (object);
 }
@@ -413,6 +420,44 @@ gtk_inscription_measure (GtkWidget      *widget,
     *natural_baseline = PANGO_PIXELS_CEIL (*natural_baseline);
 }
 
+/* The size of an inscription doesn't depend on its text at all,
+ * so all inscriptions with the same settings share measurements
+ */
+static gboolean
+gtk_inscription_measure_key (GtkWidget     *widget,
+                             GtkMeasureKey *key)
+{
+  GtkInscription *self = GTK_INSCRIPTION (widget);
+
+  gtk_measure_key_add_value (key, self->min_chars);
+  gtk_measure_key_add_value (key, self->nat_chars);
+  gtk_measure_key_add_value (key, self->min_lines);
+  gtk_measure_key_add_value (key, self->nat_lines);
+  gtk_measure_key_add_pango_context (key, gtk_widget_get_pango_context (widget));
+
+  return TRUE;
+}
+
+/* The layout of an inscription is only used to hold its settings.
+ * Shaping happens in a copy that is looked up in the shared layout
+ * cache, so that rows showing the same text don't all shape it again.
+ */
+static PangoLayout *
+gtk_inscription_get_shaped_layout (GtkInscription *self)
+{
+  guint serial = pango_layout_get_serial (self->layout);
+
+  if (self->shaped_layout == NULL || self->shaped_layout_serial != serial)
+    {
+      g_clear_object (&self->shaped_layout);
+      self->shaped_layout = gtk_pango_layout_cache_lookup (self->layout,
+                                                           pango_layout_get_width (self->layout));
+      self->shaped_layout_serial = serial;
+    }
+
+  return self->shaped_layout;
+}
+
 static void
 gtk_inscription_get_layout_location (GtkInscription *self,
                                      float          *x_out,
@@ -421,6 +466,7 @@ gtk_inscription_get_layout_location (GtkInscription *self,
   GtkWidget *widget = GTK_WIDGET (self);
   const int widget_width = gtk_widget_get_width (widget);
   const int widget_height = gtk_widget_get_height (widget);
+  PangoLayout *layout = gtk_inscription_get_shaped_layout (self);
   PangoRectangle logical;
   float xalign;
   int baseline;
@@ -433,8 +479,8 @@ gtk_inscription_get_layout_location (GtkInscription *self,
   if (_gtk_widget_get_direction (widget) != GTK_TEXT_DIR_LTR)
     xalign = 1.0 - xalign;
 
-  pango_layout_get_pixel_extents (self->layout, NULL, &logical);
-  if (pango_layout_get_width (self->layout) > 0)
+  pango_layout_get_pixel_extents (layout, NULL, &logical);
+  if (pango_layout_get_width (layout) > 0)
     x = 0.f;
   else
     x = floor ((xalign * (widget_width - logical.width)) - logical.x);
@@ -442,11 +488,11 @@ gtk_inscription_get_layout_location (GtkInscription *self,
   baseline = gtk_widget_get_baseline (widget);
   if (baseline != -1)
     {
-      int layout_baseline = pango_layout_get_baseline (self->layout) / PANGO_SCALE;
+      int layout_baseline = pango_layout_get_baseline (layout) / PANGO_SCALE;
       /* yalign is 0 because we can't support yalign while baseline aligning */
       y = baseline - layout_baseline;
     }
-  else if (pango_layout_is_ellipsized (self->layout))
+  else if (pango_layout_is_ellipsized (layout))
     {
       y = 0.f;
     }
@@ -477,7 +523,7 @@ gtk_inscription_get_layout_index (GtkInscription *self,
 
   gtk_inscription_get_layout_location (self, &lx, &ly);
 
-  inside = pango_layout_xy_to_index (self->layout,
+  inside = pango_layout_xy_to_index (gtk_inscription_get_shaped_layout (self),
                                      (x - lx) * PANGO_SCALE,
                                      (y - ly) * PANGO_SCALE,
                                      index, &trailing);
@@ -514,7 +560,7 @@ gtk_inscription_allocate (GtkWidget *widget,
        * If we can't fit 2 rows, we're single line.
        */
       {
-        PangoLayoutIter *iter = pango_layout_get_iter (self->layout);
+        PangoLayoutIter *iter = pango_layout_get_iter (gtk_inscription_get_shaped_layout (self));
         if (pango_layout_iter_next_line (iter))
           {
             PangoRectangle rect;
@@ -562,7 +608,7 @@ gtk_inscription_snapshot (GtkWidget   *widget,
   gtk_inscription_get_layout_location (self, &lx, &ly);
 
   gtk_css_boxes_init (&boxes, widget);
-  gtk_css_style_snapshot_layout (&boxes, snapshot, lx, ly, self->layout);
+  gtk_css_style_snapshot_layout (&boxes, snapshot, lx, ly, gtk_inscription_get_shaped_layout (self));
 
   gtk_snapshot_pop (snapshot);
 }
@@ -584,6 +630,8 @@ gtk_inscription_class_init (GtkInscriptionClass *klass)
   widget_class->size_allocate = gtk_inscription_allocate;
   widget_class->snapshot = gtk_inscription_snapshot;
 
+  gtk_widget_class_set_measure_key_func (widget_class, gtk_inscription_measure_key);
+
   /**
    * GtkInscription:attributes: (attributes org.gtk.Property.get=gtk_inscription_get_attributes org.gtk.Property.set=gtk_inscription_set_attributes)
    *
@@ -1483,7 +1531,7 @@ gtk_inscription_accessible_text_get_extents (GtkAccessibleText *self,
   cairo_rectangle_int_t clip_rect;
   int range[2];
 
-  layout = inscription->layout;
+  layout = gtk_inscription_get_shaped_layout (inscription);
   text = inscription->text;
   gtk_inscription_get_layout_location (inscription, &lx, &ly);
 
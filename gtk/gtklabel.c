@@ -39,9 +39,11 @@
 #include "gtkgesturesingle.h"
 #include "gtkjoinedmenuprivate.h"
 #include "gtkmarshalers.h"
+#include "gtkmeasurecacheprivate.h"
 #include "gtknative.h"
 #include "gtknotebook.h"
 #include "gtkpangoprivate.h"
+#include "gtkpangolayoutcacheprivate.h"
 #include "gtkpopovermenu.h"
 #include "gtkprivate.h"
 #include "gtkrenderbackgroundprivate.h"
@@ -978,32 +980,29 @@ nope:
  * @self: the label
  * @existing_layout: %NULL or an existing layout already in use.
  * @width: the width to measure with in pango units, or -1 for infinite
+ * @shared: whether the width is one of the label's own widths, that
+ *   other labels with the same text are likely to measure as well
  *
  * Gets a layout that can be used for measuring sizes.
  *
  * The returned layout will be identical to the label’s layout except for
  * the layout’s width, which will be set to @width. Do not modify the
- * returned layout.
+ * returned layout, it may be shared with other labels.
  *
  * Returns: a new reference to a pango layout
  */
 static PangoLayout *
 gtk_label_get_measuring_layout (GtkLabel    *self,
                                 PangoLayout *existing_layout,
-                                int          width)
+                                int          width,
+                                gboolean     shared)
 {
   PangoLayout *copy;
 
-  if (existing_layout != NULL)
-    {
-      if (existing_layout != self->layout)
-        {
-          pango_layout_set_width (existing_layout, width);
-          return existing_layout;
-        }
-
-      g_object_unref (existing_layout);
-    }
+  /* Measuring layouts other than our own come from the shared layout
+   * cache, so they must not be modified.
+   */
+  g_clear_object (&existing_layout);
 
   gtk_label_ensure_layout (self);
 
@@ -1042,6 +1041,13 @@ gtk_label_get_measuring_layout (GtkLabel    *self,
         return g_object_ref (self->layout);
     }
 
+  /* Labels in list rows often measure the same strings, so share the
+   * shaped layouts between them. Height-for-width probes the label at
+   * widths picked by its parent, which would only flood the cache.
+   */
+  if (shared)
+    return gtk_pango_layout_cache_lookup (self->layout, width);
+
   copy = pango_layout_copy (self->layout);
   pango_layout_set_width (copy, width);
   return copy;
@@ -1112,14 +1118,14 @@ get_static_size (GtkLabel       *self,
 
   get_default_widths (self, &minimum_default, &natural_default);
 
-  layout = gtk_label_get_measuring_layout (self, NULL, self->ellipsize ? natural_default : -1);
+  layout = gtk_label_get_measuring_layout (self, NULL, self->ellipsize ? natural_default : -1, TRUE);
 
   if (orientation == GTK_ORIENTATION_HORIZONTAL)
     {
       pango_layout_get_size (layout, natural, NULL);
       if (self->ellipsize)
         {
-          layout = gtk_label_get_measuring_layout (self, layout, 0);
+          layout = gtk_label_get_measuring_layout (self, layout, 0, TRUE);
           pango_layout_get_size (layout, minimum, NULL);
           /* yes, Pango ellipsizes even when that needs more space */
           *minimum = MIN (*minimum, *natural);
@@ -1157,7 +1163,7 @@ get_height_for_width (GtkLabel *self,
   if (width < 0)
     {
       /* Minimum height is assuming infinite width */
-      layout = gtk_label_get_measuring_layout (self, NULL, -1);
+      layout = gtk_label_get_measuring_layout (self, NULL, -1, TRUE);
       pango_layout_get_size (layout, NULL, minimum_height);
       baseline = pango_layout_get_baseline (layout);
       *minimum_baseline = baseline;
@@ -1165,7 +1171,7 @@ get_height_for_width (GtkLabel *self,
       /* Natural height is assuming natural width */
       get_default_widths (self, NULL, &natural_width);
 
-      layout = gtk_label_get_measuring_layout (self, layout, natural_width);
+      layout = gtk_label_get_measuring_layout (self, layout, natural_width, TRUE);
       pango_layout_get_size (layout, NULL, natural_height);
       baseline = pango_layout_get_baseline (layout);
       *natural_baseline = baseline;
@@ -1173,7 +1179,7 @@ get_height_for_width (GtkLabel *self,
   else
     {
       /* minimum = natural for any given width */
-      layout = gtk_label_get_measuring_layout (self, NULL, width);
+      layout = gtk_label_get_measuring_layout (self, NULL, width, FALSE);
 
       pango_layout_get_size (layout, NULL, &text_height);
 
@@ -1230,12 +1236,12 @@ get_width_for_height (GtkLabel *self,
   if (height < 0)
     {
       /* Minimum width is as many line breaks as possible */
-      layout = gtk_label_get_measuring_layout (self, NULL, MAX (minimum_default, 0));
+      layout = gtk_label_get_measuring_layout (self, NULL, MAX (minimum_default, 0), TRUE);
       pango_layout_get_size (layout, minimum_width, NULL);
       *minimum_width = MAX (*minimum_width, minimum_default);
 
       /* Natural width is natural width - or as wide as possible */
-      layout = gtk_label_get_measuring_layout (self, layout, natural_default);
+      layout = gtk_label_get_measuring_layout (self, layout, natural_default, TRUE);
       pango_layout_get_size (layout, natural_width, NULL);
       *natural_width = MAX (*natural_width, *minimum_width);
     }
@@ -1272,7 +1278,7 @@ get_width_for_height (GtkLabel *self,
       if (self->ellipsize != PANGO_ELLIPSIZE_NONE)
         {
           g_object_unref (layout);
-          layout = gtk_label_get_measuring_layout (self, NULL, MAX (minimum_default, 0));
+          layout = gtk_label_get_measuring_layout (self, NULL, MAX (minimum_default, 0), TRUE);
           pango_layout_get_size (layout, minimum_width, NULL);
           *minimum_width = MAX (*minimum_width, minimum_default);
         }
@@ -1319,6 +1325,39 @@ gtk_label_measure (GtkWidget      *widget,
     *natural_baseline = PANGO_PIXELS_CEIL (*natural_baseline);
 }
 
+static gboolean
+gtk_label_measure_key (GtkWidget     *widget,
+                       GtkMeasureKey *key)
+{
+  GtkLabel *self = GTK_LABEL (widget);
+  guint flags;
+
+  gtk_measure_key_add_string (key, self->text);
+  gtk_measure_key_add_attr_list (key, self->markup_attrs);
+  gtk_measure_key_add_attr_list (key, self->attrs);
+
+  if (self->tabs)
+    {
+      char *tabs = pango_tab_array_to_string (self->tabs);
+      gtk_measure_key_add_string (key, tabs);
+      g_free (tabs);
+    }
+
+  flags = self->wrap |
+          self->ellipsize << 1 |
+          self->wrap_mode << 4 |
+          self->natural_wrap_mode << 7 |
+          self->single_line_mode << 10 |
+          self->jtype << 11;
+  gtk_measure_key_add_value (key, flags);
+  gtk_measure_key_add_value (key, self->width_chars);
+  gtk_measure_key_add_value (key, self->max_width_chars);
+  gtk_measure_key_add_value (key, self->lines);
+  gtk_measure_key_add_pango_context (key, gtk_widget_get_pango_context (widget));
+
+  return TRUE;
+}
+
 static void
 get_layout_location (GtkLabel  *self,
                      float     *xp,
@@ -2250,6 +2289,8 @@ gtk_label_class_init (GtkLabelClass *class)
   widget_class->get_request_mode = gtk_label_get_request_mode;
   widget_class->measure = gtk_label_measure;
 
+  gtk_widget_class_set_measure_key_func (widget_class, gtk_label_measure_key);
+
   class->move_cursor = gtk_label_move_cursor;
   class->copy_clipboard = gtk_label_copy_clipboard;
   class->activate_link = gtk_label_activate_link;
@@ -0,0 +1,539 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtklayoutstatsprivate.h"
+
+#include "gdk/gdkprofilerprivate.h"
+
+/* Counts and times measuring, allocating, style validation and
+ * snapshotting per widget type, along with size request cache
+ * hits and the widgets that queue resizes.
+ *
+ * This only runs while the inspector shows the numbers or the
+ * profiler is running, and costs a single check otherwise.
+ *
+ * Frames are kept per frame clock, from its before-paint to its
+ * after-paint signal, since each window paints on its own. Work that
+ * happens between frames, like resizes queued by event handlers, is
+ * counted for the next frame that starts.
+ *
+ * Times are taken with g_get_monotonic_time(), so they are coarse
+ * for individual calls, but add up fine over a frame. Nested calls,
+ * like the measuring of children during the measuring of their
+ * parent, are subtracted from the parent, so the time of a type is
+ * what its own code took.
+ */
+
+gboolean gtk_layout_stats_running;
+
+static guint n_users;
+
+static GHashTable *entries;
+static GArray *child_times;
+
+typedef struct
+{
+  GtkLayoutStatsEntry frame;
+  GtkLayoutStatsEntry last_frame;
+  gint64 last_frame_counter;
+  gint64 start;
+} FrameStats;
+
+static GQuark frame_stats_quark;
+static GPtrArray *all_frame_stats;
+static FrameStats *current_frame;
+static GtkLayoutStatsEntry pending_frame;
+static guint64 n_frames;
+
+static const char *phase_names[GTK_LAYOUT_STATS_N_PHASES] = {
+  "measure",
+  "allocate",
+  "css",
+  "snapshot",
+};
+
+static guint phase_count_counters[GTK_LAYOUT_STATS_N_PHASES];
+static guint phase_time_counters[GTK_LAYOUT_STATS_N_PHASES];
+static guint cache_misses_counter;
+static guint queue_resizes_counter;
+
+static void
+update_running (void)
+{
+  gtk_layout_stats_running = n_users > 0 || GDK_PROFILER_IS_RUNNING;
+
+  if (gtk_layout_stats_running && entries == NULL)
+    {
+      entries = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+      child_times = g_array_new (FALSE, TRUE, sizeof (gint64));
+    }
+}
+
+static void
+frame_stats_free (gpointer data)
+{
+  FrameStats *stats = data;
+
+  if (current_frame == stats)
+    current_frame = NULL;
+
+  g_ptr_array_remove (all_frame_stats, stats);
+  g_free (stats);
+}
+
+static FrameStats *
+get_frame_stats (GdkFrameClock *frame_clock)
+{
+  FrameStats *stats;
+
+  if (G_UNLIKELY (frame_stats_quark == 0))
+    {
+      frame_stats_quark = g_quark_from_static_string ("gtk-layout-stats");
+      all_frame_stats = g_ptr_array_new ();
+    }
+
+  stats = g_object_get_qdata (G_OBJECT (frame_clock), frame_stats_quark);
+  if (stats)
+    return stats;
+
+  stats = g_new0 (FrameStats, 1);
+  stats->last_frame_counter = -1;
+  g_ptr_array_add (all_frame_stats, stats);
+  g_object_set_qdata_full (G_OBJECT (frame_clock), frame_stats_quark, stats, frame_stats_free);
+
+  return stats;
+}
+
+static inline GtkLayoutStatsEntry *
+get_frame (void)
+{
+  return current_frame ? &current_frame->frame : &pending_frame;
+}
+
+static void
+add_entry (GtkLayoutStatsEntry       *entry,
+           const GtkLayoutStatsEntry *other)
+{
+  guint i;
+
+  for (i = 0; i < GTK_LAYOUT_STATS_N_PHASES; i++)
+    {
+      entry->count[i] += other->count[i];
+      entry->time[i] += other->time[i];
+    }
+  entry->n_cache_hits += other->n_cache_hits;
+  entry->n_cache_misses += other->n_cache_misses;
+  entry->n_queue_resizes += other->n_queue_resizes;
+}
+
+static GtkLayoutStatsEntry *
+get_entry (GType type)
+{
+  GtkLayoutStatsEntry *entry;
+
+  entry = g_hash_table_lookup (entries, GSIZE_TO_POINTER (type));
+  if (entry == NULL)
+    {
+      entry = g_new0 (GtkLayoutStatsEntry, 1);
+      entry->type = type;
+      g_hash_table_insert (entries, GSIZE_TO_POINTER (type), entry);
+    }
+
+  return entry;
+}
+
+gint64
+gtk_layout_stats_push (void)
+{
+  gint64 zero = 0;
+
+  g_array_append_val (child_times, zero);
+
+  return g_get_monotonic_time ();
+}
+
+void
+gtk_layout_stats_pop (gint64               start,
+                      GtkLayoutStatsPhase  phase,
+                      GType                type)
+{
+  GtkLayoutStatsEntry *entry, *frame;
+  gint64 total, self;
+
+  g_return_if_fail (child_times->len > 0);
+
+  total = g_get_monotonic_time () - start;
+  self = total - g_array_index (child_times, gint64, child_times->len - 1);
+  g_array_set_size (child_times, child_times->len - 1);
+
+  if (child_times->len > 0)
+    g_array_index (child_times, gint64, child_times->len - 1) += total;
+
+  entry = get_entry (type);
+  entry->count[phase]++;
+  entry->time[phase] += self;
+
+  frame = get_frame ();
+  frame->count[phase]++;
+  frame->time[phase] += self;
+}
+
+void
+gtk_layout_stats_record_cache (GType    type,
+                               gboolean hit)
+{
+  GtkLayoutStatsEntry *entry = get_entry (type);
+  GtkLayoutStatsEntry *frame = get_frame ();
+
+  if (hit)
+    {
+      entry->n_cache_hits++;
+      frame->n_cache_hits++;
+    }
+  else
+    {
+      entry->n_cache_misses++;
+      frame->n_cache_misses++;
+    }
+}
+
+void
+gtk_layout_stats_record_queue_resize (GType type)
+{
+  get_entry (type)->n_queue_resizes++;
+  get_frame ()->n_queue_resizes++;
+}
+
+static void
+ensure_counters (void)
+{
+  guint i;
+
+  if (queue_resizes_counter != 0)
+    return;
+
+  for (i = 0; i < GTK_LAYOUT_STATS_N_PHASES; i++)
+    {
+      char *name, *description;
+
+      name = g_strdup_printf ("layout-%s-calls", phase_names[i]);
+      description = g_strdup_printf ("Widget %s calls per frame", phase_names[i]);
+      phase_count_counters[i] = gdk_profiler_define_int_counter (g_intern_string (name), g_intern_string (description));
+      g_free (name);
+      g_free (description);
+
+      name = g_strdup_printf ("layout-%s-time", phase_names[i]);
+      description = g_strdup_printf ("Microseconds of widget %s per frame", phase_names[i]);
+      phase_time_counters[i] = gdk_profiler_define_int_counter (g_intern_string (name), g_intern_string (description));
+      g_free (name);
+      g_free (description);
+    }
+
+  cache_misses_counter = gdk_profiler_define_int_counter ("layout-cache-misses", "Size request cache misses per frame");
+  queue_resizes_counter = gdk_profiler_define_int_counter ("layout-queue-resizes", "Resizes queued per frame");
+}
+
+/*
+ * gtk_layout_stats_frame_begin:
+ * @frame_clock: the `GdkFrameClock` that starts painting
+ *
+ * Starts a frame of @frame_clock, called before a window is painted.
+ * Windows that share a frame clock share their frames.
+ */
+void
+gtk_layout_stats_frame_begin (GdkFrameClock *frame_clock)
+{
+  FrameStats *stats;
+
+  /* The profiler may have been started or stopped */
+  update_running ();
+
+  if (!gtk_layout_stats_running)
+    return;
+
+  stats = get_frame_stats (frame_clock);
+  if (current_frame == stats)
+    return;
+
+  current_frame = stats;
+  add_entry (&stats->frame, &pending_frame);
+  memset (&pending_frame, 0, sizeof (pending_frame));
+  stats->start = GDK_PROFILER_CURRENT_TIME;
+}
+
+/*
+ * gtk_layout_stats_frame_done:
+ * @frame_clock: the `GdkFrameClock` that was painted
+ *
+ * Ends the current frame of @frame_clock, called after a window
+ * was painted.
+ */
+void
+gtk_layout_stats_frame_done (GdkFrameClock *frame_clock)
+{
+  FrameStats *stats;
+  GtkLayoutStatsEntry *frame;
+  gint64 frame_counter;
+
+  update_running ();
+
+  if (!gtk_layout_stats_running)
+    {
+      current_frame = NULL;
+      return;
+    }
+
+  stats = get_frame_stats (frame_clock);
+
+  /* Another window on the same frame clock ended it already */
+  frame_counter = gdk_frame_clock_get_frame_counter (frame_clock);
+  if (stats->last_frame_counter == frame_counter)
+    return;
+
+  frame = &stats->frame;
+
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      guint i;
+
+      ensure_counters ();
+
+      for (i = 0; i < GTK_LAYOUT_STATS_N_PHASES; i++)
+        {
+          gdk_profiler_set_int_counter (phase_count_counters[i], frame->count[i]);
+          gdk_profiler_set_int_counter (phase_time_counters[i], frame->time[i]);
+        }
+      gdk_profiler_set_int_counter (cache_misses_counter, frame->n_cache_misses);
+      gdk_profiler_set_int_counter (queue_resizes_counter, frame->n_queue_resizes);
+
+      if (stats->start != 0)
+        gdk_profiler_end_markf (stats->start, "Layout stats",
+                                "measure %" G_GUINT64_FORMAT " (%.2f ms), "
+                                "allocate %" G_GUINT64_FORMAT " (%.2f ms), "
+                                "css %" G_GUINT64_FORMAT " (%.2f ms), "
+                                "snapshot %" G_GUINT64_FORMAT " (%.2f ms), "
+                                "%" G_GUINT64_FORMAT " queued resizes",
+                                frame->count[GTK_LAYOUT_STATS_MEASURE], frame->time[GTK_LAYOUT_STATS_MEASURE] / 1000.,
+                                frame->count[GTK_LAYOUT_STATS_ALLOCATE], frame->time[GTK_LAYOUT_STATS_ALLOCATE] / 1000.,
+                                frame->count[GTK_LAYOUT_STATS_CSS], frame->time[GTK_LAYOUT_STATS_CSS] / 1000.,
+                                frame->count[GTK_LAYOUT_STATS_SNAPSHOT], frame->time[GTK_LAYOUT_STATS_SNAPSHOT] / 1000.,
+                                frame->n_queue_resizes);
+    }
+
+  stats->last_frame = *frame;
+  stats->last_frame_counter = frame_counter;
+  memset (frame, 0, sizeof (GtkLayoutStatsEntry));
+  stats->start = 0;
+  n_frames++;
+
+  if (current_frame == stats)
+    current_frame = NULL;
+}
+
+/*
+ * gtk_layout_stats_enable:
+ *
+ * Starts recording. Every call must be paired with a call
+ * to gtk_layout_stats_disable().
+ */
+void
+gtk_layout_stats_enable (void)
+{
+  n_users++;
+  update_running ();
+}
+
+void
+gtk_layout_stats_disable (void)
+{
+  g_return_if_fail (n_users > 0);
+
+  n_users--;
+  update_running ();
+}
+
+void
+gtk_layout_stats_reset (void)
+{
+  if (entries)
+    g_hash_table_remove_all (entries);
+
+  if (all_frame_stats)
+    {
+      guint i;
+
+      for (i = 0; i < all_frame_stats->len; i++)
+        {
+          FrameStats *stats = g_ptr_array_index (all_frame_stats, i);
+
+          memset (&stats->frame, 0, sizeof (GtkLayoutStatsEntry));
+          memset (&stats->last_frame, 0, sizeof (GtkLayoutStatsEntry));
+        }
+    }
+
+  memset (&pending_frame, 0, sizeof (pending_frame));
+  n_frames = 0;
+}
+
+static int
+compare_entries (gconstpointer a,
+                 gconstpointer b)
+{
+  const GtkLayoutStatsEntry *entry1 = a;
+  const GtkLayoutStatsEntry *entry2 = b;
+  gint64 time1 = 0, time2 = 0;
+  guint i;
+
+  for (i = 0; i < GTK_LAYOUT_STATS_N_PHASES; i++)
+    {
+      time1 += entry1->time[i];
+      time2 += entry2->time[i];
+    }
+
+  if (time1 != time2)
+    return time1 < time2 ? 1 : -1;
+
+  return g_strcmp0 (g_type_name (entry1->type), g_type_name (entry2->type));
+}
+
+/*
+ * gtk_layout_stats_get_entries:
+ * @n_entries: (out): return location for the number of entries
+ *
+ * Gets the numbers for all types that were recorded, the
+ * most expensive first.
+ *
+ * Returns: (transfer full): the entries, free with g_free()
+ */
+GtkLayoutStatsEntry *
+gtk_layout_stats_get_entries (guint *n_entries)
+{
+  GtkLayoutStatsEntry *result;
+  GHashTableIter iter;
+  gpointer value;
+  guint i;
+
+  if (entries == NULL)
+    {
+      *n_entries = 0;
+      return NULL;
+    }
+
+  *n_entries = g_hash_table_size (entries);
+  result = g_new (GtkLayoutStatsEntry, *n_entries);
+
+  i = 0;
+  g_hash_table_iter_init (&iter, entries);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    result[i++] = *(GtkLayoutStatsEntry *) value;
+
+  qsort (result, *n_entries, sizeof (GtkLayoutStatsEntry), compare_entries);
+
+  return result;
+}
+
+/*
+ * gtk_layout_stats_get_last_frame:
+ * @frame_clock: a `GdkFrameClock`
+ * @result: (out caller-allocates): return location for the numbers
+ *
+ * Gets the numbers of all types added up for the last frame
+ * of @frame_clock that was completed.
+ */
+void
+gtk_layout_stats_get_last_frame (GdkFrameClock       *frame_clock,
+                                 GtkLayoutStatsEntry *result)
+{
+  FrameStats *stats = NULL;
+
+  if (frame_stats_quark != 0)
+    stats = g_object_get_qdata (G_OBJECT (frame_clock), frame_stats_quark);
+
+  if (stats)
+    *result = stats->last_frame;
+  else
+    memset (result, 0, sizeof (GtkLayoutStatsEntry));
+}
+
+static void
+append_entry (GString                   *str,
+              const GtkLayoutStatsEntry *entry)
+{
+  guint i;
+
+  for (i = 0; i < GTK_LAYOUT_STATS_N_PHASES; i++)
+    g_string_append_printf (str,
+                            "\"%s\": { \"count\": %" G_GUINT64_FORMAT ", \"time-us\": %" G_GINT64_FORMAT " }, ",
+                            phase_names[i], entry->count[i], entry->time[i]);
+
+  g_string_append_printf (str,
+                          "\"cache-hits\": %" G_GUINT64_FORMAT ", "
+                          "\"cache-misses\": %" G_GUINT64_FORMAT ", "
+                          "\"queue-resizes\": %" G_GUINT64_FORMAT,
+                          entry->n_cache_hits, entry->n_cache_misses, entry->n_queue_resizes);
+}
+
+/*
+ * gtk_layout_stats_to_json:
+ *
+ * Serializes everything that was recorded, for looking
+ * at it in other tools.
+ *
+ * Returns: (transfer full): the numbers as JSON
+ */
+char *
+gtk_layout_stats_to_json (void)
+{
+  GtkLayoutStatsEntry *result;
+  GString *str;
+  guint i, n;
+
+  str = g_string_new ("{\n");
+
+  g_string_append_printf (str, "  \"frames\": %" G_GUINT64_FORMAT ",\n", n_frames);
+
+  /* One entry per frame clock, so per toplevel */
+  g_string_append (str, "  \"last-frames\": [\n");
+  n = all_frame_stats ? all_frame_stats->len : 0;
+  for (i = 0; i < n; i++)
+    {
+      FrameStats *stats = g_ptr_array_index (all_frame_stats, i);
+
+      g_string_append (str, "    { ");
+      append_entry (str, &stats->last_frame);
+      g_string_append (str, i + 1 < n ? " },\n" : " }\n");
+    }
+  g_string_append (str, "  ],\n");
+
+  g_string_append (str, "  \"types\": [\n");
+
+  result = gtk_layout_stats_get_entries (&n);
+  for (i = 0; i < n; i++)
+    {
+      /* Type names are C identifiers, no escaping needed */
+      g_string_append_printf (str, "    { \"type\": \"%s\", ", g_type_name (result[i].type));
+      append_entry (str, &result[i]);
+      g_string_append (str, i + 1 < n ? " },\n" : " }\n");
+    }
+  g_free (result);
+
+  g_string_append (str, "  ]\n}\n");
+
+  return g_string_free (str, FALSE);
+}
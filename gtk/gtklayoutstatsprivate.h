@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gdk/gdk.h>
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+  GTK_LAYOUT_STATS_MEASURE,
+  GTK_LAYOUT_STATS_ALLOCATE,
+  GTK_LAYOUT_STATS_CSS,
+  GTK_LAYOUT_STATS_SNAPSHOT,
+} GtkLayoutStatsPhase;
+
+#define GTK_LAYOUT_STATS_N_PHASES (GTK_LAYOUT_STATS_SNAPSHOT + 1)
+
+typedef struct _GtkLayoutStatsEntry GtkLayoutStatsEntry;
+
+struct _GtkLayoutStatsEntry
+{
+  GType   type;
+  guint64 count[GTK_LAYOUT_STATS_N_PHASES];
+  /* in microseconds, without the time spent in children */
+  gint64  time[GTK_LAYOUT_STATS_N_PHASES];
+  guint64 n_cache_hits;
+  guint64 n_cache_misses;
+  guint64 n_queue_resizes;
+};
+
+extern gboolean gtk_layout_stats_running;
+
+#define GTK_LAYOUT_STATS_IS_RUNNING (G_UNLIKELY (gtk_layout_stats_running))
+
+gint64                  gtk_layout_stats_push                   (void);
+void                    gtk_layout_stats_pop                    (gint64               start,
+                                                                 GtkLayoutStatsPhase  phase,
+                                                                 GType                type);
+void                    gtk_layout_stats_record_cache           (GType                type,
+                                                                 gboolean             hit);
+void                    gtk_layout_stats_record_queue_resize    (GType                type);
+
+void                    gtk_layout_stats_frame_begin            (GdkFrameClock       *frame_clock);
+void                    gtk_layout_stats_frame_done             (GdkFrameClock       *frame_clock);
+
+void                    gtk_layout_stats_enable                 (void);
+void                    gtk_layout_stats_disable                (void);
+void                    gtk_layout_stats_reset                  (void);
+GtkLayoutStatsEntry *   gtk_layout_stats_get_entries            (guint               *n_entries);
+void                    gtk_layout_stats_get_last_frame         (GdkFrameClock       *frame_clock,
+                                                                 GtkLayoutStatsEntry *frame);
+char *                  gtk_layout_stats_to_json                (void);
+
+/* Returns a start time to pass to gtk_layout_stats_end(),
+ * or 0 if nothing is being recorded
+ */
+static inline gint64
+gtk_layout_stats_begin (void)
+{
+  if (GTK_LAYOUT_STATS_IS_RUNNING)
+    return gtk_layout_stats_push ();
+
+  return 0;
+}
+
+static inline void
+gtk_layout_stats_end (gint64               start,
+                      GtkLayoutStatsPhase  phase,
+                      GType                type)
+{
+  if (start != 0)
+    gtk_layout_stats_pop (start, phase, type);
+}
+
+G_END_DECLS
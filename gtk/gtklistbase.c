@@ -30,6 +30,7 @@
 #include "gtkdropcontrollermotion.h"
 #include "gtkgesturedrag.h"
 #include "gtkgizmoprivate.h"
+#include "gtkidleschedulerprivate.h"
 #include "gtklistitemwidgetprivate.h"
 #include "gtkmultiselection.h"
 #include "gtkorientable.h"
@@ -40,6 +41,10 @@
 #include "gtktypebuiltins.h"
 #include "gtkwidgetprivate.h"
 
+#include "gdk/gdkprofilerprivate.h"
+
+#include <math.h>
+
 /* Allow shadows to overdraw without immediately culling the widget at the viewport
  * boundary.
  * Choose this so that roughly 1 extra widget gets drawn on each side of the viewport,
@@ -60,6 +65,20 @@ struct _RubberbandData
   double pointer_x, pointer_y;                  /* mouse coordinates in widget space */
 };
 
+/* How far ahead of the scroll direction to prepare rows */
+#define PREFETCH_TIME_US (250 * 1000)
+/* Never keep more rows than this around for prefetching */
+#define PREFETCH_MAX_ITEMS 200
+/* Rows added to the prefetched range in one step */
+#define PREFETCH_STEP 4
+/* Rows added to the prefetched range between two frames. They are all
+ * measured when the list is allocated, so this bounds the extra work
+ * prefetching adds to a frame.
+ */
+#define PREFETCH_FRAME_ITEMS 16
+/* Give the prefetched rows back when scrolling stopped for this long */
+#define PREFETCH_TIMEOUT_MS 500
+
 typedef struct _GtkListBasePrivate GtkListBasePrivate;
 
 struct _GtkListBasePrivate
@@ -83,6 +102,17 @@ struct _GtkListBasePrivate
   /* the item that has input focus */
   GtkListItemTracker *focus;
 
+  /* rows prepared ahead of the scroll direction */
+  GtkListItemTracker *prefetch;
+  guint prefetch_items;
+  guint prefetch_frame_items;
+  guint prefetch_task_id;
+  guint prefetch_timeout_id;
+  /* scroll speed along the list in items per second */
+  double velocity;
+  guint last_scroll_pos;
+  gint64 last_scroll_time;
+
   gboolean enable_rubberband;
   GtkGesture *drag_gesture;
   RubberbandData *rubberband;
@@ -179,6 +209,182 @@ gtk_list_base_get_adjustment_values (GtkListBase    *self,
     *page_size = ps;
 }
 
+static void
+gtk_list_base_stop_prefetch (GtkListBase *self)
+{
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+
+  g_clear_handle_id (&priv->prefetch_task_id, gtk_idle_scheduler_remove);
+  g_clear_handle_id (&priv->prefetch_timeout_id, g_source_remove);
+
+  if (priv->prefetch)
+    {
+      gtk_list_item_tracker_free (priv->item_manager, priv->prefetch);
+      priv->prefetch = NULL;
+    }
+
+  priv->prefetch_items = 0;
+  priv->velocity = 0;
+}
+
+static guint
+gtk_list_base_get_prefetch_target (GtkListBase *self)
+{
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+
+  return MIN (PREFETCH_MAX_ITEMS, fabs (priv->velocity) * PREFETCH_TIME_US / G_USEC_PER_SEC);
+}
+
+/* Moves the prefetch tracker to the edge of the rows kept alive
+ * by the anchor, looking ahead in the scroll direction */
+static void
+gtk_list_base_update_prefetch (GtkListBase *self)
+{
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+  guint anchor_pos, items_before, items_after;
+
+  anchor_pos = gtk_list_item_tracker_get_position (priv->item_manager, priv->anchor);
+  if (anchor_pos == GTK_INVALID_LIST_POSITION)
+    return;
+
+  if (priv->prefetch == NULL)
+    {
+      priv->prefetch = gtk_list_item_tracker_new (priv->item_manager);
+      /* Prefetched rows are offscreen, they can wait for their bind */
+      gtk_list_item_tracker_set_defer_binding (priv->item_manager, priv->prefetch, TRUE);
+    }
+
+  items_before = round (priv->center_widgets * CLAMP (priv->anchor_align_along, 0, 1));
+  items_after = priv->center_widgets - items_before + priv->above_below_widgets;
+  items_before += priv->above_below_widgets;
+
+  if (priv->velocity >= 0)
+    gtk_list_item_tracker_set_position (priv->item_manager,
+                                        priv->prefetch,
+                                        anchor_pos + items_after,
+                                        0,
+                                        priv->prefetch_items);
+  else
+    gtk_list_item_tracker_set_position (priv->item_manager,
+                                        priv->prefetch,
+                                        anchor_pos - MIN (anchor_pos, items_before),
+                                        priv->prefetch_items,
+                                        0);
+}
+
+static gboolean
+gtk_list_base_prefetch_cb (gpointer data,
+                           gint64   deadline)
+{
+  GtkListBase *self = data;
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+  guint target;
+  gint64 before G_GNUC_UNUSED;
+
+  before = GDK_PROFILER_CURRENT_TIME;
+
+  target = gtk_list_base_get_prefetch_target (self);
+
+  /* Grow in small steps, so that we stay within the budget */
+  while (priv->prefetch_items < target &&
+         priv->prefetch_frame_items < PREFETCH_FRAME_ITEMS &&
+         g_get_monotonic_time () < deadline)
+    {
+      guint n_items = MIN (target, priv->prefetch_items + PREFETCH_STEP);
+
+      priv->prefetch_frame_items += n_items - priv->prefetch_items;
+      priv->prefetch_items = n_items;
+      gtk_list_base_update_prefetch (self);
+    }
+
+  gdk_profiler_end_markf (before, "Prefetch rows", "%u of %u", priv->prefetch_items, target);
+
+  /* If this frame has enough new rows, gtk_list_base_allocate()
+   * queues us again
+   */
+  if (priv->prefetch_items < target &&
+      priv->prefetch_frame_items < PREFETCH_FRAME_ITEMS)
+    return G_SOURCE_CONTINUE;
+
+  priv->prefetch_task_id = 0;
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gtk_list_base_queue_prefetch (GtkListBase *self)
+{
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+
+  if (priv->prefetch_items < gtk_list_base_get_prefetch_target (self) &&
+      priv->prefetch_frame_items < PREFETCH_FRAME_ITEMS &&
+      priv->prefetch_task_id == 0)
+    priv->prefetch_task_id = gtk_idle_scheduler_add (GTK_IDLE_TASK_BACKGROUND,
+                                                     gtk_list_base_prefetch_cb,
+                                                     self,
+                                                     NULL,
+                                                     "Prefetch list rows");
+}
+
+static gboolean
+gtk_list_base_prefetch_timeout_cb (gpointer data)
+{
+  GtkListBase *self = data;
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+
+  priv->prefetch_timeout_id = 0;
+  gtk_list_base_stop_prefetch (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gtk_list_base_update_velocity (GtkListBase *self,
+                               guint        pos)
+{
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+  gint64 now, dt;
+  double velocity;
+  int delta;
+  gboolean reversed;
+
+  now = g_get_monotonic_time ();
+  dt = now - priv->last_scroll_time;
+  delta = (int) pos - (int) priv->last_scroll_pos;
+
+  priv->last_scroll_pos = pos;
+  priv->last_scroll_time = now;
+
+  if (delta == 0 || dt <= 0)
+    return;
+
+  /* Jumps are not scrolling, and a long pause means we start over */
+  if (ABS (delta) > priv->center_widgets + 2 * priv->above_below_widgets ||
+      dt > PREFETCH_TIMEOUT_MS * 1000)
+    {
+      gtk_list_base_stop_prefetch (self);
+      return;
+    }
+
+  velocity = (double) delta * G_USEC_PER_SEC / dt;
+  reversed = (velocity < 0) != (priv->velocity < 0);
+  if (reversed)
+    priv->velocity = velocity;
+  else
+    priv->velocity = 0.7 * priv->velocity + 0.3 * velocity;
+
+  if (reversed)
+    priv->prefetch_items = 0;
+  else
+    priv->prefetch_items = MIN (priv->prefetch_items, gtk_list_base_get_prefetch_target (self));
+
+  gtk_list_base_update_prefetch (self);
+  gtk_list_base_queue_prefetch (self);
+
+  g_clear_handle_id (&priv->prefetch_timeout_id, g_source_remove);
+  priv->prefetch_timeout_id = g_timeout_add (PREFETCH_TIMEOUT_MS, gtk_list_base_prefetch_timeout_cb, self);
+  gdk_source_set_static_name_by_id (priv->prefetch_timeout_id, "[gtk] list_prefetch_timeout");
+}
+
 static void
 gtk_list_base_adjustment_value_changed_cb (GtkAdjustment *adjustment,
                                            GtkListBase   *self)
@@ -258,6 +464,9 @@ gtk_list_base_adjustment_value_changed_cb (GtkAdjustment *adjustment,
                             align_across, side_across,
                             align_along, side_along);
 
+  if (adjustment == priv->adjustment[priv->orientation])
+    gtk_list_base_update_velocity (self, pos);
+
   gtk_widget_queue_allocate (GTK_WIDGET (self));
 }
 
@@ -681,6 +890,7 @@ gtk_list_base_dispose (GObject *object)
       gtk_list_item_tracker_free (priv->item_manager, priv->focus);
       priv->focus = NULL;
     }
+  gtk_list_base_stop_prefetch (self);
   g_clear_object (&priv->item_manager);
 
   g_clear_object (&priv->model);
@@ -914,6 +1124,8 @@ gtk_list_base_scroll_to_item (GtkListBase   *self,
                             pos,
                             align_across, side_across,
                             align_along, side_along);
+  /* The item was asked for, so it shouldn't show up as a placeholder */
+  gtk_list_item_tracker_bind_now (priv->item_manager, priv->anchor);
 
   g_clear_pointer (&scroll, gtk_scroll_info_unref);
 }
@@ -2002,6 +2214,8 @@ gtk_list_base_init_real (GtkListBase      *self,
                                                   gtk_list_base_prepare_section_func,
                                                   gtk_list_base_create_header_widget_func);
   priv->anchor = gtk_list_item_tracker_new (priv->item_manager);
+  /* The anchor follows scrolling, its rows can wait for their bind */
+  gtk_list_item_tracker_set_defer_binding (priv->item_manager, priv->anchor, TRUE);
   priv->anchor_side_along = GTK_PACK_START;
   priv->anchor_side_across = GTK_PACK_START;
   priv->selected = gtk_list_item_tracker_new (priv->item_manager);
@@ -2110,17 +2324,43 @@ gtk_list_base_update_adjustments (GtkListBase *self)
                                        page_along);
 }
 
+static void
+gtk_list_base_update_bind_center (GtkListBase *self)
+{
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+  int value_across, page_across, value_along, page_along;
+
+  if (!gtk_list_item_manager_get_deferred_binding (priv->item_manager))
+    return;
+
+  gtk_list_base_get_adjustment_values (self, OPPOSITE_ORIENTATION (priv->orientation), &value_across, NULL, &page_across);
+  gtk_list_base_get_adjustment_values (self, priv->orientation, &value_along, NULL, &page_along);
+
+  gtk_list_item_manager_set_bind_center (priv->item_manager,
+                                         value_across + page_across / 2,
+                                         value_along + page_along / 2);
+}
+
 void
 gtk_list_base_allocate (GtkListBase *self)
 {
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
   GtkCssBoxes boxes;
 
   gtk_css_boxes_init (&boxes, GTK_WIDGET (self));
 
   gtk_list_base_update_adjustments (self);
+  gtk_list_base_update_bind_center (self);
 
   gtk_list_base_allocate_children (self, &boxes);
   gtk_list_base_allocate_rubberband (self, &boxes);
+
+  gtk_list_item_manager_report_frame (priv->item_manager, priv->prefetch_items);
+
+  /* The new prefetched rows have been measured, make some more */
+  priv->prefetch_frame_items = 0;
+  if (priv->prefetch)
+    gtk_list_base_queue_prefetch (self);
 }
 
 GtkScrollablePolicy
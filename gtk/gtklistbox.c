@@ -23,6 +23,7 @@
 #include "gtkactionhelperprivate.h"
 #include "gtkadjustmentprivate.h"
 #include "gtkbinlayout.h"
+#include "gtkbitset.h"
 #include "gtkbuildable.h"
 #include "gtkgestureclick.h"
 #include "gtkmain.h"
@@ -100,6 +101,13 @@
  * `GtkListBoxRow` is the kind of widget that can be added to a `GtkListBox`.
  */
 
+/* Row height to assume for virtualized models before any row was measured */
+#define VIRTUAL_DEFAULT_ROW_HEIGHT 32
+/* Rows to create when the visible area is not known */
+#define VIRTUAL_DEFAULT_ROWS 50
+/* Rows to keep above and below the visible area */
+#define VIRTUAL_MARGIN_ROWS 10
+
 typedef struct _GtkListBoxClass   GtkListBoxClass;
 
 struct _GtkListBox
@@ -146,6 +154,23 @@ struct _GtkListBox
   GtkListBoxCreateWidgetFunc create_widget_func;
   gpointer create_widget_func_data;
   GDestroyNotify create_widget_func_data_destroy;
+
+  /* With a virtualized model, rows only exist for the items in view,
+   * the first of which is window_start, and for the selected and
+   * cursor rows. The height of the others is estimated */
+  gboolean virtualized;
+  guint window_start;
+  int estimated_row_height;
+  gint64 measured_rows_height;
+  guint n_measured_rows;
+  GtkBitset *virtual_selection;
+  guint window_tick_id;
+
+  /* The row the cursor moves to once it is allocated */
+  guint pending_cursor;
+  gboolean pending_cursor_extend;
+  gboolean pending_cursor_modify;
+  gboolean pending_cursor_allocated;
 };
 
 struct _GtkListBoxClass
@@ -176,10 +201,12 @@ typedef struct
   GtkActionHelper *action_helper;
   int y;
   int height;
+  guint position;   /* in the bound model, for virtualized boxes */
   guint visible     :1;
   guint selected    :1;
   guint activatable :1;
   guint selectable  :1;
+  guint measured    :1;
 } GtkListBoxRowPrivate;
 
 enum {
@@ -205,6 +232,7 @@ enum {
   PROP_ACTIVATE_ON_SINGLE_CLICK,
   PROP_ACCEPT_UNPAIRED_RELEASE,
   PROP_SHOW_SEPARATORS,
+  PROP_VIRTUALIZED,
   LAST_PROPERTY
 };
 
@@ -315,6 +343,11 @@ static void gtk_list_box_update_row_styles (GtkListBox    *box);
 static void gtk_list_box_update_row_style  (GtkListBox    *box,
                                             GtkListBoxRow *row);
 
+static GtkListBoxRow *      gtk_list_box_insert_bound_row               (GtkListBox          *box,
+                                                                         guint                position,
+                                                                         int                  index);
+static void                 gtk_list_box_update_window                  (GtkListBox          *box);
+static void                 gtk_list_box_queue_update_window            (GtkListBox          *box);
 static void                 gtk_list_box_bound_model_changed            (GListModel          *list,
                                                                          guint                position,
                                                                          guint                removed,
@@ -396,6 +429,9 @@ gtk_list_box_get_property (GObject    *obj,
     case PROP_SHOW_SEPARATORS:
       g_value_set_boolean (value, box->show_separators);
       break;
+    case PROP_VIRTUALIZED:
+      g_value_set_boolean (value, box->virtualized);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, property_id, pspec);
       break;
@@ -424,6 +460,9 @@ gtk_list_box_set_property (GObject      *obj,
     case PROP_SHOW_SEPARATORS:
       gtk_list_box_set_show_separators (box, g_value_get_boolean (value));
       break;
+    case PROP_VIRTUALIZED:
+      gtk_list_box_set_virtualized (box, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, property_id, pspec);
       break;
@@ -446,6 +485,13 @@ gtk_list_box_dispose (GObject *object)
 
   gtk_list_box_remove_all (self);
 
+  if (self->window_tick_id)
+    {
+      gtk_widget_remove_tick_callback (GTK_WIDGET (self), self->window_tick_id);
+      self->window_tick_id = 0;
+    }
+  g_clear_pointer (&self->virtual_selection, gtk_bitset_unref);
+
   G_OBJECT_CLASS (gtk_list_box_parent_class)->dispose (object);
 }
 
@@ -461,6 +507,8 @@ gtk_list_box_finalize (GObject *obj)
   if (box->update_header_func_target_destroy_notify != NULL)
     box->update_header_func_target_destroy_notify (box->update_header_func_target);
 
+  if (box->adjustment)
+    g_signal_handlers_disconnect_by_func (box->adjustment, gtk_list_box_queue_update_window, box);
   g_clear_object (&box->adjustment);
   g_clear_object (&box->drag_highlighted_row);
 
@@ -538,6 +586,18 @@ gtk_list_box_class_init (GtkListBoxClass *klass)
                           FALSE,
                           G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkListBox:virtualized: (attributes org.gtk.Property.get=gtk_list_box_get_virtualized org.gtk.Property.set=gtk_list_box_set_virtualized)
+   *
+   * Whether to only create rows for the visible part of a bound model.
+   *
+   * Since: 4.16
+   */
+  properties[PROP_VIRTUALIZED] =
+    g_param_spec_boolean ("virtualized", NULL, NULL,
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (object_class, LAST_PROPERTY, properties);
 
   /**
@@ -753,6 +813,7 @@ gtk_list_box_init (GtkListBox *box)
 
   box->selection_mode = GTK_SELECTION_SINGLE;
   box->activate_single_click = TRUE;
+  box->pending_cursor = GTK_INVALID_LIST_POSITION;
 
   box->children = g_sequence_new (NULL);
   box->header_hash = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, NULL);
@@ -797,6 +858,52 @@ gtk_list_box_get_selected_row (GtkListBox *box)
   return box->selected_row;
 }
 
+static gboolean
+gtk_list_box_is_virtual (GtkListBox *box)
+{
+  return box->virtualized && box->bound_model != NULL;
+}
+
+/* Returns the first row of a virtualized box at or after @position */
+static GSequenceIter *
+gtk_list_box_find_position (GtkListBox *box,
+                            guint       position)
+{
+  GSequenceIter *begin, *end, *mid;
+
+  begin = g_sequence_get_begin_iter (box->children);
+  end = g_sequence_get_end_iter (box->children);
+
+  while (begin != end)
+    {
+      mid = g_sequence_range_get_midpoint (begin, end);
+      if (ROW_PRIV (g_sequence_get (mid))->position < position)
+        begin = g_sequence_iter_next (mid);
+      else
+        end = mid;
+    }
+
+  return begin;
+}
+
+static GtkListBoxRow *
+gtk_list_box_get_row_at_position (GtkListBox *box,
+                                  guint       position)
+{
+  GSequenceIter *iter;
+  GtkListBoxRow *row;
+
+  iter = gtk_list_box_find_position (box, position);
+  if (g_sequence_iter_is_end (iter))
+    return NULL;
+
+  row = g_sequence_get (iter);
+  if (ROW_PRIV (row)->position != position)
+    return NULL;
+
+  return row;
+}
+
 /**
  * gtk_list_box_get_row_at_index:
  * @box: a `GtkListBox`
@@ -807,6 +914,9 @@ gtk_list_box_get_selected_row (GtkListBox *box)
  * If @index_ is negative or larger than the number of items in the
  * list, %NULL is returned.
  *
+ * If @box is [property@Gtk.ListBox:virtualized], %NULL is also
+ * returned for items that currently have no row.
+ *
  * Returns: (transfer none) (nullable): the child `GtkWidget`
  */
 GtkListBoxRow *
@@ -817,6 +927,12 @@ gtk_list_box_get_row_at_index (GtkListBox *box,
 
   g_return_val_if_fail (GTK_IS_LIST_BOX (box), NULL);
 
+  if (index_ < 0)
+    return NULL;
+
+  if (gtk_list_box_is_virtual (box))
+    return gtk_list_box_get_row_at_position (box, index_);
+
   iter = g_sequence_get_iter_at_pos (box->children, index_);
   if (!g_sequence_iter_is_end (iter))
     return g_sequence_get (iter);
@@ -928,6 +1044,18 @@ gtk_list_box_select_all (GtkListBox *box)
   if (box->selection_mode != GTK_SELECTION_MULTIPLE)
     return;
 
+  if (gtk_list_box_is_virtual (box))
+    {
+      GSequenceIter *iter;
+
+      /* Existing rows are selected below */
+      gtk_bitset_add_range (box->virtual_selection, 0, g_list_model_get_n_items (box->bound_model));
+      for (iter = g_sequence_get_begin_iter (box->children);
+           !g_sequence_iter_is_end (iter);
+           iter = g_sequence_iter_next (iter))
+        gtk_bitset_remove (box->virtual_selection, ROW_PRIV (g_sequence_get (iter))->position);
+    }
+
   if (g_sequence_get_length (box->children) > 0)
     {
       gtk_list_box_select_all_between (box, NULL, NULL, FALSE);
@@ -1094,8 +1222,18 @@ gtk_list_box_set_adjustment (GtkListBox    *box,
   if (adjustment)
     g_object_ref_sink (adjustment);
   if (box->adjustment)
-    g_object_unref (box->adjustment);
+    {
+      g_signal_handlers_disconnect_by_func (box->adjustment, gtk_list_box_queue_update_window, box);
+      g_object_unref (box->adjustment);
+    }
   box->adjustment = adjustment;
+  if (box->adjustment)
+    {
+      g_signal_connect_swapped (box->adjustment, "value-changed", G_CALLBACK (gtk_list_box_queue_update_window), box);
+      g_signal_connect_swapped (box->adjustment, "changed", G_CALLBACK (gtk_list_box_queue_update_window), box);
+    }
+
+  gtk_list_box_queue_update_window (box);
 }
 
 /**
@@ -1601,6 +1739,9 @@ gtk_list_box_update_cursor (GtkListBox    *box,
         gtk_widget_grab_focus (GTK_WIDGET (row));
     }
   gtk_widget_queue_draw (GTK_WIDGET (row));
+
+  /* The previous cursor row may be out of view */
+  gtk_list_box_queue_update_window (box);
 }
 
 static GtkListBox *
@@ -1658,6 +1799,12 @@ gtk_list_box_unselect_all_internal (GtkListBox *box)
   if (box->selection_mode == GTK_SELECTION_NONE)
     return FALSE;
 
+  if (box->virtual_selection && !gtk_bitset_is_empty (box->virtual_selection))
+    {
+      gtk_bitset_remove_all (box->virtual_selection);
+      dirty = TRUE;
+    }
+
   for (iter = g_sequence_get_begin_iter (box->children);
        !g_sequence_iter_is_end (iter);
        iter = g_sequence_iter_next (iter))
@@ -1737,6 +1884,12 @@ gtk_list_box_select_all_between (GtkListBox    *box,
       iter2 = iter;
     }
 
+  /* Select the items in between that have no row, too */
+  if (gtk_list_box_is_virtual (box) && row1 && row2 && !modify)
+    gtk_bitset_add_range_closed (box->virtual_selection,
+                                 MIN (ROW_PRIV (row1)->position, ROW_PRIV (row2)->position),
+                                 MAX (ROW_PRIV (row1)->position, ROW_PRIV (row2)->position));
+
   for (iter = iter1;
        !g_sequence_iter_is_end (iter);
        iter = g_sequence_iter_next (iter))
@@ -1744,6 +1897,9 @@ gtk_list_box_select_all_between (GtkListBox    *box,
       GtkListBoxRow *row;
 
       row = GTK_LIST_BOX_ROW (g_sequence_get (iter));
+      if (gtk_list_box_is_virtual (box))
+        gtk_bitset_remove (box->virtual_selection, ROW_PRIV (row)->position);
+
       if (row_is_visible (row))
         {
           if (modify)
@@ -2511,6 +2667,15 @@ gtk_list_box_get_request_mode (GtkWidget *widget)
   return GTK_SIZE_REQUEST_HEIGHT_FOR_WIDTH;
 }
 
+static int
+gtk_list_box_get_estimated_row_height (GtkListBox *box)
+{
+  if (box->estimated_row_height > 0)
+    return box->estimated_row_height;
+
+  return VIRTUAL_DEFAULT_ROW_HEIGHT;
+}
+
 static void
 gtk_list_box_measure (GtkWidget     *widget,
                       GtkOrientation  orientation,
@@ -2606,6 +2771,11 @@ gtk_list_box_measure (GtkWidget     *widget,
           *minimum += row_min;
         }
 
+      /* Items without a row get the estimated height */
+      if (box->bound_model && box->virtualized)
+        *minimum += gtk_list_box_get_estimated_row_height (box)
+                    * (g_list_model_get_n_items (box->bound_model) - g_sequence_get_length (box->children));
+
       /* We always allocate the minimum height, since handling expanding rows
        * is way too costly, and unlikely to be used, as lists are generally put
        * inside a scrolling window anyway.
@@ -2626,7 +2796,9 @@ gtk_list_box_size_allocate (GtkWidget *widget,
   GtkListBoxRow *row;
   GSequenceIter *iter;
   int child_min;
-
+  gboolean virtual;
+  int row_height;
+  guint position;
 
   child_allocation.x = 0;
   child_allocation.y = 0;
@@ -2649,11 +2821,25 @@ gtk_list_box_size_allocate (GtkWidget *widget,
       child_allocation.y += child_min;
     }
 
+  virtual = gtk_list_box_is_virtual (box);
+  row_height = gtk_list_box_get_estimated_row_height (box);
+  position = 0;
+
   for (iter = g_sequence_get_begin_iter (box->children);
        !g_sequence_iter_is_end (iter);
        iter = g_sequence_iter_next (iter))
     {
+      int row_y;
+
       row = g_sequence_get (iter);
+
+      /* Leave room for the items without a row */
+      if (virtual)
+        {
+          child_allocation.y += (ROW_PRIV (row)->position - position) * row_height;
+          position = ROW_PRIV (row)->position + 1;
+        }
+
       if (!row_is_visible (row))
         {
           ROW_PRIV (row)->y = child_allocation.y;
@@ -2661,6 +2847,8 @@ gtk_list_box_size_allocate (GtkWidget *widget,
           continue;
         }
 
+      row_y = child_allocation.y;
+
       if (ROW_PRIV (row)->header != NULL)
         {
           gtk_widget_measure (ROW_PRIV (row)->header, GTK_ORIENTATION_VERTICAL,
@@ -2684,7 +2872,30 @@ gtk_list_box_size_allocate (GtkWidget *widget,
       ROW_PRIV (row)->height = child_allocation.height;
       gtk_widget_size_allocate (GTK_WIDGET (row), &child_allocation, -1);
       child_allocation.y += child_min;
+
+      if (!virtual)
+        continue;
+
+      /* Every row counts once towards the estimate, so it settles
+       * instead of changing whenever different rows are in view */
+      if (!ROW_PRIV (row)->measured)
+        {
+          ROW_PRIV (row)->measured = TRUE;
+          box->measured_rows_height += child_allocation.y - row_y;
+          box->n_measured_rows++;
+        }
+
+      if (ROW_PRIV (row)->position == box->pending_cursor)
+        box->pending_cursor_allocated = TRUE;
     }
+
+  /* Changing the estimate or the cursor needs to happen outside
+   * of layout */
+  if (virtual &&
+      (box->pending_cursor_allocated ||
+       (box->n_measured_rows > 0 &&
+        MAX (1, box->measured_rows_height / box->n_measured_rows) != row_height)))
+    gtk_list_box_queue_update_window (box);
 }
 
 /**
@@ -2858,6 +3069,116 @@ gtk_list_box_toggle_cursor_row (GtkListBox *box)
     gtk_list_box_select_and_activate (box, box->cursor_row);
 }
 
+static void
+gtk_list_box_keynav_failed (GtkListBox *box,
+                            int         count)
+{
+  GtkDirectionType direction = count < 0 ? GTK_DIR_UP : GTK_DIR_DOWN;
+
+  if (!gtk_widget_keynav_failed (GTK_WIDGET (box), direction))
+    {
+      GtkWidget *toplevel = GTK_WIDGET (gtk_widget_get_root (GTK_WIDGET (box)));
+
+      if (toplevel)
+        gtk_widget_child_focus (toplevel,
+                                direction == GTK_DIR_UP ?
+                                GTK_DIR_TAB_BACKWARD :
+                                GTK_DIR_TAB_FORWARD);
+
+    }
+}
+
+/* Rows of a virtualized box past the ones in view may not exist, so
+ * the cursor moves by model position, creating the row if needed.
+ * A new row only gets the cursor once it is allocated, or focusing
+ * it could not scroll it into view.
+ */
+static void
+gtk_list_box_move_cursor_virtual (GtkListBox      *box,
+                                  GtkMovementStep  step,
+                                  int              count,
+                                  gboolean         extend,
+                                  gboolean         modify)
+{
+  GtkListBoxRow *row;
+  guint n_items, current;
+  gint64 target;
+  int row_height;
+  int page_size;
+
+  n_items = g_list_model_get_n_items (box->bound_model);
+  row_height = gtk_list_box_get_estimated_row_height (box);
+
+  if (box->pending_cursor != GTK_INVALID_LIST_POSITION)
+    current = box->pending_cursor;
+  else if (box->cursor_row != NULL)
+    current = ROW_PRIV (box->cursor_row)->position;
+  else
+    current = GTK_INVALID_LIST_POSITION;
+
+  switch ((guint) step)
+    {
+    case GTK_MOVEMENT_BUFFER_ENDS:
+      target = count < 0 ? 0 : (gint64) n_items - 1;
+      break;
+    case GTK_MOVEMENT_DISPLAY_LINES:
+      if (current == GTK_INVALID_LIST_POSITION)
+        target = -1;
+      else
+        target = CLAMP ((gint64) current + count, 0, (gint64) n_items - 1);
+      break;
+    case GTK_MOVEMENT_PAGES:
+      page_size = 100;
+      if (box->adjustment != NULL)
+        page_size = gtk_adjustment_get_page_increment (box->adjustment);
+
+      if (current == GTK_INVALID_LIST_POSITION)
+        target = -1;
+      else
+        target = CLAMP ((gint64) current + (gint64) count * MAX (1, page_size / row_height),
+                        0, (gint64) n_items - 1);
+      break;
+    default:
+      return;
+    }
+
+  if (target < 0 || target == current)
+    {
+      gtk_list_box_keynav_failed (box, count);
+      return;
+    }
+
+  row = gtk_list_box_get_row_at_position (box, target);
+  if (row != NULL && ROW_PRIV (row)->measured)
+    {
+      box->pending_cursor = GTK_INVALID_LIST_POSITION;
+      gtk_list_box_update_cursor (box, row, TRUE);
+      if (!modify)
+        gtk_list_box_update_selection (box, row, FALSE, extend);
+      return;
+    }
+
+  box->pending_cursor = target;
+  box->pending_cursor_extend = extend;
+  box->pending_cursor_modify = modify;
+  box->pending_cursor_allocated = FALSE;
+
+  if (row == NULL)
+    {
+      GSequenceIter *iter = gtk_list_box_find_position (box, target);
+
+      gtk_list_box_insert_bound_row (box, target, g_sequence_iter_get_position (iter));
+      gtk_widget_queue_resize (GTK_WIDGET (box));
+    }
+
+  /* Scroll to where the row is expected, so the rows around it
+   * get created as well */
+  if (box->adjustment != NULL)
+    gtk_adjustment_clamp_page (box->adjustment,
+                               target * row_height,
+                               (target + 1) * row_height);
+}
+
 static void
 gtk_list_box_move_cursor (GtkListBox      *box,
                           GtkMovementStep  step,
@@ -2872,6 +3193,12 @@ gtk_list_box_move_cursor (GtkListBox      *box,
   int end_y;
   int height;
 
+  if (gtk_list_box_is_virtual (box))
+    {
+      gtk_list_box_move_cursor_virtual (box, step, count, extend, modify);
+      return;
+    }
+
   row = NULL;
   switch ((guint) step)
     {
@@ -2965,20 +3292,7 @@ gtk_list_box_move_cursor (GtkListBox      *box,
 
   if (row == NULL || row == box->cursor_row)
     {
-      GtkDirectionType direction = count < 0 ? GTK_DIR_UP : GTK_DIR_DOWN;
-
-      if (!gtk_widget_keynav_failed (GTK_WIDGET (box), direction))
-        {
-          GtkWidget *toplevel = GTK_WIDGET (gtk_widget_get_root (GTK_WIDGET (box)));
-
-          if (toplevel)
-            gtk_widget_child_focus (toplevel,
-                                    direction == GTK_DIR_UP ?
-                                    GTK_DIR_TAB_BACKWARD :
-                                    GTK_DIR_TAB_FORWARD);
-
-        }
-
+      gtk_list_box_keynav_failed (box, count);
       return;
     }
 
@@ -3267,7 +3581,14 @@ gtk_list_box_row_get_index (GtkListBoxRow *row)
   g_return_val_if_fail (GTK_IS_LIST_BOX_ROW (row), -1);
 
   if (priv->iter != NULL)
-    return g_sequence_iter_get_position (priv->iter);
+    {
+      GtkListBox *box = gtk_list_box_row_get_box (row);
+
+      if (box && gtk_list_box_is_virtual (box))
+        return priv->position;
+
+      return g_sequence_iter_get_position (priv->iter);
+    }
 
   return -1;
 }
@@ -3678,6 +3999,284 @@ gtk_list_box_buildable_interface_init (GtkBuildableIface *iface)
   iface->add_child = gtk_list_box_buildable_add_child;
 }
 
+static GtkListBoxRow *
+gtk_list_box_insert_bound_row (GtkListBox *box,
+                               guint       position,
+                               int         index)
+{
+  GObject *item;
+  GtkWidget *widget;
+  GtkListBoxRow *row;
+
+  item = g_list_model_get_item (box->bound_model, position);
+  widget = box->create_widget_func (item, box->create_widget_func_data);
+
+  /* We allow the create_widget_func to either return a full
+   * reference or a floating reference.  If we got the floating
+   * reference, then turn it into a full reference now.  That means
+   * that gtk_list_box_insert() will take another full reference.
+   * Finally, we'll release this full reference below, leaving only
+   * the one held by the box.
+   */
+  if (g_object_is_floating (widget))
+    g_object_ref_sink (widget);
+
+  gtk_widget_set_visible (widget, TRUE);
+
+  if (GTK_IS_LIST_BOX_ROW (widget))
+    row = g_object_ref (GTK_LIST_BOX_ROW (widget));
+  else
+    {
+      row = GTK_LIST_BOX_ROW (g_object_ref_sink (gtk_list_box_row_new ()));
+      gtk_list_box_row_set_child (row, widget);
+    }
+
+  ROW_PRIV (row)->position = position;
+  gtk_list_box_insert (box, GTK_WIDGET (row), index);
+
+  /* Restore the selection of rows that were dropped while scrolling */
+  if (box->virtual_selection && gtk_bitset_contains (box->virtual_selection, position))
+    {
+      gtk_bitset_remove (box->virtual_selection, position);
+      if (gtk_list_box_row_set_selected (row, TRUE))
+        box->selected_row = row;
+    }
+
+  g_object_unref (row);
+  g_object_unref (widget);
+  g_object_unref (item);
+
+  return row;
+}
+
+/* Removes a row whose item is still in the model, but is no longer
+ * needed. Its selection is remembered for when it is needed again */
+static void
+gtk_list_box_release_bound_row (GtkListBox    *box,
+                                GtkListBoxRow *row)
+{
+  if (ROW_PRIV (row)->selected)
+    {
+      gtk_bitset_add (box->virtual_selection, ROW_PRIV (row)->position);
+      gtk_list_box_row_set_selected (row, FALSE);
+    }
+
+  gtk_list_box_remove (box, GTK_WIDGET (row));
+}
+
+/* The selected and cursor rows are kept when they scroll out of view,
+ * so they can still be queried and navigated from */
+static gboolean
+gtk_list_box_row_is_pinned (GtkListBox    *box,
+                            GtkListBoxRow *row)
+{
+  return row == box->selected_row ||
+         row == box->cursor_row ||
+         ROW_PRIV (row)->position == box->pending_cursor;
+}
+
+static void
+gtk_list_box_update_window (GtkListBox *box)
+{
+  GSequenceIter *iter;
+  guint n_items, start, end, position;
+  double top, bottom;
+  int row_height;
+  gboolean changed;
+
+  if (!gtk_list_box_is_virtual (box))
+    return;
+
+  n_items = g_list_model_get_n_items (box->bound_model);
+  row_height = gtk_list_box_get_estimated_row_height (box);
+
+  if (box->adjustment && gtk_adjustment_get_page_size (box->adjustment) > 0)
+    {
+      top = gtk_adjustment_get_value (box->adjustment);
+      bottom = top + gtk_adjustment_get_page_size (box->adjustment);
+    }
+  else
+    {
+      top = 0;
+      bottom = VIRTUAL_DEFAULT_ROWS * row_height;
+    }
+
+  start = MAX (0, floor (top / row_height) - VIRTUAL_MARGIN_ROWS);
+  start = MIN (start, n_items);
+  end = ceil (bottom / row_height) + VIRTUAL_MARGIN_ROWS;
+  end = CLAMP (end, start, n_items);
+
+  changed = FALSE;
+
+  iter = g_sequence_get_begin_iter (box->children);
+  while (!g_sequence_iter_is_end (iter))
+    {
+      GtkListBoxRow *row = g_sequence_get (iter);
+
+      iter = g_sequence_iter_next (iter);
+
+      if ((ROW_PRIV (row)->position < start || ROW_PRIV (row)->position >= end) &&
+          !gtk_list_box_row_is_pinned (box, row))
+        {
+          gtk_list_box_release_bound_row (box, row);
+          changed = TRUE;
+        }
+    }
+
+  iter = gtk_list_box_find_position (box, start);
+  for (position = start; position < end; position++)
+    {
+      if (!g_sequence_iter_is_end (iter) &&
+          ROW_PRIV (g_sequence_get (iter))->position == position)
+        {
+          iter = g_sequence_iter_next (iter);
+          continue;
+        }
+
+      gtk_list_box_insert_bound_row (box, position, g_sequence_iter_get_position (iter));
+      changed = TRUE;
+    }
+
+  box->window_start = start;
+
+  if (changed)
+    gtk_widget_queue_resize (GTK_WIDGET (box));
+}
+
+/* Moves the view along with the estimated items before the window
+ * when their height changes, so the rows in view stay in place */
+static void
+gtk_list_box_update_estimated_row_height (GtkListBox *box)
+{
+  GSequenceIter *iter;
+  int old_height, new_height;
+  guint n_estimated;
+
+  if (box->n_measured_rows == 0)
+    return;
+
+  old_height = gtk_list_box_get_estimated_row_height (box);
+  new_height = MAX (1, box->measured_rows_height / box->n_measured_rows);
+  if (old_height == new_height)
+    return;
+
+  box->estimated_row_height = new_height;
+
+  if (box->adjustment)
+    {
+      double delta, total;
+
+      n_estimated = box->window_start;
+      for (iter = g_sequence_get_begin_iter (box->children);
+           !g_sequence_iter_is_end (iter) &&
+           ROW_PRIV (g_sequence_get (iter))->position < box->window_start;
+           iter = g_sequence_iter_next (iter))
+        n_estimated--;
+
+      delta = (double) n_estimated * (new_height - old_height);
+      total = (double) (g_list_model_get_n_items (box->bound_model) - g_sequence_get_length (box->children))
+              * (new_height - old_height);
+
+      /* The viewport updates the upper bound with the next
+       * allocation, until then it must not clamp the value */
+      gtk_adjustment_configure (box->adjustment,
+                                gtk_adjustment_get_value (box->adjustment) + delta,
+                                gtk_adjustment_get_lower (box->adjustment),
+                                gtk_adjustment_get_upper (box->adjustment) + MAX (total, 0),
+                                gtk_adjustment_get_step_increment (box->adjustment),
+                                gtk_adjustment_get_page_increment (box->adjustment),
+                                gtk_adjustment_get_page_size (box->adjustment));
+    }
+
+  gtk_widget_queue_resize (GTK_WIDGET (box));
+}
+
+static void
+gtk_list_box_apply_pending_cursor (GtkListBox *box)
+{
+  GtkListBoxRow *row;
+
+  if (!box->pending_cursor_allocated)
+    return;
+
+  row = gtk_list_box_get_row_at_position (box, box->pending_cursor);
+  box->pending_cursor = GTK_INVALID_LIST_POSITION;
+  box->pending_cursor_allocated = FALSE;
+
+  if (row == NULL)
+    return;
+
+  gtk_list_box_update_cursor (box, row, TRUE);
+  if (!box->pending_cursor_modify)
+    gtk_list_box_update_selection (box, row, FALSE, box->pending_cursor_extend);
+}
+
+static gboolean
+gtk_list_box_update_window_tick (GtkWidget     *widget,
+                                 GdkFrameClock *frame_clock,
+                                 gpointer       user_data)
+{
+  GtkListBox *box = GTK_LIST_BOX (widget);
+
+  box->window_tick_id = 0;
+
+  /* The cursor row is focused while its allocation is current */
+  gtk_list_box_apply_pending_cursor (box);
+  gtk_list_box_update_estimated_row_height (box);
+  gtk_list_box_update_window (box);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Scrolling happens during layout, when we can't add or remove
+ * rows, so update them before the next one */
+static void
+gtk_list_box_queue_update_window (GtkListBox *box)
+{
+  if (!gtk_list_box_is_virtual (box) || box->window_tick_id != 0)
+    return;
+
+  box->window_tick_id = gtk_widget_add_tick_callback (GTK_WIDGET (box),
+                                                      gtk_list_box_update_window_tick,
+                                                      NULL, NULL);
+}
+
+static void
+gtk_list_box_bound_model_changed_virtual (GtkListBox *box,
+                                          guint       position,
+                                          guint       removed,
+                                          guint       added)
+{
+  GSequenceIter *iter;
+
+  gtk_bitset_splice (box->virtual_selection, position, removed, added);
+
+  if (box->pending_cursor != GTK_INVALID_LIST_POSITION && box->pending_cursor >= position)
+    {
+      if (box->pending_cursor >= position + removed)
+        box->pending_cursor = box->pending_cursor - removed + added;
+      else
+        box->pending_cursor = GTK_INVALID_LIST_POSITION;
+    }
+
+  /* Rows of removed items go away, the ones after them move */
+  iter = gtk_list_box_find_position (box, position);
+  while (!g_sequence_iter_is_end (iter))
+    {
+      GtkListBoxRow *row = g_sequence_get (iter);
+
+      iter = g_sequence_iter_next (iter);
+
+      if (ROW_PRIV (row)->position < position + removed)
+        gtk_list_box_remove (box, GTK_WIDGET (row));
+      else
+        ROW_PRIV (row)->position = ROW_PRIV (row)->position - removed + added;
+    }
+
+  gtk_widget_queue_resize (GTK_WIDGET (box));
+  gtk_list_box_update_window (box);
+}
+
 static void
 gtk_list_box_bound_model_changed (GListModel *list,
                                   guint       position,
@@ -3688,6 +4287,12 @@ gtk_list_box_bound_model_changed (GListModel *list,
   GtkListBox *box = user_data;
   guint i;
 
+  if (box->virtualized)
+    {
+      gtk_list_box_bound_model_changed_virtual (box, position, removed, added);
+      return;
+    }
+
   while (removed--)
     {
       GtkListBoxRow *row;
@@ -3697,29 +4302,30 @@ gtk_list_box_bound_model_changed (GListModel *list,
     }
 
   for (i = 0; i < added; i++)
-    {
-      GObject *item;
-      GtkWidget *widget;
-
-      item = g_list_model_get_item (list, position + i);
-      widget = box->create_widget_func (item, box->create_widget_func_data);
-
-      /* We allow the create_widget_func to either return a full
-       * reference or a floating reference.  If we got the floating
-       * reference, then turn it into a full reference now.  That means
-       * that gtk_list_box_insert() will take another full reference.
-       * Finally, we'll release this full reference below, leaving only
-       * the one held by the box.
-       */
-      if (g_object_is_floating (widget))
-        g_object_ref_sink (widget);
+    gtk_list_box_insert_bound_row (box, position + i, position + i);
+}
 
-      gtk_widget_set_visible (widget, TRUE);
-      gtk_list_box_insert (box, widget, position + i);
+static void
+gtk_list_box_remove_bound_rows (GtkListBox *box)
+{
+  GSequenceIter *iter;
 
-      g_object_unref (widget);
-      g_object_unref (item);
+  iter = g_sequence_get_begin_iter (box->children);
+  while (!g_sequence_iter_is_end (iter))
+    {
+      GtkWidget *row = g_sequence_get (iter);
+      iter = g_sequence_iter_next (iter);
+      gtk_list_box_remove (box, row);
     }
+
+  box->window_start = 0;
+  box->estimated_row_height = 0;
+  box->measured_rows_height = 0;
+  box->n_measured_rows = 0;
+  box->pending_cursor = GTK_INVALID_LIST_POSITION;
+  box->pending_cursor_allocated = FALSE;
+  if (box->virtual_selection)
+    gtk_bitset_remove_all (box->virtual_selection);
 }
 
 static void
@@ -3754,6 +4360,9 @@ gtk_list_box_check_model_compat (GtkListBox *box)
  * Note that using a model is incompatible with the filtering and sorting
  * functionality in `GtkListBox`. When using a model, filtering and sorting
  * should be implemented by the model.
+ *
+ * For large models, consider making @box
+ * [property@Gtk.ListBox:virtualized].
  */
 void
 gtk_list_box_bind_model (GtkListBox                 *box,
@@ -3762,8 +4371,6 @@ gtk_list_box_bind_model (GtkListBox                 *box,
                          gpointer                    user_data,
                          GDestroyNotify              user_data_free_func)
 {
-  GSequenceIter *iter;
-
   g_return_if_fail (GTK_IS_LIST_BOX (box));
   g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
   g_return_if_fail (model == NULL || create_widget_func != NULL);
@@ -3777,14 +4384,7 @@ gtk_list_box_bind_model (GtkListBox                 *box,
       g_clear_object (&box->bound_model);
     }
 
-  iter = g_sequence_get_begin_iter (box->children);
-  while (!g_sequence_iter_is_end (iter))
-    {
-      GtkWidget *row = g_sequence_get (iter);
-      iter = g_sequence_iter_next (iter);
-      gtk_list_box_remove (box, row);
-    }
-
+  gtk_list_box_remove_bound_rows (box);
 
   if (model == NULL)
     return;
@@ -3843,3 +4443,87 @@ gtk_list_box_get_show_separators (GtkListBox *box)
 
   return box->show_separators;
 }
+
+/**
+ * gtk_list_box_set_virtualized: (attributes org.gtk.Method.set_property=virtualized)
+ * @box: a `GtkListBox`
+ * @virtualized: %TRUE to only create rows for visible items
+ *
+ * Sets whether rows are only created for the visible part of
+ * a model bound with [method@Gtk.ListBox.bind_model].
+ *
+ * When enabled, @box only creates rows for the items in view
+ * plus a few around them, and estimates the height of the others.
+ * Rows are created and destroyed as @box is scrolled, so binding
+ * a model with many thousand items stays cheap.
+ *
+ * For this to work, @box needs to be the child of a
+ * [class@Gtk.Viewport], or have its
+ * [method@Gtk.ListBox.set_adjustment] set up accordingly.
+ *
+ * Items that currently don't have a row can not be accessed
+ * with [method@Gtk.ListBox.get_row_at_index], and are not reported
+ * by [method@Gtk.ListBox.selected_foreach] and
+ * [method@Gtk.ListBox.get_selected_rows], though their selection is
+ * kept. The row returned by [method@Gtk.ListBox.get_selected_row]
+ * and the row with the keyboard cursor are kept when they are
+ * scrolled out of view. The header function is only called for rows
+ * that exist, and gets the closest existing row before them as the
+ * previous row.
+ *
+ * This setting has no effect when no model is bound.
+ *
+ * Since: 4.16
+ */
+void
+gtk_list_box_set_virtualized (GtkListBox *box,
+                              gboolean    virtualized)
+{
+  g_return_if_fail (GTK_IS_LIST_BOX (box));
+
+  if (box->virtualized == virtualized)
+    return;
+
+  if (box->bound_model)
+    gtk_list_box_remove_bound_rows (box);
+
+  box->virtualized = virtualized;
+
+  if (virtualized)
+    {
+      box->virtual_selection = gtk_bitset_new_empty ();
+    }
+  else
+    {
+      g_clear_pointer (&box->virtual_selection, gtk_bitset_unref);
+      if (box->window_tick_id)
+        {
+          gtk_widget_remove_tick_callback (GTK_WIDGET (box), box->window_tick_id);
+          box->window_tick_id = 0;
+        }
+    }
+
+  if (box->bound_model)
+    gtk_list_box_bound_model_changed (box->bound_model, 0, 0, g_list_model_get_n_items (box->bound_model), box);
+
+  g_object_notify_by_pspec (G_OBJECT (box), properties[PROP_VIRTUALIZED]);
+}
+
+/**
+ * gtk_list_box_get_virtualized: (attributes org.gtk.Method.get_property=virtualized)
+ * @box: a `GtkListBox`
+ *
+ * Returns whether rows are only created for the visible part
+ * of a bound model.
+ *
+ * Returns: %TRUE if @box is virtualized
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_list_box_get_virtualized (GtkListBox *box)
+{
+  g_return_val_if_fail (GTK_IS_LIST_BOX (box), FALSE);
+
+  return box->virtualized;
+}
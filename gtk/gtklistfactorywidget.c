@@ -204,6 +204,16 @@ gtk_list_factory_widget_update (GtkListItemBase *base,
     }
 }
 
+static void
+gtk_list_factory_widget_placeholder (GtkListItemBase *base)
+{
+  GtkListFactoryWidget *self = GTK_LIST_FACTORY_WIDGET (base);
+  GtkListFactoryWidgetPrivate *priv = gtk_list_factory_widget_get_instance_private (self);
+
+  if (priv->object)
+    gtk_list_item_factory_placeholder (priv->factory, priv->object);
+}
+
 static void
 gtk_list_factory_widget_set_property (GObject      *object,
                                       guint         property_id,
@@ -304,6 +314,7 @@ gtk_list_factory_widget_class_init (GtkListFactoryWidgetClass *klass)
   klass->teardown_object = gtk_list_factory_widget_default_teardown_object;
 
   base_class->update = gtk_list_factory_widget_update;
+  base_class->placeholder = gtk_list_factory_widget_placeholder;
 
   gobject_class->set_property = gtk_list_factory_widget_set_property;
   gobject_class->dispose = gtk_list_factory_widget_dispose;
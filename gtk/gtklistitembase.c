@@ -104,6 +104,26 @@ gtk_list_item_base_update (GtkListItemBase *self,
     }
 }
 
+/*
+ * gtk_list_item_base_show_placeholder:
+ * @self: a `GtkListItemBase`
+ * @position: the position of the item that will be bound later
+ * @selected: whether that item is selected
+ *
+ * Unbinds the current item from @self and makes it look like a
+ * placeholder until the item at @position gets bound.
+ */
+void
+gtk_list_item_base_show_placeholder (GtkListItemBase *self,
+                                     guint            position,
+                                     gboolean         selected)
+{
+  gtk_list_item_base_update (self, position, NULL, selected);
+
+  if (GTK_LIST_ITEM_BASE_GET_CLASS (self)->placeholder)
+    GTK_LIST_ITEM_BASE_GET_CLASS (self)->placeholder (self);
+}
+
 guint
 gtk_list_item_base_get_position (GtkListItemBase *self)
 {
@@ -46,6 +46,8 @@ struct _GtkListItemBaseClass
                                                                  guint                   position,
                                                                  gpointer                item,
                                                                  gboolean                selected);
+  /* make the widget look like a placeholder after updating it to a NULL item */
+  void                  (* placeholder)                         (GtkListItemBase        *self);
 };
 
 GType                   gtk_list_item_base_get_type             (void) G_GNUC_CONST;
@@ -54,6 +56,9 @@ void                    gtk_list_item_base_update               (GtkListItemBase
                                                                  guint                   position,
                                                                  gpointer                item,
                                                                  gboolean                selected);
+void                    gtk_list_item_base_show_placeholder     (GtkListItemBase        *self,
+                                                                 guint                   position,
+                                                                 gboolean                selected);
 
 guint                   gtk_list_item_base_get_position         (GtkListItemBase        *self);
 gpointer                gtk_list_item_base_get_item             (GtkListItemBase        *self);
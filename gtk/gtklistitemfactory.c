@@ -112,12 +112,19 @@ gtk_list_item_factory_default_update (GtkListItemFactory *self,
     func (item, data);
 }
 
+static void
+gtk_list_item_factory_default_placeholder (GtkListItemFactory *self,
+                                           GObject            *item)
+{
+}
+
 static void
 gtk_list_item_factory_class_init (GtkListItemFactoryClass *klass)
 {
   klass->setup = gtk_list_item_factory_default_setup;
   klass->teardown = gtk_list_item_factory_default_teardown;
   klass->update = gtk_list_item_factory_default_update;
+  klass->placeholder = gtk_list_item_factory_default_placeholder;
 }
 
 static void
@@ -162,3 +169,13 @@ gtk_list_item_factory_update (GtkListItemFactory *self,
 
   GTK_LIST_ITEM_FACTORY_GET_CLASS (self)->update (self, item, unbind, bind, func, data);
 }
+
+void
+gtk_list_item_factory_placeholder (GtkListItemFactory *self,
+                                   GObject            *item)
+{
+  g_return_if_fail (GTK_IS_LIST_ITEM_FACTORY (self));
+  g_return_if_fail (G_IS_OBJECT (item));
+
+  GTK_LIST_ITEM_FACTORY_GET_CLASS (self)->placeholder (self, item);
+}
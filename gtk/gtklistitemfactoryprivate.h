@@ -55,6 +55,10 @@ struct _GtkListItemFactoryClass
                                                                  gboolean                bind,
                                                                  GFunc                   func,
                                                                  gpointer                data);
+
+  /* make the unbound @list_item look like a placeholder, cheaply */
+  void                  (* placeholder)                         (GtkListItemFactory     *self,
+                                                                 GObject                *item);
 };
 
 void                    gtk_list_item_factory_setup             (GtkListItemFactory     *self,
@@ -75,6 +79,8 @@ void                    gtk_list_item_factory_update            (GtkListItemFact
                                                                  GFunc                   func,
                                                                  gpointer                data);
 
+void                    gtk_list_item_factory_placeholder       (GtkListItemFactory     *self,
+                                                                 GObject                *item);
 
 G_END_DECLS
 
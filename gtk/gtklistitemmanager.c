@@ -21,11 +21,14 @@
 
 #include "gtklistitemmanagerprivate.h"
 
+#include "gtkidleschedulerprivate.h"
 #include "gtklistitembaseprivate.h"
 #include "gtklistitemwidgetprivate.h"
 #include "gtksectionmodel.h"
 #include "gtkwidgetprivate.h"
 
+#include "gdk/gdkprofilerprivate.h"
+
 typedef struct _GtkListItemChange GtkListItemChange;
 
 struct _GtkListItemManager
@@ -39,6 +42,16 @@ struct _GtkListItemManager
   GtkRbTree *items;
   GSList *trackers;
 
+  /* Widgets that are shown unbound and wait for their item */
+  gboolean deferred_binding;
+  GHashTable *deferred_items;
+  guint deferred_bind_id;
+  int bind_center_across;
+  int bind_center_along;
+
+  /* widgets created since the last frame */
+  guint n_created_widgets;
+
   GtkListTile * (* split_func) (GtkWidget *, GtkListTile *, guint);
   GtkListItemBase * (* create_widget) (GtkWidget *);
   void (* prepare_section) (GtkWidget *, GtkListTile *, guint);
@@ -56,6 +69,7 @@ struct _GtkListItemTracker
   GtkListItemBase *widget;
   guint n_before;
   guint n_after;
+  gboolean defer_binding;
 };
 
 struct _GtkListItemChange
@@ -67,6 +81,12 @@ struct _GtkListItemChange
 
 G_DEFINE_TYPE (GtkListItemManager, gtk_list_item_manager, G_TYPE_OBJECT)
 
+static guint deferred_binds_counter;
+static guint completed_binds_counter;
+static guint created_widgets_counter;
+static guint prefetched_items_counter;
+static guint n_deferred_binds;
+
 static void
 gtk_list_item_change_init (GtkListItemChange *change)
 {
@@ -111,6 +131,13 @@ static void
 gtk_list_item_change_release (GtkListItemChange *change,
                               GtkListItemBase   *widget)
 {
+  /* Widgets that never got their item bound can be reused for anything */
+  if (gtk_list_item_base_get_item (widget) == NULL)
+    {
+      gtk_list_item_change_recycle (change, widget);
+      return;
+    }
+
   if (change->deleted_items == NULL)
     change->deleted_items = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) gtk_widget_unparent);
 
@@ -726,6 +753,136 @@ gtk_list_tile_set_type (GtkListTile     *tile,
   gtk_rb_tree_node_mark_dirty (tile);
 }
 
+static void
+gtk_list_item_manager_bind_now (GtkListItemManager *self,
+                                GtkListItemBase    *widget)
+{
+  guint position;
+  gpointer item;
+
+  if (widget == NULL || !g_hash_table_remove (self->deferred_items, widget))
+    return;
+
+  position = gtk_list_item_base_get_position (widget);
+  item = g_list_model_get_item (G_LIST_MODEL (self->model), position);
+  gtk_list_item_base_update (widget,
+                             position,
+                             item,
+                             gtk_selection_model_is_selected (self->model, position));
+  g_object_unref (item);
+}
+
+static void
+gtk_list_item_manager_forget_deferred (GtkListItemManager *self,
+                                       GtkListItemBase    *widget)
+{
+  g_hash_table_remove (self->deferred_items, widget);
+}
+
+typedef struct
+{
+  GtkListItemBase *widget;
+  gint64 distance;
+} DeferredBind;
+
+static int
+compare_deferred_binds (gconstpointer a,
+                        gconstpointer b)
+{
+  const DeferredBind *bind_a = a;
+  const DeferredBind *bind_b = b;
+
+  if (bind_a->distance < bind_b->distance)
+    return -1;
+  else if (bind_a->distance > bind_b->distance)
+    return 1;
+  else
+    return 0;
+}
+
+static gint64
+gtk_list_item_manager_get_bind_distance (GtkListItemManager *self,
+                                         GtkListItemBase    *widget)
+{
+  GtkListTile *tile;
+  gint64 across, along;
+
+  tile = gtk_list_item_manager_get_nth (self, gtk_list_item_base_get_position (widget), NULL);
+  if (tile == NULL || tile->area.width <= 0 || tile->area.height <= 0)
+    return G_MAXINT64; /* not allocated yet */
+
+  across = tile->area.x + tile->area.width / 2 - self->bind_center_across;
+  along = tile->area.y + tile->area.height / 2 - self->bind_center_along;
+
+  return across * across + along * along;
+}
+
+static gboolean
+gtk_list_item_manager_deferred_bind_cb (gpointer data,
+                                        gint64   deadline)
+{
+  GtkListItemManager *self = data;
+  GHashTableIter iter;
+  gpointer widget;
+  GArray *binds;
+  guint i;
+  gint64 before G_GNUC_UNUSED;
+
+  before = GDK_PROFILER_CURRENT_TIME;
+
+  binds = g_array_sized_new (FALSE, FALSE, sizeof (DeferredBind), g_hash_table_size (self->deferred_items));
+  g_hash_table_iter_init (&iter, self->deferred_items);
+  while (g_hash_table_iter_next (&iter, &widget, NULL))
+    {
+      DeferredBind bind = { widget, gtk_list_item_manager_get_bind_distance (self, widget) };
+      g_array_append_val (binds, bind);
+    }
+
+  /* Rows in the middle of the view first, they are what the user looks at */
+  g_array_sort (binds, compare_deferred_binds);
+
+  /* Always bind at least one row, so that we make progress */
+  for (i = 0; i < binds->len; i++)
+    {
+      if (i > 0 && g_get_monotonic_time () >= deadline)
+        break;
+
+      /* A bind may have changed the model and released the widget */
+      gtk_list_item_manager_bind_now (self, g_array_index (binds, DeferredBind, i).widget);
+    }
+
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      gdk_profiler_end_markf (before, "Deferred binds", "%u of %u", i, binds->len);
+      gdk_profiler_set_int_counter (deferred_binds_counter, n_deferred_binds);
+      gdk_profiler_set_int_counter (completed_binds_counter, i);
+      n_deferred_binds = 0;
+    }
+
+  g_array_free (binds, TRUE);
+
+  if (g_hash_table_size (self->deferred_items) > 0)
+    return G_SOURCE_CONTINUE;
+
+  self->deferred_bind_id = 0;
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gtk_list_item_manager_defer_bind (GtkListItemManager *self,
+                                  GtkListItemBase    *widget)
+{
+  g_hash_table_add (self->deferred_items, widget);
+  n_deferred_binds++;
+
+  if (self->deferred_bind_id == 0)
+    self->deferred_bind_id = gtk_idle_scheduler_add (GTK_IDLE_TASK_VISIBLE,
+                                                     gtk_list_item_manager_deferred_bind_cb,
+                                                     self,
+                                                     NULL,
+                                                     "Bind list items");
+}
+
 static void
 gtk_list_item_tracker_unset_position (GtkListItemManager *self,
                                       GtkListItemTracker *tracker)
@@ -761,6 +918,27 @@ gtk_list_item_tracker_query_range (GtkListItemManager *self,
   return TRUE;
 }
 
+/* Returns whether @position is the position of a tracker that
+ * doesn't allow deferred binding, like the focus. The rows
+ * around a tracker can wait for their bind.
+ */
+static gboolean
+gtk_list_item_manager_binds_now (GtkListItemManager *self,
+                                 guint               position)
+{
+  GSList *l;
+
+  for (l = self->trackers; l; l = l->next)
+    {
+      GtkListItemTracker *tracker = l->data;
+
+      if (!tracker->defer_binding && tracker->position == position)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 static void
 gtk_list_item_query_tracked_range (GtkListItemManager *self,
                                    guint               n_items,
@@ -880,7 +1058,10 @@ gtk_list_item_manager_remove_items (GtkListItemManager *self,
               g_assert (tile->n_items <= n_items);
             }
           if (tile->widget)
-            gtk_list_item_change_release (change, GTK_LIST_ITEM_BASE (tile->widget));
+            {
+              gtk_list_item_manager_forget_deferred (self, GTK_LIST_ITEM_BASE (tile->widget));
+              gtk_list_item_change_release (change, GTK_LIST_ITEM_BASE (tile->widget));
+            }
           tile->widget = NULL;
           n_items -= tile->n_items;
           tile->n_items = 0;
@@ -1171,6 +1352,7 @@ gtk_list_item_manager_release_items (GtkListItemManager *self,
             case GTK_LIST_TILE_ITEM:
               if (tile->widget)
                 {
+                  gtk_list_item_manager_forget_deferred (self, GTK_LIST_ITEM_BASE (tile->widget));
                   gtk_list_item_change_recycle (change, GTK_LIST_ITEM_BASE (tile->widget));
                   tile->widget = NULL;
                 }
@@ -1371,11 +1553,26 @@ gtk_list_item_manager_ensure_items (GtkListItemManager *self,
                   gpointer item = g_list_model_get_item (G_LIST_MODEL (self->model), position + i);
                   tile->widget = GTK_WIDGET (gtk_list_item_change_get (change, item));
                   if (tile->widget == NULL)
-                    tile->widget = GTK_WIDGET (self->create_widget (self->widget));
-                  gtk_list_item_base_update (GTK_LIST_ITEM_BASE (tile->widget),
-                                             position + i,
-                                             item,
-                                             gtk_selection_model_is_selected (self->model, position + i));
+                    {
+                      tile->widget = GTK_WIDGET (self->create_widget (self->widget));
+                      self->n_created_widgets++;
+                    }
+                  if (self->deferred_binding &&
+                      gtk_list_item_base_get_item (GTK_LIST_ITEM_BASE (tile->widget)) != item &&
+                      !gtk_list_item_manager_binds_now (self, position + i))
+                    {
+                      gtk_list_item_base_show_placeholder (GTK_LIST_ITEM_BASE (tile->widget),
+                                                           position + i,
+                                                           gtk_selection_model_is_selected (self->model, position + i));
+                      gtk_list_item_manager_defer_bind (self, GTK_LIST_ITEM_BASE (tile->widget));
+                    }
+                  else
+                    {
+                      gtk_list_item_base_update (GTK_LIST_ITEM_BASE (tile->widget),
+                                                 position + i,
+                                                 item,
+                                                 gtk_selection_model_is_selected (self->model, position + i));
+                    }
                   g_object_unref (item);
                   gtk_widget_insert_after (tile->widget, self->widget, insert_after);
                 }
@@ -1598,6 +1795,8 @@ gtk_list_item_manager_model_items_changed_cb (GListModel         *model,
       g_assert (tile != NULL);
       g_assert (tile->widget);
       tracker->widget = GTK_LIST_ITEM_BASE (tile->widget);
+      if (!tracker->defer_binding)
+        gtk_list_item_manager_bind_now (self, tracker->widget);
     }
 
   gtk_list_item_change_finish (&change);
@@ -1742,6 +1941,8 @@ gtk_list_item_manager_dispose (GObject *object)
 
   gtk_list_item_manager_clear_model (self);
 
+  g_clear_handle_id (&self->deferred_bind_id, gtk_idle_scheduler_remove);
+  g_clear_pointer (&self->deferred_items, g_hash_table_unref);
   g_clear_pointer (&self->items, gtk_rb_tree_unref);
 
   G_OBJECT_CLASS (gtk_list_item_manager_parent_class)->dispose (object);
@@ -1753,11 +1954,17 @@ gtk_list_item_manager_class_init (GtkListItemManagerClass *klass)
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
   object_class->dispose = gtk_list_item_manager_dispose;
+
+  deferred_binds_counter = gdk_profiler_define_int_counter ("deferred-binds", "List item binds deferred");
+  completed_binds_counter = gdk_profiler_define_int_counter ("completed-binds", "Deferred list item binds completed");
+  created_widgets_counter = gdk_profiler_define_int_counter ("created-list-widgets", "List item widgets created per frame");
+  prefetched_items_counter = gdk_profiler_define_int_counter ("prefetched-list-items", "List items prepared ahead of scrolling");
 }
 
 static void
 gtk_list_item_manager_init (GtkListItemManager *self)
 {
+  self->deferred_items = g_hash_table_new (NULL, NULL);
 }
 
 void
@@ -1940,7 +2147,11 @@ gtk_list_item_tracker_set_position (GtkListItemManager *self,
 
   tile = gtk_list_item_manager_get_nth (self, position, NULL);
   if (tile)
-    tracker->widget = GTK_LIST_ITEM_BASE (tile->widget);
+    {
+      tracker->widget = GTK_LIST_ITEM_BASE (tile->widget);
+      if (!tracker->defer_binding)
+        gtk_list_item_manager_bind_now (self, tracker->widget);
+    }
 
   gtk_widget_queue_resize (self->widget);
 }
@@ -1951,3 +2162,124 @@ gtk_list_item_tracker_get_position (GtkListItemManager *self,
 {
   return tracker->position;
 }
+
+/*
+ * gtk_list_item_tracker_set_defer_binding:
+ * @self: a `GtkListItemManager`
+ * @tracker: a tracker of @self
+ * @defer_binding: whether the item of @tracker may be bound later
+ *
+ * Allows deferred binding for the item at the position of @tracker.
+ * This is meant for trackers that follow scrolling, like the anchor
+ * or prefetching, and not for ones the user interacts with, like
+ * the focus.
+ */
+void
+gtk_list_item_tracker_set_defer_binding (GtkListItemManager *self,
+                                         GtkListItemTracker *tracker,
+                                         gboolean            defer_binding)
+{
+  tracker->defer_binding = defer_binding;
+}
+
+/*
+ * gtk_list_item_tracker_bind_now:
+ * @self: a `GtkListItemManager`
+ * @tracker: a tracker of @self
+ *
+ * Binds the item of @tracker right away if its bind was deferred.
+ * This is used when the item becomes the explicit target of an
+ * operation, like scrolling to it.
+ */
+void
+gtk_list_item_tracker_bind_now (GtkListItemManager *self,
+                                GtkListItemTracker *tracker)
+{
+  gtk_list_item_manager_bind_now (self, tracker->widget);
+}
+
+/*
+ * gtk_list_item_manager_set_deferred_binding:
+ * @self: a `GtkListItemManager`
+ * @deferred: whether to defer binding items
+ *
+ * If @deferred is %TRUE, widgets for newly visible items are first
+ * shown unbound. The items are bound later, when the frame budget
+ * allows, starting with the rows closest to the bind center.
+ *
+ * This includes the rows that scroll into view. Only the items at
+ * the position of a tracker, like the focus, are bound right away,
+ * unless the tracker allows deferring with
+ * gtk_list_item_tracker_set_defer_binding().
+ */
+void
+gtk_list_item_manager_set_deferred_binding (GtkListItemManager *self,
+                                            gboolean            deferred)
+{
+  g_return_if_fail (GTK_IS_LIST_ITEM_MANAGER (self));
+
+  if (self->deferred_binding == deferred)
+    return;
+
+  self->deferred_binding = deferred;
+
+  if (!deferred)
+    {
+      GList *pending, *l;
+
+      pending = g_hash_table_get_keys (self->deferred_items);
+      for (l = pending; l; l = l->next)
+        gtk_list_item_manager_bind_now (self, l->data);
+      g_list_free (pending);
+
+      g_clear_handle_id (&self->deferred_bind_id, gtk_idle_scheduler_remove);
+    }
+}
+
+gboolean
+gtk_list_item_manager_get_deferred_binding (GtkListItemManager *self)
+{
+  g_return_val_if_fail (GTK_IS_LIST_ITEM_MANAGER (self), FALSE);
+
+  return self->deferred_binding;
+}
+
+/*
+ * gtk_list_item_manager_set_bind_center:
+ * @self: a `GtkListItemManager`
+ * @across: coordinate across the list
+ * @along: coordinate along the list
+ *
+ * Sets the point in tile coordinates around which deferred
+ * binds are prioritized. Usually this is the center of the
+ * visible area.
+ */
+void
+gtk_list_item_manager_set_bind_center (GtkListItemManager *self,
+                                       int                 across,
+                                       int                 along)
+{
+  self->bind_center_across = across;
+  self->bind_center_along = along;
+}
+
+/*
+ * gtk_list_item_manager_report_frame:
+ * @self: a `GtkListItemManager`
+ * @n_prefetched: number of items currently prepared ahead of scrolling
+ *
+ * Reports statistics about the current frame to the profiler
+ * and resets them.
+ */
+void
+gtk_list_item_manager_report_frame (GtkListItemManager *self,
+                                    guint               n_prefetched)
+{
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      gdk_profiler_set_int_counter (created_widgets_counter, self->n_created_widgets);
+      gdk_profiler_set_int_counter (prefetched_items_counter, n_prefetched);
+    }
+
+  self->n_created_widgets = 0;
+}
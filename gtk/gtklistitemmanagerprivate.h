@@ -134,6 +134,14 @@ GtkSelectionModel *     gtk_list_item_manager_get_model         (GtkListItemMana
 void                    gtk_list_item_manager_set_has_sections  (GtkListItemManager     *self,
                                                                  gboolean                has_sections);
 gboolean                gtk_list_item_manager_get_has_sections  (GtkListItemManager     *self);
+void                    gtk_list_item_manager_set_deferred_binding (GtkListItemManager  *self,
+                                                                 gboolean                deferred);
+gboolean                gtk_list_item_manager_get_deferred_binding (GtkListItemManager  *self);
+void                    gtk_list_item_manager_set_bind_center   (GtkListItemManager     *self,
+                                                                 int                     across,
+                                                                 int                     along);
+void                    gtk_list_item_manager_report_frame      (GtkListItemManager     *self,
+                                                                 guint                   n_prefetched);
 
 GtkListItemTracker *    gtk_list_item_tracker_new               (GtkListItemManager     *self);
 void                    gtk_list_item_tracker_free              (GtkListItemManager     *self,
@@ -145,6 +153,11 @@ void                    gtk_list_item_tracker_set_position      (GtkListItemMana
                                                                  guint                   n_after);
 guint                   gtk_list_item_tracker_get_position      (GtkListItemManager     *self,
                                                                  GtkListItemTracker     *tracker);
+void                    gtk_list_item_tracker_set_defer_binding (GtkListItemManager     *self,
+                                                                 GtkListItemTracker     *tracker,
+                                                                 gboolean                defer_binding);
+void                    gtk_list_item_tracker_bind_now          (GtkListItemManager     *self,
+                                                                 GtkListItemTracker     *tracker);
 
 
 G_END_DECLS
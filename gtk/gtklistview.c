@@ -22,6 +22,7 @@
 #include "gtklistviewprivate.h"
 
 #include "gtkbitset.h"
+#include "gtkcssstylechangeprivate.h"
 #include "gtklistbaseprivate.h"
 #include "gtklistheaderwidgetprivate.h"
 #include "gtklistitemmanagerprivate.h"
@@ -144,8 +145,10 @@
 enum
 {
   PROP_0,
+  PROP_DEFERRED_BINDING,
   PROP_ENABLE_RUBBERBAND,
   PROP_FACTORY,
+  PROP_FIXED_HEIGHT_MODE,
   PROP_HEADER_FACTORY,
   PROP_MODEL,
   PROP_SHOW_SEPARATORS,
@@ -201,6 +204,74 @@ gtk_list_view_prepare_section (GtkListBase *base,
 {
 }
 
+static void
+gtk_list_view_invalidate_fixed_row_size (GtkListView *self)
+{
+  self->fixed_row_minimum = -1;
+  self->fixed_row_natural = -1;
+  self->fixed_row_height = -1;
+}
+
+/* In fixed height mode, a single row is measured and all rows get
+ * its size. That size is kept until the width or the style of the
+ * list changes, so it does not change when other rows scroll into
+ * view.
+ */
+static gboolean
+gtk_list_view_get_fixed_row_size (GtkListView    *self,
+                                  GtkOrientation  orientation,
+                                  int             for_size,
+                                  int            *minimum,
+                                  int            *natural)
+{
+  GtkListTile *tile;
+
+  if (self->fixed_row_minimum < 0 ||
+      self->fixed_row_orientation != orientation ||
+      self->fixed_row_for_size != for_size)
+    {
+      for (tile = gtk_list_item_manager_get_first (self->item_manager);
+           tile != NULL;
+           tile = gtk_rb_tree_node_get_next (tile))
+        {
+          if (tile->type == GTK_LIST_TILE_ITEM && tile->widget)
+            break;
+        }
+      if (tile == NULL)
+        return FALSE;
+
+      gtk_widget_measure (tile->widget, orientation, for_size,
+                          &self->fixed_row_minimum, &self->fixed_row_natural,
+                          NULL, NULL);
+      self->fixed_row_orientation = orientation;
+      self->fixed_row_for_size = for_size;
+    }
+
+  *minimum = self->fixed_row_minimum;
+  *natural = self->fixed_row_natural;
+
+  return TRUE;
+}
+
+/* Without section headers, the rows in fixed height mode are at
+ * multiples of the row height, so positions can be computed without
+ * looking at the tiles. Returns 0 if that is not possible.
+ */
+static int
+gtk_list_view_get_fixed_row_stride (GtkListView *self)
+{
+  int spacing;
+
+  if (!self->fixed_height_mode ||
+      self->fixed_row_height <= 0 ||
+      gtk_list_item_manager_get_has_sections (self->item_manager))
+    return 0;
+
+  gtk_list_base_get_border_spacing (GTK_LIST_BASE (self), NULL, &spacing);
+
+  return self->fixed_row_height + spacing;
+}
+
 /* We define the listview as **inert** when the factory isn't used. */
 static gboolean
 gtk_list_view_is_inert (GtkListView *self)
@@ -302,6 +373,23 @@ gtk_list_view_get_allocation (GtkListBase  *base,
   GtkListView *self = GTK_LIST_VIEW (base);
   GtkListTile *tile;
   guint offset;
+  int stride;
+
+  stride = gtk_list_view_get_fixed_row_stride (self);
+  if (stride > 0)
+    {
+      tile = gtk_list_item_manager_get_first (self->item_manager);
+      if (tile == NULL || pos >= gtk_list_base_get_n_items (base))
+        return FALSE;
+
+      *area = (GdkRectangle) {
+                tile->area.x,
+                pos * stride,
+                tile->area.width,
+                self->fixed_row_height
+              };
+      return TRUE;
+    }
 
   tile = gtk_list_item_manager_get_nth (self->item_manager, pos, &offset);
   if (tile == NULL)
@@ -379,6 +467,27 @@ gtk_list_view_get_position_from_allocation (GtkListBase           *base,
 {
   GtkListView *self = GTK_LIST_VIEW (base);
   GtkListTile *tile;
+  guint n_items;
+  int stride;
+
+  stride = gtk_list_view_get_fixed_row_stride (self);
+  if (stride > 0)
+    {
+      tile = gtk_list_item_manager_get_first (self->item_manager);
+      n_items = gtk_list_base_get_n_items (base);
+      if (tile == NULL || n_items == 0)
+        return FALSE;
+
+      *pos = y < 0 ? 0 : MIN ((guint) (y / stride), n_items - 1);
+      if (area)
+        *area = (GdkRectangle) {
+                  tile->area.x,
+                  *pos * stride,
+                  tile->area.width,
+                  self->fixed_row_height
+                };
+      return TRUE;
+    }
 
   tile = gtk_list_item_manager_get_nearest_tile (self->item_manager, x, y);
   if (tile == NULL)
@@ -531,6 +640,35 @@ gtk_list_view_measure_list (GtkWidget      *widget,
     return;
   gtk_list_base_get_border_spacing (GTK_LIST_BASE (self), NULL, &spacing);
 
+  if (self->fixed_height_mode &&
+      gtk_list_view_get_fixed_row_size (self, orientation, for_size, &child_min, &child_nat))
+    {
+      min = n_items * child_min;
+      nat = n_items * child_nat;
+
+      /* section headers are the only rows that need measuring */
+      if (gtk_list_item_manager_get_has_sections (self->item_manager))
+        {
+          for (tile = gtk_list_item_manager_get_first (self->item_manager);
+               tile != NULL;
+               tile = gtk_rb_tree_node_get_next (tile))
+            {
+              if (tile->widget == NULL || tile->type == GTK_LIST_TILE_ITEM)
+                continue;
+
+              gtk_widget_measure (tile->widget,
+                                  orientation, for_size,
+                                  &child_min, &child_nat, NULL, NULL);
+              min += child_min;
+              nat += child_nat;
+            }
+        }
+
+      *minimum = min + spacing * (n_items - 1);
+      *natural = nat + spacing * (n_items - 1);
+      return;
+    }
+
   min_heights = g_array_new (FALSE, FALSE, sizeof (int));
   nat_heights = g_array_new (FALSE, FALSE, sizeof (int));
   n_unknown = 0;
@@ -599,6 +737,7 @@ gtk_list_view_size_allocate (GtkWidget *widget,
   GtkListTile *tile;
   GArray *heights;
   int min, nat, row_height, y, list_width, spacing;
+  gboolean fixed_height;
   GtkOrientation orientation, opposite_orientation;
   GtkScrollablePolicy scroll_policy, opposite_scroll_policy;
 
@@ -631,6 +770,17 @@ gtk_list_view_size_allocate (GtkWidget *widget,
   /* step 2: determine height of known list items and gc the list */
   heights = g_array_new (FALSE, FALSE, sizeof (int));
 
+  /* In fixed height mode, all rows get the height of the reference row.
+   * They have all been measured across already, so they can be allocated
+   * without measuring them again.
+   */
+  fixed_height = self->fixed_height_mode &&
+                 gtk_list_view_get_fixed_row_size (self, orientation, list_width, &min, &nat);
+  if (fixed_height)
+    self->fixed_row_height = scroll_policy == GTK_SCROLL_MINIMUM ? min : nat;
+  else
+    self->fixed_row_height = -1;
+
   for (;
        tile != NULL;
        tile = gtk_rb_tree_node_get_next (tile))
@@ -638,6 +788,14 @@ gtk_list_view_size_allocate (GtkWidget *widget,
       if (tile->widget == NULL)
         continue;
 
+      if (fixed_height && tile->type == GTK_LIST_TILE_ITEM)
+        {
+          gtk_list_tile_set_area_size (self->item_manager, tile,
+                                       list_width,
+                                       self->fixed_row_height);
+          continue;
+        }
+
       gtk_widget_measure (tile->widget, orientation,
                           list_width,
                           &min, &nat, NULL, NULL);
@@ -651,7 +809,10 @@ gtk_list_view_size_allocate (GtkWidget *widget,
     }
 
   /* step 3: determine height of unknown items and set the positions */
-  row_height = gtk_list_view_get_unknown_row_height (self, heights);
+  if (fixed_height)
+    row_height = self->fixed_row_height;
+  else
+    row_height = gtk_list_view_get_unknown_row_height (self, heights);
   g_array_free (heights, TRUE);
 
   y = 0;
@@ -676,6 +837,18 @@ gtk_list_view_size_allocate (GtkWidget *widget,
   gtk_list_base_allocate (GTK_LIST_BASE (self));
 }
 
+static void
+gtk_list_view_css_changed (GtkWidget         *widget,
+                           GtkCssStyleChange *change)
+{
+  GtkListView *self = GTK_LIST_VIEW (widget);
+
+  GTK_WIDGET_CLASS (gtk_list_view_parent_class)->css_changed (widget, change);
+
+  if (change == NULL || gtk_css_style_change_affects (change, GTK_CSS_AFFECTS_SIZE))
+    gtk_list_view_invalidate_fixed_row_size (self);
+}
+
 static void
 gtk_list_view_root (GtkWidget *widget)
 {
@@ -743,6 +916,10 @@ gtk_list_view_get_property (GObject    *object,
 
   switch (property_id)
     {
+    case PROP_DEFERRED_BINDING:
+      g_value_set_boolean (value, gtk_list_view_get_deferred_binding (self));
+      break;
+
     case PROP_ENABLE_RUBBERBAND:
       g_value_set_boolean (value, gtk_list_base_get_enable_rubberband (GTK_LIST_BASE (self)));
       break;
@@ -751,6 +928,10 @@ gtk_list_view_get_property (GObject    *object,
       g_value_set_object (value, self->factory);
       break;
 
+    case PROP_FIXED_HEIGHT_MODE:
+      g_value_set_boolean (value, self->fixed_height_mode);
+      break;
+
     case PROP_HEADER_FACTORY:
       g_value_set_object (value, self->header_factory);
       break;
@@ -787,6 +968,10 @@ gtk_list_view_set_property (GObject      *object,
 
   switch (property_id)
     {
+    case PROP_DEFERRED_BINDING:
+      gtk_list_view_set_deferred_binding (self, g_value_get_boolean (value));
+      break;
+
     case PROP_ENABLE_RUBBERBAND:
       gtk_list_view_set_enable_rubberband (self, g_value_get_boolean (value));
       break;
@@ -795,6 +980,10 @@ gtk_list_view_set_property (GObject      *object,
       gtk_list_view_set_factory (self, g_value_get_object (value));
       break;
 
+    case PROP_FIXED_HEIGHT_MODE:
+      gtk_list_view_set_fixed_height_mode (self, g_value_get_boolean (value));
+      break;
+
     case PROP_HEADER_FACTORY:
       gtk_list_view_set_header_factory (self, g_value_get_object (value));
       break;
@@ -858,6 +1047,7 @@ gtk_list_view_class_init (GtkListViewClass *klass)
 
   widget_class->measure = gtk_list_view_measure;
   widget_class->size_allocate = gtk_list_view_size_allocate;
+  widget_class->css_changed = gtk_list_view_css_changed;
   widget_class->root = gtk_list_view_root;
   widget_class->unroot = gtk_list_view_unroot;
   widget_class->show = gtk_list_view_show;
@@ -867,6 +1057,18 @@ gtk_list_view_class_init (GtkListViewClass *klass)
   gobject_class->get_property = gtk_list_view_get_property;
   gobject_class->set_property = gtk_list_view_set_property;
 
+  /**
+   * GtkListView:deferred-binding: (attributes org.gtk.Property.get=gtk_list_view_get_deferred_binding org.gtk.Property.set=gtk_list_view_set_deferred_binding)
+   *
+   * Bind items to newly visible rows in the background.
+   *
+   * Since: 4.16
+   */
+  properties[PROP_DEFERRED_BINDING] =
+    g_param_spec_boolean ("deferred-binding", NULL, NULL,
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
   /**
    * GtkListView:enable-rubberband: (attributes org.gtk.Property.get=gtk_list_view_get_enable_rubberband org.gtk.Property.set=gtk_list_view_set_enable_rubberband)
    *
@@ -889,6 +1091,18 @@ gtk_list_view_class_init (GtkListViewClass *klass)
                          GTK_TYPE_LIST_ITEM_FACTORY,
                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GtkListView:fixed-height-mode: (attributes org.gtk.Property.get=gtk_list_view_get_fixed_height_mode org.gtk.Property.set=gtk_list_view_set_fixed_height_mode)
+   *
+   * Assume that all rows have the same height.
+   *
+   * Since: 4.16
+   */
+  properties[PROP_FIXED_HEIGHT_MODE] =
+    g_param_spec_boolean ("fixed-height-mode", NULL, NULL,
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
   /**
    * GtkListView:header-factory: (attributes org.gtk.Property.get=gtk_list_view_get_header_factory org.gtk.Property.set=gtk_list_view_set_header_factory)
    *
@@ -998,6 +1212,8 @@ gtk_list_view_init (GtkListView *self)
                                         GTK_LIST_VIEW_MAX_LIST_ITEMS,
                                         GTK_LIST_VIEW_EXTRA_ITEMS);
 
+  gtk_list_view_invalidate_fixed_row_size (self);
+
   gtk_widget_add_css_class (GTK_WIDGET (self), "view");
 }
 
@@ -1114,6 +1330,7 @@ gtk_list_view_set_factory (GtkListView        *self,
   if (!g_set_object (&self->factory, factory))
     return;
 
+  gtk_list_view_invalidate_fixed_row_size (self);
   gtk_list_view_update_factories (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_FACTORY]);
@@ -1353,6 +1570,118 @@ gtk_list_view_get_tab_behavior (GtkListView *self)
   return gtk_list_base_get_tab_behavior (GTK_LIST_BASE (self));
 }
 
+/**
+ * gtk_list_view_set_fixed_height_mode: (attributes org.gtk.Method.set_property=fixed-height-mode)
+ * @self: a `GtkListView`
+ * @fixed_height_mode: %TRUE to enable fixed height mode
+ *
+ * Sets whether all rows of @self are assumed to have the same height.
+ *
+ * When enabled, a single row is measured, and all rows are given its
+ * height. It is measured again only when the width or the style of
+ * the list changes, so the size of the list does not change while
+ * scrolling. Without sections, the position of a row is computed
+ * from its index, which makes jumping far into very long lists cheap.
+ *
+ * Only enable this if your rows really have a uniform height,
+ * otherwise their contents will be clipped or padded. Section
+ * headers are still measured individually.
+ *
+ * Since: 4.16
+ */
+void
+gtk_list_view_set_fixed_height_mode (GtkListView *self,
+                                     gboolean     fixed_height_mode)
+{
+  g_return_if_fail (GTK_IS_LIST_VIEW (self));
+
+  if (self->fixed_height_mode == fixed_height_mode)
+    return;
+
+  self->fixed_height_mode = fixed_height_mode;
+  gtk_list_view_invalidate_fixed_row_size (self);
+
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_FIXED_HEIGHT_MODE]);
+}
+
+/**
+ * gtk_list_view_get_fixed_height_mode: (attributes org.gtk.Method.get_property=fixed-height-mode)
+ * @self: a `GtkListView`
+ *
+ * Returns whether all rows are assumed to have the same height.
+ *
+ * Returns: %TRUE if fixed height mode is enabled
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_list_view_get_fixed_height_mode (GtkListView *self)
+{
+  g_return_val_if_fail (GTK_IS_LIST_VIEW (self), FALSE);
+
+  return self->fixed_height_mode;
+}
+
+/**
+ * gtk_list_view_set_deferred_binding: (attributes org.gtk.Method.set_property=deferred-binding)
+ * @self: a `GtkListView`
+ * @deferred_binding: %TRUE to bind items in the background
+ *
+ * Sets whether items are bound to newly visible rows in the background.
+ *
+ * When enabled, rows that scroll into view or are prepared ahead of
+ * scrolling are first shown as placeholders, see
+ * [signal@Gtk.SignalListItemFactory::placeholder]. The items are then
+ * bound in the time left between frames, starting with the rows
+ * closest to the center of the view. This keeps scrolling smooth when
+ * binding is expensive, like when it involves loading images.
+ *
+ * The focused item and items that are scrolled to explicitly are
+ * always bound right away.
+ *
+ * For this to look good, the rows should have the same size before
+ * and after binding.
+ *
+ * Since: 4.16
+ */
+void
+gtk_list_view_set_deferred_binding (GtkListView *self,
+                                    gboolean     deferred_binding)
+{
+  GtkListItemManager *manager;
+
+  g_return_if_fail (GTK_IS_LIST_VIEW (self));
+
+  manager = gtk_list_base_get_manager (GTK_LIST_BASE (self));
+  if (gtk_list_item_manager_get_deferred_binding (manager) == deferred_binding)
+    return;
+
+  gtk_list_item_manager_set_deferred_binding (manager, deferred_binding);
+  gtk_widget_queue_allocate (GTK_WIDGET (self));
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_DEFERRED_BINDING]);
+}
+
+/**
+ * gtk_list_view_get_deferred_binding: (attributes org.gtk.Method.get_property=deferred-binding)
+ * @self: a `GtkListView`
+ *
+ * Returns whether items are bound to newly visible rows in the background.
+ *
+ * Returns: %TRUE if binding is deferred
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_list_view_get_deferred_binding (GtkListView *self)
+{
+  g_return_val_if_fail (GTK_IS_LIST_VIEW (self), FALSE);
+
+  return gtk_list_item_manager_get_deferred_binding (gtk_list_base_get_manager (GTK_LIST_BASE (self)));
+}
+
 /**
  * gtk_list_view_scroll_to:
  * @self: The listview to scroll in
@@ -89,6 +89,18 @@ GDK_AVAILABLE_IN_4_12
 GtkListTabBehavior
                 gtk_list_view_get_tab_behavior                  (GtkListView            *self);
 
+GDK_AVAILABLE_IN_4_16
+void            gtk_list_view_set_fixed_height_mode             (GtkListView            *self,
+                                                                 gboolean                fixed_height_mode);
+GDK_AVAILABLE_IN_4_16
+gboolean        gtk_list_view_get_fixed_height_mode             (GtkListView            *self);
+
+GDK_AVAILABLE_IN_4_16
+void            gtk_list_view_set_deferred_binding              (GtkListView            *self,
+                                                                 gboolean                deferred_binding);
+GDK_AVAILABLE_IN_4_16
+gboolean        gtk_list_view_get_deferred_binding              (GtkListView            *self);
+
 GDK_AVAILABLE_IN_4_12
 void            gtk_list_view_scroll_to                         (GtkListView            *self,
                                                                  guint                   pos,
@@ -33,6 +33,15 @@ struct _GtkListView
   GtkListItemFactory *header_factory;
   gboolean show_separators;
   gboolean single_click_activate;
+  gboolean fixed_height_mode;
+
+  /* the size of the reference row in fixed height mode */
+  GtkOrientation fixed_row_orientation;
+  int fixed_row_for_size;
+  int fixed_row_minimum;
+  int fixed_row_natural;
+  /* the height all rows were last allocated with, or -1 */
+  int fixed_row_height;
 };
 
 struct _GtkListViewClass
@@ -0,0 +1,381 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkmeasurecacheprivate.h"
+
+#include <pango/pangocairo.h>
+
+/* A process-wide cache of measurements.
+ *
+ * The size request cache of a widget is per instance and thrown away
+ * whenever the widget queues a resize. For leaf widgets whose size only
+ * depends on their content and their style, like labels and images,
+ * that means the same measurement is done over and over when list rows
+ * get recycled and rebound to the same content.
+ *
+ * Such widgets can provide a key of everything their measure function
+ * looks at apart from the style (see gtk_widget_class_set_measure_key_func()),
+ * and their measurements are then shared here, keyed on the widget type,
+ * that key, the style and the size the widget is measured for.
+ *
+ * Styles are compared by identity. Widgets with the same style
+ * declarations in the same place of the tree share their style, so
+ * recycled rows find the measurements of their predecessors.
+ */
+
+/* Maximum number of measurements kept around */
+#define MAX_ENTRIES 4096
+
+typedef struct _CacheKey CacheKey;
+typedef struct _CacheEntry CacheEntry;
+
+struct _CacheKey
+{
+  GType type;
+  GtkMeasureKey content;
+  GtkCssStyle *style;
+  GtkOrientation orientation;
+  int for_size;
+};
+
+struct _CacheEntry
+{
+  CacheKey key;
+  int minimum;
+  int natural;
+  int minimum_baseline;
+  int natural_baseline;
+  GList lru_link;
+};
+
+static GHashTable *cache;
+static GQueue lru;
+static guint64 n_hits;
+static guint64 n_misses;
+static guint64 n_evictions;
+
+static guint
+cache_key_hash (gconstpointer data)
+{
+  const CacheKey *key = data;
+  guint hash;
+
+  hash = (guint) (key->content.hash ^ (key->content.hash >> 32));
+  hash = (hash << 5) - hash + g_direct_hash (key->style);
+  hash = (hash << 5) - hash + (guint) key->type;
+  hash = (hash << 5) - hash + (guint) key->for_size;
+  hash = (hash << 5) - hash + key->orientation;
+
+  return hash;
+}
+
+static gboolean
+attr_lists_equal (PangoAttrList *a,
+                  PangoAttrList *b)
+{
+  if (a == b)
+    return TRUE;
+
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  return pango_attr_list_equal (a, b);
+}
+
+static gboolean
+cache_key_equal (gconstpointer data1,
+                 gconstpointer data2)
+{
+  const CacheKey *a = data1;
+  const CacheKey *b = data2;
+  guint i;
+
+  if (a->content.hash != b->content.hash ||
+      a->style != b->style ||
+      a->type != b->type ||
+      a->for_size != b->for_size ||
+      a->orientation != b->orientation ||
+      a->content.bytes->len != b->content.bytes->len ||
+      a->content.n_attr_lists != b->content.n_attr_lists)
+    return FALSE;
+
+  if (memcmp (a->content.bytes->data, b->content.bytes->data, a->content.bytes->len) != 0)
+    return FALSE;
+
+  for (i = 0; i < a->content.n_attr_lists; i++)
+    {
+      if (!attr_lists_equal (a->content.attr_lists[i], b->content.attr_lists[i]))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static void
+cache_entry_free (gpointer data)
+{
+  CacheEntry *entry = data;
+  guint i;
+
+  /* Entries own copies of the attribute lists */
+  for (i = 0; i < entry->key.content.n_attr_lists; i++)
+    g_clear_pointer (&entry->key.content.attr_lists[i], pango_attr_list_unref);
+  entry->key.content.n_attr_lists = 0;
+  gtk_measure_key_clear (&entry->key.content);
+  g_object_unref (entry->key.style);
+  g_free (entry);
+}
+
+static void
+cache_evict_last (void)
+{
+  CacheEntry *entry = g_queue_peek_tail (&lru);
+
+  g_queue_unlink (&lru, &entry->lru_link);
+  g_hash_table_remove (cache, &entry->key);
+}
+
+/*
+ * gtk_measure_key_init:
+ * @key: a `GtkMeasureKey`
+ *
+ * Initializes an empty key.
+ */
+void
+gtk_measure_key_init (GtkMeasureKey *key)
+{
+  key->hash = G_GUINT64_CONSTANT (0xcbf29ce484222325);
+  key->bytes = g_byte_array_sized_new (64);
+  key->n_attr_lists = 0;
+}
+
+/*
+ * gtk_measure_key_clear:
+ * @key: a `GtkMeasureKey`
+ *
+ * Frees the contents of @key. The attribute lists are
+ * not owned by the key.
+ */
+void
+gtk_measure_key_clear (GtkMeasureKey *key)
+{
+  g_clear_pointer (&key->bytes, g_byte_array_unref);
+}
+
+/*
+ * gtk_measure_key_add_pango_context:
+ * @key: a `GtkMeasureKey`
+ * @context: a `PangoContext`
+ *
+ * Adds the settings of @context that affect the size of text,
+ * apart from the font description, which is part of the style.
+ */
+void
+gtk_measure_key_add_pango_context (GtkMeasureKey *key,
+                                   PangoContext  *context)
+{
+  const cairo_font_options_t *options;
+  PangoFontMap *fontmap;
+  PangoLanguage *language;
+  PangoDirection direction;
+  PangoGravity gravity;
+  double resolution;
+  gboolean round;
+
+  fontmap = pango_context_get_font_map (context);
+  language = pango_context_get_language (context);
+  direction = pango_context_get_base_dir (context);
+  gravity = pango_context_get_base_gravity (context);
+  resolution = pango_cairo_context_get_resolution (context);
+  round = pango_context_get_round_glyph_positions (context);
+
+  gtk_measure_key_add_value (key, fontmap);
+  gtk_measure_key_add_value (key, language);
+  gtk_measure_key_add_value (key, direction);
+  gtk_measure_key_add_value (key, gravity);
+  gtk_measure_key_add_value (key, resolution);
+  gtk_measure_key_add_value (key, round);
+
+  options = pango_cairo_context_get_font_options (context);
+  if (options)
+    {
+      cairo_antialias_t antialias = cairo_font_options_get_antialias (options);
+      cairo_subpixel_order_t subpixel_order = cairo_font_options_get_subpixel_order (options);
+      cairo_hint_style_t hint_style = cairo_font_options_get_hint_style (options);
+      cairo_hint_metrics_t hint_metrics = cairo_font_options_get_hint_metrics (options);
+
+      gtk_measure_key_add_value (key, antialias);
+      gtk_measure_key_add_value (key, subpixel_order);
+      gtk_measure_key_add_value (key, hint_style);
+      gtk_measure_key_add_value (key, hint_metrics);
+      gtk_measure_key_add_string (key, cairo_font_options_get_variations ((cairo_font_options_t *) options));
+    }
+}
+
+/*
+ * gtk_measure_key_add_attr_list:
+ * @key: a `GtkMeasureKey`
+ * @attrs: (nullable): a `PangoAttrList`
+ *
+ * Adds the attributes in @attrs.
+ *
+ * Attribute lists are compared with pango_attr_list_equal() and
+ * don't contribute to the hash, so that building a key does not
+ * have to look at their contents.
+ */
+void
+gtk_measure_key_add_attr_list (GtkMeasureKey *key,
+                               PangoAttrList *attrs)
+{
+  g_return_if_fail (key->n_attr_lists < GTK_MEASURE_KEY_MAX_ATTR_LISTS);
+
+  key->attr_lists[key->n_attr_lists++] = attrs;
+}
+
+/*
+ * gtk_measure_cache_lookup:
+ * @type: the type of the measured widget
+ * @key: the key of the widget content
+ * @style: the style of the widget
+ * @orientation: the orientation to measure in
+ * @for_size: the size in the opposite orientation, or -1
+ * @minimum: (out): return location for the minimum size
+ * @natural: (out): return location for the natural size
+ * @minimum_baseline: (out): return location for the minimum baseline
+ * @natural_baseline: (out): return location for the natural baseline
+ *
+ * Looks up a measurement that was done for a widget of the same
+ * type, content and style.
+ *
+ * Returns: %TRUE if the measurement was found
+ */
+gboolean
+gtk_measure_cache_lookup (GType                type,
+                          const GtkMeasureKey *key,
+                          GtkCssStyle         *style,
+                          GtkOrientation       orientation,
+                          int                  for_size,
+                          int                 *minimum,
+                          int                 *natural,
+                          int                 *minimum_baseline,
+                          int                 *natural_baseline)
+{
+  CacheKey cache_key = { type, *key, style, orientation, for_size };
+  CacheEntry *entry;
+
+  if (G_UNLIKELY (cache == NULL))
+    cache = g_hash_table_new_full (cache_key_hash, cache_key_equal, NULL, cache_entry_free);
+
+  entry = g_hash_table_lookup (cache, &cache_key);
+  if (entry == NULL)
+    {
+      n_misses++;
+      return FALSE;
+    }
+
+  n_hits++;
+
+  g_queue_unlink (&lru, &entry->lru_link);
+  g_queue_push_head_link (&lru, &entry->lru_link);
+
+  *minimum = entry->minimum;
+  *natural = entry->natural;
+  *minimum_baseline = entry->minimum_baseline;
+  *natural_baseline = entry->natural_baseline;
+
+  return TRUE;
+}
+
+/*
+ * gtk_measure_cache_insert:
+ *
+ * Adds a measurement, after gtk_measure_cache_lookup()
+ * did not find it. The contents of @key are taken over.
+ */
+void
+gtk_measure_cache_insert (GType           type,
+                          GtkMeasureKey  *key,
+                          GtkCssStyle    *style,
+                          GtkOrientation  orientation,
+                          int             for_size,
+                          int             minimum,
+                          int             natural,
+                          int             minimum_baseline,
+                          int             natural_baseline)
+{
+  CacheEntry *entry;
+  guint i;
+
+  entry = g_new0 (CacheEntry, 1);
+  entry->key.type = type;
+  entry->key.content = *key;
+  key->bytes = NULL;
+  /* The widget may change its lists later */
+  for (i = 0; i < entry->key.content.n_attr_lists; i++)
+    {
+      if (entry->key.content.attr_lists[i])
+        entry->key.content.attr_lists[i] = pango_attr_list_copy (entry->key.content.attr_lists[i]);
+    }
+  entry->key.style = g_object_ref (style);
+  entry->key.orientation = orientation;
+  entry->key.for_size = for_size;
+  entry->minimum = minimum;
+  entry->natural = natural;
+  entry->minimum_baseline = minimum_baseline;
+  entry->natural_baseline = natural_baseline;
+  entry->lru_link.data = entry;
+
+  /* The widget may have been measured recursively */
+  if (g_hash_table_contains (cache, &entry->key))
+    {
+      cache_entry_free (entry);
+      return;
+    }
+
+  g_hash_table_add (cache, entry);
+  g_queue_push_head_link (&lru, &entry->lru_link);
+
+  while (lru.length > MAX_ENTRIES)
+    {
+      cache_evict_last ();
+      n_evictions++;
+    }
+}
+
+/*
+ * gtk_measure_cache_clear:
+ *
+ * Drops all measurements from the cache.
+ */
+void
+gtk_measure_cache_clear (void)
+{
+  while (lru.length > 0)
+    cache_evict_last ();
+}
+
+void
+gtk_measure_cache_get_stats (GtkMeasureCacheStats *stats)
+{
+  stats->n_entries = lru.length;
+  stats->max_entries = MAX_ENTRIES;
+  stats->n_hits = n_hits;
+  stats->n_misses = n_misses;
+  stats->n_evictions = n_evictions;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gtkcssstyleprivate.h"
+
+#include <pango/pango.h>
+#include <string.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GtkMeasureCacheStats GtkMeasureCacheStats;
+
+struct _GtkMeasureCacheStats
+{
+  guint   n_entries;
+  guint   max_entries;
+  guint64 n_hits;
+  guint64 n_misses;
+  guint64 n_evictions;
+};
+
+typedef struct _GtkMeasureKey GtkMeasureKey;
+
+#define GTK_MEASURE_KEY_MAX_ATTR_LISTS 2
+
+/* Everything apart from the style that the measurements of a widget
+ * depend on. The cache compares keys in full, the hash only speeds
+ * up finding them */
+struct _GtkMeasureKey
+{
+  guint64 hash;
+  GByteArray *bytes;
+  PangoAttrList *attr_lists[GTK_MEASURE_KEY_MAX_ATTR_LISTS];
+  guint n_attr_lists;
+};
+
+void            gtk_measure_key_init                    (GtkMeasureKey         *key);
+void            gtk_measure_key_clear                   (GtkMeasureKey         *key);
+
+/* FNV-1a, over the same bytes that are compared */
+static inline void
+gtk_measure_key_add_bytes (GtkMeasureKey *key,
+                           gconstpointer  data,
+                           gsize          size)
+{
+  const guchar *p = data;
+  gsize i;
+
+  for (i = 0; i < size; i++)
+    {
+      key->hash ^= p[i];
+      key->hash *= G_GUINT64_CONSTANT (0x100000001b3);
+    }
+
+  g_byte_array_append (key->bytes, data, size);
+}
+
+#define gtk_measure_key_add_value(key, value) \
+  gtk_measure_key_add_bytes ((key), &(value), sizeof (value))
+
+static inline void
+gtk_measure_key_add_string (GtkMeasureKey *key,
+                            const char    *str)
+{
+  if (str == NULL)
+    str = "";
+
+  /* Include the terminator, so that "ab" + "c" differs from "a" + "bc" */
+  gtk_measure_key_add_bytes (key, str, strlen (str) + 1);
+}
+
+void            gtk_measure_key_add_pango_context       (GtkMeasureKey         *key,
+                                                         PangoContext          *context);
+void            gtk_measure_key_add_attr_list           (GtkMeasureKey         *key,
+                                                         PangoAttrList         *attrs);
+
+gboolean        gtk_measure_cache_lookup                (GType                  type,
+                                                         const GtkMeasureKey   *key,
+                                                         GtkCssStyle           *style,
+                                                         GtkOrientation         orientation,
+                                                         int                    for_size,
+                                                         int                   *minimum,
+                                                         int                   *natural,
+                                                         int                   *minimum_baseline,
+                                                         int                   *natural_baseline);
+void            gtk_measure_cache_insert                (GType                  type,
+                                                         GtkMeasureKey         *key,
+                                                         GtkCssStyle           *style,
+                                                         GtkOrientation         orientation,
+                                                         int                    for_size,
+                                                         int                    minimum,
+                                                         int                    natural,
+                                                         int                    minimum_baseline,
+                                                         int                    natural_baseline);
+void            gtk_measure_cache_clear                 (void);
+void            gtk_measure_cache_get_stats             (GtkMeasureCacheStats  *stats);
+
+G_END_DECLS
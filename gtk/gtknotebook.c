@@ -333,6 +333,7 @@ enum {
   PROP_ENABLE_POPUP,
   PROP_GROUP_NAME,
   PROP_PAGES,
+  PROP_VIRTUALIZED,
   LAST_PROP
 };
 
@@ -1178,6 +1179,18 @@ gtk_notebook_class_init (GtkNotebookClass *class)
                            G_TYPE_LIST_MODEL,
                            GTK_PARAM_READABLE);
 
+  /**
+   * GtkNotebook:virtualized: (attributes org.gtk.Property.get=gtk_notebook_get_virtualized org.gtk.Property.set=gtk_notebook_set_virtualized)
+   *
+   * Whether pages that are not shown are put to sleep after a while.
+   *
+   * Since: 4.16
+   */
+  properties[PROP_VIRTUALIZED] =
+      g_param_spec_boolean ("virtualized", NULL, NULL,
+                            FALSE,
+                            GTK_PARAM_READWRITE|G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (gobject_class, LAST_PROP, properties);
 
   /**
@@ -1944,6 +1957,9 @@ gtk_notebook_set_property (GObject         *object,
     case PROP_GROUP_NAME:
       gtk_notebook_set_group_name (notebook, g_value_get_string (value));
       break;
+    case PROP_VIRTUALIZED:
+      gtk_notebook_set_virtualized (notebook, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1984,6 +2000,9 @@ gtk_notebook_get_property (GObject         *object,
     case PROP_PAGES:
       g_value_take_object (value, gtk_notebook_get_pages (notebook));
       break;
+    case PROP_VIRTUALIZED:
+      g_value_set_boolean (value, gtk_notebook_get_virtualized (notebook));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -7345,3 +7364,47 @@ gtk_notebook_get_pages (GtkNotebook *notebook)
   return notebook->pages;
 }
 
+/**
+ * gtk_notebook_set_virtualized: (attributes org.gtk.Method.set_property=virtualized)
+ * @notebook: a `GtkNotebook`
+ * @virtualized: whether to put hidden pages to sleep
+ *
+ * Sets whether pages that are not shown are put to sleep.
+ *
+ * This is useful for notebooks with lots of pages.
+ * See [method@Gtk.Stack.set_virtualized] for details.
+ *
+ * Since: 4.16
+ */
+void
+gtk_notebook_set_virtualized (GtkNotebook *notebook,
+                              gboolean     virtualized)
+{
+  g_return_if_fail (GTK_IS_NOTEBOOK (notebook));
+
+  if (gtk_stack_get_virtualized (GTK_STACK (notebook->stack_widget)) == !!virtualized)
+    return;
+
+  gtk_stack_set_virtualized (GTK_STACK (notebook->stack_widget), virtualized);
+
+  g_object_notify_by_pspec (G_OBJECT (notebook), properties[PROP_VIRTUALIZED]);
+}
+
+/**
+ * gtk_notebook_get_virtualized: (attributes org.gtk.Method.get_property=virtualized)
+ * @notebook: a `GtkNotebook`
+ *
+ * Returns whether pages that are not shown are put to sleep.
+ *
+ * Returns: %TRUE if @notebook is virtualized
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_notebook_get_virtualized (GtkNotebook *notebook)
+{
+  g_return_val_if_fail (GTK_IS_NOTEBOOK (notebook), FALSE);
+
+  return gtk_stack_get_virtualized (GTK_STACK (notebook->stack_widget));
+}
+
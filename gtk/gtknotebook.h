@@ -242,6 +242,12 @@ GtkWidget *gtk_notebook_page_get_child (GtkNotebookPage *page);
 GDK_AVAILABLE_IN_ALL
 GListModel *gtk_notebook_get_pages (GtkNotebook *notebook);
 
+GDK_AVAILABLE_IN_4_16
+void       gtk_notebook_set_virtualized (GtkNotebook *notebook,
+                                         gboolean     virtualized);
+GDK_AVAILABLE_IN_4_16
+gboolean   gtk_notebook_get_virtualized (GtkNotebook *notebook);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GtkNotebook, g_object_unref)
 
 G_END_DECLS
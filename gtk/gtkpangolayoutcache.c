@@ -0,0 +1,459 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkpangolayoutcacheprivate.h"
+
+#include <pango/pangocairo.h>
+#include <string.h>
+
+/* A process-wide cache of shaped layouts.
+ *
+ * Widgets in list rows tend to show the same short strings over and
+ * over (units, status values, dates, ...). Instead of shaping them in
+ * a fresh PangoLayout for every row, they can look up a shared layout
+ * here that has the same text, attributes, context settings and width
+ * as their own layout.
+ *
+ * Layouts handed out by the cache are shared, so they must be treated
+ * as read-only by callers. Each of them has a private PangoContext with
+ * the settings of the context it was requested with, so later changes
+ * to the context of the requesting widget don't reach them.
+ */
+
+/* Maximum number of layouts kept around */
+#define MAX_ENTRIES 1024
+
+/* Long texts are unlikely to repeat and expensive to keep around */
+#define MAX_TEXT_LENGTH 1024
+
+typedef struct _ContextState ContextState;
+typedef struct _CacheKey CacheKey;
+typedef struct _CacheEntry CacheEntry;
+
+/* The settings of the PangoContext that a layout was shaped with.
+ *
+ * Contexts change when fonts or the resolution change, so the cache
+ * keeps a copy of their settings instead of reading the live context,
+ * which would change the hash of entries that are already in the table.
+ */
+struct _ContextState
+{
+  PangoFontMap *font_map;
+  PangoDirection base_dir;
+  PangoGravity base_gravity;
+  PangoGravityHint gravity_hint;
+  PangoLanguage *language;
+  gboolean round_glyph_positions;
+  double resolution;
+  gboolean has_matrix;
+  PangoMatrix matrix;
+  cairo_font_options_t *font_options;
+  PangoFontDescription *font_desc;
+};
+
+struct _CacheKey
+{
+  PangoLayout *layout;
+  int width;
+  guint hash;
+  ContextState context;
+};
+
+struct _CacheEntry
+{
+  CacheKey key;
+  GList lru_link;
+};
+
+static GHashTable *cache;
+static GQueue lru;
+static guint64 n_hits;
+static guint64 n_misses;
+static guint64 n_evictions;
+
+static void
+context_state_init (ContextState *state,
+                    PangoContext *context,
+                    gboolean      copy)
+{
+  const PangoMatrix *matrix;
+  const cairo_font_options_t *font_options;
+  const PangoFontDescription *font_desc;
+
+  state->font_map = pango_context_get_font_map (context);
+  state->base_dir = pango_context_get_base_dir (context);
+  state->base_gravity = pango_context_get_base_gravity (context);
+  state->gravity_hint = pango_context_get_gravity_hint (context);
+  state->language = pango_context_get_language (context);
+  state->round_glyph_positions = pango_context_get_round_glyph_positions (context);
+  state->resolution = pango_cairo_context_get_resolution (context);
+
+  matrix = pango_context_get_matrix (context);
+  state->has_matrix = matrix != NULL;
+  if (matrix)
+    state->matrix = *matrix;
+
+  font_options = pango_cairo_context_get_font_options (context);
+  font_desc = pango_context_get_font_description (context);
+
+  if (copy)
+    {
+      if (state->font_map)
+        g_object_ref (state->font_map);
+      state->font_options = font_options ? cairo_font_options_copy (font_options) : NULL;
+      state->font_desc = font_desc ? pango_font_description_copy (font_desc) : NULL;
+    }
+  else
+    {
+      state->font_options = (cairo_font_options_t *) font_options;
+      state->font_desc = (PangoFontDescription *) font_desc;
+    }
+}
+
+static PangoContext *
+context_state_create_context (const ContextState *state)
+{
+  PangoContext *context;
+
+  context = pango_font_map_create_context (state->font_map);
+  pango_context_set_base_dir (context, state->base_dir);
+  pango_context_set_base_gravity (context, state->base_gravity);
+  pango_context_set_gravity_hint (context, state->gravity_hint);
+  pango_context_set_language (context, state->language);
+  pango_context_set_round_glyph_positions (context, state->round_glyph_positions);
+  pango_cairo_context_set_resolution (context, state->resolution);
+  pango_context_set_matrix (context, state->has_matrix ? &state->matrix : NULL);
+  pango_cairo_context_set_font_options (context, state->font_options);
+  pango_context_set_font_description (context, state->font_desc);
+
+  return context;
+}
+
+static void
+context_state_clear (ContextState *state)
+{
+  g_clear_object (&state->font_map);
+  g_clear_pointer (&state->font_options, cairo_font_options_destroy);
+  g_clear_pointer (&state->font_desc, pango_font_description_free);
+}
+
+static gboolean
+matrix_equal (const PangoMatrix *a,
+              const PangoMatrix *b)
+{
+  return a->xx == b->xx && a->xy == b->xy &&
+         a->yx == b->yx && a->yy == b->yy &&
+         a->x0 == b->x0 && a->y0 == b->y0;
+}
+
+static gboolean
+font_options_equal (const cairo_font_options_t *a,
+                    const cairo_font_options_t *b)
+{
+  if (a == b)
+    return TRUE;
+
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  return cairo_font_options_equal (a, b);
+}
+
+static gboolean
+font_description_equal (const PangoFontDescription *a,
+                        const PangoFontDescription *b)
+{
+  if (a == b)
+    return TRUE;
+
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  return pango_font_description_equal (a, b);
+}
+
+static gboolean
+context_state_equal (const ContextState *a,
+                     const ContextState *b)
+{
+  return a->font_map == b->font_map &&
+         a->base_dir == b->base_dir &&
+         a->base_gravity == b->base_gravity &&
+         a->gravity_hint == b->gravity_hint &&
+         a->language == b->language &&
+         a->round_glyph_positions == b->round_glyph_positions &&
+         a->resolution == b->resolution &&
+         a->has_matrix == b->has_matrix &&
+         (!a->has_matrix || matrix_equal (&a->matrix, &b->matrix)) &&
+         font_options_equal (a->font_options, b->font_options) &&
+         font_description_equal (a->font_desc, b->font_desc);
+}
+
+static gboolean
+attr_list_equal (PangoAttrList *a,
+                 PangoAttrList *b)
+{
+  if (a == b)
+    return TRUE;
+
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  return pango_attr_list_equal (a, b);
+}
+
+static gboolean
+tab_array_equal (PangoTabArray *a,
+                 PangoTabArray *b)
+{
+  char *sa, *sb;
+  gboolean result;
+
+  if (a == b)
+    return TRUE;
+
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  sa = pango_tab_array_to_string (a);
+  sb = pango_tab_array_to_string (b);
+  result = strcmp (sa, sb) == 0;
+  g_free (sa);
+  g_free (sb);
+
+  return result;
+}
+
+static guint
+cache_key_hash (gconstpointer data)
+{
+  const CacheKey *key = data;
+
+  return key->hash;
+}
+
+static gboolean
+cache_key_equal (gconstpointer data1,
+                 gconstpointer data2)
+{
+  const CacheKey *a = data1;
+  const CacheKey *b = data2;
+
+  if (a->hash != b->hash || a->width != b->width)
+    return FALSE;
+
+  return pango_layout_get_height (a->layout) == pango_layout_get_height (b->layout) &&
+         pango_layout_get_wrap (a->layout) == pango_layout_get_wrap (b->layout) &&
+         pango_layout_get_ellipsize (a->layout) == pango_layout_get_ellipsize (b->layout) &&
+         pango_layout_get_alignment (a->layout) == pango_layout_get_alignment (b->layout) &&
+         pango_layout_get_justify (a->layout) == pango_layout_get_justify (b->layout) &&
+         pango_layout_get_justify_last_line (a->layout) == pango_layout_get_justify_last_line (b->layout) &&
+         pango_layout_get_indent (a->layout) == pango_layout_get_indent (b->layout) &&
+         pango_layout_get_spacing (a->layout) == pango_layout_get_spacing (b->layout) &&
+         pango_layout_get_line_spacing (a->layout) == pango_layout_get_line_spacing (b->layout) &&
+         pango_layout_get_auto_dir (a->layout) == pango_layout_get_auto_dir (b->layout) &&
+         pango_layout_get_single_paragraph_mode (a->layout) == pango_layout_get_single_paragraph_mode (b->layout) &&
+         strcmp (pango_layout_get_text (a->layout), pango_layout_get_text (b->layout)) == 0 &&
+         font_description_equal (pango_layout_get_font_description (a->layout),
+                                 pango_layout_get_font_description (b->layout)) &&
+         attr_list_equal (pango_layout_get_attributes (a->layout),
+                          pango_layout_get_attributes (b->layout)) &&
+         tab_array_equal (pango_layout_get_tabs (a->layout),
+                          pango_layout_get_tabs (b->layout)) &&
+         context_state_equal (&a->context, &b->context);
+}
+
+static void
+cache_entry_free (gpointer data)
+{
+  CacheEntry *entry = data;
+
+  g_object_unref (entry->key.layout);
+  context_state_clear (&entry->key.context);
+  g_free (entry);
+}
+
+static void
+cache_key_init (CacheKey    *key,
+                PangoLayout *layout,
+                int          width,
+                gboolean     copy_context)
+{
+  PangoContext *context = pango_layout_get_context (layout);
+  const PangoFontDescription *desc;
+  guint hash;
+
+  key->layout = layout;
+  key->width = width;
+  context_state_init (&key->context, context, copy_context);
+
+  hash = g_str_hash (pango_layout_get_text (layout));
+  hash = (hash << 5) - hash + (guint) width;
+  hash = (hash << 5) - hash + (guint) pango_layout_get_height (layout);
+  hash = (hash << 5) - hash + (guint) key->context.resolution;
+  if (key->context.font_desc)
+    hash = (hash << 5) - hash + pango_font_description_hash (key->context.font_desc);
+
+  desc = pango_layout_get_font_description (layout);
+  if (desc)
+    hash = (hash << 5) - hash + pango_font_description_hash (desc);
+
+  key->hash = hash;
+}
+
+/* Copies @layout into a new layout on @context */
+static PangoLayout *
+layout_copy_to_context (PangoLayout  *layout,
+                        PangoContext *context)
+{
+  PangoLayout *copy;
+  PangoTabArray *tabs;
+
+  copy = pango_layout_new (context);
+
+  pango_layout_set_text (copy, pango_layout_get_text (layout), -1);
+  pango_layout_set_attributes (copy, pango_layout_get_attributes (layout));
+  pango_layout_set_font_description (copy, pango_layout_get_font_description (layout));
+  tabs = pango_layout_get_tabs (layout);
+  if (tabs)
+    {
+      pango_layout_set_tabs (copy, tabs);
+      pango_tab_array_free (tabs);
+    }
+  pango_layout_set_height (copy, pango_layout_get_height (layout));
+  pango_layout_set_wrap (copy, pango_layout_get_wrap (layout));
+  pango_layout_set_ellipsize (copy, pango_layout_get_ellipsize (layout));
+  pango_layout_set_alignment (copy, pango_layout_get_alignment (layout));
+  pango_layout_set_justify (copy, pango_layout_get_justify (layout));
+  pango_layout_set_justify_last_line (copy, pango_layout_get_justify_last_line (layout));
+  pango_layout_set_indent (copy, pango_layout_get_indent (layout));
+  pango_layout_set_spacing (copy, pango_layout_get_spacing (layout));
+  pango_layout_set_line_spacing (copy, pango_layout_get_line_spacing (layout));
+  pango_layout_set_auto_dir (copy, pango_layout_get_auto_dir (layout));
+  pango_layout_set_single_paragraph_mode (copy, pango_layout_get_single_paragraph_mode (layout));
+
+  return copy;
+}
+
+static void
+cache_evict_last (void)
+{
+  CacheEntry *entry = g_queue_peek_tail (&lru);
+
+  g_queue_unlink (&lru, &entry->lru_link);
+  g_hash_table_remove (cache, &entry->key);
+}
+
+/*
+ * gtk_pango_layout_cache_lookup:
+ * @layout: the layout to find a shaped equivalent for
+ * @width: the width to use instead of the width of @layout,
+ *   in Pango units, or -1
+ *
+ * Looks up a layout that is identical to @layout except for
+ * its width, which is set to @width.
+ *
+ * If no such layout is in the cache yet, a copy of @layout is
+ * added to it.
+ *
+ * The returned layout is shared with other users of the cache
+ * and must not be modified.
+ *
+ * Returns: (transfer full): a shared layout
+ */
+PangoLayout *
+gtk_pango_layout_cache_lookup (PangoLayout *layout,
+                               int          width)
+{
+  CacheKey key;
+  CacheEntry *entry;
+  PangoContext *context;
+  PangoLayout *copy;
+
+  g_return_val_if_fail (PANGO_IS_LAYOUT (layout), NULL);
+
+  if (strlen (pango_layout_get_text (layout)) > MAX_TEXT_LENGTH)
+    {
+      copy = pango_layout_copy (layout);
+      pango_layout_set_width (copy, width);
+      return copy;
+    }
+
+  if (G_UNLIKELY (cache == NULL))
+    cache = g_hash_table_new_full (cache_key_hash, cache_key_equal, NULL, cache_entry_free);
+
+  cache_key_init (&key, layout, width, FALSE);
+
+  entry = g_hash_table_lookup (cache, &key);
+  if (entry)
+    {
+      n_hits++;
+
+      g_queue_unlink (&lru, &entry->lru_link);
+      g_queue_push_head_link (&lru, &entry->lru_link);
+
+      return g_object_ref (entry->key.layout);
+    }
+
+  n_misses++;
+
+  context = context_state_create_context (&key.context);
+  copy = layout_copy_to_context (layout, context);
+  pango_layout_set_width (copy, width);
+  g_object_unref (context);
+
+  entry = g_new0 (CacheEntry, 1);
+  cache_key_init (&entry->key, copy, width, TRUE);
+  entry->lru_link.data = entry;
+
+  g_hash_table_add (cache, entry);
+  g_queue_push_head_link (&lru, &entry->lru_link);
+
+  while (lru.length > MAX_ENTRIES)
+    {
+      cache_evict_last ();
+      n_evictions++;
+    }
+
+  return g_object_ref (copy);
+}
+
+/*
+ * gtk_pango_layout_cache_clear:
+ *
+ * Drops all layouts from the cache.
+ *
+ * Layouts that are still in use stay valid.
+ */
+void
+gtk_pango_layout_cache_clear (void)
+{
+  while (lru.length > 0)
+    cache_evict_last ();
+}
+
+void
+gtk_pango_layout_cache_get_stats (GtkPangoLayoutCacheStats *stats)
+{
+  stats->n_entries = lru.length;
+  stats->max_entries = MAX_ENTRIES;
+  stats->n_hits = n_hits;
+  stats->n_misses = n_misses;
+  stats->n_evictions = n_evictions;
+}
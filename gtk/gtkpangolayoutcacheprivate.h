@@ -0,0 +1,40 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <pango/pango.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GtkPangoLayoutCacheStats GtkPangoLayoutCacheStats;
+
+struct _GtkPangoLayoutCacheStats
+{
+  guint   n_entries;
+  guint   max_entries;
+  guint64 n_hits;
+  guint64 n_misses;
+  guint64 n_evictions;
+};
+
+PangoLayout *   gtk_pango_layout_cache_lookup           (PangoLayout              *layout,
+                                                         int                       width);
+void            gtk_pango_layout_cache_clear            (void);
+void            gtk_pango_layout_cache_get_stats        (GtkPangoLayoutCacheStats *stats);
+
+G_END_DECLS
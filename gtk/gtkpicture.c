@@ -28,6 +28,7 @@
 #include "gtksnapshot.h"
 #include "gtktypebuiltins.h"
 #include "gtkwidgetprivate.h"
+#include "gtkdecodeloadprivate.h"
 #include "gdktextureutilsprivate.h"
 
 /**
@@ -90,6 +91,7 @@ enum
   PROP_KEEP_ASPECT_RATIO,
   PROP_CAN_SHRINK,
   PROP_CONTENT_FIT,
+  PROP_LOAD_ASYNC,
   NUM_PROPERTIES
 };
 
@@ -99,9 +101,12 @@ struct _GtkPicture
 
   GdkPaintable *paintable;
   GFile *file;
+  GtkDecodeLoad *decode_load;
 
   char *alternative_text;
   guint can_shrink : 1;
+  guint load_async : 1;
+  guint load_pending : 1;
   GtkContentFit content_fit;
 };
 
@@ -287,6 +292,10 @@ gtk_picture_set_property (GObject      *object,
       gtk_picture_set_content_fit (self, g_value_get_enum (value));
       break;
 
+    case PROP_LOAD_ASYNC:
+      gtk_picture_set_load_async (self, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -329,6 +338,10 @@ gtk_picture_get_property (GObject     *object,
       g_value_set_enum (value, self->content_fit);
       break;
 
+    case PROP_LOAD_ASYNC:
+      g_value_set_boolean (value, self->load_async);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -372,11 +385,95 @@ gtk_picture_clear_paintable (GtkPicture *self)
   g_object_unref (self->paintable);
 }
 
+static void
+gtk_picture_cancel_load (GtkPicture *self)
+{
+  g_clear_pointer (&self->decode_load, gtk_decode_load_cancel);
+}
+
+static void
+gtk_picture_file_loaded (GdkPaintable *paintable,
+                         const GError *error,
+                         gpointer      data)
+{
+  GtkPicture *self = data;
+
+  /* The load is gone after this callback */
+  self->decode_load = NULL;
+  self->load_pending = FALSE;
+
+  gtk_picture_set_paintable (self, paintable);
+}
+
+static void
+gtk_picture_start_load (GtkPicture *self)
+{
+  g_assert (self->decode_load == NULL);
+
+  /* Load the file the same way gtk_picture_set_file() does, so that
+   * scalable images are rendered at the scale of the picture
+   */
+  self->decode_load = gtk_decode_load_start (GTK_WIDGET (self),
+                                             self->file,
+                                             -1, -1,
+                                             gtk_widget_get_scale_factor (GTK_WIDGET (self)),
+                                             gdk_paintable_load_file_scaled,
+                                             gtk_picture_file_loaded,
+                                             self);
+}
+
+static void
+gtk_picture_root (GtkWidget *widget)
+{
+  GtkPicture *self = GTK_PICTURE (widget);
+
+  GTK_WIDGET_CLASS (gtk_picture_parent_class)->root (widget);
+
+  if (self->load_pending && self->decode_load == NULL)
+    gtk_picture_start_load (self);
+}
+
+static void
+gtk_picture_unroot (GtkWidget *widget)
+{
+  GtkPicture *self = GTK_PICTURE (widget);
+
+  /* Nobody will see the picture, so don't keep a thread busy with it.
+   * It is started again if the picture gets rooted again.
+   */
+  gtk_picture_cancel_load (self);
+
+  GTK_WIDGET_CLASS (gtk_picture_parent_class)->unroot (widget);
+}
+
+static void
+gtk_picture_map (GtkWidget *widget)
+{
+  GtkPicture *self = GTK_PICTURE (widget);
+
+  GTK_WIDGET_CLASS (gtk_picture_parent_class)->map (widget);
+
+  if (self->decode_load)
+    gtk_decode_load_update_priority (self->decode_load);
+}
+
+static void
+gtk_picture_unmap (GtkWidget *widget)
+{
+  GtkPicture *self = GTK_PICTURE (widget);
+
+  GTK_WIDGET_CLASS (gtk_picture_parent_class)->unmap (widget);
+
+  if (self->decode_load)
+    gtk_decode_load_update_priority (self->decode_load);
+}
+
 static void
 gtk_picture_dispose (GObject *object)
 {
   GtkPicture *self = GTK_PICTURE (object);
 
+  gtk_picture_cancel_load (self);
   gtk_picture_clear_paintable (self);
 
   g_clear_object (&self->file);
@@ -398,6 +495,10 @@ gtk_picture_class_init (GtkPictureClass *class)
   widget_class->snapshot = gtk_picture_snapshot;
   widget_class->get_request_mode = gtk_picture_get_request_mode;
   widget_class->measure = gtk_picture_measure;
+  widget_class->root = gtk_picture_root;
+  widget_class->unroot = gtk_picture_unroot;
+  widget_class->map = gtk_picture_map;
+  widget_class->unmap = gtk_picture_unmap;
 
   /**
    * GtkPicture:paintable: (attributes org.gtk.Property.get=gtk_picture_get_paintable org.gtk.Property.set=gtk_picture_set_paintable)
@@ -467,6 +568,20 @@ gtk_picture_class_init (GtkPictureClass *class)
                          GTK_CONTENT_FIT_CONTAIN,
                          GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkPicture:load-async: (attributes org.gtk.Property.get=gtk_picture_get_load_async org.gtk.Property.set=gtk_picture_set_load_async)
+   *
+   * Whether files are loaded in a thread.
+   *
+   * See [method@Gtk.Picture.set_load_async].
+   *
+   * Since: 4.16
+   */
+  properties[PROP_LOAD_ASYNC] =
+      g_param_spec_boolean ("load-async", NULL, NULL,
+                            FALSE,
+                            GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (gobject_class, NUM_PROPERTIES, properties);
 
   gtk_widget_class_set_css_name (widget_class, I_("picture"));
@@ -676,6 +791,18 @@ gtk_picture_set_file (GtkPicture *self,
   g_set_object (&self->file, file);
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_FILE]);
 
+  if (file && self->load_async)
+    {
+      gtk_picture_set_paintable (self, NULL);
+
+      self->load_pending = TRUE;
+      if (gtk_widget_get_root (GTK_WIDGET (self)))
+        gtk_picture_start_load (self);
+
+      g_object_thaw_notify (G_OBJECT (self));
+      return;
+    }
+
   if (file)
     paintable = gdk_paintable_new_from_file_scaled (file, gtk_widget_get_scale_factor (GTK_WIDGET (self)));
   else
@@ -826,6 +953,10 @@ gtk_picture_set_paintable (GtkPicture   *self,
   g_return_if_fail (GTK_IS_PICTURE (self));
   g_return_if_fail (paintable == NULL || GDK_IS_PAINTABLE (paintable));
 
+  /* Whatever is loading would replace this paintable */
+  gtk_picture_cancel_load (self);
+  self->load_pending = FALSE;
+
   if (self->paintable == paintable)
     return;
 
@@ -1080,3 +1211,58 @@ gtk_picture_get_alternative_text (GtkPicture *self)
   return self->alternative_text;
 }
 
+/**
+ * gtk_picture_set_load_async: (attributes org.gtk.Method.set_property=load-async)
+ * @self: a `GtkPicture`
+ * @load_async: whether to load files in a thread
+ *
+ * Sets whether files set with [method@Gtk.Picture.set_file] are
+ * loaded in a thread.
+ *
+ * By default, files are loaded right away, which blocks the
+ * application for as long as it takes to load them. That is a
+ * problem when showing a lot of pictures, for example in a
+ * [class@Gtk.GridView].
+ *
+ * With this property set, the picture stays empty until the file has
+ * been loaded. Pictures that are in view of their scrolled window are
+ * loaded first, followed by the ones that are about to be scrolled
+ * into view. Loading stops when another file or paintable is set,
+ * like when list items are bound to a different item, and when the
+ * picture is removed from its window.
+ *
+ * If loading the file fails, the picture stays empty.
+ *
+ * Since: 4.16
+ */
+void
+gtk_picture_set_load_async (GtkPicture *self,
+                            gboolean    load_async)
+{
+  g_return_if_fail (GTK_IS_PICTURE (self));
+
+  if (self->load_async == !!load_async)
+    return;
+
+  self->load_async = !!load_async;
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOAD_ASYNC]);
+}
+
+/**
+ * gtk_picture_get_load_async: (attributes org.gtk.Method.get_property=load-async)
+ * @self: a `GtkPicture`
+ *
+ * Returns whether files are loaded in a thread.
+ *
+ * Returns: %TRUE if files are loaded in a thread
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_picture_get_load_async (GtkPicture *self)
+{
+  g_return_val_if_fail (GTK_IS_PICTURE (self), FALSE);
+
+  return self->load_async;
+}
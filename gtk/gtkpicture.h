@@ -91,6 +91,12 @@ void            gtk_picture_set_alternative_text        (GtkPicture
 GDK_AVAILABLE_IN_ALL
 const char *    gtk_picture_get_alternative_text        (GtkPicture             *self);
 
+GDK_AVAILABLE_IN_4_16
+void            gtk_picture_set_load_async              (GtkPicture             *self,
+                                                         gboolean                load_async);
+GDK_AVAILABLE_IN_4_16
+gboolean        gtk_picture_get_load_async              (GtkPicture             *self);
+
 
 G_END_DECLS
 
@@ -64,6 +64,12 @@
  * listitems passed will not trigger notify signals as the listitem's
  * notifications are frozen. See g_object_freeze_notify() for details.
  *
+ * When the list widget defers binding, for example with
+ * [property@Gtk.ListView:deferred-binding], a listitem may be shown
+ * for a while without an item. [signal@Gtk.SignalListItemFactory::placeholder]
+ * is emitted after unbinding such a listitem, so that it does not keep
+ * showing the contents of its previous item.
+ *
  * For tracking changes in other properties in the listitem, the
  * ::notify signal is recommended. The signal can be connected in the
  * [signal@Gtk.SignalListItemFactory::setup] signal and removed again during
@@ -87,6 +93,8 @@ struct _GtkSignalListItemFactoryClass
                                                                  GObject                  *list_item);
   void                  (* unbind)                              (GtkSignalListItemFactory *self,
                                                                  GObject                  *list_item);
+  void                  (* placeholder)                         (GtkSignalListItemFactory *self,
+                                                                 GObject                  *list_item);
 };
 
 enum {
@@ -94,6 +102,7 @@ enum {
   BIND,
   UNBIND,
   TEARDOWN,
+  PLACEHOLDER,
 
   LAST_SIGNAL
 };
@@ -148,6 +157,13 @@ gtk_signal_list_item_factory_teardown (GtkListItemFactory *factory,
   g_signal_emit (factory, signals[TEARDOWN], 0, item);
 }
 
+static void
+gtk_signal_list_item_factory_placeholder (GtkListItemFactory *factory,
+                                          GObject            *item)
+{
+  g_signal_emit (factory, signals[PLACEHOLDER], 0, item);
+}
+
 static void
 gtk_signal_list_item_factory_class_init (GtkSignalListItemFactoryClass *klass)
 {
@@ -156,6 +172,7 @@ gtk_signal_list_item_factory_class_init (GtkSignalListItemFactoryClass *klass)
   factory_class->setup = gtk_signal_list_item_factory_setup;
   factory_class->teardown = gtk_signal_list_item_factory_teardown;
   factory_class->update = gtk_signal_list_item_factory_update;
+  factory_class->placeholder = gtk_signal_list_item_factory_placeholder;
 
   /**
    * GtkSignalListItemFactory::setup:
@@ -260,6 +277,34 @@ gtk_signal_list_item_factory_class_init (GtkSignalListItemFactoryClass *klass)
   g_signal_set_va_marshaller (signals[TEARDOWN],
                               G_TYPE_FROM_CLASS (klass),
                               g_cclosure_marshal_VOID__OBJECTv);
+
+  /**
+   * GtkSignalListItemFactory::placeholder:
+   * @self: The `GtkSignalListItemFactory`
+   * @object: The `GObject` to show as a placeholder
+   *
+   * Emitted when an object has been unbound and will be shown
+   * without an item until a new item is bound to it.
+   *
+   * Handlers should make the widgets look like a placeholder, for
+   * example by clearing labels and images. This must be cheap, the
+   * point of deferring the bind is to keep expensive work out of
+   * the frame.
+   *
+   * Since: 4.16
+   */
+  signals[PLACEHOLDER] =
+    g_signal_new (I_("placeholder"),
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_FIRST,
+                  G_STRUCT_OFFSET (GtkSignalListItemFactoryClass, placeholder),
+                  NULL, NULL,
+                  g_cclosure_marshal_VOID__OBJECT,
+                  G_TYPE_NONE, 1,
+                  G_TYPE_OBJECT);
+  g_signal_set_va_marshaller (signals[PLACEHOLDER],
+                              G_TYPE_FROM_CLASS (klass),
+                              g_cclosure_marshal_VOID__OBJECTv);
 }
 
 static void
@@ -31,6 +31,8 @@
 #include "gtkcssnodeprivate.h"
 #include "gtkcssnumbervalueprivate.h"
 #include "gtklayoutmanagerprivate.h"
+#include "gtklayoutstatsprivate.h"
+#include "gtkmeasurecacheprivate.h"
 
 
 #ifdef G_ENABLE_CONSISTENCY_CHECKS
@@ -129,6 +131,60 @@ get_box_padding (GtkCssStyle *style,
   border->right = get_number (style->size->padding_right);
 }
 
+/* Calls the measure vfunc, going through the shared measure
+ * cache for widgets that support it
+ */
+static void
+measure_content (GtkWidget      *widget,
+                 GtkCssStyle    *style,
+                 GtkOrientation  orientation,
+                 int             for_size,
+                 int            *minimum,
+                 int            *natural,
+                 int            *minimum_baseline,
+                 int            *natural_baseline)
+{
+  GtkWidgetClass *widget_class = GTK_WIDGET_GET_CLASS (widget);
+  GtkWidgetClassPrivate *class_priv = widget_class->priv;
+  GtkMeasureKey key;
+
+  /* Animated styles change every frame, don't fill the cache with them */
+  if (class_priv->measure_key == NULL ||
+      class_priv->measure_key_measure != widget_class->measure ||
+      !gtk_css_style_is_static (style))
+    {
+      widget_class->measure (widget, orientation, for_size,
+                             minimum, natural,
+                             minimum_baseline, natural_baseline);
+      return;
+    }
+
+  gtk_measure_key_init (&key);
+
+  if (!class_priv->measure_key (widget, &key))
+    {
+      widget_class->measure (widget, orientation, for_size,
+                             minimum, natural,
+                             minimum_baseline, natural_baseline);
+    }
+  else if (!gtk_measure_cache_lookup (G_OBJECT_TYPE (widget), &key, style,
+                                      orientation, for_size,
+                                      minimum, natural,
+                                      minimum_baseline, natural_baseline))
+    {
+      widget_class->measure (widget, orientation, for_size,
+                             minimum, natural,
+                             minimum_baseline, natural_baseline);
+
+      gtk_measure_cache_insert (G_OBJECT_TYPE (widget), &key, style,
+                                orientation, for_size,
+                                *minimum, *natural,
+                                *minimum_baseline, *natural_baseline);
+    }
+
+  gtk_measure_key_clear (&key);
+}
+
 static void
 gtk_widget_query_size_for_orientation (GtkWidget        *widget,
                                        GtkOrientation    orientation,
@@ -168,9 +224,11 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
                                                    &min_baseline,
                                                    &nat_baseline);
 
+  if (GTK_LAYOUT_STATS_IS_RUNNING)
+    gtk_layout_stats_record_cache (G_OBJECT_TYPE (widget), found_in_cache);
+
   if (!found_in_cache)
     {
-      GtkWidgetClass *widget_class;
       GtkCssStyle *style;
       GtkBorder margin, border, padding;
       int adjusted_min, adjusted_natural;
@@ -181,14 +239,15 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
       int css_extra_for_size;
       int css_extra_size;
       int widget_margins_for_size;
+      gint64 stats_start;
+
+      stats_start = gtk_layout_stats_begin ();
 
       style = gtk_css_node_get_style (gtk_widget_get_css_node (widget));
       get_box_margin (style, &margin);
       get_box_border (style, &border);
       get_box_padding (style, &padding);
 
-      widget_class = GTK_WIDGET_GET_CLASS (widget);
-
       if (orientation == GTK_ORIENTATION_HORIZONTAL)
         {
           css_extra_size = margin.left + margin.right + border.left + border.right + padding.left + padding.right;
@@ -257,9 +316,9 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
           if (for_size < 0)
             {
               push_recursion_check (widget, orientation);
-              widget_class->measure (widget, orientation, -1,
-                                     &reported_min_size, &reported_nat_size,
-                                     &min_baseline, &nat_baseline);
+              measure_content (widget, style, orientation, -1,
+                               &reported_min_size, &reported_nat_size,
+                               &min_baseline, &nat_baseline);
               pop_recursion_check (widget, orientation);
             }
           else
@@ -285,11 +344,11 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
                 adjusted_for_size = minimum_for_size;
 
               push_recursion_check (widget, orientation);
-              widget_class->measure (widget,
-                                     orientation,
-                                     adjusted_for_size,
-                                     &reported_min_size, &reported_nat_size,
-                                     &min_baseline, &nat_baseline);
+              measure_content (widget, style,
+                               orientation,
+                               adjusted_for_size,
+                               &reported_min_size, &reported_nat_size,
+                               &min_baseline, &nat_baseline);
               pop_recursion_check (widget, orientation);
             }
         }
@@ -410,6 +469,8 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
                                       nat_size,
 				      min_baseline,
 				      nat_baseline);
+
+      gtk_layout_stats_end (stats_start, GTK_LAYOUT_STATS_MEASURE, G_OBJECT_TYPE (widget));
     }
 
   if (minimum)
@@ -22,6 +22,7 @@
 #include "gtksortlistmodel.h"
 
 #include "gtkbitset.h"
+#include "gtkidleschedulerprivate.h"
 #include "gtkmultisorter.h"
 #include "gtkprivate.h"
 #include "gtksectionmodel.h"
@@ -43,16 +44,6 @@
  */
 #define GTK_SORT_MAX_MERGE_SIZE (1024)
 
-/* Time we spend in the sort callback before returning to the main loop
- *
- * Increasing this number will make the callback take longer and potentially
- * reduce responsiveness of an application, but will increase the amount of
- * work done per step. And we emit an ::items-changed() signal after every
- * step, so if we can avoid that, we recuce the overhead in the list widget
- * and in turn reduce the total sort time.
- */
-#define GTK_SORT_STEP_TIME_US (1000) /* 1 millisecond */
-
 /**
  * GtkSortListModel:
  *
@@ -364,24 +355,21 @@ gtk_sort_list_model_stop_sorting (GtkSortListModel *self,
   if (runs)
     gtk_tim_sort_get_runs (&self->sort, runs);
   gtk_tim_sort_finish (&self->sort);
-  g_clear_handle_id (&self->sort_cb, g_source_remove);
+  g_clear_handle_id (&self->sort_cb, gtk_idle_scheduler_remove);
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PENDING]);
 }
 
 static gboolean
 gtk_sort_list_model_sort_step (GtkSortListModel *self,
-                               gboolean          finish,
+                               gint64            end_time,
                                guint            *out_position,
                                guint            *out_n_items)
 {
-  gint64 end_time = g_get_monotonic_time ();
   gboolean result = FALSE;
   GtkTimSortRun change;
   gpointer *start_change, *end_change;
 
-  end_time += GTK_SORT_STEP_TIME_US;
-
   if (!gtk_bitset_is_empty (self->missing_keys))
     {
       GtkBitsetIter iter;
@@ -395,7 +383,7 @@ gtk_sort_list_model_sort_step (GtkSortListModel *self,
           gtk_sort_keys_init_key (self->sort_keys, item, key_from_pos (self, pos));
           g_object_unref (item);
 
-          if (g_get_monotonic_time () >= end_time && !finish)
+          if (g_get_monotonic_time () >= end_time)
             {
               gtk_bitset_remove_range_closed (self->missing_keys, 0, pos);
               *out_position = 0;
@@ -419,7 +407,7 @@ gtk_sort_list_model_sort_step (GtkSortListModel *self,
           end_change = MAX (end_change, ((gpointer *) change.base) + change.len);
         }
      
-      if (g_get_monotonic_time () >= end_time && !finish)
+      if (g_get_monotonic_time () >= end_time)
         break;
     }
 
@@ -438,12 +426,13 @@ gtk_sort_list_model_sort_step (GtkSortListModel *self,
 }
 
 static gboolean
-gtk_sort_list_model_sort_cb (gpointer data)
+gtk_sort_list_model_sort_cb (gpointer data,
+                             gint64   deadline)
 {
   GtkSortListModel *self = data;
   guint pos, n_items;
 
-  if (gtk_sort_list_model_sort_step (self, FALSE, &pos, &n_items))
+  if (gtk_sort_list_model_sort_step (self, deadline, &pos, &n_items))
     {
       if (n_items)
         g_list_model_items_changed (G_LIST_MODEL (self), pos, n_items, n_items);
@@ -491,8 +480,10 @@ gtk_sort_list_model_start_sorting (GtkSortListModel *self,
   if (!self->incremental)
     return FALSE;
 
-  self->sort_cb = g_idle_add (gtk_sort_list_model_sort_cb, self);
-  gdk_source_set_static_name_by_id (self->sort_cb, "[gtk] gtk_sort_list_model_sort_cb");
+  self->sort_cb = gtk_idle_scheduler_add (GTK_IDLE_TASK_VISIBLE,
+                                          gtk_sort_list_model_sort_cb,
+                                          self, NULL,
+                                          "[gtk] gtk_sort_list_model_sort_cb");
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PENDING]);
   return TRUE;
 }
@@ -504,7 +495,7 @@ gtk_sort_list_model_finish_sorting (GtkSortListModel *self,
 {
   gtk_tim_sort_set_max_merge_size (&self->sort, 0);
 
-  gtk_sort_list_model_sort_step (self, TRUE, pos, n_items);
+  gtk_sort_list_model_sort_step (self, G_MAXINT64, pos, n_items);
   gtk_tim_sort_finish (&self->sort);
 
   gtk_sort_list_model_stop_sorting (self, NULL);
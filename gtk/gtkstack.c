@@ -26,6 +26,7 @@
 #include "gtkenums.h"
 #include "gtkaccessibleprivate.h"
 #include "gtkatcontextprivate.h"
+#include "gtkidleschedulerprivate.h"
 #include "gtkprivate.h"
 #include "gtkprogresstrackerprivate.h"
 #include "gtksettingsprivate.h"
@@ -33,6 +34,7 @@
 #include "gtkwidgetprivate.h"
 #include "gtksingleselection.h"
 #include "gtklistlistmodelprivate.h"
+#include "gdkprofilerprivate.h"
 #include <math.h>
 #include <string.h>
 
@@ -78,6 +80,13 @@
  *     </child>
  * ```
  *
+ * # Virtualization
+ *
+ * Stacks with many pages can be put in virtualized mode with
+ * [method@Gtk.Stack.set_virtualized]. Pages that have not been shown
+ * for a few seconds are then unrealized and their styles are dropped,
+ * and they are brought back when they become the visible child again.
+ *
  * # CSS nodes
  *
  * `GtkStack` has a single CSS node named stack.
@@ -162,6 +171,11 @@ typedef struct {
 
   GtkSelectionModel *pages;
 
+  gboolean virtualized;
+  guint dormancy_timeout_id;
+  guint dormancy_task_id;
+  gint64 wake_time;
+
 } GtkStackPrivate;
 
 static void gtk_stack_buildable_interface_init (GtkBuildableIface *iface);
@@ -184,6 +198,7 @@ enum  {
   PROP_TRANSITION_RUNNING,
   PROP_INTERPOLATE_SIZE,
   PROP_PAGES,
+  PROP_VIRTUALIZED,
   LAST_PROP
 };
 
@@ -216,10 +231,17 @@ struct _GtkStackPage
 
   GtkATContext *at_context;
 
+  /* When the page was last hidden, or 0 while it is shown */
+  gint64 hidden_since;
+  /* The size of a dormant page, for homogeneous stacks */
+  int dormant_min[2];
+  int dormant_nat[2];
+
   guint needs_attention : 1;
   guint visible         : 1;
   guint use_underline   : 1;
   guint in_destruction  : 1;
+  guint dormant         : 1;
 };
 
 typedef struct _GtkStackPageClass GtkStackPageClass;
@@ -231,6 +253,14 @@ struct _GtkStackPageClass
 static GParamSpec *stack_props[LAST_PROP] = { NULL, };
 static GParamSpec *stack_page_props[LAST_CHILD_PROP] = { NULL, };
 
+/* How long a page must have been hidden before it is put to sleep */
+#define DORMANCY_TIMEOUT_SECONDS 5
+
+static guint n_dormant_pages;
+static guint n_dropped_styles;
+static guint dormant_pages_counter;
+static guint dropped_styles_counter;
+
 static GtkATContext *
 gtk_stack_page_accessible_get_at_context (GtkAccessible *accessible)
 {
@@ -828,6 +858,8 @@ gtk_stack_accessible_init (GtkAccessibleInterface *iface)
 static void stack_remove (GtkStack  *stack,
                           GtkWidget *child,
                           gboolean   in_dispose);
+static void gtk_stack_schedule_dormancy   (GtkStack *stack);
+static void gtk_stack_unschedule_dormancy (GtkStack *stack);
 
 static void
 gtk_stack_dispose (GObject *obj)
@@ -837,6 +869,8 @@ gtk_stack_dispose (GObject *obj)
   GtkWidget *child;
   guint n_pages = priv->children->len;
 
+  gtk_stack_unschedule_dormancy (stack);
+
   while ((child = gtk_widget_get_first_child (GTK_WIDGET (stack))))
     stack_remove (stack, child, TRUE);
 
@@ -902,6 +936,9 @@ gtk_stack_get_property (GObject   *object,
     case PROP_PAGES:
       g_value_take_object (value, gtk_stack_get_pages (stack));
       break;
+    case PROP_VIRTUALIZED:
+      g_value_set_boolean (value, gtk_stack_get_virtualized (stack));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -939,6 +976,9 @@ gtk_stack_set_property (GObject     *object,
     case PROP_INTERPOLATE_SIZE:
       gtk_stack_set_interpolate_size (stack, g_value_get_boolean (value));
       break;
+    case PROP_VIRTUALIZED:
+      gtk_stack_set_virtualized (stack, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -1052,8 +1092,26 @@ gtk_stack_class_init (GtkStackClass *klass)
                            GTK_TYPE_SELECTION_MODEL,
                            GTK_PARAM_READABLE);
 
+  /**
+   * GtkStack:virtualized: (attributes org.gtk.Property.get=gtk_stack_get_virtualized org.gtk.Property.set=gtk_stack_set_virtualized)
+   *
+   * Whether pages that are not shown are put to sleep after a while.
+   *
+   * Since: 4.16
+   */
+  stack_props[PROP_VIRTUALIZED] =
+      g_param_spec_boolean ("virtualized", NULL, NULL,
+                            FALSE,
+                            GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (object_class, LAST_PROP, stack_props);
 
+  if (dormant_pages_counter == 0)
+    {
+      dormant_pages_counter = gdk_profiler_define_int_counter ("stack-dormant-pages", "Dormant stack pages");
+      dropped_styles_counter = gdk_profiler_define_int_counter ("stack-dropped-styles", "Styles dropped by dormant stack pages");
+    }
+
   gtk_widget_class_set_css_name (widget_class, I_("stack"));
   gtk_widget_class_set_accessible_role (widget_class, GTK_ACCESSIBLE_ROLE_GROUP);
 }
@@ -1244,7 +1302,7 @@ gtk_stack_progress_updated (GtkStack *stack)
   if (gtk_progress_tracker_get_state (&priv->tracker) == GTK_PROGRESS_STATE_AFTER &&
       priv->last_visible_child != NULL)
     {
-      gtk_widget_set_child_visible (priv->last_visible_child->widget, FALSE);
+      gtk_stack_hide_page (stack, priv->last_visible_child);
       priv->last_visible_child = NULL;
     }
 }
@@ -1387,6 +1445,159 @@ gtk_stack_start_transition (GtkStack               *stack,
   gtk_stack_progress_updated (GTK_STACK (widget));
 }
 
+static void
+gtk_stack_wake_page (GtkStack     *stack,
+                     GtkStackPage *page)
+{
+  GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
+
+  if (!page->dormant)
+    return;
+
+  page->dormant = FALSE;
+  n_dormant_pages--;
+
+  /* Only valid while the page sleeps */
+  memset (page->dormant_min, 0, sizeof (page->dormant_min));
+  memset (page->dormant_nat, 0, sizeof (page->dormant_nat));
+
+  gtk_widget_set_dormant (page->widget, FALSE);
+
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      /* The expensive part happens when the page gets validated,
+       * measured and realized, so we measure up to the next frame
+       */
+      if (page == priv->visible_child && priv->wake_time == 0)
+        priv->wake_time = GDK_PROFILER_CURRENT_TIME;
+      gdk_profiler_set_int_counter (dormant_pages_counter, n_dormant_pages);
+    }
+}
+
+static gboolean
+gtk_stack_put_pages_to_sleep (gpointer user_data,
+                              gint64   deadline)
+{
+  GtkStack *stack = user_data;
+  GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
+  gint64 before G_GNUC_UNUSED;
+  gint64 now;
+  gboolean pending = FALSE;
+  guint n_pages = 0;
+  guint n_dropped = 0;
+  guint idx;
+
+  before = GDK_PROFILER_CURRENT_TIME;
+  now = g_get_monotonic_time ();
+
+  for (idx = 0; idx < priv->children->len; idx++)
+    {
+      GtkStackPage *page = g_ptr_array_index (priv->children, idx);
+
+      if (page->dormant ||
+          page->hidden_since == 0 ||
+          page == priv->visible_child ||
+          page == priv->last_visible_child ||
+          gtk_widget_get_mapped (page->widget))
+        continue;
+
+      if (now - page->hidden_since < DORMANCY_TIMEOUT_SECONDS * G_USEC_PER_SEC)
+        {
+          pending = TRUE;
+          continue;
+        }
+
+      if (g_get_monotonic_time () >= deadline)
+        break;
+
+      /* Remember the size, so that homogeneous stacks don't
+       * need to wake the page up again for measuring it
+       */
+      gtk_widget_measure (page->widget, GTK_ORIENTATION_HORIZONTAL, -1,
+                          &page->dormant_min[GTK_ORIENTATION_HORIZONTAL],
+                          &page->dormant_nat[GTK_ORIENTATION_HORIZONTAL],
+                          NULL, NULL);
+      gtk_widget_measure (page->widget, GTK_ORIENTATION_VERTICAL, -1,
+                          &page->dormant_min[GTK_ORIENTATION_VERTICAL],
+                          &page->dormant_nat[GTK_ORIENTATION_VERTICAL],
+                          NULL, NULL);
+
+      n_dropped += gtk_widget_set_dormant (page->widget, TRUE);
+      page->dormant = TRUE;
+      n_pages++;
+    }
+
+  n_dormant_pages += n_pages;
+  n_dropped_styles += n_dropped;
+
+  if (GDK_PROFILER_IS_RUNNING && n_pages > 0)
+    {
+      gdk_profiler_end_markf (before, "Stack pages to sleep", "%u pages, %u styles dropped", n_pages, n_dropped);
+      gdk_profiler_set_int_counter (dormant_pages_counter, n_dormant_pages);
+      gdk_profiler_set_int_counter (dropped_styles_counter, n_dropped_styles);
+    }
+
+  if (idx < priv->children->len)
+    return G_SOURCE_CONTINUE;
+
+  priv->dormancy_task_id = 0;
+
+  if (pending)
+    gtk_stack_schedule_dormancy (stack);
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+gtk_stack_dormancy_timeout_cb (gpointer user_data)
+{
+  GtkStack *stack = user_data;
+  GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
+
+  priv->dormancy_timeout_id = 0;
+  priv->dormancy_task_id = gtk_idle_scheduler_add (GTK_IDLE_TASK_BACKGROUND,
+                                                   gtk_stack_put_pages_to_sleep,
+                                                   stack, NULL,
+                                                   "[gtk] gtk_stack_put_pages_to_sleep");
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gtk_stack_schedule_dormancy (GtkStack *stack)
+{
+  GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
+
+  if (!priv->virtualized ||
+      priv->dormancy_timeout_id != 0 ||
+      priv->dormancy_task_id != 0)
+    return;
+
+  priv->dormancy_timeout_id = g_timeout_add_seconds (DORMANCY_TIMEOUT_SECONDS,
+                                                     gtk_stack_dormancy_timeout_cb,
+                                                     stack);
+  gdk_source_set_static_name_by_id (priv->dormancy_timeout_id, "[gtk] gtk_stack_dormancy_timeout_cb");
+}
+
+static void
+gtk_stack_unschedule_dormancy (GtkStack *stack)
+{
+  GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
+
+  g_clear_handle_id (&priv->dormancy_timeout_id, g_source_remove);
+  g_clear_handle_id (&priv->dormancy_task_id, gtk_idle_scheduler_remove);
+}
+
+static void
+gtk_stack_hide_page (GtkStack     *stack,
+                     GtkStackPage *page)
+{
+  gtk_widget_set_child_visible (page->widget, FALSE);
+
+  page->hidden_since = g_get_monotonic_time ();
+  gtk_stack_schedule_dormancy (stack);
+}
+
 static void
 set_visible_child (GtkStack               *stack,
                    GtkStackPage      *child_info,
@@ -1458,7 +1669,7 @@ set_visible_child (GtkStack               *stack,
     }
 
   if (priv->last_visible_child)
-    gtk_widget_set_child_visible (priv->last_visible_child->widget, FALSE);
+    gtk_stack_hide_page (stack, priv->last_visible_child);
   priv->last_visible_child = NULL;
 
   if (priv->visible_child && priv->visible_child->widget)
@@ -1471,7 +1682,7 @@ set_visible_child (GtkStack               *stack,
         }
       else
         {
-          gtk_widget_set_child_visible (priv->visible_child->widget, FALSE);
+          gtk_stack_hide_page (stack, priv->visible_child);
         }
     }
 
@@ -1479,6 +1690,8 @@ set_visible_child (GtkStack               *stack,
 
   if (child_info)
     {
+      child_info->hidden_since = 0;
+      gtk_stack_wake_page (stack, child_info);
       gtk_widget_set_child_visible (child_info->widget, TRUE);
 
       if (contains_focus)
@@ -1554,7 +1767,7 @@ update_child_visible (GtkStack     *stack,
 
   if (child_info == priv->last_visible_child)
     {
-      gtk_widget_set_child_visible (priv->last_visible_child->widget, FALSE);
+      gtk_stack_hide_page (stack, priv->last_visible_child);
       priv->last_visible_child = NULL;
     }
 
@@ -1706,7 +1919,7 @@ gtk_stack_add_page (GtkStack     *stack,
 
   g_ptr_array_add (priv->children, g_object_ref (child_info));
 
-  gtk_widget_set_child_visible (child_info->widget, FALSE);
+  gtk_stack_hide_page (stack, child_info);
   gtk_widget_set_parent (child_info->widget, GTK_WIDGET (stack));
 
   if (priv->pages)
@@ -1745,6 +1958,9 @@ stack_remove (GtkStack  *stack,
 
   was_visible = gtk_widget_get_visible (child);
 
+  gtk_stack_wake_page (stack, child_info);
+  child_info->hidden_since = 0;
+
   if (priv->visible_child == child_info)
     priv->visible_child = NULL;
 
@@ -2131,6 +2347,81 @@ gtk_stack_get_interpolate_size (GtkStack *stack)
   return priv->interpolate_size;
 }
 
+/**
+ * gtk_stack_set_virtualized: (attributes org.gtk.Method.set_property=virtualized)
+ * @stack: a `GtkStack`
+ * @virtualized: whether to put hidden pages to sleep
+ *
+ * Sets whether pages that are not shown are put to sleep.
+ *
+ * Pages that have not been the visible child for a few seconds
+ * are then unrealized, and the styles of their widgets are dropped.
+ * They are brought back when they become the visible child again,
+ * or when their widgets are asked for their style in the meantime.
+ *
+ * This saves memory and makes style changes like theme switches
+ * cheaper for stacks with lots of pages, at the expense of a slower
+ * first frame when switching to a page that has been put to sleep.
+ *
+ * Pages that are asleep don't take part in CSS matching, so they
+ * are not taken into account by positional selectors like :nth-child()
+ * of their siblings. Homogeneous stacks use the size a page had when
+ * it was put to sleep, unless the page queues a resize in the meantime,
+ * which wakes it up.
+ *
+ * Since: 4.16
+ */
+void
+gtk_stack_set_virtualized (GtkStack *stack,
+                           gboolean  virtualized)
+{
+  GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
+  guint idx;
+
+  g_return_if_fail (GTK_IS_STACK (stack));
+
+  virtualized = !!virtualized;
+
+  if (priv->virtualized == virtualized)
+    return;
+
+  priv->virtualized = virtualized;
+
+  if (virtualized)
+    {
+      gtk_stack_schedule_dormancy (stack);
+    }
+  else
+    {
+      gtk_stack_unschedule_dormancy (stack);
+
+      for (idx = 0; idx < priv->children->len; idx++)
+        gtk_stack_wake_page (stack, g_ptr_array_index (priv->children, idx));
+    }
+
+  g_object_notify_by_pspec (G_OBJECT (stack), stack_props[PROP_VIRTUALIZED]);
+}
+
+/**
+ * gtk_stack_get_virtualized: (attributes org.gtk.Method.get_property=virtualized)
+ * @stack: a `GtkStack`
+ *
+ * Returns whether pages that are not shown are put to sleep.
+ *
+ * Returns: %TRUE if @stack is virtualized
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_stack_get_virtualized (GtkStack *stack)
+{
+  GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
+
+  g_return_val_if_fail (GTK_IS_STACK (stack), FALSE);
+
+  return priv->virtualized;
+}
+
 
 
 /**
@@ -2596,6 +2887,13 @@ gtk_stack_snapshot (GtkWidget   *widget,
   GtkStack *stack = GTK_STACK (widget);
   GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
 
+  if (priv->wake_time != 0)
+    {
+      gdk_profiler_end_markf (priv->wake_time, "Stack page switch", "%s",
+                              priv->visible_child && priv->visible_child->name ? priv->visible_child->name : "");
+      priv->wake_time = 0;
+    }
+
   if (priv->visible_child)
     {
       if (gtk_progress_tracker_get_state (&priv->tracker) != GTK_PROGRESS_STATE_AFTER)
@@ -2754,7 +3052,22 @@ gtk_stack_measure (GtkWidget      *widget,
 
       if (gtk_widget_get_visible (child))
         {
-          if (!priv->homogeneous[OPPOSITE_ORIENTATION(orientation)] && priv->visible_child != child_info)
+          /* A sleeping page that queued a resize has changed since
+           * its size was remembered, and can't be measured without
+           * its styles, so it has to be woken up
+           */
+          if (child_info->dormant && gtk_widget_get_resize_needed (child))
+            {
+              gtk_stack_wake_page (stack, child_info);
+              gtk_stack_schedule_dormancy (stack);
+            }
+
+          if (child_info->dormant)
+            {
+              child_min = child_info->dormant_min[orientation];
+              child_nat = child_info->dormant_nat[orientation];
+            }
+          else if (!priv->homogeneous[OPPOSITE_ORIENTATION(orientation)] && priv->visible_child != child_info)
             {
               int min_for_size;
 
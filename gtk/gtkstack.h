@@ -174,6 +174,11 @@ void                   gtk_stack_set_interpolate_size    (GtkStack *stack,
                                                           gboolean  interpolate_size);
 GDK_AVAILABLE_IN_ALL
 gboolean               gtk_stack_get_interpolate_size    (GtkStack *stack);
+GDK_AVAILABLE_IN_4_16
+void                   gtk_stack_set_virtualized         (GtkStack *stack,
+                                                          gboolean  virtualized);
+GDK_AVAILABLE_IN_4_16
+gboolean               gtk_stack_get_virtualized         (GtkStack *stack);
 
 GDK_AVAILABLE_IN_ALL
 GtkSelectionModel *    gtk_stack_get_pages               (GtkStack *stack);
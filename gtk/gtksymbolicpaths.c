@@ -0,0 +1,1115 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtksymbolicpathsprivate.h"
+
+#include "gtkenums.h"
+
+#include <string.h>
+
+/* Symbolic icons as paths.
+ *
+ * Symbolic icons are simple svgs: a few filled shapes, where the
+ * class of a shape decides if it is drawn in the foreground color
+ * or in one of the error, warning and success colors (see the
+ * wrapper svg in gdktextureutils.c). Instead of rendering them to
+ * textures at every size, we parse them once into GskPaths that
+ * are drawn with fill nodes, which look sharp at any scale and
+ * take the colors at draw time.
+ *
+ * Only the subset of svg that symbolic icons use is understood.
+ * For anything else, like strokes, clips, text or images, no paths
+ * are created, and the icon is rendered to a texture as before.
+ */
+
+typedef enum {
+  SYMBOLIC_SHAPE_FILL,
+  SYMBOLIC_SHAPE_PUSH_OPACITY,
+  SYMBOLIC_SHAPE_POP
+} SymbolicShapeKind;
+
+typedef struct _SymbolicShape SymbolicShape;
+typedef struct _ParserState ParserState;
+typedef struct _ParserData ParserData;
+
+/* Groups with opacity are drawn as a layer, so the shapes
+ * are interleaved with pushes and pops of the opacity
+ */
+struct _SymbolicShape
+{
+  SymbolicShapeKind kind;
+  GskPath *path;
+  GskTransform *transform;
+  GskFillRule fill_rule;
+  GtkSymbolicColor color;
+  float alpha;
+};
+
+struct _GtkSymbolicPaths
+{
+  double width;
+  double height;
+  graphene_rect_t viewbox;
+  gboolean needs_clip;
+  GArray *shapes;
+  guint n_shapes;
+};
+
+/* The properties of an element that its children inherit */
+struct _ParserState
+{
+  GskTransform *transform;
+  float fill_opacity;
+  GskFillRule fill_rule;
+  gboolean fill_none;
+  gboolean visible;
+  gboolean pushed_opacity;
+};
+
+struct _ParserData
+{
+  GtkSymbolicPaths *paths;
+  GArray *states;
+  guint skip_depth;
+  gboolean has_symbolic_classes;
+};
+
+/*
+ * gtk_symbolic_paths_enabled:
+ *
+ * Returns whether symbolic icons should be drawn as paths.
+ * Setting `GTK_SYMBOLIC_PATHS=0` goes back to textures.
+ *
+ * Returns: %TRUE if paths should be used
+ */
+gboolean
+gtk_symbolic_paths_enabled (void)
+{
+  static gsize enabled = 0;
+
+  if (g_once_init_enter (&enabled))
+    {
+      const char *str = g_getenv ("GTK_SYMBOLIC_PATHS");
+
+      g_once_init_leave (&enabled, str && g_str_equal (str, "0") ? 1 : 2);
+    }
+
+  return enabled == 2;
+}
+
+static void
+symbolic_shape_clear (gpointer data)
+{
+  SymbolicShape *shape = data;
+
+  g_clear_pointer (&shape->path, gsk_path_unref);
+  gsk_transform_unref (shape->transform);
+}
+
+static void
+gtk_symbolic_paths_append_opacity (GtkSymbolicPaths  *self,
+                                   SymbolicShapeKind  kind,
+                                   float              opacity)
+{
+  SymbolicShape shape = { kind, NULL, NULL, GSK_FILL_RULE_WINDING, GTK_SYMBOLIC_COLOR_FOREGROUND, opacity };
+
+  g_array_append_val (self->shapes, shape);
+}
+
+static void
+parser_state_clear (gpointer data)
+{
+  ParserState *state = data;
+
+  gsk_transform_unref (state->transform);
+}
+
+static void
+set_error (GError     **error,
+           const char  *format,
+           ...) G_GNUC_PRINTF (2, 3);
+
+static void
+set_error (GError     **error,
+           const char  *format,
+           ...)
+{
+  va_list args;
+
+  va_start (args, format);
+  *error = g_error_new_valist (G_MARKUP_ERROR, G_MARKUP_ERROR_INVALID_CONTENT, format, args);
+  va_end (args);
+}
+
+static const char *
+skip_separators (const char *p)
+{
+  while (g_ascii_isspace (*p) || *p == ',')
+    p++;
+
+  return p;
+}
+
+static gboolean
+parse_number (const char  *str,
+              double      *value)
+{
+  char *end;
+
+  *value = g_ascii_strtod (str, &end);
+  if (end == str)
+    return FALSE;
+
+  if (*end == '%')
+    {
+      *value /= 100;
+      end++;
+    }
+
+  while (g_ascii_isspace (*end))
+    end++;
+
+  return *end == '\0';
+}
+
+/* Lengths in user units, with an optional px */
+static gboolean
+parse_length (const char *str,
+              double     *value)
+{
+  char *end;
+
+  *value = g_ascii_strtod (str, &end);
+  if (end == str)
+    return FALSE;
+
+  if (g_str_has_prefix (end, "px"))
+    end += 2;
+
+  while (g_ascii_isspace (*end))
+    end++;
+
+  return *end == '\0';
+}
+
+/* Parses a list of numbers, separated by whitespace or commas */
+static gboolean
+parse_numbers (const char *str,
+               GArray     *numbers)
+{
+  const char *p = skip_separators (str);
+
+  while (*p)
+    {
+      char *end;
+      double value;
+
+      value = g_ascii_strtod (p, &end);
+      if (end == p)
+        return FALSE;
+
+      g_array_append_val (numbers, value);
+      p = skip_separators (end);
+    }
+
+  return TRUE;
+}
+
+static gboolean
+parse_transform (const char    *str,
+                 GskTransform **transform)
+{
+  GskTransform *result = NULL;
+  const char *p = skip_separators (str);
+
+  while (*p)
+    {
+      double args[6];
+      guint n_args = 0;
+      const char *name;
+      gsize name_len;
+
+      name = p;
+      while (g_ascii_isalpha (*p))
+        p++;
+      name_len = p - name;
+
+      while (g_ascii_isspace (*p))
+        p++;
+      if (*p != '(')
+        goto fail;
+
+      p = skip_separators (p + 1);
+      while (*p != ')')
+        {
+          char *end;
+
+          if (n_args == G_N_ELEMENTS (args))
+            goto fail;
+
+          args[n_args] = g_ascii_strtod (p, &end);
+          if (end == p)
+            goto fail;
+
+          n_args++;
+          p = skip_separators (end);
+        }
+      p = skip_separators (p + 1);
+
+#define IS(str) (name_len == strlen (str) && strncmp (name, str, name_len) == 0)
+      if (IS ("matrix") && n_args == 6)
+        {
+          graphene_matrix_t matrix;
+
+          graphene_matrix_init_from_2d (&matrix, args[0], args[1], args[2], args[3], args[4], args[5]);
+          result = gsk_transform_matrix (result, &matrix);
+        }
+      else if (IS ("translate") && (n_args == 1 || n_args == 2))
+        {
+          result = gsk_transform_translate (result, &GRAPHENE_POINT_INIT (args[0], n_args == 2 ? args[1] : 0));
+        }
+      else if (IS ("scale") && (n_args == 1 || n_args == 2))
+        {
+          result = gsk_transform_scale (result, args[0], n_args == 2 ? args[1] : args[0]);
+        }
+      else if (IS ("rotate") && n_args == 1)
+        {
+          result = gsk_transform_rotate (result, args[0]);
+        }
+      else if (IS ("rotate") && n_args == 3)
+        {
+          result = gsk_transform_translate (result, &GRAPHENE_POINT_INIT (args[1], args[2]));
+          result = gsk_transform_rotate (result, args[0]);
+          result = gsk_transform_translate (result, &GRAPHENE_POINT_INIT (-args[1], -args[2]));
+        }
+      else if (IS ("skewX") && n_args == 1)
+        {
+          result = gsk_transform_skew (result, args[0], 0);
+        }
+      else if (IS ("skewY") && n_args == 1)
+        {
+          result = gsk_transform_skew (result, 0, args[0]);
+        }
+      else
+        {
+          goto fail;
+        }
+#undef IS
+    }
+
+  *transform = result;
+  return TRUE;
+
+fail:
+  gsk_transform_unref (result);
+  return FALSE;
+}
+
+/* Applies a presentation attribute or a style property. Returns
+ * %FALSE if the element uses something that can't be drawn as
+ * filled paths.
+ */
+static gboolean
+apply_property (ParserState  *state,
+                const char   *name,
+                const char   *value,
+                double       *opacity,
+                gboolean     *display,
+                GError      **error)
+{
+  double number;
+
+  if (g_str_equal (name, "opacity"))
+    {
+      if (!parse_number (value, &number))
+        goto invalid;
+
+      *opacity = CLAMP (number, 0, 1);
+    }
+  else if (g_str_equal (name, "fill-opacity"))
+    {
+      if (g_str_equal (value, "inherit"))
+        return TRUE;
+
+      if (!parse_number (value, &number))
+        goto invalid;
+
+      state->fill_opacity = CLAMP (number, 0, 1);
+    }
+  else if (g_str_equal (name, "fill-rule"))
+    {
+      if (g_str_equal (value, "evenodd"))
+        state->fill_rule = GSK_FILL_RULE_EVEN_ODD;
+      else if (g_str_equal (value, "nonzero"))
+        state->fill_rule = GSK_FILL_RULE_WINDING;
+      else if (!g_str_equal (value, "inherit"))
+        goto invalid;
+    }
+  else if (g_str_equal (name, "fill"))
+    {
+      if (!g_str_equal (value, "inherit"))
+        state->fill_none = g_str_equal (value, "none");
+    }
+  else if (g_str_equal (name, "display"))
+    {
+      *display = !g_str_equal (value, "none");
+    }
+  else if (g_str_equal (name, "visibility"))
+    {
+      if (!g_str_equal (value, "inherit"))
+        state->visible = g_str_equal (value, "visible");
+    }
+  else if (g_str_equal (name, "stroke") ||
+           g_str_equal (name, "clip-path") ||
+           g_str_equal (name, "mask") ||
+           g_str_equal (name, "filter"))
+    {
+      if (!g_str_equal (value, "none"))
+        {
+          set_error (error, "Unsupported %s", name);
+          return FALSE;
+        }
+    }
+
+  return TRUE;
+
+invalid:
+  set_error (error, "Invalid value for %s: %s", name, value);
+  return FALSE;
+}
+
+static gboolean
+apply_style (ParserState  *state,
+             const char   *style,
+             double       *opacity,
+             gboolean     *display,
+             GError      **error)
+{
+  char **declarations;
+  gboolean result = TRUE;
+  guint i;
+
+  declarations = g_strsplit (style, ";", -1);
+
+  for (i = 0; result && declarations[i]; i++)
+    {
+      char *colon, *name, *value;
+
+      colon = strchr (declarations[i], ':');
+      if (colon == NULL)
+        continue;
+
+      *colon = '\0';
+      name = g_strstrip (declarations[i]);
+      value = g_strstrip (colon + 1);
+
+      result = apply_property (state, name, value, opacity, display, error);
+    }
+
+  g_strfreev (declarations);
+
+  return result;
+}
+
+static GtkSymbolicColor
+color_from_class (const char *class)
+{
+  char **classes;
+  GtkSymbolicColor color = GTK_SYMBOLIC_COLOR_FOREGROUND;
+  guint i;
+
+  if (class == NULL)
+    return color;
+
+  classes = g_strsplit_set (class, " \t\n", -1);
+
+  for (i = 0; classes[i]; i++)
+    {
+      if (g_str_equal (classes[i], "error"))
+        color = GTK_SYMBOLIC_COLOR_ERROR;
+      else if (g_str_equal (classes[i], "warning"))
+        color = GTK_SYMBOLIC_COLOR_WARNING;
+      else if (g_str_equal (classes[i], "success"))
+        color = GTK_SYMBOLIC_COLOR_SUCCESS;
+      else
+        continue;
+
+      break;
+    }
+
+  g_strfreev (classes);
+
+  return color;
+}
+
+static const char *
+get_attribute (const char **names,
+               const char **values,
+               const char  *name)
+{
+  guint i;
+
+  for (i = 0; names[i]; i++)
+    {
+      if (g_str_equal (names[i], name))
+        return values[i];
+    }
+
+  return NULL;
+}
+
+static gboolean
+get_length_attribute (const char **names,
+                      const char **values,
+                      const char  *name,
+                      double       default_value,
+                      double      *value,
+                      GError     **error)
+{
+  const char *str = get_attribute (names, values, name);
+
+  if (str == NULL)
+    {
+      *value = default_value;
+      return TRUE;
+    }
+
+  if (!parse_length (str, value))
+    {
+      set_error (error, "Invalid value for %s: %s", name, str);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+#define GET_LENGTH(name, default_value, value) \
+  if (!get_length_attribute (names, values, name, default_value, value, error)) \
+    return FALSE;
+
+/* Builds the path for a shape element. The path stays %NULL
+ * for shapes that don't cover anything.
+ */
+static gboolean
+build_shape_path (const char   *element_name,
+                  const char  **names,
+                  const char  **values,
+                  GskPath     **path,
+                  GError      **error)
+{
+  GskPathBuilder *builder;
+
+  *path = NULL;
+
+  if (g_str_equal (element_name, "path"))
+    {
+      const char *d = get_attribute (names, values, "d");
+
+      if (d == NULL)
+        return TRUE;
+
+      *path = gsk_path_parse (d);
+      if (*path == NULL)
+        {
+          set_error (error, "Invalid path data");
+          return FALSE;
+        }
+
+      if (gsk_path_is_empty (*path))
+        g_clear_pointer (path, gsk_path_unref);
+    }
+  else if (g_str_equal (element_name, "rect"))
+    {
+      double x, y, width, height, rx, ry;
+
+      GET_LENGTH ("x", 0, &x);
+      GET_LENGTH ("y", 0, &y);
+      GET_LENGTH ("width", 0, &width);
+      GET_LENGTH ("height", 0, &height);
+      GET_LENGTH ("rx", -1, &rx);
+      GET_LENGTH ("ry", -1, &ry);
+
+      if (width <= 0 || height <= 0)
+        return TRUE;
+
+      if (rx < 0)
+        rx = MAX (ry, 0);
+      if (ry < 0)
+        ry = rx;
+      rx = MIN (rx, width / 2);
+      ry = MIN (ry, height / 2);
+
+      builder = gsk_path_builder_new ();
+
+      if (rx > 0 && ry > 0)
+        {
+          GskRoundedRect rect;
+          graphene_size_t corner = GRAPHENE_SIZE_INIT (rx, ry);
+
+          gsk_rounded_rect_init (&rect,
+                                 &GRAPHENE_RECT_INIT (x, y, width, height),
+                                 &corner, &corner, &corner, &corner);
+          gsk_path_builder_add_rounded_rect (builder, &rect);
+        }
+      else
+        {
+          gsk_path_builder_add_rect (builder, &GRAPHENE_RECT_INIT (x, y, width, height));
+        }
+
+      *path = gsk_path_builder_free_to_path (builder);
+    }
+  else if (g_str_equal (element_name, "circle"))
+    {
+      double cx, cy, r;
+
+      GET_LENGTH ("cx", 0, &cx);
+      GET_LENGTH ("cy", 0, &cy);
+      GET_LENGTH ("r", 0, &r);
+
+      if (r <= 0)
+        return TRUE;
+
+      builder = gsk_path_builder_new ();
+      gsk_path_builder_add_circle (builder, &GRAPHENE_POINT_INIT (cx, cy), r);
+      *path = gsk_path_builder_free_to_path (builder);
+    }
+  else if (g_str_equal (element_name, "ellipse"))
+    {
+      double cx, cy, rx, ry;
+
+      GET_LENGTH ("cx", 0, &cx);
+      GET_LENGTH ("cy", 0, &cy);
+      GET_LENGTH ("rx", 0, &rx);
+      GET_LENGTH ("ry", 0, &ry);
+
+      if (rx <= 0 || ry <= 0)
+        return TRUE;
+
+      builder = gsk_path_builder_new ();
+      gsk_path_builder_move_to (builder, cx + rx, cy);
+      gsk_path_builder_svg_arc_to (builder, rx, ry, 0, FALSE, TRUE, cx - rx, cy);
+      gsk_path_builder_svg_arc_to (builder, rx, ry, 0, FALSE, TRUE, cx + rx, cy);
+      gsk_path_builder_close (builder);
+      *path = gsk_path_builder_free_to_path (builder);
+    }
+  else if (g_str_equal (element_name, "polygon") ||
+           g_str_equal (element_name, "polyline"))
+    {
+      const char *points = get_attribute (names, values, "points");
+      GArray *numbers;
+      guint i;
+
+      if (points == NULL)
+        return TRUE;
+
+      numbers = g_array_new (FALSE, FALSE, sizeof (double));
+      if (!parse_numbers (points, numbers) || numbers->len % 2 != 0)
+        {
+          g_array_unref (numbers);
+          set_error (error, "Invalid points");
+          return FALSE;
+        }
+
+      if (numbers->len < 6)
+        {
+          g_array_unref (numbers);
+          return TRUE;
+        }
+
+      /* Fills are closed either way */
+      builder = gsk_path_builder_new ();
+      gsk_path_builder_move_to (builder,
+                                g_array_index (numbers, double, 0),
+                                g_array_index (numbers, double, 1));
+      for (i = 2; i < numbers->len; i += 2)
+        gsk_path_builder_line_to (builder,
+                                  g_array_index (numbers, double, i),
+                                  g_array_index (numbers, double, i + 1));
+      gsk_path_builder_close (builder);
+      *path = gsk_path_builder_free_to_path (builder);
+
+      g_array_unref (numbers);
+    }
+  else if (g_str_equal (element_name, "line"))
+    {
+      /* Lines only have strokes */
+    }
+  else
+    {
+      set_error (error, "Unsupported element %s", element_name);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+parse_svg_element (GtkSymbolicPaths  *paths,
+                   const char       **names,
+                   const char       **values,
+                   GError           **error)
+{
+  const char *viewbox, *aspect;
+  double width, height;
+
+  GET_LENGTH ("width", -1, &width);
+  GET_LENGTH ("height", -1, &height);
+
+  aspect = get_attribute (names, values, "preserveAspectRatio");
+  if (aspect && !g_str_equal (aspect, "xMidYMid") && !g_str_equal (aspect, "xMidYMid meet"))
+    {
+      set_error (error, "Unsupported preserveAspectRatio");
+      return FALSE;
+    }
+
+  viewbox = get_attribute (names, values, "viewBox");
+  if (viewbox)
+    {
+      GArray *numbers = g_array_new (FALSE, FALSE, sizeof (double));
+
+      if (!parse_numbers (viewbox, numbers) || numbers->len != 4 ||
+          g_array_index (numbers, double, 2) <= 0 ||
+          g_array_index (numbers, double, 3) <= 0)
+        {
+          g_array_unref (numbers);
+          set_error (error, "Invalid viewBox");
+          return FALSE;
+        }
+
+      graphene_rect_init (&paths->viewbox,
+                          g_array_index (numbers, double, 0),
+                          g_array_index (numbers, double, 1),
+                          g_array_index (numbers, double, 2),
+                          g_array_index (numbers, double, 3));
+      g_array_unref (numbers);
+
+      if (width <= 0)
+        width = paths->viewbox.size.width;
+      if (height <= 0)
+        height = paths->viewbox.size.height;
+    }
+  else
+    {
+      /* Like svg_find_size_strings() */
+      if (width <= 0)
+        width = 16;
+      if (height <= 0)
+        height = 16;
+
+      graphene_rect_init (&paths->viewbox, 0, 0, width, height);
+    }
+
+  paths->width = width;
+  paths->height = height;
+
+  return TRUE;
+}
+
+static void
+start_element (GMarkupParseContext  *context,
+               const char           *element_name,
+               const char          **names,
+               const char          **values,
+               gpointer              user_data,
+               GError              **error)
+{
+  ParserData *data = user_data;
+  ParserState root = { NULL, 1, GSK_FILL_RULE_WINDING, FALSE, TRUE, FALSE };
+  ParserState *parent;
+  ParserState state;
+  double opacity = 1;
+  gboolean display = TRUE;
+  const char *str;
+  GskPath *path;
+  guint i;
+
+  if (data->skip_depth > 0)
+    {
+      data->skip_depth++;
+      return;
+    }
+
+  if (data->states->len == 0)
+    {
+      if (!g_str_equal (element_name, "svg"))
+        {
+          set_error (error, "Not an svg");
+          return;
+        }
+
+      if (!parse_svg_element (data->paths, names, values, error))
+        return;
+
+      parent = &root;
+    }
+  else
+    {
+      /* Nothing in here is drawn, unless it is referenced,
+       * which we don't support
+       */
+      if (g_str_equal (element_name, "defs") ||
+          g_str_equal (element_name, "title") ||
+          g_str_equal (element_name, "desc") ||
+          g_str_equal (element_name, "metadata") ||
+          strchr (element_name, ':') != NULL)
+        {
+          data->skip_depth = 1;
+          return;
+        }
+
+      parent = &g_array_index (data->states, ParserState, data->states->len - 1);
+    }
+
+  state = *parent;
+  state.transform = NULL;
+  state.pushed_opacity = FALSE;
+
+  for (i = 0; names[i]; i++)
+    {
+      if (!apply_property (&state, names[i], values[i], &opacity, &display, error))
+        return;
+    }
+
+  str = get_attribute (names, values, "style");
+  if (str && !apply_style (&state, str, &opacity, &display, error))
+    return;
+
+  if (!display || opacity <= 0)
+    {
+      data->skip_depth = 1;
+      return;
+    }
+
+  str = get_attribute (names, values, "transform");
+  if (str)
+    {
+      GskTransform *transform;
+
+      if (!parse_transform (str, &transform))
+        {
+          set_error (error, "Invalid transform: %s", str);
+          return;
+        }
+
+      state.transform = gsk_transform_transform (gsk_transform_ref (parent->transform), transform);
+      gsk_transform_unref (transform);
+    }
+  else
+    {
+      state.transform = gsk_transform_ref (parent->transform);
+    }
+
+  if (data->states->len == 0 || g_str_equal (element_name, "g"))
+    {
+      /* Like the rasterizer, apply the opacity to the group as a
+       * whole, so overlapping children don't show through
+       */
+      if (opacity < 1)
+        {
+          gtk_symbolic_paths_append_opacity (data->paths, SYMBOLIC_SHAPE_PUSH_OPACITY, opacity);
+          state.pushed_opacity = TRUE;
+        }
+
+      g_array_append_val (data->states, state);
+      return;
+    }
+
+  if (!build_shape_path (element_name, names, values, &path, error))
+    {
+      gsk_transform_unref (state.transform);
+      return;
+    }
+
+  /* Icons with symbolic classes are rendered through the wrapper
+   * svg, which fills these no matter what they say. Other icons
+   * are rendered as they are.
+   */
+  if (state.fill_none &&
+      (!data->has_symbolic_classes ||
+       (!g_str_equal (element_name, "path") &&
+        !g_str_equal (element_name, "rect") &&
+        !g_str_equal (element_name, "circle"))))
+    g_clear_pointer (&path, gsk_path_unref);
+
+  if (path && state.visible && opacity * state.fill_opacity > 0)
+    {
+      SymbolicShape shape;
+
+      shape.kind = SYMBOLIC_SHAPE_FILL;
+      shape.path = path;
+      shape.transform = gsk_transform_ref (state.transform);
+      shape.fill_rule = state.fill_rule;
+      shape.color = color_from_class (get_attribute (names, values, "class"));
+      shape.alpha = opacity * state.fill_opacity;
+
+      g_array_append_val (data->paths->shapes, shape);
+      data->paths->n_shapes++;
+    }
+  else
+    {
+      g_clear_pointer (&path, gsk_path_unref);
+    }
+
+  /* Shapes can have children, like a title */
+  g_array_append_val (data->states, state);
+}
+
+static void
+end_element (GMarkupParseContext  *context,
+             const char           *element_name,
+             gpointer              user_data,
+             GError              **error)
+{
+  ParserData *data = user_data;
+  ParserState *state;
+
+  if (data->skip_depth > 0)
+    {
+      data->skip_depth--;
+      return;
+    }
+
+  state = &g_array_index (data->states, ParserState, data->states->len - 1);
+  if (state->pushed_opacity)
+    gtk_symbolic_paths_append_opacity (data->paths, SYMBOLIC_SHAPE_POP, 1);
+
+  g_array_set_size (data->states, data->states->len - 1);
+}
+
+static const GMarkupParser parser = {
+  start_element,
+  end_element,
+  NULL,
+  NULL,
+  NULL
+};
+
+/* Whether all shapes are inside the viewBox, so nothing
+ * needs to be clipped away
+ */
+static gboolean
+gtk_symbolic_paths_compute_needs_clip (GtkSymbolicPaths *self)
+{
+  guint i;
+
+  for (i = 0; i < self->shapes->len; i++)
+    {
+      SymbolicShape *shape = &g_array_index (self->shapes, SymbolicShape, i);
+      graphene_rect_t bounds;
+
+      if (shape->kind != SYMBOLIC_SHAPE_FILL)
+        continue;
+
+      if (!gsk_path_get_bounds (shape->path, &bounds))
+        continue;
+
+      gsk_transform_transform_bounds (shape->transform, &bounds, &bounds);
+
+      if (!graphene_rect_contains_rect (&self->viewbox, &bounds))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+/*
+ * gtk_symbolic_paths_new:
+ * @bytes: the contents of a symbolic svg
+ * @has_symbolic_classes: whether the svg uses the symbolic classes,
+ *   and is therefore rendered through the wrapper svg
+ *
+ * Parses a symbolic icon into paths.
+ *
+ * Returns: (nullable): the paths, or %NULL if the icon
+ *   uses something that can't be drawn as filled paths
+ */
+GtkSymbolicPaths *
+gtk_symbolic_paths_new (GBytes   *bytes,
+                        gboolean  has_symbolic_classes)
+{
+  GtkSymbolicPaths *self;
+  GMarkupParseContext *context;
+  ParserData data;
+  GError *error = NULL;
+  const char *text;
+  gsize len;
+
+  self = g_atomic_rc_box_new0 (GtkSymbolicPaths);
+  self->shapes = g_array_new (FALSE, FALSE, sizeof (SymbolicShape));
+  g_array_set_clear_func (self->shapes, symbolic_shape_clear);
+
+  data.paths = self;
+  data.states = g_array_new (FALSE, FALSE, sizeof (ParserState));
+  g_array_set_clear_func (data.states, parser_state_clear);
+  data.skip_depth = 0;
+  data.has_symbolic_classes = has_symbolic_classes;
+
+  text = g_bytes_get_data (bytes, &len);
+
+  context = g_markup_parse_context_new (&parser, G_MARKUP_IGNORE_QUALIFIED, &data, NULL);
+  if (!g_markup_parse_context_parse (context, text, len, &error) ||
+      !g_markup_parse_context_end_parse (context, &error))
+    {
+      g_debug ("Drawing symbolic icon as texture: %s", error->message);
+      g_clear_error (&error);
+      g_clear_pointer (&self, gtk_symbolic_paths_unref);
+    }
+  else if (self->n_shapes == 0)
+    {
+      g_clear_pointer (&self, gtk_symbolic_paths_unref);
+    }
+  else
+    {
+      self->needs_clip = gtk_symbolic_paths_compute_needs_clip (self);
+    }
+
+  g_markup_parse_context_free (context);
+  g_array_unref (data.states);
+
+  return self;
+}
+
+GtkSymbolicPaths *
+gtk_symbolic_paths_ref (GtkSymbolicPaths *self)
+{
+  return g_atomic_rc_box_acquire (self);
+}
+
+static void
+gtk_symbolic_paths_clear (gpointer data)
+{
+  GtkSymbolicPaths *self = data;
+
+  g_array_unref (self->shapes);
+}
+
+void
+gtk_symbolic_paths_unref (GtkSymbolicPaths *self)
+{
+  g_atomic_rc_box_release_full (self, gtk_symbolic_paths_clear);
+}
+
+double
+gtk_symbolic_paths_get_width (GtkSymbolicPaths *self)
+{
+  return self->width;
+}
+
+double
+gtk_symbolic_paths_get_height (GtkSymbolicPaths *self)
+{
+  return self->height;
+}
+
+guint
+gtk_symbolic_paths_get_n_shapes (GtkSymbolicPaths *self)
+{
+  return self->n_shapes;
+}
+
+/*
+ * gtk_symbolic_paths_snapshot:
+ * @self: the paths
+ * @snapshot: the snapshot to draw to
+ * @width: width to draw in
+ * @height: height to draw in
+ * @colors: (array length=n_colors): the symbolic colors
+ * @n_colors: the number of colors, at least 1
+ *
+ * Draws the icon with a fill node per shape. Like the textures
+ * of icons, it keeps its aspect ratio and is centered.
+ */
+void
+gtk_symbolic_paths_snapshot (GtkSymbolicPaths *self,
+                             GtkSnapshot      *snapshot,
+                             double            width,
+                             double            height,
+                             const GdkRGBA    *colors,
+                             gsize             n_colors)
+{
+  double render_width, render_height, scale;
+  guint i;
+
+  g_assert (n_colors > 0);
+
+  if (self->width >= self->height)
+    {
+      render_width = width;
+      render_height = height * (self->height / self->width);
+    }
+  else
+    {
+      render_width = width * (self->width / self->height);
+      render_height = height;
+    }
+
+  scale = MIN (render_width / self->viewbox.size.width,
+               render_height / self->viewbox.size.height);
+
+  gtk_snapshot_save (snapshot);
+
+  gtk_snapshot_translate (snapshot,
+                          &GRAPHENE_POINT_INIT ((width - self->viewbox.size.width * scale) / 2,
+                                                (height - self->viewbox.size.height * scale) / 2));
+  gtk_snapshot_scale (snapshot, scale, scale);
+  gtk_snapshot_translate (snapshot,
+                          &GRAPHENE_POINT_INIT (- self->viewbox.origin.x, - self->viewbox.origin.y));
+
+  if (self->needs_clip)
+    gtk_snapshot_push_clip (snapshot, &self->viewbox);
+
+  for (i = 0; i < self->shapes->len; i++)
+    {
+      SymbolicShape *shape = &g_array_index (self->shapes, SymbolicShape, i);
+      GdkRGBA color;
+
+      if (shape->kind == SYMBOLIC_SHAPE_PUSH_OPACITY)
+        {
+          gtk_snapshot_push_opacity (snapshot, shape->alpha);
+          continue;
+        }
+      else if (shape->kind == SYMBOLIC_SHAPE_POP)
+        {
+          gtk_snapshot_pop (snapshot);
+          continue;
+        }
+
+      color = colors[shape->color < n_colors ? shape->color : GTK_SYMBOLIC_COLOR_FOREGROUND];
+      color.alpha *= shape->alpha;
+      if (color.alpha <= 0)
+        continue;
+
+      if (shape->transform)
+        {
+          gtk_snapshot_save (snapshot);
+          gtk_snapshot_transform (snapshot, shape->transform);
+          gtk_snapshot_append_fill (snapshot, shape->path, shape->fill_rule, &color);
+          gtk_snapshot_restore (snapshot);
+        }
+      else
+        {
+          gtk_snapshot_append_fill (snapshot, shape->path, shape->fill_rule, &color);
+        }
+    }
+
+  if (self->needs_clip)
+    gtk_snapshot_pop (snapshot);
+
+  gtk_snapshot_restore (snapshot);
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gtksnapshot.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GtkSymbolicPaths GtkSymbolicPaths;
+
+gboolean                gtk_symbolic_paths_enabled              (void);
+
+GtkSymbolicPaths *      gtk_symbolic_paths_new                  (GBytes                 *bytes,
+                                                                 gboolean                has_symbolic_classes);
+
+GtkSymbolicPaths *      gtk_symbolic_paths_ref                  (GtkSymbolicPaths       *self);
+void                    gtk_symbolic_paths_unref                (GtkSymbolicPaths       *self);
+
+double                  gtk_symbolic_paths_get_width            (GtkSymbolicPaths       *self);
+double                  gtk_symbolic_paths_get_height           (GtkSymbolicPaths       *self);
+guint                   gtk_symbolic_paths_get_n_shapes         (GtkSymbolicPaths       *self);
+
+void                    gtk_symbolic_paths_snapshot             (GtkSymbolicPaths       *self,
+                                                                 GtkSnapshot            *snapshot,
+                                                                 double                  width,
+                                                                 double                  height,
+                                                                 const GdkRGBA          *colors,
+                                                                 gsize                   n_colors);
+
+G_END_DECLS
@@ -66,6 +66,7 @@
 #include "gtkdebug.h"
 #include "gtktextmarkprivate.h"
 #include "gtktextsegmentprivate.h"
+#include "gtkbitmaskprivate.h"
 #include "gtkpangoprivate.h"
 #include "gdkprivate.h"
 
@@ -74,17 +75,6 @@
  */
 
 
-/*
- * The structure below is used to pass information between
- * _gtk_text_btree_get_tags and inc_count:
- */
-
-typedef struct TagInfo {
-  GPtrArray *tags;
-  GArray *counts;
-} TagInfo;
-
-
 /*
  * This is used to store per-view width/height info at the tree nodes.
  */
@@ -136,6 +126,12 @@ struct _GtkTextBTreeNode {
   Summary *summary;             /* First in malloc-ed list of info
                                  * about tags in this subtree (NULL if
                                  * no tag info in the subtree). */
+  GtkBitmask *toggle_parity;    /* Bit n is set if the tag with index n
+                                 * has an odd number of toggles in this
+                                 * subtree, i.e. the subtree switches it
+                                 * on or off. */
+  int num_toggles;                      /* Total number of tag toggles in
+                                         * the subtree rooted here. */
   int level;                            /* Level of this node in the B-tree.
                                          * 0 refers to the bottom of the tree
                                          * (children are lines, not nodes). */
@@ -179,6 +175,8 @@ struct _GtkTextBTree {
   GtkTextBuffer *buffer;
   BTreeView *views;
   GSList *tag_infos;
+  GPtrArray *tag_info_slots;            /* GtkTextTagInfo by info->index,
+                                         * NULL for unused indexes */
   gulong tag_changed_handler;
 
   /* Incremented when a segment with a byte size > 0
@@ -307,9 +305,6 @@ static void tag_changed_cb        (GtkTextTagTable  *table,
 static void cleanup_line          (GtkTextLine      *line);
 static void recompute_node_counts (GtkTextBTree     *tree,
                                    GtkTextBTreeNode *node);
-static void inc_count             (GtkTextTag       *tag,
-                                   int               inc,
-                                   TagInfo          *tagInfoPtr);
 
 static void summary_destroy       (Summary          *summary);
 
@@ -346,6 +341,91 @@ chars_changed (GtkTextBTree *tree)
   tree->chars_changed_stamp += 1;
 }
 
+static inline GtkBitmask *
+toggle_parity_flip (GtkBitmask *parity,
+                    guint       index)
+{
+  return _gtk_bitmask_set (parity, index, !_gtk_bitmask_get (parity, index));
+}
+
+/* Combines the toggles of two ranges, i.e. computes parity ^ other */
+static inline GtkBitmask *
+toggle_parity_add (GtkBitmask       *parity,
+                   const GtkBitmask *other)
+{
+  if (_gtk_bitmask_is_empty (other))
+    return parity;
+
+  return _gtk_bitmask_xor (parity, other);
+}
+
+/* The tags that are on at a position, computed by adding up the
+ * toggle parities of the nodes before it. The bits are kept in an
+ * array that is sized for the tags of the tree up front, so adding
+ * the parities of many nodes does not allocate, even with more tags
+ * than fit into the bits of an unallocated GtkBitmask.
+ */
+#define PARITY_WORD_BITS (sizeof (gsize) * 8)
+#define PARITY_PREALLOC_WORDS 4
+
+typedef struct
+{
+  gsize *bits;
+  gsize n_words;
+  gsize prealloc[PARITY_PREALLOC_WORDS];
+} TagParity;
+
+static void
+tag_parity_init (TagParity    *parity,
+                 GtkTextBTree *tree)
+{
+  parity->n_words = (tree->tag_info_slots->len + PARITY_WORD_BITS - 1) / PARITY_WORD_BITS;
+
+  if (parity->n_words <= PARITY_PREALLOC_WORDS)
+    parity->bits = parity->prealloc;
+  else
+    parity->bits = g_new (gsize, parity->n_words);
+
+  memset (parity->bits, 0, parity->n_words * sizeof (gsize));
+}
+
+static void
+tag_parity_clear (TagParity *parity)
+{
+  if (parity->bits != parity->prealloc)
+    g_free (parity->bits);
+}
+
+static inline void
+tag_parity_flip (TagParity *parity,
+                 guint      index)
+{
+  g_assert (index / PARITY_WORD_BITS < parity->n_words);
+
+  parity->bits[index / PARITY_WORD_BITS] ^= ((gsize) 1) << (index % PARITY_WORD_BITS);
+}
+
+static inline gboolean
+tag_parity_get (const TagParity *parity,
+                guint            index)
+{
+  return (parity->bits[index / PARITY_WORD_BITS] >> (index % PARITY_WORD_BITS)) & 1;
+}
+
+static gboolean
+tag_parity_is_empty (const TagParity *parity)
+{
+  gsize i;
+
+  for (i = 0; i < parity->n_words; i++)
+    {
+      if (parity->bits[i])
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
 /*
  * BTree operations
  */
@@ -425,6 +505,7 @@ _gtk_text_btree_new (GtkTextTagTable *table,
 
   tree->mark_table = g_hash_table_new (g_str_hash, g_str_equal);
   tree->child_anchor_table = NULL;
+  tree->tag_info_slots = g_ptr_array_new ();
 
   /* We don't ref the buffer, since the buffer owns us;
    * we'd have some circularity issues. The buffer always
@@ -499,6 +580,9 @@ _gtk_text_btree_unref (GtkTextBTree *tree)
       gtk_text_btree_node_destroy (tree, tree->root_node);
       tree->root_node = NULL;
 
+      g_ptr_array_unref (tree->tag_info_slots);
+      tree->tag_info_slots = NULL;
+
       g_assert (g_hash_table_size (tree->mark_table) == 0);
       g_hash_table_destroy (tree->mark_table);
       tree->mark_table = NULL;
@@ -584,7 +668,7 @@ gtk_text_btree_resolve_bidi (GtkTextIter *start,
             {
 	      PangoDirection pango_dir;
 
-              pango_dir = gdk_find_base_dir (seg->body.chars, seg->byte_count);
+              pango_dir = gdk_find_base_dir (_gtk_char_segment_get_chars (seg), seg->byte_count);
 
               if (pango_dir != PANGO_DIRECTION_NEUTRAL)
                 {
@@ -1073,14 +1157,104 @@ _gtk_text_btree_delete (GtkTextIter *start,
   gtk_text_btree_resolve_bidi (start, end);
 }
 
+/* Adds @seg after *cur_seg in *line. If @seg ends in a paragraph
+ * delimiter, the remainder of the line is moved to a new line,
+ * which becomes the current line.
+ */
+static void
+insert_char_segment (GtkTextLine         **line,
+                     GtkTextLineSegment  **cur_seg,
+                     GtkTextLineSegment   *seg,
+                     gboolean              ends_line)
+{
+  GtkTextLine *newline;
+
+  if (*cur_seg == NULL)
+    {
+      seg->next = (*line)->segments;
+      (*line)->segments = seg;
+    }
+  else
+    {
+      seg->next = (*cur_seg)->next;
+      (*cur_seg)->next = seg;
+    }
+
+  if (!ends_line)
+    {
+      *cur_seg = seg;
+      return;
+    }
+
+  /*
+   * The chunk ended with a newline, so create a new GtkTextLine
+   * and move the remainder of the old line to it.
+   */
+
+  newline = gtk_text_line_new ();
+  gtk_text_line_set_parent (newline, (*line)->parent);
+  newline->next = (*line)->next;
+  (*line)->next = newline;
+  newline->segments = seg->next;
+  seg->next = NULL;
+  *line = newline;
+  *cur_seg = NULL;
+}
+
+static void
+finish_insert (GtkTextBTree *tree,
+               GtkTextIter  *iter,
+               GtkTextLine  *start_line,
+               int           start_byte_index,
+               GtkTextLine  *line,
+               int           line_count_delta,
+               int           char_count_delta)
+{
+  GtkTextIter start;
+  GtkTextIter end;
+
+  /*
+   * Cleanup the starting line for the insertion, plus the ending
+   * line if it's different.
+   */
+
+  cleanup_line (start_line);
+  if (line != start_line)
+    {
+      cleanup_line (line);
+    }
+
+  post_insert_fixup (tree, line, line_count_delta, char_count_delta);
+
+  /* Invalidate our region, and reset the iterator the user
+     passed in to point to the end of the inserted text. */
+
+  _gtk_text_btree_get_iter_at_line (tree,
+                                    &start,
+                                    start_line,
+                                    start_byte_index);
+  end = start;
+
+  /* We could almost certainly be more efficient here
+     by saving the information from the insertion loop
+     above. FIXME */
+  gtk_text_iter_forward_chars (&end, char_count_delta);
+
+  DV (g_print ("invalidating due to inserting some text (%s)\n", G_STRLOC));
+  _gtk_text_btree_invalidate_region (tree, &start, &end, FALSE);
+
+
+  /* Convenience for the user */
+  *iter = end;
+
+  gtk_text_btree_resolve_bidi (&start, &end);
+}
+
 void
 _gtk_text_btree_insert (GtkTextIter *iter,
                         const char *text,
                         int          len)
 {
-  GtkTextLineSegment *prev_seg;     /* The segment just before the first
-                                     * new segment (NULL means new segment
-                                     * is at beginning of line). */
   GtkTextLineSegment *cur_seg;              /* Current segment;  new characters
                                              * are inserted just after this one.
                                              * NULL means insert at beginning of
@@ -1088,7 +1262,6 @@ _gtk_text_btree_insert (GtkTextIter *iter,
   GtkTextLine *line;           /* Current line (new segments are
                                 * added to this line). */
   GtkTextLineSegment *seg;
-  GtkTextLine *newline;
   int chunk_len;                        /* # characters in current chunk. */
   int sol;                           /* start of line */
   int eol;                           /* Pointer to character just after last
@@ -1122,8 +1295,7 @@ _gtk_text_btree_insert (GtkTextIter *iter,
    * should not be on that line, as we assert here.
    */
   g_assert (!_gtk_text_line_is_last (line, tree));
-  prev_seg = gtk_text_line_segment_split (iter);
-  cur_seg = prev_seg;
+  cur_seg = gtk_text_line_segment_split (iter);
 
   /* Invalidate all iterators */
   chars_changed (tree);
@@ -1165,80 +1337,98 @@ _gtk_text_btree_insert (GtkTextIter *iter,
 
       char_count_delta += seg->char_count;
 
-      if (cur_seg == NULL)
-        {
-          seg->next = line->segments;
-          line->segments = seg;
-        }
-      else
-        {
-          seg->next = cur_seg->next;
-          cur_seg->next = seg;
-        }
+      /* delim == eol means the chunk didn't end with a paragraph separator */
+      g_assert (delim != eol || eol == len);
+      insert_char_segment (&line, &cur_seg, seg, delim != eol);
 
-      if (delim == eol)
-        {
-          /* chunk didn't end with a paragraph separator */
-          g_assert (eol == len);
-          break;
-        }
+      if (delim != eol)
+        line_count_delta++;
+    }
 
-      /*
-       * The chunk ended with a newline, so create a new GtkTextLine
-       * and move the remainder of the old line to it.
-       */
+  finish_insert (tree, iter,
+                 start_line, start_byte_index,
+                 line, line_count_delta, char_count_delta);
+}
 
-      newline = gtk_text_line_new ();
-      gtk_text_line_set_parent (newline, line->parent);
-      newline->next = line->next;
-      line->next = newline;
-      newline->segments = seg->next;
-      seg->next = NULL;
-      line = newline;
-      cur_seg = NULL;
-      line_count_delta++;
-    }
+/*
+ * _gtk_text_btree_insert_spans:
+ * @iter: where to insert
+ * @text: valid UTF-8 text without nul bytes
+ * @spans: (array length=n_spans): the paragraphs of @text
+ * @n_spans: the number of spans
+ *
+ * Inserts @text like _gtk_text_btree_insert(), but without copying it.
+ * The caller has already split @text into paragraphs, as
+ * pango_find_paragraph_boundary() does, and must keep @text alive
+ * for as long as the tree exists.
+ */
+void
+_gtk_text_btree_insert_spans (GtkTextIter           *iter,
+                              const char            *text,
+                              const GtkTextLineSpan *spans,
+                              guint                  n_spans)
+{
+  GtkTextLineSegment *cur_seg;
+  GtkTextLine *line;
+  GtkTextLine *start_line;
+  GtkTextBTree *tree;
+  int start_byte_index;
+  int line_count_delta;
+  int char_count_delta;
+  guint i;
 
-  /*
-   * Cleanup the starting line for the insertion, plus the ending
-   * line if it's different.
-   */
+  g_return_if_fail (text != NULL);
+  g_return_if_fail (iter != NULL);
 
-  cleanup_line (start_line);
-  if (line != start_line)
-    {
-      cleanup_line (line);
-    }
+  if (n_spans == 0)
+    return;
 
-  post_insert_fixup (tree, line, line_count_delta, char_count_delta);
+  tree = _gtk_text_iter_get_btree (iter);
+  line = _gtk_text_iter_get_text_line (iter);
 
-  /* Invalidate our region, and reset the iterator the user
-     passed in to point to the end of the inserted text. */
-  {
-    GtkTextIter start;
-    GtkTextIter end;
+  start_line = line;
+  start_byte_index = gtk_text_iter_get_line_index (iter);
 
+  g_assert (!_gtk_text_line_is_last (line, tree));
+  cur_seg = gtk_text_line_segment_split (iter);
 
-    _gtk_text_btree_get_iter_at_line (tree,
-                                      &start,
-                                      start_line,
-                                      start_byte_index);
-    end = start;
+  chars_changed (tree);
+  segments_changed (tree);
 
-    /* We could almost certainly be more efficient here
-       by saving the information from the insertion loop
-       above. FIXME */
-    gtk_text_iter_forward_chars (&end, char_count_delta);
+  line_count_delta = 0;
+  char_count_delta = 0;
+  for (i = 0; i < n_spans; i++)
+    {
+      GtkTextLineSegment *seg;
+      gboolean ends_line;
 
-    DV (g_print ("invalidating due to inserting some text (%s)\n", G_STRLOC));
-    _gtk_text_btree_invalidate_region (tree, &start, &end, FALSE);
+      seg = _gtk_char_segment_new_external (text, spans[i].byte_count, spans[i].char_count);
 
+      /* Only the last span may lack a paragraph delimiter */
+      if (i + 1 < n_spans)
+        {
+          ends_line = TRUE;
+        }
+      else
+        {
+          int delim, eol;
+
+          pango_find_paragraph_boundary (text, spans[i].byte_count, &delim, &eol);
+          ends_line = delim != eol;
+        }
 
-    /* Convenience for the user */
-    *iter = end;
+      char_count_delta += seg->char_count;
+      insert_char_segment (&line, &cur_seg, seg, ends_line);
 
-    gtk_text_btree_resolve_bidi (&start, &end);
-  }
+      if (ends_line)
+        line_count_delta++;
+
+      text += spans[i].byte_count;
+    }
+
+  finish_insert (tree, iter,
+                 start_line, start_byte_index,
+                 line, line_count_delta, char_count_delta);
 }
 
 static void
@@ -2184,26 +2374,19 @@ _gtk_text_btree_get_line_at_char (GtkTextBTree      *tree,
   return line;
 }
 
-/* It returns an array sorted by tags priority, ready to pass to
- * _gtk_text_attributes_fill_from_tags() */
-GPtrArray *
-_gtk_text_btree_get_tags (const GtkTextIter *iter)
+/* Computes which tags are toggled on at @byte_index in @line.
+ * Bit n of @parity is set if the tag with info index n is on.
+ * @parity must have been initialized for the tree of @line.
+ */
+static void
+gtk_text_btree_get_toggle_parity (GtkTextLine *line,
+                                  int          byte_index,
+                                  TagParity   *parity)
 {
   GtkTextBTreeNode *node;
   GtkTextLine *siblingline;
   GtkTextLineSegment *seg;
-  int src, dst, index;
-  TagInfo tagInfo;
-  GtkTextLine *line;
-  int byte_index;
-
-#define NUM_TAG_INFOS 10
-
-  line = _gtk_text_iter_get_text_line (iter);
-  byte_index = gtk_text_iter_get_line_index (iter);
-
-  tagInfo.tags = g_ptr_array_sized_new (NUM_TAG_INFOS);
-  tagInfo.counts = g_array_new (FALSE, FALSE, sizeof (int));
+  int index;
 
   /*
    * Record tag toggles within the line of indexPtr but preceding
@@ -2218,84 +2401,96 @@ _gtk_text_btree_get_tags (const GtkTextIter *iter)
       if ((seg->type == &gtk_text_toggle_on_type)
           || (seg->type == &gtk_text_toggle_off_type))
         {
-          inc_count (seg->body.toggle.info->tag, 1, &tagInfo);
+          tag_parity_flip (parity, seg->body.toggle.info->index);
         }
     }
 
   /*
    * Record toggles for tags in lines that are predecessors of
-   * line but under the same level-0 GtkTextBTreeNode.
+   * line but under the same level-0 GtkTextBTreeNode. There's
+   * nothing to find if the node has no toggles at all.
    */
 
-  for (siblingline = line->parent->children.line;
-       siblingline != line;
-       siblingline = siblingline->next)
+  if (line->parent->num_toggles > 0)
     {
-      for (seg = siblingline->segments; seg != NULL;
-           seg = seg->next)
+      for (siblingline = line->parent->children.line;
+           siblingline != line;
+           siblingline = siblingline->next)
         {
-          if ((seg->type == &gtk_text_toggle_on_type)
-              || (seg->type == &gtk_text_toggle_off_type))
+          for (seg = siblingline->segments; seg != NULL;
+               seg = seg->next)
             {
-              inc_count (seg->body.toggle.info->tag, 1, &tagInfo);
+              if ((seg->type == &gtk_text_toggle_on_type)
+                  || (seg->type == &gtk_text_toggle_off_type))
+                {
+                  tag_parity_flip (parity, seg->body.toggle.info->index);
+                }
             }
         }
     }
 
   /*
-   * For each GtkTextBTreeNode in the ancestry of this line, record tag
-   * toggles for all siblings that precede that GtkTextBTreeNode.
+   * For each GtkTextBTreeNode in the ancestry of this line, add the
+   * toggles of all siblings that precede that GtkTextBTreeNode.
    */
 
   for (node = line->parent; node->parent != NULL;
        node = node->parent)
     {
       GtkTextBTreeNode *siblingPtr;
-      Summary *summary;
 
       for (siblingPtr = node->parent->children.node;
            siblingPtr != node; siblingPtr = siblingPtr->next)
         {
-          for (summary = siblingPtr->summary; summary != NULL;
-               summary = summary->next)
-            {
-              if (summary->toggle_count & 1)
-                {
-                  inc_count (summary->info->tag, summary->toggle_count,
-                             &tagInfo);
-                }
-            }
+          _gtk_bitmask_xor_into (siblingPtr->toggle_parity, parity->bits, parity->n_words);
         }
     }
+}
 
-  /*
-   * Go through the tag information and squash out all of the tags
-   * that have even toggle counts (these tags exist before the point
-   * of interest, but not at the desired character itself).
-   */
+/* It returns an array sorted by tags priority, ready to pass to
+ * _gtk_text_attributes_fill_from_tags() */
+GPtrArray *
+_gtk_text_btree_get_tags (const GtkTextIter *iter)
+{
+  GtkTextBTree *tree;
+  TagParity parity;
+  GPtrArray *tags;
+  guint i;
+
+#define NUM_TAG_INFOS 10
 
-  for (src = 0, dst = 0; src < tagInfo.tags->len; src++)
+  tree = _gtk_text_iter_get_btree (iter);
+  tag_parity_init (&parity, tree);
+  gtk_text_btree_get_toggle_parity (_gtk_text_iter_get_text_line (iter),
+                                    gtk_text_iter_get_line_index (iter),
+                                    &parity);
+
+  if (tag_parity_is_empty (&parity))
     {
-      if (g_array_index (tagInfo.counts, int, src) & 1)
-        {
-          g_assert (GTK_IS_TEXT_TAG (g_ptr_array_index (tagInfo.tags, src)));
-          g_ptr_array_index (tagInfo.tags, dst) = g_ptr_array_index (tagInfo.tags, src);
-          dst++;
-        }
+      tag_parity_clear (&parity);
+      return NULL;
     }
 
-  g_ptr_array_set_size (tagInfo.tags, dst);
-  g_array_unref (tagInfo.counts);
-  if (dst == 0)
+  tags = g_ptr_array_sized_new (NUM_TAG_INFOS);
+
+  for (i = 0; i < tree->tag_info_slots->len; i++)
     {
-      g_ptr_array_unref (tagInfo.tags);
-      return NULL;
+      if (tag_parity_get (&parity, i))
+        {
+          GtkTextTagInfo *info = g_ptr_array_index (tree->tag_info_slots, i);
+
+          g_assert (info != NULL);
+          g_assert (GTK_IS_TEXT_TAG (info->tag));
+          g_ptr_array_add (tags, info->tag);
+        }
     }
 
+  tag_parity_clear (&parity);
+
   /* Sort tags in ascending order of priority */
-  _gtk_text_tag_array_sort (tagInfo.tags);
+  _gtk_text_tag_array_sort (tags);
 
-  return tagInfo.tags;
+  return tags;
 }
 
 static void
@@ -2349,7 +2544,7 @@ copy_segment (GString *string,
           g_assert ((copy_start + copy_bytes) <= seg->byte_count);
 
           g_string_append_len (string,
-                               seg->body.chars + copy_start,
+                               _gtk_char_segment_get_chars (seg) + copy_start,
                                copy_bytes);
         }
 
@@ -2463,17 +2658,10 @@ gboolean
 _gtk_text_btree_char_is_invisible (const GtkTextIter *iter)
 {
   gboolean invisible = FALSE;  /* if nobody says otherwise, it's visible */
-  int *tagCnts;
-  GtkTextTag **tags;
-  int numTags;
-  GtkTextBTreeNode *node;
-  GtkTextLine *siblingline;
-  GtkTextLineSegment *seg;
-  GtkTextTag *tag;
-  int i, index;
-  GtkTextLine *line;
+  GtkTextTag *top_tag = NULL;
+  TagParity parity;
   GtkTextBTree *tree;
-  int byte_index;
+  guint i;
 
   tree = _gtk_text_iter_get_btree (iter);
 
@@ -2483,117 +2671,36 @@ _gtk_text_btree_char_is_invisible (const GtkTextIter *iter)
   if G_LIKELY (!_gtk_text_tag_table_affects_visibility (tree->table))
     return FALSE;
 
-  line = _gtk_text_iter_get_text_line (iter);
-
-  byte_index = gtk_text_iter_get_line_index (iter);
-
-  numTags = gtk_text_tag_table_get_size (tree->table);
-
-  tagCnts = g_alloca (sizeof (int) * numTags);
-  tags = g_alloca (sizeof (GtkTextTag *) * numTags);
-
-  memset (tagCnts, 0, sizeof (int) * numTags);
-
-  /*
-   * Record tag toggles within the line of indexPtr but preceding
-   * indexPtr.
-   */
-
-  for (index = 0, seg = line->segments;
-       (index + seg->byte_count) <= byte_index; /* segfault here means invalid index */
-       index += seg->byte_count, seg = seg->next)
-    {
-      if ((seg->type == &gtk_text_toggle_on_type)
-          || (seg->type == &gtk_text_toggle_off_type))
-        {
-          tag = seg->body.toggle.info->tag;
-          if (tag->priv->invisible_set)
-            {
-              tags[tag->priv->priority] = tag;
-              tagCnts[tag->priv->priority]++;
-            }
-        }
-    }
+  tag_parity_init (&parity, tree);
+  gtk_text_btree_get_toggle_parity (_gtk_text_iter_get_text_line (iter),
+                                    gtk_text_iter_get_line_index (iter),
+                                    &parity);
 
   /*
-   * Record toggles for tags in lines that are predecessors of
-   * line but under the same level-0 GtkTextBTreeNode.
+   * Take the invisible value from the highest priority tag
+   * that is on and sets it.
    */
 
-  for (siblingline = line->parent->children.line;
-       siblingline != line;
-       siblingline = siblingline->next)
+  if (!tag_parity_is_empty (&parity))
     {
-      for (seg = siblingline->segments; seg != NULL;
-           seg = seg->next)
+      for (i = 0; i < tree->tag_info_slots->len; i++)
         {
-          if ((seg->type == &gtk_text_toggle_on_type)
-              || (seg->type == &gtk_text_toggle_off_type))
-            {
-              tag = seg->body.toggle.info->tag;
-              if (tag->priv->invisible_set)
-                {
-                  tags[tag->priv->priority] = tag;
-                  tagCnts[tag->priv->priority]++;
-                }
-            }
-        }
-    }
+          GtkTextTagInfo *info;
 
-  /*
-   * For each GtkTextBTreeNode in the ancestry of this line, record tag toggles
-   * for all siblings that precede that GtkTextBTreeNode.
-   */
+          if (!tag_parity_get (&parity, i))
+            continue;
 
-  for (node = line->parent; node->parent != NULL;
-       node = node->parent)
-    {
-      GtkTextBTreeNode *siblingPtr;
-      Summary *summary;
-
-      for (siblingPtr = node->parent->children.node;
-           siblingPtr != node; siblingPtr = siblingPtr->next)
-        {
-          for (summary = siblingPtr->summary; summary != NULL;
-               summary = summary->next)
-            {
-              if (summary->toggle_count & 1)
-                {
-                  tag = summary->info->tag;
-                  if (tag->priv->invisible_set)
-                    {
-                      tags[tag->priv->priority] = tag;
-                      tagCnts[tag->priv->priority] += summary->toggle_count;
-                    }
-                }
-            }
+          info = g_ptr_array_index (tree->tag_info_slots, i);
+          if (info->tag->priv->invisible_set &&
+              (top_tag == NULL || info->tag->priv->priority > top_tag->priv->priority))
+            top_tag = info->tag;
         }
     }
 
-  /*
-   * Now traverse from highest priority to lowest,
-   * take invisible value from first odd count (= on)
-   */
+  tag_parity_clear (&parity);
 
-  for (i = numTags-1; i >=0; i--)
-    {
-      if (tagCnts[i] & 1)
-        {
-          /* FIXME not sure this should be if 0 */
-#if 0
-#ifndef ALWAYS_SHOW_SELECTION
-          /* who would make the selection invisible? */
-          if ((tag == tkxt->seltag)
-              && !(tkxt->flags & GOT_FOCUS))
-            {
-              continue;
-            }
-#endif
-#endif
-          invisible = tags[i]->priv->values->invisible;
-          break;
-        }
-    }
+  if (top_tag)
+    invisible = top_tag->priv->values->invisible;
 
   return invisible;
 }
@@ -3444,7 +3551,7 @@ ensure_end_iter_segment (GtkTextBTree *tree)
       tree->end_iter_segment_stamp = tree->segments_changed_stamp;
 
       g_assert (tree->end_iter_segment->type == &gtk_text_char_type);
-      g_assert (tree->end_iter_segment->body.chars[tree->end_iter_segment_byte_index] == '\n');
+      g_assert (_gtk_char_segment_get_chars (tree->end_iter_segment)[tree->end_iter_segment_byte_index] == '\n');
     }
 }
 
@@ -3943,7 +4050,7 @@ _gtk_text_line_byte_to_char (GtkTextLine *line,
   else
     {
       if (seg->type == &gtk_text_char_type)
-        return char_offset + g_utf8_strlen (seg->body.chars, byte_offset);
+        return char_offset + g_utf8_strlen (_gtk_char_segment_get_chars (seg), byte_offset);
       else
         {
           g_assert (seg->char_count == 1);
@@ -4150,7 +4257,7 @@ _gtk_text_line_byte_to_char_offsets (GtkTextLine *line,
 
   if (seg->type == &gtk_text_char_type)
     {
-      *seg_char_offset = g_utf8_strlen (seg->body.chars, offset);
+      *seg_char_offset = g_utf8_strlen (_gtk_char_segment_get_chars (seg), offset);
 
       g_assert (*seg_char_offset < seg->char_count);
 
@@ -4199,12 +4306,12 @@ _gtk_text_line_char_to_byte_offsets (GtkTextLine *line,
 
       /* if in the last fourth of the segment walk backwards */
       if (seg->char_count - offset < seg->char_count / 4)
-        p = g_utf8_offset_to_pointer (seg->body.chars + seg->byte_count,
+        p = g_utf8_offset_to_pointer (_gtk_char_segment_get_chars (seg) + seg->byte_count,
                                       offset - seg->char_count);
       else
-        p = g_utf8_offset_to_pointer (seg->body.chars, offset);
+        p = g_utf8_offset_to_pointer (_gtk_char_segment_get_chars (seg), offset);
 
-      *seg_byte_offset = p - seg->body.chars;
+      *seg_byte_offset = p - _gtk_char_segment_get_chars (seg);
 
       g_assert (*seg_byte_offset < seg->byte_count);
 
@@ -4329,10 +4436,37 @@ _gtk_text_line_next_could_contain_tag (GtkTextLine  *line,
 
   if (tag == NULL)
     {
-      /* Right now we can only offer linear-search if the user wants
-       * to know about any tag toggle at all.
+      /* Nodes know how many toggles they contain in total, so we can
+       * skip over all subtrees without any toggles.
        */
-      return _gtk_text_line_next_excluding_last (line);
+      if (line->next)
+        return _gtk_text_line_next_excluding_last (line);
+
+      node = line->parent;
+      while (node != NULL)
+        {
+          if (node->next == NULL)
+            node = node->parent;
+          else
+            {
+              node = node->next;
+
+              if (node->num_toggles > 0)
+                break;
+            }
+        }
+
+      if (node == NULL)
+        return NULL;
+
+      while (node->level > 0)
+        {
+          node = node->children.node;
+          while (node->num_toggles == 0)
+            node = node->next;
+        }
+
+      return node->children.line;
     }
 
   /* Our tag summaries only have node precision, not line
@@ -4492,10 +4626,51 @@ _gtk_text_line_previous_could_contain_tag (GtkTextLine  *line,
 
   if (tag == NULL)
     {
-      /* Right now we can only offer linear-search if the user wants
-       * to know about any tag toggle at all.
-       */
-      return _gtk_text_line_previous (line);
+      /* See above, skip all subtrees without toggles */
+      prev = prev_line_under_node (line->parent, line);
+      if (prev)
+        return prev;
+
+      for (line_ancestor = line->parent;
+           line_ancestor->parent != NULL;
+           line_ancestor = line_ancestor->parent)
+        {
+          for (node = line_ancestor->parent->children.node;
+               node != line_ancestor;
+               node = node->next)
+            {
+              if (node->num_toggles > 0)
+                found_node = node;
+            }
+
+          if (found_node)
+            break;
+        }
+
+      if (found_node == NULL)
+        return NULL;
+
+      node = found_node;
+      while (node->level > 0)
+        {
+          GtkTextBTreeNode *child;
+
+          found_node = NULL;
+          for (child = node->children.node; child != NULL; child = child->next)
+            {
+              if (child->num_toggles > 0)
+                found_node = child;
+            }
+
+          g_assert (found_node != NULL);
+          node = found_node;
+        }
+
+      prev = node->children.line;
+      while (prev->next)
+        prev = prev->next;
+
+      return prev;
     }
 
   /* Return same-node line, if any. */
@@ -4872,6 +5047,8 @@ gtk_text_btree_node_new (void)
   node = g_new (GtkTextBTreeNode, 1);
 
   node->node_data = NULL;
+  node->toggle_parity = _gtk_bitmask_new ();
+  node->num_toggles = 0;
 
   return node;
 }
@@ -5519,6 +5696,7 @@ gtk_text_btree_node_free_empty (GtkTextBTree *tree,
 
   summary_list_destroy (node->summary);
   node_data_list_destroy (node->node_data);
+  _gtk_bitmask_free (node->toggle_parity);
   g_free (node);
 }
 
@@ -6009,6 +6187,20 @@ gtk_text_btree_get_tag_info (GtkTextBTree *tree,
       info->tag_root = NULL;
       info->toggle_count = 0;
 
+      /* Reuse the index of a removed tag, so the toggle parity
+       * bitmasks in the tree nodes stay small.
+       */
+      for (info->index = 0; info->index < tree->tag_info_slots->len; info->index++)
+        {
+          if (g_ptr_array_index (tree->tag_info_slots, info->index) == NULL)
+            break;
+        }
+
+      if (info->index == tree->tag_info_slots->len)
+        g_ptr_array_add (tree->tag_info_slots, info);
+      else
+        g_ptr_array_index (tree->tag_info_slots, info->index) = info;
+
       tree->tag_infos = g_slist_prepend (tree->tag_infos, info);
     }
 
@@ -6041,6 +6233,11 @@ gtk_text_btree_remove_tag_info (GtkTextBTree *tree,
           list->next = NULL;
           g_slist_free (list);
 
+          /* All toggles of the tag are gone at this point, so no
+           * node has the bit for this index set anymore.
+           */
+          g_ptr_array_index (tree->tag_info_slots, info->index) = NULL;
+
           g_object_unref (info->tag);
 
           g_free (info);
@@ -6088,6 +6285,9 @@ recompute_level_zero_counts (GtkTextBTreeNode *node)
               info = seg->body.toggle.info;
 
               gtk_text_btree_node_adjust_toggle_count (node, info, 1);
+
+              node->toggle_parity = toggle_parity_flip (node->toggle_parity, info->index);
+              node->num_toggles++;
             }
 
           seg = seg->next;
@@ -6111,6 +6311,8 @@ recompute_level_nonzero_counts (GtkTextBTreeNode *node)
       node->num_children += 1;
       node->num_lines += child->num_lines;
       node->num_chars += child->num_chars;
+      node->num_toggles += child->num_toggles;
+      node->toggle_parity = toggle_parity_add (node->toggle_parity, child->toggle_parity);
 
       if (child->parent != node)
         {
@@ -6175,6 +6377,9 @@ recompute_node_counts (GtkTextBTree *tree, GtkTextBTreeNode *node)
   node->num_children = 0;
   node->num_lines = 0;
   node->num_chars = 0;
+  node->num_toggles = 0;
+  _gtk_bitmask_free (node->toggle_parity);
+  node->toggle_parity = _gtk_bitmask_new ();
 
   /*
    * Scan through the children, adding the childrens’ tag counts into
@@ -6253,6 +6458,18 @@ _gtk_change_node_toggle_count (GtkTextBTreeNode *node,
 
   info->toggle_count += delta;
 
+  /*
+   * The toggle counts and parities are kept for all ancestors,
+   * not just the ones below the tag root.
+   */
+
+  for (node2Ptr = node; node2Ptr != NULL; node2Ptr = node2Ptr->parent)
+    {
+      node2Ptr->num_toggles += delta;
+      if (delta & 1)
+        node2Ptr->toggle_parity = toggle_parity_flip (node2Ptr->toggle_parity, info->index);
+    }
+
   if (info->tag_root == (GtkTextBTreeNode *) NULL)
     {
       info->tag_root = node;
@@ -6428,48 +6645,6 @@ _gtk_change_node_toggle_count (GtkTextBTreeNode *node,
     }
 }
 
-/*
- *----------------------------------------------------------------------
- *
- * inc_count --
- *
- *      This is a utility procedure used by _gtk_text_btree_get_tags.  It
- *      increments the count for a particular tag, adding a new
- *      entry for that tag if there wasn’t one previously.
- *
- * Results:
- *      None.
- *
- * Side effects:
- *      The information at *tagInfoPtr may be modified, and the arrays
- *      may be reallocated to make them larger.
- *
- *----------------------------------------------------------------------
- */
-
-static void
-inc_count (GtkTextTag *tag, int inc, TagInfo *tagInfoPtr)
-{
-  for (int i = 0; i < tagInfoPtr->tags->len; i++)
-    {
-      GtkTextTag *t = g_ptr_array_index (tagInfoPtr->tags, i);
-      if (t == tag)
-        {
-          g_array_index (tagInfoPtr->counts, int, i) += inc;
-          return;
-        }
-    }
-
-  /*
-   * There isn’t currently an entry for this tag, so we have to
-   * make a new one.  If the arrays are full, then enlarge the
-   * arrays first.
-   */
-
-  g_ptr_array_add (tagInfoPtr->tags, tag);
-  g_array_append_val (tagInfoPtr->counts, inc);
-}
-
 static void
 gtk_text_btree_link_segment (GtkTextLineSegment *seg,
                              const GtkTextIter *iter)
@@ -6647,7 +6822,8 @@ gtk_text_btree_node_check_consistency (GtkTextBTree     *tree,
   Summary *summary, *summary2;
   GtkTextLine *line;
   GtkTextLineSegment *segPtr;
-  int num_children, num_lines, num_chars, toggle_count, min_children;
+  int num_children, num_lines, num_chars, num_toggles, toggle_count, min_children;
+  GtkBitmask *toggle_parity;
   GtkTextLineData *ld;
   NodeData *nd;
 
@@ -6679,6 +6855,8 @@ gtk_text_btree_node_check_consistency (GtkTextBTree     *tree,
   num_children = 0;
   num_lines = 0;
   num_chars = 0;
+  num_toggles = 0;
+  toggle_parity = _gtk_bitmask_new ();
   if (node->level == 0)
     {
       for (line = node->children.line; line != NULL;
@@ -6720,6 +6898,15 @@ gtk_text_btree_node_check_consistency (GtkTextBTree     *tree,
                   g_error ("gtk_text_btree_node_check_consistency: line ended with wrong type");
                 }
 
+              if (((segPtr->type == &gtk_text_toggle_on_type)
+                   || (segPtr->type == &gtk_text_toggle_off_type))
+                  && segPtr->body.toggle.inNodeCounts)
+                {
+                  num_toggles++;
+                  toggle_parity = toggle_parity_flip (toggle_parity,
+                                                      segPtr->body.toggle.info->index);
+                }
+
               num_chars += segPtr->char_count;
             }
 
@@ -6767,6 +6954,8 @@ gtk_text_btree_node_check_consistency (GtkTextBTree     *tree,
           num_children++;
           num_lines += childnode->num_lines;
           num_chars += childnode->num_chars;
+          num_toggles += childnode->num_toggles;
+          toggle_parity = toggle_parity_add (toggle_parity, childnode->toggle_parity);
         }
     }
   if (num_children != node->num_children)
@@ -6784,6 +6973,16 @@ gtk_text_btree_node_check_consistency (GtkTextBTree     *tree,
       g_error ("gtk_text_btree_node_check_consistency: mismatch in num_chars (%d %d)",
                num_chars, node->num_chars);
     }
+  if (num_toggles != node->num_toggles)
+    {
+      g_error ("gtk_text_btree_node_check_consistency: mismatch in num_toggles (%d %d)",
+               num_toggles, node->num_toggles);
+    }
+  if (!_gtk_bitmask_equals (toggle_parity, node->toggle_parity))
+    {
+      g_error ("gtk_text_btree_node_check_consistency: mismatch in toggle parity");
+    }
+  _gtk_bitmask_free (toggle_parity);
 
   for (summary = node->summary; summary != NULL;
        summary = summary->next)
@@ -7030,10 +7229,11 @@ _gtk_text_btree_check (GtkTextBTree *tree)
       g_error ("_gtk_text_btree_check: last line has wrong # characters: %d",
                seg->byte_count);
     }
-  if ((seg->body.chars[0] != '\n') || (seg->body.chars[1] != 0))
+  /* The segment may refer to external text, which is not nul-terminated */
+  if (_gtk_char_segment_get_chars (seg)[0] != '\n')
     {
-      g_error ("_gtk_text_btree_check: last line had bad value: %s",
-               seg->body.chars);
+      g_error ("_gtk_text_btree_check: last line had bad value: %.*s",
+               seg->byte_count, _gtk_char_segment_get_chars (seg));
     }
 }
 
@@ -7109,7 +7309,7 @@ _gtk_text_btree_spew_line_short (GtkTextLine *line, int indent)
     {
       if (seg->type == &gtk_text_char_type)
         {
-          char * str = g_strndup (seg->body.chars, MIN (seg->byte_count, 10));
+          char * str = g_strndup (_gtk_char_segment_get_chars (seg), MIN (seg->byte_count, 10));
           char * s;
           s = str;
           while (*s)
@@ -7225,7 +7425,7 @@ _gtk_text_btree_spew_segment (GtkTextBTree* tree, GtkTextLineSegment * seg)
 
   if (seg->type == &gtk_text_char_type)
     {
-      char * str = g_strndup (seg->body.chars, seg->byte_count);
+      char * str = g_strndup (_gtk_char_segment_get_chars (seg), seg->byte_count);
       printf ("       '%s'\n", str);
       g_free (str);
     }
@@ -43,6 +43,15 @@
 
 G_BEGIN_DECLS
 
+typedef struct _GtkTextLineSpan GtkTextLineSpan;
+
+/* A paragraph of text, including its delimiter */
+struct _GtkTextLineSpan
+{
+  int byte_count;
+  int char_count;
+};
+
 GtkTextBTree  *_gtk_text_btree_new        (GtkTextTagTable *table,
                                            GtkTextBuffer   *buffer);
 void           _gtk_text_btree_ref        (GtkTextBTree    *tree);
@@ -67,6 +76,10 @@ void _gtk_text_btree_delete           (GtkTextIter  *start,
 void _gtk_text_btree_insert           (GtkTextIter  *iter,
                                        const char   *text,
                                        int           len);
+void _gtk_text_btree_insert_spans     (GtkTextIter           *iter,
+                                       const char            *text,
+                                       const GtkTextLineSpan *spans,
+                                       guint                  n_spans);
 void _gtk_text_btree_insert_paintable (GtkTextIter  *iter,
                                        GdkPaintable *texture);
 
@@ -68,6 +68,13 @@ struct _GtkTextBufferPrivate
 
   GtkTextHistory *history;
 
+  /* The file that char segments may point into, see
+   * gtk_text_buffer_load_mapped_file_async()
+   */
+  GMappedFile *mapped_file;
+  /* The paragraphs of mapped_file while its text is being inserted */
+  GArray *mapped_spans;
+
   guint user_action_count;
 
   /* Whether the buffer has been modified since last save */
@@ -1096,6 +1103,9 @@ gtk_text_buffer_finalize (GObject *object)
       priv->btree = NULL;
     }
 
+  /* Only after the segments referring to it are gone */
+  g_clear_pointer (&priv->mapped_file, g_mapped_file_unref);
+
   if (priv->log_attr_cache)
     free_log_attr_cache (priv->log_attr_cache);
 
@@ -1180,6 +1190,226 @@ gtk_text_buffer_set_text (GtkTextBuffer *buffer,
   gtk_text_history_end_irreversible_action (buffer->priv->history);
 }
 
+typedef struct
+{
+  GMappedFile *file;
+  GArray *spans;
+} LoadMappedData;
+
+static void
+load_mapped_data_free (gpointer data)
+{
+  LoadMappedData *load = data;
+
+  g_mapped_file_unref (load->file);
+  g_clear_pointer (&load->spans, g_array_unref);
+  g_free (load);
+}
+
+/* Validates the text and splits it into paragraphs the same
+ * way _gtk_text_btree_insert() does, off the main thread.
+ */
+static void
+load_mapped_file_thread (GTask        *task,
+                         gpointer      source_object,
+                         gpointer      task_data,
+                         GCancellable *cancellable)
+{
+  LoadMappedData *load = task_data;
+  const char *text;
+  const char *invalid;
+  gsize len, sol;
+
+  text = g_mapped_file_get_contents (load->file);
+  len = g_mapped_file_get_length (load->file);
+
+  /* The text btree counts bytes and characters in ints */
+  if (len > G_MAXINT)
+    {
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_FILE_TOO_LARGE,
+                               "File is too large to be loaded into a text buffer");
+      return;
+    }
+
+  if (!g_utf8_validate_len (text, len, &invalid))
+    {
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                               "Invalid UTF-8 at byte %" G_GSIZE_FORMAT,
+                               (gsize) (invalid - text));
+      return;
+    }
+
+  if (memchr (text, '\0', len) != NULL)
+    {
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                               "Text contains nul bytes");
+      return;
+    }
+
+  load->spans = g_array_new (FALSE, FALSE, sizeof (GtkTextLineSpan));
+
+  for (sol = 0; sol < len; )
+    {
+      GtkTextLineSpan span;
+      int delim, eol;
+
+      if (load->spans->len % 4096 == 0 &&
+          g_task_return_error_if_cancelled (task))
+        return;
+
+      pango_find_paragraph_boundary (text + sol, len - sol, &delim, &eol);
+
+      span.byte_count = eol;
+      span.char_count = g_utf8_strlen (text + sol, eol);
+      g_array_append_val (load->spans, span);
+
+      sol += eol;
+    }
+
+  g_task_return_boolean (task, TRUE);
+}
+
+static void
+load_mapped_file_done (GObject      *source,
+                       GAsyncResult *result,
+                       gpointer      user_data)
+{
+  GtkTextBuffer *buffer = GTK_TEXT_BUFFER (source);
+  GtkTextBufferPrivate *priv = buffer->priv;
+  GTask *task = user_data;
+  LoadMappedData *load;
+  GtkTextIter start, end;
+  GError *error = NULL;
+
+  if (!g_task_propagate_boolean (G_TASK (result), &error))
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  load = g_task_get_task_data (G_TASK (result));
+
+  gtk_text_history_begin_irreversible_action (priv->history);
+
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  gtk_text_buffer_delete (buffer, &start, &end);
+
+  /* Nothing refers to the previous file anymore */
+  g_clear_pointer (&priv->mapped_file, g_mapped_file_unref);
+  priv->mapped_file = g_mapped_file_ref (load->file);
+
+  if (load->spans->len > 0)
+    {
+      /* Listeners see the text being inserted as usual. The default
+       * handler inserts it from the spans, without copying it. The
+       * text was validated in the thread already.
+       */
+      priv->mapped_spans = load->spans;
+      gtk_text_buffer_get_start_iter (buffer, &start);
+      g_signal_emit (buffer, signals[INSERT_TEXT], 0,
+                     &start,
+                     g_mapped_file_get_contents (load->file),
+                     (int) g_mapped_file_get_length (load->file));
+      priv->mapped_spans = NULL;
+    }
+
+  gtk_text_history_end_irreversible_action (priv->history);
+
+  g_task_return_boolean (task, TRUE);
+  g_object_unref (task);
+}
+
+/**
+ * gtk_text_buffer_load_mapped_file_async:
+ * @buffer: a `GtkTextBuffer`
+ * @file: a `GMappedFile` with UTF-8 text
+ * @cancellable: (nullable): a `GCancellable` to cancel the operation
+ * @callback: (scope async): a callback to call when the operation is complete
+ * @user_data: (closure callback): data to pass to @callback
+ *
+ * Replaces the contents of @buffer with the contents of @file.
+ *
+ * Unlike [method@Gtk.TextBuffer.set_text], the text is not copied
+ * into the buffer. The buffer keeps a reference on @file and refers
+ * to its memory directly. The text is validated and split into
+ * lines in a thread.
+ *
+ * This saves the copy of the text, not the cost of its lines. Once
+ * the thread is done, the buffer creates its structures for every
+ * line of the file on the main thread, so memory use and the time
+ * until the text shows still grow with the number of lines. Files
+ * larger than %G_MAXINT bytes can not be loaded.
+ *
+ * When the text is loaded, the current contents of @buffer are
+ * deleted and the new contents are inserted by emitting
+ * [signal@Gtk.TextBuffer::insert-text], like
+ * [method@Gtk.TextBuffer.set_text] does. Only the default handler
+ * of the signal avoids the copy, so handlers that insert the text
+ * themselves or change it copy it as usual. The load is marked as
+ * an irreversible action in the undo stack.
+ *
+ * The buffer stays editable. Text that is inserted later on is
+ * copied into the buffer as usual.
+ *
+ * Since: 4.16
+ */
+void
+gtk_text_buffer_load_mapped_file_async (GtkTextBuffer       *buffer,
+                                        GMappedFile         *file,
+                                        GCancellable        *cancellable,
+                                        GAsyncReadyCallback  callback,
+                                        gpointer             user_data)
+{
+  LoadMappedData *load;
+  GTask *task, *thread_task;
+
+  g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+  g_return_if_fail (file != NULL);
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  task = g_task_new (buffer, cancellable, callback, user_data);
+  g_task_set_source_tag (task, gtk_text_buffer_load_mapped_file_async);
+
+  load = g_new0 (LoadMappedData, 1);
+  load->file = g_mapped_file_ref (file);
+
+  thread_task = g_task_new (buffer, cancellable, load_mapped_file_done, task);
+  g_task_set_source_tag (thread_task, load_mapped_file_thread);
+  g_task_set_task_data (thread_task, load, load_mapped_data_free);
+  g_task_run_in_thread (thread_task, load_mapped_file_thread);
+  g_object_unref (thread_task);
+}
+
+/**
+ * gtk_text_buffer_load_mapped_file_finish:
+ * @buffer: a `GtkTextBuffer`
+ * @result: a `GAsyncResult`
+ * @error: return location for an error
+ *
+ * Finishes the [method@Gtk.TextBuffer.load_mapped_file_async] call.
+ *
+ * If the file is not valid UTF-8, @error is set to
+ * %G_IO_ERROR_INVALID_DATA, and if it is too large, to
+ * %G_IO_ERROR_FILE_TOO_LARGE. The contents of the buffer
+ * are left unchanged in both cases.
+ *
+ * Returns: %TRUE if the file was loaded
+ *
+ * Since: 4.16
+ */
+gboolean
+gtk_text_buffer_load_mapped_file_finish (GtkTextBuffer  *buffer,
+                                         GAsyncResult   *result,
+                                         GError        **error)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (g_task_is_valid (result, buffer), FALSE);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == gtk_text_buffer_load_mapped_file_async, FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
 /*
  * Insertion
  */
@@ -1193,12 +1423,24 @@ gtk_text_buffer_real_insert_text (GtkTextBuffer *buffer,
   g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
   g_return_if_fail (iter != NULL);
 
-  gtk_text_history_text_inserted (buffer->priv->history,
+  GtkTextBufferPrivate *priv = buffer->priv;
+
+  gtk_text_history_text_inserted (priv->history,
                                   gtk_text_iter_get_offset (iter),
                                   text,
                                   len);
 
-  _gtk_text_btree_insert (iter, text, len);
+  /* The text of a mapped file is not copied, the tree refers
+   * to the file directly. See gtk_text_buffer_load_mapped_file_async()
+   */
+  if (priv->mapped_spans != NULL &&
+      text == g_mapped_file_get_contents (priv->mapped_file) &&
+      (gsize) len == g_mapped_file_get_length (priv->mapped_file))
+    _gtk_text_btree_insert_spans (iter, text,
+                                  (GtkTextLineSpan *) priv->mapped_spans->data,
+                                  priv->mapped_spans->len);
+  else
+    _gtk_text_btree_insert (iter, text, len);
 
   g_signal_emit (buffer, signals[CHANGED], 0);
   g_object_notify_by_pspec (G_OBJECT (buffer), text_buffer_props[PROP_CURSOR_POSITION]);
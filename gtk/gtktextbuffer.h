@@ -157,6 +157,17 @@ void gtk_text_buffer_set_text          (GtkTextBuffer *buffer,
                                         const char    *text,
                                         int            len);
 
+GDK_AVAILABLE_IN_4_16
+void     gtk_text_buffer_load_mapped_file_async  (GtkTextBuffer       *buffer,
+                                                  GMappedFile         *file,
+                                                  GCancellable        *cancellable,
+                                                  GAsyncReadyCallback  callback,
+                                                  gpointer             user_data);
+GDK_AVAILABLE_IN_4_16
+gboolean gtk_text_buffer_load_mapped_file_finish (GtkTextBuffer       *buffer,
+                                                  GAsyncResult        *result,
+                                                  GError             **error);
+
 /* Insert into the buffer */
 GDK_AVAILABLE_IN_ALL
 void gtk_text_buffer_insert            (GtkTextBuffer *buffer,
@@ -288,7 +288,7 @@ iter_init_from_byte_offset (GtkTextIter *iter,
   iter_set_from_byte_offset (real, line, line_byte_offset);
 
   if (real->segment->type == &gtk_text_char_type &&
-      (real->segment->body.chars[real->segment_byte_offset] & 0xc0) == 0x80)
+      (_gtk_char_segment_get_chars (real->segment)[real->segment_byte_offset] & 0xc0) == 0x80)
     g_warning ("Incorrect line byte index %d falls in the middle of a UTF-8 "
                "character; this will crash the text buffer. "
                "Byte indexes must refer to the start of a character.",
@@ -884,7 +884,7 @@ gtk_text_iter_get_char (const GtkTextIter *iter)
     {
       ensure_byte_offsets (real);
 
-      return g_utf8_get_char (real->segment->body.chars +
+      return g_utf8_get_char (_gtk_char_segment_get_chars (real->segment) +
                               real->segment_byte_offset);
     }
   else if (real->segment->type == &gtk_text_child_type)
@@ -1938,7 +1938,7 @@ forward_char (GtkTextRealIter *real)
         {
           int bytes;
           const char * start =
-            real->segment->body.chars + real->segment_byte_offset;
+            _gtk_char_segment_get_chars (real->segment) + real->segment_byte_offset;
 
           bytes = g_utf8_next_char (start) - start;
 
@@ -2425,13 +2425,13 @@ gtk_text_iter_backward_chars (GtkTextIter *iter, int count)
 
           /* if in the last fourth of the segment walk backwards */
           if (count < real->segment_char_offset / 4)
-            p = g_utf8_offset_to_pointer (real->segment->body.chars + real->segment_byte_offset,
+            p = g_utf8_offset_to_pointer (_gtk_char_segment_get_chars (real->segment) + real->segment_byte_offset,
                                           -count);
           else
-            p = g_utf8_offset_to_pointer (real->segment->body.chars,
+            p = g_utf8_offset_to_pointer (_gtk_char_segment_get_chars (real->segment),
                                           real->segment_char_offset - count);
 
-          new_byte_offset = p - real->segment->body.chars;
+          new_byte_offset = p - _gtk_char_segment_get_chars (real->segment);
           real->line_byte_offset -= (real->segment_byte_offset - new_byte_offset);
           real->segment_byte_offset = new_byte_offset;
         }
@@ -3924,7 +3924,7 @@ gtk_text_iter_set_line_index (GtkTextIter *iter,
     gtk_text_iter_forward_line (iter);
 
   if (real->segment->type == &gtk_text_char_type &&
-      (real->segment->body.chars[real->segment_byte_offset] & 0xc0) == 0x80)
+      (_gtk_char_segment_get_chars (real->segment)[real->segment_byte_offset] & 0xc0) == 0x80)
     g_warning ("%s: Incorrect byte offset %d falls in the middle of a UTF-8 "
                "character; this will crash the text buffer. "
                "Byte indexes must refer to the start of a character.",
@@ -5928,7 +5928,7 @@ _gtk_text_iter_check (const GtkTextIter *iter)
           if (byte_segment->type == &gtk_text_char_type)
             {
               const char *p;
-              p = byte_segment->body.chars + seg_byte_offset;
+              p = _gtk_char_segment_get_chars (byte_segment) + seg_byte_offset;
 
               if (!gtk_text_byte_begins_utf8_char (p))
                 g_error ("broken iterator byte index pointed into the middle of a character");
@@ -5959,7 +5959,7 @@ _gtk_text_iter_check (const GtkTextIter *iter)
           if (char_segment->type == &gtk_text_char_type)
             {
               const char *p;
-              p = g_utf8_offset_to_pointer (char_segment->body.chars,
+              p = g_utf8_offset_to_pointer (_gtk_char_segment_get_chars (char_segment),
                                             seg_char_offset);
 
               /* hmm, not likely to happen eh */
@@ -5985,7 +5985,7 @@ _gtk_text_iter_check (const GtkTextIter *iter)
           int char_offset = 0;
           while (char_offset < seg_char_offset)
             {
-              const char * start = char_segment->body.chars + byte_offset;
+              const char * start = _gtk_char_segment_get_chars (char_segment) + byte_offset;
               byte_offset += g_utf8_next_char (start) - start;
               char_offset += 1;
             }
@@ -5994,12 +5994,12 @@ _gtk_text_iter_check (const GtkTextIter *iter)
             g_error ("byte offset did not correspond to char offset");
 
           char_offset =
-            g_utf8_strlen (char_segment->body.chars, seg_byte_offset);
+            g_utf8_strlen (_gtk_char_segment_get_chars (char_segment), seg_byte_offset);
 
           if (char_offset != seg_char_offset)
             g_error ("char offset did not correspond to byte offset");
 
-          if (!gtk_text_byte_begins_utf8_char (char_segment->body.chars + seg_byte_offset))
+          if (!gtk_text_byte_begins_utf8_char (_gtk_char_segment_get_chars (char_segment) + seg_byte_offset))
             g_error ("byte index for iterator does not index the start of a character");
         }
     }
@@ -124,6 +124,7 @@ static void gtk_text_layout_emit_changed           (GtkTextLayout     *layout,
 						    int                new_height);
 
 static void gtk_text_layout_invalidate_all (GtkTextLayout *layout);
+static void gtk_text_layout_invalidate_wraps (GtkTextLayout *layout);
 
 static PangoAttribute *gtk_text_attr_appearance_new (const GtkTextAppearance *appearance);
 
@@ -522,8 +523,12 @@ gtk_text_layout_set_screen_width (GtkTextLayout *layout, int width)
 
   layout->screen_width = width;
 
-  DV (g_print ("invalidating all due to new screen width (%s)\n", G_STRLOC));
-  gtk_text_layout_invalidate_all (layout);
+  /* The text and attributes of a paragraph don't depend on the screen
+   * width, so keep the cached displays around and let the display cache
+   * re-layout copies of them on demand instead of rebuilding them.
+   */
+  DV (g_print ("invalidating wraps due to new screen width (%s)\n", G_STRLOC));
+  gtk_text_layout_invalidate_wraps (layout);
 }
 
 /**
@@ -724,6 +729,38 @@ gtk_text_layout_invalidate_all (GtkTextLayout *layout)
   gtk_text_layout_invalidate (layout, &start, &end);
 }
 
+static void
+gtk_text_layout_invalidate_wraps (GtkTextLayout *layout)
+{
+  GtkTextIter start;
+  GtkTextIter end;
+  GtkTextLine *line;
+  GtkTextLine *last_line;
+
+  if (layout->buffer == NULL)
+    return;
+
+  gtk_text_buffer_get_bounds (layout->buffer, &start, &end);
+
+  line = _gtk_text_iter_get_text_line (&start);
+  last_line = _gtk_text_iter_get_text_line (&end);
+
+  while (TRUE)
+    {
+      GtkTextLineData *line_data = _gtk_text_line_get_data (line, layout);
+
+      if (line_data)
+        _gtk_text_line_invalidate_wrap (line, line_data);
+
+      if (line == last_line)
+        break;
+
+      line = _gtk_text_line_next_excluding_last (line);
+    }
+
+  gtk_text_layout_invalidated (layout);
+}
+
 static void
 gtk_text_layout_invalidate_cache (GtkTextLayout *layout,
                                   GtkTextLine   *line,
@@ -1303,7 +1340,9 @@ set_para_values (GtkTextLayout      *layout,
   h_margin = display->left_margin + display->right_margin;
   h_padding = layout->left_padding + layout->right_padding;
 
-  if (style->wrap_mode != GTK_WRAP_NONE)
+  display->wrapped = style->wrap_mode != GTK_WRAP_NONE;
+
+  if (display->wrapped)
     {
       int layout_width = (layout->screen_width - h_margin - h_padding);
       pango_layout_set_width (display->layout, layout_width * PANGO_SCALE);
@@ -2275,6 +2314,105 @@ tags_array_toggle_tag (GPtrArray  *array,
   return array;
 }
 
+static void
+update_display_extents (GtkTextLayout      *layout,
+                        GtkTextLineDisplay *display)
+{
+  PangoRectangle extents;
+  int text_pixel_width;
+  int h_margin;
+  int h_padding;
+
+  pango_layout_get_extents (display->layout, NULL, &extents);
+
+  text_pixel_width = PIXEL_BOUND (extents.width);
+
+  h_margin = display->left_margin + display->right_margin;
+  h_padding = layout->left_padding + layout->right_padding;
+
+  display->width = text_pixel_width + h_margin + h_padding;
+  display->height = display->top_margin + display->bottom_margin + PANGO_PIXELS (extents.height);
+  display->x_offset = display->left_margin;
+
+  /* If we aren't wrapping, we need to do the alignment of each
+   * paragraph ourselves.
+   */
+  if (pango_layout_get_width (display->layout) < 0)
+    {
+      int excess = display->total_width - text_pixel_width;
+
+      switch (pango_layout_get_alignment (display->layout))
+        {
+        case PANGO_ALIGN_LEFT:
+        default:
+          break;
+        case PANGO_ALIGN_CENTER:
+          display->x_offset += excess / 2;
+          break;
+        case PANGO_ALIGN_RIGHT:
+          display->x_offset += excess;
+          break;
+        }
+    }
+}
+
+/*
+ * gtk_text_layout_rewrap_display:
+ * @layout: a `GtkTextLayout`
+ * @display: a `GtkTextLineDisplay` created by @layout
+ *
+ * Creates a copy of @display for the current screen width of @layout.
+ *
+ * The copy keeps the text, attributes and paragraph settings of @display,
+ * which do not depend on the screen width, so walking the btree segments
+ * and resolving the tag styles of the paragraph is skipped. Pango still
+ * shapes and breaks the paragraph again for the new width.
+ *
+ * @display itself is not modified, since others may still hold it.
+ *
+ * Returns: (transfer full) (nullable): the new display, or %NULL if
+ *   @display can not be reused and must be recreated
+ */
+GtkTextLineDisplay *
+gtk_text_layout_rewrap_display (GtkTextLayout      *layout,
+                                GtkTextLineDisplay *display)
+{
+  GtkTextLineDisplay *copy;
+  int h_margin;
+  int h_padding;
+
+  /* The block cursor rectangle is computed from the line breaks */
+  if (display->has_block_cursor)
+    return NULL;
+
+  copy = g_rc_box_dup (sizeof (GtkTextLineDisplay), display);
+  copy->cache_iter = NULL;
+  copy->mru_link.data = copy;
+  copy->mru_link.prev = NULL;
+  copy->mru_link.next = NULL;
+  copy->node = NULL;
+  copy->layout = display->layout ? pango_layout_copy (display->layout) : NULL;
+  copy->cursors = display->cursors ? g_array_copy (display->cursors) : NULL;
+  copy->screen_width = layout->screen_width;
+
+  if (copy->totally_invisible)
+    return copy;
+
+  h_margin = copy->left_margin + copy->right_margin;
+  h_padding = layout->left_padding + layout->right_padding;
+
+  if (copy->wrapped)
+    {
+      int layout_width = (layout->screen_width - h_margin - h_padding);
+      pango_layout_set_width (copy->layout, layout_width * PANGO_SCALE);
+    }
+  copy->total_width = MAX (layout->screen_width, layout->width) - h_margin - h_padding;
+
+  update_display_extents (layout, copy);
+
+  return copy;
+}
+
 GtkTextLineDisplay *
 gtk_text_layout_create_display (GtkTextLayout *layout,
                                 GtkTextLine   *line,
@@ -2286,10 +2424,8 @@ gtk_text_layout_create_display (GtkTextLayout *layout,
   GtkTextIter iter;
   GtkTextAttributes *style;
   char *text;
-  int text_pixel_width;
   PangoAttrList *attrs;
   int text_allocated, layout_byte_offset;
-  PangoRectangle extents;
   gboolean para_values_set = FALSE;
   GSList *cursor_byte_offsets = NULL;
   GSList *cursor_segs = NULL;
@@ -2298,8 +2434,6 @@ gtk_text_layout_create_display (GtkTextLayout *layout,
   PangoDirection base_dir;
   GPtrArray *tags;
   gboolean initial_toggle_segments;
-  int h_margin;
-  int h_padding;
   PangoAttribute *last_font_attr = NULL;
   PangoAttribute *last_scale_attr = NULL;
   PangoAttribute *last_fallback_attr = NULL;
@@ -2313,6 +2447,7 @@ gtk_text_layout_create_display (GtkTextLayout *layout,
   display->size_only = !!size_only;
   display->line = line;
   display->insert_index = -1;
+  display->screen_width = layout->screen_width;
 
   /* Special-case optimization for completely
    * invisible lines; makes it faster to deal
@@ -2321,6 +2456,7 @@ gtk_text_layout_create_display (GtkTextLayout *layout,
   if (totally_invisible_line (layout, line, &iter))
     {
       display->layout = pango_layout_new (layout->ltr_context);
+      display->totally_invisible = TRUE;
       return g_steal_pointer (&display);
     }
 
@@ -2394,7 +2530,7 @@ gtk_text_layout_create_display (GtkTextLayout *layout,
                     {
                       if (seg->type == &gtk_text_char_type)
                         {
-                          memcpy (text + layout_byte_offset, seg->body.chars, seg->byte_count);
+                          memcpy (text + layout_byte_offset, _gtk_char_segment_get_chars (seg), seg->byte_count);
                           layout_byte_offset += seg->byte_count;
                           bytes += seg->byte_count;
                         }
@@ -2580,36 +2716,7 @@ gtk_text_layout_create_display (GtkTextLayout *layout,
   g_slist_free (cursor_byte_offsets);
   g_slist_free (cursor_segs);
 
-  pango_layout_get_extents (display->layout, NULL, &extents);
-
-  text_pixel_width = PIXEL_BOUND (extents.width);
-
-  h_margin = display->left_margin + display->right_margin;
-  h_padding = layout->left_padding + layout->right_padding;
-
-  display->width = text_pixel_width + h_margin + h_padding;
-  display->height += PANGO_PIXELS (extents.height);
-
-  /* If we aren't wrapping, we need to do the alignment of each
-   * paragraph ourselves.
-   */
-  if (pango_layout_get_width (display->layout) < 0)
-    {
-      int excess = display->total_width - text_pixel_width;
-
-      switch (pango_layout_get_alignment (display->layout))
-        {
-        case PANGO_ALIGN_LEFT:
-        default:
-          break;
-        case PANGO_ALIGN_CENTER:
-          display->x_offset += excess / 2;
-          break;
-        case PANGO_ALIGN_RIGHT:
-          display->x_offset += excess;
-          break;
-        }
-    }
+  update_display_extents (layout, display);
 
   /* Free this if we aren't in a loop */
   if (layout->wrap_loop_count == 0)
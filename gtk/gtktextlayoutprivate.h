@@ -201,6 +201,7 @@ struct _GtkTextLineDisplay
   int top_margin;
   int bottom_margin;
   int insert_index;		/* Byte index of insert cursor within para or -1 */
+  int screen_width;             /* Screen width the paragraph was broken for */
 
   GtkTextLine *line;
 
@@ -212,6 +213,8 @@ struct _GtkTextLineDisplay
   guint size_only : 1;
   guint pg_bg_rgba_set : 1;
   guint has_children : 1;
+  guint wrapped : 1;
+  guint totally_invisible : 1;
 
   GdkRGBA pg_bg_rgba;
 };
@@ -329,6 +332,9 @@ void     gtk_text_layout_update_display_cursors (GtkTextLayout      *layout,
                                                  GtkTextLineDisplay *display);
 void     gtk_text_layout_update_children        (GtkTextLayout      *layout,
                                                  GtkTextLineDisplay *display);
+GtkTextLineDisplay *
+         gtk_text_layout_rewrap_display         (GtkTextLayout      *layout,
+                                                 GtkTextLineDisplay *display);
 gboolean _gtk_text_layout_get_block_cursor    (GtkTextLayout     *layout,
 					       GdkRectangle      *pos);
 gboolean gtk_text_layout_clamp_iter_to_vrange (GtkTextLayout     *layout,
@@ -42,6 +42,7 @@ struct _GtkTextLineDisplayCache
   guint       log_source;
   int         hits;
   int         misses;
+  int         rewraps;
   int         inval;
   int         inval_cursors;
   int         inval_by_line;
@@ -60,11 +61,11 @@ static gboolean
 dump_stats (gpointer data)
 {
   GtkTextLineDisplayCache *cache = data;
-  g_printerr ("%p: size=%u hits=%d misses=%d inval_total=%d "
+  g_printerr ("%p: size=%u hits=%d misses=%d rewraps=%d inval_total=%d "
               "inval_cursors=%d inval_by_line=%d "
               "inval_by_range=%d inval_by_y_range=%d\n",
               cache, g_hash_table_size (cache->line_to_display),
-              cache->hits, cache->misses,
+              cache->hits, cache->misses, cache->rewraps,
               cache->inval, cache->inval_cursors,
               cache->inval_by_line, cache->inval_by_range,
               cache->inval_by_y_range);
@@ -241,6 +242,40 @@ purge_text_line_display_in_idle (gpointer data)
   return G_SOURCE_CONTINUE;
 }
 
+static void
+gtk_text_line_display_cache_remove_display (GtkTextLineDisplayCache *cache,
+                                            GtkTextLineDisplay      *display)
+{
+  GSequenceIter *iter = g_steal_pointer (&display->cache_iter);
+
+  g_hash_table_remove (cache->line_to_display, display->line);
+  g_queue_unlink (&cache->mru, &display->mru_link);
+
+  if (iter != NULL)
+    {
+      g_sequence_remove (iter);
+
+      g_queue_push_head_link (&purge_in_idle, &display->mru_link);
+
+      /* Purging a lot of GtkTextLineDisplay while processing a frame
+       * can increase the chances that we miss our frame deadline. Instead
+       * defer that work to right after the frame has completed. This can
+       * help situations where we have large, zoomed out TextView like
+       * those used in an overview map.
+       */
+      if G_UNLIKELY (purge_in_idle_source == 0)
+        {
+          GSource *source;
+
+          purge_in_idle_source = g_idle_add_full (G_PRIORITY_LOW,
+                                                  purge_text_line_display_in_idle,
+                                                  NULL, NULL);
+          source = g_main_context_find_source_by_id (NULL, purge_in_idle_source);
+          g_source_set_static_name (source, "[gtk+ line-display-cache-gc]");
+        }
+    }
+}
+
 /*
  * gtk_text_line_display_cache_invalidate_display:
  * @cache: a GtkTextLineDisplayCache
@@ -271,37 +306,10 @@ gtk_text_line_display_cache_invalidate_display (GtkTextLineDisplayCache *cache,
     }
   else
     {
-      GSequenceIter *iter = g_steal_pointer (&display->cache_iter);
-
       if (cache->cursor_line == display->line)
         cache->cursor_line = NULL;
 
-      g_hash_table_remove (cache->line_to_display, display->line);
-      g_queue_unlink (&cache->mru, &display->mru_link);
-
-      if (iter != NULL)
-        {
-          g_sequence_remove (iter);
-
-          g_queue_push_head_link (&purge_in_idle, &display->mru_link);
-
-          /* Purging a lot of GtkTextLineDisplay while processing a frame
-           * can increase the chances that we miss our frame deadline. Instead
-           * defer that work to right after the frame has completed. This can
-           * help situations where we have large, zoomed out TextView like
-           * those used in an overview map.
-           */
-          if G_UNLIKELY (purge_in_idle_source == 0)
-            {
-              GSource *source;
-
-              purge_in_idle_source = g_idle_add_full (G_PRIORITY_LOW,
-                                                      purge_text_line_display_in_idle,
-                                                      NULL, NULL);
-              source = g_main_context_find_source_by_id (NULL, purge_in_idle_source);
-              g_source_set_static_name (source, "[gtk+ line-display-cache-gc]");
-            }
-        }
+      gtk_text_line_display_cache_remove_display (cache, display);
     }
 
   STAT_INC (cache->inval);
@@ -339,7 +347,8 @@ gtk_text_line_display_cache_get (GtkTextLineDisplayCache *cache,
 
   if (display != NULL)
     {
-      if (size_only || !display->size_only)
+      if ((size_only || !display->size_only) &&
+          display->screen_width == layout->screen_width)
         {
           STAT_INC (cache->hits);
 
@@ -356,9 +365,40 @@ gtk_text_line_display_cache_get (GtkTextLineDisplayCache *cache,
           return gtk_text_line_display_ref (display);
         }
 
+      /* Displays survive screen width changes. The text and attributes
+       * of the paragraph are reused and only Pango's shaping and line
+       * breaking are redone, in a copy, since the old display may still
+       * be held elsewhere.
+       */
+      if (size_only || !display->size_only)
+        {
+          GtkTextLineDisplay *rewrapped;
+
+          rewrapped = gtk_text_layout_rewrap_display (layout, display);
+          if (rewrapped != NULL)
+            {
+              STAT_INC (cache->rewraps);
+
+              /* The line stays the cursor line, so only drop the entry */
+              gtk_text_line_display_cache_remove_display (cache, display);
+
+              if (!size_only && line == cache->cursor_line)
+                gtk_text_layout_update_display_cursors (layout, line, rewrapped);
+
+              if (!size_only && rewrapped->has_children)
+                gtk_text_layout_update_children (layout, rewrapped);
+
+              gtk_text_line_display_cache_take_display (cache,
+                                                        gtk_text_line_display_ref (rewrapped),
+                                                        layout);
+
+              return rewrapped;
+            }
+        }
+
       /* We need an updated display that includes more than just
-       * sizing, so we need to drop this entry and force the layout
-       * to create a new one.
+       * sizing, or one that can't be re-broken, so we need to drop
+       * this entry and force the layout to create a new one.
        */
       gtk_text_line_display_cache_invalidate_display (cache, display, FALSE);
     }
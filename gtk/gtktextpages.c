@@ -0,0 +1,365 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtktextpagesprivate.h"
+
+#include <string.h>
+
+/* Assistive technologies may ask for the whole contents of a text
+ * view, which means converting all of the buffer to a string on every
+ * call. To avoid redoing that work, the text is gathered from pages of
+ * a fixed number of lines that are cached on the buffer until they
+ * are changed.
+ *
+ * The cache is limited by the size of the text it holds rather than
+ * by the number of pages, so that reading all of a big buffer again
+ * finds its pages instead of evicting them one by one.
+ */
+
+#define LINES_PER_PAGE 128
+#define MAX_CACHED_BYTES (32 << 20)
+
+typedef struct
+{
+  int index;
+  char *text;
+  gsize len;
+  GList lru_link;
+} TextPage;
+
+typedef struct
+{
+  GtkTextBuffer *buffer;
+  GtkTextTagTable *table;
+  GHashTable *pages;
+  GQueue lru;
+  gsize n_bytes;
+  guint n_hits;
+  guint n_misses;
+} TextPages;
+
+static GQuark text_pages_quark;
+
+static void
+text_page_free (gpointer data)
+{
+  TextPage *page = data;
+
+  g_free (page->text);
+  g_free (page);
+}
+
+static void
+text_pages_remove (TextPages *pages,
+                   TextPage  *page)
+{
+  g_queue_unlink (&pages->lru, &page->lru_link);
+  pages->n_bytes -= page->len;
+  g_hash_table_remove (pages->pages, GINT_TO_POINTER (page->index));
+}
+
+static void
+text_pages_drop (TextPages *pages,
+                 int        first,
+                 int        last)
+{
+  GList *l, *next;
+
+  if (last - first < g_hash_table_size (pages->pages))
+    {
+      for (int i = first; i <= last; i++)
+        {
+          TextPage *page = g_hash_table_lookup (pages->pages, GINT_TO_POINTER (i));
+          if (page)
+            text_pages_remove (pages, page);
+        }
+      return;
+    }
+
+  for (l = pages->lru.head; l; l = next)
+    {
+      TextPage *page = l->data;
+
+      next = l->next;
+      if (page->index >= first && page->index <= last)
+        text_pages_remove (pages, page);
+    }
+}
+
+/* Drops the pages covering the lines from @start to @end, and all
+ * following pages if the number of lines changes.
+ */
+static void
+text_pages_invalidate (TextPages         *pages,
+                       const GtkTextIter *start,
+                       const GtkTextIter *end,
+                       gboolean           lines_changed)
+{
+  int first, last;
+
+  first = gtk_text_iter_get_line (start) / LINES_PER_PAGE;
+  if (lines_changed)
+    last = G_MAXINT;
+  else
+    last = gtk_text_iter_get_line (end) / LINES_PER_PAGE;
+
+  text_pages_drop (pages, first, last);
+}
+
+static void
+text_pages_insert_text (GtkTextBuffer *buffer,
+                        GtkTextIter   *iter,
+                        const char    *text,
+                        int            len,
+                        TextPages     *pages)
+{
+  int delim, eol;
+
+  pango_find_paragraph_boundary (text, len, &delim, &eol);
+  text_pages_invalidate (pages, iter, iter, delim < len);
+}
+
+/* Embedded objects are left out of the text, but they move the
+ * offsets of the text after them
+ */
+static void
+text_pages_insert_object (GtkTextBuffer *buffer,
+                          GtkTextIter   *iter,
+                          gpointer       object,
+                          TextPages     *pages)
+{
+  text_pages_invalidate (pages, iter, iter, FALSE);
+}
+
+static void
+text_pages_delete_range (GtkTextBuffer *buffer,
+                         GtkTextIter   *start,
+                         GtkTextIter   *end,
+                         TextPages     *pages)
+{
+  text_pages_invalidate (pages, start, end,
+                         gtk_text_iter_get_line (start) != gtk_text_iter_get_line (end));
+}
+
+/* Invisible text is left out of the pages */
+static void
+text_pages_tag_applied (GtkTextBuffer *buffer,
+                        GtkTextTag    *tag,
+                        GtkTextIter   *start,
+                        GtkTextIter   *end,
+                        TextPages     *pages)
+{
+  text_pages_invalidate (pages, start, end, FALSE);
+}
+
+/* A tag that becomes invisible or visible changes the text of all
+ * the ranges it is applied to. That is a size change.
+ */
+static void
+text_pages_tag_changed (GtkTextTagTable *table,
+                        GtkTextTag      *tag,
+                        gboolean         size_changed,
+                        TextPages       *pages)
+{
+  if (size_changed)
+    text_pages_drop (pages, 0, G_MAXINT);
+}
+
+static void
+text_pages_free (gpointer data)
+{
+  TextPages *pages = data;
+
+  g_signal_handlers_disconnect_by_data (pages->buffer, pages);
+  g_signal_handlers_disconnect_by_data (pages->table, pages);
+  g_object_unref (pages->table);
+  g_hash_table_unref (pages->pages);
+  g_free (pages);
+}
+
+static TextPages *
+text_pages_get (GtkTextBuffer *buffer)
+{
+  TextPages *pages;
+
+  if (G_UNLIKELY (text_pages_quark == 0))
+    text_pages_quark = g_quark_from_static_string ("gtk-text-pages");
+
+  pages = g_object_get_qdata (G_OBJECT (buffer), text_pages_quark);
+  if (pages)
+    return pages;
+
+  pages = g_new0 (TextPages, 1);
+  pages->buffer = buffer;
+  pages->table = g_object_ref (gtk_text_buffer_get_tag_table (buffer));
+  pages->pages = g_hash_table_new_full (NULL, NULL, NULL, text_page_free);
+
+  g_signal_connect (buffer, "insert-text", G_CALLBACK (text_pages_insert_text), pages);
+  g_signal_connect (buffer, "insert-paintable", G_CALLBACK (text_pages_insert_object), pages);
+  g_signal_connect (buffer, "insert-child-anchor", G_CALLBACK (text_pages_insert_object), pages);
+  g_signal_connect (buffer, "delete-range", G_CALLBACK (text_pages_delete_range), pages);
+  g_signal_connect (buffer, "apply-tag", G_CALLBACK (text_pages_tag_applied), pages);
+  g_signal_connect (buffer, "remove-tag", G_CALLBACK (text_pages_tag_applied), pages);
+  g_signal_connect (pages->table, "tag-changed", G_CALLBACK (text_pages_tag_changed), pages);
+
+  g_object_set_qdata_full (G_OBJECT (buffer), text_pages_quark, pages, text_pages_free);
+
+  return pages;
+}
+
+static void
+get_page_bounds (GtkTextBuffer *buffer,
+                 int            index,
+                 GtkTextIter   *start,
+                 GtkTextIter   *end)
+{
+  gtk_text_buffer_get_iter_at_line (buffer, start, index * LINES_PER_PAGE);
+  if (!gtk_text_buffer_get_iter_at_line (buffer, end, (index + 1) * LINES_PER_PAGE))
+    gtk_text_buffer_get_end_iter (buffer, end);
+}
+
+static TextPage *
+text_pages_lookup (TextPages *pages,
+                   int        index)
+{
+  TextPage *page;
+  GtkTextIter start, end;
+
+  page = g_hash_table_lookup (pages->pages, GINT_TO_POINTER (index));
+  if (page)
+    {
+      pages->n_hits++;
+      g_queue_unlink (&pages->lru, &page->lru_link);
+      g_queue_push_head_link (&pages->lru, &page->lru_link);
+      return page;
+    }
+
+  pages->n_misses++;
+
+  page = g_new0 (TextPage, 1);
+  page->index = index;
+  page->lru_link.data = page;
+
+  get_page_bounds (pages->buffer, index, &start, &end);
+  page->text = gtk_text_buffer_get_text (pages->buffer, &start, &end, FALSE);
+  page->len = strlen (page->text);
+
+  g_hash_table_insert (pages->pages, GINT_TO_POINTER (index), page);
+  g_queue_push_head_link (&pages->lru, &page->lru_link);
+  pages->n_bytes += page->len;
+
+  while (pages->n_bytes > MAX_CACHED_BYTES && pages->lru.length > 1)
+    text_pages_remove (pages, g_queue_peek_tail (&pages->lru));
+
+  return page;
+}
+
+/*< private >
+ * gtk_text_pages_get_text:
+ * @buffer: a `GtkTextBuffer`
+ * @start: start of the range
+ * @end: end of the range
+ *
+ * Gets the visible text between @start and @end, like
+ * gtk_text_buffer_get_text() does, reusing the text of
+ * earlier calls for the parts of @buffer that did not change.
+ *
+ * Returns: (transfer full): the text, including its
+ *   terminating nul byte
+ */
+GBytes *
+gtk_text_pages_get_text (GtkTextBuffer     *buffer,
+                         const GtkTextIter *start,
+                         const GtkTextIter *end)
+{
+  TextPages *pages;
+  GString *string;
+  gsize len;
+  int index, last;
+
+  if (gtk_text_iter_compare (start, end) >= 0)
+    return g_bytes_new_static ("", 1);
+
+  index = gtk_text_iter_get_line (start) / LINES_PER_PAGE;
+  last = gtk_text_iter_get_line (end) / LINES_PER_PAGE;
+
+  /* Small ranges are not worth caching */
+  if (index == last)
+    {
+      char *text = gtk_text_buffer_get_text (buffer, start, end, FALSE);
+
+      return g_bytes_new_take (text, strlen (text) + 1);
+    }
+
+  pages = text_pages_get (buffer);
+  string = g_string_new (NULL);
+
+  for (; index <= last; index++)
+    {
+      GtkTextIter page_start, page_end;
+
+      get_page_bounds (buffer, index, &page_start, &page_end);
+
+      if (gtk_text_iter_compare (start, &page_start) <= 0 &&
+          gtk_text_iter_compare (&page_end, end) <= 0)
+        {
+          TextPage *page = text_pages_lookup (pages, index);
+
+          g_string_append_len (string, page->text, page->len);
+        }
+      else
+        {
+          char *text;
+
+          if (gtk_text_iter_compare (start, &page_start) > 0)
+            page_start = *start;
+          if (gtk_text_iter_compare (&page_end, end) > 0)
+            page_end = *end;
+
+          text = gtk_text_buffer_get_text (buffer, &page_start, &page_end, FALSE);
+          g_string_append (string, text);
+          g_free (text);
+        }
+    }
+
+  len = string->len + 1;
+
+  return g_bytes_new_take (g_string_free (string, FALSE), len);
+}
+
+/*< private >
+ * gtk_text_pages_get_stats:
+ * @buffer: a `GtkTextBuffer`
+ * @n_hits: (out): return location for the number of pages that were
+ *   found in the cache
+ * @n_misses: (out): return location for the number of pages that had
+ *   to be created
+ *
+ * Gets statistics about the text pages of @buffer, for tests.
+ */
+void
+gtk_text_pages_get_stats (GtkTextBuffer *buffer,
+                          guint         *n_hits,
+                          guint         *n_misses)
+{
+  TextPages *pages = text_pages_get (buffer);
+
+  *n_hits = pages->n_hits;
+  *n_misses = pages->n_misses;
+}
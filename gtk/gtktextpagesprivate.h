@@ -0,0 +1,31 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gtktextbuffer.h"
+
+G_BEGIN_DECLS
+
+GBytes *gtk_text_pages_get_text  (GtkTextBuffer     *buffer,
+                                  const GtkTextIter *start,
+                                  const GtkTextIter *end);
+void    gtk_text_pages_get_stats (GtkTextBuffer     *buffer,
+                                  guint             *n_hits,
+                                  guint             *n_misses);
+
+G_END_DECLS
@@ -154,6 +154,9 @@ gtk_text_line_segment_split (const GtkTextIter *iter)
 
 #define CSEG_SIZE(chars) ((unsigned) (G_STRUCT_OFFSET (GtkTextLineSegment, body) \
         + 1 + (chars)))
+#define CSEG_EXTERNAL_SIZE ((unsigned) (G_STRUCT_OFFSET (GtkTextLineSegment, body) \
+        + sizeof (GtkTextExternalChars)))
+#define CSEG_IS_EXTERNAL(seg) ((seg)->body.chars[0] == '\0')
 #define TSEG_SIZE ((unsigned) (G_STRUCT_OFFSET (GtkTextLineSegment, body) \
         + sizeof (GtkTextToggleBody)))
 
@@ -175,12 +178,17 @@ char_segment_self_check (GtkTextLineSegment *seg)
       g_error ("segment has size <= 0");
     }
 
-  if (strlen (seg->body.chars) != seg->byte_count)
+  if (CSEG_IS_EXTERNAL (seg))
+    {
+      if (memchr (seg->body.external.text, '\0', seg->byte_count) != NULL)
+        g_error ("external segment contains nul bytes");
+    }
+  else if (strlen (seg->body.chars) != seg->byte_count)
     {
       g_error ("segment has wrong size");
     }
 
-  if (g_utf8_strlen (seg->body.chars, seg->byte_count) != seg->char_count)
+  if (g_utf8_strlen (_gtk_char_segment_get_chars (seg), seg->byte_count) != seg->char_count)
     {
       g_error ("char segment has wrong character count");
     }
@@ -208,6 +216,41 @@ _gtk_char_segment_new (const char *text, guint len)
   return seg;
 }
 
+/*
+ * _gtk_char_segment_new_external:
+ * @text: valid UTF-8 text without nul bytes
+ * @len: length of @text in bytes
+ * @chars: number of characters in @text
+ *
+ * Creates a char segment that refers to @text instead of
+ * copying it. The caller must keep @text around for as long
+ * as the segment, or any segment split off from it, exists.
+ *
+ * Returns: a new char segment
+ */
+GtkTextLineSegment*
+_gtk_char_segment_new_external (const char *text,
+                                guint       len,
+                                guint       chars)
+{
+  GtkTextLineSegment *seg;
+
+  g_assert (gtk_text_byte_begins_utf8_char (text));
+
+  seg = g_malloc (CSEG_EXTERNAL_SIZE);
+  seg->type = &gtk_text_char_type;
+  seg->next = NULL;
+  seg->byte_count = len;
+  seg->char_count = chars;
+  seg->body.external.nul = '\0';
+  seg->body.external.text = text;
+
+  if (GTK_DEBUG_CHECK (TEXT))
+    char_segment_self_check (seg);
+
+  return seg;
+}
+
 GtkTextLineSegment*
 _gtk_char_segment_new_from_two_strings (const char *text1, 
 					guint        len1, 
@@ -278,11 +321,24 @@ char_segment_split_func (GtkTextLineSegment *seg, int index)
       char_segment_self_check (seg);
     }
 
-  new1 = _gtk_char_segment_new (seg->body.chars, index);
-  new2 = _gtk_char_segment_new (seg->body.chars + index, seg->byte_count - index);
+  if (CSEG_IS_EXTERNAL (seg))
+    {
+      const char *text = seg->body.external.text;
+      int chars1 = g_utf8_strlen (text, index);
 
-  g_assert (gtk_text_byte_begins_utf8_char (new1->body.chars));
-  g_assert (gtk_text_byte_begins_utf8_char (new2->body.chars));
+      new1 = _gtk_char_segment_new_external (text, index, chars1);
+      new2 = _gtk_char_segment_new_external (text + index,
+                                             seg->byte_count - index,
+                                             seg->char_count - chars1);
+    }
+  else
+    {
+      new1 = _gtk_char_segment_new (seg->body.chars, index);
+      new2 = _gtk_char_segment_new (seg->body.chars + index, seg->byte_count - index);
+    }
+
+  g_assert (gtk_text_byte_begins_utf8_char (_gtk_char_segment_get_chars (new1)));
+  g_assert (gtk_text_byte_begins_utf8_char (_gtk_char_segment_get_chars (new2)));
   g_assert (new1->byte_count + new2->byte_count == seg->byte_count);
   g_assert (new1->char_count + new2->char_count == seg->char_count);
 
@@ -337,13 +393,25 @@ char_segment_cleanup_func (GtkTextLineSegment *segPtr, GtkTextLine *line)
       return segPtr;
     }
 
-  newPtr =
-    _gtk_char_segment_new_from_two_strings (segPtr->body.chars, 
-					    segPtr->byte_count,
-					    segPtr->char_count,
-                                            segPtr2->body.chars, 
-					    segPtr2->byte_count,
-					    segPtr2->char_count);
+  /* Neighbouring pieces of the same external text don't need a copy */
+  if (CSEG_IS_EXTERNAL (segPtr) && CSEG_IS_EXTERNAL (segPtr2) &&
+      segPtr->body.external.text + segPtr->byte_count == segPtr2->body.external.text)
+    {
+      newPtr =
+        _gtk_char_segment_new_external (segPtr->body.external.text,
+                                        segPtr->byte_count + segPtr2->byte_count,
+                                        segPtr->char_count + segPtr2->char_count);
+    }
+  else
+    {
+      newPtr =
+        _gtk_char_segment_new_from_two_strings (_gtk_char_segment_get_chars (segPtr),
+                                                segPtr->byte_count,
+                                                segPtr->char_count,
+                                                _gtk_char_segment_get_chars (segPtr2),
+                                                segPtr2->byte_count,
+                                                segPtr2->char_count);
+    }
 
   newPtr->next = segPtr2->next;
 
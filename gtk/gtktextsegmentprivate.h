@@ -48,6 +48,7 @@ struct _GtkTextTagInfo {
   GtkTextTag *tag;
   GtkTextBTreeNode *tag_root; /* highest-level node containing the tag */
   int toggle_count;      /* total toggles of this tag below tag_root */
+  guint index;           /* bit used for the tag in node toggle parities */
 };
 
 /* Body of a segment that toggles a tag on or off */
@@ -123,6 +124,20 @@ struct _GtkTextLineSegmentClass {
                                         * segment. */
 };
 
+/* The body of a char segment that refers to text outside of
+ * the segment instead of holding a copy, see
+ * _gtk_char_segment_new_external().
+ */
+typedef struct _GtkTextExternalChars GtkTextExternalChars;
+
+struct _GtkTextExternalChars {
+  char nul;                             /* Always 0. Text held by the segment
+                                         * never contains nul bytes, so this
+                                         * tells the two kinds apart. */
+  const char *text;                     /* The text, which is not
+                                         * nul-terminated. */
+};
+
 /*
  * The data structure below defines line segments.
  */
@@ -140,7 +155,10 @@ struct _GtkTextLineSegment {
   union {
     char chars[4];                      /* Characters that make up character
                                          * info.  Actual length varies to
-                                         * hold as many characters as needed.*/
+                                         * hold as many characters as needed.
+                                         * Use _gtk_char_segment_get_chars()
+                                         * to read them. */
+    GtkTextExternalChars external;      /* Characters outside of the segment */
     GtkTextToggleBody toggle;           /* Information about tag toggle. */
     GtkTextMarkBody mark;               /* Information about mark. */
     GtkTextPaintable paintable;         /* Child texture */
@@ -153,6 +171,9 @@ GtkTextLineSegment  *gtk_text_line_segment_split (const GtkTextIter *iter);
 
 GtkTextLineSegment *_gtk_char_segment_new                  (const char     *text,
                                                             guint           len);
+GtkTextLineSegment *_gtk_char_segment_new_external         (const char     *text,
+                                                            guint           len,
+                                                            guint           chars);
 GtkTextLineSegment *_gtk_char_segment_new_from_two_strings (const char     *text1,
                                                             guint           len1,
 							    guint           chars1,
@@ -164,6 +185,18 @@ GtkTextLineSegment *_gtk_toggle_segment_new                (GtkTextTagInfo *info
 
 void                _gtk_toggle_segment_free               (GtkTextLineSegment *seg);
 
+/* Returns the characters of a char segment. They are only
+ * nul-terminated if the segment holds a copy of them.
+ */
+static inline char *
+_gtk_char_segment_get_chars (const GtkTextLineSegment *seg)
+{
+  if (G_LIKELY (seg->body.chars[0] != '\0'))
+    return (char *) seg->body.chars;
+
+  return (char *) seg->body.external.text;
+}
+
 G_END_DECLS
 
 
@@ -40,6 +40,7 @@
 #include "gtkdragsourceprivate.h"
 #include "gtkdropcontrollermotion.h"
 #include "gtkemojichooser.h"
+#include "gtkidleschedulerprivate.h"
 #include "gtkimmulticontext.h"
 #include "gtkjoinedmenuprivate.h"
 #include "gtkmagnifierprivate.h"
@@ -55,6 +56,7 @@
 #include "gtktextiterprivate.h"
 #include "gtktexthandleprivate.h"
 #include "gtktextviewchildprivate.h"
+#include "gtktextpagesprivate.h"
 #include "gtkpopover.h"
 #include "gtkprivate.h"
 #include "gtktextbufferprivate.h"
@@ -3906,7 +3908,7 @@ gtk_text_view_remove_validate_idles (GtkTextView *text_view)
 
   if (priv->incremental_validate_idle != 0)
     {
-      g_source_remove (priv->incremental_validate_idle);
+      gtk_idle_scheduler_remove (priv->incremental_validate_idle);
       priv->incremental_validate_idle = 0;
     }
 }
@@ -4863,15 +4865,32 @@ first_validate_callback (gpointer data)
   return FALSE;
 }
 
+/* Until the visible lines are valid, the next frame
+ * depends on the validation
+ */
+static GtkIdleTaskPriority
+gtk_text_view_get_validate_priority (GtkTextView *text_view)
+{
+  if (!text_view->priv->onscreen_validated)
+    return GTK_IDLE_TASK_REDRAW;
+  else
+    return GTK_IDLE_TASK_BACKGROUND;
+}
+
 static gboolean
-incremental_validate_callback (gpointer data)
+incremental_validate_callback (gpointer data,
+                               gint64   deadline)
 {
   GtkTextView *text_view = data;
   gboolean result = TRUE;
 
   DV(g_print(G_STRLOC"\n"));
 
-  gtk_text_layout_validate (text_view->priv->layout, 2000);
+  /* Validate in small steps until the scheduler wants us to stop */
+  do
+    gtk_text_layout_validate (text_view->priv->layout, 200);
+  while (!gtk_text_layout_is_valid (text_view->priv->layout) &&
+         g_get_monotonic_time () < deadline);
 
   gtk_text_view_update_adjustments (text_view);
 
@@ -4880,6 +4899,11 @@ incremental_validate_callback (gpointer data)
       text_view->priv->incremental_validate_idle = 0;
       result = FALSE;
     }
+  else
+    {
+      gtk_idle_scheduler_set_priority (text_view->priv->incremental_validate_idle,
+                                       gtk_text_view_get_validate_priority (text_view));
+    }
 
   return result;
 }
@@ -4908,11 +4932,18 @@ gtk_text_view_invalidate (GtkTextView *text_view)
 
   if (!priv->incremental_validate_idle)
     {
-      priv->incremental_validate_idle = g_idle_add_full (GTK_TEXT_VIEW_PRIORITY_VALIDATE, incremental_validate_callback, text_view, NULL);
-      gdk_source_set_static_name_by_id (priv->incremental_validate_idle, "[gtk] incremental_validate_callback");
+      priv->incremental_validate_idle = gtk_idle_scheduler_add (gtk_text_view_get_validate_priority (text_view),
+                                                                incremental_validate_callback,
+                                                                text_view, NULL,
+                                                                "[gtk] incremental_validate_callback");
       DV (g_print (G_STRLOC": adding incremental validate idle %d\n",
                    priv->incremental_validate_idle));
     }
+  else
+    {
+      gtk_idle_scheduler_set_priority (priv->incremental_validate_idle,
+                                       gtk_text_view_get_validate_priority (text_view));
+    }
 }
 
 static void
@@ -10392,14 +10423,20 @@ gtk_text_view_accessible_text_get_contents (GtkAccessibleText *self,
 {
   GtkTextBuffer *buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (self));
   GtkTextIter start_iter, end_iter;
-  char *string;
 
   gtk_text_buffer_get_iter_at_offset (buffer, &start_iter, start);
   gtk_text_buffer_get_iter_at_offset (buffer, &end_iter, end == G_MAXUINT ? -1 : end);
 
-  string = gtk_text_buffer_get_text (buffer, &start_iter, &end_iter, FALSE);
+  /* Assistive technologies tend to ask for all of the text again and
+   * again, so it is served from pages that are kept until they change
+   */
+  return gtk_text_pages_get_text (buffer, &start_iter, &end_iter);
+}
 
-  return g_bytes_new_take (string, strlen (string) + 1);
+static unsigned int
+gtk_text_view_accessible_text_get_character_count (GtkAccessibleText *self)
+{
+  return gtk_text_buffer_get_char_count (gtk_text_view_get_buffer (GTK_TEXT_VIEW (self)));
 }
 
 static GBytes *
@@ -10767,6 +10804,7 @@ gtk_text_view_accessible_text_init (GtkAccessibleTextInterface *iface)
   iface->get_default_attributes = gtk_text_view_accessible_text_get_default_attributes;
   iface->get_extents = gtk_text_view_accessible_text_get_extents;
   iface->get_offset = gtk_text_view_accessible_text_get_offset;
+  iface->get_character_count = gtk_text_view_accessible_text_get_character_count;
 }
 
 /* }}} */
@@ -44,6 +44,7 @@
 #include "gtkdebug.h"
 #include "gtkgestureprivate.h"
 #include "gtklayoutmanagerprivate.h"
+#include "gtklayoutstatsprivate.h"
 #include "gtkmain.h"
 #include "gtkmarshalers.h"
 #include "gtknative.h"
@@ -2594,6 +2595,9 @@ gtk_widget_unparent (GtkWidget *widget)
    */
   priv->child_visible = TRUE;
 
+  if (priv->dormant)
+    gtk_widget_set_dormant (widget, FALSE);
+
   old_parent = priv->parent;
   if (old_parent)
     {
@@ -2719,7 +2723,7 @@ gtk_widget_show (GtkWidget *widget)
             gtk_widget_queue_compute_expand (parent);
         }
 
-      gtk_css_node_set_visible (priv->cssnode, TRUE);
+      gtk_css_node_set_visible (priv->cssnode, !priv->dormant);
 
       g_signal_emit (widget, widget_signals[SHOW], 0);
       g_object_notify_by_pspec (G_OBJECT (widget), widget_props[PROP_VISIBLE]);
@@ -3551,7 +3555,7 @@ gtk_widget_queue_allocate (GtkWidget *widget)
   gtk_widget_set_alloc_needed (widget);
 }
 
-static inline gboolean
+gboolean
 gtk_widget_get_resize_needed (GtkWidget *widget)
 {
   GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
@@ -3626,6 +3630,9 @@ gtk_widget_queue_resize (GtkWidget *widget)
 {
   g_return_if_fail (GTK_IS_WIDGET (widget));
 
+  if (GTK_LAYOUT_STATS_IS_RUNNING)
+    gtk_layout_stats_record_queue_resize (G_OBJECT_TYPE (widget));
+
   if (_gtk_widget_get_realized (widget))
     gtk_widget_queue_draw (widget);
 
@@ -4086,12 +4093,16 @@ gtk_widget_allocate (GtkWidget    *widget,
     }
   else
     {
+      gint64 stats_start;
+
       priv->width = adjusted.width;
       priv->height = adjusted.height;
       priv->baseline = baseline;
 
       priv->alloc_needed_on_child = FALSE;
 
+      stats_start = gtk_layout_stats_begin ();
+
       if (priv->layout_manager != NULL)
         {
           gtk_layout_manager_allocate (priv->layout_manager, widget,
@@ -4107,6 +4118,8 @@ gtk_widget_allocate (GtkWidget    *widget,
                                                         baseline);
         }
 
+      gtk_layout_stats_end (stats_start, GTK_LAYOUT_STATS_ALLOCATE, G_OBJECT_TYPE (widget));
+
       /* Size allocation is god... after consulting god, no further requests or allocations are needed */
       if (GTK_DISPLAY_DEBUG_CHECK (_gtk_widget_get_display (widget), GEOMETRY) &&
           gtk_widget_get_resize_needed (widget))
@@ -6813,6 +6826,57 @@ gtk_widget_set_child_visible (GtkWidget *widget,
   g_object_unref (widget);
 }
 
+/*
+ * gtk_widget_set_dormant:
+ * @widget: a `GtkWidget`
+ * @dormant: whether to put @widget to sleep
+ *
+ * Puts a widget that is not mapped to sleep, or wakes it up again.
+ *
+ * A dormant widget is unrealized, and its CSS node takes no part in
+ * style validation, as if it was hidden. The styles of the whole
+ * subtree are dropped, and computed again after the widget has been
+ * woken up, or when they are asked for in the meantime.
+ *
+ * This is meant for containers that keep lots of children around
+ * that are not shown, like `GtkStack`.
+ *
+ * Returns: the number of styles that were dropped by putting
+ *   @widget to sleep
+ */
+guint
+gtk_widget_set_dormant (GtkWidget *widget,
+                        gboolean   dormant)
+{
+  GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
+  guint n_dropped = 0;
+
+  g_return_val_if_fail (GTK_IS_WIDGET (widget), 0);
+  g_return_val_if_fail (!dormant || !_gtk_widget_get_mapped (widget), 0);
+
+  dormant = !!dormant;
+
+  if (priv->dormant == dormant)
+    return 0;
+
+  priv->dormant = dormant;
+
+  if (dormant)
+    {
+      if (_gtk_widget_get_realized (widget))
+        gtk_widget_unrealize (widget);
+
+      gtk_css_node_set_visible (priv->cssnode, FALSE);
+      n_dropped = gtk_css_node_drop_styles (priv->cssnode);
+    }
+  else
+    {
+      gtk_css_node_set_visible (priv->cssnode, priv->visible);
+    }
+
+  return n_dropped;
+}
+
 /**
  * gtk_widget_get_child_visible:
  * @widget: a `GtkWidget`
@@ -10927,6 +10991,32 @@ gtk_widget_class_get_css_name (GtkWidgetClass *widget_class)
   return g_quark_to_string (widget_class->priv->css_name);
 }
 
+/*
+ * gtk_widget_class_set_measure_key_func:
+ * @widget_class: a widget class
+ * @func: function to compute the measure key of a widget
+ *
+ * Lets widgets of this class share their measurements with other
+ * widgets of the same type, content and style.
+ *
+ * This is only used as long as the measure function of subclasses
+ * is the same as the one of @widget_class at the time of the call,
+ * so it must be called after that was set.
+ */
+void
+gtk_widget_class_set_measure_key_func (GtkWidgetClass    *widget_class,
+                                       GtkMeasureKeyFunc  func)
+{
+  GtkWidgetClassPrivate *priv;
+
+  g_return_if_fail (GTK_IS_WIDGET_CLASS (widget_class));
+
+  priv = widget_class->priv;
+
+  priv->measure_key = func;
+  priv->measure_key_measure = widget_class->measure;
+}
+
 void
 gtk_widget_css_changed (GtkWidget         *widget,
                         GtkCssStyleChange *change)
@@ -11908,6 +11998,7 @@ gtk_widget_do_snapshot (GtkWidget *widget,
 {
   GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
   GskRenderNode *render_node;
+  gint64 stats_start;
 
   if (!priv->draw_needed)
     return;
@@ -11922,7 +12013,9 @@ gtk_widget_do_snapshot (GtkWidget *widget,
 
   gtk_widget_push_paintables (widget);
 
+  stats_start = gtk_layout_stats_begin ();
   render_node = gtk_widget_create_render_node (widget, snapshot);
+  gtk_layout_stats_end (stats_start, GTK_LAYOUT_STATS_SNAPSHOT, G_OBJECT_TYPE (widget));
   /* This can happen when nested drawing happens and a widget contains itself
    * or when we replace a clipped area
    */
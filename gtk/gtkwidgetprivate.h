@@ -32,6 +32,7 @@
 #include "gtkcsstypesprivate.h"
 #include "gtkeventcontrollerprivate.h"
 #include "gtklistlistmodelprivate.h"
+#include "gtkmeasurecacheprivate.h"
 #include "gtkrootprivate.h"
 #include "gtksizerequestcacheprivate.h"
 #include "gtkwindowprivate.h"
@@ -45,6 +46,20 @@ typedef gboolean (*GtkSurfaceTransformChangedCallback) (GtkWidget
                                                         const graphene_matrix_t *surface_transform,
                                                         gpointer                 user_data);
 
+/*
+ * GtkMeasureKeyFunc:
+ * @widget: the widget to be measured
+ * @key: the key to add to
+ *
+ * Adds everything apart from the style that the measure function
+ * of @widget depends on to @key, so that measurements can be
+ * shared with other widgets of the same type.
+ *
+ * Returns: %FALSE if the measurements of @widget can't be shared
+ */
+typedef gboolean (*GtkMeasureKeyFunc) (GtkWidget     *widget,
+                                       GtkMeasureKey *key);
+
 #define GTK_STATE_FLAGS_BITS 15
 
 typedef struct _GtkWidgetSurfaceTransformData
@@ -81,6 +96,7 @@ struct _GtkWidgetPrivate
   guint has_grab              : 1;
   guint child_visible         : 1;
   guint can_target            : 1;
+  guint dormant               : 1;
 
   /* Queue-resize related flags */
   guint resize_needed         : 1; /* queue_resize() has been called but no get_preferred_size() yet */
@@ -216,6 +232,15 @@ struct _GtkWidgetClassPrivate
   GtkAccessibleRole accessible_role;
   guint activate_signal;
   GQuark css_name;
+  GtkMeasureKeyFunc measure_key;
+  /* The measure function that measure_key was made for */
+  void (* measure_key_measure) (GtkWidget      *widget,
+                                GtkOrientation  orientation,
+                                int             for_size,
+                                int            *minimum,
+                                int            *natural,
+                                int            *minimum_baseline,
+                                int            *natural_baseline);
 };
 
 void          gtk_widget_root               (GtkWidget *widget);
@@ -223,7 +248,10 @@ void          gtk_widget_unroot             (GtkWidget *widget);
 GtkCssNode *  gtk_widget_get_css_node       (GtkWidget *widget);
 void         _gtk_widget_set_visible_flag   (GtkWidget *widget,
                                              gboolean   visible);
+guint        gtk_widget_set_dormant         (GtkWidget *widget,
+                                             gboolean   dormant);
 gboolean     _gtk_widget_get_alloc_needed   (GtkWidget *widget);
+gboolean     gtk_widget_get_resize_needed   (GtkWidget *widget);
 gboolean     gtk_widget_needs_allocate      (GtkWidget *widget);
 void         gtk_widget_ensure_resize       (GtkWidget *widget);
 void         gtk_widget_ensure_allocate     (GtkWidget *widget);
@@ -301,6 +329,8 @@ void              gtk_widget_adjust_size_request           (GtkWidget      *widg
 void              gtk_widget_adjust_baseline_request       (GtkWidget *widget,
                                                             int       *minimum_baseline,
                                                             int       *natural_baseline);
+void              gtk_widget_class_set_measure_key_func    (GtkWidgetClass     *widget_class,
+                                                            GtkMeasureKeyFunc   func);
 
 typedef void    (*GtkCallback)     (GtkWidget        *widget,
                                     gpointer          data);
@@ -39,6 +39,8 @@
 #include "gtkgestureclick.h"
 #include "gtkheaderbar.h"
 #include "gtkicontheme.h"
+#include "gtkidleschedulerprivate.h"
+#include "gtklayoutstatsprivate.h"
 #include <glib/gi18n-lib.h>
 #include "gtkmain.h"
 #include "gtkmarshalers.h"
@@ -396,6 +398,8 @@ static gboolean surface_render            (GdkSurface         *surface,
 static gboolean surface_event             (GdkSurface         *surface,
                                            GdkEvent           *event,
                                            GtkWidget          *widget);
+static void     before_paint              (GdkFrameClock      *clock,
+                                           GtkWindow          *window);
 static void     after_paint               (GdkFrameClock      *clock,
                                            GtkWindow          *window);
 
@@ -4332,7 +4336,9 @@ gtk_window_realize (GtkWidget *widget)
   g_signal_connect (surface, "compute-size", G_CALLBACK (toplevel_compute_size), widget);
 
   frame_clock = gdk_surface_get_frame_clock (surface);
+  g_signal_connect (frame_clock, "before-paint", G_CALLBACK (before_paint), widget);
   g_signal_connect (frame_clock, "after-paint", G_CALLBACK (after_paint), widget);
+  gtk_idle_scheduler_add_frame_clock (frame_clock);
 
   GTK_WIDGET_CLASS (gtk_window_parent_class)->realize (widget);
 
@@ -4447,7 +4453,9 @@ gtk_window_unrealize (GtkWidget *widget)
 
   frame_clock = gdk_surface_get_frame_clock (surface);
 
+  g_signal_handlers_disconnect_by_func (frame_clock, before_paint, widget);
   g_signal_handlers_disconnect_by_func (frame_clock, after_paint, widget);
+  gtk_idle_scheduler_remove_frame_clock (frame_clock);
 
   gtk_root_stop_layout (GTK_ROOT (window));
 
@@ -4758,11 +4766,20 @@ surface_render (GdkSurface     *surface,
   return TRUE;
 }
 
+static void
+before_paint (GdkFrameClock *clock,
+              GtkWindow     *window)
+{
+  gtk_layout_stats_frame_begin (clock);
+}
+
 static void
 after_paint (GdkFrameClock *clock,
              GtkWindow     *window)
 {
   maybe_unset_focus_and_default (window);
+
+  gtk_layout_stats_frame_done (clock);
 }
 
 static gboolean
@@ -0,0 +1,304 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <glib/gi18n-lib.h>
+
+#include "caches.h"
+
+#include "gdktextureutilsprivate.h"
+#include "gtkbinlayout.h"
+#include "gtkbox.h"
+#include "gtklabel.h"
+#include "gtklistbox.h"
+#include "gtkmeasurecacheprivate.h"
+#include "gtkpangolayoutcacheprivate.h"
+#include "gtkprivate.h"
+
+#include "gdk/gdktexturecacheprivate.h"
+
+/* How often the numbers are refreshed while the page is shown */
+#define UPDATE_INTERVAL_MS 500
+
+struct _GtkInspectorCaches
+{
+  GtkWidget parent;
+
+  GtkWidget *swin;
+  GtkWidget *box;
+  GtkWidget *layout_box;
+
+  GtkWidget *layout_entries;
+  GtkWidget *layout_hits;
+  GtkWidget *layout_misses;
+  GtkWidget *layout_hit_rate;
+  GtkWidget *layout_evictions;
+
+  GtkWidget *measure_box;
+  GtkWidget *measure_entries;
+  GtkWidget *measure_hits;
+  GtkWidget *measure_misses;
+  GtkWidget *measure_hit_rate;
+  GtkWidget *measure_evictions;
+
+  GtkWidget *texture_box;
+  GtkWidget *texture_entries;
+  GtkWidget *texture_size;
+  GtkWidget *texture_hits;
+  GtkWidget *texture_misses;
+  GtkWidget *texture_hit_rate;
+  GtkWidget *texture_evictions;
+
+  GtkWidget *symbolic_box;
+  GtkWidget *symbolic_entries;
+  GtkWidget *symbolic_hits;
+  GtkWidget *symbolic_misses;
+  GtkWidget *symbolic_hit_rate;
+
+  guint update_source_id;
+};
+
+typedef struct _GtkInspectorCachesClass
+{
+  GtkWidgetClass parent;
+} GtkInspectorCachesClass;
+
+G_DEFINE_TYPE (GtkInspectorCaches, gtk_inspector_caches, GTK_TYPE_WIDGET)
+
+static GtkWidget *
+add_value_row (GtkListBox *list,
+               const char *name)
+{
+  GtkWidget *box;
+  GtkWidget *label;
+  GtkWidget *row;
+
+  box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 40);
+
+  label = gtk_label_new (name);
+  gtk_widget_set_halign (label, GTK_ALIGN_START);
+  gtk_widget_set_valign (label, GTK_ALIGN_BASELINE_FILL);
+  gtk_label_set_xalign (GTK_LABEL (label), 0.0);
+  gtk_widget_set_hexpand (label, TRUE);
+  gtk_box_append (GTK_BOX (box), label);
+
+  label = gtk_label_new (NULL);
+  gtk_label_set_selectable (GTK_LABEL (label), TRUE);
+  gtk_widget_set_halign (label, GTK_ALIGN_END);
+  gtk_widget_set_valign (label, GTK_ALIGN_BASELINE_FILL);
+  gtk_label_set_xalign (GTK_LABEL (label), 1.0);
+  gtk_label_set_width_chars (GTK_LABEL (label), 25);
+  gtk_box_append (GTK_BOX (box), label);
+
+  row = gtk_list_box_row_new ();
+  gtk_list_box_row_set_child (GTK_LIST_BOX_ROW (row), box);
+  gtk_list_box_row_set_activatable (GTK_LIST_BOX_ROW (row), FALSE);
+
+  gtk_widget_set_hexpand (box, FALSE);
+  gtk_list_box_insert (list, row, -1);
+
+  return label;
+}
+
+static void
+set_value (GtkWidget  *label,
+           const char *format,
+           ...) G_GNUC_PRINTF (2, 3);
+
+static void
+set_value (GtkWidget  *label,
+           const char *format,
+           ...)
+{
+  va_list args;
+  char *text;
+
+  va_start (args, format);
+  text = g_strdup_vprintf (format, args);
+  va_end (args);
+
+  gtk_label_set_label (GTK_LABEL (label), text);
+
+  g_free (text);
+}
+
+static double
+hit_rate (guint64 hits,
+          guint64 misses)
+{
+  if (hits + misses == 0)
+    return 0;
+
+  return 100.0 * hits / (double) (hits + misses);
+}
+
+static gboolean
+update_caches (gpointer data)
+{
+  GtkInspectorCaches *caches = data;
+  GtkPangoLayoutCacheStats layout_stats;
+  GtkMeasureCacheStats measure_stats;
+  GdkTextureCacheStats texture_stats;
+  GtkSymbolicCacheStats symbolic_stats;
+  char *size, *max_size;
+
+  gtk_pango_layout_cache_get_stats (&layout_stats);
+
+  set_value (caches->layout_entries, "%u / %u", layout_stats.n_entries, layout_stats.max_entries);
+  set_value (caches->layout_hits, "%" G_GUINT64_FORMAT, layout_stats.n_hits);
+  set_value (caches->layout_misses, "%" G_GUINT64_FORMAT, layout_stats.n_misses);
+  set_value (caches->layout_hit_rate, "%.1f %%", hit_rate (layout_stats.n_hits, layout_stats.n_misses));
+  set_value (caches->layout_evictions, "%" G_GUINT64_FORMAT, layout_stats.n_evictions);
+
+  gtk_measure_cache_get_stats (&measure_stats);
+
+  set_value (caches->measure_entries, "%u / %u", measure_stats.n_entries, measure_stats.max_entries);
+  set_value (caches->measure_hits, "%" G_GUINT64_FORMAT, measure_stats.n_hits);
+  set_value (caches->measure_misses, "%" G_GUINT64_FORMAT, measure_stats.n_misses);
+  set_value (caches->measure_hit_rate, "%.1f %%", hit_rate (measure_stats.n_hits, measure_stats.n_misses));
+  set_value (caches->measure_evictions, "%" G_GUINT64_FORMAT, measure_stats.n_evictions);
+
+  gdk_texture_cache_get_stats (&texture_stats);
+
+  size = g_format_size (texture_stats.size);
+  max_size = g_format_size (texture_stats.max_size);
+
+  set_value (caches->texture_entries, "%u (%u kept)", texture_stats.n_entries, texture_stats.n_kept);
+  set_value (caches->texture_size, "%s / %s", size, max_size);
+  set_value (caches->texture_hits, "%" G_GUINT64_FORMAT, texture_stats.n_hits);
+  set_value (caches->texture_misses, "%" G_GUINT64_FORMAT, texture_stats.n_misses);
+  set_value (caches->texture_hit_rate, "%.1f %%", hit_rate (texture_stats.n_hits, texture_stats.n_misses));
+  set_value (caches->texture_evictions, "%" G_GUINT64_FORMAT, texture_stats.n_evictions);
+
+  gtk_symbolic_cache_get_stats (&symbolic_stats);
+
+  set_value (caches->symbolic_entries, "%u / %u", symbolic_stats.n_entries, symbolic_stats.max_entries);
+  set_value (caches->symbolic_hits, "%" G_GUINT64_FORMAT, symbolic_stats.n_hits);
+  set_value (caches->symbolic_misses, "%" G_GUINT64_FORMAT, symbolic_stats.n_misses);
+  set_value (caches->symbolic_hit_rate, "%.1f %%", hit_rate (symbolic_stats.n_hits, symbolic_stats.n_misses));
+
+  g_free (size);
+  g_free (max_size);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+clear_caches (GtkInspectorCaches *caches)
+{
+  gtk_pango_layout_cache_clear ();
+  gtk_measure_cache_clear ();
+  gdk_texture_cache_clear ();
+  gtk_symbolic_cache_clear ();
+
+  update_caches (caches);
+}
+
+static void
+gtk_inspector_caches_map (GtkWidget *widget)
+{
+  GtkInspectorCaches *caches = GTK_INSPECTOR_CACHES (widget);
+
+  GTK_WIDGET_CLASS (gtk_inspector_caches_parent_class)->map (widget);
+
+  update_caches (caches);
+  caches->update_source_id = g_timeout_add (UPDATE_INTERVAL_MS, update_caches, caches);
+  gdk_source_set_static_name_by_id (caches->update_source_id, "[gtk] update_caches");
+}
+
+static void
+gtk_inspector_caches_unmap (GtkWidget *widget)
+{
+  GtkInspectorCaches *caches = GTK_INSPECTOR_CACHES (widget);
+
+  g_clear_handle_id (&caches->update_source_id, g_source_remove);
+
+  GTK_WIDGET_CLASS (gtk_inspector_caches_parent_class)->unmap (widget);
+}
+
+static void
+gtk_inspector_caches_init (GtkInspectorCaches *caches)
+{
+  GtkListBox *list;
+
+  gtk_widget_init_template (GTK_WIDGET (caches));
+
+  list = GTK_LIST_BOX (caches->layout_box);
+  caches->layout_entries = add_value_row (list, _("Entries"));
+  caches->layout_hits = add_value_row (list, _("Hits"));
+  caches->layout_misses = add_value_row (list, _("Misses"));
+  caches->layout_hit_rate = add_value_row (list, _("Hit Rate"));
+  caches->layout_evictions = add_value_row (list, _("Evictions"));
+
+  list = GTK_LIST_BOX (caches->measure_box);
+  caches->measure_entries = add_value_row (list, _("Entries"));
+  caches->measure_hits = add_value_row (list, _("Hits"));
+  caches->measure_misses = add_value_row (list, _("Misses"));
+  caches->measure_hit_rate = add_value_row (list, _("Hit Rate"));
+  caches->measure_evictions = add_value_row (list, _("Evictions"));
+
+  list = GTK_LIST_BOX (caches->texture_box);
+  gtk_widget_class_bind_template_child (widget_class, GtkInspectorCaches, symbolic_box);
+  caches->texture_entries = add_value_row (list, _("Entries"));
+  caches->texture_size = add_value_row (list, _("Memory"));
+  caches->texture_hits = add_value_row (list, _("Hits"));
+  caches->texture_misses = add_value_row (list, _("Misses"));
+  caches->texture_hit_rate = add_value_row (list, _("Hit Rate"));
+  caches->texture_evictions = add_value_row (list, _("Evictions"));
+
+  list = GTK_LIST_BOX (caches->symbolic_box);
+  caches->symbolic_entries = add_value_row (list, _("Entries"));
+  caches->symbolic_hits = add_value_row (list, _("Hits"));
+  caches->symbolic_misses = add_value_row (list, _("Misses"));
+  caches->symbolic_hit_rate = add_value_row (list, _("Hit Rate"));
+}
+
+static void
+gtk_inspector_caches_dispose (GObject *object)
+{
+  GtkInspectorCaches *caches = GTK_INSPECTOR_CACHES (object);
+
+  g_clear_handle_id (&caches->update_source_id, g_source_remove);
+
+  gtk_widget_dispose_template (GTK_WIDGET (object), GTK_TYPE_INSPECTOR_CACHES);
+
+  G_OBJECT_CLASS (gtk_inspector_caches_parent_class)->dispose (object);
+}
+
+static void
+gtk_inspector_caches_class_init (GtkInspectorCachesClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+  object_class->dispose = gtk_inspector_caches_dispose;
+
+  widget_class->map = gtk_inspector_caches_map;
+  widget_class->unmap = gtk_inspector_caches_unmap;
+
+  gtk_widget_class_set_template_from_resource (widget_class, "/org/gtk/libgtk/inspector/caches.ui");
+  gtk_widget_class_bind_template_child (widget_class, GtkInspectorCaches, swin);
+  gtk_widget_class_bind_template_child (widget_class, GtkInspectorCaches, box);
+  gtk_widget_class_bind_template_child (widget_class, GtkInspectorCaches, layout_box);
+  gtk_widget_class_bind_template_child (widget_class, GtkInspectorCaches, measure_box);
+  gtk_widget_class_bind_template_child (widget_class, GtkInspectorCaches, texture_box);
+  gtk_widget_class_bind_template_callback (widget_class, clear_caches);
+
+  gtk_widget_class_set_layout_manager_type (widget_class, GTK_TYPE_BIN_LAYOUT);
+}
+
+// vim: set et sw=2 ts=2:
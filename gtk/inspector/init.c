@@ -27,12 +27,14 @@
 #include "a11y.h"
 #include "actions.h"
 #include "graphrenderer.h"
+#include "caches.h"
 #include "clipboard.h"
 #include "controllers.h"
 #include "css-editor.h"
 #include "css-node-tree.h"
 #include "general.h"
 #include "graphdata.h"
+#include "layoutstats.h"
 #include "list-data.h"
 #include "logs.h"
 #include "magnifier.h"
@@ -70,11 +72,13 @@ gtk_inspector_init (void)
   g_type_ensure (graph_renderer_get_type ());
   g_type_ensure (GTK_TYPE_INSPECTOR_A11Y);
   g_type_ensure (GTK_TYPE_INSPECTOR_ACTIONS);
+  g_type_ensure (GTK_TYPE_INSPECTOR_CACHES);
   g_type_ensure (GTK_TYPE_INSPECTOR_CLIPBOARD);
   g_type_ensure (GTK_TYPE_INSPECTOR_CONTROLLERS);
   g_type_ensure (GTK_TYPE_INSPECTOR_CSS_EDITOR);
   g_type_ensure (GTK_TYPE_INSPECTOR_CSS_NODE_TREE);
   g_type_ensure (GTK_TYPE_INSPECTOR_GENERAL);
+  g_type_ensure (GTK_TYPE_INSPECTOR_LAYOUT_STATS);
   g_type_ensure (GTK_TYPE_INSPECTOR_LIST_DATA);
   g_type_ensure (GTK_TYPE_INSPECTOR_LOGS);
   g_type_ensure (GTK_TYPE_MAGNIFIER);
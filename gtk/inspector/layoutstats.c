@@ -0,0 +1,355 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <glib/gi18n-lib.h>
+
+#include "layoutstats.h"
+#include "window.h"
+
+#include "gtkalertdialog.h"
+#include "gtkbinlayout.h"
+#include "gtkbox.h"
+#include "gtkfiledialog.h"
+#include "gtklabel.h"
+#include "gtklayoutstatsprivate.h"
+#include "gtklistbox.h"
+#include "gtkprivate.h"
+#include "gtkwindow.h"
+
+/* How often the numbers are refreshed while the page is shown */
+#define UPDATE_INTERVAL_MS 500
+
+/* How many types to show */
+#define MAX_TYPES 25
+
+struct _GtkInspectorLayoutStats
+{
+  GtkWidget parent;
+
+  GtkWidget *swin;
+  GtkWidget *box;
+  GtkWidget *frame_box;
+  GtkWidget *types_box;
+
+  GtkWidget *frame_phases[GTK_LAYOUT_STATS_N_PHASES];
+  GtkWidget *frame_cache;
+  GtkWidget *frame_queue_resizes;
+
+  guint update_source_id;
+};
+
+typedef struct _GtkInspectorLayoutStatsClass
+{
+  GtkWidgetClass parent;
+} GtkInspectorLayoutStatsClass;
+
+G_DEFINE_TYPE (GtkInspectorLayoutStats, gtk_inspector_layout_stats, GTK_TYPE_WIDGET)
+
+static GtkWidget *
+add_value_row (GtkListBox *list,
+               const char *name,
+               int         width_chars)
+{
+  GtkWidget *box;
+  GtkWidget *label;
+  GtkWidget *row;
+
+  box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 40);
+
+  label = gtk_label_new (name);
+  gtk_widget_set_halign (label, GTK_ALIGN_START);
+  gtk_widget_set_valign (label, GTK_ALIGN_BASELINE_FILL);
+  gtk_label_set_xalign (GTK_LABEL (label), 0.0);
+  gtk_widget_set_hexpand (label, TRUE);
+  gtk_box_append (GTK_BOX (box), label);
+
+  label = gtk_label_new (NULL);
+  gtk_label_set_selectable (GTK_LABEL (label), TRUE);
+  gtk_widget_set_halign (label, GTK_ALIGN_END);
+  gtk_widget_set_valign (label, GTK_ALIGN_BASELINE_FILL);
+  gtk_label_set_xalign (GTK_LABEL (label), 1.0);
+  gtk_label_set_width_chars (GTK_LABEL (label), width_chars);
+  gtk_box_append (GTK_BOX (box), label);
+
+  row = gtk_list_box_row_new ();
+  gtk_list_box_row_set_child (GTK_LIST_BOX_ROW (row), box);
+  gtk_list_box_row_set_activatable (GTK_LIST_BOX_ROW (row), FALSE);
+
+  gtk_widget_set_hexpand (box, FALSE);
+  gtk_list_box_insert (list, row, -1);
+
+  return label;
+}
+
+static void
+set_value (GtkWidget  *label,
+           const char *format,
+           ...) G_GNUC_PRINTF (2, 3);
+
+static void
+set_value (GtkWidget  *label,
+           const char *format,
+           ...)
+{
+  va_list args;
+  char *text;
+
+  va_start (args, format);
+  text = g_strdup_vprintf (format, args);
+  va_end (args);
+
+  gtk_label_set_label (GTK_LABEL (label), text);
+
+  g_free (text);
+}
+
+static void
+set_phase_value (GtkWidget *label,
+                 guint64    count,
+                 gint64     time)
+{
+  set_value (label, "%" G_GUINT64_FORMAT " (%.2f ms)", count, time / 1000.);
+}
+
+/* Frames are kept per frame clock. Show the ones of the inspected
+ * application, preferring its active window
+ */
+static GdkFrameClock *
+get_inspected_frame_clock (GtkInspectorLayoutStats *sl)
+{
+  GtkInspectorWindow *iw;
+  GListModel *toplevels;
+  GtkWidget *found = NULL;
+  guint i;
+
+  iw = GTK_INSPECTOR_WINDOW (gtk_widget_get_ancestor (GTK_WIDGET (sl), GTK_TYPE_INSPECTOR_WINDOW));
+  if (iw == NULL)
+    return NULL;
+
+  toplevels = gtk_window_get_toplevels ();
+  for (i = 0; i < g_list_model_get_n_items (toplevels); i++)
+    {
+      GtkWidget *window = GTK_WIDGET (g_list_model_get_item (toplevels, i));
+
+      /* The toplevels list keeps the windows alive */
+      if (!GTK_IS_INSPECTOR_WINDOW (window) &&
+          gtk_widget_get_display (window) == gtk_inspector_window_get_inspected_display (iw) &&
+          gtk_widget_get_realized (window) &&
+          (found == NULL || gtk_window_is_active (GTK_WINDOW (window))))
+        found = window;
+
+      g_object_unref (window);
+    }
+
+  return found ? gtk_widget_get_frame_clock (found) : NULL;
+}
+
+static gboolean
+update_layout_stats (gpointer data)
+{
+  GtkInspectorLayoutStats *sl = data;
+  GtkLayoutStatsEntry frame = { 0, };
+  GtkLayoutStatsEntry *entries;
+  GdkFrameClock *frame_clock;
+  guint i, j, n;
+
+  frame_clock = get_inspected_frame_clock (sl);
+  if (frame_clock)
+    gtk_layout_stats_get_last_frame (frame_clock, &frame);
+
+  for (i = 0; i < GTK_LAYOUT_STATS_N_PHASES; i++)
+    set_phase_value (sl->frame_phases[i], frame.count[i], frame.time[i]);
+  set_value (sl->frame_cache, "%" G_GUINT64_FORMAT " / %" G_GUINT64_FORMAT,
+             frame.n_cache_hits, frame.n_cache_misses);
+  set_value (sl->frame_queue_resizes, "%" G_GUINT64_FORMAT, frame.n_queue_resizes);
+
+  gtk_list_box_remove_all (GTK_LIST_BOX (sl->types_box));
+
+  entries = gtk_layout_stats_get_entries (&n);
+  for (i = 0; i < MIN (n, MAX_TYPES); i++)
+    {
+      GtkLayoutStatsEntry *entry = &entries[i];
+      GtkWidget *label;
+      gint64 total = 0;
+      char *tooltip;
+
+      for (j = 0; j < GTK_LAYOUT_STATS_N_PHASES; j++)
+        total += entry->time[j];
+
+      label = add_value_row (GTK_LIST_BOX (sl->types_box), g_type_name (entry->type), 40);
+      set_value (label,
+                 "%.2f ms, %" G_GUINT64_FORMAT " cache misses, %" G_GUINT64_FORMAT " resizes queued",
+                 total / 1000., entry->n_cache_misses, entry->n_queue_resizes);
+
+      tooltip = g_strdup_printf ("Measure: %" G_GUINT64_FORMAT " (%.2f ms)\n"
+                                 "Allocate: %" G_GUINT64_FORMAT " (%.2f ms)\n"
+                                 "Style: %" G_GUINT64_FORMAT " (%.2f ms)\n"
+                                 "Snapshot: %" G_GUINT64_FORMAT " (%.2f ms)\n"
+                                 "Cache hits: %" G_GUINT64_FORMAT,
+                                 entry->count[GTK_LAYOUT_STATS_MEASURE], entry->time[GTK_LAYOUT_STATS_MEASURE] / 1000.,
+                                 entry->count[GTK_LAYOUT_STATS_ALLOCATE], entry->time[GTK_LAYOUT_STATS_ALLOCATE] / 1000.,
+                                 entry->count[GTK_LAYOUT_STATS_CSS], entry->time[GTK_LAYOUT_STATS_CSS] / 1000.,
+                                 entry->count[GTK_LAYOUT_STATS_SNAPSHOT], entry->time[GTK_LAYOUT_STATS_SNAPSHOT] / 1000.,
+                                 entry->n_cache_hits);
+      gtk_widget_set_tooltip_text (label, tooltip);
+      g_free (tooltip);
+    }
+
+  g_free (entries);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+reset_stats (GtkInspectorLayoutStats *sl)
+{
+  gtk_layout_stats_reset ();
+
+  update_layout_stats (sl);
+}
+
+static void
+export_response (GObject      *source,
+                 GAsyncResult *result,
+                 gpointer      data)
+{
+  GtkFileDialog *dialog = GTK_FILE_DIALOG (source);
+  GtkInspectorLayoutStats *sl = data;
+  GError *error = NULL;
+  GFile *file;
+  char *json;
+
+  file = gtk_file_dialog_save_finish (dialog, result, NULL);
+  if (file == NULL)
+    return;
+
+  json = gtk_layout_stats_to_json ();
+
+  if (!g_file_replace_contents (file, json, strlen (json),
+                                NULL,
+                                FALSE,
+                                G_FILE_CREATE_NONE,
+                                NULL,
+                                NULL,
+                                &error))
+    {
+      GtkAlertDialog *alert;
+
+      alert = gtk_alert_dialog_new (_("Exporting layout statistics failed"));
+      gtk_alert_dialog_set_detail (alert, error->message);
+      gtk_alert_dialog_show (alert, GTK_WINDOW (gtk_widget_get_root (GTK_WIDGET (sl))));
+      g_object_unref (alert);
+      g_error_free (error);
+    }
+
+  g_free (json);
+  g_object_unref (file);
+}
+
+static void
+export_stats (GtkInspectorLayoutStats *sl)
+{
+  GtkFileDialog *dialog;
+
+  dialog = gtk_file_dialog_new ();
+  gtk_file_dialog_set_initial_name (dialog, "layout-stats.json");
+  gtk_file_dialog_save (dialog,
+                        GTK_WINDOW (gtk_widget_get_root (GTK_WIDGET (sl))),
+                        NULL,
+                        export_response, sl);
+  g_object_unref (dialog);
+}
+
+static void
+gtk_inspector_layout_stats_map (GtkWidget *widget)
+{
+  GtkInspectorLayoutStats *sl = GTK_INSPECTOR_LAYOUT_STATS (widget);
+
+  GTK_WIDGET_CLASS (gtk_inspector_layout_stats_parent_class)->map (widget);
+
+  /* Recording costs a bit, so only do it while someone looks */
+  gtk_layout_stats_enable ();
+
+  update_layout_stats (sl);
+  sl->update_source_id = g_timeout_add (UPDATE_INTERVAL_MS, update_layout_stats, sl);
+  gdk_source_set_static_name_by_id (sl->update_source_id, "[gtk] update_layout_stats");
+}
+
+static void
+gtk_inspector_layout_stats_unmap (GtkWidget *widget)
+{
+  GtkInspectorLayoutStats *sl = GTK_INSPECTOR_LAYOUT_STATS (widget);
+
+  g_clear_handle_id (&sl->update_source_id, g_source_remove);
+
+  gtk_layout_stats_disable ();
+
+  GTK_WIDGET_CLASS (gtk_inspector_layout_stats_parent_class)->unmap (widget);
+}
+
+static void
+gtk_inspector_layout_stats_init (GtkInspectorLayoutStats *sl)
+{
+  GtkListBox *list;
+
+  gtk_widget_init_template (GTK_WIDGET (sl));
+
+  list = GTK_LIST_BOX (sl->frame_box);
+  sl->frame_phases[GTK_LAYOUT_STATS_MEASURE] = add_value_row (list, _("Measure"), 25);
+  sl->frame_phases[GTK_LAYOUT_STATS_ALLOCATE] = add_value_row (list, _("Allocate"), 25);
+  sl->frame_phases[GTK_LAYOUT_STATS_CSS] = add_value_row (list, _("Style"), 25);
+  sl->frame_phases[GTK_LAYOUT_STATS_SNAPSHOT] = add_value_row (list, _("Snapshot"), 25);
+  sl->frame_cache = add_value_row (list, _("Size Cache Hits / Misses"), 25);
+  sl->frame_queue_resizes = add_value_row (list, _("Resizes Queued"), 25);
+}
+
+static void
+gtk_inspector_layout_stats_dispose (GObject *object)
+{
+  GtkInspectorLayoutStats *sl = GTK_INSPECTOR_LAYOUT_STATS (object);
+
+  g_clear_handle_id (&sl->update_source_id, g_source_remove);
+
+  gtk_widget_dispose_template (GTK_WIDGET (object), GTK_TYPE_INSPECTOR_LAYOUT_STATS);
+
+  G_OBJECT_CLASS (gtk_inspector_layout_stats_parent_class)->dispose (object);
+}
+
+static void
+gtk_inspector_layout_stats_class_init (GtkInspectorLayoutStatsClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+  object_class->dispose = gtk_inspector_layout_stats_dispose;
+
+  widget_class->map = gtk_inspector_layout_stats_map;
+  widget_class->unmap = gtk_inspector_layout_stats_unmap;
+
+  gtk_widget_class_set_template_from_resource (widget_class, "/org/gtk/libgtk/inspector/layoutstats.ui");
+  gtk_widget_class_bind_template_child (widget_class, GtkInspectorLayoutStats, swin);
+  gtk_widget_class_bind_template_child (widget_class, GtkInspectorLayoutStats, box);
+  gtk_widget_class_bind_template_child (widget_class, GtkInspectorLayoutStats, frame_box);
+  gtk_widget_class_bind_template_child (widget_class, GtkInspectorLayoutStats, types_box);
+  gtk_widget_class_bind_template_callback (widget_class, reset_stats);
+  gtk_widget_class_bind_template_callback (widget_class, export_stats);
+
+  gtk_widget_class_set_layout_manager_type (widget_class, GTK_TYPE_BIN_LAYOUT);
+}
+
+// vim: set et sw=2 ts=2:
@@ -0,0 +1,224 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+static int n_widgets = 400;
+static int n_resizes = 200;
+
+static GOptionEntry options[] = {
+  { "widgets", 'w', 0, G_OPTION_ARG_INT, &n_widgets, "Number of widgets in the layout", "WIDGETS" },
+  { "resizes", 'r', 0, G_OPTION_ARG_INT, &n_resizes, "Number of resizes to time", "RESIZES" },
+  { NULL }
+};
+
+/* A form, with a column of labels and a column of buttons */
+
+#define FORM_TYPE_WIDGET (form_widget_get_type ())
+G_DECLARE_FINAL_TYPE (FormWidget, form_widget, FORM, WIDGET, GtkWidget)
+
+struct _FormWidget
+{
+  GtkWidget parent_instance;
+};
+
+G_DEFINE_TYPE (FormWidget, form_widget, GTK_TYPE_WIDGET)
+
+static void
+form_widget_dispose (GObject *object)
+{
+  GtkWidget *child;
+
+  while ((child = gtk_widget_get_first_child (GTK_WIDGET (object))))
+    gtk_widget_unparent (child);
+
+  G_OBJECT_CLASS (form_widget_parent_class)->dispose (object);
+}
+
+static void
+form_widget_class_init (FormWidgetClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+  object_class->dispose = form_widget_dispose;
+
+  gtk_widget_class_set_layout_manager_type (widget_class, GTK_TYPE_CONSTRAINT_LAYOUT);
+}
+
+static void
+form_widget_init (FormWidget *self)
+{
+}
+
+static void
+add_constraint (GtkConstraintLayout    *layout,
+                gpointer                target,
+                GtkConstraintAttribute  target_attr,
+                GtkConstraintRelation   relation,
+                gpointer                source,
+                GtkConstraintAttribute  source_attr,
+                double                  constant)
+{
+  gtk_constraint_layout_add_constraint (layout,
+                                        gtk_constraint_new (target, target_attr,
+                                                            relation,
+                                                            source, source_attr,
+                                                            1.0, constant,
+                                                            GTK_CONSTRAINT_STRENGTH_REQUIRED));
+}
+
+static void
+time_add_constraints (GtkWidget *form,
+                      GTimer    *timer)
+{
+  GtkConstraintLayout *layout;
+  GtkWidget *first_label = NULL;
+  GtkWidget *prev_label = NULL;
+  int n_constraints = 0;
+  int i;
+
+  layout = GTK_CONSTRAINT_LAYOUT (gtk_widget_get_layout_manager (form));
+
+  g_timer_start (timer);
+
+  for (i = 0; i < n_widgets / 2; i++)
+    {
+      GtkWidget *label, *button;
+      char *text;
+
+      text = g_strdup_printf ("Field %d", i);
+      label = gtk_label_new (text);
+      g_free (text);
+      gtk_widget_set_parent (label, form);
+
+      button = gtk_button_new_with_label ("Value");
+      gtk_widget_set_parent (button, form);
+
+      add_constraint (layout, label, GTK_CONSTRAINT_ATTRIBUTE_START,
+                      GTK_CONSTRAINT_RELATION_EQ,
+                      NULL, GTK_CONSTRAINT_ATTRIBUTE_START, 8);
+      add_constraint (layout, button, GTK_CONSTRAINT_ATTRIBUTE_START,
+                      GTK_CONSTRAINT_RELATION_EQ,
+                      label, GTK_CONSTRAINT_ATTRIBUTE_END, 12);
+      add_constraint (layout, button, GTK_CONSTRAINT_ATTRIBUTE_END,
+                      GTK_CONSTRAINT_RELATION_EQ,
+                      NULL, GTK_CONSTRAINT_ATTRIBUTE_END, -8);
+      add_constraint (layout, button, GTK_CONSTRAINT_ATTRIBUTE_TOP,
+                      GTK_CONSTRAINT_RELATION_EQ,
+                      label, GTK_CONSTRAINT_ATTRIBUTE_TOP, 0);
+      n_constraints += 4;
+
+      if (prev_label == NULL)
+        {
+          add_constraint (layout, label, GTK_CONSTRAINT_ATTRIBUTE_TOP,
+                          GTK_CONSTRAINT_RELATION_EQ,
+                          NULL, GTK_CONSTRAINT_ATTRIBUTE_TOP, 8);
+          n_constraints += 1;
+
+          first_label = label;
+        }
+      else
+        {
+          /* Keep the labels in one column of the same width */
+          add_constraint (layout, label, GTK_CONSTRAINT_ATTRIBUTE_TOP,
+                          GTK_CONSTRAINT_RELATION_EQ,
+                          prev_label, GTK_CONSTRAINT_ATTRIBUTE_BOTTOM, 6);
+          add_constraint (layout, label, GTK_CONSTRAINT_ATTRIBUTE_WIDTH,
+                          GTK_CONSTRAINT_RELATION_EQ,
+                          first_label, GTK_CONSTRAINT_ATTRIBUTE_WIDTH, 0);
+          n_constraints += 2;
+        }
+
+      prev_label = label;
+    }
+
+  if (prev_label != NULL)
+    {
+      add_constraint (layout, prev_label, GTK_CONSTRAINT_ATTRIBUTE_BOTTOM,
+                      GTK_CONSTRAINT_RELATION_LE,
+                      NULL, GTK_CONSTRAINT_ATTRIBUTE_BOTTOM, -8);
+      n_constraints += 1;
+    }
+
+  g_print ("add constraints:  %8.2f msec (%d widgets, %d constraints)\n",
+           g_timer_elapsed (timer, NULL) * 1000,
+           (n_widgets / 2) * 2, n_constraints);
+}
+
+static void
+time_resize (GtkWidget *form,
+             GTimer    *timer,
+             gboolean   measure)
+{
+  int min_width, min_height;
+  int i;
+
+  gtk_widget_measure (form, GTK_ORIENTATION_HORIZONTAL, -1, &min_width, NULL, NULL, NULL);
+  gtk_widget_measure (form, GTK_ORIENTATION_VERTICAL, -1, &min_height, NULL, NULL, NULL);
+
+  /* Get the first allocation out of the way */
+  gtk_widget_size_allocate (form,
+                            &(GtkAllocation) { 0, 0, min_width, min_height },
+                            -1);
+
+  g_timer_start (timer);
+
+  for (i = 0; i < n_resizes; i++)
+    {
+      int width = min_width + 1 + (i % 100) * 4;
+
+      if (measure)
+        {
+          /* What happens when the layout gets asked for its height
+           * for every new width, like in a height-for-width parent
+           */
+          gtk_widget_measure (form, GTK_ORIENTATION_VERTICAL, width, NULL, NULL, NULL, NULL);
+          gtk_widget_measure (form, GTK_ORIENTATION_HORIZONTAL, -1, NULL, NULL, NULL, NULL);
+        }
+
+      gtk_widget_size_allocate (form,
+                                &(GtkAllocation) { 0, 0, width, min_height },
+                                -1);
+    }
+
+  g_print ("%s %8.2f msec (%.3f msec per resize)\n",
+           measure ? "measure+allocate:" : "allocate:        ",
+           g_timer_elapsed (timer, NULL) * 1000,
+           g_timer_elapsed (timer, NULL) * 1000 / MAX (n_resizes, 1));
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GtkWidget *window, *form;
+  GError *error = NULL;
+  GTimer *timer;
+
+  context = g_option_context_new ("");
+  g_option_context_add_main_entries (context, options, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  timer = g_timer_new ();
+
+  /* The layout needs to be rooted to have a solver */
+  window = gtk_window_new ();
+  form = g_object_new (FORM_TYPE_WIDGET, NULL);
+  gtk_window_set_child (GTK_WINDOW (window), form);
+
+  time_add_constraints (form, timer);
+  time_resize (form, timer, FALSE);
+  time_resize (form, timer, TRUE);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+  g_timer_destroy (timer);
+
+  return 0;
+}
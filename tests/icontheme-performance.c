@@ -0,0 +1,185 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+static char *theme_name = NULL;
+static int n_runs = 5;
+static int n_icons = 200;
+
+static GOptionEntry options[] = {
+  { "theme", 't', 0, G_OPTION_ARG_STRING, &theme_name, "Icon theme to load", "THEME" },
+  { "runs", 'r', 0, G_OPTION_ARG_INT, &n_runs, "Number of times to load the theme", "RUNS" },
+  { "icons", 'i', 0, G_OPTION_ARG_INT, &n_icons, "Number of icons to look up and draw", "ICONS" },
+  { NULL }
+};
+
+static GtkIconTheme *
+create_theme (void)
+{
+  GtkIconTheme *theme;
+
+  theme = gtk_icon_theme_new ();
+  if (theme_name)
+    gtk_icon_theme_set_theme_name (theme, theme_name);
+
+  return theme;
+}
+
+/* What an application pays before it can show its first icon */
+static void
+time_load (GTimer *timer)
+{
+  double total = 0;
+  int i;
+
+  for (i = 0; i < n_runs; i++)
+    {
+      GtkIconTheme *theme;
+
+      g_timer_start (timer);
+
+      theme = create_theme ();
+      gtk_icon_theme_has_icon (theme, "image-missing");
+
+      total += g_timer_elapsed (timer, NULL);
+
+      g_object_unref (theme);
+    }
+
+  g_print ("load theme:        %8.2f msec per load\n",
+           total * 1000 / MAX (n_runs, 1));
+}
+
+static GPtrArray *
+get_icon_names (GtkIconTheme *theme,
+                gboolean      symbolic)
+{
+  GPtrArray *names;
+  char **all;
+  int i;
+
+  names = g_ptr_array_new_with_free_func (g_free);
+
+  all = gtk_icon_theme_get_icon_names (theme);
+  for (i = 0; all[i] && names->len < n_icons; i++)
+    {
+      if (g_str_has_suffix (all[i], "-symbolic") == symbolic)
+        g_ptr_array_add (names, g_strdup (all[i]));
+    }
+  g_strfreev (all);
+
+  return names;
+}
+
+static void
+time_lookup (GtkIconTheme *theme,
+             GTimer       *timer)
+{
+  GPtrArray *names;
+  guint i;
+
+  names = get_icon_names (theme, FALSE);
+
+  g_timer_start (timer);
+
+  for (i = 0; i < names->len; i++)
+    {
+      GtkIconPaintable *icon;
+
+      icon = gtk_icon_theme_lookup_icon (theme, g_ptr_array_index (names, i), NULL,
+                                         32, 1, GTK_TEXT_DIR_NONE, 0);
+      g_object_unref (icon);
+    }
+
+  g_print ("lookup:            %8.2f msec (%.3f msec per icon, %u icons)\n",
+           g_timer_elapsed (timer, NULL) * 1000,
+           g_timer_elapsed (timer, NULL) * 1000 / MAX (names->len, 1),
+           names->len);
+
+  g_ptr_array_unref (names);
+}
+
+/* Looks up and draws symbolic icons, the way widgets do when they
+ * are shown for the first time. Drawing them again at another size
+ * finds the sources that were loaded for the first size.
+ */
+static void
+time_first_paint (GtkIconTheme *theme,
+                  GTimer       *timer,
+                  int           size)
+{
+  const GdkRGBA colors[4] = {
+    { 0.2, 0.2, 0.2, 1.0 },
+    { 0.8, 0.1, 0.1, 1.0 },
+    { 0.9, 0.6, 0.1, 1.0 },
+    { 0.2, 0.7, 0.2, 1.0 },
+  };
+  GPtrArray *names;
+  guint i;
+
+  names = get_icon_names (theme, TRUE);
+
+  g_timer_start (timer);
+
+  for (i = 0; i < names->len; i++)
+    {
+      GtkIconPaintable *icon;
+      GtkSnapshot *snapshot;
+      GskRenderNode *node;
+
+      icon = gtk_icon_theme_lookup_icon (theme, g_ptr_array_index (names, i), NULL,
+                                         size, 1, GTK_TEXT_DIR_NONE, 0);
+
+      snapshot = gtk_snapshot_new ();
+      gtk_symbolic_paintable_snapshot_symbolic (GTK_SYMBOLIC_PAINTABLE (icon),
+                                                snapshot, size, size,
+                                                colors, G_N_ELEMENTS (colors));
+      node = gtk_snapshot_free_to_node (snapshot);
+
+      g_clear_pointer (&node, gsk_render_node_unref);
+      g_object_unref (icon);
+    }
+
+  g_print ("first paint at %2d: %8.2f msec (%.3f msec per icon, %u icons)\n",
+           size,
+           g_timer_elapsed (timer, NULL) * 1000,
+           g_timer_elapsed (timer, NULL) * 1000 / MAX (names->len, 1),
+           names->len);
+
+  g_ptr_array_unref (names);
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GtkIconTheme *theme;
+  GError *error = NULL;
+  GTimer *timer;
+
+  context = g_option_context_new ("");
+  g_option_context_add_main_entries (context, options, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  timer = g_timer_new ();
+
+  time_load (timer);
+
+  theme = create_theme ();
+  time_lookup (theme, timer);
+  time_first_paint (theme, timer, 16);
+  time_first_paint (theme, timer, 24);
+  g_object_unref (theme);
+
+  g_timer_destroy (timer);
+  g_free (theme_name);
+
+  return 0;
+}
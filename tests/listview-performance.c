@@ -0,0 +1,310 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+#include <math.h>
+
+#include "frame-stats.h"
+
+static int n_rows = 10000000;
+static int n_jumps = 20;
+static double scroll_time = 10;
+static gboolean fixed_height = FALSE;
+static gboolean column_view = FALSE;
+static gboolean deferred_binding = FALSE;
+static int bind_time = 0;
+
+static GOptionEntry options[] = {
+  { "rows", 'r', 0, G_OPTION_ARG_INT, &n_rows, "Number of rows in the model", "ROWS" },
+  { "jumps", 'j', 0, G_OPTION_ARG_INT, &n_jumps, "Number of jumps between start and end", "JUMPS" },
+  { "scroll-time", 't', 0, G_OPTION_ARG_DOUBLE, &scroll_time, "Seconds to scroll for", "SECONDS" },
+  { "fixed-height", 'f', 0, G_OPTION_ARG_NONE, &fixed_height, "Enable fixed height mode", NULL },
+  { "column-view", 'c', 0, G_OPTION_ARG_NONE, &column_view, "Use a GtkColumnView", NULL },
+  { "deferred-binding", 'd', 0, G_OPTION_ARG_NONE, &deferred_binding, "Bind rows in the background", NULL },
+  { "bind-time", 'b', 0, G_OPTION_ARG_INT, &bind_time, "Microseconds each bind takes", "USEC" },
+  { NULL }
+};
+
+/* A model that creates its items on demand, so that
+ * millions of rows don't need millions of objects
+ */
+typedef struct
+{
+  GObject parent;
+  guint n_items;
+} RowModel;
+
+typedef GObjectClass RowModelClass;
+
+static GType row_model_get_type (void);
+
+static GType
+row_model_get_item_type (GListModel *list)
+{
+  return GTK_TYPE_STRING_OBJECT;
+}
+
+static guint
+row_model_get_n_items (GListModel *list)
+{
+  return ((RowModel *) list)->n_items;
+}
+
+static gpointer
+row_model_get_item (GListModel *list,
+                    guint       position)
+{
+  GtkStringObject *item;
+  char *text;
+
+  if (position >= ((RowModel *) list)->n_items)
+    return NULL;
+
+  text = g_strdup_printf ("Log entry %u: nothing to see here", position);
+  item = gtk_string_object_new (text);
+  g_free (text);
+
+  return item;
+}
+
+static void
+row_model_list_model_init (GListModelInterface *iface)
+{
+  iface->get_item_type = row_model_get_item_type;
+  iface->get_n_items = row_model_get_n_items;
+  iface->get_item = row_model_get_item;
+}
+
+G_DEFINE_TYPE_WITH_CODE (RowModel, row_model, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, row_model_list_model_init))
+
+static void
+row_model_init (RowModel *self) {}
+
+static void
+row_model_class_init (RowModelClass *class) {}
+
+static void
+setup_cb (GtkSignalListItemFactory *factory,
+          GObject                  *list_item)
+{
+  GtkWidget *label = gtk_label_new (NULL);
+
+  gtk_label_set_xalign (GTK_LABEL (label), 0);
+  g_object_set (list_item, "child", label, NULL);
+}
+
+static void
+bind_cb (GtkSignalListItemFactory *factory,
+         GObject                  *list_item)
+{
+  GtkWidget *label;
+  GtkStringObject *item;
+
+  g_object_get (list_item, "child", &label, "item", &item, NULL);
+
+  /* Pretend to do something expensive, like loading a thumbnail */
+  if (bind_time > 0)
+    {
+      gint64 end = g_get_monotonic_time () + bind_time;
+      while (g_get_monotonic_time () < end)
+        ;
+    }
+
+  gtk_label_set_label (GTK_LABEL (label), gtk_string_object_get_string (item));
+  g_object_unref (label);
+  g_object_unref (item);
+}
+
+static GtkWidget *
+create_view (void)
+{
+  GtkSelectionModel *model;
+  GtkListItemFactory *factory;
+  RowModel *rows;
+
+  rows = g_object_new (row_model_get_type (), NULL);
+  rows->n_items = n_rows;
+  model = GTK_SELECTION_MODEL (gtk_no_selection_new (G_LIST_MODEL (rows)));
+
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_cb), NULL);
+  g_signal_connect (factory, "bind", G_CALLBACK (bind_cb), NULL);
+
+  if (column_view)
+    {
+      GtkWidget *view;
+      GtkColumnViewColumn *column;
+      int i;
+
+      view = gtk_column_view_new (model);
+      gtk_column_view_set_fixed_height_mode (GTK_COLUMN_VIEW (view), fixed_height);
+      gtk_column_view_set_deferred_binding (GTK_COLUMN_VIEW (view), deferred_binding);
+
+      for (i = 0; i < 3; i++)
+        {
+          column = gtk_column_view_column_new ("Column", g_object_ref (factory));
+          gtk_column_view_append_column (GTK_COLUMN_VIEW (view), column);
+          g_object_unref (column);
+        }
+      g_object_unref (factory);
+
+      return view;
+    }
+  else
+    {
+      GtkWidget *view;
+
+      view = gtk_list_view_new (model, factory);
+      gtk_list_view_set_fixed_height_mode (GTK_LIST_VIEW (view), fixed_height);
+      gtk_list_view_set_deferred_binding (GTK_LIST_VIEW (view), deferred_binding);
+
+      return view;
+    }
+}
+
+static void
+scroll_to (GtkWidget *view,
+           guint      pos)
+{
+  if (GTK_IS_COLUMN_VIEW (view))
+    gtk_column_view_scroll_to (GTK_COLUMN_VIEW (view), pos, NULL, GTK_LIST_SCROLL_NONE, NULL);
+  else
+    gtk_list_view_scroll_to (GTK_LIST_VIEW (view), pos, GTK_LIST_SCROLL_NONE, NULL);
+}
+
+static void
+after_paint_cb (GdkFrameClock *clock,
+                gpointer       data)
+{
+  gboolean *painted = data;
+
+  *painted = TRUE;
+}
+
+static void
+wait_for_paint (GtkWidget *widget)
+{
+  GdkFrameClock *clock = gtk_widget_get_frame_clock (widget);
+  gboolean painted = FALSE;
+  gulong id;
+
+  id = g_signal_connect (clock, "after-paint", G_CALLBACK (after_paint_cb), &painted);
+  gtk_widget_queue_draw (widget);
+
+  while (!painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (clock, id);
+}
+
+static void
+time_jumps (GtkWidget *view)
+{
+  GTimer *timer;
+  double total = 0, worst = 0;
+  int i;
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_jumps; i++)
+    {
+      double elapsed;
+
+      g_timer_start (timer);
+      scroll_to (view, i % 2 ? 0 : n_rows - 1);
+      wait_for_paint (view);
+      elapsed = g_timer_elapsed (timer, NULL);
+
+      total += elapsed;
+      worst = MAX (worst, elapsed);
+    }
+
+  g_print ("jump to end: %8.2f msec average, %8.2f msec worst\n",
+           total / n_jumps * 1000, worst * 1000);
+
+  g_timer_destroy (timer);
+}
+
+static gboolean
+scroll_cb (GtkWidget     *view,
+           GdkFrameClock *frame_clock,
+           gpointer       user_data)
+{
+  gboolean *done = user_data;
+  static gint64 start_time;
+  gint64 now = gdk_frame_clock_get_frame_time (frame_clock);
+  GtkAdjustment *vadjustment;
+  double elapsed, upper, page_size;
+
+  if (start_time == 0)
+    start_time = now;
+
+  elapsed = (now - start_time) / 1000000.;
+  if (elapsed > scroll_time)
+    {
+      *done = TRUE;
+      g_main_context_wakeup (NULL);
+      return G_SOURCE_REMOVE;
+    }
+
+  /* Scroll a few screens up and down around the middle of the list */
+  vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (view));
+  upper = gtk_adjustment_get_upper (vadjustment);
+  page_size = gtk_adjustment_get_page_size (vadjustment);
+  gtk_adjustment_set_value (vadjustment,
+                            (upper - page_size) / 2 + 20 * page_size * sin (elapsed));
+
+  return G_SOURCE_CONTINUE;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GtkWidget *window, *sw, *view;
+  GError *error = NULL;
+  gboolean done = FALSE;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  frame_stats_add_options (g_option_context_get_main_group (context));
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  window = gtk_window_new ();
+  frame_stats_ensure (GTK_WINDOW (window));
+  gtk_window_set_default_size (GTK_WINDOW (window), 800, 600);
+
+  sw = gtk_scrolled_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), sw);
+
+  view = create_view ();
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), view);
+
+  gtk_window_present (GTK_WINDOW (window));
+  wait_for_paint (view);
+
+  g_print ("%d rows, %s, fixed height mode %s, deferred binding %s\n",
+           n_rows,
+           column_view ? "GtkColumnView" : "GtkListView",
+           fixed_height ? "on" : "off",
+           deferred_binding ? "on" : "off");
+
+  time_jumps (view);
+
+  gtk_widget_add_tick_callback (view, scroll_cb, &done, NULL);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+
+  return 0;
+}
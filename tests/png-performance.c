@@ -0,0 +1,113 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+static int width = 3840;
+static int height = 2160;
+static int n_runs = 5;
+
+static GOptionEntry options[] = {
+  { "width", 0, 0, G_OPTION_ARG_INT, &width, "Width of the image", "WIDTH" },
+  { "height", 0, 0, G_OPTION_ARG_INT, &height, "Height of the image", "HEIGHT" },
+  { "runs", 'r', 0, G_OPTION_ARG_INT, &n_runs, "Number of times to save each image", "RUNS" },
+  { NULL }
+};
+
+/* Something that compresses about as well as a screenshot:
+ * gradients with some noise
+ */
+static GdkTexture *
+create_texture (GdkMemoryFormat format,
+                gsize           bpp)
+{
+  GdkTexture *texture;
+  GBytes *bytes;
+  guchar *data;
+  gsize stride;
+  int x, y;
+  gsize i;
+
+  stride = width * bpp;
+  data = g_malloc (stride * height);
+
+  for (y = 0; y < height; y++)
+    for (x = 0; x < width; x++)
+      for (i = 0; i < bpp; i++)
+        data[y * stride + x * bpp + i] = (x + y * (i + 1)) / 8 + g_random_int_range (0, 3);
+
+  bytes = g_bytes_new_take (data, stride * height);
+  texture = gdk_memory_texture_new (width, height, format, bytes, stride);
+  g_bytes_unref (bytes);
+
+  return texture;
+}
+
+static void
+time_save (GdkTexture *texture,
+           const char *name,
+           int         level)
+{
+  GTimer *timer;
+  gsize size = 0;
+  int i;
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_runs; i++)
+    {
+      GBytes *bytes;
+
+      bytes = gdk_texture_save_to_png_bytes_with_compression (texture, level);
+      size = g_bytes_get_size (bytes);
+      g_bytes_unref (bytes);
+    }
+
+  g_print ("%-8s level %2d: %8.2f msec per save, %6.2f MB\n",
+           name, level,
+           g_timer_elapsed (timer, NULL) * 1000 / MAX (n_runs, 1),
+           size / 1000000.0);
+
+  g_timer_destroy (timer);
+}
+
+int
+main (int argc, char **argv)
+{
+  const struct {
+    const char *name;
+    GdkMemoryFormat format;
+    gsize bpp;
+  } formats[] = {
+    { "8-bit", GDK_MEMORY_R8G8B8A8, 4 },
+    { "16-bit", GDK_MEMORY_R16G16B16A16, 8 },
+  };
+  const int levels[] = { -1, 0, 1, 9 };
+  GOptionContext *context;
+  GError *error = NULL;
+  gsize i, j;
+
+  context = g_option_context_new ("");
+  g_option_context_add_main_entries (context, options, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  g_print ("%dx%d, %u processors\n", width, height, g_get_num_processors ());
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++)
+    {
+      GdkTexture *texture = create_texture (formats[i].format, formats[i].bpp);
+
+      for (j = 0; j < G_N_ELEMENTS (levels); j++)
+        time_save (texture, formats[i].name, levels[j]);
+
+      g_object_unref (texture);
+    }
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+#include <math.h>
+
+static char *theme_name = NULL;
+static int n_frames = 20;
+static int n_icons = 30;
+
+static GOptionEntry options[] = {
+  { "theme", 't', 0, G_OPTION_ARG_STRING, &theme_name, "Icon theme to load", "THEME" },
+  { "frames", 'f', 0, G_OPTION_ARG_INT, &n_frames, "Number of frames to draw per scale", "FRAMES" },
+  { "icons", 'i', 0, G_OPTION_ARG_INT, &n_icons, "Number of icons in the toolbar", "ICONS" },
+  { NULL }
+};
+
+static const GdkRGBA colors[4] = {
+  { 0.2, 0.2, 0.2, 1.0 },
+  { 0.8, 0.1, 0.1, 1.0 },
+  { 0.9, 0.6, 0.1, 1.0 },
+  { 0.2, 0.7, 0.2, 1.0 },
+};
+
+static GPtrArray *
+get_icon_names (GtkIconTheme *theme)
+{
+  GPtrArray *names;
+  char **all;
+  int i;
+
+  names = g_ptr_array_new_with_free_func (g_free);
+
+  all = gtk_icon_theme_get_icon_names (theme);
+  for (i = 0; all[i] && names->len < n_icons; i++)
+    {
+      if (g_str_has_suffix (all[i], "-symbolic"))
+        g_ptr_array_add (names, g_strdup (all[i]));
+    }
+  g_strfreev (all);
+
+  return names;
+}
+
+/* Draws a row of symbolic icons the way a toolbar does, with the
+ * hover color of one of the buttons changing every frame.
+ */
+static void
+snapshot_toolbar (GtkIconTheme *theme,
+                  GPtrArray    *names,
+                  int           size,
+                  int           frame)
+{
+  GtkSnapshot *snapshot;
+  GskRenderNode *node;
+  guint i;
+
+  snapshot = gtk_snapshot_new ();
+
+  for (i = 0; i < names->len; i++)
+    {
+      GtkIconPaintable *icon;
+      GdkRGBA fg[4];
+
+      memcpy (fg, colors, sizeof (colors));
+      if (i == frame % names->len)
+        fg[0].alpha = 0.5;
+
+      icon = gtk_icon_theme_lookup_icon (theme, g_ptr_array_index (names, i), NULL,
+                                         size, 1, GTK_TEXT_DIR_NONE, 0);
+
+      gtk_snapshot_save (snapshot);
+      gtk_snapshot_translate (snapshot, &GRAPHENE_POINT_INIT (i * (size + 12), 0));
+      gtk_symbolic_paintable_snapshot_symbolic (GTK_SYMBOLIC_PAINTABLE (icon),
+                                                snapshot, size, size,
+                                                fg, G_N_ELEMENTS (fg));
+      gtk_snapshot_restore (snapshot);
+
+      g_object_unref (icon);
+    }
+
+  node = gtk_snapshot_free_to_node (snapshot);
+  g_clear_pointer (&node, gsk_render_node_unref);
+}
+
+/* Changing the text scale looks up every icon of the toolbar at a
+ * new size, most of which are not in the icon theme.
+ */
+static void
+time_scale (GtkIconTheme *theme,
+            GPtrArray    *names,
+            GTimer       *timer,
+            double        scale)
+{
+  int size;
+  double first;
+  int i;
+
+  size = round (16 * scale);
+
+  g_timer_start (timer);
+  snapshot_toolbar (theme, names, size, 0);
+  first = g_timer_elapsed (timer, NULL);
+
+  g_timer_start (timer);
+  for (i = 1; i <= n_frames; i++)
+    snapshot_toolbar (theme, names, size, i);
+
+  g_print ("scale %.2f: first frame %8.2f msec, then %8.3f msec per frame (%u icons)\n",
+           scale,
+           first * 1000,
+           g_timer_elapsed (timer, NULL) * 1000 / MAX (n_frames, 1),
+           names->len);
+}
+
+int
+main (int argc, char **argv)
+{
+  const double scales[] = { 1, 1.25, 1.5, 2, 1 };
+  GOptionContext *context;
+  GtkIconTheme *theme;
+  GPtrArray *names;
+  GError *error = NULL;
+  GTimer *timer;
+  guint i;
+
+  context = g_option_context_new ("");
+  g_option_context_add_main_entries (context, options, NULL);
+  g_option_context_set_summary (context,
+                                "Set GTK_SYMBOLIC_PATHS=0 to compare with icons drawn from textures.");
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  theme = gtk_icon_theme_new ();
+  if (theme_name)
+    gtk_icon_theme_set_theme_name (theme, theme_name);
+
+  names = get_icon_names (theme);
+  timer = g_timer_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (scales); i++)
+    time_scale (theme, names, timer, scales[i]);
+
+  g_timer_destroy (timer);
+  g_ptr_array_unref (names);
+  g_object_unref (theme);
+  g_free (theme_name);
+
+  return 0;
+}
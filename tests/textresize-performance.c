@@ -0,0 +1,116 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+static int n_lines = 2000;
+static int n_resizes = 200;
+
+static GOptionEntry options[] = {
+  { "lines", 'l', 0, G_OPTION_ARG_INT, &n_lines, "Number of paragraphs in the buffer", "LINES" },
+  { "resizes", 'r', 0, G_OPTION_ARG_INT, &n_resizes, "Number of resizes to time", "RESIZES" },
+  { NULL }
+};
+
+static void
+fill_buffer (GtkTextBuffer *buffer)
+{
+  GString *text;
+  int i;
+
+  text = g_string_new (NULL);
+  for (i = 0; i < n_lines; i++)
+    g_string_append_printf (text,
+                            "%d: Nel mezzo del cammin di nostra vita mi ritrovai per una selva oscura, "
+                            "ché la diritta via era smarrita. Ahi quanto a dir qual era è cosa dura "
+                            "esta selva selvaggia e aspra e forte che nel pensier rinova la paura!\n",
+                            i);
+  gtk_text_buffer_set_text (buffer, text->str, text->len);
+  g_string_free (text, TRUE);
+}
+
+/* Resizes the view like a live resize does, allocating it and
+ * drawing it at each new width. With @restyle, the cached line
+ * displays are dropped before each resize, which is what every
+ * width change used to cost.
+ */
+static void
+time_resize (GtkWidget *window,
+             GtkWidget *scrolled,
+             GtkWidget *view,
+             GTimer    *timer,
+             gboolean   restyle)
+{
+  int i;
+
+  g_timer_start (timer);
+
+  for (i = 0; i < n_resizes; i++)
+    {
+      GtkSnapshot *snapshot;
+      GskRenderNode *node;
+      int width = 600 - (i % 2) * 40;
+
+      if (restyle)
+        gtk_text_view_set_left_margin (GTK_TEXT_VIEW (view), i % 2);
+
+      gtk_widget_measure (scrolled, GTK_ORIENTATION_HORIZONTAL, -1, NULL, NULL, NULL, NULL);
+      gtk_widget_measure (scrolled, GTK_ORIENTATION_VERTICAL, width, NULL, NULL, NULL, NULL);
+      gtk_widget_size_allocate (scrolled, &(GtkAllocation) { 0, 0, width, 800 }, -1);
+
+      snapshot = gtk_snapshot_new ();
+      gtk_widget_snapshot_child (window, scrolled, snapshot);
+      node = gtk_snapshot_free_to_node (snapshot);
+      g_clear_pointer (&node, gsk_render_node_unref);
+    }
+
+  g_print ("%s %8.2f msec (%.3f msec per resize)\n",
+           restyle ? "rebuild + resize:" : "resize:          ",
+           g_timer_elapsed (timer, NULL) * 1000,
+           g_timer_elapsed (timer, NULL) * 1000 / MAX (n_resizes, 1));
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GtkWidget *window, *scrolled, *view;
+  GError *error = NULL;
+  GTimer *timer;
+
+  context = g_option_context_new ("");
+  g_option_context_add_main_entries (context, options, NULL);
+  g_option_context_set_summary (context,
+                                "Compares resizing a wrapped text view with keeping and with "
+                                "dropping its cached line displays.");
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 600, 800);
+  scrolled = gtk_scrolled_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), scrolled);
+  view = gtk_text_view_new ();
+  gtk_text_view_set_wrap_mode (GTK_TEXT_VIEW (view), GTK_WRAP_WORD_CHAR);
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (scrolled), view);
+  fill_buffer (gtk_text_view_get_buffer (GTK_TEXT_VIEW (view)));
+
+  gtk_window_present (GTK_WINDOW (window));
+  while (!gtk_widget_get_mapped (view))
+    g_main_context_iteration (NULL, TRUE);
+
+  timer = g_timer_new ();
+
+  time_resize (window, scrolled, view, timer, FALSE);
+  time_resize (window, scrolled, view, timer, TRUE);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+  g_timer_destroy (timer);
+
+  return 0;
+}
@@ -0,0 +1,169 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+static int n_lines = 100000;
+static int n_tags = 500;
+
+static GOptionEntry options[] = {
+  { "lines", 'l', 0, G_OPTION_ARG_INT, &n_lines, "Number of lines in the buffer", "LINES" },
+  { "tags", 't', 0, G_OPTION_ARG_INT, &n_tags, "Number of tags to apply", "TAGS" },
+  { NULL }
+};
+
+static GtkTextBuffer *
+create_buffer (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextIter start, end;
+  GString *text;
+  GRand *rand;
+  int i;
+
+  buffer = gtk_text_buffer_new (NULL);
+
+  text = g_string_new (NULL);
+  for (i = 0; i < n_lines; i++)
+    g_string_append_printf (text, "Line %d of some text with a few words in it\n", i);
+  gtk_text_buffer_set_text (buffer, text->str, text->len);
+  g_string_free (text, TRUE);
+
+  rand = g_rand_new_with_seed (42);
+
+  for (i = 0; i < n_tags; i++)
+    {
+      GtkTextTag *tag;
+      char *name;
+      int j;
+
+      name = g_strdup_printf ("tag%d", i);
+      if (i % 50 == 0)
+        tag = gtk_text_buffer_create_tag (buffer, name, "invisible", FALSE, NULL);
+      else
+        tag = gtk_text_buffer_create_tag (buffer, name, "weight", 400 + (i % 5) * 100, NULL);
+      g_free (name);
+
+      /* Each tag covers a handful of short ranges all over the buffer */
+      for (j = 0; j < 10; j++)
+        {
+          int line = g_rand_int_range (rand, 0, n_lines);
+
+          gtk_text_buffer_get_iter_at_line_offset (buffer, &start, line, g_rand_int_range (rand, 0, 10));
+          end = start;
+          gtk_text_iter_forward_lines (&end, g_rand_int_range (rand, 0, 20));
+          gtk_text_iter_forward_chars (&end, g_rand_int_range (rand, 1, 30));
+          gtk_text_buffer_apply_tag (buffer, tag, &start, &end);
+        }
+    }
+
+  g_rand_free (rand);
+
+  return buffer;
+}
+
+static void
+time_get_tags (GtkTextBuffer *buffer,
+               GTimer        *timer)
+{
+  GtkTextIter iter;
+  guint n_found = 0;
+  int i;
+
+  g_timer_start (timer);
+
+  for (i = 0; i < n_lines; i++)
+    {
+      GSList *tags;
+
+      gtk_text_buffer_get_iter_at_line_offset (buffer, &iter, i, 5);
+      tags = gtk_text_iter_get_tags (&iter);
+      n_found += g_slist_length (tags);
+      g_slist_free (tags);
+    }
+
+  g_print ("get_tags:        %8.2f msec (%u tags found)\n",
+           g_timer_elapsed (timer, NULL) * 1000, n_found);
+}
+
+static void
+time_invisible (GtkTextBuffer *buffer,
+                GTimer        *timer)
+{
+  GtkTextIter iter;
+  guint n_visible = 0;
+  int i;
+
+  g_timer_start (timer);
+
+  for (i = 0; i < n_lines; i++)
+    {
+      gtk_text_buffer_get_iter_at_line_offset (buffer, &iter, i, 5);
+      if (gtk_text_iter_is_cursor_position (&iter) && gtk_text_iter_forward_visible_cursor_position (&iter))
+        n_visible++;
+    }
+
+  g_print ("visibility:      %8.2f msec (%u visible)\n",
+           g_timer_elapsed (timer, NULL) * 1000, n_visible);
+}
+
+static void
+time_toggles (GtkTextBuffer *buffer,
+              GTimer        *timer)
+{
+  GtkTextIter iter;
+  guint n_toggles = 0;
+
+  g_timer_start (timer);
+
+  gtk_text_buffer_get_start_iter (buffer, &iter);
+  while (gtk_text_iter_forward_to_tag_toggle (&iter, NULL))
+    n_toggles++;
+
+  g_print ("forward toggles: %8.2f msec (%u toggles)\n",
+           g_timer_elapsed (timer, NULL) * 1000, n_toggles);
+
+  n_toggles = 0;
+  g_timer_start (timer);
+
+  gtk_text_buffer_get_end_iter (buffer, &iter);
+  while (gtk_text_iter_backward_to_tag_toggle (&iter, NULL))
+    n_toggles++;
+
+  g_print ("backward toggles:%8.2f msec (%u toggles)\n",
+           g_timer_elapsed (timer, NULL) * 1000, n_toggles);
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GtkTextBuffer *buffer;
+  GError *error = NULL;
+  GTimer *timer;
+
+  context = g_option_context_new ("");
+  g_option_context_add_main_entries (context, options, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  timer = g_timer_new ();
+
+  buffer = create_buffer ();
+  g_print ("Created buffer with %d lines and %d tags in %.2f msec\n",
+           n_lines, n_tags, g_timer_elapsed (timer, NULL) * 1000);
+
+  time_get_tags (buffer, timer);
+  time_invisible (buffer, timer);
+  time_toggles (buffer, timer);
+
+  g_object_unref (buffer);
+  g_timer_destroy (timer);
+
+  return 0;
+}
@@ -0,0 +1,548 @@
+#include <gtk/gtk.h>
+
+#include "gtk/gtkaccessibletextprivate.h"
+#include "gtk/gtktextpagesprivate.h"
+#include "gtk/a11y/gtkatspicontextprivate.h"
+
+static int n_lines = 10000;
+
+static GtkWidget *
+create_text_view (GString **contents)
+{
+  GtkWidget *view;
+  GtkTextBuffer *buffer;
+  GString *text;
+  int i;
+
+  text = g_string_new (NULL);
+  for (i = 0; i < n_lines; i++)
+    g_string_append_printf (text, "Line %d with ünïcödé in it\n", i);
+
+  view = g_object_ref_sink (gtk_text_view_new ());
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (view));
+  gtk_text_buffer_set_text (buffer, text->str, text->len);
+
+  *contents = text;
+
+  return view;
+}
+
+static char *
+get_text (GtkTextView *view,
+          int          start,
+          int          end)
+{
+  GBytes *contents;
+  char *text;
+
+  contents = gtk_accessible_text_get_contents (GTK_ACCESSIBLE_TEXT (view), start, end < 0 ? G_MAXUINT : end);
+  text = g_strdup (g_bytes_get_data (contents, NULL));
+  g_bytes_unref (contents);
+
+  return text;
+}
+
+static char *
+get_expected (GtkTextView *view,
+              int          start,
+              int          end)
+{
+  GtkTextBuffer *buffer = gtk_text_view_get_buffer (view);
+  GtkTextIter start_iter, end_iter;
+
+  gtk_text_buffer_get_iter_at_offset (buffer, &start_iter, start);
+  gtk_text_buffer_get_iter_at_offset (buffer, &end_iter, end);
+
+  return gtk_text_buffer_get_text (buffer, &start_iter, &end_iter, FALSE);
+}
+
+static void
+check_range (GtkTextView *view,
+             int          start,
+             int          end)
+{
+  char *text, *expected;
+
+  text = get_text (view, start, end);
+  expected = get_expected (view, start, end < 0 ? G_MAXINT : end);
+  g_assert_cmpstr (text, ==, expected);
+  g_free (text);
+  g_free (expected);
+}
+
+static void
+atspitext_ranges (void)
+{
+  GtkWidget *view;
+  GtkTextBuffer *buffer;
+  GString *contents;
+  char *text;
+  guint n_hits, n_misses, n_hits_before, n_misses_before;
+
+  view = create_text_view (&contents);
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (view));
+
+  text = get_text (GTK_TEXT_VIEW (view), 0, -1);
+  g_assert_cmpstr (text, ==, contents->str);
+  g_free (text);
+
+  /* Asking again is served from the cached pages */
+  gtk_text_pages_get_stats (buffer, &n_hits_before, &n_misses_before);
+  text = get_text (GTK_TEXT_VIEW (view), 0, -1);
+  g_assert_cmpstr (text, ==, contents->str);
+  g_free (text);
+  gtk_text_pages_get_stats (buffer, &n_hits, &n_misses);
+  g_assert_cmpuint (n_misses, ==, n_misses_before);
+  g_assert_cmpuint (n_hits, >, n_hits_before);
+
+  g_assert_cmpuint (gtk_accessible_text_get_character_count (GTK_ACCESSIBLE_TEXT (view)), ==,
+                    g_utf8_strlen (contents->str, -1));
+
+  check_range (GTK_TEXT_VIEW (view), 0, 0);
+  check_range (GTK_TEXT_VIEW (view), 0, 10);
+  check_range (GTK_TEXT_VIEW (view), 5, 5000);
+  check_range (GTK_TEXT_VIEW (view), 4000, 40000);
+  check_range (GTK_TEXT_VIEW (view), 100000, -1);
+
+  check_range (GTK_TEXT_VIEW (view), 200000, 200000);
+
+  g_string_free (contents, TRUE);
+  g_object_unref (view);
+}
+
+static void
+atspitext_edits (void)
+{
+  GtkWidget *view;
+  GtkTextBuffer *buffer;
+  GtkTextIter start, end;
+  GString *contents;
+  char *text, *expected;
+
+  view = create_text_view (&contents);
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (view));
+
+  /* Fill the cache, then change the buffer behind its back */
+  text = get_text (GTK_TEXT_VIEW (view), 0, -1);
+  g_free (text);
+
+  gtk_text_buffer_get_iter_at_line (buffer, &start, n_lines / 2);
+  gtk_text_buffer_insert (buffer, &start, "Inserted\n", -1);
+
+  gtk_text_buffer_get_iter_at_line (buffer, &start, 10);
+  gtk_text_buffer_get_iter_at_line (buffer, &end, 20);
+  gtk_text_buffer_delete (buffer, &start, &end);
+
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  expected = gtk_text_buffer_get_text (buffer, &start, &end, FALSE);
+  text = get_text (GTK_TEXT_VIEW (view), 0, -1);
+  g_assert_cmpstr (text, ==, expected);
+  g_free (text);
+  g_free (expected);
+
+  check_range (GTK_TEXT_VIEW (view), 1000, 300000);
+
+  g_string_free (contents, TRUE);
+  g_object_unref (view);
+}
+
+/* Invisible text is not part of the text, but it still counts
+ * for the offsets, and so for the length
+ */
+static void
+atspitext_invisible (void)
+{
+  GtkWidget *view;
+  GtkTextBuffer *buffer;
+  GtkTextTag *tag;
+  GdkPaintable *paintable;
+  GtkTextIter start, end;
+  GString *contents;
+  char *text, *expected;
+
+  view = create_text_view (&contents);
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (view));
+
+  /* Fill the cache, then change the text behind its back */
+  text = get_text (GTK_TEXT_VIEW (view), 0, -1);
+  g_free (text);
+
+  tag = gtk_text_buffer_create_tag (buffer, NULL, NULL);
+  gtk_text_buffer_get_iter_at_line (buffer, &start, 200);
+  gtk_text_buffer_get_iter_at_line (buffer, &end, 300);
+  gtk_text_buffer_apply_tag (buffer, tag, &start, &end);
+
+  paintable = gdk_paintable_new_empty (10, 10);
+  gtk_text_buffer_get_iter_at_line (buffer, &start, 500);
+  gtk_text_buffer_insert_paintable (buffer, &start, paintable);
+  g_object_unref (paintable);
+
+  text = get_text (GTK_TEXT_VIEW (view), 0, -1);
+  g_free (text);
+
+  g_object_set (tag, "invisible", TRUE, NULL);
+
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  expected = gtk_text_buffer_get_text (buffer, &start, &end, FALSE);
+  g_assert_cmpuint (strlen (expected), <, contents->len);
+
+  text = get_text (GTK_TEXT_VIEW (view), 0, -1);
+  g_assert_cmpstr (text, ==, expected);
+  g_assert_cmpuint (gtk_accessible_text_get_character_count (GTK_ACCESSIBLE_TEXT (view)), ==,
+                    gtk_text_buffer_get_char_count (buffer));
+  g_assert_cmpuint (g_utf8_strlen (text, -1), <,
+                    gtk_text_buffer_get_char_count (buffer));
+  g_free (text);
+  g_free (expected);
+
+  g_string_free (contents, TRUE);
+  g_object_unref (view);
+}
+
+/* Long ranges are returned in full */
+static void
+atspitext_long (void)
+{
+  GtkWidget *view;
+  GtkTextBuffer *buffer;
+  GString *contents;
+  char *text;
+
+  view = create_text_view (&contents);
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (view));
+
+  while (g_utf8_strlen (contents->str, contents->len) <= 1 << 20)
+    g_string_append (contents, contents->str);
+  gtk_text_buffer_set_text (buffer, contents->str, contents->len);
+
+  text = get_text (GTK_TEXT_VIEW (view), 0, -1);
+  g_assert_cmpstr (text, ==, contents->str);
+  g_free (text);
+
+  check_range (GTK_TEXT_VIEW (view), 1000, -1);
+
+  g_string_free (contents, TRUE);
+  g_object_unref (view);
+}
+
+static void
+atspitext_performance (void)
+{
+  GtkWidget *view;
+  GString *contents;
+  GTimer *timer;
+  double first, repeated;
+  int i;
+
+  if (!g_test_perf ())
+    {
+      g_test_skip ("Only run in performance mode");
+      return;
+    }
+
+  view = create_text_view (&contents);
+  timer = g_timer_new ();
+
+  g_free (get_text (GTK_TEXT_VIEW (view), 0, -1));
+  first = g_timer_elapsed (timer, NULL);
+
+  g_timer_start (timer);
+  for (i = 0; i < 100; i++)
+    g_free (get_text (GTK_TEXT_VIEW (view), 0, -1));
+  repeated = g_timer_elapsed (timer, NULL) / 100;
+
+  g_test_message ("Full text of %d lines: %.2f msec first, %.2f msec repeated",
+                  n_lines, first * 1000, repeated * 1000);
+  g_test_minimized_result (repeated, "%.2f msec per repeated GetText", repeated * 1000);
+
+  g_timer_destroy (timer);
+  g_string_free (contents, TRUE);
+  g_object_unref (view);
+}
+
+/* {{{ Mock AT-SPI bus */
+
+/* Stands in for the AT-SPI registry, which applications announce
+ * themselves to, and for a screen reader that reads their text
+ */
+typedef struct
+{
+  GTestDBus *bus;
+  GDBusConnection *connection;
+  GDBusNodeInfo *info;
+  char *app_name;
+} MockRegistry;
+
+static MockRegistry *registry;
+
+static const char registry_xml[] =
+  "<node>"
+  "  <interface name='org.a11y.atspi.Socket'>"
+  "    <method name='Embed'>"
+  "      <arg type='(so)' name='plug' direction='in'/>"
+  "      <arg type='(so)' name='socket' direction='out'/>"
+  "    </method>"
+  "  </interface>"
+  "</node>";
+
+static void
+registry_handle_method (GDBusConnection       *connection,
+                        const char            *sender,
+                        const char            *object_path,
+                        const char            *interface_name,
+                        const char            *method_name,
+                        GVariant              *parameters,
+                        GDBusMethodInvocation *invocation,
+                        gpointer               user_data)
+{
+  MockRegistry *self = user_data;
+  const char *name, *path;
+
+  g_variant_get (parameters, "((&s&o))", &name, &path);
+  g_free (self->app_name);
+  self->app_name = g_strdup (name);
+
+  g_dbus_method_invocation_return_value (invocation,
+                                         g_variant_new ("((so))",
+                                                        "org.a11y.atspi.Registry",
+                                                        "/org/a11y/atspi/accessible/root"));
+}
+
+static const GDBusInterfaceVTable registry_vtable = {
+  registry_handle_method,
+  NULL,
+  NULL,
+};
+
+/* Runs the registry on a private bus, and points the AT-SPI
+ * backend at it. Returns NULL if there is no bus daemon.
+ */
+static MockRegistry *
+mock_registry_new (void)
+{
+  MockRegistry *self;
+  char *daemon;
+  GVariant *reply;
+  GError *error = NULL;
+
+  daemon = g_find_program_in_path ("dbus-daemon");
+  if (daemon == NULL)
+    return NULL;
+  g_free (daemon);
+
+  self = g_new0 (MockRegistry, 1);
+  self->bus = g_test_dbus_new (G_TEST_DBUS_NONE);
+  g_test_dbus_up (self->bus);
+
+  self->connection =
+    g_dbus_connection_new_for_address_sync (g_test_dbus_get_bus_address (self->bus),
+                                            G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                                            G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+                                            NULL, NULL, &error);
+  g_assert_no_error (error);
+
+  reply = g_dbus_connection_call_sync (self->connection,
+                                       "org.freedesktop.DBus",
+                                       "/org/freedesktop/DBus",
+                                       "org.freedesktop.DBus",
+                                       "RequestName",
+                                       g_variant_new ("(su)", "org.a11y.atspi.Registry", 0),
+                                       G_VARIANT_TYPE ("(u)"),
+                                       G_DBUS_CALL_FLAGS_NONE, -1,
+                                       NULL, &error);
+  g_assert_no_error (error);
+  g_variant_unref (reply);
+
+  self->info = g_dbus_node_info_new_for_xml (registry_xml, &error);
+  g_assert_no_error (error);
+  g_dbus_connection_register_object (self->connection,
+                                     "/org/a11y/atspi/accessible/root",
+                                     self->info->interfaces[0],
+                                     &registry_vtable,
+                                     self, NULL,
+                                     &error);
+  g_assert_no_error (error);
+
+  g_setenv ("AT_SPI_BUS_ADDRESS", g_test_dbus_get_bus_address (self->bus), TRUE);
+  g_setenv ("GTK_A11Y", "atspi", TRUE);
+
+  return self;
+}
+
+static void
+mock_registry_free (MockRegistry *self)
+{
+  g_dbus_connection_close_sync (self->connection, NULL, NULL);
+  g_object_unref (self->connection);
+  g_dbus_node_info_unref (self->info);
+  g_test_dbus_down (self->bus);
+  g_object_unref (self->bus);
+  g_free (self->app_name);
+  g_free (self);
+}
+
+typedef struct
+{
+  GVariant *reply;
+  GError *error;
+  gboolean done;
+} CallData;
+
+static void
+call_done (GObject      *source,
+           GAsyncResult *result,
+           gpointer      user_data)
+{
+  CallData *data = user_data;
+
+  data->reply = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source), result, &data->error);
+  data->done = TRUE;
+}
+
+/* The application answers on this thread, so the client has to
+ * keep it running while it waits
+ */
+static GVariant *
+mock_registry_get_text (MockRegistry  *self,
+                        const char    *path,
+                        GError       **error)
+{
+  CallData data = { NULL, };
+
+  g_dbus_connection_call (self->connection,
+                          self->app_name,
+                          path,
+                          "org.a11y.atspi.Text",
+                          "GetText",
+                          g_variant_new ("(ii)", 0, -1),
+                          G_VARIANT_TYPE ("(s)"),
+                          G_DBUS_CALL_FLAGS_NONE, -1,
+                          NULL,
+                          call_done, &data);
+
+  while (!data.done)
+    g_main_context_iteration (NULL, TRUE);
+
+  if (data.error)
+    g_propagate_error (error, data.error);
+
+  return data.reply;
+}
+
+/* }}} */
+
+static void
+atspitext_bus_performance (void)
+{
+  GtkWidget *window, *view;
+  GtkATContext *context;
+  GString *contents;
+  GVariant *reply;
+  GError *error = NULL;
+  const char *path, *text;
+  GTimer *timer;
+  double first, repeated;
+  int i;
+
+  if (!g_test_perf ())
+    {
+      g_test_skip ("Only run in performance mode");
+      return;
+    }
+
+  if (registry == NULL)
+    {
+      g_test_skip ("No D-Bus daemon to run the accessibility bus");
+      return;
+    }
+
+  view = create_text_view (&contents);
+  context = gtk_accessible_get_at_context (GTK_ACCESSIBLE (view));
+  if (!GTK_IS_AT_SPI_CONTEXT (context))
+    {
+      g_test_skip ("The AT-SPI backend is not available");
+      g_clear_object (&context);
+      g_string_free (contents, TRUE);
+      g_object_unref (view);
+      return;
+    }
+
+  window = gtk_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), view);
+  gtk_window_present (GTK_WINDOW (window));
+
+  /* Wait for the application to announce itself, and for the
+   * text view to be put on the bus
+   */
+  path = gtk_at_spi_context_get_context_path (GTK_AT_SPI_CONTEXT (context));
+  while (registry->app_name == NULL)
+    g_main_context_iteration (NULL, TRUE);
+
+  while ((reply = mock_registry_get_text (registry, path, &error)) == NULL)
+    {
+      g_assert_true (g_error_matches (error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD) ||
+                     g_error_matches (error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_OBJECT) ||
+                     g_error_matches (error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_INTERFACE));
+      g_clear_error (&error);
+      g_main_context_iteration (NULL, FALSE);
+    }
+  g_variant_unref (reply);
+
+  /* Start over with no cached text */
+  gtk_text_buffer_set_text (gtk_text_view_get_buffer (GTK_TEXT_VIEW (view)), contents->str, contents->len);
+
+  timer = g_timer_new ();
+
+  reply = mock_registry_get_text (registry, path, &error);
+  g_assert_no_error (error);
+  first = g_timer_elapsed (timer, NULL);
+  g_variant_get (reply, "(&s)", &text);
+  g_assert_cmpstr (text, ==, contents->str);
+  g_variant_unref (reply);
+
+  g_timer_start (timer);
+  for (i = 0; i < 100; i++)
+    {
+      reply = mock_registry_get_text (registry, path, &error);
+      g_assert_no_error (error);
+      g_variant_unref (reply);
+    }
+  repeated = g_timer_elapsed (timer, NULL) / 100;
+
+  g_test_message ("Full text of %d lines over D-Bus: %.2f msec first, %.2f msec repeated",
+                  n_lines, first * 1000, repeated * 1000);
+  g_test_minimized_result (repeated, "%.2f msec per repeated GetText over D-Bus", repeated * 1000);
+
+  g_timer_destroy (timer);
+  g_object_unref (context);
+  g_string_free (contents, TRUE);
+  gtk_window_destroy (GTK_WINDOW (window));
+  g_object_unref (view);
+}
+
+int
+main (int argc, char *argv[])
+{
+  int res;
+
+  gtk_test_init (&argc, &argv, NULL);
+
+  /* The accessibility backend is picked when the first widget is
+   * created, so the bus has to be ready before any test runs
+   */
+  if (g_test_perf ())
+    registry = mock_registry_new ();
+
+  g_test_add_func ("/a11y/atspitext/ranges", atspitext_ranges);
+  g_test_add_func ("/a11y/atspitext/edits", atspitext_edits);
+  g_test_add_func ("/a11y/atspitext/invisible", atspitext_invisible);
+  g_test_add_func ("/a11y/atspitext/long", atspitext_long);
+  g_test_add_func ("/a11y/atspitext/performance", atspitext_performance);
+  g_test_add_func ("/a11y/atspitext/performance/bus", atspitext_bus_performance);
+
+  res = g_test_run ();
+
+  g_clear_pointer (&registry, mock_registry_free);
+
+  return res;
+}
@@ -0,0 +1,324 @@
+#include <string.h>
+
+#include <gtk/gtk.h>
+#include "gdk/gdkdecodeschedulerprivate.h"
+
+typedef struct
+{
+  GdkPaintable *texture;
+  gboolean failed;
+  guint n_calls;
+} Result;
+
+static void
+load_done (GdkPaintable *texture,
+           const GError *error,
+           gpointer      data)
+{
+  Result *result = data;
+
+  g_assert_true ((texture == NULL) != (error == NULL));
+
+  result->n_calls++;
+  result->failed = error != NULL;
+  g_set_object (&result->texture, texture);
+
+  g_main_context_wakeup (NULL);
+}
+
+static GFile *
+get_image_file (const char *dir,
+                const char *name)
+{
+  char *path;
+  GFile *file;
+
+  path = g_test_build_filename (G_TEST_DIST, dir, name, NULL);
+  file = g_file_new_for_path (path);
+  g_free (path);
+
+  return file;
+}
+
+static void
+test_load (void)
+{
+  Result result = { NULL, };
+  GFile *file;
+
+  file = get_image_file ("image-data", "image.png");
+
+  gdk_decode_scheduler_load_file (file, -1, -1, GDK_DECODE_PRIORITY_VISIBLE, load_done, &result);
+
+  while (result.n_calls == 0)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_false (result.failed);
+  g_assert_nonnull (result.texture);
+
+  g_clear_object (&result.texture);
+  g_object_unref (file);
+}
+
+static void
+test_shared (void)
+{
+  Result result1 = { NULL, }, result2 = { NULL, }, result3 = { NULL, };
+  GdkDecodeRequest *request;
+  GFile *file;
+
+  file = get_image_file ("image-data", "image.jpeg");
+
+  /* The same file at the same size is only loaded once */
+  gdk_decode_scheduler_load_file (file, -1, -1, GDK_DECODE_PRIORITY_BACKGROUND, load_done, &result1);
+  request = gdk_decode_scheduler_load_file (file, -1, -1, GDK_DECODE_PRIORITY_BACKGROUND, load_done, &result3);
+  gdk_decode_scheduler_load_file (file, -1, -1, GDK_DECODE_PRIORITY_VISIBLE, load_done, &result2);
+
+  gdk_decode_request_cancel (request);
+
+  while (result1.n_calls == 0 || result2.n_calls == 0)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_nonnull (result1.texture);
+  g_assert_true (result1.texture == result2.texture);
+  g_assert_cmpuint (result3.n_calls, ==, 0);
+
+  g_clear_object (&result1.texture);
+  g_clear_object (&result2.texture);
+  g_object_unref (file);
+}
+
+static void
+test_cancel (void)
+{
+  Result result = { NULL, }, other = { NULL, };
+  GdkDecodeRequest *request;
+  GFile *file;
+
+  file = get_image_file ("image-data", "image.tiff");
+
+  request = gdk_decode_scheduler_load_file (file, -1, -1, GDK_DECODE_PRIORITY_VISIBLE, load_done, &result);
+  gdk_decode_request_set_priority (request, GDK_DECODE_PRIORITY_BACKGROUND);
+  gdk_decode_request_cancel (request);
+
+  /* Whether the cancelled load was still queued or already
+   * running, it must never report back
+   */
+  gdk_decode_scheduler_load_file (file, 16, 16, GDK_DECODE_PRIORITY_BACKGROUND, load_done, &other);
+
+  while (other.n_calls == 0)
+    g_main_context_iteration (NULL, TRUE);
+  while (g_main_context_iteration (NULL, FALSE));
+
+  g_assert_cmpuint (result.n_calls, ==, 0);
+  g_assert_true (GDK_IS_TEXTURE (other.texture));
+  g_assert_cmpint (gdk_texture_get_width (GDK_TEXTURE (other.texture)), <=, 16);
+
+  g_clear_object (&other.texture);
+  g_object_unref (file);
+}
+
+static void
+test_error (void)
+{
+  Result result = { NULL, };
+  GFile *file;
+
+  file = get_image_file ("bad-image-data", "invalid.1.png");
+
+  gdk_decode_scheduler_load_file (file, -1, -1, GDK_DECODE_PRIORITY_VISIBLE, load_done, &result);
+
+  while (result.n_calls == 0)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_true (result.failed);
+  g_assert_null (result.texture);
+
+  g_object_unref (file);
+}
+
+/* Loads that block until they are released, and record the
+ * order in which they run. They are told apart by their width.
+ */
+#define N_BLOCKERS 4
+
+static GMutex lock;
+static GCond cond;
+static gboolean released[N_BLOCKERS];
+static guint n_running;
+static guint max_running;
+static GArray *run_order;
+
+static GdkPaintable *
+blocking_load (GFile         *file,
+               int            width,
+               int            height,
+               double         scale,
+               GCancellable  *cancellable,
+               GError       **error)
+{
+  g_mutex_lock (&lock);
+
+  n_running++;
+  max_running = MAX (max_running, n_running);
+  g_array_append_val (run_order, width);
+  g_cond_broadcast (&cond);
+
+  if (width < N_BLOCKERS)
+    {
+      while (!released[width])
+        g_cond_wait (&cond, &lock);
+    }
+
+  n_running--;
+  g_mutex_unlock (&lock);
+
+  return gdk_paintable_new_empty (width, height);
+}
+
+static void
+wait_for_running (guint n)
+{
+  g_mutex_lock (&lock);
+  while (n_running < n)
+    g_cond_wait (&cond, &lock);
+  g_mutex_unlock (&lock);
+}
+
+static void
+release (int blocker)
+{
+  g_mutex_lock (&lock);
+  released[blocker] = TRUE;
+  g_cond_broadcast (&cond);
+  g_mutex_unlock (&lock);
+}
+
+static void
+setup_blockers (GFile  *file,
+                Result *results)
+{
+  int i;
+
+  memset (released, 0, sizeof (released));
+  n_running = 0;
+  max_running = 0;
+  run_order = g_array_new (FALSE, FALSE, sizeof (int));
+
+  for (i = 0; i < N_BLOCKERS; i++)
+    gdk_decode_scheduler_load_file_full (file, i, 1, 1.0, blocking_load,
+                                         GDK_DECODE_PRIORITY_VISIBLE,
+                                         load_done, &results[i]);
+
+  /* Now all threads are busy */
+  wait_for_running (N_BLOCKERS);
+}
+
+static void
+wait_for_results (Result *results,
+                  guint   n_results)
+{
+  guint i;
+
+  for (i = 0; i < n_results; i++)
+    {
+      while (results[i].n_calls == 0)
+        g_main_context_iteration (NULL, TRUE);
+
+      g_assert_false (results[i].failed);
+      g_clear_object (&results[i].texture);
+    }
+}
+
+static void
+test_priority (void)
+{
+  const int expected[] = { 13, 11, 12, 10 };
+  Result results[N_BLOCKERS + 4] = { { NULL, }, };
+  GdkDecodeRequest *request;
+  GFile *file;
+  guint i;
+
+  file = g_file_new_for_path ("does-not-matter");
+
+  setup_blockers (file, results);
+
+  gdk_decode_scheduler_load_file_full (file, 10, 1, 1.0, blocking_load,
+                                       GDK_DECODE_PRIORITY_BACKGROUND,
+                                       load_done, &results[N_BLOCKERS]);
+  gdk_decode_scheduler_load_file_full (file, 11, 1, 1.0, blocking_load,
+                                       GDK_DECODE_PRIORITY_NEARBY,
+                                       load_done, &results[N_BLOCKERS + 1]);
+  gdk_decode_scheduler_load_file_full (file, 12, 1, 1.0, blocking_load,
+                                       GDK_DECODE_PRIORITY_NEARBY,
+                                       load_done, &results[N_BLOCKERS + 2]);
+  request = gdk_decode_scheduler_load_file_full (file, 13, 1, 1.0, blocking_load,
+                                                 GDK_DECODE_PRIORITY_BACKGROUND,
+                                                 load_done, &results[N_BLOCKERS + 3]);
+
+  /* Scrolled into view */
+  gdk_decode_request_set_priority (request, GDK_DECODE_PRIORITY_VISIBLE);
+
+  /* With a single free thread, the queued loads run one by one */
+  release (0);
+
+  wait_for_results (&results[N_BLOCKERS], 4);
+
+  /* The blockers come first, in any order */
+  g_mutex_lock (&lock);
+  g_assert_cmpuint (run_order->len, ==, N_BLOCKERS + G_N_ELEMENTS (expected));
+  for (i = 0; i < G_N_ELEMENTS (expected); i++)
+    g_assert_cmpint (g_array_index (run_order, int, N_BLOCKERS + i), ==, expected[i]);
+  g_mutex_unlock (&lock);
+
+  for (i = 1; i < N_BLOCKERS; i++)
+    release (i);
+
+  wait_for_results (results, N_BLOCKERS);
+
+  g_clear_pointer (&run_order, g_array_unref);
+  g_object_unref (file);
+}
+
+static void
+test_max_threads (void)
+{
+  Result results[N_BLOCKERS + 8] = { { NULL, }, };
+  GFile *file;
+  guint i;
+
+  file = g_file_new_for_path ("does-not-matter");
+
+  setup_blockers (file, results);
+
+  for (i = N_BLOCKERS; i < G_N_ELEMENTS (results); i++)
+    gdk_decode_scheduler_load_file_full (file, 10 + i, 1, 1.0, blocking_load,
+                                         GDK_DECODE_PRIORITY_VISIBLE,
+                                         load_done, &results[i]);
+
+  for (i = 0; i < N_BLOCKERS; i++)
+    release (i);
+
+  wait_for_results (results, G_N_ELEMENTS (results));
+
+  /* The blockers kept all threads busy, so nothing ran next to them */
+  g_assert_cmpuint (max_running, ==, N_BLOCKERS);
+
+  g_clear_pointer (&run_order, g_array_unref);
+  g_object_unref (file);
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, NULL);
+
+  g_test_add_func ("/decodescheduler/load", test_load);
+  g_test_add_func ("/decodescheduler/shared", test_shared);
+  g_test_add_func ("/decodescheduler/cancel", test_cancel);
+  g_test_add_func ("/decodescheduler/error", test_error);
+  g_test_add_func ("/decodescheduler/priority", test_priority);
+  g_test_add_func ("/decodescheduler/max-threads", test_max_threads);
+
+  return g_test_run ();
+}
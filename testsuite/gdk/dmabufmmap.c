@@ -0,0 +1,163 @@
+#include "config.h"
+
+#include <gtk/gtk.h>
+#include <gdk/gdkdmabuffourccprivate.h>
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/udmabuf.h>
+
+#define WIDTH 61
+#define HEIGHT 17
+#define STRIDE 256
+#define OFFSET 64
+
+static void
+close_fd (gpointer data)
+{
+  close (GPOINTER_TO_INT (data));
+}
+
+/* Turns the memfd into a real dmabuf if the kernel lets us,
+ * so that the syncing is exercised, too. Otherwise we use
+ * the memfd itself, which can be mapped just the same.
+ */
+static int
+make_udmabuf (int memfd,
+              gsize size)
+{
+  struct udmabuf_create create = { 0, };
+  int devfd, fd;
+
+  if (fcntl (memfd, F_ADD_SEALS, F_SEAL_SHRINK) < 0)
+    return -1;
+
+  devfd = open ("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+  if (devfd < 0)
+    return -1;
+
+  create.memfd = memfd;
+  create.flags = UDMABUF_FLAGS_CLOEXEC;
+  create.offset = 0;
+  create.size = size;
+
+  fd = ioctl (devfd, UDMABUF_CREATE, &create);
+  close (devfd);
+
+  return fd;
+}
+
+static GdkTexture *
+make_linear_dmabuf_texture (GBytes **out_bytes)
+{
+  GdkDmabufTextureBuilder *builder;
+  GdkTexture *texture;
+  GError *error = NULL;
+  guchar *data;
+  gsize size;
+  int memfd, fd;
+  int x, y;
+
+  size = OFFSET + STRIDE * HEIGHT;
+  size = (size + 4095) & ~4095;
+
+  memfd = memfd_create ("dmabuf-mmap", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  g_assert_cmpint (memfd, >=, 0);
+  g_assert_cmpint (ftruncate (memfd, size), ==, 0);
+
+  data = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+  g_assert_true (data != MAP_FAILED);
+
+  for (y = 0; y < HEIGHT; y++)
+    for (x = 0; x < WIDTH * 4; x++)
+      data[OFFSET + y * STRIDE + x] = g_test_rand_int_range (0, 256);
+
+  *out_bytes = g_bytes_new (data + OFFSET, STRIDE * HEIGHT);
+  munmap (data, size);
+
+  fd = make_udmabuf (memfd, size);
+  if (fd < 0)
+    fd = memfd;
+  else
+    close (memfd);
+
+  builder = gdk_dmabuf_texture_builder_new ();
+  gdk_dmabuf_texture_builder_set_display (builder, gdk_display_get_default ());
+  gdk_dmabuf_texture_builder_set_width (builder, WIDTH);
+  gdk_dmabuf_texture_builder_set_height (builder, HEIGHT);
+  gdk_dmabuf_texture_builder_set_fourcc (builder, DRM_FORMAT_ARGB8888);
+  gdk_dmabuf_texture_builder_set_modifier (builder, DRM_FORMAT_MOD_LINEAR);
+  gdk_dmabuf_texture_builder_set_n_planes (builder, 1);
+  gdk_dmabuf_texture_builder_set_fd (builder, 0, fd);
+  gdk_dmabuf_texture_builder_set_stride (builder, 0, STRIDE);
+  gdk_dmabuf_texture_builder_set_offset (builder, 0, OFFSET);
+
+  texture = gdk_dmabuf_texture_builder_build (builder, close_fd, GINT_TO_POINTER (fd), &error);
+  g_assert_no_error (error);
+
+  g_object_unref (builder);
+
+  return texture;
+}
+
+static void
+assert_same_download (GdkTexture      *texture1,
+                      GdkTexture      *texture2,
+                      GdkMemoryFormat  format)
+{
+  GdkTextureDownloader *downloader;
+  GBytes *bytes1, *bytes2;
+  gsize stride1, stride2;
+
+  downloader = gdk_texture_downloader_new (texture1);
+  gdk_texture_downloader_set_format (downloader, format);
+  bytes1 = gdk_texture_downloader_download_bytes (downloader, &stride1);
+
+  gdk_texture_downloader_set_texture (downloader, texture2);
+  bytes2 = gdk_texture_downloader_download_bytes (downloader, &stride2);
+
+  g_assert_cmpuint (stride1, ==, stride2);
+  g_assert_cmpmem (g_bytes_get_data (bytes1, NULL), g_bytes_get_size (bytes1),
+                   g_bytes_get_data (bytes2, NULL), g_bytes_get_size (bytes2));
+
+  g_bytes_unref (bytes1);
+  g_bytes_unref (bytes2);
+  gdk_texture_downloader_free (downloader);
+}
+
+/* Linear dmabufs are downloaded by mapping them, which
+ * works without any GPU, so compare with a memory texture
+ * of the same pixels.
+ */
+static void
+test_dmabuf_mmap (void)
+{
+  GdkTexture *texture, *reference;
+  GBytes *bytes;
+
+  texture = make_linear_dmabuf_texture (&bytes);
+  reference = gdk_memory_texture_new (WIDTH, HEIGHT,
+                                      gdk_texture_get_format (texture),
+                                      bytes, STRIDE);
+
+  /* no conversion */
+  assert_same_download (texture, reference, gdk_texture_get_format (texture));
+  /* converted from the mapping */
+  assert_same_download (texture, reference, GDK_MEMORY_R8G8B8A8);
+  assert_same_download (texture, reference, GDK_MEMORY_R16G16B16A16_FLOAT);
+
+  g_object_unref (reference);
+  g_object_unref (texture);
+  g_bytes_unref (bytes);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/dmabuf/mmap", test_dmabuf_mmap);
+
+  return g_test_run ();
+}
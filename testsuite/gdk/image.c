@@ -68,6 +68,69 @@ test_load_image (gconstpointer data)
   g_free (path);
 }
 
+static GdkTexture *
+load_image_at_size (GBytes     *bytes,
+                    const char *filename,
+                    int         width,
+                    int         height)
+{
+  GdkTexture *texture;
+  GError *error = NULL;
+
+  if (g_str_has_suffix (filename, ".png"))
+    texture = gdk_load_png_at_size (bytes, width, height, NULL, &error);
+  else if (g_str_has_suffix (filename, ".tiff"))
+    texture = gdk_load_tiff_at_size (bytes, width, height, &error);
+  else if (g_str_has_suffix (filename, ".jpeg"))
+    texture = gdk_load_jpeg_at_size (bytes, width, height, &error);
+  else
+    g_assert_not_reached ();
+
+  g_assert_no_error (error);
+  g_assert_true (GDK_IS_TEXTURE (texture));
+
+  return texture;
+}
+
+static void
+test_load_image_at_size (gconstpointer data)
+{
+  const char *filename = data;
+  GdkTexture *texture;
+  char *path;
+  GFile *file;
+  GBytes *bytes;
+  GError *error = NULL;
+
+  path = g_test_build_filename (G_TEST_DIST, "image-data", filename, NULL);
+  file = g_file_new_for_path (path);
+  bytes = g_file_load_bytes (file, NULL, NULL, &error);
+  g_assert_no_error (error);
+
+  /* All the images are 32x32 */
+  texture = load_image_at_size (bytes, filename, 16, 16);
+  g_assert_cmpint (gdk_texture_get_width (texture), ==, 16);
+  g_assert_cmpint (gdk_texture_get_height (texture), ==, 16);
+  g_object_unref (texture);
+
+  /* Never smaller than needed */
+  texture = load_image_at_size (bytes, filename, 10, -1);
+  g_assert_cmpint (gdk_texture_get_width (texture), >=, 10);
+  g_assert_cmpint (gdk_texture_get_width (texture), <=, 16);
+  g_assert_cmpint (gdk_texture_get_width (texture), ==, gdk_texture_get_height (texture));
+  g_object_unref (texture);
+
+  /* Never scaled up */
+  texture = load_image_at_size (bytes, filename, 100, 100);
+  g_assert_cmpint (gdk_texture_get_width (texture), ==, 32);
+  g_assert_cmpint (gdk_texture_get_height (texture), ==, 32);
+  g_object_unref (texture);
+
+  g_bytes_unref (bytes);
+  g_object_unref (file);
+  g_free (path);
+}
+
 static void
 test_save_image (gconstpointer test_data)
 {
@@ -117,6 +180,77 @@ test_save_image (gconstpointer test_data)
   g_free (path);
 }
 
+/* Big enough to be saved with multiple threads */
+static GdkTexture *
+create_big_texture (GdkMemoryFormat format,
+                    gsize           bpp)
+{
+  const int width = 1024, height = 1024;
+  GdkTexture *texture;
+  GBytes *bytes;
+  guchar *data;
+  gsize i;
+
+  data = g_malloc (width * height * bpp);
+  for (i = 0; i < width * height * bpp; i++)
+    data[i] = (i * 7 + i / (width * bpp) * 3) ^ g_test_rand_int_range (0, 4);
+
+  bytes = g_bytes_new_take (data, width * height * bpp);
+  texture = gdk_memory_texture_new (width, height, format, bytes, width * bpp);
+  g_bytes_unref (bytes);
+
+  return texture;
+}
+
+static void
+test_save_big_image (void)
+{
+  const struct {
+    GdkMemoryFormat format;
+    gsize bpp;
+  } formats[] = {
+    { GDK_MEMORY_R8G8B8A8, 4 },
+    { GDK_MEMORY_R8G8B8, 3 },
+    { GDK_MEMORY_R16G16B16A16, 8 },
+  };
+  const int levels[] = { -1, 0, 1, 9 };
+  /* Force the thread count, so the parallel writer runs
+   * even on machines with a single processor
+   */
+  const guint threads[] = { 1, 3, 8 };
+  gsize i, j, k;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++)
+    {
+      GdkTexture *texture = create_big_texture (formats[i].format, formats[i].bpp);
+
+      for (j = 0; j < G_N_ELEMENTS (levels); j++)
+        {
+          for (k = 0; k < G_N_ELEMENTS (threads); k++)
+            {
+              GdkTexture *texture2;
+              GError *error = NULL;
+              GBytes *bytes;
+
+              gdk_png_set_save_threads (threads[k]);
+              bytes = gdk_save_png_with_compression (texture, levels[j]);
+              gdk_png_set_save_threads (0);
+
+              texture2 = gdk_load_png (bytes, NULL, &error);
+              g_assert_no_error (error);
+
+              g_assert_cmpint (gdk_texture_get_format (texture2), ==, formats[i].format);
+              assert_texture_equal (texture, texture2);
+
+              g_object_unref (texture2);
+              g_bytes_unref (bytes);
+            }
+        }
+
+      g_object_unref (texture);
+    }
+}
+
 static void
 test_load_image_fail (gconstpointer data)
 {
@@ -155,6 +289,10 @@ main (int argc, char *argv[])
      char *test = g_strconcat ("/image/load/", name, NULL);
      g_test_add_data_func (test, name, test_load_image);
      g_free (test);
+
+     test = g_strconcat ("/image/load-at-size/", name, NULL);
+     g_test_add_data_func (test, name, test_load_image_at_size);
+     g_free (test);
    }
 
   path = g_test_build_filename (G_TEST_DIST, "bad-image-data", NULL);
@@ -172,6 +310,7 @@ main (int argc, char *argv[])
   g_test_add_data_func ("/image/save/image.png", "image.png", test_save_image);
   g_test_add_data_func ("/image/save/image.tiff", "image.tiff", test_save_image);
   g_test_add_data_func ("/image/save/image.jpeg", "image.jpeg", test_save_image);
+  g_test_add_func ("/image/save/big", test_save_big_image);
 
   return g_test_run ();
 }
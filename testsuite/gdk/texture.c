@@ -1,7 +1,9 @@
 #include <gtk.h>
+#include <glib/gstdio.h>
 
 #include "gdk/gdkmemorytextureprivate.h"
 #include "gdk/gdktextureprivate.h"
+#include "gdk/gdktexturecacheprivate.h"
 
 
 #define assert_texture_diff_equal(a, b, expected) G_STMT_START { \
@@ -441,6 +443,252 @@ test_texture_downloader (void)
   g_object_unref (texture);
 }
 
+static void
+save_png (const char *path,
+          int         width,
+          int         height)
+{
+  GdkTexture *texture;
+  GBytes *bytes;
+
+  bytes = g_bytes_new_take (g_malloc0 (width * height * 4), width * height * 4);
+  texture = gdk_memory_texture_new (width, height, GDK_MEMORY_DEFAULT, bytes, width * 4);
+  g_assert_true (gdk_texture_save_to_png (texture, path));
+
+  g_object_unref (texture);
+  g_bytes_unref (bytes);
+}
+
+static void
+test_texture_cache (void)
+{
+  GdkTextureCacheStats before, after;
+  GdkTexture *texture1, *texture2, *texture3;
+  GError *error = NULL;
+  char *path;
+  GFile *file;
+
+  gdk_texture_cache_clear ();
+
+  path = g_test_build_filename (G_TEST_DIST, "image-data", "image.png", NULL);
+  file = g_file_new_for_path (path);
+
+  gdk_texture_cache_get_stats (&before);
+
+  texture1 = gdk_texture_load_file (file, -1, -1, NULL, &error);
+  g_assert_no_error (error);
+  texture2 = gdk_texture_load_file (file, -1, -1, NULL, &error);
+  g_assert_no_error (error);
+  g_assert_true (texture1 == texture2);
+
+  /* Different sizes are different textures */
+  texture3 = gdk_texture_load_file (file, 4, 4, NULL, &error);
+  g_assert_no_error (error);
+  g_assert_true (texture1 != texture3);
+
+  gdk_texture_cache_get_stats (&after);
+  g_assert_cmpuint (after.n_hits, ==, before.n_hits + 1);
+  g_assert_cmpuint (after.n_kept, ==, 2);
+
+  gdk_texture_cache_clear ();
+  g_object_unref (texture2);
+  texture2 = gdk_texture_load_file (file, -1, -1, NULL, &error);
+  g_assert_no_error (error);
+  g_assert_true (texture1 != texture2);
+
+  g_object_unref (texture1);
+  g_object_unref (texture2);
+  g_object_unref (texture3);
+
+  /* The public constructors don't share textures */
+  texture1 = gdk_texture_new_from_file (file, &error);
+  g_assert_no_error (error);
+  texture2 = gdk_texture_new_from_filename (path, &error);
+  g_assert_no_error (error);
+  g_assert_true (texture1 != texture2);
+
+  g_object_unref (texture1);
+  g_object_unref (texture2);
+
+  texture1 = gdk_texture_new_from_resource ("/org/gtk/libgtk/icons/16x16/places/user-trash.png");
+  texture2 = gdk_texture_new_from_resource ("/org/gtk/libgtk/icons/16x16/places/user-trash.png");
+  g_assert_true (texture1 != texture2);
+
+  g_object_unref (texture1);
+  g_object_unref (texture2);
+
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+test_texture_cache_replaced (void)
+{
+  GdkTexture *texture1, *texture2;
+  GFileInfo *info;
+  GError *error = NULL;
+  char *path;
+  GFile *file;
+  int fd;
+
+  fd = g_file_open_tmp ("gdk-texture-cache-XXXXXX.png", &path, NULL);
+  g_assert_cmpint (fd, >=, 0);
+  g_close (fd, NULL);
+  file = g_file_new_for_path (path);
+
+  save_png (path, 4, 4);
+  info = g_file_query_info (file,
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+                            G_FILE_QUERY_INFO_NONE,
+                            NULL, &error);
+  g_assert_no_error (error);
+
+  texture1 = gdk_texture_load_file (file, -1, -1, NULL, &error);
+  g_assert_no_error (error);
+
+  /* Rewrite the file without changing its modification time,
+   * as happens with coarse timestamps
+   */
+  save_png (path, 8, 8);
+  g_file_set_attributes_from_info (file, info, G_FILE_QUERY_INFO_NONE, NULL, &error);
+  g_assert_no_error (error);
+
+  texture2 = gdk_texture_load_file (file, -1, -1, NULL, &error);
+  g_assert_no_error (error);
+  g_assert_true (texture1 != texture2);
+  g_assert_cmpint (gdk_texture_get_width (texture2), ==, 8);
+
+  g_object_unref (texture1);
+  g_object_unref (texture2);
+  g_object_unref (info);
+
+  g_unlink (path);
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+test_texture_lod (void)
+{
+  const guchar pixels[] = {
+    0, 0, 0, 0,    40, 40, 40, 40,    80, 80, 80, 80,
+    40, 40, 40, 40,    80, 80, 80, 80,    200, 0, 0, 200,
+    10, 20, 30, 255,   10, 20, 30, 255,   10, 20, 30, 255,
+  };
+  GdkMemoryFormat formats[] = { GDK_MEMORY_R8G8B8A8_PREMULTIPLIED, GDK_MEMORY_R8G8B8A8 };
+  /* straight alpha colors are weighted by their alpha */
+  guchar expected[] = { 40, 60 };
+  guchar data[2 * 2 * 4];
+  gsize i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++)
+    {
+      GdkTexture *texture, *lod1, *lod;
+      GdkTextureDownloader *downloader;
+      GBytes *bytes;
+
+      bytes = g_bytes_new_static (pixels, sizeof (pixels));
+      texture = gdk_memory_texture_new (3, 3, formats[i], bytes, 3 * 4);
+      g_bytes_unref (bytes);
+
+      g_assert_true (gdk_memory_texture_get_lod (GDK_MEMORY_TEXTURE (texture), 0) == texture);
+
+      lod1 = gdk_memory_texture_get_lod (GDK_MEMORY_TEXTURE (texture), 1);
+      g_assert_cmpint (gdk_texture_get_width (lod1), ==, 2);
+      g_assert_cmpint (gdk_texture_get_height (lod1), ==, 2);
+      g_assert_cmpint (gdk_texture_get_format (lod1), ==, formats[i]);
+      g_assert_true (gdk_memory_texture_get_lod (GDK_MEMORY_TEXTURE (texture), 1) == lod1);
+
+      downloader = gdk_texture_downloader_new (lod1);
+      gdk_texture_downloader_set_format (downloader, formats[i]);
+      gdk_texture_downloader_download_into (downloader, data, 2 * 4);
+      gdk_texture_downloader_free (downloader);
+
+      /* 2x2 block in the top left */
+      g_assert_cmpint (data[0], ==, expected[i]);
+      g_assert_cmpint (data[3], ==, 40);
+      /* the last row is only averaged with itself */
+      g_assert_cmpint (data[8], ==, 10);
+      g_assert_cmpint (data[9], ==, 20);
+      g_assert_cmpint (data[10], ==, 30);
+      g_assert_cmpint (data[11], ==, 255);
+
+      lod = gdk_memory_texture_get_lod (GDK_MEMORY_TEXTURE (texture), 10);
+      g_assert_cmpint (gdk_texture_get_width (lod), ==, 1);
+      g_assert_cmpint (gdk_texture_get_height (lod), ==, 1);
+      g_assert_true (gdk_memory_texture_get_lod (GDK_MEMORY_TEXTURE (lod1), 9) == lod);
+
+      g_object_unref (texture);
+    }
+}
+
+static void
+lod_prepared (GObject      *source,
+              GAsyncResult *result,
+              gpointer      data)
+{
+  gboolean *done = data;
+
+  g_assert_true (gdk_memory_texture_prepare_lod_finish (GDK_MEMORY_TEXTURE (source), result, NULL));
+  *done = TRUE;
+  g_main_context_wakeup (NULL);
+}
+
+static void
+test_texture_lod_async (void)
+{
+  GdkTexture *texture, *thumbnail;
+  GdkTextureDownloader *downloader;
+  gboolean done = FALSE;
+  GBytes *bytes;
+  guchar *data;
+  gsize x, y;
+
+  /* Every pixel has its coordinates as its color */
+  data = g_malloc (600 * 600 * 4);
+  for (y = 0; y < 600; y++)
+    for (x = 0; x < 600; x++)
+      {
+        data[(y * 600 + x) * 4 + 0] = x / 4;
+        data[(y * 600 + x) * 4 + 1] = y / 4;
+        data[(y * 600 + x) * 4 + 2] = 0;
+        data[(y * 600 + x) * 4 + 3] = 255;
+      }
+  bytes = g_bytes_new_take (data, 600 * 600 * 4);
+  texture = gdk_memory_texture_new (600, 600, GDK_MEMORY_R8G8B8A8, bytes, 600 * 4);
+  g_bytes_unref (bytes);
+
+  g_assert_true (gdk_memory_texture_peek_lod (GDK_MEMORY_TEXTURE (texture), 0) == texture);
+  g_assert_null (gdk_memory_texture_peek_lod (GDK_MEMORY_TEXTURE (texture), 2));
+
+  /* The thumbnail has the size of level 2, and samples the middle of its blocks */
+  thumbnail = gdk_memory_texture_get_thumbnail (GDK_MEMORY_TEXTURE (texture));
+  g_assert_cmpint (gdk_texture_get_width (thumbnail), ==, 150);
+  g_assert_cmpint (gdk_texture_get_height (thumbnail), ==, 150);
+  g_assert_true (gdk_memory_texture_get_thumbnail (GDK_MEMORY_TEXTURE (texture)) == thumbnail);
+
+  data = g_malloc (150 * 150 * 4);
+  downloader = gdk_texture_downloader_new (thumbnail);
+  gdk_texture_downloader_set_format (downloader, GDK_MEMORY_R8G8B8A8);
+  gdk_texture_downloader_download_into (downloader, data, 150 * 4);
+  gdk_texture_downloader_free (downloader);
+  g_assert_cmpint (data[(10 * 150 + 20) * 4 + 0], ==, (20 * 4 + 2) / 4);
+  g_assert_cmpint (data[(10 * 150 + 20) * 4 + 1], ==, (10 * 4 + 2) / 4);
+  g_free (data);
+
+  gdk_memory_texture_prepare_lod_async (GDK_MEMORY_TEXTURE (texture), 2, NULL, lod_prepared, &done);
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_nonnull (gdk_memory_texture_peek_lod (GDK_MEMORY_TEXTURE (texture), 1));
+  g_assert_true (gdk_memory_texture_peek_lod (GDK_MEMORY_TEXTURE (texture), 2) ==
+                 gdk_memory_texture_get_lod (GDK_MEMORY_TEXTURE (texture), 2));
+  g_assert_null (gdk_memory_texture_peek_lod (GDK_MEMORY_TEXTURE (texture), 3));
+
+  g_object_unref (texture);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -452,11 +700,15 @@ main (int argc, char *argv[])
   g_test_add_func ("/texture/save-to-png", test_texture_save_to_png);
   g_test_add_func ("/texture/save-to-tiff", test_texture_save_to_tiff);
   g_test_add_func ("/texture/subtexture", test_texture_subtexture);
+  g_test_add_func ("/texture/lod", test_texture_lod);
+  g_test_add_func ("/texture/lod-async", test_texture_lod_async);
   g_test_add_func ("/texture/icon/load", test_texture_icon);
   g_test_add_func ("/texture/icon/load-async", test_texture_icon_async);
   g_test_add_func ("/texture/icon/serialize", test_texture_icon_serialize);
   g_test_add_func ("/texture/diff", test_texture_diff);
   g_test_add_func ("/texture/downloader", test_texture_downloader);
+  g_test_add_func ("/texture/cache", test_texture_cache);
+  g_test_add_func ("/texture/cache-replaced", test_texture_cache_replaced);
 
   return g_test_run ();
 }
@@ -0,0 +1,226 @@
+#include <gtk/gtk.h>
+
+/* A stream that returns at most a few bytes per read,
+ * like a slow network mount would.
+ */
+#define TYPE_SLOW_INPUT_STREAM (slow_input_stream_get_type ())
+G_DECLARE_FINAL_TYPE (SlowInputStream, slow_input_stream, SLOW, INPUT_STREAM, GFilterInputStream)
+
+struct _SlowInputStream
+{
+  GFilterInputStream parent_instance;
+};
+
+G_DEFINE_TYPE (SlowInputStream, slow_input_stream, G_TYPE_FILTER_INPUT_STREAM)
+
+static gssize
+slow_input_stream_read (GInputStream  *stream,
+                        void          *buffer,
+                        gsize          count,
+                        GCancellable  *cancellable,
+                        GError       **error)
+{
+  GInputStream *base = g_filter_input_stream_get_base_stream (G_FILTER_INPUT_STREAM (stream));
+
+  g_usleep (100);
+
+  return g_input_stream_read (base, buffer, MIN (count, 64), cancellable, error);
+}
+
+static void
+slow_input_stream_class_init (SlowInputStreamClass *klass)
+{
+  GInputStreamClass *stream_class = G_INPUT_STREAM_CLASS (klass);
+
+  stream_class->read_fn = slow_input_stream_read;
+}
+
+static void
+slow_input_stream_init (SlowInputStream *self)
+{
+}
+
+static GInputStream *
+open_slow_stream (const char *filename)
+{
+  GInputStream *base, *stream;
+  char *path;
+  GFile *file;
+  GError *error = NULL;
+
+  path = g_test_build_filename (G_TEST_DIST, "image-data", filename, NULL);
+  file = g_file_new_for_path (path);
+  base = G_INPUT_STREAM (g_file_read (file, NULL, &error));
+  g_assert_no_error (error);
+
+  stream = g_object_new (TYPE_SLOW_INPUT_STREAM, "base-stream", base, NULL);
+
+  g_object_unref (base);
+  g_object_unref (file);
+  g_free (path);
+
+  return stream;
+}
+
+static void
+texture_changed (GdkTextureLoader *loader,
+                 GParamSpec       *pspec,
+                 guint            *n_textures)
+{
+  g_assert_nonnull (gdk_texture_loader_get_texture (loader));
+
+  (*n_textures)++;
+}
+
+static void
+wait_for_loader (GdkTextureLoader *loader)
+{
+  while (gdk_texture_loader_is_loading (loader))
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+assert_texture_equal (GdkTexture *t1,
+                      GdkTexture *t2)
+{
+  GdkTextureDownloader *downloader;
+  GBytes *b1, *b2;
+  gsize stride1, stride2;
+
+  g_assert_cmpint (gdk_texture_get_width (t1), ==, gdk_texture_get_width (t2));
+  g_assert_cmpint (gdk_texture_get_height (t1), ==, gdk_texture_get_height (t2));
+
+  downloader = gdk_texture_downloader_new (t1);
+  b1 = gdk_texture_downloader_download_bytes (downloader, &stride1);
+  gdk_texture_downloader_set_texture (downloader, t2);
+  b2 = gdk_texture_downloader_download_bytes (downloader, &stride2);
+  gdk_texture_downloader_free (downloader);
+
+  g_assert_cmpuint (stride1, ==, stride2);
+  g_assert_true (g_bytes_equal (b1, b2));
+
+  g_bytes_unref (b1);
+  g_bytes_unref (b2);
+}
+
+static void
+test_progressive (gconstpointer data)
+{
+  const char *filename = data;
+  GdkTextureLoader *loader;
+  GdkTexture *texture;
+  GInputStream *stream;
+  guint n_textures = 0;
+  char *path;
+  GError *error = NULL;
+
+  stream = open_slow_stream (filename);
+  loader = gdk_texture_loader_new_for_stream (stream);
+  g_signal_connect (loader, "notify::texture", G_CALLBACK (texture_changed), &n_textures);
+
+  g_assert_true (gdk_texture_loader_is_loading (loader));
+
+  wait_for_loader (loader);
+
+  g_assert_no_error (gdk_texture_loader_get_error (loader));
+  g_assert_nonnull (gdk_texture_loader_get_texture (loader));
+
+  /* Previews, and then the final image */
+  g_assert_cmpuint (n_textures, >, 1);
+
+  path = g_test_build_filename (G_TEST_DIST, "image-data", filename, NULL);
+  texture = gdk_texture_new_from_filename (path, &error);
+  g_assert_no_error (error);
+
+  if (g_str_has_suffix (filename, ".png"))
+    assert_texture_equal (gdk_texture_loader_get_texture (loader), texture);
+  else
+    {
+      g_assert_cmpint (gdk_paintable_get_intrinsic_width (GDK_PAINTABLE (loader)), ==, gdk_texture_get_width (texture));
+      g_assert_cmpint (gdk_paintable_get_intrinsic_height (GDK_PAINTABLE (loader)), ==, gdk_texture_get_height (texture));
+    }
+
+  g_object_unref (texture);
+  g_free (path);
+  g_object_unref (loader);
+  g_object_unref (stream);
+}
+
+static void
+test_file (void)
+{
+  GdkTextureLoader *loader;
+  char *path;
+  GFile *file;
+
+  /* Not a format that can be streamed */
+  path = g_test_build_filename (G_TEST_DIST, "image-data", "image.tiff", NULL);
+  file = g_file_new_for_path (path);
+  loader = gdk_texture_loader_new_for_file (file);
+
+  wait_for_loader (loader);
+
+  g_assert_no_error (gdk_texture_loader_get_error (loader));
+  g_assert_nonnull (gdk_texture_loader_get_texture (loader));
+  g_assert_cmpint (gdk_paintable_get_intrinsic_width (GDK_PAINTABLE (loader)), ==, 32);
+  g_assert_cmpint (gdk_paintable_get_intrinsic_height (GDK_PAINTABLE (loader)), ==, 32);
+
+  g_object_unref (loader);
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+test_error (void)
+{
+  GdkTextureLoader *loader;
+  char *path;
+  GFile *file;
+
+  path = g_test_build_filename (G_TEST_DIST, "bad-image-data", "invalid.1.png", NULL);
+  file = g_file_new_for_path (path);
+  loader = gdk_texture_loader_new_for_file (file);
+
+  wait_for_loader (loader);
+
+  g_assert_nonnull (gdk_texture_loader_get_error (loader));
+
+  g_object_unref (loader);
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+test_dispose (void)
+{
+  GdkTextureLoader *loader;
+  GInputStream *stream;
+  guint i;
+
+  /* Dropping a loader cancels it, without the thread blowing up */
+  stream = open_slow_stream ("image.jpeg");
+  loader = gdk_texture_loader_new_for_stream (stream);
+  g_object_unref (loader);
+
+  for (i = 0; i < 100; i++)
+    {
+      g_usleep (1000);
+      while (g_main_context_iteration (NULL, FALSE));
+    }
+
+  g_object_unref (stream);
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, NULL);
+
+  g_test_add_data_func ("/textureloader/progressive/image.jpeg", "image.jpeg", test_progressive);
+  g_test_add_data_func ("/textureloader/progressive/image-palette.png", "image-palette.png", test_progressive);
+  g_test_add_func ("/textureloader/file", test_file);
+  g_test_add_func ("/textureloader/error", test_error);
+  g_test_add_func ("/textureloader/dispose", test_dispose);
+
+  return g_test_run ();
+}
@@ -95,6 +95,258 @@ test_can_diff_transform (void)
   gsk_transform_unref (t2);
 }
 
+/* Something like a list of rows, each with a background,
+ * a border and some offset content. If @changed_row is not
+ * negative, that row gets a different color.
+ */
+static GskRenderNode *
+create_rows (int n_rows,
+             int changed_row)
+{
+  GskRenderNode **rows;
+  GskRenderNode *result;
+  int i;
+
+  rows = g_new (GskRenderNode *, n_rows);
+
+  for (i = 0; i < n_rows; i++)
+    {
+      GskRenderNode *children[3], *content;
+      GskTransform *transform;
+      graphene_rect_t bounds = GRAPHENE_RECT_INIT (0, i * 20, 200, 20);
+      GskRoundedRect outline;
+
+      gsk_rounded_rect_init_from_rect (&outline, &bounds, 0);
+
+      children[0] = gsk_color_node_new (&(GdkRGBA) { 1, 1, 1, 1 }, &bounds);
+      children[1] = gsk_border_node_new (&outline,
+                                         (float[4]) { 1, 1, 1, 1 },
+                                         (GdkRGBA[4]) { { 0, 0, 0, 1 }, { 0, 0, 0, 1 }, { 0, 0, 0, 1 }, { 0, 0, 0, 1 } });
+
+      if (i == changed_row)
+        content = gsk_color_node_new (&(GdkRGBA) { 1, 0, 0, 1 }, &GRAPHENE_RECT_INIT (0, 0, 50, 10));
+      else
+        content = gsk_color_node_new (&(GdkRGBA) { 0, 0, 1, 1 }, &GRAPHENE_RECT_INIT (0, 0, 50, 10));
+
+      transform = gsk_transform_translate (NULL, &GRAPHENE_POINT_INIT (10, i * 20 + 5));
+      children[2] = gsk_transform_node_new (content, transform);
+      gsk_transform_unref (transform);
+      gsk_render_node_unref (content);
+
+      rows[i] = gsk_container_node_new (children, 3);
+
+      gsk_render_node_unref (children[0]);
+      gsk_render_node_unref (children[1]);
+      gsk_render_node_unref (children[2]);
+    }
+
+  result = gsk_container_node_new (rows, n_rows);
+
+  for (i = 0; i < n_rows; i++)
+    gsk_render_node_unref (rows[i]);
+  g_free (rows);
+
+  return result;
+}
+
+static cairo_region_t *
+diff_nodes (GskRenderNode *node1,
+            GskRenderNode *node2)
+{
+  cairo_region_t *region = cairo_region_create ();
+
+  gsk_render_node_diff (node1, node2, &(GskDiffData) { region, NULL });
+
+  return region;
+}
+
+static void
+test_diff_identical (void)
+{
+  GskRenderNode *node1, *node2, *node3;
+  cairo_region_t *region;
+  cairo_rectangle_int_t extents;
+
+  node1 = create_rows (100, -1);
+  node2 = create_rows (100, -1);
+  node3 = create_rows (100, 42);
+
+  /* Separately created, but equal trees have the same hash */
+  g_assert_cmpuint (gsk_render_node_get_hash (node1), !=, 0);
+  g_assert_cmpuint (gsk_render_node_get_hash (node1), ==, gsk_render_node_get_hash (node2));
+  g_assert_cmpuint (gsk_render_node_get_hash (node1), !=, gsk_render_node_get_hash (node3));
+
+  region = diff_nodes (node1, node2);
+  g_assert_true (cairo_region_is_empty (region));
+  cairo_region_destroy (region);
+
+  /* Only the changed row is damaged */
+  region = diff_nodes (node1, node3);
+  cairo_region_get_extents (region, &extents);
+  g_assert_cmpint (extents.x, ==, 10);
+  g_assert_cmpint (extents.y, ==, 42 * 20 + 5);
+  g_assert_cmpint (extents.width, ==, 50);
+  g_assert_cmpint (extents.height, ==, 10);
+  cairo_region_destroy (region);
+
+  gsk_render_node_unref (node1);
+  gsk_render_node_unref (node2);
+  gsk_render_node_unref (node3);
+}
+
+static void
+test_diff_unhashable (void)
+{
+  GskRenderNode *cairo1, *cairo2, *container1, *container2;
+  cairo_region_t *region;
+
+  cairo1 = gsk_cairo_node_new (&GRAPHENE_RECT_INIT (0, 0, 10, 10));
+  cairo2 = gsk_cairo_node_new (&GRAPHENE_RECT_INIT (0, 0, 10, 10));
+  container1 = gsk_container_node_new (&cairo1, 1);
+  container2 = gsk_container_node_new (&cairo2, 1);
+
+  /* Cairo nodes have no hash, so they must never be skipped */
+  g_assert_cmpuint (gsk_render_node_get_hash (cairo1), ==, 0);
+  g_assert_cmpuint (gsk_render_node_get_hash (container1), ==, 0);
+
+  region = diff_nodes (container1, container2);
+  g_assert_false (cairo_region_is_empty (region));
+  cairo_region_destroy (region);
+
+  gsk_render_node_unref (cairo1);
+  gsk_render_node_unref (cairo2);
+  gsk_render_node_unref (container1);
+  gsk_render_node_unref (container2);
+}
+
+static void
+test_diff_signed_zero (void)
+{
+  GskRenderNode *node1, *node2;
+  cairo_region_t *region;
+
+  /* -0.0 == 0.0, so these render the same */
+  node1 = gsk_color_node_new (&(GdkRGBA) { 0, 0, 0, 1 }, &GRAPHENE_RECT_INIT (0.f, 0.f, 10, 10));
+  node2 = gsk_color_node_new (&(GdkRGBA) { -0.f, 0, 0, 1 }, &GRAPHENE_RECT_INIT (-0.f, -0.f, 10, 10));
+
+  g_assert_cmpuint (gsk_render_node_get_hash (node1), ==, gsk_render_node_get_hash (node2));
+
+  region = diff_nodes (node1, node2);
+  g_assert_true (cairo_region_is_empty (region));
+  cairo_region_destroy (region);
+
+  gsk_render_node_unref (node1);
+  gsk_render_node_unref (node2);
+}
+
+static double
+time_diff (GskRenderNode *node1,
+           GskRenderNode *node2,
+           int            n_runs)
+{
+  GTimer *timer;
+  double elapsed;
+  int i;
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_runs; i++)
+    cairo_region_destroy (diff_nodes (node1, node2));
+
+  elapsed = g_timer_elapsed (timer, NULL) / n_runs;
+  g_timer_destroy (timer);
+
+  return elapsed;
+}
+
+static GskRenderNode *
+load_node (const char *filename)
+{
+  GskRenderNode *node;
+  char *contents;
+  gsize length;
+  GBytes *bytes;
+
+  if (!g_file_get_contents (filename, &contents, &length, NULL))
+    return NULL;
+
+  /* Some of the files test error handling, ignore those */
+  bytes = g_bytes_new_take (contents, length);
+  node = gsk_render_node_deserialize (bytes, NULL, NULL);
+  g_bytes_unref (bytes);
+
+  return node;
+}
+
+static void
+test_diff_performance (void)
+{
+  GskRenderNode *node1, *node2, *node3;
+  const char *name;
+  GDir *dir;
+  char *path;
+  double identical, changed, captured;
+  int n_files;
+
+  if (!g_test_perf ())
+    {
+      g_test_skip ("Only run in performance mode");
+      return;
+    }
+
+  /* Synthetic trees, the common case of a window
+   * that snapshots again with hardly any changes */
+  node1 = create_rows (10000, -1);
+  node2 = create_rows (10000, -1);
+  node3 = create_rows (10000, 5000);
+
+  identical = time_diff (node1, node2, 1);
+  changed = time_diff (node1, node3, 1);
+
+  g_test_message ("10000 rows: %.2f msec identical, %.2f msec one row changed",
+                  identical * 1000, changed * 1000);
+  g_test_minimized_result (changed, "%.2f msec to diff 10000 rows with one change", changed * 1000);
+
+  gsk_render_node_unref (node1);
+  gsk_render_node_unref (node2);
+  gsk_render_node_unref (node3);
+
+  /* Captured trees, from the rendering tests */
+  path = g_test_build_filename (G_TEST_DIST, "compare", NULL);
+  dir = g_dir_open (path, 0, NULL);
+  g_assert_nonnull (dir);
+
+  captured = 0;
+  n_files = 0;
+  while ((name = g_dir_read_name (dir)))
+    {
+      char *filename;
+
+      if (!g_str_has_suffix (name, ".node"))
+        continue;
+
+      filename = g_build_filename (path, name, NULL);
+      node1 = load_node (filename);
+      node2 = load_node (filename);
+      g_free (filename);
+
+      if (node1 && node2)
+        {
+          captured += time_diff (node1, node2, 10);
+          n_files++;
+        }
+
+      g_clear_pointer (&node1, gsk_render_node_unref);
+      g_clear_pointer (&node2, gsk_render_node_unref);
+    }
+
+  g_test_message ("%d captured trees: %.2f msec to diff all of them",
+                  n_files, captured * 1000);
+
+  g_dir_close (dir);
+  g_free (path);
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -103,6 +355,10 @@ main (int   argc,
 
   g_test_add_func ("/node/can-diff/basic", test_can_diff_basic);
   g_test_add_func ("/node/can-diff/transform", test_can_diff_transform);
+  g_test_add_func ("/node/diff/identical", test_diff_identical);
+  g_test_add_func ("/node/diff/unhashable", test_diff_unhashable);
+  g_test_add_func ("/node/diff/signed-zero", test_diff_signed_zero);
+  g_test_add_func ("/node/diff/performance", test_diff_performance);
 
   return g_test_run ();
 }
@@ -0,0 +1,315 @@
+#include <gtk/gtk.h>
+#include "gsk/gpu/gskgpudeviceprivate.h"
+#include "gsk/gpu/gskgpuimageprivate.h"
+#include "gsk/gpu/gskgputilesprivate.h"
+
+/* Matches gskgpudevice.c */
+#define MIN_TILE_PIXELS (32 * 1024 * 1024)
+
+#define TILE_SIZE 1024
+
+typedef struct _TestImage TestImage;
+typedef struct _TestImageClass TestImageClass;
+
+struct _TestImage
+{
+  GskGpuImage parent_instance;
+};
+
+struct _TestImageClass
+{
+  GskGpuImageClass parent_class;
+};
+
+G_DEFINE_TYPE (TestImage, test_image, GSK_TYPE_GPU_IMAGE)
+
+static void
+test_image_class_init (TestImageClass *klass)
+{
+}
+
+static void
+test_image_init (TestImage *self)
+{
+}
+
+static GskGpuImage *
+test_image_new (void)
+{
+  GskGpuImage *image;
+
+  image = g_object_new (test_image_get_type (), NULL);
+  gsk_gpu_image_setup (image, 0, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED, TILE_SIZE, TILE_SIZE);
+
+  return image;
+}
+
+typedef struct _TestDevice TestDevice;
+typedef struct _TestDeviceClass TestDeviceClass;
+
+struct _TestDevice
+{
+  GskGpuDevice parent_instance;
+};
+
+struct _TestDeviceClass
+{
+  GskGpuDeviceClass parent_class;
+};
+
+G_DEFINE_TYPE (TestDevice, test_device, GSK_TYPE_GPU_DEVICE)
+
+static void
+test_device_make_current (GskGpuDevice *device)
+{
+}
+
+static void
+test_device_class_init (TestDeviceClass *klass)
+{
+  GSK_GPU_DEVICE_CLASS (klass)->make_current = test_device_make_current;
+}
+
+static void
+test_device_init (TestDevice *self)
+{
+}
+
+static GskGpuDevice *
+test_device_new (void)
+{
+  GskGpuDevice *device;
+
+  device = g_object_new (test_device_get_type (), NULL);
+  gsk_gpu_device_setup (device, gdk_display_get_default (), 4096);
+
+  return device;
+}
+
+static GdkTexture *
+create_texture (void)
+{
+  static const guchar pixel[4] = { 0, 0, 0, 255 };
+  GdkTexture *texture;
+  GBytes *bytes;
+
+  bytes = g_bytes_new_static (pixel, sizeof (pixel));
+  texture = gdk_memory_texture_new (1, 1, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED, bytes, 4);
+  g_bytes_unref (bytes);
+
+  return texture;
+}
+
+/* Caches a tile, and returns a pointer to its image that is
+ * cleared once the cache lets go of the image
+ */
+static void
+cache_tile (GskGpuDevice  *device,
+            GdkTexture    *texture,
+            gsize          tile_id,
+            gint64         timestamp,
+            GskGpuImage  **image)
+{
+  *image = test_image_new ();
+  g_object_add_weak_pointer (G_OBJECT (*image), (gpointer *) image);
+  gsk_gpu_device_cache_tile_image (device, texture, 0, tile_id, timestamp, *image);
+  g_object_unref (*image);
+}
+
+static void
+test_tiles_lod (void)
+{
+  g_assert_cmpuint (gsk_gpu_tiles_get_lod (1000, 1000, 1000, 1000), ==, 0);
+  g_assert_cmpuint (gsk_gpu_tiles_get_lod (1000, 1000, 2000, 2000), ==, 0);
+  g_assert_cmpuint (gsk_gpu_tiles_get_lod (1000, 1000, 501, 501), ==, 0);
+  g_assert_cmpuint (gsk_gpu_tiles_get_lod (1000, 1000, 500, 500), ==, 1);
+  g_assert_cmpuint (gsk_gpu_tiles_get_lod (1000, 1000, 250, 250), ==, 2);
+  /* The level must have enough pixels in both directions */
+  g_assert_cmpuint (gsk_gpu_tiles_get_lod (1000, 1000, 250, 100), ==, 2);
+  g_assert_cmpuint (gsk_gpu_tiles_get_lod (100000, 1000, 1000, 1000), ==, 0);
+}
+
+static void
+test_tiles_range (void)
+{
+  cairo_rectangle_int_t range;
+
+  /* 3x2 tiles, the last ones partial */
+  g_assert_true (gsk_gpu_tiles_get_range (2500, 1500, TILE_SIZE,
+                                          &GRAPHENE_RECT_INIT (0, 0, 2500, 1500),
+                                          &range));
+  g_assert_cmpint (range.x, ==, 0);
+  g_assert_cmpint (range.y, ==, 0);
+  g_assert_cmpint (range.width, ==, 3);
+  g_assert_cmpint (range.height, ==, 2);
+
+  /* Only the tiles the area touches */
+  g_assert_true (gsk_gpu_tiles_get_range (2500, 1500, TILE_SIZE,
+                                          &GRAPHENE_RECT_INIT (1000, 1100, 100, 100),
+                                          &range));
+  g_assert_cmpint (range.x, ==, 0);
+  g_assert_cmpint (range.y, ==, 1);
+  g_assert_cmpint (range.width, ==, 2);
+  g_assert_cmpint (range.height, ==, 1);
+
+  /* Areas are clamped to the texture */
+  g_assert_true (gsk_gpu_tiles_get_range (2500, 1500, TILE_SIZE,
+                                          &GRAPHENE_RECT_INIT (2400, -100, 5000, 200),
+                                          &range));
+  g_assert_cmpint (range.x, ==, 2);
+  g_assert_cmpint (range.y, ==, 0);
+  g_assert_cmpint (range.width, ==, 1);
+  g_assert_cmpint (range.height, ==, 1);
+
+  g_assert_false (gsk_gpu_tiles_get_range (2500, 1500, TILE_SIZE,
+                                           &GRAPHENE_RECT_INIT (2600, 0, 100, 100),
+                                           &range));
+  g_assert_false (gsk_gpu_tiles_get_range (2500, 1500, TILE_SIZE,
+                                           &GRAPHENE_RECT_INIT (-200, -200, 100, 100),
+                                           &range));
+}
+
+static void
+test_tiles_gutter (void)
+{
+  cairo_rectangle_int_t tile, upload;
+
+  gsk_gpu_tiles_get_tile (2500, 1500, TILE_SIZE, 0, 0, &tile, &upload);
+  g_assert_cmpint (tile.x, ==, 0);
+  g_assert_cmpint (tile.width, ==, TILE_SIZE);
+  g_assert_cmpint (upload.x, ==, 0);
+  g_assert_cmpint (upload.y, ==, 0);
+  g_assert_cmpint (upload.width, ==, TILE_SIZE + GSK_GPU_TILE_GUTTER);
+  g_assert_cmpint (upload.height, ==, TILE_SIZE + GSK_GPU_TILE_GUTTER);
+
+  gsk_gpu_tiles_get_tile (2500, 1500, TILE_SIZE, 1, 1, &tile, &upload);
+  g_assert_cmpint (tile.x, ==, TILE_SIZE);
+  g_assert_cmpint (tile.y, ==, TILE_SIZE);
+  g_assert_cmpint (tile.width, ==, TILE_SIZE);
+  g_assert_cmpint (tile.height, ==, 1500 - TILE_SIZE);
+  g_assert_cmpint (upload.x, ==, TILE_SIZE - GSK_GPU_TILE_GUTTER);
+  g_assert_cmpint (upload.y, ==, TILE_SIZE - GSK_GPU_TILE_GUTTER);
+  g_assert_cmpint (upload.width, ==, TILE_SIZE + 2 * GSK_GPU_TILE_GUTTER);
+  g_assert_cmpint (upload.height, ==, 1500 - TILE_SIZE + GSK_GPU_TILE_GUTTER);
+
+  gsk_gpu_tiles_get_tile (2500, 1500, TILE_SIZE, 2, 0, &tile, &upload);
+  g_assert_cmpint (tile.x, ==, 2 * TILE_SIZE);
+  g_assert_cmpint (tile.width, ==, 2500 - 2 * TILE_SIZE);
+  g_assert_cmpint (upload.x, ==, 2 * TILE_SIZE - GSK_GPU_TILE_GUTTER);
+  g_assert_cmpint (upload.width, ==, 2500 - 2 * TILE_SIZE + GSK_GPU_TILE_GUTTER);
+}
+
+#define N_FIRST 40
+#define N_SECOND 20
+
+static void
+test_tiles_lru (void)
+{
+  GskGpuImage *first[N_FIRST], *second[N_SECOND];
+  GskGpuDevice *device;
+  GdkTexture *texture;
+  GskGpuImage *image;
+  gsize i, n_cached, n_frame, n_evicted;
+
+  g_assert_cmpint (N_FIRST * TILE_SIZE * TILE_SIZE, >, MIN_TILE_PIXELS);
+
+  device = test_device_new ();
+  texture = create_texture ();
+
+  /* Tiles needed by the current frame are kept, even beyond the budget */
+  for (i = 0; i < N_FIRST; i++)
+    cache_tile (device, texture, i, 1, &first[i]);
+  for (i = 0; i < N_FIRST; i++)
+    g_assert_nonnull (first[i]);
+
+  /* Using a tile makes it the most recently used one */
+  image = gsk_gpu_device_lookup_tile_image (device, texture, 0, 0, 2);
+  g_assert_true (image == first[0]);
+  g_object_unref (image);
+
+  for (i = 0; i < N_SECOND; i++)
+    cache_tile (device, texture, 100 + i, 2, &second[i]);
+
+  /* The budget is twice the tiles of the frame, but at least
+   * MIN_TILE_PIXELS. Whatever exceeds it is evicted, least
+   * recently used first.
+   */
+  n_cached = N_FIRST;
+  n_frame = 1;
+  n_evicted = 0;
+  for (i = 0; i < N_SECOND; i++)
+    {
+      n_cached++;
+      n_frame++;
+      while (n_cached > MAX (MIN_TILE_PIXELS / (TILE_SIZE * TILE_SIZE), 2 * n_frame))
+        {
+          n_cached--;
+          n_evicted++;
+        }
+    }
+  g_assert_cmpuint (n_evicted, >, 0);
+
+  g_assert_nonnull (first[0]);
+  for (i = 1; i < N_FIRST; i++)
+    {
+      if (i <= n_evicted)
+        {
+          /* Evicted tiles are freed right away, not when the texture goes */
+          g_assert_null (first[i]);
+          g_assert_null (gsk_gpu_device_lookup_tile_image (device, texture, 0, i, 2));
+        }
+      else
+        {
+          g_assert_nonnull (first[i]);
+        }
+    }
+  for (i = 0; i < N_SECOND; i++)
+    g_assert_nonnull (second[i]);
+
+  g_object_unref (device);
+  for (i = 0; i < N_FIRST; i++)
+    g_assert_null (first[i]);
+  for (i = 0; i < N_SECOND; i++)
+    g_assert_null (second[i]);
+
+  g_object_unref (texture);
+}
+
+static void
+test_tiles_texture_gone (void)
+{
+  GskGpuImage *images[2];
+  GskGpuDevice *device;
+  GdkTexture *texture;
+
+  device = test_device_new ();
+  texture = create_texture ();
+
+  cache_tile (device, texture, 0, 1, &images[0]);
+  cache_tile (device, texture, 1, 1, &images[1]);
+  g_assert_nonnull (images[0]);
+  g_assert_nonnull (images[1]);
+
+  /* The tiles become dead pixels, which makes the next frame collect them */
+  g_object_unref (texture);
+  gsk_gpu_device_maybe_gc (device);
+
+  g_assert_null (images[0]);
+  g_assert_null (images[1]);
+
+  g_object_unref (device);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/gpu/tiles/lod", test_tiles_lod);
+  g_test_add_func ("/gpu/tiles/range", test_tiles_range);
+  g_test_add_func ("/gpu/tiles/gutter", test_tiles_gutter);
+  g_test_add_func ("/gpu/tiles/lru", test_tiles_lru);
+  g_test_add_func ("/gpu/tiles/texture-gone", test_tiles_texture_gone);
+
+  return g_test_run ();
+}
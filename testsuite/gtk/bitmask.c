@@ -192,6 +192,57 @@ test_union (void)
     }
 }
 
+static void
+test_xor (void)
+{
+  GtkBitmask *left, *right, *expected;
+  gsize bits[MAX_INDEX / (8 * sizeof (gsize)) + 1];
+  guint run, try, i;
+
+  for (run = 0; run < N_RUNS; run++)
+    {
+      left = _gtk_bitmask_new ();
+      right = _gtk_bitmask_new ();
+      expected = _gtk_bitmask_new ();
+      memset (bits, 0, sizeof (bits));
+
+      for (try = 0; try < N_TRIES; try++)
+        {
+          guint id = g_test_rand_int_range (0, MAX_INDEX);
+
+          if (g_test_rand_bit ())
+            left = _gtk_bitmask_set (left, id, !_gtk_bitmask_get (left, id));
+          else
+            right = _gtk_bitmask_set (right, id, !_gtk_bitmask_get (right, id));
+
+          expected = _gtk_bitmask_set (expected, id, !_gtk_bitmask_get (expected, id));
+        }
+
+      _gtk_bitmask_xor_into (left, bits, G_N_ELEMENTS (bits));
+      _gtk_bitmask_xor_into (right, bits, G_N_ELEMENTS (bits));
+      for (i = 0; i < MAX_INDEX; i++)
+        {
+          gboolean set = (bits[i / (8 * sizeof (gsize))] >> (i % (8 * sizeof (gsize)))) & 1;
+          g_assert_cmpint (set, ==, _gtk_bitmask_get (expected, i));
+        }
+
+      left = _gtk_bitmask_xor (left, right);
+      assert_cmpmasks (left, expected);
+
+      /* xoring twice gives back the original */
+      left = _gtk_bitmask_xor (left, right);
+      left = _gtk_bitmask_xor (left, right);
+      assert_cmpmasks (left, expected);
+
+      left = _gtk_bitmask_xor (left, expected);
+      g_assert_true (_gtk_bitmask_is_empty (left));
+
+      _gtk_bitmask_free (left);
+      _gtk_bitmask_free (right);
+      _gtk_bitmask_free (expected);
+    }
+}
+
 static void
 test_intersect (void)
 {
@@ -468,6 +519,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/bitmask/equals", test_equals);
   g_test_add_func ("/bitmask/set", test_set);
   g_test_add_func ("/bitmask/union", test_union);
+  g_test_add_func ("/bitmask/xor", test_xor);
   g_test_add_func ("/bitmask/intersect", test_intersect);
   g_test_add_func ("/bitmask/intersect_hardcoded", test_intersect_hardcoded);
   g_test_add_func ("/bitmask/subtract_hardcoded", test_subtract_hardcoded);
@@ -360,6 +360,133 @@ constraint_solver_paper (void)
   g_object_unref (solver);
 }
 
+static void
+constraint_solver_edit_var_persistent (void)
+{
+  GtkConstraintSolver *solver = gtk_constraint_solver_new ();
+
+  GtkConstraintVariable *width = gtk_constraint_solver_create_variable (solver, NULL, "width", 0.0);
+  GtkConstraintVariable *half = gtk_constraint_solver_create_variable (solver, NULL, "half", 0.0);
+  int i;
+
+  GtkConstraintExpression *e = gtk_constraint_expression_new_from_variable (width);
+  gtk_constraint_expression_multiply_by (e, 0.5);
+  gtk_constraint_solver_add_constraint (solver,
+                                        half, GTK_CONSTRAINT_RELATION_EQ, e,
+                                        GTK_CONSTRAINT_STRENGTH_REQUIRED);
+
+  gtk_constraint_solver_add_edit_variable (solver, width, GTK_CONSTRAINT_STRENGTH_STRONG * 2);
+
+  for (i = 1; i <= 3; i++)
+    {
+      gtk_constraint_solver_begin_edit (solver);
+      gtk_constraint_solver_suggest_value (solver, width, 100.0 * i);
+      gtk_constraint_solver_end_edit (solver);
+
+      /* The edit variable is still there for the next edit phase */
+      g_assert_true (gtk_constraint_solver_has_edit_variable (solver, width));
+
+      g_assert_cmpfloat_with_epsilon (gtk_constraint_variable_get_value (width), 100.0 * i, 0.001);
+      g_assert_cmpfloat_with_epsilon (gtk_constraint_variable_get_value (half), 50.0 * i, 0.001);
+    }
+
+  gtk_constraint_solver_remove_edit_variable (solver, width);
+  g_assert_false (gtk_constraint_solver_has_edit_variable (solver, width));
+
+  gtk_constraint_variable_unref (width);
+  gtk_constraint_variable_unref (half);
+
+  g_object_unref (solver);
+}
+
+static void
+constraint_solver_edit_var_strength (void)
+{
+  GtkConstraintSolver *solver = gtk_constraint_solver_new ();
+
+  GtkConstraintVariable *width = gtk_constraint_solver_create_variable (solver, NULL, "width", 0.0);
+
+  gtk_constraint_solver_add_constraint (solver,
+                                        width, GTK_CONSTRAINT_RELATION_EQ,
+                                        gtk_constraint_expression_new (50.0),
+                                        GTK_CONSTRAINT_STRENGTH_MEDIUM);
+
+  gtk_constraint_solver_add_edit_variable (solver, width, GTK_CONSTRAINT_STRENGTH_STRONG * 2);
+
+  gtk_constraint_solver_begin_edit (solver);
+  gtk_constraint_solver_suggest_value (solver, width, 200.0);
+  gtk_constraint_solver_end_edit (solver);
+
+  g_assert_cmpfloat_with_epsilon (gtk_constraint_variable_get_value (width), 200.0, 0.001);
+
+  /* A relaxed edit variable is ignored, but stays editable */
+  gtk_constraint_solver_set_edit_strength (solver, width, 0);
+  g_assert_true (gtk_constraint_solver_has_edit_variable (solver, width));
+  g_assert_cmpfloat_with_epsilon (gtk_constraint_variable_get_value (width), 50.0, 0.001);
+
+  gtk_constraint_solver_begin_edit (solver);
+  gtk_constraint_solver_suggest_value (solver, width, 300.0);
+  gtk_constraint_solver_end_edit (solver);
+
+  g_assert_cmpfloat_with_epsilon (gtk_constraint_variable_get_value (width), 50.0, 0.001);
+
+  gtk_constraint_solver_set_edit_strength (solver, width, GTK_CONSTRAINT_STRENGTH_STRONG * 2);
+  g_assert_cmpfloat_with_epsilon (gtk_constraint_variable_get_value (width), 300.0, 0.001);
+
+  gtk_constraint_solver_remove_edit_variable (solver, width);
+
+  gtk_constraint_variable_unref (width);
+
+  g_object_unref (solver);
+}
+
+static void
+constraint_solver_long_expression (void)
+{
+  GtkConstraintSolver *solver = gtk_constraint_solver_new ();
+  GtkConstraintVariable *vars[40];
+  GtkConstraintExpressionIter iter;
+  GtkConstraintExpression *e;
+  GtkConstraintVariable *v;
+  double c;
+  int i;
+
+  e = gtk_constraint_expression_new (0.0);
+
+  for (i = 0; i < G_N_ELEMENTS (vars); i++)
+    {
+      vars[i] = gtk_constraint_solver_create_variable (solver, NULL, "v", 0.0);
+      gtk_constraint_expression_add_variable (e, vars[i], i + 1, NULL, NULL);
+    }
+
+  /* Cancel out every other term */
+  for (i = 0; i < G_N_ELEMENTS (vars); i += 2)
+    gtk_constraint_expression_add_variable (e, vars[i], -(i + 1), NULL, NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (vars); i++)
+    g_assert_cmpfloat_with_epsilon (gtk_constraint_expression_get_coefficient (e, vars[i]),
+                                    i % 2 ? i + 1 : 0.0,
+                                    0.001);
+
+  /* The remaining terms keep their order */
+  i = 1;
+  gtk_constraint_expression_iter_init (&iter, e);
+  while (gtk_constraint_expression_iter_next (&iter, &v, &c))
+    {
+      g_assert_true (v == vars[i]);
+      g_assert_cmpfloat_with_epsilon (c, i + 1, 0.001);
+      i += 2;
+    }
+  g_assert_cmpint (i, ==, G_N_ELEMENTS (vars) + 1);
+
+  gtk_constraint_expression_unref (e);
+
+  for (i = 0; i < G_N_ELEMENTS (vars); i++)
+    gtk_constraint_variable_unref (vars[i]);
+
+  g_object_unref (solver);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -376,6 +503,9 @@ main (int argc, char *argv[])
   g_test_add_func ("/constraint-solver/cassowary", constraint_solver_cassowary);
   g_test_add_func ("/constraint-solver/edit/required", constraint_solver_edit_var_required);
   g_test_add_func ("/constraint-solver/edit/suggest", constraint_solver_edit_var_suggest);
+  g_test_add_func ("/constraint-solver/edit/persistent", constraint_solver_edit_var_persistent);
+  g_test_add_func ("/constraint-solver/edit/strength", constraint_solver_edit_var_strength);
+  g_test_add_func ("/constraint-solver/expression/long", constraint_solver_long_expression);
 
   return g_test_run ();
 }
@@ -0,0 +1,331 @@
+/* GtkDirectoryList tests.
+ *
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <locale.h>
+
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+
+/* How long to wait for the file monitor to catch up */
+#define TIMEOUT_SECONDS 30
+
+typedef struct {
+  char *path;
+  GHashTable *expected; /* names of the files in the directory */
+  GPtrArray *names; /* the list as seen through items-changed */
+  guint n_changes;
+} Fixture;
+
+static char *
+get_name (GListModel *model,
+          guint       position)
+{
+  GFileInfo *info = g_list_model_get_item (model, position);
+  char *name = g_strdup (g_file_info_get_name (info));
+
+  g_object_unref (info);
+
+  return name;
+}
+
+static void
+items_changed (GListModel *model,
+               guint       position,
+               guint       removed,
+               guint       added,
+               Fixture    *fixture)
+{
+  guint i;
+
+  g_assert_cmpuint (position + removed, <=, fixture->names->len);
+
+  g_ptr_array_remove_range (fixture->names, position, removed);
+  for (i = 0; i < added; i++)
+    g_ptr_array_insert (fixture->names, position + i, get_name (model, position + i));
+
+  g_assert_cmpuint (fixture->names->len, ==, g_list_model_get_n_items (model));
+
+  fixture->n_changes++;
+}
+
+static void
+create_file (Fixture    *fixture,
+             const char *name)
+{
+  char *filename = g_build_filename (fixture->path, name, NULL);
+
+  /* Write in place, so changes are seen as changes */
+  g_assert_true (g_file_set_contents_full (filename, name, -1, G_FILE_SET_CONTENTS_NONE, 0666, NULL));
+  g_hash_table_add (fixture->expected, g_strdup (name));
+
+  g_free (filename);
+}
+
+static void
+delete_file (Fixture    *fixture,
+             const char *name)
+{
+  char *filename = g_build_filename (fixture->path, name, NULL);
+
+  g_assert_cmpint (g_unlink (filename), ==, 0);
+  g_hash_table_remove (fixture->expected, name);
+
+  g_free (filename);
+}
+
+static void
+rename_file (Fixture    *fixture,
+             const char *name,
+             const char *new_name)
+{
+  char *filename = g_build_filename (fixture->path, name, NULL);
+  char *new_filename = g_build_filename (fixture->path, new_name, NULL);
+
+  g_assert_cmpint (g_rename (filename, new_filename), ==, 0);
+  g_hash_table_remove (fixture->expected, name);
+  g_hash_table_add (fixture->expected, g_strdup (new_name));
+
+  g_free (filename);
+  g_free (new_filename);
+}
+
+static const char *
+pick_file (Fixture *fixture)
+{
+  GHashTableIter iter;
+  gpointer name;
+  guint n;
+
+  n = g_test_rand_int_range (0, g_hash_table_size (fixture->expected));
+  g_hash_table_iter_init (&iter, fixture->expected);
+  do
+    g_hash_table_iter_next (&iter, &name, NULL);
+  while (n-- > 0);
+
+  return name;
+}
+
+static gboolean
+model_matches (GListModel *model,
+               Fixture    *fixture)
+{
+  guint i, n_items;
+
+  n_items = g_list_model_get_n_items (model);
+  if (n_items != g_hash_table_size (fixture->expected))
+    return FALSE;
+
+  for (i = 0; i < n_items; i++)
+    {
+      char *name = get_name (model, i);
+      gboolean found = g_hash_table_contains (fixture->expected, name);
+
+      g_free (name);
+      if (!found)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+timeout_cb (gpointer data)
+{
+  gboolean *timed_out = data;
+
+  *timed_out = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+loading_changed (GtkDirectoryList *list,
+                 GParamSpec       *pspec,
+                 gboolean         *loaded)
+{
+  *loaded = !gtk_directory_list_is_loading (list);
+}
+
+static void
+wait_for_loaded (GtkDirectoryList *list)
+{
+  gboolean loaded = !gtk_directory_list_is_loading (list);
+  gulong handler;
+
+  handler = g_signal_connect (list, "notify::loading", G_CALLBACK (loading_changed), &loaded);
+
+  while (!loaded)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (list, handler);
+}
+
+/* The loading property only covers the initial enumeration, so
+ * monitor events are waited for by blocking until items-changed
+ */
+static void
+wait_for_match (GtkDirectoryList *list,
+                Fixture          *fixture)
+{
+  gboolean timed_out = FALSE;
+  guint n_changes = G_MAXUINT;
+  guint id;
+
+  id = g_timeout_add_seconds (TIMEOUT_SECONDS, timeout_cb, &timed_out);
+
+  while (!timed_out)
+    {
+      if (n_changes != fixture->n_changes)
+        {
+          n_changes = fixture->n_changes;
+          if (model_matches (G_LIST_MODEL (list), fixture))
+            break;
+        }
+
+      g_main_context_iteration (NULL, TRUE);
+    }
+
+  if (!timed_out)
+    g_source_remove (id);
+}
+
+static void
+test_stress (void)
+{
+  Fixture fixture;
+  GtkDirectoryList *list;
+  GFile *dir;
+  guint n_files, n_events, n_created;
+  GTimer *timer;
+  guint i;
+  GHashTableIter iter;
+  gpointer name;
+
+  n_files = g_test_slow () ? 100000 : 5000;
+  n_events = n_files / 2;
+
+  fixture.path = g_dir_make_tmp ("gtk-directorylist-XXXXXX", NULL);
+  g_assert_nonnull (fixture.path);
+  fixture.expected = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  fixture.names = g_ptr_array_new_with_free_func (g_free);
+  fixture.n_changes = 0;
+
+  for (i = 0; i < n_files; i++)
+    {
+      char *file_name = g_strdup_printf ("file-%u", i);
+      create_file (&fixture, file_name);
+      g_free (file_name);
+    }
+  n_created = n_files;
+
+  dir = g_file_new_for_path (fixture.path);
+  list = gtk_directory_list_new ("standard::name", dir);
+  wait_for_loaded (list);
+  g_assert_no_error (gtk_directory_list_get_error (list));
+  g_assert_true (model_matches (G_LIST_MODEL (list), &fixture));
+
+  for (i = 0; i < g_list_model_get_n_items (G_LIST_MODEL (list)); i++)
+    g_ptr_array_add (fixture.names, get_name (G_LIST_MODEL (list), i));
+  g_signal_connect (list, "items-changed", G_CALLBACK (items_changed), &fixture);
+
+  for (i = 0; i < n_events; i++)
+    {
+      char *file_name;
+
+      switch (g_test_rand_int_range (0, 4))
+        {
+        case 0:
+          file_name = g_strdup_printf ("file-%u", n_created++);
+          create_file (&fixture, file_name);
+          g_free (file_name);
+          break;
+
+        case 1:
+          delete_file (&fixture, pick_file (&fixture));
+          break;
+
+        case 2:
+          file_name = g_strdup (pick_file (&fixture));
+          create_file (&fixture, file_name);
+          g_free (file_name);
+          break;
+
+        case 3:
+          file_name = g_strdup_printf ("file-%u", n_created++);
+          rename_file (&fixture, pick_file (&fixture), file_name);
+          g_free (file_name);
+          break;
+
+        default:
+          g_assert_not_reached ();
+        }
+    }
+
+  timer = g_timer_new ();
+  wait_for_match (list, &fixture);
+
+  if (fixture.n_changes == 0)
+    {
+      g_test_skip ("File monitoring does not work");
+    }
+  else
+    {
+      g_test_message ("%u events handled in %.2f msec with %u emissions of items-changed",
+                      n_events, g_timer_elapsed (timer, NULL) * 1000, fixture.n_changes);
+
+      g_assert_true (model_matches (G_LIST_MODEL (list), &fixture));
+
+      /* The changes that were emitted add up to the list */
+      g_assert_cmpuint (fixture.names->len, ==, g_list_model_get_n_items (G_LIST_MODEL (list)));
+      for (i = 0; i < fixture.names->len; i++)
+        {
+          char *file_name = get_name (G_LIST_MODEL (list), i);
+          g_assert_cmpstr (file_name, ==, g_ptr_array_index (fixture.names, i));
+          g_free (file_name);
+        }
+    }
+
+  g_signal_handlers_disconnect_by_func (list, items_changed, &fixture);
+  g_object_unref (list);
+  g_object_unref (dir);
+  g_timer_destroy (timer);
+
+  g_hash_table_iter_init (&iter, fixture.expected);
+  while (g_hash_table_iter_next (&iter, &name, NULL))
+    {
+      char *filename = g_build_filename (fixture.path, name, NULL);
+      g_unlink (filename);
+      g_free (filename);
+    }
+  g_rmdir (fixture.path);
+
+  g_free (fixture.path);
+  g_hash_table_unref (fixture.expected);
+  g_ptr_array_unref (fixture.names);
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, NULL);
+  setlocale (LC_ALL, "C");
+
+  g_test_add_func ("/directorylist/stress", test_stress);
+
+  return g_test_run ();
+}
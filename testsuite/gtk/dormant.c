@@ -0,0 +1,219 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <locale.h>
+
+#include <gtk/gtk.h>
+#include "gtk/gtkcssnodeprivate.h"
+#include "gtk/gtkcssstaticstyleprivate.h"
+#include "gtk/gtkwidgetprivate.h"
+
+static void
+test_styles (void)
+{
+  GtkWidget *box, *label;
+  GtkCssNode *node;
+  GtkCssStyle *style;
+
+  box = g_object_ref_sink (gtk_box_new (GTK_ORIENTATION_VERTICAL, 0));
+  label = gtk_label_new ("Some text");
+  gtk_box_append (GTK_BOX (box), label);
+
+  node = gtk_widget_get_css_node (label);
+  style = gtk_css_node_get_style (node);
+  g_assert_true (style != gtk_css_static_style_get_default ());
+
+  gtk_widget_set_dormant (box, TRUE);
+  g_assert_false (gtk_css_node_get_visible (gtk_widget_get_css_node (box)));
+  g_assert_true (node->style == gtk_css_static_style_get_default ());
+
+  gtk_widget_set_dormant (box, FALSE);
+  g_assert_true (gtk_css_node_get_visible (gtk_widget_get_css_node (box)));
+  style = gtk_css_node_get_style (node);
+  g_assert_true (style != gtk_css_static_style_get_default ());
+
+  /* Hidden widgets stay hidden when they are woken up */
+  gtk_widget_set_visible (box, FALSE);
+  gtk_widget_set_dormant (box, TRUE);
+  gtk_widget_set_visible (box, TRUE);
+  g_assert_false (gtk_css_node_get_visible (gtk_widget_get_css_node (box)));
+  gtk_widget_set_visible (box, FALSE);
+  gtk_widget_set_dormant (box, FALSE);
+  g_assert_false (gtk_css_node_get_visible (gtk_widget_get_css_node (box)));
+
+  g_object_unref (box);
+}
+
+static void
+test_unrealize (void)
+{
+  GtkWidget *window, *stack, *page1, *page2;
+
+  window = gtk_window_new ();
+  stack = gtk_stack_new ();
+  gtk_window_set_child (GTK_WINDOW (window), stack);
+
+  page1 = gtk_label_new ("Page 1");
+  page2 = gtk_label_new ("Page 2");
+  gtk_stack_add_named (GTK_STACK (stack), page1, "page1");
+  gtk_stack_add_named (GTK_STACK (stack), page2, "page2");
+
+  gtk_window_present (GTK_WINDOW (window));
+  gtk_stack_set_visible_child (GTK_STACK (stack), page2);
+  gtk_widget_realize (page1);
+  g_assert_true (gtk_widget_get_realized (page1));
+  g_assert_false (gtk_widget_get_mapped (page1));
+
+  gtk_widget_set_dormant (page1, TRUE);
+  g_assert_false (gtk_widget_get_realized (page1));
+
+  /* Removing the widget wakes it up */
+  g_object_ref (page1);
+  gtk_stack_remove (GTK_STACK (stack), page1);
+  g_assert_true (gtk_css_node_get_visible (gtk_widget_get_css_node (page1)));
+  g_object_unref (page1);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static gboolean
+is_dormant (GtkWidget *widget)
+{
+  return gtk_widget_get_visible (widget) &&
+         !gtk_widget_get_realized (widget) &&
+         !gtk_css_node_get_visible (gtk_widget_get_css_node (widget));
+}
+
+static gboolean
+timeout_cb (gpointer data)
+{
+  gboolean *timed_out = data;
+
+  *timed_out = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Hidden pages are put to sleep after a few seconds */
+static void
+wait_until_dormant (GtkWidget *widget)
+{
+  gboolean timed_out = FALSE;
+  guint id;
+
+  id = g_timeout_add_seconds (15, timeout_cb, &timed_out);
+
+  while (!timed_out && !is_dormant (widget))
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_false (timed_out);
+  g_source_remove (id);
+}
+
+static void
+test_stack_virtualized (void)
+{
+  GtkWidget *window, *stack, *page1, *page2;
+  GtkCssNode *node;
+  int min, nat, width;
+
+  window = gtk_window_new ();
+  stack = gtk_stack_new ();
+  gtk_stack_set_virtualized (GTK_STACK (stack), TRUE);
+  gtk_window_set_child (GTK_WINDOW (window), stack);
+
+  page1 = gtk_label_new ("Page 1");
+  page2 = gtk_label_new ("Page 2");
+  gtk_stack_add_named (GTK_STACK (stack), page1, "page1");
+  gtk_stack_add_named (GTK_STACK (stack), page2, "page2");
+
+  gtk_window_present (GTK_WINDOW (window));
+  gtk_stack_set_visible_child (GTK_STACK (stack), page2);
+
+  gtk_widget_measure (page1, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &width, NULL, NULL);
+
+  wait_until_dormant (page1);
+  g_assert_false (is_dormant (page2));
+
+  node = gtk_widget_get_css_node (page1);
+  g_assert_true (node->style == gtk_css_static_style_get_default ());
+
+  /* The sleeping page of the homogeneous stack is still measured */
+  gtk_widget_measure (stack, GTK_ORIENTATION_HORIZONTAL, -1, &min, &nat, NULL, NULL);
+  g_assert_cmpint (nat, >=, width);
+  g_assert_true (is_dormant (page1));
+
+  /* A sleeping page that changes size is woken up for measuring */
+  gtk_label_set_label (GTK_LABEL (page1), "Page 1 with a much longer label");
+  gtk_widget_measure (stack, GTK_ORIENTATION_HORIZONTAL, -1, &min, &nat, NULL, NULL);
+  g_assert_false (is_dormant (page1));
+
+  wait_until_dormant (page1);
+
+  /* Showing the page wakes it up and gives it its style back */
+  gtk_stack_set_visible_child (GTK_STACK (stack), page1);
+  g_assert_false (is_dormant (page1));
+  g_assert_true (gtk_css_node_get_style (node) != gtk_css_static_style_get_default ());
+
+  gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_notebook_virtualized (void)
+{
+  GtkWidget *window, *notebook, *page1, *page2;
+
+  window = gtk_window_new ();
+  notebook = gtk_notebook_new ();
+  gtk_notebook_set_virtualized (GTK_NOTEBOOK (notebook), TRUE);
+  g_assert_true (gtk_notebook_get_virtualized (GTK_NOTEBOOK (notebook)));
+  gtk_window_set_child (GTK_WINDOW (window), notebook);
+
+  page1 = gtk_label_new ("Page 1");
+  page2 = gtk_label_new ("Page 2");
+  gtk_notebook_append_page (GTK_NOTEBOOK (notebook), page1, NULL);
+  gtk_notebook_append_page (GTK_NOTEBOOK (notebook), page2, NULL);
+
+  gtk_window_present (GTK_WINDOW (window));
+  gtk_notebook_set_current_page (GTK_NOTEBOOK (notebook), 1);
+
+  wait_until_dormant (page1);
+  g_assert_false (is_dormant (page2));
+
+  gtk_notebook_set_current_page (GTK_NOTEBOOK (notebook), 0);
+  g_assert_false (is_dormant (page1));
+
+  /* Turning virtualization off wakes up all pages */
+  wait_until_dormant (page2);
+  gtk_notebook_set_virtualized (GTK_NOTEBOOK (notebook), FALSE);
+  g_assert_false (is_dormant (page2));
+
+  gtk_window_destroy (GTK_WINDOW (window));
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/dormant/styles", test_styles);
+  g_test_add_func ("/dormant/unrealize", test_unrealize);
+  g_test_add_func ("/dormant/stack-virtualized", test_stack_virtualized);
+  g_test_add_func ("/dormant/notebook-virtualized", test_notebook_virtualized);
+
+  return g_test_run ();
+}
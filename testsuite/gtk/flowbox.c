@@ -48,12 +48,127 @@ test_measure_crash (void)
   gtk_window_destroy (GTK_WINDOW (window));
 }
 
+static GtkWidget *
+create_label (gpointer item,
+              gpointer data)
+{
+  return gtk_label_new (gtk_string_object_get_string (item));
+}
+
+static gboolean
+timed_out_cb (gpointer data)
+{
+  gboolean *timed_out = data;
+
+  *timed_out = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+wait_until (gboolean (* condition) (GtkFlowBox *box),
+            GtkFlowBox *box)
+{
+  gboolean timed_out = FALSE;
+  guint id;
+
+  id = g_timeout_add_seconds (5, timed_out_cb, &timed_out);
+
+  while (!condition (box) && !timed_out)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_false (timed_out);
+  g_source_remove (id);
+}
+
+static gboolean
+is_allocated (GtkFlowBox *box)
+{
+  return gtk_widget_get_height (GTK_WIDGET (box)) > 0;
+}
+
+static gboolean
+first_children_released (GtkFlowBox *box)
+{
+  return gtk_flow_box_get_child_at_index (box, 1) == NULL;
+}
+
+static gboolean
+last_child_focused (GtkFlowBox *box)
+{
+  GtkWidget *focus;
+
+  focus = gtk_root_get_focus (gtk_widget_get_root (GTK_WIDGET (box)));
+  if (focus == NULL || !GTK_IS_FLOW_BOX_CHILD (focus))
+    return FALSE;
+
+  return gtk_flow_box_child_get_index (GTK_FLOW_BOX_CHILD (focus)) == 9999;
+}
+
+static void
+test_virtualized_scroll (void)
+{
+  GtkWidget *window, *sw;
+  GtkFlowBox *box;
+  GtkStringList *model;
+  GtkFlowBoxChild *child;
+  GtkAdjustment *vadjustment;
+  GList *selected;
+  gboolean handled;
+  int i;
+
+  model = gtk_string_list_new (NULL);
+  for (i = 0; i < 10000; i++)
+    {
+      char *s = g_strdup_printf ("%d", i);
+      gtk_string_list_append (model, s);
+      g_free (s);
+    }
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 200, 400);
+  sw = gtk_scrolled_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), sw);
+  box = GTK_FLOW_BOX (gtk_flow_box_new ());
+  gtk_flow_box_set_virtualized (box, TRUE);
+  gtk_flow_box_bind_model (box, G_LIST_MODEL (model), create_label, NULL, NULL);
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), GTK_WIDGET (box));
+  vadjustment = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (sw));
+  gtk_flow_box_set_vadjustment (box, vadjustment);
+  gtk_window_present (GTK_WINDOW (window));
+
+  wait_until (is_allocated, box);
+  child = gtk_flow_box_get_child_at_index (box, 0);
+  gtk_flow_box_select_child (box, child);
+
+  /* The selected child is kept when scrolled out of view */
+  gtk_adjustment_set_value (vadjustment, gtk_adjustment_get_upper (vadjustment) / 2);
+  wait_until (first_children_released, box);
+  g_assert_true (gtk_flow_box_get_child_at_index (box, 0) == child);
+  selected = gtk_flow_box_get_selected_children (box);
+  g_assert_nonnull (g_list_find (selected, child));
+  g_list_free (selected);
+
+  /* The cursor can move past the children in view */
+  g_signal_emit_by_name (box, "move-cursor", GTK_MOVEMENT_BUFFER_ENDS, 1, FALSE, FALSE, &handled);
+  g_assert_true (handled);
+  wait_until (last_child_focused, box);
+  selected = gtk_flow_box_get_selected_children (box);
+  g_assert_cmpuint (g_list_length (selected), ==, 1);
+  g_assert_cmpint (gtk_flow_box_child_get_index (selected->data), ==, 9999);
+  g_list_free (selected);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+  g_object_unref (model);
+}
+
 int
 main (int argc, char *argv[])
 {
   gtk_test_init (&argc, &argv);
 
   g_test_add_func ("/flowbox/measure-crash", test_measure_crash);
+  g_test_add_func ("/flowbox/virtualized-scroll", test_virtualized_scroll);
 
   return g_test_run ();
 }
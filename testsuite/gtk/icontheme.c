@@ -644,6 +644,45 @@ test_list (void)
   g_strfreev (icons);
 }
 
+static gboolean
+sizes_contain (const int *sizes,
+               int        size)
+{
+  for (; *sizes != 0; sizes++)
+    {
+      if (*sizes == size)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+test_icon_sizes (void)
+{
+  GtkIconTheme *theme;
+  int *sizes;
+
+  theme = get_test_icontheme (FALSE);
+
+  sizes = gtk_icon_theme_get_icon_sizes (theme, "size-test");
+  g_assert_true (sizes_contain (sizes, 15));
+  g_assert_true (sizes_contain (sizes, 19));
+  g_assert_true (sizes_contain (sizes, -1));
+  g_assert_cmpint (sizes[3], ==, 0);
+  g_free (sizes);
+
+  /* Only in the inherited theme */
+  sizes = gtk_icon_theme_get_icon_sizes (theme, "one-two-three-symbolic");
+  g_assert_cmpint (sizes[0], ==, -1);
+  g_assert_cmpint (sizes[1], ==, 0);
+  g_free (sizes);
+
+  sizes = gtk_icon_theme_get_icon_sizes (theme, "does-not-exist");
+  g_assert_cmpint (sizes[0], ==, 0);
+  g_free (sizes);
+}
+
 static void
 test_inherit (void)
 {
@@ -766,6 +805,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/icontheme/svg-size", test_svg_size);
   g_test_add_func ("/icontheme/size", test_size);
   g_test_add_func ("/icontheme/list", test_list);
+  g_test_add_func ("/icontheme/icon-sizes", test_icon_sizes);
   g_test_add_func ("/icontheme/inherit", test_inherit);
   g_test_add_func ("/icontheme/nonsquare-symbolic", test_nonsquare_symbolic);
   g_test_add_func ("/icontheme/lookup_order0", test_lookup_order0);
@@ -0,0 +1,206 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+#include "gtk/gtkidleschedulerprivate.h"
+
+typedef struct
+{
+  GString *log;
+  char name;
+  int n_runs;
+  guint id;
+} TaskData;
+
+static gboolean
+count_task (gpointer data,
+            gint64   deadline)
+{
+  TaskData *task = data;
+
+  g_assert_cmpint (deadline, >, 0);
+
+  g_string_append_c (task->log, task->name);
+  task->n_runs--;
+
+  if (task->n_runs > 0)
+    return G_SOURCE_CONTINUE;
+
+  task->id = 0;
+  return G_SOURCE_REMOVE;
+}
+
+static void
+run_until_done (TaskData *tasks,
+                guint     n_tasks)
+{
+  gboolean done;
+  guint i;
+
+  do
+    {
+      g_main_context_iteration (NULL, TRUE);
+
+      done = TRUE;
+      for (i = 0; i < n_tasks; i++)
+        done &= tasks[i].id == 0;
+    }
+  while (!done);
+}
+
+static void
+test_priority (void)
+{
+  GString *log = g_string_new (NULL);
+  TaskData tasks[] = {
+    { log, 'b', 2, 0 },
+    { log, 'v', 2, 0 },
+  };
+
+  tasks[0].id = gtk_idle_scheduler_add (GTK_IDLE_TASK_BACKGROUND, count_task, &tasks[0], NULL, "background");
+  tasks[1].id = gtk_idle_scheduler_add (GTK_IDLE_TASK_VISIBLE, count_task, &tasks[1], NULL, "visible");
+
+  run_until_done (tasks, G_N_ELEMENTS (tasks));
+
+  /* Visible tasks go first in every round */
+  g_assert_cmpstr (log->str, ==, "vbvb");
+
+  g_string_free (log, TRUE);
+}
+
+static gboolean
+log_idle (gpointer data)
+{
+  GString *log = data;
+
+  g_string_append_c (log, 'i');
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+test_redraw (void)
+{
+  GString *log = g_string_new (NULL);
+  TaskData tasks[] = {
+    { log, 'b', 1, 0 },
+    { log, 'r', 2, 0 },
+  };
+
+  g_idle_add (log_idle, log);
+
+  tasks[0].id = gtk_idle_scheduler_add (GTK_IDLE_TASK_BACKGROUND, count_task, &tasks[0], NULL, "background");
+  tasks[1].id = gtk_idle_scheduler_add (GTK_IDLE_TASK_REDRAW, count_task, &tasks[1], NULL, "redraw");
+
+  run_until_done (tasks, G_N_ELEMENTS (tasks));
+  while (g_main_context_iteration (NULL, FALSE));
+
+  /* Redraw tasks run ahead of other idles, and take the
+   * other tasks along
+   */
+  g_assert_cmpstr (log->str, ==, "rbri");
+
+  /* Lowering the priority lets other idles go first */
+  g_string_truncate (log, 0);
+  g_idle_add (log_idle, log);
+  tasks[0].n_runs = 1;
+  tasks[0].id = gtk_idle_scheduler_add (GTK_IDLE_TASK_REDRAW, count_task, &tasks[0], NULL, "redraw");
+  gtk_idle_scheduler_set_priority (tasks[0].id, GTK_IDLE_TASK_BACKGROUND);
+
+  run_until_done (tasks, 1);
+
+  g_assert_cmpstr (log->str, ==, "ib");
+
+  g_string_free (log, TRUE);
+}
+
+static void
+test_round_robin (void)
+{
+  GString *log = g_string_new (NULL);
+  TaskData tasks[] = {
+    { log, 'a', 3, 0 },
+    { log, 'b', 1, 0 },
+    { log, 'c', 2, 0 },
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (tasks); i++)
+    tasks[i].id = gtk_idle_scheduler_add (GTK_IDLE_TASK_VISIBLE, count_task, &tasks[i], NULL, NULL);
+
+  run_until_done (tasks, G_N_ELEMENTS (tasks));
+
+  g_assert_cmpstr (log->str, ==, "abcaca");
+
+  g_string_free (log, TRUE);
+}
+
+static gboolean
+remove_self_task (gpointer data,
+                  gint64   deadline)
+{
+  TaskData *task = data;
+
+  task->n_runs++;
+  g_clear_handle_id (&task->id, gtk_idle_scheduler_remove);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static int n_notified;
+
+static void
+count_notify (gpointer data)
+{
+  n_notified++;
+}
+
+static void
+test_remove (void)
+{
+  TaskData task = { NULL, 0, 0, 0 };
+
+  n_notified = 0;
+
+  /* Removing a task that never ran */
+  task.id = gtk_idle_scheduler_add (GTK_IDLE_TASK_VISIBLE, remove_self_task, &task, count_notify, NULL);
+  g_clear_handle_id (&task.id, gtk_idle_scheduler_remove);
+  g_assert_cmpint (n_notified, ==, 1);
+  g_assert_cmpint (task.n_runs, ==, 0);
+
+  /* Removing a task from within itself */
+  task.id = gtk_idle_scheduler_add (GTK_IDLE_TASK_BACKGROUND, remove_self_task, &task, count_notify, NULL);
+
+  while (task.id != 0)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_cmpint (task.n_runs, ==, 1);
+  g_assert_cmpint (n_notified, ==, 2);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/idlescheduler/priority", test_priority);
+  g_test_add_func ("/idlescheduler/redraw", test_redraw);
+  g_test_add_func ("/idlescheduler/round-robin", test_round_robin);
+  g_test_add_func ("/idlescheduler/remove", test_remove);
+
+  return g_test_run ();
+}
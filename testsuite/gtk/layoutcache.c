@@ -0,0 +1,208 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <locale.h>
+
+#include <gtk/gtk.h>
+#include "gtk/gtkpangolayoutcacheprivate.h"
+
+static void
+test_shared (void)
+{
+  GtkWidget *label1, *label2;
+  PangoLayout *template1, *template2;
+  PangoLayout *layout1, *layout2;
+
+  gtk_pango_layout_cache_clear ();
+
+  label1 = g_object_ref_sink (gtk_label_new (NULL));
+  label2 = g_object_ref_sink (gtk_label_new (NULL));
+
+  template1 = gtk_widget_create_pango_layout (label1, "Same text");
+  template2 = gtk_widget_create_pango_layout (label2, "Same text");
+
+  layout1 = gtk_pango_layout_cache_lookup (template1, 100 * PANGO_SCALE);
+  layout2 = gtk_pango_layout_cache_lookup (template2, 100 * PANGO_SCALE);
+
+  g_assert_true (layout1 == layout2);
+  g_assert_true (layout1 != template1);
+  g_assert_cmpint (pango_layout_get_width (layout1), ==, 100 * PANGO_SCALE);
+  g_assert_cmpstr (pango_layout_get_text (layout1), ==, "Same text");
+
+  g_object_unref (layout2);
+  layout2 = gtk_pango_layout_cache_lookup (template2, 50 * PANGO_SCALE);
+  g_assert_true (layout1 != layout2);
+  g_assert_cmpint (pango_layout_get_width (layout2), ==, 50 * PANGO_SCALE);
+
+  g_object_unref (layout1);
+  g_object_unref (layout2);
+  g_object_unref (template1);
+  g_object_unref (template2);
+  g_object_unref (label1);
+  g_object_unref (label2);
+}
+
+static void
+test_different (void)
+{
+  GtkWidget *label;
+  PangoLayout *template;
+  PangoLayout *layout1, *layout2, *layout3;
+  PangoAttrList *attrs;
+
+  gtk_pango_layout_cache_clear ();
+
+  label = g_object_ref_sink (gtk_label_new (NULL));
+  template = gtk_widget_create_pango_layout (label, "Text");
+
+  layout1 = gtk_pango_layout_cache_lookup (template, -1);
+
+  pango_layout_set_text (template, "Other text", -1);
+  layout2 = gtk_pango_layout_cache_lookup (template, -1);
+  g_assert_true (layout1 != layout2);
+
+  pango_layout_set_text (template, "Text", -1);
+  attrs = pango_attr_list_new ();
+  pango_attr_list_insert (attrs, pango_attr_weight_new (PANGO_WEIGHT_BOLD));
+  pango_layout_set_attributes (template, attrs);
+  pango_attr_list_unref (attrs);
+  layout3 = gtk_pango_layout_cache_lookup (template, -1);
+  g_assert_true (layout1 != layout3);
+  g_assert_true (layout2 != layout3);
+
+  g_object_unref (layout1);
+  g_object_unref (layout2);
+  g_object_unref (layout3);
+  g_object_unref (template);
+  g_object_unref (label);
+}
+
+static void
+test_context_change (void)
+{
+  GtkWidget *label1, *label2;
+  PangoLayout *template1, *template2;
+  PangoLayout *layout1, *layout2;
+  PangoFontDescription *desc, *old_desc;
+  guint serial;
+
+  gtk_pango_layout_cache_clear ();
+
+  label1 = g_object_ref_sink (gtk_label_new (NULL));
+  label2 = g_object_ref_sink (gtk_label_new (NULL));
+
+  template1 = gtk_widget_create_pango_layout (label1, "Font change");
+  template2 = gtk_widget_create_pango_layout (label2, "Font change");
+
+  layout1 = gtk_pango_layout_cache_lookup (template1, -1);
+  g_assert_true (pango_layout_get_context (layout1) != pango_layout_get_context (template1));
+  old_desc = pango_font_description_copy (pango_context_get_font_description (pango_layout_get_context (layout1)));
+  serial = pango_layout_get_serial (layout1);
+
+  /* A font change of the context the cached layout was requested
+   * with does not reach the shared layout, which other widgets with
+   * the old settings still use
+   */
+  desc = pango_font_description_from_string ("Sans 30");
+  pango_context_set_font_description (pango_layout_get_context (template1), desc);
+  pango_font_description_free (desc);
+
+  g_assert_cmpuint (pango_layout_get_serial (layout1), ==, serial);
+  g_assert_true (pango_font_description_equal (pango_context_get_font_description (pango_layout_get_context (layout1)),
+                                               old_desc));
+
+  layout2 = gtk_pango_layout_cache_lookup (template2, -1);
+  g_assert_true (layout1 == layout2);
+  g_object_unref (layout2);
+
+  /* and the changed context finds a layout with its own settings */
+  layout2 = gtk_pango_layout_cache_lookup (template1, -1);
+  g_assert_true (layout1 != layout2);
+  g_assert_true (pango_font_description_equal (pango_context_get_font_description (pango_layout_get_context (layout2)),
+                                               pango_context_get_font_description (pango_layout_get_context (template1))));
+
+  pango_font_description_free (old_desc);
+  g_object_unref (layout1);
+  g_object_unref (layout2);
+  g_object_unref (template1);
+  g_object_unref (template2);
+  g_object_unref (label1);
+  g_object_unref (label2);
+}
+
+static void
+test_stats (void)
+{
+  GtkWidget *label;
+  PangoLayout *template;
+  PangoLayout *layout;
+  GtkPangoLayoutCacheStats before, after;
+  guint i;
+
+  gtk_pango_layout_cache_clear ();
+
+  label = g_object_ref_sink (gtk_label_new (NULL));
+  template = gtk_widget_create_pango_layout (label, "Counted");
+
+  gtk_pango_layout_cache_get_stats (&before);
+
+  for (i = 0; i < 10; i++)
+    {
+      layout = gtk_pango_layout_cache_lookup (template, -1);
+      g_object_unref (layout);
+    }
+
+  gtk_pango_layout_cache_get_stats (&after);
+
+  g_assert_cmpuint (after.n_entries, ==, 1);
+  g_assert_cmpuint (after.n_misses - before.n_misses, ==, 1);
+  g_assert_cmpuint (after.n_hits - before.n_hits, ==, 9);
+
+  for (i = 0; i < after.max_entries + 10; i++)
+    {
+      char *text = g_strdup_printf ("%u", i);
+
+      pango_layout_set_text (template, text, -1);
+      layout = gtk_pango_layout_cache_lookup (template, -1);
+      g_object_unref (layout);
+      g_free (text);
+    }
+
+  gtk_pango_layout_cache_get_stats (&after);
+  g_assert_cmpuint (after.n_entries, ==, after.max_entries);
+  g_assert_cmpuint (after.n_evictions - before.n_evictions, >=, 10);
+
+  gtk_pango_layout_cache_clear ();
+  gtk_pango_layout_cache_get_stats (&after);
+  g_assert_cmpuint (after.n_entries, ==, 0);
+
+  g_object_unref (template);
+  g_object_unref (label);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/layoutcache/shared", test_shared);
+  g_test_add_func ("/layoutcache/different", test_different);
+  g_test_add_func ("/layoutcache/context-change", test_context_change);
+  g_test_add_func ("/layoutcache/stats", test_stats);
+
+  return g_test_run ();
+}
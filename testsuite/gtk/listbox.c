@@ -437,6 +437,184 @@ test_header (void)
   g_object_unref (list);
 }
 
+static GtkWidget *
+create_label (gpointer item,
+              gpointer data)
+{
+  return gtk_label_new (gtk_string_object_get_string (item));
+}
+
+static guint
+count_rows (GtkListBox *list)
+{
+  GtkWidget *row;
+  guint n_rows = 0;
+
+  for (row = gtk_widget_get_first_child (GTK_WIDGET (list));
+       row != NULL;
+       row = gtk_widget_get_next_sibling (row))
+    {
+      if (GTK_IS_LIST_BOX_ROW (row))
+        n_rows++;
+    }
+
+  return n_rows;
+}
+
+static void
+test_virtualized (void)
+{
+  GtkListBox *list;
+  GtkStringList *model;
+  GtkListBoxRow *row;
+  GtkWidget *label;
+  guint n_rows;
+  int i;
+
+  model = gtk_string_list_new (NULL);
+  for (i = 0; i < 10000; i++)
+    {
+      char *s = g_strdup_printf ("%d", i);
+      gtk_string_list_append (model, s);
+      g_free (s);
+    }
+
+  list = GTK_LIST_BOX (gtk_list_box_new ());
+  g_object_ref_sink (list);
+
+  gtk_list_box_set_virtualized (list, TRUE);
+  gtk_list_box_bind_model (list, G_LIST_MODEL (model), create_label, NULL, NULL);
+
+  n_rows = count_rows (list);
+  g_assert_cmpuint (n_rows, >, 0);
+  g_assert_cmpuint (n_rows, <, 1000);
+
+  row = gtk_list_box_get_row_at_index (list, 0);
+  g_assert_nonnull (row);
+  g_assert_cmpint (gtk_list_box_row_get_index (row), ==, 0);
+  g_assert_null (gtk_list_box_get_row_at_index (list, 9999));
+
+  /* Rows follow changes to the model */
+  gtk_string_list_splice (model, 0, 1, NULL);
+  g_assert_cmpuint (count_rows (list), ==, n_rows);
+  row = gtk_list_box_get_row_at_index (list, 0);
+  label = gtk_list_box_row_get_child (row);
+  g_assert_cmpstr (gtk_label_get_label (GTK_LABEL (label)), ==, "1");
+
+  /* The selection is kept for items without rows */
+  gtk_list_box_set_selection_mode (list, GTK_SELECTION_MULTIPLE);
+  gtk_list_box_select_all (list);
+  g_assert_true (gtk_list_box_row_is_selected (gtk_list_box_get_row_at_index (list, 0)));
+  gtk_string_list_splice (model, 0, 1, NULL);
+  g_assert_true (gtk_list_box_row_is_selected (gtk_list_box_get_row_at_index (list, 0)));
+  gtk_list_box_unselect_all (list);
+  g_assert_null (gtk_list_box_get_selected_rows (list));
+
+  gtk_list_box_set_virtualized (list, FALSE);
+  g_assert_cmpuint (count_rows (list), ==, 9998);
+
+  g_object_unref (list);
+  g_object_unref (model);
+}
+
+static gboolean
+timed_out_cb (gpointer data)
+{
+  gboolean *timed_out = data;
+
+  *timed_out = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+wait_until (gboolean (* condition) (GtkListBox *list),
+            GtkListBox *list)
+{
+  gboolean timed_out = FALSE;
+  guint id;
+
+  id = g_timeout_add_seconds (5, timed_out_cb, &timed_out);
+
+  while (!condition (list) && !timed_out)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_false (timed_out);
+  g_source_remove (id);
+}
+
+static gboolean
+is_allocated (GtkListBox *list)
+{
+  return gtk_widget_get_height (GTK_WIDGET (list)) > 0;
+}
+
+static gboolean
+first_rows_released (GtkListBox *list)
+{
+  return gtk_list_box_get_row_at_index (list, 1) == NULL;
+}
+
+static gboolean
+last_row_focused (GtkListBox *list)
+{
+  GtkWidget *focus;
+
+  focus = gtk_root_get_focus (gtk_widget_get_root (GTK_WIDGET (list)));
+  if (focus == NULL || !GTK_IS_LIST_BOX_ROW (focus))
+    return FALSE;
+
+  return gtk_list_box_row_get_index (GTK_LIST_BOX_ROW (focus)) == 9999;
+}
+
+static void
+test_virtualized_scroll (void)
+{
+  GtkWidget *window, *sw;
+  GtkListBox *list;
+  GtkStringList *model;
+  GtkListBoxRow *row;
+  GtkAdjustment *vadjustment;
+  int i;
+
+  model = gtk_string_list_new (NULL);
+  for (i = 0; i < 10000; i++)
+    {
+      char *s = g_strdup_printf ("%d", i);
+      gtk_string_list_append (model, s);
+      g_free (s);
+    }
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 200, 400);
+  sw = gtk_scrolled_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), sw);
+  list = GTK_LIST_BOX (gtk_list_box_new ());
+  gtk_list_box_set_virtualized (list, TRUE);
+  gtk_list_box_bind_model (list, G_LIST_MODEL (model), create_label, NULL, NULL);
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), GTK_WIDGET (list));
+  gtk_window_present (GTK_WINDOW (window));
+
+  wait_until (is_allocated, list);
+  row = gtk_list_box_get_row_at_index (list, 0);
+  gtk_list_box_select_row (list, row);
+
+  /* The selected row is kept when scrolled out of view */
+  vadjustment = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (sw));
+  gtk_adjustment_set_value (vadjustment, gtk_adjustment_get_upper (vadjustment) / 2);
+  wait_until (first_rows_released, list);
+  g_assert_true (gtk_list_box_get_selected_row (list) == row);
+  g_assert_true (gtk_list_box_get_row_at_index (list, 0) == row);
+
+  /* The cursor can move past the rows in view */
+  g_signal_emit_by_name (list, "move-cursor", GTK_MOVEMENT_BUFFER_ENDS, 1, FALSE, FALSE);
+  wait_until (last_row_focused, list);
+  g_assert_cmpint (gtk_list_box_row_get_index (gtk_list_box_get_selected_row (list)), ==, 9999);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+  g_object_unref (model);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -447,6 +625,8 @@ main (int argc, char *argv[])
   g_test_add_func ("/listbox/multi-selection", test_multi_selection);
   g_test_add_func ("/listbox/filter", test_filter);
   g_test_add_func ("/listbox/header", test_header);
+  g_test_add_func ("/listbox/virtualized", test_virtualized);
+  g_test_add_func ("/listbox/virtualized-scroll", test_virtualized_scroll);
 
   return g_test_run ();
 }
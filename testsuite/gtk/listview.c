@@ -0,0 +1,197 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+static void
+setup_item (GtkSignalListItemFactory *factory,
+            GtkListItem              *item)
+{
+  gtk_list_item_set_child (item, gtk_label_new (NULL));
+}
+
+static void
+bind_item (GtkSignalListItemFactory *factory,
+           GtkListItem              *item)
+{
+  GtkStringObject *string = gtk_list_item_get_item (item);
+
+  gtk_label_set_label (GTK_LABEL (gtk_list_item_get_child (item)),
+                       gtk_string_object_get_string (string));
+}
+
+static GtkSelectionModel *
+create_model (void)
+{
+  GtkStringList *list;
+  char buffer[32];
+  guint i;
+
+  list = gtk_string_list_new (NULL);
+  for (i = 0; i < 1000; i++)
+    {
+      g_snprintf (buffer, sizeof (buffer), "Item %u", i);
+      gtk_string_list_append (list, buffer);
+    }
+
+  return GTK_SELECTION_MODEL (gtk_no_selection_new (G_LIST_MODEL (list)));
+}
+
+static GtkListItemFactory *
+create_factory (void)
+{
+  GtkListItemFactory *factory;
+
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_item), NULL);
+  g_signal_connect (factory, "bind", G_CALLBACK (bind_item), NULL);
+
+  return factory;
+}
+
+/* Shows @list, then changes the rows and shows it again.
+ * Allocating a row that was not measured warns, and warnings
+ * are fatal in tests.
+ */
+static void
+show_and_change (GtkWidget *list,
+                 GtkWidget *scrollable)
+{
+  GtkWidget *window, *sw;
+  GtkAdjustment *vadjustment;
+  GtkWidget *child;
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 200, 200);
+  sw = gtk_scrolled_window_new ();
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), list);
+  gtk_window_set_child (GTK_WINDOW (window), sw);
+
+  gtk_window_present (GTK_WINDOW (window));
+  gtk_test_widget_wait_for_draw (window);
+
+  /* Invalidate the size of every shown row but the first */
+  for (child = gtk_widget_get_first_child (scrollable);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    {
+      if (child != gtk_widget_get_first_child (scrollable))
+        gtk_widget_queue_resize (child);
+    }
+  gtk_test_widget_wait_for_draw (window);
+
+  /* Scroll to rows that were not shown before */
+  vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (scrollable));
+  gtk_adjustment_set_value (vadjustment, gtk_adjustment_get_upper (vadjustment) / 2);
+  gtk_test_widget_wait_for_draw (window);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_fixed_height_list (void)
+{
+  GtkListItemFactory *factory;
+  GtkWidget *list;
+
+  factory = create_factory ();
+  list = gtk_list_view_new (create_model (), factory);
+  gtk_list_view_set_fixed_height_mode (GTK_LIST_VIEW (list), TRUE);
+
+  show_and_change (list, list);
+}
+
+static void
+test_fixed_height_column (void)
+{
+  GtkListItemFactory *factory;
+  GtkColumnViewColumn *column;
+  GtkWidget *view, *list;
+
+  view = gtk_column_view_new (create_model ());
+  gtk_column_view_set_fixed_height_mode (GTK_COLUMN_VIEW (view), TRUE);
+
+  factory = create_factory ();
+  column = gtk_column_view_column_new ("Items", factory);
+  gtk_column_view_append_column (GTK_COLUMN_VIEW (view), column);
+  g_object_unref (column);
+
+  /* The rows live in the list view inside the column view */
+  for (list = gtk_widget_get_first_child (view);
+       list != NULL && !GTK_IS_LIST_VIEW (list);
+       list = gtk_widget_get_next_sibling (list))
+    ;
+  g_assert_nonnull (list);
+
+  show_and_change (view, list);
+}
+
+/* The rows keep the height of the reference row, even when a row
+ * with different contents scrolls into view
+ */
+static void
+test_fixed_height_stable (void)
+{
+  GtkListItemFactory *factory;
+  GtkSelectionModel *model;
+  GtkStringList *list;
+  GtkWidget *window, *sw, *view;
+  GtkAdjustment *vadjustment;
+  double upper;
+
+  model = create_model ();
+  list = GTK_STRING_LIST (gtk_no_selection_get_model (GTK_NO_SELECTION (model)));
+  gtk_string_list_splice (list, 600, 1, (const char *[]) { "A\nmuch\ntaller\nrow", NULL });
+
+  factory = create_factory ();
+  view = gtk_list_view_new (model, factory);
+  gtk_list_view_set_fixed_height_mode (GTK_LIST_VIEW (view), TRUE);
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 200, 200);
+  sw = gtk_scrolled_window_new ();
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), view);
+  gtk_window_set_child (GTK_WINDOW (window), sw);
+
+  gtk_window_present (GTK_WINDOW (window));
+  gtk_test_widget_wait_for_draw (window);
+
+  vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (view));
+  upper = gtk_adjustment_get_upper (vadjustment);
+
+  gtk_list_view_scroll_to (GTK_LIST_VIEW (view), 600, GTK_LIST_SCROLL_NONE, NULL);
+  gtk_test_widget_wait_for_draw (window);
+  g_assert_cmpfloat (gtk_adjustment_get_upper (vadjustment), ==, upper);
+
+  gtk_list_view_scroll_to (GTK_LIST_VIEW (view), 999, GTK_LIST_SCROLL_NONE, NULL);
+  gtk_test_widget_wait_for_draw (window);
+  g_assert_cmpfloat (gtk_adjustment_get_upper (vadjustment), ==, upper);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/listview/fixed-height", test_fixed_height_list);
+  g_test_add_func ("/listview/fixed-height/stable", test_fixed_height_stable);
+  g_test_add_func ("/columnview/fixed-height", test_fixed_height_column);
+
+  return g_test_run ();
+}
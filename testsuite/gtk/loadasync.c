@@ -0,0 +1,251 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+#include "gtk/gtkdecodeloadprivate.h"
+
+static char *
+create_image_file (int width,
+                   int height)
+{
+  GdkTexture *texture;
+  GBytes *bytes;
+  guchar *data;
+  char *path;
+  int fd;
+
+  data = g_malloc0 (width * height * 4);
+  bytes = g_bytes_new_take (data, width * height * 4);
+  texture = gdk_memory_texture_new (width, height, GDK_MEMORY_DEFAULT, bytes, width * 4);
+
+  fd = g_file_open_tmp ("gtk-loadasync-XXXXXX.png", &path, NULL);
+  g_assert_cmpint (fd, >=, 0);
+  g_close (fd, NULL);
+
+  g_assert_true (gdk_texture_save_to_png (texture, path));
+
+  g_object_unref (texture);
+  g_bytes_unref (bytes);
+
+  return path;
+}
+
+static void
+test_picture (void)
+{
+  GtkWidget *window, *picture;
+  GdkPaintable *paintable;
+  char *path;
+  GFile *file;
+  gboolean load_async;
+
+  path = create_image_file (10, 20);
+  file = g_file_new_for_path (path);
+
+  window = gtk_window_new ();
+  picture = gtk_picture_new ();
+  gtk_window_set_child (GTK_WINDOW (window), picture);
+
+  g_assert_false (gtk_picture_get_load_async (GTK_PICTURE (picture)));
+  g_object_set (picture, "load-async", TRUE, NULL);
+  g_object_get (picture, "load-async", &load_async, NULL);
+  g_assert_true (load_async);
+
+  gtk_picture_set_file (GTK_PICTURE (picture), file);
+  g_assert_null (gtk_picture_get_paintable (GTK_PICTURE (picture)));
+
+  while (gtk_picture_get_paintable (GTK_PICTURE (picture)) == NULL)
+    g_main_context_iteration (NULL, TRUE);
+
+  paintable = gtk_picture_get_paintable (GTK_PICTURE (picture));
+  g_assert_cmpint (gdk_paintable_get_intrinsic_width (paintable), ==, 10);
+  g_assert_cmpint (gdk_paintable_get_intrinsic_height (paintable), ==, 20);
+  g_assert_true (gtk_picture_get_file (GTK_PICTURE (picture)) == file);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+
+  g_unlink (path);
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+test_picture_replaced (void)
+{
+  GtkWidget *window, *box, *picture, *other;
+  GdkPaintable *paintable;
+  char *path;
+  GFile *file;
+
+  path = create_image_file (10, 20);
+  file = g_file_new_for_path (path);
+  paintable = gdk_paintable_new_empty (5, 5);
+
+  window = gtk_window_new ();
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_window_set_child (GTK_WINDOW (window), box);
+  picture = gtk_picture_new ();
+  gtk_picture_set_load_async (GTK_PICTURE (picture), TRUE);
+  gtk_box_append (GTK_BOX (box), picture);
+  other = gtk_picture_new ();
+  gtk_picture_set_load_async (GTK_PICTURE (other), TRUE);
+  gtk_box_append (GTK_BOX (box), other);
+
+  /* Like a list item that is bound to a different item */
+  gtk_picture_set_file (GTK_PICTURE (picture), file);
+  gtk_picture_set_paintable (GTK_PICTURE (picture), paintable);
+
+  gtk_picture_set_file (GTK_PICTURE (other), file);
+  while (gtk_picture_get_paintable (GTK_PICTURE (other)) == NULL)
+    g_main_context_iteration (NULL, TRUE);
+  while (g_main_context_iteration (NULL, FALSE));
+
+  g_assert_true (gtk_picture_get_paintable (GTK_PICTURE (picture)) == paintable);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+
+  g_unlink (path);
+  g_object_unref (paintable);
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+test_picture_unrooted (void)
+{
+  GtkWidget *window, *picture;
+  char *path;
+  GFile *file;
+
+  path = create_image_file (10, 20);
+  file = g_file_new_for_path (path);
+
+  picture = g_object_ref_sink (gtk_picture_new ());
+  gtk_picture_set_load_async (GTK_PICTURE (picture), TRUE);
+  gtk_picture_set_file (GTK_PICTURE (picture), file);
+
+  /* The load starts once the picture is in a window */
+  while (g_main_context_iteration (NULL, FALSE));
+  g_assert_null (gtk_picture_get_paintable (GTK_PICTURE (picture)));
+
+  window = gtk_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), picture);
+
+  while (gtk_picture_get_paintable (GTK_PICTURE (picture)) == NULL)
+    g_main_context_iteration (NULL, TRUE);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+  g_object_unref (picture);
+
+  g_unlink (path);
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+test_image (void)
+{
+  GtkWidget *window, *image;
+  GdkPaintable *paintable;
+  char *path;
+  char *filename;
+
+  path = create_image_file (10, 20);
+
+  window = gtk_window_new ();
+  image = gtk_image_new ();
+  gtk_window_set_child (GTK_WINDOW (window), image);
+
+  g_assert_false (gtk_image_get_load_async (GTK_IMAGE (image)));
+  gtk_image_set_load_async (GTK_IMAGE (image), TRUE);
+
+  gtk_image_set_from_file (GTK_IMAGE (image), path);
+  g_assert_cmpint (gtk_image_get_storage_type (GTK_IMAGE (image)), ==, GTK_IMAGE_EMPTY);
+
+  while (gtk_image_get_storage_type (GTK_IMAGE (image)) == GTK_IMAGE_EMPTY)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_cmpint (gtk_image_get_storage_type (GTK_IMAGE (image)), ==, GTK_IMAGE_PAINTABLE);
+  paintable = gtk_image_get_paintable (GTK_IMAGE (image));
+  g_assert_cmpint (gdk_paintable_get_intrinsic_width (paintable), ==, 10);
+
+  g_object_get (image, "file", &filename, NULL);
+  g_assert_cmpstr (filename, ==, path);
+  g_free (filename);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+
+  g_unlink (path);
+  g_free (path);
+}
+
+static void
+test_priority (void)
+{
+  GtkWidget *window, *sw, *box, *pictures[3];
+  guint i;
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 100, 100);
+  sw = gtk_scrolled_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), sw);
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), box);
+
+  /* On screen, just below it, and far away */
+  for (i = 0; i < G_N_ELEMENTS (pictures); i++)
+    {
+      GdkPaintable *paintable = gdk_paintable_new_empty (50, i == 2 ? 1000 : 100);
+
+      pictures[i] = gtk_picture_new_for_paintable (paintable);
+      gtk_picture_set_can_shrink (GTK_PICTURE (pictures[i]), FALSE);
+      gtk_box_append (GTK_BOX (box), pictures[i]);
+      g_object_unref (paintable);
+    }
+  gtk_box_append (GTK_BOX (box), gtk_label_new ("End"));
+
+  gtk_window_present (GTK_WINDOW (window));
+  gtk_test_widget_wait_for_draw (window);
+
+  g_assert_cmpint (gtk_widget_get_decode_priority (pictures[0]), ==, GDK_DECODE_PRIORITY_VISIBLE);
+  g_assert_cmpint (gtk_widget_get_decode_priority (pictures[1]), ==, GDK_DECODE_PRIORITY_NEARBY);
+  g_assert_cmpint (gtk_widget_get_decode_priority (gtk_widget_get_last_child (box)), ==, GDK_DECODE_PRIORITY_BACKGROUND);
+
+  gtk_widget_set_visible (pictures[0], FALSE);
+  gtk_test_widget_wait_for_draw (window);
+
+  g_assert_cmpint (gtk_widget_get_decode_priority (pictures[0]), ==, GDK_DECODE_PRIORITY_BACKGROUND);
+  g_assert_cmpint (gtk_widget_get_decode_priority (pictures[1]), ==, GDK_DECODE_PRIORITY_VISIBLE);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/loadasync/picture", test_picture);
+  g_test_add_func ("/loadasync/picture-replaced", test_picture_replaced);
+  g_test_add_func ("/loadasync/picture-unrooted", test_picture_unrooted);
+  g_test_add_func ("/loadasync/image", test_image);
+  g_test_add_func ("/loadasync/priority", test_priority);
+
+  return g_test_run ();
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <locale.h>
+
+#include <gtk/gtk.h>
+#include "gtk/gtkcssnodeprivate.h"
+#include "gtk/gtkmeasurecacheprivate.h"
+#include "gtk/gtkwidgetprivate.h"
+
+/* Labels in the middle of a box share their style, the
+ * first and last one match different selectors
+ */
+static GtkWidget *
+create_box (const char * const *texts)
+{
+  GtkWidget *box;
+  guint i;
+
+  box = g_object_ref_sink (gtk_box_new (GTK_ORIENTATION_VERTICAL, 0));
+
+  for (i = 0; texts[i]; i++)
+    {
+      GtkWidget *label = gtk_label_new (texts[i]);
+
+      gtk_label_set_wrap (GTK_LABEL (label), TRUE);
+      gtk_box_append (GTK_BOX (box), label);
+    }
+
+  return box;
+}
+
+static GtkWidget *
+get_nth_child (GtkWidget *box,
+               guint      n)
+{
+  GtkWidget *child = gtk_widget_get_first_child (box);
+
+  while (n-- > 0)
+    child = gtk_widget_get_next_sibling (child);
+
+  return child;
+}
+
+static void
+test_shared (void)
+{
+  const char *texts[] = { "first", "Some text that wraps", "Some text that wraps", "last", NULL };
+  GtkMeasureCacheStats before, after;
+  GtkWidget *box, *label1, *label2;
+  int min1, nat1, min2, nat2;
+
+  gtk_measure_cache_clear ();
+
+  box = create_box (texts);
+  label1 = get_nth_child (box, 1);
+  label2 = get_nth_child (box, 2);
+
+  gtk_measure_cache_get_stats (&before);
+
+  gtk_widget_measure (label1, GTK_ORIENTATION_HORIZONTAL, -1, &min1, &nat1, NULL, NULL);
+  gtk_widget_measure (label2, GTK_ORIENTATION_HORIZONTAL, -1, &min2, &nat2, NULL, NULL);
+  g_assert_cmpint (min1, ==, min2);
+  g_assert_cmpint (nat1, ==, nat2);
+
+  gtk_widget_measure (label1, GTK_ORIENTATION_VERTICAL, 50, &min1, &nat1, NULL, NULL);
+  gtk_widget_measure (label2, GTK_ORIENTATION_VERTICAL, 50, &min2, &nat2, NULL, NULL);
+  g_assert_cmpint (min1, ==, min2);
+  g_assert_cmpint (nat1, ==, nat2);
+
+  gtk_measure_cache_get_stats (&after);
+  g_assert_cmpuint (after.n_hits, >, before.n_hits);
+
+  /* Survives resizes, unlike the size request cache of the widget */
+  before = after;
+  gtk_widget_queue_resize (label2);
+  gtk_widget_measure (label2, GTK_ORIENTATION_HORIZONTAL, -1, &min2, &nat2, NULL, NULL);
+  gtk_measure_cache_get_stats (&after);
+  g_assert_cmpuint (after.n_hits, >, before.n_hits);
+
+  g_object_unref (box);
+}
+
+static void
+test_different (void)
+{
+  const char *texts[] = { "first", "Short", "A much longer text than the other one", "last", NULL };
+  GtkWidget *box, *label1, *label2;
+  int nat1, nat2;
+
+  gtk_measure_cache_clear ();
+
+  box = create_box (texts);
+  label1 = get_nth_child (box, 1);
+  label2 = get_nth_child (box, 2);
+
+  gtk_widget_measure (label1, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &nat1, NULL, NULL);
+  gtk_widget_measure (label2, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &nat2, NULL, NULL);
+  g_assert_cmpint (nat1, <, nat2);
+
+  /* Changing the text must not find the old measurement */
+  gtk_label_set_label (GTK_LABEL (label1), texts[2]);
+  gtk_widget_measure (label1, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &nat1, NULL, NULL);
+  g_assert_cmpint (nat1, ==, nat2);
+
+  gtk_label_set_width_chars (GTK_LABEL (label1), 100);
+  gtk_widget_measure (label1, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &nat1, NULL, NULL);
+  g_assert_cmpint (nat1, >, nat2);
+
+  g_object_unref (box);
+}
+
+static void
+test_attributes (void)
+{
+  const char *texts[] = { "first", "Some text", "Some text", "last", NULL };
+  GtkWidget *box, *label1, *label2;
+  PangoAttrList *attrs;
+  int nat1, nat2;
+
+  gtk_measure_cache_clear ();
+
+  box = create_box (texts);
+  label1 = get_nth_child (box, 1);
+  label2 = get_nth_child (box, 2);
+
+  attrs = pango_attr_list_new ();
+  pango_attr_list_insert (attrs, pango_attr_letter_spacing_new (10 * PANGO_SCALE));
+  gtk_label_set_attributes (GTK_LABEL (label2), attrs);
+
+  gtk_widget_measure (label1, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &nat1, NULL, NULL);
+  gtk_widget_measure (label2, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &nat2, NULL, NULL);
+  g_assert_cmpint (nat1, <, nat2);
+
+  /* Equal lists share measurements */
+  gtk_label_set_attributes (GTK_LABEL (label1), attrs);
+  gtk_widget_measure (label1, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &nat1, NULL, NULL);
+  g_assert_cmpint (nat1, ==, nat2);
+
+  pango_attr_list_unref (attrs);
+  g_object_unref (box);
+}
+
+/* Keys are compared in full, not only by their hash */
+static void
+test_collision (void)
+{
+  GtkWidget *label;
+  GtkCssStyle *style;
+  GtkMeasureKey key1, key2;
+  int min, nat, min_baseline, nat_baseline;
+
+  gtk_measure_cache_clear ();
+
+  label = g_object_ref_sink (gtk_label_new (NULL));
+  style = gtk_css_node_get_style (gtk_widget_get_css_node (label));
+
+  gtk_measure_key_init (&key1);
+  gtk_measure_key_add_string (&key1, "a");
+  gtk_measure_key_init (&key2);
+  gtk_measure_key_add_string (&key2, "b");
+  key2.hash = key1.hash;
+
+  gtk_measure_cache_insert (GTK_TYPE_LABEL, &key1, style,
+                            GTK_ORIENTATION_HORIZONTAL, -1,
+                            1, 2, -1, -1);
+  g_assert_false (gtk_measure_cache_lookup (GTK_TYPE_LABEL, &key2, style,
+                                            GTK_ORIENTATION_HORIZONTAL, -1,
+                                            &min, &nat, &min_baseline, &nat_baseline));
+
+  gtk_measure_key_clear (&key1);
+  gtk_measure_key_init (&key1);
+  gtk_measure_key_add_string (&key1, "a");
+  g_assert_true (gtk_measure_cache_lookup (GTK_TYPE_LABEL, &key1, style,
+                                           GTK_ORIENTATION_HORIZONTAL, -1,
+                                           &min, &nat, &min_baseline, &nat_baseline));
+  g_assert_cmpint (min, ==, 1);
+  g_assert_cmpint (nat, ==, 2);
+
+  gtk_measure_key_clear (&key1);
+  gtk_measure_key_clear (&key2);
+  g_object_unref (label);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/measurecache/shared", test_shared);
+  g_test_add_func ("/measurecache/different", test_different);
+  g_test_add_func ("/measurecache/attributes", test_attributes);
+  g_test_add_func ("/measurecache/collision", test_collision);
+
+  return g_test_run ();
+}
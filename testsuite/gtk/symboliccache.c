@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+#include "gtk/gdktextureutilsprivate.h"
+
+static char *
+get_icon_path (const char *name)
+{
+  return g_test_build_filename (G_TEST_DIST, "icons", "scalable", name, NULL);
+}
+
+static void
+test_sizes (void)
+{
+  GtkSymbolicCacheStats before, after;
+  GdkTexture *texture1, *texture2, *texture3;
+  gboolean only_fg1, only_fg2;
+  GError *error = NULL;
+  char *path;
+
+  gtk_symbolic_cache_clear ();
+
+  path = get_icon_path ("nonsquare-symbolic.svg");
+
+  gtk_symbolic_cache_get_stats (&before);
+
+  texture1 = gdk_texture_new_from_filename_symbolic (path, 16, 16, 1, &only_fg1, &error);
+  g_assert_no_error (error);
+
+  /* Another size uses the same source */
+  texture2 = gdk_texture_new_from_filename_symbolic (path, 32, 32, 1, &only_fg2, &error);
+  g_assert_no_error (error);
+  g_assert_true (texture1 != texture2);
+  g_assert_true (only_fg1 == only_fg2);
+
+  gtk_symbolic_cache_get_stats (&after);
+  g_assert_cmpuint (after.n_entries, ==, 1);
+  g_assert_cmpuint (after.n_hits, >, before.n_hits);
+
+  /* The same size shares the texture */
+  texture3 = gdk_texture_new_from_filename_symbolic (path, 16, 16, 1, &only_fg2, &error);
+  g_assert_no_error (error);
+  g_assert_true (texture1 == texture3);
+  g_assert_true (only_fg1 == only_fg2);
+
+  gtk_symbolic_cache_clear ();
+  gtk_symbolic_cache_get_stats (&after);
+  g_assert_cmpuint (after.n_entries, ==, 0);
+
+  g_object_unref (texture1);
+  g_object_unref (texture2);
+  g_object_unref (texture3);
+  g_free (path);
+}
+
+static void
+test_missing (void)
+{
+  GtkSymbolicCacheStats stats;
+  GdkTexture *texture;
+  gboolean only_fg;
+  GError *error = NULL;
+  char *path;
+
+  gtk_symbolic_cache_clear ();
+
+  path = get_icon_path ("does-not-exist-symbolic.svg");
+
+  texture = gdk_texture_new_from_filename_symbolic (path, 16, 16, 1, &only_fg, &error);
+  g_assert_null (texture);
+  g_assert_error (error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+  g_clear_error (&error);
+
+  gtk_symbolic_cache_get_stats (&stats);
+  g_assert_cmpuint (stats.n_entries, ==, 0);
+
+  g_free (path);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/symboliccache/sizes", test_sizes);
+  g_test_add_func ("/symboliccache/missing", test_missing);
+
+  return g_test_run ();
+}
@@ -0,0 +1,308 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+#include "gtk/gtksymbolicpathsprivate.h"
+
+static const GdkRGBA colors[4] = {
+  { 0, 0, 0, 1 },
+  { 1, 0, 0, 1 },
+  { 1, 1, 0, 1 },
+  { 0, 1, 0, 1 },
+};
+
+static GtkSymbolicPaths *
+parse (const char *svg,
+       gboolean    has_symbolic_classes)
+{
+  GBytes *bytes;
+  GtkSymbolicPaths *paths;
+
+  bytes = g_bytes_new_static (svg, strlen (svg));
+  paths = gtk_symbolic_paths_new (bytes, has_symbolic_classes);
+  g_bytes_unref (bytes);
+
+  return paths;
+}
+
+static void
+collect_fills (GskRenderNode *node,
+               GPtrArray     *fills)
+{
+  switch (gsk_render_node_get_node_type (node))
+    {
+    case GSK_CONTAINER_NODE:
+      for (guint i = 0; i < gsk_container_node_get_n_children (node); i++)
+        collect_fills (gsk_container_node_get_child (node, i), fills);
+      break;
+
+    case GSK_TRANSFORM_NODE:
+      collect_fills (gsk_transform_node_get_child (node), fills);
+      break;
+
+    case GSK_CLIP_NODE:
+      collect_fills (gsk_clip_node_get_child (node), fills);
+      break;
+
+    case GSK_OPACITY_NODE:
+      collect_fills (gsk_opacity_node_get_child (node), fills);
+      break;
+
+    case GSK_FILL_NODE:
+      g_ptr_array_add (fills, node);
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+}
+
+/* Returns the fill nodes of the icon, in order */
+static GPtrArray *
+snapshot_fills (GtkSymbolicPaths  *paths,
+                double             size,
+                GskRenderNode    **out_node)
+{
+  GtkSnapshot *snapshot;
+  GPtrArray *fills;
+
+  snapshot = gtk_snapshot_new ();
+  gtk_symbolic_paths_snapshot (paths, snapshot, size, size, colors, G_N_ELEMENTS (colors));
+  *out_node = gtk_snapshot_free_to_node (snapshot);
+
+  fills = g_ptr_array_new ();
+  collect_fills (*out_node, fills);
+
+  return fills;
+}
+
+static GskRenderNode *
+find_opacity (GskRenderNode *node)
+{
+  GskRenderNode *found = NULL;
+
+  switch (gsk_render_node_get_node_type (node))
+    {
+    case GSK_CONTAINER_NODE:
+      for (guint i = 0; i < gsk_container_node_get_n_children (node) && !found; i++)
+        found = find_opacity (gsk_container_node_get_child (node, i));
+      return found;
+
+    case GSK_TRANSFORM_NODE:
+      return find_opacity (gsk_transform_node_get_child (node));
+
+    case GSK_CLIP_NODE:
+      return find_opacity (gsk_clip_node_get_child (node));
+
+    case GSK_OPACITY_NODE:
+      return node;
+
+    default:
+      return NULL;
+    }
+}
+
+static void
+assert_color (GskRenderNode *fill,
+              const GdkRGBA *expected,
+              float          alpha)
+{
+  GskRenderNode *child = gsk_fill_node_get_child (fill);
+  const GdkRGBA *color;
+
+  g_assert_cmpint (gsk_render_node_get_node_type (child), ==, GSK_COLOR_NODE);
+  color = gsk_color_node_get_color (child);
+
+  g_assert_cmpfloat_with_epsilon (color->red, expected->red, 0.001);
+  g_assert_cmpfloat_with_epsilon (color->green, expected->green, 0.001);
+  g_assert_cmpfloat_with_epsilon (color->blue, expected->blue, 0.001);
+  g_assert_cmpfloat_with_epsilon (color->alpha, alpha, 0.001);
+}
+
+static void
+test_shapes (void)
+{
+  GtkSymbolicPaths *paths;
+  GskRenderNode *node;
+  GPtrArray *fills;
+  graphene_rect_t bounds;
+
+  paths = parse ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                 "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"16\" height=\"16\">"
+                 "  <title>test</title>"
+                 "  <defs><linearGradient id=\"a\"/></defs>"
+                 "  <path d=\"M 0 0 h 8 v 8 h -8 z\"/>"
+                 "  <g transform=\"translate(8 8)\">"
+                 "    <rect class=\"error\" width=\"8\" height=\"8\" rx=\"2\"/>"
+                 "    <circle class=\"warning\" cx=\"4\" cy=\"4\" r=\"2\"/>"
+                 "  </g>"
+                 "  <ellipse class=\"success\" cx=\"4\" cy=\"12\" rx=\"4\" ry=\"2\"/>"
+                 "  <polygon points=\"8,0 16,0 16,8\" fill-rule=\"evenodd\"/>"
+                 "</svg>", TRUE);
+  g_assert_nonnull (paths);
+  g_assert_cmpfloat (gtk_symbolic_paths_get_width (paths), ==, 16);
+  g_assert_cmpfloat (gtk_symbolic_paths_get_height (paths), ==, 16);
+  g_assert_cmpuint (gtk_symbolic_paths_get_n_shapes (paths), ==, 5);
+
+  fills = snapshot_fills (paths, 32, &node);
+  g_assert_cmpuint (fills->len, ==, 5);
+
+  assert_color (g_ptr_array_index (fills, 0), &colors[GTK_SYMBOLIC_COLOR_FOREGROUND], 1);
+  assert_color (g_ptr_array_index (fills, 1), &colors[GTK_SYMBOLIC_COLOR_ERROR], 1);
+  assert_color (g_ptr_array_index (fills, 2), &colors[GTK_SYMBOLIC_COLOR_WARNING], 1);
+  assert_color (g_ptr_array_index (fills, 3), &colors[GTK_SYMBOLIC_COLOR_SUCCESS], 1);
+  assert_color (g_ptr_array_index (fills, 4), &colors[GTK_SYMBOLIC_COLOR_FOREGROUND], 1);
+  g_assert_cmpint (gsk_fill_node_get_fill_rule (g_ptr_array_index (fills, 0)), ==, GSK_FILL_RULE_WINDING);
+  g_assert_cmpint (gsk_fill_node_get_fill_rule (g_ptr_array_index (fills, 4)), ==, GSK_FILL_RULE_EVEN_ODD);
+
+  /* Scaled to the size it is drawn at */
+  gsk_render_node_get_bounds (node, &bounds);
+  g_assert_cmpfloat_with_epsilon (bounds.origin.x, 0, 0.01);
+  g_assert_cmpfloat_with_epsilon (bounds.origin.y, 0, 0.01);
+  g_assert_cmpfloat_with_epsilon (bounds.size.width, 32, 0.01);
+  g_assert_cmpfloat_with_epsilon (bounds.size.height, 32, 0.01);
+
+  g_ptr_array_unref (fills);
+  gsk_render_node_unref (node);
+  gtk_symbolic_paths_unref (paths);
+}
+
+static void
+test_opacity (void)
+{
+  GtkSymbolicPaths *paths;
+  GskRenderNode *node;
+  GPtrArray *fills;
+
+  paths = parse ("<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 16 16\">"
+                 "  <g opacity=\"0.5\" style=\"fill-opacity: 0.5\">"
+                 "    <rect width=\"16\" height=\"8\"/>"
+                 "    <rect y=\"8\" width=\"16\" height=\"8\" style=\"opacity:0.5\"/>"
+                 "  </g>"
+                 "  <rect width=\"4\" height=\"4\" display=\"none\"/>"
+                 "  <rect width=\"4\" height=\"4\" style=\"visibility: hidden\"/>"
+                 "  <g opacity=\"0\"><rect width=\"4\" height=\"4\"/></g>"
+                 "</svg>", FALSE);
+  g_assert_nonnull (paths);
+  g_assert_cmpuint (gtk_symbolic_paths_get_n_shapes (paths), ==, 2);
+
+  fills = snapshot_fills (paths, 16, &node);
+  g_assert_cmpuint (fills->len, ==, 2);
+
+  /* The group opacity applies to the group as a layer */
+  g_assert_nonnull (find_opacity (node));
+  g_assert_cmpfloat_with_epsilon (gsk_opacity_node_get_opacity (find_opacity (node)), 0.5, 0.001);
+
+  assert_color (g_ptr_array_index (fills, 0), &colors[GTK_SYMBOLIC_COLOR_FOREGROUND], 0.5);
+  assert_color (g_ptr_array_index (fills, 1), &colors[GTK_SYMBOLIC_COLOR_FOREGROUND], 0.25);
+
+  g_ptr_array_unref (fills);
+  gsk_render_node_unref (node);
+  gtk_symbolic_paths_unref (paths);
+}
+
+static void
+test_fill_none (void)
+{
+  const char *svg =
+    "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"16\" height=\"16\">"
+    "  <rect width=\"16\" height=\"16\" fill=\"none\"/>"
+    "  <ellipse cx=\"8\" cy=\"8\" rx=\"8\" ry=\"4\" style=\"fill:none\"/>"
+    "  <circle cx=\"8\" cy=\"8\" r=\"4\"/>"
+    "</svg>";
+  GtkSymbolicPaths *paths;
+
+  /* Icons without symbolic classes are drawn as they are */
+  paths = parse (svg, FALSE);
+  g_assert_nonnull (paths);
+  g_assert_cmpuint (gtk_symbolic_paths_get_n_shapes (paths), ==, 1);
+  gtk_symbolic_paths_unref (paths);
+
+  /* The wrapper svg fills paths, rects and circles regardless */
+  paths = parse (svg, TRUE);
+  g_assert_nonnull (paths);
+  g_assert_cmpuint (gtk_symbolic_paths_get_n_shapes (paths), ==, 2);
+  gtk_symbolic_paths_unref (paths);
+}
+
+/* Icons that use more than filled shapes are drawn from textures */
+static void
+test_unsupported (void)
+{
+  const char *svgs[] = {
+    "not an svg",
+    "<html/>",
+    "<svg width=\"16\" height=\"16\"><path d=\"M 0 0 L 16 16\" stroke=\"black\"/></svg>",
+    "<svg width=\"16\" height=\"16\"><path d=\"M 0 0 L 16 16\" style=\"stroke:#000\"/></svg>",
+    "<svg width=\"16\" height=\"16\"><text>Hi</text></svg>",
+    "<svg width=\"16\" height=\"16\"><use href=\"#a\"/></svg>",
+    "<svg width=\"16\" height=\"16\"><g clip-path=\"url(#a)\"><rect width=\"4\" height=\"4\"/></g></svg>",
+    "<svg width=\"16\" height=\"16\"><path d=\"this is not a path\"/></svg>",
+    "<svg width=\"16\" height=\"16\"><rect width=\"4\" height=\"4\" transform=\"wobble(3)\"/></svg>",
+    "<svg width=\"100%\" height=\"16\"><rect width=\"4\" height=\"4\"/></svg>",
+    "<svg width=\"16\" height=\"16\"></svg>",
+  };
+
+  for (guint i = 0; i < G_N_ELEMENTS (svgs); i++)
+    g_assert_null (parse (svgs[i], FALSE));
+}
+
+static void
+test_icon (void)
+{
+  GtkSymbolicPaths *paths;
+  GskRenderNode *node;
+  GPtrArray *fills;
+  GError *error = NULL;
+  char *path, *contents;
+  gsize length;
+  GBytes *bytes;
+
+  path = g_test_build_filename (G_TEST_DIST, "icons", "scalable", "nonsquare-symbolic.svg", NULL);
+  g_file_get_contents (path, &contents, &length, &error);
+  g_assert_no_error (error);
+
+  bytes = g_bytes_new_take (contents, length);
+  paths = gtk_symbolic_paths_new (bytes, FALSE);
+  g_bytes_unref (bytes);
+
+  g_assert_nonnull (paths);
+  g_assert_cmpfloat (gtk_symbolic_paths_get_width (paths), ==, 12);
+  g_assert_cmpfloat (gtk_symbolic_paths_get_height (paths), ==, 18);
+
+  fills = snapshot_fills (paths, 18, &node);
+  g_assert_cmpuint (fills->len, ==, 2);
+
+  g_ptr_array_unref (fills);
+  gsk_render_node_unref (node);
+  gtk_symbolic_paths_unref (paths);
+  g_free (path);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/symbolicpaths/shapes", test_shapes);
+  g_test_add_func ("/symbolicpaths/opacity", test_opacity);
+  g_test_add_func ("/symbolicpaths/fill-none", test_fill_none);
+  g_test_add_func ("/symbolicpaths/unsupported", test_unsupported);
+  g_test_add_func ("/symbolicpaths/icon", test_icon);
+
+  return g_test_run ();
+}
@@ -19,6 +19,7 @@
 #include "config.h"
 #include <stdio.h>
 #include <string.h>
+#include <glib/gstdio.h>
 
 #include <gtk/gtk.h>
 #include "gtk/gtktexttypesprivate.h" /* Private header, for UNKNOWN_CHAR */
@@ -1950,6 +1951,136 @@ test_serialize_wrap_mode (void)
   g_assert_finalize_object (buffer);
 }
 
+typedef struct
+{
+  gboolean done;
+  GError *error;
+} LoadResult;
+
+static void
+mapped_file_loaded (GObject      *source,
+                    GAsyncResult *result,
+                    gpointer      data)
+{
+  LoadResult *load = data;
+
+  if (!gtk_text_buffer_load_mapped_file_finish (GTK_TEXT_BUFFER (source), result, &load->error))
+    g_assert_nonnull (load->error);
+
+  load->done = TRUE;
+}
+
+static GError *
+load_mapped_file (GtkTextBuffer *buffer,
+                  const char    *contents)
+{
+  LoadResult load = { FALSE, NULL };
+  GMappedFile *file;
+  GError *error = NULL;
+  char *path;
+  int fd;
+
+  fd = g_file_open_tmp ("textbuffer-XXXXXX", &path, &error);
+  g_assert_no_error (error);
+  g_close (fd, NULL);
+  g_file_set_contents (path, contents, -1, &error);
+  g_assert_no_error (error);
+
+  file = g_mapped_file_new (path, FALSE, &error);
+  g_assert_no_error (error);
+
+  gtk_text_buffer_load_mapped_file_async (buffer, file, NULL, mapped_file_loaded, &load);
+  g_mapped_file_unref (file);
+
+  while (!load.done)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_unlink (path);
+  g_free (path);
+
+  return load.error;
+}
+
+static void
+count_inserted_bytes (GtkTextBuffer *buffer,
+                      GtkTextIter   *iter,
+                      const char    *text,
+                      int            len,
+                      int           *inserted)
+{
+  g_assert_true (g_utf8_validate (text, len, NULL));
+  *inserted += len;
+}
+
+static void
+count_changes (GtkTextBuffer *buffer,
+               int           *changes)
+{
+  (*changes)++;
+}
+
+static void
+test_mapped_file (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextTag *tag;
+  GtkTextIter start, end;
+  GError *error;
+  char *text;
+  int inserted = 0, changes = 0;
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, "previous", -1);
+
+  g_signal_connect (buffer, "insert-text", G_CALLBACK (count_inserted_bytes), &inserted);
+  g_signal_connect (buffer, "changed", G_CALLBACK (count_changes), &changes);
+
+  error = load_mapped_file (buffer, "first line\nsecond l\xc3\xafne\r\nthird");
+  g_assert_no_error (error);
+
+  /* Listeners are told about the new text like for any insertion */
+  g_assert_cmpint (inserted, ==, strlen ("first line\nsecond l\xc3\xafne\r\nthird"));
+  g_assert_cmpint (changes, ==, 2);
+  g_signal_handlers_disconnect_by_func (buffer, count_inserted_bytes, &inserted);
+  g_signal_handlers_disconnect_by_func (buffer, count_changes, &changes);
+
+  g_assert_cmpint (gtk_text_buffer_get_line_count (buffer), ==, 3);
+  g_assert_cmpint (gtk_text_buffer_get_char_count (buffer), ==, 29);
+  check_buffer_contents (buffer, "first line\nsecond l\xc3\xafne\r\nthird");
+  g_assert_false (gtk_text_buffer_get_can_undo (buffer));
+
+  /* Splitting and merging segments keeps referring to the file */
+  tag = gtk_text_buffer_create_tag (buffer, NULL, "weight", PANGO_WEIGHT_BOLD, NULL);
+  gtk_text_buffer_get_iter_at_line_offset (buffer, &start, 1, 3);
+  gtk_text_buffer_get_iter_at_line_offset (buffer, &end, 1, 9);
+  gtk_text_buffer_apply_tag (buffer, tag, &start, &end);
+  text = gtk_text_buffer_get_text (buffer, &start, &end, TRUE);
+  g_assert_cmpstr (text, ==, "ond l\xc3\xaf");
+  g_free (text);
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  gtk_text_buffer_remove_tag (buffer, tag, &start, &end);
+
+  /* Edits copy the text */
+  gtk_text_buffer_get_iter_at_line_offset (buffer, &start, 0, 5);
+  gtk_text_buffer_insert (buffer, &start, " inserted", -1);
+  gtk_text_buffer_get_iter_at_line_offset (buffer, &start, 2, 0);
+  gtk_text_buffer_get_iter_at_line_offset (buffer, &end, 2, 2);
+  gtk_text_buffer_delete (buffer, &start, &end);
+  check_buffer_contents (buffer, "first inserted line\nsecond l\xc3\xafne\r\nird");
+
+  error = load_mapped_file (buffer, "invalid \xff text");
+  g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+  g_clear_error (&error);
+  check_buffer_contents (buffer, "first inserted line\nsecond l\xc3\xafne\r\nird");
+
+  error = load_mapped_file (buffer, "ends with newline\n");
+  g_assert_no_error (error);
+  g_assert_cmpint (gtk_text_buffer_get_line_count (buffer), ==, 2);
+  check_buffer_contents (buffer, "ends with newline\n");
+
+  g_assert_finalize_object (buffer);
+}
+
 int
 main (int argc, char** argv)
 {
@@ -1978,6 +2109,7 @@ main (int argc, char** argv)
   g_test_add_func ("/TextBuffer/Undo 4", test_undo4);
   g_test_add_func ("/TextBuffer/Undo 5", test_undo5);
   g_test_add_func ("/TextBuffer/Serialize wrap-mode", test_serialize_wrap_mode);
+  g_test_add_func ("/TextBuffer/Mapped file", test_mapped_file);
 
   return g_test_run();
 }
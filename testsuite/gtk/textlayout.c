@@ -0,0 +1,250 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+#include "gtk/gtktextlayoutprivate.h"
+#include "gtk/gtktextiterprivate.h"
+
+#define PARAGRAPH "Lorem ipsum dolor sit amet, consectetur adipiscing elit, " \
+                  "sed do eiusmod tempor incididunt ut labore et dolore magna aliqua."
+
+static GtkTextLayout *
+create_layout (GtkTextBuffer *buffer)
+{
+  GtkTextLayout *layout;
+  GtkTextAttributes *style;
+  PangoContext *context;
+
+  layout = gtk_text_layout_new ();
+
+  context = pango_font_map_create_context (pango_cairo_font_map_get_default ());
+  gtk_text_layout_set_contexts (layout, context, context);
+  g_object_unref (context);
+
+  style = gtk_text_attributes_new ();
+  style->wrap_mode = GTK_WRAP_WORD;
+  gtk_text_layout_set_default_style (layout, style);
+  gtk_text_attributes_unref (style);
+
+  gtk_text_layout_set_buffer (layout, buffer);
+  gtk_text_layout_set_cursor_visible (layout, TRUE);
+  gtk_text_layout_set_screen_width (layout, 300);
+
+  return layout;
+}
+
+static GtkTextLine *
+get_line (GtkTextBuffer *buffer,
+          int            line_number)
+{
+  GtkTextIter iter;
+
+  gtk_text_buffer_get_iter_at_line (buffer, &iter, line_number);
+
+  return _gtk_text_iter_get_text_line (&iter);
+}
+
+/* Checks that a display that was re-broken for a new width looks
+ * like one that is created from scratch at that width
+ */
+static void
+assert_display_is_fresh (GtkTextLayout      *layout,
+                         GtkTextLineDisplay *display)
+{
+  GtkTextLineDisplay *fresh;
+  PangoRectangle strong, fresh_strong;
+
+  fresh = gtk_text_layout_create_display (layout, display->line, FALSE);
+  gtk_text_layout_update_display_cursors (layout, display->line, fresh);
+
+  g_assert_cmpint (display->screen_width, ==, layout->screen_width);
+  g_assert_cmpstr (pango_layout_get_text (display->layout), ==, pango_layout_get_text (fresh->layout));
+  g_assert_cmpint (pango_layout_get_width (display->layout), ==, pango_layout_get_width (fresh->layout));
+  g_assert_cmpint (pango_layout_get_line_count (display->layout), ==, pango_layout_get_line_count (fresh->layout));
+  g_assert_cmpint (display->width, ==, fresh->width);
+  g_assert_cmpint (display->height, ==, fresh->height);
+  g_assert_cmpint (display->insert_index, ==, fresh->insert_index);
+
+  if (fresh->cursors == NULL)
+    {
+      g_assert_null (display->cursors);
+    }
+  else
+    {
+      g_assert_nonnull (display->cursors);
+      g_assert_cmpuint (display->cursors->len, ==, fresh->cursors->len);
+    }
+
+  if (fresh->insert_index >= 0)
+    {
+      pango_layout_get_cursor_pos (display->layout, display->insert_index, &strong, NULL);
+      pango_layout_get_cursor_pos (fresh->layout, fresh->insert_index, &fresh_strong, NULL);
+      g_assert_cmpint (strong.x, ==, fresh_strong.x);
+      g_assert_cmpint (strong.y, ==, fresh_strong.y);
+    }
+
+  gtk_text_line_display_unref (fresh);
+}
+
+static void
+test_rewrap (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextLayout *layout;
+  GtkTextLineDisplay *before, *after;
+  GtkTextIter iter;
+  int width, n_lines;
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, PARAGRAPH "\n" PARAGRAPH, -1);
+  layout = create_layout (buffer);
+
+  gtk_text_buffer_get_iter_at_line_offset (buffer, &iter, 0, 50);
+  gtk_text_buffer_place_cursor (buffer, &iter);
+
+  for (int i = 0; i < 2; i++)
+    {
+      GtkTextLine *line = get_line (buffer, i);
+
+      gtk_text_layout_set_screen_width (layout, 300);
+
+      before = gtk_text_layout_get_line_display (layout, line, FALSE);
+      width = pango_layout_get_width (before->layout);
+      n_lines = pango_layout_get_line_count (before->layout);
+
+      gtk_text_layout_set_screen_width (layout, 100);
+
+      after = gtk_text_layout_get_line_display (layout, line, FALSE);
+      g_assert_true (after != before);
+      g_assert_cmpint (pango_layout_get_line_count (after->layout), >, n_lines);
+      assert_display_is_fresh (layout, after);
+
+      /* The old display may still be in use, and is left alone */
+      g_assert_cmpint (pango_layout_get_width (before->layout), ==, width);
+      g_assert_cmpint (pango_layout_get_line_count (before->layout), ==, n_lines);
+
+      gtk_text_line_display_unref (after);
+      gtk_text_line_display_unref (before);
+    }
+
+  g_object_unref (layout);
+  g_object_unref (buffer);
+}
+
+static void
+test_rewrap_cursor_line (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextLayout *layout;
+  GtkTextLineDisplay *display;
+  GtkTextLine *line;
+  GtkTextIter iter;
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, PARAGRAPH, -1);
+  layout = create_layout (buffer);
+
+  gtk_text_buffer_get_iter_at_offset (buffer, &iter, 100);
+  gtk_text_buffer_place_cursor (buffer, &iter);
+  line = get_line (buffer, 0);
+
+  display = gtk_text_layout_get_line_display (layout, line, FALSE);
+  g_assert_nonnull (display->cursors);
+  gtk_text_line_display_unref (display);
+
+  /* Re-breaking keeps the line as the cursor line, so the cursors
+   * follow the new breaks, and keep doing so on later width changes
+   */
+  for (int width = 250; width >= 100; width -= 50)
+    {
+      gtk_text_layout_set_screen_width (layout, width);
+
+      display = gtk_text_layout_get_line_display (layout, line, FALSE);
+      g_assert_nonnull (display->cursors);
+      assert_display_is_fresh (layout, display);
+      gtk_text_line_display_unref (display);
+    }
+
+  /* Moving the cursor away still updates the re-broken display */
+  gtk_text_buffer_get_start_iter (buffer, &iter);
+  gtk_text_buffer_place_cursor (buffer, &iter);
+
+  display = gtk_text_layout_get_line_display (layout, line, FALSE);
+  assert_display_is_fresh (layout, display);
+  gtk_text_line_display_unref (display);
+
+  g_object_unref (layout);
+  g_object_unref (buffer);
+}
+
+static void
+test_rewrap_preedit (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextLayout *layout;
+  GtkTextLineDisplay *display;
+  PangoAttrList *attrs;
+  GtkTextLine *line;
+  GtkTextIter iter;
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, PARAGRAPH, -1);
+  layout = create_layout (buffer);
+
+  gtk_text_buffer_get_iter_at_offset (buffer, &iter, 40);
+  gtk_text_buffer_place_cursor (buffer, &iter);
+  line = get_line (buffer, 0);
+
+  attrs = pango_attr_list_new ();
+  pango_attr_list_insert (attrs, pango_attr_underline_new (PANGO_UNDERLINE_SINGLE));
+  gtk_text_layout_set_preedit_string (layout, "preedit text", attrs, 4);
+  pango_attr_list_unref (attrs);
+
+  display = gtk_text_layout_get_line_display (layout, line, FALSE);
+  g_assert_nonnull (strstr (pango_layout_get_text (display->layout), "preedit text"));
+  gtk_text_line_display_unref (display);
+
+  gtk_text_layout_set_screen_width (layout, 120);
+
+  display = gtk_text_layout_get_line_display (layout, line, FALSE);
+  g_assert_nonnull (strstr (pango_layout_get_text (display->layout), "preedit text"));
+  assert_display_is_fresh (layout, display);
+  gtk_text_line_display_unref (display);
+
+  /* Ending the preedit drops it from the re-broken display too */
+  gtk_text_layout_set_preedit_string (layout, NULL, NULL, 0);
+
+  display = gtk_text_layout_get_line_display (layout, line, FALSE);
+  g_assert_null (strstr (pango_layout_get_text (display->layout), "preedit text"));
+  assert_display_is_fresh (layout, display);
+  gtk_text_line_display_unref (display);
+
+  g_object_unref (layout);
+  g_object_unref (buffer);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/textlayout/rewrap", test_rewrap);
+  g_test_add_func ("/textlayout/rewrap/cursor-line", test_rewrap_cursor_line);
+  g_test_add_func ("/textlayout/rewrap/preedit", test_rewrap_preedit);
+
+  return g_test_run ();
+}